@@ -0,0 +1,138 @@
+/*
+ * activation benchmark: relu / sigmoid / tanh forward + backward, scalar vs AVX2 vs
+ * AVX-512 slice kernels, plus the threaded dispatch (pico_relu_cpu & co.) at the
+ * widest level the machine has.
+ *
+ * Run with `make act` from bench/. Kernels are called directly on raw buffers so the
+ * single-thread columns measure the kernel only; the "threaded" column goes through
+ * the cpu_kernels.h dispatcher, which splits across global_tp above
+ * PICO_ACT_THREAD_MIN_CHUNK elements per slice. relu is pure bandwidth; sigmoid/tanh
+ * are compute-bound (exp + divide per element), which is where the threads pay off.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench_common.h"
+
+#define WARMUP 3
+#define ITERS 50
+
+typedef void (*fwd_fn)(const float*, float*, int64_t);
+typedef void (*bwd_fn)(const float*, const float*, float*, int64_t);
+typedef void (*disp_fwd_fn)(struct PicoTensor*, struct PicoTensor*);
+typedef void (*disp_bwd_fn)(struct PicoTensor*, struct PicoTensor*);
+
+struct ActCase {
+    const char* name;
+    fwd_fn fwd[3];  // scalar, avx2, avx512
+    bwd_fn bwd[3];
+    disp_fwd_fn disp_fwd;
+    disp_bwd_fn disp_bwd;
+};
+
+static double time_fwd(fwd_fn f, const float* x, float* y, int64_t n) {
+    for(int w = 0; w < WARMUP; w++) f(x, y, n);
+    double t0 = bench_now_sec();
+    for(int it = 0; it < ITERS; it++) f(x, y, n);
+    return (bench_now_sec() - t0) / (double)ITERS;
+}
+
+static double time_bwd(bwd_fn f, const float* y, const float* dy, float* dx, int64_t n) {
+    for(int w = 0; w < WARMUP; w++) f(y, dy, dx, n);
+    double t0 = bench_now_sec();
+    for(int it = 0; it < ITERS; it++) f(y, dy, dx, n);
+    return (bench_now_sec() - t0) / (double)ITERS;
+}
+
+static double time_disp(disp_fwd_fn fwd, disp_bwd_fn bwd, struct PicoTensor* x,
+                        struct PicoTensor* out) {
+    for(int w = 0; w < WARMUP; w++) {
+        fwd(x, out);
+        bwd(out, x);
+    }
+    double t0 = bench_now_sec();
+    for(int it = 0; it < ITERS; it++) {
+        fwd(x, out);
+        bwd(out, x);
+    }
+    return (bench_now_sec() - t0) / (double)ITERS;
+}
+
+int main(void) {
+    pico_init();
+    int has_avx512 = __builtin_cpu_supports("avx512f");
+    g_simd_level = has_avx512 ? SIMD_AVX512 : SIMD_AVX2;
+
+    struct ActCase cases[] = {
+        {"relu",
+         {pico_relu_fwd_scalar, pico_relu_fwd_avx2_fp32, pico_relu_fwd_avx512_fp32},
+         {pico_relu_bwd_scalar, pico_relu_bwd_avx2_fp32, pico_relu_bwd_avx512_fp32},
+         pico_relu_cpu,
+         pico_relu_backward_cpu},
+        {"sigmoid",
+         {pico_sigmoid_fwd_scalar, pico_sigmoid_fwd_avx2_fp32, pico_sigmoid_fwd_avx512_fp32},
+         {pico_sigmoid_bwd_scalar, pico_sigmoid_bwd_avx2_fp32, pico_sigmoid_bwd_avx512_fp32},
+         pico_sigmoid_cpu,
+         pico_sigmoid_backward_cpu},
+        {"tanh",
+         {pico_tanh_fwd_scalar, pico_tanh_fwd_avx2_fp32, pico_tanh_fwd_avx512_fp32},
+         {pico_tanh_bwd_scalar, pico_tanh_bwd_avx2_fp32, pico_tanh_bwd_avx512_fp32},
+         pico_tanh_cpu,
+         pico_tanh_backward_cpu},
+    };
+    int n_cases = (int)(sizeof(cases) / sizeof(cases[0]));
+    int64_t sizes[] = {1 << 12, 1 << 16, 1 << 20, 1 << 23};
+    int n_sizes = (int)(sizeof(sizes) / sizeof(sizes[0]));
+
+    printf("\n  pico activations fwd+bwd ms   (warmup=%d, iters=%d, -O2, threaded=%s)\n", WARMUP,
+           ITERS, has_avx512 ? "avx512" : "avx2");
+    printf("  %-8s %-9s %10s %10s %10s %10s %9s %8s\n", "act", "numel", "scalar", "avx2",
+           "avx512", "threaded", "best x", "correct");
+    printf("  --------------------------------------------------------------------------------\n");
+
+    for(int s = 0; s < n_sizes; s++) {
+        int64_t n = sizes[s];
+        int64_t shape[] = {n};
+        struct PicoTensor* x = pico_param(shape, 1);
+        struct PicoTensor* out = pico_param(shape, 1);
+        float* ref = malloc((size_t)n * sizeof(float));
+        for(int64_t i = 0; i < n; i++) {
+            x->data[i] = (float)((i * 37) % 201 - 100) * 0.05f;
+            out->grad[i] = 1.0f;
+        }
+
+        for(int c = 0; c < n_cases; c++) {
+            struct ActCase* ac = &cases[c];
+
+            // correctness gate: every SIMD forward within 1e-6 of scalar
+            ac->fwd[0](x->data, ref, n);
+            float diff = 0.0f;
+            for(int v = 1; v < 3; v++) {
+                if(v == 2 && !has_avx512) continue;
+                ac->fwd[v](x->data, out->data, n);
+                for(int64_t i = 0; i < n; i++) diff = fmaxf(diff, fabsf(out->data[i] - ref[i]));
+            }
+
+            double t[3] = {NAN, NAN, NAN};
+            for(int v = 0; v < 3; v++) {
+                if(v == 2 && !has_avx512) continue;
+                t[v] = time_fwd(ac->fwd[v], x->data, out->data, n) +
+                       time_bwd(ac->bwd[v], out->data, out->grad, x->grad, n);
+            }
+            double t_thr = time_disp(ac->disp_fwd, ac->disp_bwd, x, out);
+            double best = has_avx512 ? fmin(t[2], t_thr) : fmin(t[1], t_thr);
+
+            printf("  %-8s %-9ld %10.3f %10.3f %10.3f %10.3f %8.2fx %8s\n", ac->name, (long)n,
+                   t[0] * 1e3, t[1] * 1e3, t[2] * 1e3, t_thr * 1e3, t[0] / best,
+                   diff <= 1e-6f ? "ok" : "MISMATCH");
+        }
+
+        free(ref);
+        pico_free(x);
+        pico_free(out);
+    }
+
+    printf("\n");
+    return 0;
+}
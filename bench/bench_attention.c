@@ -0,0 +1,145 @@
+/*
+ * attention benchmark: causal self-attention over [heads, L, 64] against the same
+ * computation out of existing ops, in ms per call. batch 1.
+ *
+ * Run with `make attention` from bench/. Per shape:
+ *
+ *   chain       — per head: matmul(q, kᵀ), * 1/sqrt(d), + mask, softmax, matmul(·, v),
+ *                 the L × L scores a fresh arena tensor at every step
+ *   scalar      — pico_attention with the scalar kernels
+ *   simd        — pico_attention at the detected SIMD level
+ *   fwd+bwd     — the chain vs pico_attention, forward + backward into q, k and v
+ *   scores MB   — what the chain materializes per call (scores, scaled, masked, P) vs
+ *                 the per-row logsumexp pico_attention keeps
+ *
+ * Gated: max |simd - chain| on the forward is printed per shape.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "act/activations.h"
+#include "arena.h"
+#include "attention/attention.h"
+#include "bench_common.h"
+#include "ops.h"
+#include "reduce/reduce.h"
+#include "view/view.h"
+
+#define WARMUP 1
+#define ITERS 3
+#define DIM 64
+
+// q, k, v [heads * L, d]: one 2-D chain per head, outputs summed into one loss
+static struct PicoTensor* chain_attention(struct PicoTensor* q, struct PicoTensor* k,
+                                          struct PicoTensor* v, struct PicoTensor* mask,
+                                          int64_t heads, int64_t L, struct PicoTensor** y0) {
+    struct PicoTensor* scale = pico_tensor_from_scalar(1.0f / sqrtf((float)DIM));
+    struct PicoTensor* loss = NULL;
+    for(int64_t h = 0; h < heads; h++) {
+        struct PicoTensor* qh = pico_narrow(q, 0, h * L, L);
+        struct PicoTensor* kt = pico_contiguous(pico_transpose(pico_narrow(k, 0, h * L, L), 0, 1));
+        struct PicoTensor* vh = pico_narrow(v, 0, h * L, L);
+        struct PicoTensor* s = pico_add(pico_mul(pico_matmul(qh, kt), scale), mask);
+        struct PicoTensor* y = pico_matmul(pico_softmax(s, -1), vh);
+        if(h == 0) *y0 = y;
+        struct PicoTensor* part = pico_sum(y, NULL, 0, false);
+        loss = loss == NULL ? part : pico_add(loss, part);
+    }
+    return loss;
+}
+
+// chain when chain, else pico_attention; backward through a sum when bwd
+static double run(struct Arena* ar, bool chain, bool bwd, struct PicoTensor* q,
+                  struct PicoTensor* k, struct PicoTensor* v, struct PicoTensor* mask,
+                  int64_t heads, int64_t L) {
+    int64_t s3[] = {heads, L, DIM};
+    double t = 0.0;
+    for(int it = -WARMUP; it < ITERS; it++) {
+        if(it == 0) t = bench_now_sec();
+        struct PicoTensor *y0, *loss;
+        if(chain) {
+            loss = chain_attention(q, k, v, mask, heads, L, &y0);
+        } else {
+            loss = pico_sum(pico_attention(pico_reshape(q, s3, 3), pico_reshape(k, s3, 3),
+                                           pico_reshape(v, s3, 3), mask),
+                            NULL, 0, false);
+        }
+        if(bwd) pico_backward(ar, loss);
+        arena_reset(ar);
+    }
+    return (bench_now_sec() - t) / ITERS;
+}
+
+// max |pico_attention - chain| over head 0's output
+static float max_err(struct Arena* ar, struct PicoTensor* q, struct PicoTensor* k,
+                     struct PicoTensor* v, struct PicoTensor* mask, int64_t heads, int64_t L) {
+    int64_t s3[] = {heads, L, DIM};
+    struct PicoTensor* ref;
+    chain_attention(q, k, v, mask, heads, L, &ref);
+    struct PicoTensor* y = pico_attention(pico_reshape(q, s3, 3), pico_reshape(k, s3, 3),
+                                          pico_reshape(v, s3, 3), mask);
+    float err = 0.0f;
+    for(int64_t i = 0; i < L * DIM; i++) err = fmaxf(err, fabsf(y->data[i] - ref->data[i]));
+    arena_reset(ar);
+    return err;
+}
+
+int main(void) {
+    pico_init();
+    SimdLevel level = g_simd_level;
+    int64_t shapes[][2] = {{8, 128}, {8, 256}, {8, 512}, {4, 1024}};
+    int n_shapes = (int)(sizeof(shapes) / sizeof(shapes[0]));
+
+    struct Arena* ar = arena_init((size_t)1 << 30);
+    arena_ctx_push(ar);
+
+    printf("\n  causal attention, d %d, ms/call   (warmup=%d, iters=%d, -O2)\n", DIM, WARMUP,
+           ITERS);
+    printf("  %-10s %8s %8s %8s %10s %10s %8s %10s %9s %8s\n", "[h, L]", "chain", "scalar",
+           "simd", "chain f+b", "attn f+b", "speedup", "chain MB", "attn MB", "max err");
+    printf("  --------------------------------------------------------------------------------"
+           "-------------\n");
+    for(int i = 0; i < n_shapes; i++) {
+        int64_t heads = shapes[i][0], L = shapes[i][1];
+        int64_t xs[] = {heads * L, DIM}, ms[] = {L, L};
+        struct PicoTensor* q = pico_param(xs, 2);
+        struct PicoTensor* k = pico_param(xs, 2);
+        struct PicoTensor* v = pico_param(xs, 2);
+        struct PicoTensor* mask = pico_param(ms, 2);
+        for(int64_t j = 0; j < q->numel; j++) {
+            q->data[j] = (float)(j % 17) * 0.1f - 0.8f;
+            k->data[j] = (float)(j % 13) * 0.1f - 0.6f;
+            v->data[j] = (float)(j % 11) * 0.1f - 0.5f;
+        }
+        for(int64_t j = 0; j < mask->numel; j++) mask->data[j] = j % L > j / L ? -INFINITY : 0.0f;
+        mask->requires_grad = 0;
+
+        double t_chain = run(ar, true, false, q, k, v, mask, heads, L);
+        g_simd_level = SIMD_NONE;
+        double t_scalar = run(ar, false, false, q, k, v, mask, heads, L);
+        g_simd_level = level;
+        double t_simd = run(ar, false, false, q, k, v, mask, heads, L);
+        double t_chain_bwd = run(ar, true, true, q, k, v, mask, heads, L);
+        double t_attn_bwd = run(ar, false, true, q, k, v, mask, heads, L);
+        float err = max_err(ar, q, k, v, mask, heads, L);
+
+        double chain_mb = 4.0 * heads * L * L * sizeof(float) / (1 << 20);
+        double attn_mb = (double)heads * L * sizeof(float) / (1 << 20);
+        char name[32];
+        snprintf(name, sizeof(name), "[%lld, %lld]", (long long)heads, (long long)L);
+        printf("  %-10s %8.2f %8.2f %8.2f %10.2f %10.2f %7.1fx %10.1f %9.3f %8.1e\n", name,
+               t_chain * 1e3, t_scalar * 1e3, t_simd * 1e3, t_chain_bwd * 1e3,
+               t_attn_bwd * 1e3, t_chain_bwd / t_attn_bwd, chain_mb, attn_mb, err);
+
+        pico_free(q);
+        pico_free(k);
+        pico_free(v);
+        pico_free(mask);
+    }
+    printf("\n");
+
+    arena_ctx_pop();
+    arena_destroy(ar);
+    return 0;
+}
@@ -0,0 +1,144 @@
+/*
+ * concatenation benchmark: joining n sequences into one batch, the way a data loader
+ * does. the old two-tensor pico_cat chained n - 1 times (every call copies everything
+ * joined so far again) and a one-thread memcpy loop vs pico_cat_n.
+ *
+ * Run with `make cat` from bench/. Per case, in GB/s (output bytes read + written):
+ *
+ *   chained pico_cat  — ((t0 ++ t1) ++ t2) ++ ...: n - 1 calls, quadratic bytes
+ *   memcpy loop       — one pass, one thread, plain stores (the old pico_cat's loop)
+ *   cat_n cached      — pico_cat_n's walk on one thread with plain stores
+ *   cat_n streaming   — the same with non-temporal stores
+ *   pico_cat_n        — the real call: split across global_tp, streaming past
+ *                       PICO_CAT_STREAM_MIN_BYTES when the runs are long. it also pays
+ *                       for zeroing the fresh tensor's data and grad
+ *
+ * along dim 0 every input is one run; along the last dim the runs interleave row by row.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "arena.h"
+#include "bench_common.h"
+
+#define WARMUP 2
+#define ITERS 10
+#define MAX_N 64
+
+enum path { CHAINED, MEMCPY_LOOP, CACHED, STREAMING, PICO, PATHS };
+
+struct cat_case {
+    int n;
+    int64_t rows, cols;  // each input
+    int dim;
+};
+
+static void memcpy_loop(struct PicoTensor** ts, int n, int dim, char* dst) {
+    int64_t outer = dim == 0 ? 1 : ts[0]->shape[0];
+    size_t chunk = sizeof(float) * (size_t)(ts[0]->numel / outer);
+    for(int64_t o = 0; o < outer; o++) {
+        for(int k = 0; k < n; k++) {
+            memcpy(dst, (char*)ts[k]->data + o * chunk, chunk);
+            dst += chunk;
+        }
+    }
+}
+
+// pico_cat_n's walk on the calling thread, with the store kind forced
+static void cat_walk(struct PicoTensor** ts, int n, int dim, char* dst, bool stream) {
+    const char* src[MAX_N];
+    int64_t offsets[MAX_N], chunks[MAX_N], row = 0;
+    int64_t inner = dim == 0 ? ts[0]->numel : ts[0]->shape[1];
+    for(int k = 0; k < n; k++) {
+        src[k] = (const char*)ts[k]->data;
+        offsets[k] = row;
+        chunks[k] = inner;
+        row += inner;
+    }
+    struct PicoCatJob job = {.src = src,
+                             .dst = dst,
+                             .offsets = offsets,
+                             .chunks = chunks,
+                             .row = row,
+                             .n = n,
+                             .elem = sizeof(float),
+                             .stream = stream};
+    pico_cat_fwd_slice(&job, 0, ts[0]->numel * n);
+}
+
+static void run(enum path p, struct PicoTensor** ts, int n, int dim, char* dst,
+                struct Arena* ar) {
+    switch(p) {
+        case CHAINED: {
+            struct PicoTensor* acc = ts[0];
+            for(int k = 1; k < n; k++) acc = pico_cat(acc, ts[k], dim);
+            break;
+        }
+        case MEMCPY_LOOP: memcpy_loop(ts, n, dim, dst); break;
+        case CACHED: cat_walk(ts, n, dim, dst, false); break;
+        case STREAMING: cat_walk(ts, n, dim, dst, true); break;
+        default: pico_cat_n(ts, n, dim);
+    }
+    arena_reset(ar);
+}
+
+static double gbps(enum path p, struct PicoTensor** ts, int n, int dim, char* dst,
+                   struct Arena* ar) {
+    for(int w = 0; w < WARMUP; w++) run(p, ts, n, dim, dst, ar);
+    double t0 = bench_now_sec();
+    for(int it = 0; it < ITERS; it++) run(p, ts, n, dim, dst, ar);
+    double t = (bench_now_sec() - t0) / ITERS;
+    return 2.0 * sizeof(float) * ts[0]->numel * n / t * 1e-9;
+}
+
+int main(void) {
+    pico_init();
+    struct cat_case cases[] = {
+        {8, 64, 256, 0},     // 512 KB out, stays cached
+        {32, 128, 1024, 0},  // 16 MB
+        {32, 1024, 128, 1},  // 16 MB, interleaved rows
+        {16, 1024, 1024, 0}, // 64 MB
+    };
+    int n_cases = (int)(sizeof(cases) / sizeof(cases[0]));
+    const char* names[] = {"chained pico_cat", "memcpy loop", "cat_n cached", "cat_n streaming",
+                           "pico_cat_n"};
+    int has_avx2 = __builtin_cpu_supports("avx2");
+
+    struct Arena* ar = arena_init((size_t)1 << 30);
+    arena_ctx_push(ar);
+    char* dst = malloc((size_t)64 << 20);
+
+    printf("\n  cat of n fp32 inputs, GB/s read + written   (warmup=%d, iters=%d, -O2)\n",
+           WARMUP, ITERS);
+    printf("  %-20s %-4s %-18s %9s %9s\n", "inputs", "dim", "path", "GB/s", "vs memcpy");
+    printf("  ----------------------------------------------------------------\n");
+    for(int c = 0; c < n_cases; c++) {
+        struct cat_case cc = cases[c];
+        int64_t shape[] = {cc.rows, cc.cols};
+        struct PicoTensor* ts[MAX_N];
+        for(int k = 0; k < cc.n; k++) {
+            ts[k] = pico_param(shape, 2);
+            for(int64_t i = 0; i < ts[k]->numel; i++) ts[k]->data[i] = (float)(k + i);
+        }
+        char cbuf[32];
+        snprintf(cbuf, sizeof(cbuf), "%d x %lldx%lld", cc.n, (long long)cc.rows,
+                 (long long)cc.cols);
+        double base = 1.0;
+        for(int p = 0; p < PATHS; p++) {
+            if(p == STREAMING && !has_avx2) continue;
+            double g = gbps(p, ts, cc.n, cc.dim, dst, ar);
+            if(p == MEMCPY_LOOP) base = g;
+            printf("  %-20s %-4s %-18s %9.2f", p == 0 ? cbuf : "",
+                   p == 0 ? (cc.dim ? "1" : "0") : "", names[p], g);
+            if(p >= MEMCPY_LOOP) printf(" %8.2fx", g / base);
+            printf("\n");
+        }
+        for(int k = 0; k < cc.n; k++) pico_free(ts[k]);
+    }
+    printf("\n");
+
+    free(dst);
+    arena_ctx_pop();
+    arena_destroy(ar);
+    return 0;
+}
@@ -0,0 +1,98 @@
+/*
+ * checkpoint benchmark: what a save every few steps costs the training loop, with
+ * pico_ckpt_write (the loop stops until the file is on disk) vs pico_ckpt_write_async
+ * (the loop stops for the snapshot memcpy into the staging slab; the pwrite + fsync
+ * happen on a writer thread while the next steps run).
+ *
+ * Run with `make ckpt` from bench/. The "model" is PARAMS fp32 params of PARAM_FLOATS
+ * each (64 MB) under SGD; a step is pico_optim_sgd_step on fixed grads, a memory-bound
+ * pass over params + grads. Every SAVE_EVERY steps the params are saved to /tmp.
+ * Per mode: mean and max step time (a step includes the save call that precedes it),
+ * the time spent inside the save call, and the wall time of the whole run (the async
+ * run waits for its last save, so the totals compare the same work).
+ *
+ * The writer thread still needs a core: with one CPU it shares it with the loop, so the
+ * async win there is what the blocking fsync and page-cache writeback no longer cost
+ * the loop, not the full write time.
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+
+#include "bench_common.h"
+#include "checkpoint/checkpoint.h"
+#include "optim/optim.h"
+
+#define PARAMS 16
+#define PARAM_FLOATS (1 << 20)
+#define STEPS 60
+#define SAVE_EVERY 10
+#define PATH "/tmp/pico_bench_ckpt.bin"
+
+enum mode { NO_SAVE, SYNC_SAVE, ASYNC_SAVE };
+
+struct result {
+    double mean, max, save, wall;
+};
+
+static struct result run(enum mode mode, struct PicoOptimSGD* opt, struct PicoCkptWriter* w) {
+    struct PicoCkptAsync* as = pico_ckpt_async_init();
+    struct result r = {0};
+    double t_run = bench_now_sec();
+    for(int step = 1; step <= STEPS; step++) {
+        double t0 = bench_now_sec();
+        if(step % SAVE_EVERY == 0 && mode != NO_SAVE) {
+            bool ok = mode == SYNC_SAVE ? pico_ckpt_write(w, PATH)
+                                        : pico_ckpt_write_async(as, w, PATH);
+            if(!ok) fprintf(stderr, "save failed\n");
+            r.save += bench_now_sec() - t0;
+        }
+        pico_optim_sgd_step(opt);
+        double dt = bench_now_sec() - t0;
+        r.mean += dt;
+        if(dt > r.max) r.max = dt;
+    }
+    pico_ckpt_async_free(as);  // waits for the last save
+    r.wall = bench_now_sec() - t_run;
+    r.mean /= STEPS;
+    return r;
+}
+
+int main(void) {
+    pico_init();
+    struct PicoOptimSGD* opt = pico_optim_sgd_init(1e-6f);
+    struct PicoCkptWriter* w = pico_ckpt_writer_init();
+    struct PicoTensor* params[PARAMS];
+    for(int p = 0; p < PARAMS; p++) {
+        int64_t shape[] = {PARAM_FLOATS};
+        params[p] = pico_param(shape, 1);
+        for(int64_t i = 0; i < PARAM_FLOATS; i++) {
+            params[p]->data[i] = 0.001f * (float)(i % 1000);
+            params[p]->grad[i] = 0.01f * (float)(i % 7 - 3);
+        }
+        pico_optim_sgd_add(opt, params[p]);
+        char name[32];
+        snprintf(name, sizeof(name), "layer%d.weight", p);
+        pico_ckpt_add(w, name, params[p]);
+    }
+    pico_optim_sgd_step(opt);  // warm the chunk list
+
+    double mb = (double)PARAMS * PARAM_FLOATS * sizeof(float) / (1 << 20);
+    printf("\n  %d SGD steps over %.0f MB of params, a save to %s every %d steps  (-O2)\n",
+           STEPS, mb, PATH, SAVE_EVERY);
+    printf("  %-22s %12s %12s %14s %12s\n", "mode", "mean step", "max step", "in save call",
+           "wall");
+    printf("  ------------------------------------------------------------------------------\n");
+    const char* names[] = {"no save", "pico_ckpt_write", "pico_ckpt_write_async"};
+    for(int m = NO_SAVE; m <= ASYNC_SAVE; m++) {
+        struct result r = run((enum mode)m, opt, w);
+        printf("  %-22s %9.2f ms %9.2f ms %11.2f ms %9.1f ms\n", names[m], r.mean * 1e3,
+               r.max * 1e3, r.save * 1e3, r.wall * 1e3);
+    }
+    printf("\n");
+
+    remove(PATH);
+    pico_ckpt_writer_free(w);
+    pico_optim_sgd_free(opt);
+    for(int p = 0; p < PARAMS; p++) pico_free(params[p]);
+    return 0;
+}
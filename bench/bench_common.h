@@ -49,7 +49,7 @@ static inline void bench_scalar_cell(struct PicoTensor* a, struct PicoTensor* b,
         for(; i + (R) <= rows; i += (R)) {                                             \
             int j = 0;                                                                 \
             for(; j + 8 <= cols; j += 8)                                               \
-                pico_matmul_cpu_avx_kernel_##R##_8(a, b, out, k_dim, i, j);            \
+                pico_matmul_cpu_avx_kernel_##R##_8(a, b, out, k_dim, i, j, NULL);      \
             for(; j < cols; j++) /* right strip: R rows x 1 col */                     \
                 for(int r = 0; r < (R); r++)                                           \
                     bench_scalar_cell(a, b, out, k_dim, i + r, j);                     \
@@ -0,0 +1,130 @@
+/*
+ * conv2d benchmark: ResNet-18 layer shapes at batch 1, NHWC. a direct convolution loop
+ * vs PicoConv2d's im2col + GEMM, in GFLOP/s (2 flops per multiply-add).
+ *
+ * Run with `make conv` from bench/. Per layer:
+ *
+ *   direct          — seven nested loops, output channels innermost (contiguous in both
+ *                     the weights and y)
+ *   im2col + GEMM   — always through im2col, even for 1x1 (what the layer would do
+ *                     without its pointwise path)
+ *   forward         — pico_nn_conv2d_forward: 1x1 stride-1 layers read x in place
+ *   fwd + bwd       — forward plus backward, x an input (so dW and no dx): two GEMMs
+ *                     of the forward's size
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "arena.h"
+#include "bench_common.h"
+#include "nn/conv.h"
+#include "reduce/reduce.h"
+
+#define WARMUP 1
+#define ITERS 3
+
+struct layer {
+    const char* name;
+    int hw, c, oc, k, stride, pad;
+};
+
+static void direct(const float* x, const float* w, float* y, const struct PicoConvShape* s) {
+    memset(y, 0, sizeof(float) * s->n * s->oh * s->ow * s->oc);
+    for(int64_t n = 0; n < s->n; n++)
+        for(int64_t p = 0; p < s->oh; p++)
+            for(int64_t q = 0; q < s->ow; q++) {
+                float* out = y + ((n * s->oh + p) * s->ow + q) * s->oc;
+                for(int64_t kh = 0; kh < s->k; kh++) {
+                    int64_t ih = p * s->stride - s->pad + kh;
+                    if(ih < 0 || ih >= s->h) continue;
+                    for(int64_t kw = 0; kw < s->k; kw++) {
+                        int64_t iw = q * s->stride - s->pad + kw;
+                        if(iw < 0 || iw >= s->w) continue;
+                        const float* in = x + ((n * s->h + ih) * s->w + iw) * s->c;
+                        for(int64_t ci = 0; ci < s->c; ci++) {
+                            const float* wr = w + ((kh * s->k + kw) * s->c + ci) * s->oc;
+                            for(int64_t o = 0; o < s->oc; o++) out[o] += in[ci] * wr[o];
+                        }
+                    }
+                }
+            }
+}
+
+static void im2col_gemm(const float* x, float* w, float* y, float* col,
+                        const struct PicoConvShape* s) {
+    int64_t rows = s->n * s->oh * s->ow, kcols = s->k * s->k * s->c;
+    memset(y, 0, sizeof(float) * rows * s->oc);
+    pico_im2col_cpu(x, col, s, 0);
+    struct PicoConvMat am, bm, om;
+    pico_matmul_cpu(pico_conv_mat(&am, col, rows, kcols, kcols, 1),
+                    pico_conv_mat(&bm, w, kcols, s->oc, s->oc, 1),
+                    pico_conv_mat(&om, y, rows, s->oc, s->oc, 1));
+}
+
+int main(void) {
+    pico_init();
+    struct layer layers[] = {
+        {"conv1 7x7/2", 224, 3, 64, 7, 2, 3},
+        {"layer1 3x3", 56, 64, 64, 3, 1, 1},
+        {"layer2 3x3/2", 56, 64, 128, 3, 2, 1},
+        {"layer4 3x3", 7, 512, 512, 3, 1, 1},
+        {"1x1 256->64", 56, 256, 64, 1, 1, 0},
+        {"1x1 64->256", 56, 64, 256, 1, 1, 0},
+    };
+    int n_layers = (int)(sizeof(layers) / sizeof(layers[0]));
+
+    struct Arena* ar = arena_init((size_t)1 << 28);
+    arena_ctx_push(ar);
+
+    printf("\n  conv2d NHWC batch 1, GFLOP/s   (warmup=%d, iters=%d, -O2)\n", WARMUP, ITERS);
+    printf("  %-14s %10s %14s %10s %10s\n", "layer", "direct", "im2col+GEMM", "forward",
+           "fwd+bwd");
+    printf("  ------------------------------------------------------------\n");
+    for(int l = 0; l < n_layers; l++) {
+        struct layer L = layers[l];
+        struct PicoConv2d* conv = pico_nn_conv2d_init(L.c, L.oc, L.k, L.stride, L.pad, 1, 1,
+                                                      false);
+        int64_t xs[] = {1, L.hw, L.hw, L.c};
+        struct PicoTensor* x = pico_param(xs, 4);
+        for(int64_t i = 0; i < x->numel; i++) x->data[i] = (float)(i % 13) * 0.1f - 0.6f;
+        x->requires_grad = 0;
+
+        struct PicoConvShape s = {.n = 1, .h = L.hw, .w = L.hw, .c = L.c, .oc = L.oc,
+                                  .k = L.k, .stride = L.stride, .pad = L.pad, .dilation = 1,
+                                  .groups = 1};
+        s.oh = pico_conv_out_size(s.h, s.k, s.stride, s.pad, 1);
+        s.ow = s.oh;
+        int64_t rows = s.oh * s.ow, kcols = s.k * s.k * s.c;
+        double flops = 2.0 * rows * kcols * s.oc;
+        float* y = malloc(sizeof(float) * rows * s.oc);
+        float* col = malloc(sizeof(float) * rows * kcols);
+
+        double t[4];
+        for(int p = 0; p < 4; p++) {
+            for(int it = -WARMUP; it < ITERS; it++) {
+                if(it == 0) t[p] = bench_now_sec();
+                if(p == 0) direct(x->data, conv->weights->data, y, &s);
+                else if(p == 1) im2col_gemm(x->data, conv->weights->data, y, col, &s);
+                else {
+                    struct PicoTensor* out = pico_nn_conv2d_forward(conv, x);
+                    if(p == 3) pico_backward(ar, pico_sum(out, NULL, 0, false));
+                    arena_reset(ar);
+                }
+            }
+            t[p] = (bench_now_sec() - t[p]) / ITERS;
+        }
+        // the backward's dW GEMM is as big as the forward's (dx is skipped: x is an input)
+        printf("  %-14s %10.2f %14.2f %10.2f %10.2f\n", L.name, flops / t[0] * 1e-9,
+               flops / t[1] * 1e-9, flops / t[2] * 1e-9, 2.0 * flops / t[3] * 1e-9);
+
+        free(y);
+        free(col);
+        pico_free(x);
+        pico_nn_conv2d_free(conv);
+    }
+    printf("\n");
+
+    arena_ctx_pop();
+    arena_destroy(ar);
+    return 0;
+}
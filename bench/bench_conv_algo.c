@@ -0,0 +1,108 @@
+/*
+ * conv algorithm benchmark: the shapes pico_conv_select sends away from im2col + GEMM,
+ * in effective GFLOP/s (the direct conv's 2 flops per multiply-add, whatever the
+ * algorithm actually does), batch 1, NHWC, through pico_conv2d_cpu.
+ *
+ * Run with `make conv_algo` from bench/. Per layer:
+ *
+ *   im2col + GEMM   — the generic path (one GEMM per group: c of them for depthwise)
+ *   scalar          — the selected algorithm with the scalar transforms / loop
+ *   simd            — the selected algorithm at the detected SIMD level
+ *
+ * ResNet 3x3 layers go to Winograd F(2x2, 3x3), MobileNet's depthwise 3x3 layers to
+ * the direct depthwise loop. Gated: max |simd - im2col| is printed per layer.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench_common.h"
+#include "global.h"
+#include "kernels/cpu_kernels.h"
+
+#define WARMUP 1
+#define ITERS 5
+
+struct layer {
+    const char* name;
+    int hw, c, oc, stride, groups;
+};
+
+static double time_conv(const float* x, const float* w, const float* b, float* y,
+                        const struct PicoConvShape* s, enum PicoConvAlgo algo, float* scratch) {
+    double t = 0.0;
+    for(int it = -WARMUP; it < ITERS; it++) {
+        if(it == 0) t = bench_now_sec();
+        pico_conv2d_cpu(x, w, b, y, s, PICO_ACT_NONE, algo, scratch);
+    }
+    return (bench_now_sec() - t) / ITERS;
+}
+
+int main(void) {
+    pico_init();
+    SimdLevel level = g_simd_level;
+    struct layer layers[] = {
+        {"res 56 c64", 56, 64, 64, 1, 1},
+        {"res 28 c128", 28, 128, 128, 1, 1},
+        {"res 14 c256", 14, 256, 256, 1, 1},
+        {"res 7 c512", 7, 512, 512, 1, 1},
+        {"dw 112 c32", 112, 32, 32, 1, 32},
+        {"dw 56 c128/2", 56, 128, 128, 2, 128},
+        {"dw 14 c512", 14, 512, 512, 1, 512},
+        {"dw 7 c1024", 7, 1024, 1024, 1, 1024},
+    };
+    int n_layers = (int)(sizeof(layers) / sizeof(layers[0]));
+
+    printf("\n  conv algorithms, 3x3 NHWC batch 1, effective GFLOP/s   (warmup=%d, iters=%d, "
+           "-O2)\n",
+           WARMUP, ITERS);
+    printf("  %-14s %-10s %12s %10s %10s %10s\n", "layer", "algo", "im2col+GEMM", "scalar",
+           "simd", "max err");
+    printf("  ---------------------------------------------------------------------\n");
+    for(int l = 0; l < n_layers; l++) {
+        struct layer L = layers[l];
+        struct PicoConvShape s = {.n = 1, .h = L.hw, .w = L.hw, .c = L.c, .oc = L.oc, .k = 3,
+                                  .stride = L.stride, .pad = 1, .dilation = 1,
+                                  .groups = L.groups};
+        s.oh = pico_conv_out_size(s.h, 3, s.stride, 1, 1);
+        s.ow = s.oh;
+        enum PicoConvAlgo algo = pico_conv_select(&s);
+
+        int64_t xn = s.h * s.w * s.c, yn = s.oh * s.ow * s.oc;
+        int64_t wn = 9 * (s.c / s.groups) * s.oc;
+        float* x = malloc(sizeof(float) * xn);
+        float* w = malloc(sizeof(float) * wn);
+        float* b = malloc(sizeof(float) * s.oc);
+        float* ref = malloc(sizeof(float) * yn);
+        float* y = malloc(sizeof(float) * yn);
+        int64_t scratch_floats = pico_conv_scratch_floats(&s, PICO_CONV_IM2COL);
+        if(pico_conv_scratch_floats(&s, algo) > scratch_floats)
+            scratch_floats = pico_conv_scratch_floats(&s, algo);
+        float* scratch = malloc(sizeof(float) * scratch_floats);
+        for(int64_t i = 0; i < xn; i++) x[i] = (float)(i % 13) * 0.1f - 0.6f;
+        for(int64_t i = 0; i < wn; i++) w[i] = (float)(i % 7) * 0.05f - 0.15f;
+        for(int64_t i = 0; i < s.oc; i++) b[i] = 0.01f * (float)(i % 5);
+
+        double flops = 2.0 * yn * 9 * (s.c / s.groups);
+        double t_gemm = time_conv(x, w, b, ref, &s, PICO_CONV_IM2COL, scratch);
+        g_simd_level = SIMD_NONE;
+        double t_scalar = time_conv(x, w, b, y, &s, algo, scratch);
+        g_simd_level = level;
+        double t_simd = time_conv(x, w, b, y, &s, algo, scratch);
+
+        float err = 0.0f;
+        for(int64_t i = 0; i < yn; i++) err = fmaxf(err, fabsf(y[i] - ref[i]));
+        printf("  %-14s %-10s %12.2f %10.2f %10.2f %10.1e\n", L.name,
+               algo == PICO_CONV_WINOGRAD ? "winograd" : "depthwise", flops / t_gemm * 1e-9,
+               flops / t_scalar * 1e-9, flops / t_simd * 1e-9, err);
+
+        free(x);
+        free(w);
+        free(b);
+        free(ref);
+        free(y);
+        free(scratch);
+    }
+    printf("\n");
+    return 0;
+}
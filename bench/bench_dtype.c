@@ -0,0 +1,141 @@
+/*
+ * mixed-precision benchmark: fp32 vs bf16 vs fp16 storage.
+ *
+ * Run with `make dtype` from bench/. Two tables:
+ *
+ *   matmul      — x[M, K] @ W[K, N] with W stored fp32 / bf16 / fp16, through
+ *                 pico_matmul_cpu (the AVX kernels load the half W and widen it in
+ *                 registers; accumulation is fp32). Skinny M is the inference case:
+ *                 every weight is used M times, so the GEMM streams W from memory and
+ *                 half the bytes is close to half the time. At M = 512 the smaller
+ *                 W panels still stay in cache longer. Gated against the fp32 matmul
+ *                 on the widened W.
+ *   activations — relu / sigmoid forward over 8M elements through pico_*_cpu, fp32 vs
+ *                 bf16 in and out (widen -> fp32 kernel -> narrow, per tile).
+ *
+ * Forced to the AVX2 matmul path (pico_matmul_cpu has no AVX-512 matmul) and to the
+ * widest level for the activations.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench_common.h"
+
+#define WARMUP 2
+#define ITERS 10
+
+static void fill(struct PicoTensor* t, int salt) {
+    for(int64_t i = 0; i < t->numel; i++) {
+        pico_tensor_set(t, i, (float)((i * 37 + salt) % 23 - 11) / 11.0f);
+    }
+}
+
+static double time_matmul(struct PicoTensor* x, struct PicoTensor* w, struct PicoTensor* out) {
+    for(int it = 0; it < WARMUP; it++) {
+        memset(out->data, 0, sizeof(float) * out->numel);
+        pico_matmul_cpu(x, w, out);
+    }
+    double t0 = bench_now_sec();
+    for(int it = 0; it < ITERS; it++) {
+        memset(out->data, 0, sizeof(float) * out->numel);
+        pico_matmul_cpu(x, w, out);
+    }
+    return (bench_now_sec() - t0) / (double)ITERS;
+}
+
+static double time_act(void (*fn)(struct PicoTensor*, struct PicoTensor*), struct PicoTensor* x,
+                       struct PicoTensor* y) {
+    for(int it = 0; it < WARMUP; it++) fn(x, y);
+    double t0 = bench_now_sec();
+    for(int it = 0; it < ITERS; it++) fn(x, y);
+    return (bench_now_sec() - t0) / (double)ITERS;
+}
+
+int main(void) {
+    pico_init();
+    int has_avx512 = __builtin_cpu_supports("avx512f");
+    if(!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("f16c")) {
+        printf("needs AVX2 + F16C\n");
+        return 0;
+    }
+
+    int64_t shapes[][3] = {{1, 4096, 4096}, {8, 4096, 4096}, {32, 2048, 2048}, {512, 512, 512}};
+    int n_shapes = (int)(sizeof(shapes) / sizeof(shapes[0]));
+    PicoDType dtypes[] = {PICO_F32, PICO_BF16, PICO_F16};
+    const char* names[] = {"fp32", "bf16", "fp16"};
+
+    g_simd_level = SIMD_AVX2;
+    printf("\n  pico matmul, W stored fp32 / bf16 / fp16   (warmup=%d, iters=%d, -O2, avx2)\n",
+           WARMUP, ITERS);
+    printf("  %-18s %-6s %10s %10s %9s %8s\n", "M x K x N", "W", "ms", "GFLOP/s", "vs fp32",
+           "correct");
+    printf("  ------------------------------------------------------------------\n");
+    for(int s = 0; s < n_shapes; s++) {
+        int64_t M = shapes[s][0], K = shapes[s][1], N = shapes[s][2];
+        int64_t sx[] = {M, K}, sw[] = {K, N}, so[] = {M, N};
+        struct PicoTensor* x = pico_param(sx, 2);
+        struct PicoTensor* ref = pico_param(so, 2);
+        struct PicoTensor* out = pico_param(so, 2);
+        fill(x, 1);
+
+        double t_f32 = 0.0;
+        for(int d = 0; d < 3; d++) {
+            struct PicoTensor* w = pico_param_dtype(sw, 2, dtypes[d]);
+            fill(w, 2);
+
+            // gate: the fp32 matmul on the widened W
+            struct PicoTensor* w32 = pico_param(sw, 2);
+            for(int64_t i = 0; i < w->numel; i++) w32->data[i] = pico_tensor_get(w, i);
+            memset(ref->data, 0, sizeof(float) * ref->numel);
+            pico_matmul_cpu(x, w32, ref);
+            memset(out->data, 0, sizeof(float) * out->numel);
+            pico_matmul_cpu(x, w, out);
+            float diff = 0.0f;
+            for(int64_t i = 0; i < out->numel; i++) {
+                diff = fmaxf(diff, fabsf(out->data[i] - ref->data[i]));
+            }
+
+            double t = time_matmul(x, w, out);
+            if(d == 0) t_f32 = t;
+            char shape[32];
+            snprintf(shape, sizeof(shape), "%ldx%ldx%ld", (long)M, (long)K, (long)N);
+            printf("  %-18s %-6s %10.3f %10.2f %8.2fx %8s\n", shape, names[d], t * 1e3,
+                   2.0 * M * K * N / t * 1e-9, t_f32 / t, diff <= 1e-3f ? "ok" : "MISMATCH");
+            pico_free(w);
+            pico_free(w32);
+        }
+        pico_free(x);
+        pico_free(ref);
+        pico_free(out);
+    }
+
+    g_simd_level = has_avx512 ? SIMD_AVX512 : SIMD_AVX2;
+    int64_t n = 1 << 23;
+    int64_t sa[] = {n};
+    printf("\n  pico activations forward, fp32 vs bf16 storage   (numel=%ld, threaded=%s)\n",
+           (long)n, has_avx512 ? "avx512" : "avx2");
+    printf("  %-8s %-6s %10s %12s %9s\n", "act", "dtype", "ms", "Gelem/s", "vs fp32");
+    printf("  ----------------------------------------------------\n");
+    struct {
+        const char* name;
+        void (*fn)(struct PicoTensor*, struct PicoTensor*);
+    } acts[] = {{"relu", pico_relu_cpu}, {"sigmoid", pico_sigmoid_cpu}};
+    for(int a = 0; a < 2; a++) {
+        double t_f32 = 0.0;
+        for(int d = 0; d < 2; d++) {
+            struct PicoTensor* x = pico_param_dtype(sa, 1, dtypes[d]);
+            struct PicoTensor* y = pico_param_dtype(sa, 1, dtypes[d]);
+            fill(x, 3);
+            double t = time_act(acts[a].fn, x, y);
+            if(d == 0) t_f32 = t;
+            printf("  %-8s %-6s %10.3f %12.3f %8.2fx\n", acts[a].name, names[d], t * 1e3,
+                   n / t * 1e-9, t_f32 / t);
+            pico_free(x);
+            pico_free(y);
+        }
+    }
+    printf("\n");
+    return 0;
+}
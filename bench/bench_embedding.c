@@ -0,0 +1,104 @@
+/*
+ * embedding benchmark: one training step on a lookup table (gather forward, backward
+ * of a sum, optimizer step, zero grad) with a dense grad vs the sparse row grad, for
+ * vocabularies from 10K to 400K rows of 64 floats and a batch of 4096 ids.
+ *
+ * Run with `make embedding` from bench/. Per table size and optimizer, ms per step:
+ *
+ *   dense   — weights->grad the size of the table: the scatter touches batch rows,
+ *             but the step and zero_grad sweep every row
+ *   sparse  — the grad lists the touched rows; the step and clear touch only them
+ *   grad MB — the dense grad vs the sparse grad after the backward
+ *
+ * ids are drawn with a skew (a few hot rows, a long tail), like token or item ids.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "arena.h"
+#include "bench_common.h"
+#include "nn/embedding.h"
+#include "optim/optim.h"
+#include "reduce/reduce.h"
+
+#define WARMUP 1
+#define ITERS 5
+#define DIM 64
+#define BATCH 4096
+
+// one step with whichever optimizer is given; the grad bytes held after the backward
+static double step(struct Arena* ar, struct PicoEmbedding* emb, struct PicoTensor* ids,
+                   struct PicoOptimSGD* sgd, struct PicoOptim* adam) {
+    struct PicoTensor* y = pico_nn_embedding_forward(emb, ids);
+    pico_backward(ar, pico_sum(y, NULL, 0, false));
+    double bytes = emb->sparse ? (double)emb->grad.n * (DIM * sizeof(float) + sizeof(int64_t))
+                               : (double)emb->weights->numel * sizeof(float);
+    if(sgd != NULL) {
+        pico_optim_sgd_step(sgd);
+        pico_optim_sgd_zero_grad(sgd);
+    } else {
+        pico_optim_step(adam);
+        pico_optim_zero_grad(adam);
+    }
+    arena_reset(ar);
+    return bytes;
+}
+
+int main(void) {
+    pico_init();
+    int vocabs[] = {10000, 50000, 200000, 400000};
+    int n_vocabs = (int)(sizeof(vocabs) / sizeof(vocabs[0]));
+
+    struct Arena* ar = arena_init((size_t)1 << 26);
+    arena_ctx_push(ar);
+    int64_t is[] = {BATCH};
+
+    printf("\n  embedding step, dim %d, batch %d, ms/step   (warmup=%d, iters=%d, -O2)\n", DIM,
+           BATCH, WARMUP, ITERS);
+    printf("  %-8s %-5s %10s %10s %9s %12s %12s\n", "vocab", "optim", "dense", "sparse",
+           "speedup", "dense grad", "sparse grad");
+    printf("  ---------------------------------------------------------------------------\n");
+    for(int v = 0; v < n_vocabs; v++) {
+        for(int kind = 0; kind < 2; kind++) {
+            double t[2], bytes[2];
+            for(int sparse = 0; sparse < 2; sparse++) {
+                struct PicoEmbedding* emb = pico_nn_embedding_init(vocabs[v], DIM, sparse);
+                struct PicoOptimSGD* sgd = kind == 0 ? pico_optim_sgd_init(0.1f) : NULL;
+                struct PicoOptim* adam = kind == 1 ? pico_optim_adam_init(1e-3f, 0.9f, 0.999f)
+                                                   : NULL;
+                if(sgd != NULL && sparse) pico_optim_sgd_add_sparse(sgd, emb->weights, &emb->grad);
+                else if(sgd != NULL) pico_optim_sgd_add(sgd, emb->weights);
+                else if(sparse) pico_optim_add_sparse(adam, emb->weights, &emb->grad);
+                else pico_optim_add(adam, emb->weights);
+
+                for(int it = -WARMUP; it < ITERS; it++) {
+                    if(it == 0) t[sparse] = bench_now_sec();
+                    struct PicoTensor* ids = pico_create_tensor(ar, is, 1);
+                    unsigned r = 12345u + (unsigned)it;
+                    for(int i = 0; i < BATCH; i++) {
+                        r = r * 1664525u + 1013904223u;
+                        unsigned u = r >> 8;
+                        // half the ids from the 1% hottest rows, the rest uniform
+                        int hot = vocabs[v] / 100;
+                        ids->data[i] = (float)(i % 2 ? u % hot : u % vocabs[v]);
+                    }
+                    ids->requires_grad = 0;
+                    bytes[sparse] = step(ar, emb, ids, sgd, adam);
+                }
+                t[sparse] = (bench_now_sec() - t[sparse]) / ITERS;
+
+                if(sgd != NULL) pico_optim_sgd_free(sgd);
+                if(adam != NULL) pico_optim_free(adam);
+                pico_nn_embedding_free(emb);
+            }
+            printf("  %-8d %-5s %10.3f %10.3f %8.1fx %10.2fMB %10.2fMB\n", vocabs[v],
+                   kind == 0 ? "sgd" : "adam", t[0] * 1e3, t[1] * 1e3, t[0] / t[1],
+                   bytes[0] / (1 << 20), bytes[1] / (1 << 20));
+        }
+    }
+    printf("\n");
+
+    arena_ctx_pop();
+    arena_destroy(ar);
+    return 0;
+}
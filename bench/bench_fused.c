@@ -0,0 +1,93 @@
+/*
+ * fused benchmark: relu(a*b + c) as ONE fused op vs the unfused chain
+ * pico_mul -> pico_add -> pico_relu.
+ *
+ * Run with `make fused` from bench/. Both sides go through the real ops (arena
+ * allocation + graph wiring included), because the extra arena tensors are part
+ * of what fusion saves. The arena is reset between iterations like a training step.
+ *
+ * Elementwise chains are memory-bound: the unfused chain moves ~9 floats per
+ * element (3 reads + 1 write for mul/add, 1+1 for relu, + grads zeroed by create),
+ * the fused op 4. Expect the gap to grow once the working set leaves cache.
+ */
+#include <math.h>
+#include <stdio.h>
+
+#include "act/activations.h"
+#include "arena.h"
+#include "bench_common.h"
+#include "fused/fused.h"
+#include "ops.h"
+
+#define WARMUP 3
+#define ITERS 20
+
+static double time_chain(int fused, struct Arena* ar, struct PicoTensor* a, struct PicoTensor* b,
+                         struct PicoTensor* c) {
+    for(int w = 0; w < WARMUP; w++) {
+        if(fused)
+            pico_mul_add_relu(a, b, c);
+        else
+            pico_relu(pico_add(pico_mul(a, b), c));
+        arena_reset(ar);
+    }
+    double t0 = bench_now_sec();
+    for(int it = 0; it < ITERS; it++) {
+        if(fused)
+            pico_mul_add_relu(a, b, c);
+        else
+            pico_relu(pico_add(pico_mul(a, b), c));
+        arena_reset(ar);
+    }
+    return (bench_now_sec() - t0) / (double)ITERS;
+}
+
+int main(void) {
+    pico_init();
+
+    int64_t sizes[] = {1 << 12, 1 << 16, 1 << 20, 1 << 23};
+    int n_sizes = (int)(sizeof(sizes) / sizeof(sizes[0]));
+
+    printf("\n  pico fused relu(a*b + c)   (warmup=%d, iters=%d, -O2)\n", WARMUP, ITERS);
+    printf("  %-10s %12s %12s %10s %10s\n", "numel", "chain ms", "fused ms", "speedup",
+           "correct");
+    printf("  ------------------------------------------------------------\n");
+
+    for(int s = 0; s < n_sizes; s++) {
+        int64_t n = sizes[s];
+        int64_t shape[] = {n};
+        struct PicoTensor* a = pico_param(shape, 1);
+        struct PicoTensor* b = pico_param(shape, 1);
+        struct PicoTensor* c = pico_param(shape, 1);
+        for(int64_t i = 0; i < n; i++) {
+            a->data[i] = (float)((i % 13) - 6) * 0.25f;
+            b->data[i] = (float)((i % 7) - 3) * 0.5f;
+            c->data[i] = 0.125f;
+        }
+
+        // each chain step allocates data + grad, so size the arena for the chain
+        struct Arena* ar = arena_init((size_t)n * sizeof(float) * 8 + (1 << 16));
+        arena_ctx_push(ar);
+
+        // correctness gate: fused must match the chain before timing means anything
+        struct PicoTensor* ref = pico_relu(pico_add(pico_mul(a, b), c));
+        struct PicoTensor* out = pico_mul_add_relu(a, b, c);
+        float diff = bench_max_abs_diff(out, ref);
+        arena_reset(ar);
+
+        double t_chain = time_chain(0, ar, a, b, c);
+        double t_fused = time_chain(1, ar, a, b, c);
+
+        printf("  %-10ld %12.3f %12.3f %9.2fx %10s\n", (long)n, t_chain * 1e3, t_fused * 1e3,
+               t_chain / t_fused, diff <= 1e-5f ? "ok" : "MISMATCH");
+
+        arena_ctx_pop();
+        arena_destroy(ar);
+        pico_free(a);
+        pico_free(b);
+        pico_free(c);
+    }
+
+    printf("\n");
+    return 0;
+}
@@ -0,0 +1,102 @@
+/*
+ * weight init benchmark: the per-element loop a model would otherwise write (libc
+ * rand(), Box-Muller per value, rejection for the truncated normal) vs the nn/init.h
+ * initializers on the threaded Philox fills.
+ *
+ * Run with `make init` from bench/. Per param size, in Gfloat/s:
+ *
+ *   kaiming_uniform  — rand() scaled to +-bound, then pico_nn_init_kaiming_uniform
+ *   kaiming_normal   — rand() Box-Muller, then pico_nn_init_kaiming_normal
+ *   trunc_normal     — rand() Box-Muller redrawn until inside +-2 std (the ViT / GPT-2
+ *                      init), then pico_nn_init_trunc_normal: one uniform draw mapped
+ *                      through erfinv, no rejection
+ *   bf16 normal      — pico_nn_init_kaiming_normal into a bf16 param (fill + one narrow)
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench_common.h"
+#include "nn/init.h"
+#include "rng/rng.h"
+
+#define WARMUP 1
+#define ITERS 5
+
+static float rand_unit(void) {
+    return ((float)rand() + 1.0f) / ((float)RAND_MAX + 2.0f);  // (0, 1)
+}
+
+static float rand_normal(void) {
+    return sqrtf(-2.0f * logf(rand_unit())) * cosf(2.0f * PI_F * rand_unit());
+}
+
+enum scheme { UNIFORM, NORMAL, TRUNC, SCHEMES };
+
+static void loop_init(enum scheme s, float* out, int64_t n, int64_t fan_in) {
+    float std = 1.0f / sqrtf((float)fan_in);
+    for(int64_t i = 0; i < n; i++) {
+        switch(s) {
+            case UNIFORM: out[i] = (2.0f * rand_unit() - 1.0f) * sqrtf(3.0f) * std; break;
+            case NORMAL: out[i] = std * rand_normal(); break;
+            default: {
+                float z;
+                do z = rand_normal();
+                while(z < -2.0f || z > 2.0f);
+                out[i] = std * z;
+            }
+        }
+    }
+}
+
+static void pico_init_scheme(enum scheme s, struct PicoTensor* t, int64_t fan_in) {
+    float std = 1.0f / sqrtf((float)fan_in);
+    switch(s) {
+        case UNIFORM: pico_nn_init_kaiming_uniform(t, PICO_FAN_IN, 1.0f); break;
+        case NORMAL: pico_nn_init_kaiming_normal(t, PICO_FAN_IN, 1.0f); break;
+        default: pico_nn_init_trunc_normal(t, 0.0f, std, -2.0f * std, 2.0f * std);
+    }
+}
+
+static double gfloats_loop(enum scheme s, float* out, int64_t n, int64_t fan_in) {
+    for(int w = 0; w < WARMUP; w++) loop_init(s, out, n, fan_in);
+    double t0 = bench_now_sec();
+    for(int it = 0; it < ITERS; it++) loop_init(s, out, n, fan_in);
+    return (double)n * ITERS / (bench_now_sec() - t0) * 1e-9;
+}
+
+static double gfloats_pico(enum scheme s, struct PicoTensor* t, int64_t fan_in) {
+    for(int w = 0; w < WARMUP; w++) pico_init_scheme(s, t, fan_in);
+    double t0 = bench_now_sec();
+    for(int it = 0; it < ITERS; it++) pico_init_scheme(s, t, fan_in);
+    return (double)t->numel * ITERS / (bench_now_sec() - t0) * 1e-9;
+}
+
+int main(void) {
+    pico_init();
+    int64_t shapes[][2] = {{256, 256}, {1024, 1024}, {4096, 4096}};
+    int n_shapes = (int)(sizeof(shapes) / sizeof(shapes[0]));
+    const char* names[] = {"kaiming_uniform", "kaiming_normal", "trunc_normal"};
+
+    printf("\n  weight init, Gfloat/s   (warmup=%d, iters=%d, -O2)\n", WARMUP, ITERS);
+    printf("  %-12s %-16s %10s %10s %9s\n", "param", "scheme", "loop", "pico", "speedup");
+    printf("  ------------------------------------------------------------\n");
+    for(int s = 0; s < n_shapes; s++) {
+        struct PicoTensor* w = pico_param(shapes[s], 2);
+        struct PicoTensor* h = pico_param_dtype(shapes[s], 2, PICO_BF16);
+        char pbuf[32];
+        snprintf(pbuf, sizeof(pbuf), "%lldx%lld", (long long)shapes[s][0],
+                 (long long)shapes[s][1]);
+        for(int k = 0; k < SCHEMES; k++) {
+            double l = gfloats_loop(k, w->data, w->numel, shapes[s][0]);
+            double p = gfloats_pico(k, w, shapes[s][0]);
+            printf("  %-12s %-16s %10.3f %10.3f %8.1fx\n", k == 0 ? pbuf : "", names[k], l, p,
+                   p / l);
+        }
+        double b = gfloats_pico(NORMAL, h, shapes[s][0]);
+        printf("  %-12s %-16s %10s %10.3f\n", "", "bf16 normal", "", b);
+        pico_free(w);
+        pico_free(h);
+    }
+    printf("\n");
+    return 0;
+}
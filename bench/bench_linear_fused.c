@@ -0,0 +1,101 @@
+/*
+ * linear_fused benchmark: relu(x @ W + b) through the fused Linear forward
+ * (bias + relu in the GEMM epilogue, one node) vs the unfused chain
+ * pico_matmul -> pico_add -> pico_relu (three nodes).
+ *
+ * Run with `make linear_fused` from bench/. Both sides go through the real ops with
+ * pico_init()'s SIMD level, and the arena is reset between iterations like a
+ * training step. Reported separately: forward only, and forward + backward.
+ *
+ * The GEMM dominates at large K, so expect the gap to be the largest for small-K /
+ * wide-N layers, where the unfused bias add (map_index broadcast) and relu passes
+ * are a big fraction of the work.
+ */
+#include <math.h>
+#include <stdio.h>
+
+#include "act/activations.h"
+#include "arena.h"
+#include "bench_common.h"
+#include "nn/linear.h"
+#include "ops.h"
+
+#define WARMUP 2
+#define ITERS 10
+
+struct shape {
+    const char* name;
+    int batch, in, out;
+};
+
+static struct PicoTensor* forward(int fused, struct PicoLinear* fc, struct PicoTensor* x) {
+    if(fused) return pico_nn_linear_forward_act(fc, x, PICO_ACT_RELU);
+    return pico_relu(pico_add(pico_matmul(x, fc->weights), fc->bias));
+}
+
+static double time_linear(int fused, int backward, struct Arena* ar, struct PicoLinear* fc,
+                          struct PicoTensor* x) {
+    for(int w = 0; w < WARMUP; w++) {
+        struct PicoTensor* y = forward(fused, fc, x);
+        if(backward) pico_backward(ar, y);
+        arena_reset(ar);
+    }
+    double t0 = bench_now_sec();
+    for(int it = 0; it < ITERS; it++) {
+        struct PicoTensor* y = forward(fused, fc, x);
+        if(backward) pico_backward(ar, y);
+        arena_reset(ar);
+    }
+    return (bench_now_sec() - t0) / (double)ITERS;
+}
+
+int main(void) {
+    pico_init();
+
+    struct shape shapes[] = {
+        {"mlp hidden   256x512 -> 512", 256, 512, 512},
+        {"wide-N       512x64 -> 1024", 512, 64, 1024},
+        {"small batch   32x784 -> 128", 32, 784, 128},
+    };
+    int n_shapes = (int)(sizeof(shapes) / sizeof(shapes[0]));
+
+    printf("\n  pico fused Linear relu(x@W + b)   (warmup=%d, iters=%d, -O2)\n", WARMUP, ITERS);
+
+    for(int s = 0; s < n_shapes; s++) {
+        size_t out_bytes = (size_t)shapes[s].batch * shapes[s].out * sizeof(float);
+        struct Arena* ar = arena_init(out_bytes * 12 + (1 << 20));
+        arena_ctx_push(ar);  // pico_nn_linear_init wants a current arena too
+
+        struct PicoLinear* fc = pico_nn_linear_init(shapes[s].in, shapes[s].out, true);
+        int64_t sx[] = {shapes[s].batch, shapes[s].in};
+        struct PicoTensor* x = pico_param(sx, 2);
+        for(int64_t i = 0; i < fc->weights->numel; i++)
+            fc->weights->data[i] = (float)((i % 13) - 6) * 0.0625f;
+        for(int64_t i = 0; i < fc->bias->numel; i++) fc->bias->data[i] = (float)((i % 5) - 2);
+        for(int64_t i = 0; i < x->numel; i++) x->data[i] = (float)((i % 7) - 3) * 0.125f;
+
+        // correctness gate: fused must match the chain
+        float diff = bench_max_abs_diff(forward(1, fc, x), forward(0, fc, x));
+        arena_reset(ar);
+
+        double chain_f = time_linear(0, 0, ar, fc, x);
+        double fused_f = time_linear(1, 0, ar, fc, x);
+        double chain_fb = time_linear(0, 1, ar, fc, x);
+        double fused_fb = time_linear(1, 1, ar, fc, x);
+
+        printf("\n  %s   [%s]\n", shapes[s].name, diff <= 1e-3f ? "ok" : "MISMATCH");
+        printf("  %-12s %12s %12s %10s\n", "", "chain ms", "fused ms", "speedup");
+        printf("  %-12s %12.3f %12.3f %9.2fx\n", "forward", chain_f * 1e3, fused_f * 1e3,
+               chain_f / fused_f);
+        printf("  %-12s %12.3f %12.3f %9.2fx\n", "fwd + bwd", chain_fb * 1e3, fused_fb * 1e3,
+               chain_fb / fused_fb);
+
+        arena_ctx_pop();
+        arena_destroy(ar);
+        pico_free(x);
+        pico_nn_linear_free(fc);
+    }
+
+    printf("\n");
+    return 0;
+}
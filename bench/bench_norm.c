@@ -0,0 +1,103 @@
+/*
+ * layernorm / rmsnorm benchmark on transformer-sized activations [rows, d], in GB/s of
+ * x read (4 bytes per element per op call, whatever the passes).
+ *
+ * Run with `make norm` from bench/. Per shape:
+ *
+ *   chain       — layernorm out of the existing ops: mean, sub, mul, mean, + eps,
+ *                 1 / sqrt as exp(-log / 2) (there is no div op), mul, * w, + b
+ *   scalar      — pico_layernorm with the scalar kernels
+ *   simd        — pico_layernorm at the detected SIMD level
+ *   fwd+bwd     — the chain vs pico_layernorm, forward + backward into x, w and b
+ *   rms         — pico_rmsnorm, forward
+ *
+ * Each iteration resets the arena, so every op pays for its fresh (zeroed) tensors.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "arena.h"
+#include "bench_common.h"
+#include "norm/norm.h"
+#include "ops.h"
+#include "reduce/reduce.h"
+
+#define WARMUP 2
+#define ITERS 10
+
+static struct PicoTensor* chain_layernorm(struct PicoTensor* x, struct PicoTensor* w,
+                                          struct PicoTensor* b) {
+    int axis[] = {-1};
+    struct PicoTensor* xc = pico_sub(x, pico_mean(x, axis, 1, true));
+    struct PicoTensor* var = pico_mean(pico_mul(xc, xc), axis, 1, true);
+    struct PicoTensor* lv = pico_tensor_log(pico_add(var, pico_tensor_from_scalar(1e-5f)));
+    struct PicoTensor* rstd = pico_tensor_exp(pico_mul(lv, pico_tensor_from_scalar(-0.5f)));
+    return pico_add(pico_mul(pico_mul(xc, rstd), w), b);
+}
+
+// mode 0 chain, 1 layernorm, 2 rmsnorm; backward through a sum when bwd
+static double run(struct Arena* ar, int mode, bool bwd, struct PicoTensor* x,
+                  struct PicoTensor* w, struct PicoTensor* b) {
+    double t = 0.0;
+    for(int it = -WARMUP; it < ITERS; it++) {
+        if(it == 0) t = bench_now_sec();
+        struct PicoTensor* y = mode == 0   ? chain_layernorm(x, w, b)
+                               : mode == 1 ? pico_layernorm(x, w, b, 1e-5f)
+                                           : pico_rmsnorm(x, w, 1e-5f);
+        if(bwd) pico_backward(ar, pico_sum(y, NULL, 0, false));
+        arena_reset(ar);
+    }
+    return (bench_now_sec() - t) / ITERS;
+}
+
+int main(void) {
+    pico_init();
+    SimdLevel level = g_simd_level;
+    int64_t shapes[][2] = {{512, 768}, {4096, 768}, {2048, 4096}, {64, 16384}};
+    int n_shapes = (int)(sizeof(shapes) / sizeof(shapes[0]));
+
+    struct Arena* ar = arena_init((size_t)1 << 30);
+    arena_ctx_push(ar);
+
+    printf("\n  layernorm / rmsnorm, GB/s of x   (warmup=%d, iters=%d, -O2)\n", WARMUP, ITERS);
+    printf("  %-12s %8s %8s %8s %12s %12s %8s %8s\n", "[rows, d]", "chain", "scalar", "simd",
+           "chain f+b", "norm f+b", "speedup", "rms");
+    printf("  ------------------------------------------------------------------------------\n");
+    for(int i = 0; i < n_shapes; i++) {
+        int64_t xs[] = {shapes[i][0], shapes[i][1]}, ps[] = {shapes[i][1]};
+        struct PicoTensor* x = pico_param(xs, 2);
+        struct PicoTensor* w = pico_param(ps, 1);
+        struct PicoTensor* b = pico_param(ps, 1);
+        for(int64_t j = 0; j < x->numel; j++) x->data[j] = (float)(j % 17) * 0.1f - 0.8f;
+        for(int64_t j = 0; j < w->numel; j++) {
+            w->data[j] = 1.0f + 0.01f * (float)(j % 5);
+            b->data[j] = 0.02f * (float)(j % 3);
+        }
+        double gb = (double)x->numel * sizeof(float) * 1e-9;
+
+        double t_chain = run(ar, 0, false, x, w, b);
+        g_simd_level = SIMD_NONE;
+        double t_scalar = run(ar, 1, false, x, w, b);
+        g_simd_level = level;
+        double t_simd = run(ar, 1, false, x, w, b);
+        double t_chain_bwd = run(ar, 0, true, x, w, b);
+        double t_norm_bwd = run(ar, 1, true, x, w, b);
+        double t_rms = run(ar, 2, false, x, w, b);
+
+        char name[32];
+        snprintf(name, sizeof(name), "[%lld, %lld]", (long long)xs[0], (long long)xs[1]);
+        printf("  %-12s %8.2f %8.2f %8.2f %12.2f %12.2f %7.1fx %8.2f\n", name, gb / t_chain,
+               gb / t_scalar, gb / t_simd, gb / t_chain_bwd, gb / t_norm_bwd,
+               t_chain_bwd / t_norm_bwd, gb / t_rms);
+
+        pico_free(x);
+        pico_free(w);
+        pico_free(b);
+    }
+    printf("\n");
+
+    arena_ctx_pop();
+    arena_destroy(ar);
+    return 0;
+}
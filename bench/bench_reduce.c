@@ -0,0 +1,86 @@
+/*
+ * reduction benchmark: sum and max over the inner axis vs an outer axis, scalar vs
+ * AVX2 vs AVX-512.
+ *
+ * Run with `make reduce` from bench/. Calls pico_reduce_ori_cpu (the dispatcher the
+ * ops use, threads included) on raw buffers, at each SIMD level. x is [rows, cols]:
+ *   inner — y[r] = op_c x[r, c]   contiguous rows, horizontal tree at the end
+ *   outer — y[c] = op_r x[r, c]   column sweep, vertical accumulate, no shuffles
+ * Reported as GB/s of x read. Both are bandwidth-bound at DRAM sizes; the gap at
+ * L2 sizes is what the layout costs. The sum is checked against a double reference
+ * (pairwise / Kahan should keep the relative error ~1e-7 regardless of length).
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench_common.h"
+
+#define WARMUP 3
+#define ITERS 30
+
+static double time_reduce(enum PicoReduceOp op, const float* x, float* y, int64_t O, int64_t R,
+                          int64_t I) {
+    for(int w = 0; w < WARMUP; w++) pico_reduce_ori_cpu(op, x, y, O, R, I);
+    double t0 = bench_now_sec();
+    for(int it = 0; it < ITERS; it++) pico_reduce_ori_cpu(op, x, y, O, R, I);
+    return (bench_now_sec() - t0) / (double)ITERS;
+}
+
+int main(void) {
+    pico_init();
+    int has_avx512 = __builtin_cpu_supports("avx512f");
+    SimdLevel levels[] = {SIMD_NONE, SIMD_AVX2, SIMD_AVX512};
+    int64_t shapes[][2] = {{256, 256}, {1024, 1024}, {64, 65536}, {65536, 64}, {4096, 4096}};
+    int n_shapes = (int)(sizeof(shapes) / sizeof(shapes[0]));
+
+    printf("\n  pico reductions GB/s   (warmup=%d, iters=%d, -O2)\n", WARMUP, ITERS);
+    printf("  %-12s %-6s %-4s %9s %9s %9s %12s\n", "shape", "axis", "op", "scalar", "avx2",
+           "avx512", "sum rel err");
+    printf("  ------------------------------------------------------------------------\n");
+
+    for(int s = 0; s < n_shapes; s++) {
+        int64_t rows = shapes[s][0], cols = shapes[s][1];
+        int64_t n = rows * cols;
+        float* x = malloc((size_t)n * sizeof(float));
+        float* y = malloc((size_t)(rows > cols ? rows : cols) * sizeof(float));
+        for(int64_t i = 0; i < n; i++) x[i] = (float)((i * 7919) % 1013) * 1e-3f;
+
+        for(int outer = 0; outer < 2; outer++) {
+            // inner: O=rows, R=cols, I=1     outer: O=1, R=rows, I=cols
+            int64_t O = outer ? 1 : rows, R = outer ? rows : cols, I = outer ? cols : 1;
+            int64_t n_out = O * I;
+
+            // double reference for the sum, worst relative error at the widest level
+            g_simd_level = has_avx512 ? SIMD_AVX512 : SIMD_AVX2;
+            pico_reduce_ori_cpu(PICO_REDUCE_SUM, x, y, O, R, I);
+            double err = 0.0;
+            for(int64_t k = 0; k < n_out; k++) {
+                double want = 0.0;
+                for(int64_t r = 0; r < R; r++) {
+                    want += outer ? x[r * cols + k] : x[k * cols + r];
+                }
+                err = fmax(err, fabs(y[k] - want) / fabs(want));
+            }
+
+            for(int op = 0; op < 2; op++) {
+                double gbs[3] = {NAN, NAN, NAN};
+                for(int v = 0; v < 3; v++) {
+                    if(v == 2 && !has_avx512) continue;
+                    g_simd_level = levels[v];
+                    double t = time_reduce(op ? PICO_REDUCE_MAX : PICO_REDUCE_SUM, x, y, O, R, I);
+                    gbs[v] = (double)n * sizeof(float) / t * 1e-9;
+                }
+                printf("  %5ldx%-6ld %-6s %-4s %9.2f %9.2f %9.2f %12.2e\n", (long)rows,
+                       (long)cols, outer ? "outer" : "inner", op ? "max" : "sum", gbs[0], gbs[1],
+                       gbs[2], err);
+            }
+        }
+
+        free(x);
+        free(y);
+    }
+
+    printf("\n");
+    return 0;
+}
@@ -0,0 +1,139 @@
+/*
+ * random fill benchmark: the old pico_rand (one global xorshift32 state, serial) vs the
+ * Philox4x32-10 fills behind pico_rand / pico_randn now.
+ *
+ * Run with `make rng` from bench/. Per size, in Gfloat/s:
+ *
+ *   uniform  — xorshift32 (the old generate_random_floats_fast, copied here as the
+ *              baseline), then Philox one super-block at a time scalar, AVX2 and
+ *              AVX-512 on one thread, then pico_rng_uniform (the detected level across
+ *              global_tp).
+ *   normal   — the old pico_randn graph (pico_rand x2 -> log / mul / sqrt / cos / sin ->
+ *              pico_cat, through the real ops), then Box-Muller scalar, AVX2, AVX-512
+ *              and pico_rng_normal.
+ *
+ * Philox costs 10 rounds of two 32x32 multiplies per 4 values, more work than one
+ * xorshift step; SIMD runs 8 / 16 counters per instruction and the threaded fill
+ * splits the counter range, which xorshift's one serial state can't.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "arena.h"
+#include "bench_common.h"
+#include "ops.h"
+#include "rng/rng.h"
+
+#define WARMUP 2
+#define ITERS 10
+
+static uint32_t xs_state = 123456789u;
+
+static void xorshift_fill(float* arr, int64_t n) {
+    for(int64_t i = 0; i < n; i++) {
+        uint32_t x = xs_state;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        xs_state = x;
+        uint32_t bits = (x >> 9) | 0x3F800000;
+        float f;
+        memcpy(&f, &bits, sizeof(f));
+        arr[i] = f - 1.0f;
+    }
+}
+
+// the old pico_randn, op for op (n even)
+static void old_randn(struct Arena* ar, int64_t n) {
+    int64_t half[] = {n / 2};
+    struct PicoTensor* u1 = pico_create_tensor(ar, half, 1);
+    struct PicoTensor* u2 = pico_create_tensor(ar, half, 1);
+    xorshift_fill(u1->data, n / 2);
+    xorshift_fill(u2->data, n / 2);
+    struct PicoTensor* mag =
+        pico_tensor_sqrt(pico_mul(pico_tensor_from_scalar(-2.0f), pico_tensor_log(u1)));
+    struct PicoTensor* angle =
+        pico_mul(pico_tensor_from_scalar(2.0f), pico_mul(pico_tensor_from_scalar(PI_F), u2));
+    pico_cat(pico_mul(mag, pico_tensor_cos(angle)), pico_mul(mag, pico_tensor_sin(angle)), 0);
+}
+
+enum path { XORSHIFT, OLD_RANDN, ONE_SCALAR, ONE_AVX2, ONE_AVX512, THREADED };
+
+static void run(enum path p, int normal, float* out, int64_t n, struct Arena* ar) {
+    switch(p) {
+        case XORSHIFT: xorshift_fill(out, n); break;
+        case OLD_RANDN:
+            old_randn(ar, n);
+            arena_reset(ar);
+            break;
+        case ONE_SCALAR:
+        case ONE_AVX2:
+        case ONE_AVX512: {
+            SimdLevel saved = g_simd_level;
+            g_simd_level = p == ONE_AVX512 ? SIMD_AVX512 : p == ONE_AVX2 ? SIMD_AVX2 : SIMD_NONE;
+            struct PicoRngJob job = {
+                .out = out, .n = n, .seed = 1, .stream = 0, .block = 0, .normal = normal,
+                .shift = 0.0f, .scale = 1.0f};
+            pico_rng_slice(&job, 0, (n + PICO_RNG_BLOCK - 1) / PICO_RNG_BLOCK);
+            g_simd_level = saved;
+            break;
+        }
+        case THREADED:
+            if(normal) pico_rng_normal(&g_pico_rng, out, n, 0.0f, 1.0f);
+            else pico_rng_uniform(&g_pico_rng, out, n, 0.0f, 1.0f);
+            break;
+    }
+}
+
+static double gfloats(enum path p, int normal, float* out, int64_t n, struct Arena* ar) {
+    for(int w = 0; w < WARMUP; w++) run(p, normal, out, n, ar);
+    double t0 = bench_now_sec();
+    for(int it = 0; it < ITERS; it++) run(p, normal, out, n, ar);
+    double t = (bench_now_sec() - t0) / ITERS;
+    return (double)n / t * 1e-9;
+}
+
+int main(void) {
+    pico_init();
+    int64_t sizes[] = {1 << 12, 1 << 16, 1 << 20, 1 << 24};
+    int n_sizes = (int)(sizeof(sizes) / sizeof(sizes[0]));
+    struct Arena* ar = arena_init((size_t)(sizes[n_sizes - 1]) * sizeof(float) * 12);
+    arena_ctx_push(ar);
+    float* out = malloc(sizeof(float) * sizes[n_sizes - 1]);
+
+    const char* u_names[] = {"xorshift32 (old)", "", "philox scalar", "philox avx2",
+                             "philox avx512", "pico_rng_uniform"};
+    const char* n_names[] = {"", "old randn graph", "box-muller scalar", "box-muller avx2",
+                             "box-muller avx512", "pico_rng_normal"};
+    enum path u_paths[] = {XORSHIFT, ONE_SCALAR, ONE_AVX2, ONE_AVX512, THREADED};
+    enum path n_paths[] = {OLD_RANDN, ONE_SCALAR, ONE_AVX2, ONE_AVX512, THREADED};
+    int has_avx512 = __builtin_cpu_supports("avx512f");
+
+    printf("\n  random fills, Gfloat/s   (warmup=%d, iters=%d, -O2)\n", WARMUP, ITERS);
+    printf("  %-10s %-8s %-20s %10s %9s\n", "n", "dist", "path", "Gfloat/s", "vs old");
+    printf("  ------------------------------------------------------------\n");
+    for(int s = 0; s < n_sizes; s++) {
+        int64_t n = sizes[s];
+        for(int normal = 0; normal < 2; normal++) {
+            enum path* paths = normal ? n_paths : u_paths;
+            const char** names = normal ? n_names : u_names;
+            double base = 0.0;
+            for(int k = 0; k < 5; k++) {
+                if(k == 3 && !has_avx512) continue;
+                double g = gfloats(paths[k], normal, out, n, ar);
+                if(k == 0) base = g;
+                char nbuf[16];
+                snprintf(nbuf, sizeof(nbuf), "%lld", (long long)n);
+                printf("  %-10s %-8s %-20s %10.3f %8.2fx\n", k == 0 ? nbuf : "",
+                       k == 0 ? (normal ? "normal" : "uniform") : "", names[paths[k]], g,
+                       g / base);
+            }
+        }
+    }
+    printf("\n");
+
+    free(out);
+    arena_ctx_pop();
+    arena_destroy(ar);
+    return 0;
+}
@@ -0,0 +1,108 @@
+/*
+ * transpose benchmark: materializing a transposed view (pico_contiguous /
+ * pico_transpose_clone) against memcpy of the same bytes, the bandwidth ceiling.
+ *
+ * Run with `make transpose` from bench/. Per fp32 matrix, in GB/s (bytes read + bytes
+ * written over time, so memcpy's number is directly comparable):
+ *
+ *   memcpy            — a straight copy of the matrix, one thread
+ *   strided rows      — the untiled gather: each output row reads one source column,
+ *                       a cache line per element (one thread)
+ *   blocked scalar    — 64x64 blocks, scalar inside (one thread)
+ *   blocked avx2      — 64x64 blocks of 8x8 in-register transposes (one thread)
+ *   pico_contiguous   — the blocked kernel at the detected level, blocks across global_tp
+ *
+ * square, tall and wide shapes, so both the read side and the write side get a turn
+ * at being the long stride.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "arena.h"
+#include "bench_common.h"
+#include "view/view.h"
+
+#define WARMUP 2
+#define ITERS 10
+
+enum path { MEMCPY, ROWS, BLOCKED_SCALAR, BLOCKED_AVX2, PICO, PATHS };
+
+// the single-thread paths, straight at the kernels: src is [rows, cols], dst [cols, rows]
+static void blocked(const float* src, float* dst, int64_t rows, int64_t cols, bool avx2) {
+    const int64_t B = PICO_TRANSPOSE_BLOCK;
+    for(int64_t i = 0; i < rows; i += B) {
+        for(int64_t j = 0; j < cols; j += B) {
+            const float* s = src + i * cols + j;
+            float* d = dst + j * rows + i;
+            int64_t r = MIN(B, rows - i), c = MIN(B, cols - j);
+            if(avx2) pico_transpose_f32_avx2(s, cols, d, rows, r, c, false);
+            else pico_transpose_f32_scalar(s, cols, d, rows, r, c, false);
+        }
+    }
+}
+
+static void run(enum path p, struct PicoTensor* x, float* dst, struct Arena* ar) {
+    int64_t rows = x->shape[0], cols = x->shape[1];
+    switch(p) {
+        case MEMCPY: memcpy(dst, x->data, sizeof(float) * x->numel); break;
+        case ROWS: {
+            int64_t shape[] = {cols, rows}, strides[] = {1, cols};
+            pico_strided_gather_scalar(x->data, dst, shape, strides, 2, sizeof(float), 0, cols);
+            break;
+        }
+        case BLOCKED_SCALAR: blocked(x->data, dst, rows, cols, false); break;
+        case BLOCKED_AVX2: blocked(x->data, dst, rows, cols, true); break;
+        default:
+            pico_contiguous(pico_transpose(x, 0, 1));
+            arena_reset(ar);
+    }
+}
+
+static double gbps(enum path p, struct PicoTensor* x, float* dst, struct Arena* ar) {
+    for(int w = 0; w < WARMUP; w++) run(p, x, dst, ar);
+    double t0 = bench_now_sec();
+    for(int it = 0; it < ITERS; it++) run(p, x, dst, ar);
+    double t = (bench_now_sec() - t0) / ITERS;
+    return 2.0 * sizeof(float) * x->numel / t * 1e-9;
+}
+
+int main(void) {
+    pico_init();
+    int64_t shapes[][2] = {{512, 512}, {4096, 4096}, {16384, 1024}, {1024, 16384}};
+    const char* kinds[] = {"square", "square", "tall", "wide"};
+    int n_shapes = (int)(sizeof(shapes) / sizeof(shapes[0]));
+    const char* names[] = {"memcpy", "strided rows", "blocked scalar", "blocked avx2",
+                           "pico_contiguous"};
+    int has_avx2 = __builtin_cpu_supports("avx2");
+
+    struct Arena* ar = arena_init((size_t)1 << 28);
+    arena_ctx_push(ar);
+    float* dst = malloc(sizeof(float) * 4096 * 4096);
+
+    printf("\n  fp32 transpose, GB/s read + written   (warmup=%d, iters=%d, -O2)\n", WARMUP,
+           ITERS);
+    printf("  %-14s %-7s %-17s %9s %9s\n", "shape", "kind", "path", "GB/s", "vs memcpy");
+    printf("  ------------------------------------------------------------\n");
+    for(int s = 0; s < n_shapes; s++) {
+        struct PicoTensor* x = pico_param(shapes[s], 2);
+        for(int64_t i = 0; i < x->numel; i++) x->data[i] = (float)(i & 1023);
+        double base = 0.0;
+        char sbuf[32];
+        snprintf(sbuf, sizeof(sbuf), "%lldx%lld", (long long)shapes[s][0],
+                 (long long)shapes[s][1]);
+        for(int p = 0; p < PATHS; p++) {
+            if(p == BLOCKED_AVX2 && !has_avx2) continue;
+            double g = gbps(p, x, dst, ar);
+            if(p == MEMCPY) base = g;
+            printf("  %-14s %-7s %-17s %9.2f %8.2fx\n", p == 0 ? sbuf : "",
+                   p == 0 ? kinds[s] : "", names[p], g, g / base);
+        }
+        pico_free(x);
+    }
+    printf("\n");
+
+    free(dst);
+    arena_ctx_pop();
+    arena_destroy(ar);
+    return 0;
+}
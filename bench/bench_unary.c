@@ -0,0 +1,159 @@
+/*
+ * unary benchmark: libm (the scalar kernels) vs the AVX2 and AVX-512 polynomial
+ * kernels for exp, log, sin, cos, tan, tanh, sqrt.
+ *
+ * Run with `make unary` from bench/. Two tables:
+ *
+ *   accuracy — max error in ulp vs the double-precision libm result, over ~4M inputs
+ *              per function: half spread evenly over the float bit patterns of the
+ *              domain (every exponent gets equal weight), half uniform in value.
+ *              these are the numbers quoted in the cpu_avx_2.h header comment.
+ *   speed    — kernels called directly (no dispatch, no arena) on an L2-resident
+ *              tensor, Gelem/s and speedup over libm.
+ *
+ * The scalar column is libm's own error for reference: glibc's float functions are
+ * not all correctly rounded either.
+ */
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench_common.h"
+
+#define ACC_N (1 << 22)
+#define SPEED_N (1 << 15)
+#define WARMUP 3
+#define ITERS 200
+
+typedef void (*unary_kernel)(struct PicoTensor*, struct PicoTensor*);
+
+struct UnaryCase {
+    const char* name;
+    unary_kernel scalar;
+    unary_kernel avx2;
+    unary_kernel avx512;
+    double (*ref)(double);
+    float lo, hi;
+};
+
+// float <-> position on a monotonic integer line (negative floats mirrored below 0)
+static int64_t float_to_line(float f) {
+    int32_t i;
+    memcpy(&i, &f, sizeof(i));
+    return i < 0 ? (int64_t)INT32_MIN - i : i;
+}
+
+static float line_to_float(int64_t l) {
+    int32_t i = l < 0 ? (int32_t)((int64_t)INT32_MIN - l) : (int32_t)l;
+    float f;
+    memcpy(&f, &i, sizeof(f));
+    return f;
+}
+
+static void fill_inputs(struct PicoTensor* x, float lo, float hi) {
+    int64_t half = x->numel / 2;
+    int64_t a = float_to_line(lo), b = float_to_line(hi);
+    for(int64_t i = 0; i < half; i++) {
+        x->data[i] = line_to_float(a + (int64_t)((double)(b - a) * (double)i / (double)half));
+    }
+    for(int64_t i = half; i < x->numel; i++) {
+        x->data[i] = lo + (hi - lo) * (float)(i - half) / (float)(x->numel - half);
+    }
+}
+
+// error of `got` in units of the float ulp at the exact (double) result
+static double ulp_error(float got, double want) {
+    if(isnan(want)) return isnan(got) ? 0.0 : INFINITY;
+    if(isinf(want) || fabs(want) > FLT_MAX)
+        return isinf(got) && (got > 0) == (want > 0) ? 0.0 : INFINITY;
+    float w = (float)fabs(want);
+    double ulp = (double)nextafterf(w, INFINITY) - (double)w;
+    if(w < FLT_MIN) ulp = 1.40129846e-45;  // denormal ulp
+    return fabs((double)got - want) / ulp;
+}
+
+static double max_ulp(unary_kernel k, struct UnaryCase* c, struct PicoTensor* x,
+                      struct PicoTensor* out) {
+    k(x, out);
+    double worst = 0.0;
+    for(int64_t i = 0; i < x->numel; i++) {
+        double e = ulp_error(out->data[i], c->ref((double)x->data[i]));
+        if(e > worst) worst = e;
+    }
+    return worst;
+}
+
+static double time_kernel(unary_kernel k, struct PicoTensor* x, struct PicoTensor* out) {
+    for(int w = 0; w < WARMUP; w++) k(x, out);
+    double t0 = bench_now_sec();
+    for(int it = 0; it < ITERS; it++) k(x, out);
+    return (bench_now_sec() - t0) / (double)ITERS;
+}
+
+int main(void) {
+    pico_init();
+    int has_avx512 = __builtin_cpu_supports("avx512f");
+
+    struct UnaryCase cases[] = {
+        {"exp", pico_exp_cpu_scalar, pico_exp_cpu_avx2_fp32, pico_exp_cpu_avx512_fp32, exp,
+         -87.3f, 88.7f},
+        {"log", pico_log_cpu_scalar, pico_log_cpu_avx2_fp32, pico_log_cpu_avx512_fp32, log,
+         1e-45f, 3.4e38f},
+        {"sin", pico_sin_cpu_scalar, pico_sin_cpu_avx2_fp32, pico_sin_cpu_avx512_fp32, sin,
+         -100.0f, 100.0f},
+        {"cos", pico_cos_cpu_scalar, pico_cos_cpu_avx2_fp32, pico_cos_cpu_avx512_fp32, cos,
+         -100.0f, 100.0f},
+        {"tan", pico_tan_cpu_scalar, pico_tan_cpu_avx2_fp32, pico_tan_cpu_avx512_fp32, tan,
+         -100.0f, 100.0f},
+        {"tanh", pico_tanh_cpu_scalar, pico_tanh_cpu_avx2_fp32, pico_tanh_cpu_avx512_fp32, tanh,
+         -20.0f, 20.0f},
+        {"sqrt", pico_sqrt_cpu_scalar, pico_sqrt_cpu_avx2_fp32, pico_sqrt_cpu_avx512_fp32, sqrt,
+         0.0f, 3.4e38f},
+    };
+    int n_cases = (int)(sizeof(cases) / sizeof(cases[0]));
+
+    int64_t acc_shape[] = {ACC_N};
+    int64_t speed_shape[] = {SPEED_N};
+    struct PicoTensor* ax = pico_param(acc_shape, 1);
+    struct PicoTensor* aout = pico_param(acc_shape, 1);
+    struct PicoTensor* sx = pico_param(speed_shape, 1);
+    struct PicoTensor* sout = pico_param(speed_shape, 1);
+
+    printf("\n  pico unary: max error vs double libm (%d inputs/fn)\n", ACC_N);
+    printf("  %-6s %22s %12s %12s %12s\n", "fn", "domain", "libm ulp", "avx2 ulp",
+           "avx512 ulp");
+    printf("  ------------------------------------------------------------------------\n");
+    for(int c = 0; c < n_cases; c++) {
+        fill_inputs(ax, cases[c].lo, cases[c].hi);
+        double e_s = max_ulp(cases[c].scalar, &cases[c], ax, aout);
+        double e_2 = max_ulp(cases[c].avx2, &cases[c], ax, aout);
+        double e_5 = has_avx512 ? max_ulp(cases[c].avx512, &cases[c], ax, aout) : NAN;
+        printf("  %-6s [%9.3g, %9.3g] %12.2f %12.2f %12.2f\n", cases[c].name, cases[c].lo,
+               cases[c].hi, e_s, e_2, e_5);
+    }
+
+    printf("\n  pico unary: throughput   (numel=%d, warmup=%d, iters=%d, -O2)\n", SPEED_N,
+           WARMUP, ITERS);
+    printf("  %-6s %12s %12s %12s %10s %10s\n", "fn", "libm Ge/s", "avx2 Ge/s", "avx512 Ge/s",
+           "avx2 x", "avx512 x");
+    printf("  ------------------------------------------------------------------------\n");
+    for(int c = 0; c < n_cases; c++) {
+        fill_inputs(sx, cases[c].lo, cases[c].hi);
+        double t_s = time_kernel(cases[c].scalar, sx, sout);
+        double t_2 = time_kernel(cases[c].avx2, sx, sout);
+        double t_5 = has_avx512 ? time_kernel(cases[c].avx512, sx, sout) : NAN;
+        printf("  %-6s %12.3f %12.3f %12.3f %9.2fx %9.2fx\n", cases[c].name,
+               SPEED_N / t_s * 1e-9, SPEED_N / t_2 * 1e-9, SPEED_N / t_5 * 1e-9, t_s / t_2,
+               t_s / t_5);
+    }
+    printf("\n");
+
+    pico_free(ax);
+    pico_free(aout);
+    pico_free(sx);
+    pico_free(sout);
+    return 0;
+}
@@ -56,8 +56,8 @@ static void init_layer_weights(struct PicoLinear* l1, struct PicoLinear* l2) {
 
 static struct PicoTensor* forward(struct PicoLinear* l1, struct PicoLinear* l2,
                                   struct PicoTensor* x) {
-    struct PicoTensor* h = pico_nn_linear_forward(l1, x);
-    h = pico_relu(h);
+    // bias + relu fused into the first layer's GEMM epilogue (one node, one pass)
+    struct PicoTensor* h = pico_nn_linear_forward_act(l1, x, PICO_ACT_RELU);
     return pico_nn_linear_forward(l2, h);
 }
 
@@ -118,6 +118,26 @@ int main(void) {
         printf("  row %d -> pred %.4f, target %.4f\n", i, final_pred->data[i], y->data[i]);
     }
 
+    // save the trained layers, then serve them from the mmap'd file: the fresh layers'
+    // params are swapped for tensors that point straight into the mapping
+    struct PicoCkptWriter* ckpt_out = pico_ckpt_writer_init();
+    pico_ckpt_add_linear(ckpt_out, "l1", l1);
+    pico_ckpt_add_linear(ckpt_out, "l2", l2);
+    if(pico_ckpt_write(ckpt_out, "relu_mlp.ckpt")) {
+        struct PicoCkpt* ckpt = pico_ckpt_open("relu_mlp.ckpt");
+        struct PicoLinear* s1 = pico_nn_linear_init(2, 4, true);
+        struct PicoLinear* s2 = pico_nn_linear_init(4, 1, true);
+        if(ckpt != NULL && pico_ckpt_bind_linear(ckpt, "l1", s1) &&
+           pico_ckpt_bind_linear(ckpt, "l2", s2)) {
+            struct PicoTensor* served = forward(s1, s2, x);
+            printf("\nreloaded from relu_mlp.ckpt: row 0 -> pred %.4f\n", served->data[0]);
+        }
+        pico_nn_linear_free(s1);
+        pico_nn_linear_free(s2);
+        pico_ckpt_close(ckpt);
+    }
+    pico_ckpt_writer_free(ckpt_out);
+
     pico_optim_sgd_free(opt);
     pico_nn_linear_free(l1);
     pico_nn_linear_free(l2);
@@ -1,9 +1,10 @@
-#include <math.h>
-#define _USE_MATH_DEFINES
 #include "activations.h"
+
 #include "arena.h"
 #include "autograd.h"
+#include "kernels/cpu_kernels.h"
 #include "tensor.h"
+#include "view/view.h"
 
 struct PicoTensor* pico_relu(struct PicoTensor* x) {
     struct Arena* arena = arena_ctx_current();
@@ -11,10 +12,12 @@ struct PicoTensor* pico_relu(struct PicoTensor* x) {
         fprintf(stderr, "[Pico] Error: No current arena in context!\n");
         return NULL;
     }
-    struct PicoTensor* out = pico_create_tensor(arena, x->shape, x->ndim);
+    x = pico_contiguous(x);
+    struct PicoTensor* out = pico_create_tensor_dtype(arena, x->shape, x->ndim, x->dtype);
+    out->backend = x->backend;
 
-    for(int i = 0; i < x->numel; i++) {
-        out->data[i] = MAX(x->data[i], 0);
+    if(x->backend == CPU) {
+        pico_relu_cpu(x, out);
     }
 
     out->parents = arena_alloc(arena, sizeof(struct PicoTensor*));
@@ -31,10 +34,12 @@ struct PicoTensor* pico_sigmoid(struct PicoTensor* x) {
         fprintf(stderr, "[Pico] Error: No current arena in context!\n");
         return NULL;
     }
-    struct PicoTensor* out = pico_create_tensor(arena, x->shape, x->ndim);
+    x = pico_contiguous(x);
+    struct PicoTensor* out = pico_create_tensor_dtype(arena, x->shape, x->ndim, x->dtype);
+    out->backend = x->backend;
 
-    for(int i = 0; i < x->numel; i++) {
-        out->data[i] = sigmoid(out->data[i]);
+    if(x->backend == CPU) {
+        pico_sigmoid_cpu(x, out);
     }
 
     out->parents = arena_alloc(arena, sizeof(struct PicoTensor*));
@@ -51,10 +56,12 @@ struct PicoTensor* pico_tanh(struct PicoTensor* x) {
         fprintf(stderr, "[Pico] Error: No current arena in context!\n");
         return NULL;
     }
-    struct PicoTensor* out = pico_create_tensor(arena, x->shape, x->ndim);
+    x = pico_contiguous(x);
+    struct PicoTensor* out = pico_create_tensor_dtype(arena, x->shape, x->ndim, x->dtype);
+    out->backend = x->backend;
 
-    for(int i = 0; i < x->numel; i++) {
-        out->data[i] = tanh(out->data[i]);
+    if(x->backend == CPU) {
+        pico_tanh_cpu(x, out);
     }
 
     out->parents = arena_alloc(arena, sizeof(struct PicoTensor*));
@@ -64,3 +71,44 @@ struct PicoTensor* pico_tanh(struct PicoTensor* x) {
 
     return out;
 }
+
+struct PicoTensor* pico_softmax(struct PicoTensor* x, int axis) {
+    int d = axis < 0 ? axis + x->ndim : axis;
+    if(d < 0 || d >= x->ndim) {
+        fprintf(stderr, "[Pico] Error: Bad softmax axis %d for a %d-d tensor!\n", axis, x->ndim);
+        return NULL;
+    }
+
+    struct Arena* arena = arena_ctx_current();
+    if(arena == NULL) {
+        fprintf(stderr, "[Pico] Error: No current arena in context!\n");
+        return NULL;
+    }
+    x = pico_as_f32(pico_contiguous(x));
+    struct PicoTensor* out = pico_create_tensor(arena, x->shape, x->ndim);
+    out->backend = x->backend;
+
+    if(x->backend == CPU) {
+        int64_t O, R, I;
+        pico_softmax_dims(x, d, &O, &R, &I);
+        int64_t scratch_floats = pico_softmax_scratch_floats(O, R, I, false);
+        float* scratch =
+            scratch_floats > 0 ? arena_alloc(arena, sizeof(float) * scratch_floats) : NULL;
+        if(scratch_floats > 0 && scratch == NULL) {
+            fprintf(stderr, "[Pico] Error: No arena space for the softmax's scratch!\n");
+            return NULL;
+        }
+        pico_softmax_cpu(x->data, out->data, scratch, O, R, I);
+    }
+
+    int* ctx = arena_alloc(arena, sizeof(int));
+    *ctx = d;
+
+    out->parents = arena_alloc(arena, sizeof(struct PicoTensor*));
+    out->parents[0] = x;
+    out->num_parents = 1;
+    out->_ctx = ctx;
+    out->_backward = pico_softmax_backward;
+
+    return out;
+}
@@ -1,14 +1,19 @@
-
-
 #pragma once
 #include <math.h>
 
 #include "tensor.h"
 
-static inline float sigmoid(float x) {
-    return exp(x) / exp(x) + 1;
-}
+// element-wise activations. forward + backward both go through the cpu_kernels.h
+// dispatch (AVX2 / AVX-512 / scalar, threaded for large tensors); the backwards use
+// the saved output only (relu' = y > 0, sigmoid' = y(1-y), tanh' = 1-y^2).
 
 struct PicoTensor* pico_relu(struct PicoTensor* x);
 struct PicoTensor* pico_sigmoid(struct PicoTensor* x);
 struct PicoTensor* pico_tanh(struct PicoTensor* x);
+
+// softmax along `axis` (negative counts from the end, -1 = last). not element-wise:
+// each output sees the whole row. forward is one online max/sum-exp pass + one write
+// pass per row; backward is the Jacobian-vector product y * (dy - dot(dy, y)), never
+// the Jacobian itself. for a loss on top, use pico_cross_entropy_loss instead: it
+// never materialises the probabilities at all.
+struct PicoTensor* pico_softmax(struct PicoTensor* x, int axis);
@@ -1,37 +1,63 @@
-
 #pragma once
 
-#include <math.h>
+#include <stdio.h>
 
-#include "activations.h"
+#include "arena.h"
+#include "kernels/cpu_kernels.h"
 #include "tensor.h"
 
+// parent->grad += self->grad * f'(self->data): the kernels only ever read the saved
+// output, never x.
+
 static inline void pico_relu_backward(struct PicoTensor* self) {
     struct PicoTensor* parent = self->parents[0];
-
-    int64_t N = parent->numel;
-
-    for(int64_t i = 0; i < N; i++) {
-        parent->grad[i] += self->grad[i] * (self->data[i] > 0);
+    if(self->backend == CPU) {
+        pico_relu_backward_cpu(self, parent);
     }
 }
 
 static inline void pico_sigmoid_backward(struct PicoTensor* self) {
     struct PicoTensor* parent = self->parents[0];
-
-    int64_t N = parent->numel;
-
-    for(int64_t i = 0; i < N; i++) {
-        parent->grad[i] += self->grad[i] * (sigmoid(self->data[i]) * (1 - sigmoid(self->data[i])));
+    if(self->backend == CPU) {
+        pico_sigmoid_backward_cpu(self, parent);
     }
 }
 
 static inline void pico_tanh_backward(struct PicoTensor* self) {
     struct PicoTensor* parent = self->parents[0];
+    if(self->backend == CPU) {
+        pico_tanh_backward_cpu(self, parent);
+    }
+}
 
-    int64_t N = parent->numel;
+// x viewed as [O, R, I] around the softmax axis (saved in self->_ctx by the forward)
+static inline void pico_softmax_dims(struct PicoTensor* x, int axis, int64_t* O, int64_t* R,
+                                     int64_t* I) {
+    *O = 1;
+    *I = 1;
+    for(int d = 0; d < axis; d++) *O *= x->shape[d];
+    for(int d = axis + 1; d < x->ndim; d++) *I *= x->shape[d];
+    *R = x->shape[axis];
+}
 
-    for(int64_t i = 0; i < N; i++) {
-        parent->grad[i] += self->grad[i] * (1 - powf(tanh(self->data[i]), 2.0f));
+// the one non-element-wise backward here: needs the whole row of y and dy
+static inline void pico_softmax_backward(struct PicoTensor* self) {
+    struct PicoTensor* parent = self->parents[0];
+    int64_t O, R, I;
+    pico_softmax_dims(self, *(int*)self->_ctx, &O, &R, &I);
+    if(self->backend == CPU) {
+        // strided rows gather into scratch from the current arena, as in the forward
+        int64_t scratch_floats = pico_softmax_scratch_floats(O, R, I, true);
+        struct Arena* arena = arena_ctx_current();
+        float* scratch = NULL;
+        if(scratch_floats > 0) {
+            scratch = arena != NULL ? arena_alloc(arena, sizeof(float) * scratch_floats) : NULL;
+            if(scratch == NULL) {
+                fprintf(stderr, "[Pico] Error: No arena space for the softmax backward's "
+                                "scratch!\n");
+                return;
+            }
+        }
+        pico_softmax_backward_cpu(self->data, self->grad, parent->grad, scratch, O, R, I);
     }
 }
@@ -0,0 +1,108 @@
+#include "attention.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "arena.h"
+#include "attention/autograd.h"
+#include "kernels/cpu_kernels.h"
+#include "tensor.h"
+#include "view/view.h"
+
+static bool pico_attention_shapes_ok(struct PicoTensor* q, struct PicoTensor* k,
+                                     struct PicoTensor* v) {
+    int nd = q->ndim;
+    if(nd < 2 || k->ndim != nd || v->ndim != nd) {
+        fprintf(stderr, "[Pico] Error: Attention needs q, k and v of one rank, at least 2!\n");
+        return false;
+    }
+    for(int i = 0; i < nd - 2; i++) {
+        if(k->shape[i] != q->shape[i] || v->shape[i] != q->shape[i]) {
+            fprintf(stderr, "[Pico] Error: Attention q, k and v differ in leading dim %d!\n", i);
+            return false;
+        }
+    }
+    if(k->shape[nd - 1] != q->shape[nd - 1] || v->shape[nd - 2] != k->shape[nd - 2]) {
+        fprintf(stderr, "[Pico] Error: Attention needs q [..., lq, d], k [..., lk, d] and "
+                        "v [..., lk, dv]!\n");
+        return false;
+    }
+    if(q->numel == 0 || k->numel == 0 || v->numel == 0) {
+        fprintf(stderr, "[Pico] Error: Attention needs non-empty q, k and v!\n");
+        return false;
+    }
+    if(k->backend != q->backend || v->backend != q->backend) {
+        fprintf(stderr, "[Pico] Error: Attention q, k and v must be on one backend!\n");
+        return false;
+    }
+    return true;
+}
+
+// the mask's stride between (batch, head) pairs: 0 for a shared [lq, lk], lq * lk for
+// one per pair. -1 when it fits neither
+static int64_t pico_attention_mask_stride(struct PicoTensor* mask, int64_t bh, int64_t lq,
+                                          int64_t lk, PicoBackend backend) {
+    if(mask->ndim >= 2 && mask->shape[mask->ndim - 2] == lq &&
+       mask->shape[mask->ndim - 1] == lk && mask->backend == backend) {
+        if(mask->numel == lq * lk) return 0;
+        if(mask->numel == bh * lq * lk) return lq * lk;
+    }
+    fprintf(stderr, "[Pico] Error: Attention mask must be [%ld, %ld] or [..., %ld, %ld]!\n",
+            (long)lq, (long)lk, (long)lq, (long)lk);
+    return -1;
+}
+
+struct PicoTensor* pico_attention(struct PicoTensor* q, struct PicoTensor* k,
+                                  struct PicoTensor* v, struct PicoTensor* mask) {
+    if(!pico_attention_shapes_ok(q, k, v)) return NULL;
+    int nd = q->ndim;
+    int64_t lq = q->shape[nd - 2], lk = k->shape[nd - 2];
+    int64_t dim = q->shape[nd - 1], vdim = v->shape[nd - 1];
+    int64_t bh = q->numel / (lq * dim);
+    int64_t mask_stride = 0;
+    if(mask != NULL) {
+        mask_stride = pico_attention_mask_stride(mask, bh, lq, lk, q->backend);
+        if(mask_stride < 0) return NULL;
+    }
+
+    struct Arena* arena = arena_ctx_current();
+    if(arena == NULL) {
+        fprintf(stderr, "[Pico] Error: No current arena in context!\n");
+        return NULL;
+    }
+    q = pico_as_f32(pico_contiguous(q));
+    k = pico_as_f32(pico_contiguous(k));
+    v = pico_as_f32(pico_contiguous(v));
+    mask = mask != NULL ? pico_as_f32(pico_contiguous(mask)) : NULL;
+
+    int64_t* shape = arena_alloc(arena, sizeof(int64_t) * nd);
+    memcpy(shape, q->shape, sizeof(int64_t) * (nd - 1));
+    shape[nd - 1] = vdim;
+    struct PicoTensor* out = pico_create_tensor(arena, shape, nd);
+    out->backend = q->backend;
+
+    struct PicoAttentionCtx* ctx = arena_alloc(arena, sizeof(struct PicoAttentionCtx));
+    ctx->lse = arena_alloc(arena, sizeof(float) * bh * lq);
+    ctx->bh = bh;
+    ctx->mask_stride = mask_stride;
+    ctx->scale = 1.0f / sqrtf((float)dim);
+
+    if(q->backend == CPU) {
+        pico_attention_cpu(q->data, k->data, v->data, mask != NULL ? mask->data : NULL,
+                           mask_stride, out->data, ctx->lse, bh, lq, lk, dim, vdim, ctx->scale);
+    }
+
+    int num_parents = mask != NULL ? 4 : 3;
+    out->parents = arena_alloc(arena, sizeof(struct PicoTensor*) * num_parents);
+    out->parents[0] = q;
+    out->parents[1] = k;
+    out->parents[2] = v;
+    if(mask != NULL) out->parents[3] = mask;
+    out->num_parents = num_parents;
+    out->_ctx = ctx;
+    out->_backward = pico_attention_backward;
+
+    return out;
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "tensor.h"
+
+// scaled-dot-product attention, y = softmax(q kᵀ / sqrt(d) + mask) v, on
+//   q [..., lq, d], k [..., lk, d], v [..., lk, dv]  ->  y [..., lq, dv]
+// with the leading dims (batch, heads, ...) equal on all three. mask is optional and
+// additive ([lq, lk] shared by every batch / head, or [..., lq, lk] like q's leading
+// dims): 0 keeps a key, -INFINITY drops it (a causal mask is -inf above the diagonal).
+// a query row with every key dropped gives a zero row. the mask gets no grad.
+// one node, run flash style: the lq × lk scores are never materialized, only tiles of
+// them and one logsumexp per query row, and the backward recomputes the tiles from
+// q and k. batch × heads run across global_tp.
+struct PicoTensor* pico_attention(struct PicoTensor* q, struct PicoTensor* k,
+                                  struct PicoTensor* v, struct PicoTensor* mask);
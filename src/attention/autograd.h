@@ -0,0 +1,47 @@
+/*
+ * for better details onbackward functions check out ../autograd.h
+ */
+
+#pragma once
+#include <stdio.h>
+
+#include "arena.h"
+#include "kernels/cpu_kernels.h"
+#include "tensor.h"
+
+// what pico_attention keeps for the backward. parents are q, k, v, then mask when given
+struct PicoAttentionCtx {
+    float* lse;  // [bh, lq], the softmax's logsumexp per query row
+    int64_t bh;
+    int64_t mask_stride;
+    float scale;
+};
+
+// recomputes each score tile from q, k and lse rather than reading a stored P; y is
+// self's data. see pico_attention_backward_cpu
+static inline void pico_attention_backward(struct PicoTensor* self) {
+    struct PicoAttentionCtx* ctx = (struct PicoAttentionCtx*)self->_ctx;
+    struct PicoTensor* q = self->parents[0];
+    struct PicoTensor* k = self->parents[1];
+    struct PicoTensor* v = self->parents[2];
+    struct PicoTensor* mask = self->num_parents > 3 ? self->parents[3] : NULL;
+    int64_t lq = q->shape[q->ndim - 2], lk = k->shape[k->ndim - 2];
+
+    if(self->backend == CPU) {
+        // delta, Σ dy * y per query row: scratch from the current arena
+        struct Arena* arena = arena_ctx_current();
+        float* delta = arena != NULL ? arena_alloc(arena, sizeof(float) * ctx->bh * lq) : NULL;
+        if(delta == NULL) {
+            fprintf(stderr, "[Pico] Error: In Attention - no arena space for the backward's "
+                            "scratch!\n");
+            return;
+        }
+        pico_attention_backward_cpu(q->data, k->data, v->data,
+                                    mask != NULL ? mask->data : NULL, ctx->mask_stride,
+                                    self->data, self->grad, ctx->lse, delta,
+                                    q->requires_grad ? q->grad : NULL,
+                                    k->requires_grad ? k->grad : NULL,
+                                    v->requires_grad ? v->grad : NULL, ctx->bh, lq, lk,
+                                    q->shape[q->ndim - 1], v->shape[v->ndim - 1], ctx->scale);
+    }
+}
@@ -48,6 +48,7 @@
 #include <math.h>
 #include <stdint.h>
 
+#include "kernels/cpu_kernels.h"
 #include "tensor.h"
 
 static inline void pico_add_backward(struct PicoTensor* self) {
@@ -79,9 +80,43 @@ static inline void pico_sub_backward(struct PicoTensor* self) {
     }
 }
 
+// a dtype cast is the identity as far as the gradient goes (grads are fp32 either way).
+// x may be a constant with no grad buffer (a loader batch)
+static inline void pico_to_dtype_backward(struct PicoTensor* self) {
+    struct PicoTensor* x = self->parents[0];
+    if(!x->requires_grad || x->grad == NULL) return;
+    for(int64_t i = 0; i < self->numel; i++) {
+        x->grad[i] += self->grad[i];
+    }
+}
+
+// saved in out->_ctx by pico_cat_n
+struct PicoCatCtx {
+    int64_t* offsets;  // where input k's chunk starts in an output row
+    int64_t* chunks;   // input k's elements per output row
+    int64_t row;       // elements per output row
+};
+
+// each input's grad += its window of self->grad, read in place: no slice is copied out
+static inline void pico_cat_backward(struct PicoTensor* self) {
+    struct PicoCatCtx* ctx = (struct PicoCatCtx*)self->_ctx;
+    float* dx[PICO_CAT_MAX_TENSORS];
+    for(int k = 0; k < self->num_parents; k++) dx[k] = self->parents[k]->grad;
+    struct PicoCatJob job = {.dy = self->grad,
+                             .dx = dx,
+                             .offsets = ctx->offsets,
+                             .chunks = ctx->chunks,
+                             .row = ctx->row,
+                             .n = self->num_parents,
+                             .elem = sizeof(float)};
+    pico_cat_backward_cpu(&job, self->numel);
+}
+
 static inline void pico_mul_backward(struct PicoTensor* self) {
-    struct PicoTensor* a = self->parents[0];
-    struct PicoTensor* b = self->parents[1];
+    // the same-dtype half case keeps its inputs half: read them through fp32 copies
+    struct PicoTensor a_tmp, b_tmp;
+    struct PicoTensor* a = pico_tensor_f32_borrow(self->parents[0], &a_tmp);
+    struct PicoTensor* b = pico_tensor_f32_borrow(self->parents[1], &b_tmp);
 
     int64_t ia = 0;
     int64_t ib = 0;
@@ -91,25 +126,35 @@ static inline void pico_mul_backward(struct PicoTensor* self) {
         a->grad[ia] += self->grad[i] * b->data[ib];
         b->grad[ib] += self->grad[i] * a->data[ia];
     }
+    pico_tensor_f32_release(a, self->parents[0]);
+    pico_tensor_f32_release(b, self->parents[1]);
 }
 
-// C = A·B   ->   dA = dC·Bᵀ ,  dB = Aᵀ·dC   (dC = self->grad)
+// C = A·B   ->   dA = dC·Bᵀ ,  dB = Aᵀ·dC
 // two matmul-style triple loops; transpose is baked into the index order.
-static inline void pico_matmul_backward(struct PicoTensor* self) {
-    struct PicoTensor* a = self->parents[0];  // A (M,K)
-    struct PicoTensor* b = self->parents[1];  // B (K,N)
-
-    int M = a->shape[0];
+// dC is passed in (row stride dc_stride, contiguous columns) instead of read from
+// self->grad so fused ops (e.g. Linear's matmul + bias + relu) can hand in their
+// already-gated gradient without building a matmul node. half a / b are read through
+// fp32 copies; their grads are fp32 anyway. a side with requires_grad == 0 or no grad
+// buffer (an input batch) is skipped.
+static inline void pico_matmul_backward_accumulate(struct PicoTensor* a_in,
+                                                   struct PicoTensor* b_in, const float* dc,
+                                                   int64_t dc_stride) {
+    struct PicoTensor a_tmp, b_tmp;
+    struct PicoTensor* a = pico_tensor_f32_borrow(a_in, &a_tmp);
+    struct PicoTensor* b = pico_tensor_f32_borrow(b_in, &b_tmp);
+    int M = a->shape[0];  // A (M,K)
     int K = a->shape[1];
-    int N = b->shape[1];
+    int N = b->shape[1];  // B (K,N)
+    bool need_da = a_in->requires_grad && a_in->grad != NULL;
+    bool need_db = b_in->requires_grad && b_in->grad != NULL;
 
     // dA[i][k] = Σ_j dC[i][j] * B[k][j]
-    for(int i = 0; i < M; i++) {
+    for(int i = 0; i < M && need_da; i++) {
         for(int k = 0; k < K; k++) {
             float acc = 0.0f;
             for(int j = 0; j < N; j++) {
-                acc += self->grad[i * self->strides[0] + j * self->strides[1]] *
-                       b->data[k * b->strides[0] + j * b->strides[1]];
+                acc += dc[i * dc_stride + j] * b->data[k * b->strides[0] + j * b->strides[1]];
             }
             a->grad[i * a->strides[0] + k * a->strides[1]] +=
                 acc;  // += : accumulate across consumers
@@ -117,16 +162,22 @@ static inline void pico_matmul_backward(struct PicoTensor* self) {
     }
 
     // dB[k][j] = Σ_i A[i][k] * dC[i][j]
-    for(int k = 0; k < K; k++) {
+    for(int k = 0; k < K && need_db; k++) {
         for(int j = 0; j < N; j++) {
             float acc = 0.0f;
             for(int i = 0; i < M; i++) {
-                acc += a->data[i * a->strides[0] + k * a->strides[1]] *
-                       self->grad[i * self->strides[0] + j * self->strides[1]];
+                acc += a->data[i * a->strides[0] + k * a->strides[1]] * dc[i * dc_stride + j];
             }
             b->grad[k * b->strides[0] + j * b->strides[1]] += acc;
         }
     }
+    pico_tensor_f32_release(a, a_in);
+    pico_tensor_f32_release(b, b_in);
+}
+
+static inline void pico_matmul_backward(struct PicoTensor* self) {
+    pico_matmul_backward_accumulate(self->parents[0], self->parents[1], self->grad,
+                                    self->strides[0]);
 }
 
 static inline void pico_tensor_sqrt_backward(struct PicoTensor* self) {
@@ -161,10 +212,11 @@ static inline void pico_tensor_tan_backward(struct PicoTensor* self) {
     }
 }
 
+// tanh' = 1 - tanh^2, from the saved output. same kernel as the pico_tanh activation
 static inline void pico_tensor_tanh_backward(struct PicoTensor* self) {
     struct PicoTensor* a = self->parents[0];
-    for(int i = 0; i < self->numel; i++) {
-        a->grad[i] += self->grad[i] * 1 - (powf(self->data[i], 2));
+    if(self->backend == CPU) {
+        pico_tanh_backward_cpu(self, a);
     }
 }
 
@@ -174,3 +226,11 @@ static inline void pico_tensor_log_backward(struct PicoTensor* self) {
         a->grad[i] += self->grad[i] * 1 / a->data[i];
     }
 }
+
+// d/dx e^x = e^x, which is exactly what the forward already stored in self->data
+static inline void pico_tensor_exp_backward(struct PicoTensor* self) {
+    struct PicoTensor* a = self->parents[0];
+    for(int i = 0; i < self->numel; i++) {
+        a->grad[i] += self->grad[i] * self->data[i];
+    }
+}
@@ -0,0 +1,578 @@
+#define _POSIX_C_SOURCE 200809L  // open / mmap / fsync / strdup under -std=c11
+
+#include "checkpoint.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "kernels/cpu_kernels.h"
+#include "optim/multi_tensor.h"
+#include "view/view.h"
+
+_Static_assert(sizeof(struct PicoCkptHeader) == 64, "checkpoint header must stay 64 bytes");
+_Static_assert(sizeof(struct PicoCkptEntry) % 8 == 0, "checkpoint entries must pack");
+
+static size_t pico_ckpt_dtype_size(enum PicoCkptDType dtype) {
+    return dtype == PICO_CKPT_I64 ? sizeof(int64_t) : pico_dtype_size((PicoDType)dtype);
+}
+
+static bool pico_ckpt_dtype_valid(uint32_t dtype) {
+    return dtype == PICO_CKPT_F32 || dtype == PICO_CKPT_BF16 || dtype == PICO_CKPT_F16 ||
+           dtype == PICO_CKPT_I64;
+}
+
+static uint64_t pico_ckpt_align(uint64_t x) {
+    return (x + PICO_CKPT_ALIGN - 1) / PICO_CKPT_ALIGN * PICO_CKPT_ALIGN;
+}
+
+static int64_t pico_ckpt_numel(const int64_t* shape, int ndim) {
+    int64_t n = 1;
+    for(int d = 0; d < ndim; d++) n *= shape[d];
+    return n;
+}
+
+// ==================== writing
+
+struct PicoCkptWriter* pico_ckpt_writer_init(void) {
+    return (struct PicoCkptWriter*)calloc(1, sizeof(struct PicoCkptWriter));
+}
+
+bool pico_ckpt_add_raw(struct PicoCkptWriter* w, const char* name, enum PicoCkptDType dtype,
+                       const int64_t* shape, int ndim, const void* data) {
+    size_t len = name != NULL ? strlen(name) : 0;
+    if(len == 0 || len >= PICO_CKPT_NAME_MAX || ndim < 1 || ndim > PICO_CKPT_MAX_DIMS ||
+       !pico_ckpt_dtype_valid(dtype)) {
+        fprintf(stderr, "[Pico] Error: In checkpoint - bad entry '%s'\n", name ? name : "");
+        return false;
+    }
+    for(int i = 0; i < w->count; i++) {
+        if(strcmp(w->items[i].name, name) == 0) {
+            fprintf(stderr, "[Pico] Error: In checkpoint - duplicate entry '%s'\n", name);
+            return false;
+        }
+    }
+
+    if(w->count == w->capacity) {
+        int capacity = w->capacity > 0 ? w->capacity * 2 : 16;
+        struct PicoCkptItem* items = realloc(w->items, sizeof(struct PicoCkptItem) * capacity);
+        if(items == NULL) return false;
+        w->items = items;
+        w->capacity = capacity;
+    }
+
+    struct PicoCkptItem* item = &w->items[w->count];
+    memset(item, 0, sizeof(*item));
+    item->name = strdup(name);
+    item->dtype = dtype;
+    item->ndim = ndim;
+    memcpy(item->shape, shape, sizeof(int64_t) * ndim);
+    item->data = data;
+    item->nbytes = (uint64_t)pico_ckpt_numel(shape, ndim) * pico_ckpt_dtype_size(dtype);
+    if(item->name == NULL) return false;
+    w->count++;
+    return true;
+}
+
+bool pico_ckpt_add(struct PicoCkptWriter* w, const char* name, struct PicoTensor* t) {
+    // the entry is written from t->data in row-major order, so a strided view would come
+    // back scrambled
+    if(!pico_is_contiguous(t)) {
+        fprintf(stderr,
+                "[Pico] Error: In checkpoint - entry '%s' is not contiguous, "
+                "add pico_contiguous() of it\n",
+                name ? name : "");
+        return false;
+    }
+    return pico_ckpt_add_raw(w, name, (enum PicoCkptDType)t->dtype, t->shape, t->ndim, t->data);
+}
+
+bool pico_ckpt_add_linear(struct PicoCkptWriter* w, const char* prefix,
+                          struct PicoLinear* layer) {
+    char name[PICO_CKPT_NAME_MAX];
+    snprintf(name, sizeof(name), "%s.weight", prefix);
+    if(!pico_ckpt_add(w, name, layer->weights)) return false;
+    if(layer->bias == NULL) return true;
+    snprintf(name, sizeof(name), "%s.bias", prefix);
+    return pico_ckpt_add(w, name, layer->bias);
+}
+
+static bool pico_ckpt_add_masters(struct PicoCkptWriter* w, const char* prefix,
+                                  struct PicoOptimChunks* chunks, struct PicoVec* params) {
+    char name[PICO_CKPT_NAME_MAX];
+    for(int i = 0; i < (int)params->size && chunks->master_offsets != NULL; i++) {
+        if(chunks->master_offsets[i] < 0) continue;
+        struct PicoTensor* t = params->data[i];
+        snprintf(name, sizeof(name), "%s.master.%d", prefix, i);
+        if(!pico_ckpt_add_raw(w, name, PICO_CKPT_F32, t->shape, t->ndim,
+                              chunks->master + chunks->master_offsets[i]))
+            return false;
+    }
+    return true;
+}
+
+bool pico_ckpt_add_optim(struct PicoCkptWriter* w, const char* prefix, struct PicoOptim* optim) {
+    if(!pico_optim_ensure_state(optim)) return false;
+    char name[PICO_CKPT_NAME_MAX];
+    int n_state = pico_optim_n_state(optim->kind);
+    for(int i = 0; i < (int)optim->params.size; i++) {
+        struct PicoTensor* t = optim->params.data[i];
+        for(int s = 0; s < n_state; s++) {
+            snprintf(name, sizeof(name), "%s.state%d.%d", prefix, s, i);
+            const float* state = optim->state + s * optim->state_len + optim->offsets[i];
+            if(!pico_ckpt_add_raw(w, name, PICO_CKPT_F32, t->shape, t->ndim, state)) return false;
+        }
+    }
+    if(!pico_ckpt_add_masters(w, prefix, &optim->chunks, &optim->params)) return false;
+    int64_t one = 1;
+    snprintf(name, sizeof(name), "%s.step", prefix);
+    return pico_ckpt_add_raw(w, name, PICO_CKPT_I64, &one, 1, &optim->t);
+}
+
+bool pico_ckpt_add_optim_sgd(struct PicoCkptWriter* w, const char* prefix,
+                             struct PicoOptimSGD* optim) {
+    if(!pico_optim_chunks_sync(&optim->chunks, &optim->params)) return false;
+    return pico_ckpt_add_masters(w, prefix, &optim->chunks, &optim->params);
+}
+
+static bool pico_ckpt_write_all(int fd, const void* buf, uint64_t n) {
+    const uint8_t* p = (const uint8_t*)buf;
+    while(n > 0) {
+        ssize_t done = write(fd, p, n);
+        if(done < 0 && errno == EINTR) continue;
+        if(done <= 0) return false;
+        p += done;
+        n -= (uint64_t)done;
+    }
+    return true;
+}
+
+// header, index and names laid out in one calloc'd buffer of data_offset bytes; each
+// entry's data offset is in the index, the total file size in the header
+static uint8_t* pico_ckpt_layout(const struct PicoCkptWriter* w) {
+    uint64_t names_at = sizeof(struct PicoCkptHeader) + sizeof(struct PicoCkptEntry) * w->count;
+    uint64_t names_len = 0;
+    for(int i = 0; i < w->count; i++) names_len += strlen(w->items[i].name);
+    uint64_t data_offset = pico_ckpt_align(names_at + names_len);
+
+    uint8_t* meta = calloc(data_offset, 1);
+    if(meta == NULL) return NULL;
+    struct PicoCkptHeader* header = (struct PicoCkptHeader*)meta;
+    struct PicoCkptEntry* entries = (struct PicoCkptEntry*)(meta + sizeof(*header));
+    memcpy(header->magic, PICO_CKPT_MAGIC, sizeof(header->magic));
+    header->version = PICO_CKPT_VERSION;
+    header->count = (uint32_t)w->count;
+    header->data_offset = data_offset;
+
+    uint64_t name_at = names_at, offset = data_offset;
+    for(int i = 0; i < w->count; i++) {
+        const struct PicoCkptItem* item = &w->items[i];
+        struct PicoCkptEntry* e = &entries[i];
+        e->name_len = (uint32_t)strlen(item->name);
+        e->name_offset = name_at;
+        memcpy(meta + name_at, item->name, e->name_len);
+        name_at += e->name_len;
+        e->offset = offset;
+        e->nbytes = item->nbytes;
+        e->dtype = (uint32_t)item->dtype;
+        e->ndim = (uint32_t)item->ndim;
+        memcpy(e->shape, item->shape, sizeof(int64_t) * item->ndim);
+        offset = pico_ckpt_align(offset + item->nbytes);
+    }
+    header->file_bytes = offset;
+    return meta;
+}
+
+static char* pico_ckpt_tmp_path(const char* path) {
+    size_t len = strlen(path) + 5;
+    char* tmp = malloc(len);
+    if(tmp != NULL) snprintf(tmp, len, "%s.tmp", path);
+    return tmp;
+}
+
+// fsync + close fd (the open <path>.tmp), then rename it over path. unlinks it on failure
+static bool pico_ckpt_commit(int fd, bool ok, const char* tmp, const char* path) {
+    ok = ok && fsync(fd) == 0;
+    if(fd >= 0 && close(fd) != 0) ok = false;
+    ok = ok && rename(tmp, path) == 0;
+    if(!ok) {
+        fprintf(stderr, "[Pico] Error: In checkpoint - writing %s failed: %s\n", path,
+                strerror(errno));
+        unlink(tmp);
+    }
+    return ok;
+}
+
+bool pico_ckpt_write(struct PicoCkptWriter* w, const char* path) {
+    uint8_t* meta = pico_ckpt_layout(w);
+    char* tmp = pico_ckpt_tmp_path(path);
+    if(meta == NULL || tmp == NULL) {
+        free(meta);
+        free(tmp);
+        return false;
+    }
+    uint64_t data_offset = ((struct PicoCkptHeader*)meta)->data_offset;
+
+    // the index, then each tensor straight from its own memory, padded to the next boundary
+    int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    bool ok = fd >= 0 && pico_ckpt_write_all(fd, meta, data_offset);
+    static const uint8_t zeros[PICO_CKPT_ALIGN];
+    for(int i = 0; i < w->count && ok; i++) {
+        uint64_t n = w->items[i].nbytes;
+        ok = pico_ckpt_write_all(fd, w->items[i].data, n) &&
+             pico_ckpt_write_all(fd, zeros, pico_ckpt_align(n) - n);
+    }
+    ok = pico_ckpt_commit(fd, ok, tmp, path);
+    free(tmp);
+    free(meta);
+    return ok;
+}
+
+void pico_ckpt_writer_free(struct PicoCkptWriter* w) {
+    if(w == NULL) return;
+    for(int i = 0; i < w->count; i++) free(w->items[i].name);
+    free(w->items);
+    free(w);
+}
+
+// ==================== asynchronous writing
+
+#ifndef PICO_CKPT_COPY_MIN_CHUNK
+#define PICO_CKPT_COPY_MIN_CHUNK (1 << 20)  // bytes per thread for the snapshot memcpy
+#endif
+
+struct PicoCkptCopyJob {
+    uint8_t* dst;
+    const uint8_t* src;
+};
+
+static void pico_ckpt_copy_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoCkptCopyJob* job = (struct PicoCkptCopyJob*)ctx;
+    memcpy(job->dst + start, job->src + start, (size_t)(end - start));
+}
+
+static bool pico_ckpt_pwrite_all(int fd, const uint8_t* buf, uint64_t n) {
+    uint64_t done = 0;
+    while(done < n) {
+        ssize_t k = pwrite(fd, buf + done, n - done, (off_t)done);
+        if(k < 0 && errno == EINTR) continue;
+        if(k <= 0) return false;
+        done += (uint64_t)k;
+    }
+    return true;
+}
+
+static void* pico_ckpt_async_worker(void* arg) {
+    struct PicoCkptAsync* a = (struct PicoCkptAsync*)arg;
+    int fd = open(a->tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    bool ok = fd >= 0 && pico_ckpt_pwrite_all(fd, a->slab, a->bytes);
+    a->ok = pico_ckpt_commit(fd, ok, a->tmp, a->path);
+    return NULL;
+}
+
+struct PicoCkptAsync* pico_ckpt_async_init(void) {
+    struct PicoCkptAsync* a = (struct PicoCkptAsync*)calloc(1, sizeof(struct PicoCkptAsync));
+    if(a != NULL) a->ok = true;
+    return a;
+}
+
+bool pico_ckpt_write_async(struct PicoCkptAsync* a, struct PicoCkptWriter* w, const char* path) {
+    pico_ckpt_async_wait(a);
+    a->ok = false;  // until the worker commits: a save that never starts must not read as done
+    uint8_t* meta = pico_ckpt_layout(w);
+    if(meta == NULL) return false;
+    const struct PicoCkptHeader* header = (const struct PicoCkptHeader*)meta;
+    const struct PicoCkptEntry* entries = (const struct PicoCkptEntry*)(meta + sizeof(*header));
+    uint64_t bytes = header->file_bytes;
+
+    if(bytes > a->slab_cap) {
+        free(a->slab);
+        a->slab = aligned_alloc(PICO_CKPT_ALIGN, bytes);  // bytes is a multiple of 64
+        a->slab_cap = a->slab != NULL ? bytes : 0;
+        if(a->slab == NULL) {
+            fprintf(stderr, "[Pico] Error: In checkpoint - no memory for the staging slab\n");
+            free(meta);
+            return false;
+        }
+    }
+
+    // the snapshot: index, then every blob at its file offset with its pad zeroed
+    memcpy(a->slab, meta, header->data_offset);
+    for(int i = 0; i < w->count; i++) {
+        const struct PicoCkptEntry* e = &entries[i];
+        struct PicoCkptCopyJob job = {.dst = a->slab + e->offset, .src = w->items[i].data};
+        pico_parallel_for((int64_t)e->nbytes, PICO_CKPT_COPY_MIN_CHUNK, pico_ckpt_copy_slice,
+                          &job);
+        memset(a->slab + e->offset + e->nbytes, 0, pico_ckpt_align(e->nbytes) - e->nbytes);
+    }
+    free(meta);
+
+    free(a->path);
+    free(a->tmp);
+    a->path = strdup(path);
+    a->tmp = pico_ckpt_tmp_path(path);
+    a->bytes = bytes;
+    if(a->path == NULL || a->tmp == NULL ||
+       pthread_create(&a->thread, NULL, pico_ckpt_async_worker, a) != 0) {
+        fprintf(stderr, "[Pico] Error: In checkpoint - can't start the writer for %s\n", path);
+        return false;
+    }
+    a->in_flight = true;
+    return true;
+}
+
+bool pico_ckpt_async_wait(struct PicoCkptAsync* a) {
+    if(a->in_flight) {
+        pthread_join(a->thread, NULL);
+        a->in_flight = false;
+    }
+    return a->ok;
+}
+
+void pico_ckpt_async_free(struct PicoCkptAsync* a) {
+    if(a == NULL) return;
+    pico_ckpt_async_wait(a);
+    free(a->slab);
+    free(a->path);
+    free(a->tmp);
+    free(a);
+}
+
+// ==================== reading
+
+// every offset and size inside the file, every data blob aligned and sized to its shape
+static bool pico_ckpt_validate(const uint8_t* map, size_t size) {
+    if(size < sizeof(struct PicoCkptHeader)) return false;
+    const struct PicoCkptHeader* h = (const struct PicoCkptHeader*)map;
+    if(memcmp(h->magic, PICO_CKPT_MAGIC, sizeof(h->magic)) != 0) return false;
+    if(h->version != PICO_CKPT_VERSION || h->file_bytes != size) return false;
+    uint64_t index_end = sizeof(*h) + (uint64_t)h->count * sizeof(struct PicoCkptEntry);
+    if(index_end > h->data_offset || h->data_offset > size) return false;
+
+    const struct PicoCkptEntry* entries = (const struct PicoCkptEntry*)(map + sizeof(*h));
+    for(uint32_t i = 0; i < h->count; i++) {
+        const struct PicoCkptEntry* e = &entries[i];
+        if(e->ndim < 1 || e->ndim > PICO_CKPT_MAX_DIMS || !pico_ckpt_dtype_valid(e->dtype))
+            return false;
+        if(e->name_offset < index_end || e->name_offset + e->name_len > h->data_offset)
+            return false;
+        if(e->offset % PICO_CKPT_ALIGN != 0 || e->offset < h->data_offset ||
+           e->offset > size || e->nbytes > size - e->offset)
+            return false;
+        for(uint32_t d = 0; d < e->ndim; d++)
+            if(e->shape[d] < 0) return false;
+        uint64_t want = (uint64_t)pico_ckpt_numel(e->shape, (int)e->ndim) *
+                        pico_ckpt_dtype_size((enum PicoCkptDType)e->dtype);
+        if(want != e->nbytes) return false;
+    }
+    return true;
+}
+
+struct PicoCkpt* pico_ckpt_open(const char* path) {
+    int fd = open(path, O_RDONLY);
+    if(fd < 0) {
+        fprintf(stderr, "[Pico] Error: In checkpoint - can't open %s: %s\n", path,
+                strerror(errno));
+        return NULL;
+    }
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(struct PicoCkptHeader)) {
+        fprintf(stderr, "[Pico] Error: In checkpoint - %s is not a checkpoint\n", path);
+        close(fd);
+        return NULL;
+    }
+
+    // private + writable: the pages are the file's until a tensor is written to, then
+    // that page gets copied. the fd isn't needed once mapped
+    size_t size = (size_t)st.st_size;
+    void* map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(map == MAP_FAILED) {
+        fprintf(stderr, "[Pico] Error: In checkpoint - mmap of %s failed: %s\n", path,
+                strerror(errno));
+        return NULL;
+    }
+    if(!pico_ckpt_validate((const uint8_t*)map, size)) {
+        fprintf(stderr, "[Pico] Error: In checkpoint - %s is corrupt or not version %d\n",
+                path, PICO_CKPT_VERSION);
+        munmap(map, size);
+        return NULL;
+    }
+
+    struct PicoCkpt* ckpt = malloc(sizeof(struct PicoCkpt));
+    const struct PicoCkptHeader* header = (const struct PicoCkptHeader*)map;
+    struct PicoTensor** views =
+        calloc(header->count > 0 ? header->count : 1, sizeof(struct PicoTensor*));
+    if(ckpt == NULL || views == NULL) {
+        fprintf(stderr, "[Pico] Error: In checkpoint - out of memory opening %s\n", path);
+        free(ckpt);
+        free(views);
+        munmap(map, size);
+        return NULL;
+    }
+    ckpt->map = (uint8_t*)map;
+    ckpt->size = size;
+    ckpt->header = header;
+    ckpt->entries = (const struct PicoCkptEntry*)(ckpt->map + sizeof(struct PicoCkptHeader));
+    ckpt->views = views;
+    return ckpt;
+}
+
+const struct PicoCkptEntry* pico_ckpt_find(const struct PicoCkpt* ckpt, const char* name) {
+    size_t len = strlen(name);
+    for(uint32_t i = 0; i < ckpt->header->count; i++) {
+        const struct PicoCkptEntry* e = &ckpt->entries[i];
+        if(e->name_len == len && memcmp(ckpt->map + e->name_offset, name, len) == 0) return e;
+    }
+    return NULL;
+}
+
+// the entry, checked to be a tensor of `numel` elements (any dtype when numel < 0)
+static const struct PicoCkptEntry* pico_ckpt_expect(const struct PicoCkpt* ckpt,
+                                                    const char* name, enum PicoCkptDType dtype,
+                                                    int64_t numel) {
+    const struct PicoCkptEntry* e = pico_ckpt_find(ckpt, name);
+    if(e == NULL) {
+        fprintf(stderr, "[Pico] Error: In checkpoint - no entry '%s'\n", name);
+        return NULL;
+    }
+    if(e->dtype != (uint32_t)dtype || pico_ckpt_numel(e->shape, (int)e->ndim) != numel) {
+        fprintf(stderr, "[Pico] Error: In checkpoint - entry '%s' has the wrong type/size\n",
+                name);
+        return NULL;
+    }
+    return e;
+}
+
+static bool pico_ckpt_same_shape(const struct PicoCkptEntry* e, const struct PicoTensor* t) {
+    if(e->ndim != t->ndim) return false;
+    for(uint32_t d = 0; d < e->ndim; d++)
+        if(e->shape[d] != t->shape[d]) return false;
+    return true;
+}
+
+struct PicoTensor* pico_ckpt_tensor(struct PicoCkpt* ckpt, const char* name) {
+    const struct PicoCkptEntry* e = pico_ckpt_find(ckpt, name);
+    if(e == NULL || e->dtype == PICO_CKPT_I64) {
+        fprintf(stderr, "[Pico] Error: In checkpoint - no tensor '%s'\n", name);
+        return NULL;
+    }
+    size_t idx = (size_t)(e - ckpt->entries);
+    if(ckpt->views[idx] != NULL) return ckpt->views[idx];
+
+    // one block: the struct, then shape, then strides
+    struct PicoTensor* t =
+        calloc(1, sizeof(struct PicoTensor) + 2 * sizeof(int64_t) * PICO_CKPT_MAX_DIMS);
+    t->shape = (int64_t*)(t + 1);
+    t->strides = t->shape + PICO_CKPT_MAX_DIMS;
+    t->ndim = (uint8_t)e->ndim;
+    memcpy(t->shape, e->shape, sizeof(int64_t) * e->ndim);
+    pico_compute_strides(t->shape, t->ndim, t->strides);
+    t->numel = pico_ckpt_numel(e->shape, (int)e->ndim);
+    t->data = (float*)(ckpt->map + e->offset);
+    t->dtype = (PicoDType)e->dtype;
+    t->backend = CPU;
+    t->is_persistent = 0;  // not ours to free: pico_free skips it
+    t->requires_grad = 0;
+    ckpt->views[idx] = t;
+    return t;
+}
+
+bool pico_ckpt_bind(struct PicoCkpt* ckpt, const char* name, struct PicoTensor** slot) {
+    struct PicoTensor* t = pico_ckpt_tensor(ckpt, name);
+    if(t == NULL) return false;
+    if(*slot != NULL && !pico_ckpt_same_shape(pico_ckpt_find(ckpt, name), *slot)) {
+        fprintf(stderr, "[Pico] Error: In checkpoint - '%s' doesn't match the tensor's shape\n",
+                name);
+        return false;
+    }
+    if(*slot != t) pico_free(*slot);
+    *slot = t;
+    return true;
+}
+
+bool pico_ckpt_bind_linear(struct PicoCkpt* ckpt, const char* prefix, struct PicoLinear* layer) {
+    char name[PICO_CKPT_NAME_MAX];
+    snprintf(name, sizeof(name), "%s.weight", prefix);
+    if(!pico_ckpt_bind(ckpt, name, &layer->weights)) return false;
+    if(layer->bias == NULL) return true;
+    snprintf(name, sizeof(name), "%s.bias", prefix);
+    return pico_ckpt_bind(ckpt, name, &layer->bias);
+}
+
+bool pico_ckpt_load(const struct PicoCkpt* ckpt, const char* name, struct PicoTensor* dst) {
+    const struct PicoCkptEntry* e = pico_ckpt_find(ckpt, name);
+    if(e == NULL || e->dtype == PICO_CKPT_I64 || !pico_ckpt_same_shape(e, dst)) {
+        fprintf(stderr, "[Pico] Error: In checkpoint - no tensor '%s' of that shape\n", name);
+        return false;
+    }
+    pico_convert_cpu(ckpt->map + e->offset, (PicoDType)e->dtype, dst->data, dst->dtype,
+                     dst->numel);
+    return true;
+}
+
+bool pico_ckpt_load_linear(const struct PicoCkpt* ckpt, const char* prefix,
+                           struct PicoLinear* layer) {
+    char name[PICO_CKPT_NAME_MAX];
+    snprintf(name, sizeof(name), "%s.weight", prefix);
+    if(!pico_ckpt_load(ckpt, name, layer->weights)) return false;
+    if(layer->bias == NULL) return true;
+    snprintf(name, sizeof(name), "%s.bias", prefix);
+    return pico_ckpt_load(ckpt, name, layer->bias);
+}
+
+static bool pico_ckpt_load_masters(const struct PicoCkpt* ckpt, const char* prefix,
+                                   struct PicoOptimChunks* chunks, struct PicoVec* params) {
+    char name[PICO_CKPT_NAME_MAX];
+    for(int i = 0; i < (int)params->size && chunks->master_offsets != NULL; i++) {
+        if(chunks->master_offsets[i] < 0) continue;
+        int64_t numel = params->data[i]->numel;
+        snprintf(name, sizeof(name), "%s.master.%d", prefix, i);
+        const struct PicoCkptEntry* e = pico_ckpt_expect(ckpt, name, PICO_CKPT_F32, numel);
+        if(e == NULL) return false;
+        memcpy(chunks->master + chunks->master_offsets[i], ckpt->map + e->offset, e->nbytes);
+    }
+    return true;
+}
+
+bool pico_ckpt_load_optim(const struct PicoCkpt* ckpt, const char* prefix,
+                          struct PicoOptim* optim) {
+    if(!pico_optim_ensure_state(optim)) return false;
+    char name[PICO_CKPT_NAME_MAX];
+    int n_state = pico_optim_n_state(optim->kind);
+    for(int i = 0; i < (int)optim->params.size; i++) {
+        int64_t numel = optim->params.data[i]->numel;
+        for(int s = 0; s < n_state; s++) {
+            snprintf(name, sizeof(name), "%s.state%d.%d", prefix, s, i);
+            const struct PicoCkptEntry* e = pico_ckpt_expect(ckpt, name, PICO_CKPT_F32, numel);
+            if(e == NULL) return false;
+            memcpy(optim->state + s * optim->state_len + optim->offsets[i],
+                   ckpt->map + e->offset, e->nbytes);
+        }
+    }
+    if(!pico_ckpt_load_masters(ckpt, prefix, &optim->chunks, &optim->params)) return false;
+    snprintf(name, sizeof(name), "%s.step", prefix);
+    const struct PicoCkptEntry* e = pico_ckpt_expect(ckpt, name, PICO_CKPT_I64, 1);
+    if(e == NULL) return false;
+    memcpy(&optim->t, ckpt->map + e->offset, sizeof(int64_t));
+    return true;
+}
+
+bool pico_ckpt_load_optim_sgd(const struct PicoCkpt* ckpt, const char* prefix,
+                              struct PicoOptimSGD* optim) {
+    if(!pico_optim_chunks_sync(&optim->chunks, &optim->params)) return false;
+    return pico_ckpt_load_masters(ckpt, prefix, &optim->chunks, &optim->params);
+}
+
+void pico_ckpt_close(struct PicoCkpt* ckpt) {
+    if(ckpt == NULL) return;
+    for(uint32_t i = 0; i < ckpt->header->count; i++) free(ckpt->views[i]);
+    free(ckpt->views);
+    munmap(ckpt->map, ckpt->size);
+    free(ckpt);
+}
@@ -0,0 +1,171 @@
+/*
+ * checkpoints: named tensors (params + optimizer state) in one binary file.
+ *
+ * layout, version 1 (little-endian, the host's byte order):
+ *
+ *   PicoCkptHeader   64 bytes: magic "PICOCKPT", version, entry count, data_offset
+ *   PicoCkptEntry    x count: name, dtype, shape, byte offset + size of its data
+ *   names            the entry names back to back (not NUL terminated)
+ *   zero pad         up to data_offset, a multiple of PICO_CKPT_ALIGN
+ *   data             one blob per entry, each starting on a PICO_CKPT_ALIGN boundary
+ *
+ * pico_ckpt_open mmaps the file, so pico_ckpt_tensor / pico_ckpt_bind hand out tensors
+ * whose data points straight into the mapping: nothing is read until a page is
+ * touched, and a model of any size "loads" in the time it takes to check the index.
+ * the offsets are 64-byte aligned, so mapped weights are as aligned as malloc'd ones.
+ * the mapping is private: writing to a mapped tensor copies that page, never the file.
+ *
+ * the writer keeps pointers, not copies: pico_ckpt_write lays out the index, then
+ * streams each tensor's bytes from where it lives. it writes <path>.tmp, fsyncs it and
+ * renames it over <path>, so a crash mid-save leaves the previous checkpoint intact.
+ */
+#pragma once
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "nn/linear.h"
+#include "optim/optim.h"
+#include "tensor.h"
+
+#define PICO_CKPT_MAGIC "PICOCKPT"
+#define PICO_CKPT_VERSION 1
+#define PICO_CKPT_ALIGN 64
+#define PICO_CKPT_MAX_DIMS 8
+#define PICO_CKPT_NAME_MAX 256
+
+// tensor dtypes keep their PicoDType value; I64 is for counters like the Adam step
+enum PicoCkptDType {
+    PICO_CKPT_F32 = PICO_F32,
+    PICO_CKPT_BF16 = PICO_BF16,
+    PICO_CKPT_F16 = PICO_F16,
+    PICO_CKPT_I64 = 16,
+};
+
+struct PicoCkptHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t count;        // entries
+    uint64_t data_offset;  // first byte of the data section
+    uint64_t file_bytes;   // the whole file, to catch truncation
+    uint8_t reserved[32];
+};
+
+struct PicoCkptEntry {
+    uint64_t name_offset;  // from the start of the file
+    uint64_t offset;       // data, from the start of the file
+    uint64_t nbytes;
+    int64_t shape[PICO_CKPT_MAX_DIMS];
+    uint32_t name_len;
+    uint32_t dtype;  // enum PicoCkptDType
+    uint32_t ndim;
+    uint32_t reserved;
+};
+
+// ==================== writing
+
+struct PicoCkptItem {
+    char* name;
+    enum PicoCkptDType dtype;
+    int ndim;
+    int64_t shape[PICO_CKPT_MAX_DIMS];
+    const void* data;  // not owned: must stay valid until pico_ckpt_write returns
+    uint64_t nbytes;
+};
+
+struct PicoCkptWriter {
+    struct PicoCkptItem* items;
+    int count;
+    int capacity;
+};
+
+struct PicoCkptWriter* pico_ckpt_writer_init(void);
+// t must be contiguous (a strided view is refused: pass pico_contiguous() of it)
+bool pico_ckpt_add(struct PicoCkptWriter* w, const char* name, struct PicoTensor* t);
+bool pico_ckpt_add_raw(struct PicoCkptWriter* w, const char* name, enum PicoCkptDType dtype,
+                       const int64_t* shape, int ndim, const void* data);
+
+// "<prefix>.weight" and, when the layer has one, "<prefix>.bias"
+bool pico_ckpt_add_linear(struct PicoCkptWriter* w, const char* prefix, struct PicoLinear* layer);
+
+// optimizer state, per param index in registration order: "<prefix>.state<s>.<i>" for
+// each state array (momentum, Adam's m and v, ...), "<prefix>.master.<i>" for the fp32
+// masters of half params, and "<prefix>.step". a fresh optimizer (no step yet) has
+// its zero state allocated first, so the checkpoint is complete either way
+bool pico_ckpt_add_optim(struct PicoCkptWriter* w, const char* prefix, struct PicoOptim* optim);
+bool pico_ckpt_add_optim_sgd(struct PicoCkptWriter* w, const char* prefix,
+                             struct PicoOptimSGD* optim);
+
+bool pico_ckpt_write(struct PicoCkptWriter* w, const char* path);
+void pico_ckpt_writer_free(struct PicoCkptWriter* w);
+
+// ==================== asynchronous writing
+//
+// pico_ckpt_write_async copies every entry of the writer into a staging slab already in
+// the file's layout (a threaded memcpy: the only part the caller waits for), then a
+// background thread pwrites the slab to <path>.tmp, fsyncs it and renames it, like
+// pico_ckpt_write. once the call returns the params and optimizer state are free to
+// change, so training goes on while the save drains to disk. the slab is kept for the
+// next save. one save in flight at a time: a new call waits for the previous one.
+
+struct PicoCkptAsync {
+    pthread_t thread;
+    bool in_flight;
+    bool ok;  // how the last finished save went
+    uint8_t* slab;
+    uint64_t slab_cap;
+    uint64_t bytes;  // of the save in flight
+    char* path;
+    char* tmp;
+};
+
+struct PicoCkptAsync* pico_ckpt_async_init(void);
+bool pico_ckpt_write_async(struct PicoCkptAsync* a, struct PicoCkptWriter* w, const char* path);
+
+// block until the save in flight (if any) is on disk; false when the last save failed
+bool pico_ckpt_async_wait(struct PicoCkptAsync* a);
+
+// waits for the save in flight first
+void pico_ckpt_async_free(struct PicoCkptAsync* a);
+
+// ==================== reading
+
+struct PicoCkpt {
+    uint8_t* map;  // the whole file, mmap'd private
+    size_t size;
+    const struct PicoCkptHeader* header;
+    const struct PicoCkptEntry* entries;
+    struct PicoTensor** views;  // per entry, made by pico_ckpt_tensor on first use
+};
+
+// NULL (with a message) when the file is missing, truncated, or not a version-1 checkpoint
+struct PicoCkpt* pico_ckpt_open(const char* path);
+
+const struct PicoCkptEntry* pico_ckpt_find(const struct PicoCkpt* ckpt, const char* name);
+
+// zero-copy: a tensor over the mapped data (no grad, requires_grad = 0). owned by the
+// checkpoint and valid until pico_ckpt_close; pico_free on it is a no-op
+struct PicoTensor* pico_ckpt_tensor(struct PicoCkpt* ckpt, const char* name);
+
+// swap *slot for the mapped tensor of the same shape (freeing the old one), e.g.
+// pico_ckpt_bind(ckpt, "fc1.weight", &fc1->weights). for inference: the mapped tensor
+// has no grad
+bool pico_ckpt_bind(struct PicoCkpt* ckpt, const char* name, struct PicoTensor** slot);
+bool pico_ckpt_bind_linear(struct PicoCkpt* ckpt, const char* prefix, struct PicoLinear* layer);
+
+// copy into an existing tensor of the same shape (converting the dtype if needed): for
+// resuming training, where params need their own memory and grads
+bool pico_ckpt_load(const struct PicoCkpt* ckpt, const char* name, struct PicoTensor* dst);
+bool pico_ckpt_load_linear(const struct PicoCkpt* ckpt, const char* prefix,
+                           struct PicoLinear* layer);
+
+// restore what pico_ckpt_add_optim(_sgd) saved. the optimizer must have the same params
+// (same shapes, same order) registered
+bool pico_ckpt_load_optim(const struct PicoCkpt* ckpt, const char* prefix,
+                          struct PicoOptim* optim);
+bool pico_ckpt_load_optim_sgd(const struct PicoCkpt* ckpt, const char* prefix,
+                              struct PicoOptimSGD* optim);
+
+void pico_ckpt_close(struct PicoCkpt* ckpt);
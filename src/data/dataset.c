@@ -0,0 +1,376 @@
+#define _POSIX_C_SOURCE 200809L  // open / mmap / posix_madvise under -std=c11
+
+#include "dataset.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ==================== datasets
+
+// the whole file, read-only. NULL (with a message) when it can't be mapped
+static uint8_t* pico_dataset_map(const char* path, size_t* size) {
+    int fd = open(path, O_RDONLY);
+    if(fd < 0) {
+        fprintf(stderr, "[Pico] Error: In dataset - can't open %s: %s\n", path, strerror(errno));
+        return NULL;
+    }
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size == 0) {
+        fprintf(stderr, "[Pico] Error: In dataset - %s is empty\n", path);
+        close(fd);
+        return NULL;
+    }
+    *size = (size_t)st.st_size;
+    void* map = mmap(NULL, *size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(map == MAP_FAILED) {
+        fprintf(stderr, "[Pico] Error: In dataset - mmap of %s failed: %s\n", path,
+                strerror(errno));
+        return NULL;
+    }
+    return (uint8_t*)map;
+}
+
+// fill in n and sample_bytes for the samples from ds->data to the end of the mapping
+static bool pico_dataset_finish(struct PicoDataset* ds, const char* path) {
+    ds->sample_bytes = pico_dtype_size(ds->dtype);
+    for(int d = 0; d < ds->ndim; d++) ds->sample_bytes *= (size_t)ds->shape[d];
+    size_t bytes = ds->map_size - (size_t)(ds->data - ds->map);
+    if(ds->sample_bytes == 0 || bytes % ds->sample_bytes != 0) {
+        fprintf(stderr, "[Pico] Error: In dataset - %s isn't a whole number of samples\n", path);
+        return false;
+    }
+    ds->n = (int64_t)(bytes / ds->sample_bytes);
+    return true;
+}
+
+struct PicoDataset* pico_dataset_open(const char* path, PicoDType dtype, const int64_t* shape,
+                                      int ndim) {
+    if(ndim < 0 || ndim > PICO_DATASET_MAX_DIMS) {
+        fprintf(stderr, "[Pico] Error: In dataset - samples take 0..%d dims\n",
+                PICO_DATASET_MAX_DIMS);
+        return NULL;
+    }
+    for(int d = 0; d < ndim; d++) {
+        if(shape[d] <= 0) {
+            fprintf(stderr, "[Pico] Error: In dataset - sample dims must be positive\n");
+            return NULL;
+        }
+    }
+    struct PicoDataset* ds = calloc(1, sizeof(struct PicoDataset));
+    ds->map = pico_dataset_map(path, &ds->map_size);
+    if(ds->map == NULL) {
+        free(ds);
+        return NULL;
+    }
+    ds->data = ds->map;
+    ds->dtype = dtype;
+    ds->ndim = ndim;
+    memcpy(ds->shape, shape, sizeof(int64_t) * ndim);
+    if(!pico_dataset_finish(ds, path)) {
+        pico_dataset_close(ds);
+        return NULL;
+    }
+    return ds;
+}
+
+// the value after `'key':` in the .npy header dict, or NULL
+static const char* pico_npy_field(const char* header, const char* key) {
+    const char* p = strstr(header, key);
+    if(p == NULL) return NULL;
+    p = strchr(p + strlen(key), ':');
+    if(p == NULL) return NULL;
+    p++;
+    while(*p == ' ') p++;
+    return p;
+}
+
+// .npy: "\x93NUMPY", version, header length (2 bytes in v1, 4 after), then a python
+// dict literal like {'descr': '<f4', 'fortran_order': False, 'shape': (60000, 784), }
+static bool pico_npy_parse(struct PicoDataset* ds, const char* path) {
+    const uint8_t* m = ds->map;
+    if(ds->map_size < 10 || memcmp(m, "\x93NUMPY", 6) != 0) {
+        fprintf(stderr, "[Pico] Error: In dataset - %s is not a .npy file\n", path);
+        return false;
+    }
+    size_t header_len, header_at;
+    if(m[6] == 1) {
+        header_len = (size_t)m[8] | (size_t)m[9] << 8;
+        header_at = 10;
+    } else {
+        if(ds->map_size < 12) return false;
+        header_len = (size_t)m[8] | (size_t)m[9] << 8 | (size_t)m[10] << 16 | (size_t)m[11] << 24;
+        header_at = 12;
+    }
+    if(header_at + header_len > ds->map_size) {
+        fprintf(stderr, "[Pico] Error: In dataset - %s has a truncated header\n", path);
+        return false;
+    }
+    char* header = malloc(header_len + 1);
+    memcpy(header, m + header_at, header_len);
+    header[header_len] = '\0';
+
+    bool ok = false;
+    const char* descr = pico_npy_field(header, "'descr'");
+    const char* fortran = pico_npy_field(header, "'fortran_order'");
+    const char* shape = pico_npy_field(header, "'shape'");
+    if(descr == NULL || fortran == NULL || shape == NULL || *shape != '(') {
+        fprintf(stderr, "[Pico] Error: In dataset - can't read the header of %s\n", path);
+    } else if(strncmp(fortran, "False", 5) != 0) {
+        fprintf(stderr, "[Pico] Error: In dataset - %s is fortran order\n", path);
+    } else if(strncmp(descr, "'<f4'", 5) != 0 && strncmp(descr, "'<f2'", 5) != 0) {
+        fprintf(stderr, "[Pico] Error: In dataset - %s: only '<f4' and '<f2' arrays\n", path);
+    } else {
+        ds->dtype = descr[3] == '4' ? PICO_F32 : PICO_F16;
+        // (n, d0, d1, ...): the first dim is the sample count, the rest the sample shape
+        const char* p = shape + 1;
+        int dims = 0;
+        int64_t n = 0;
+        ok = true;
+        while(ok && *p != ')') {
+            char* end;
+            long long v = strtoll(p, &end, 10);
+            if(end == p || v < 0 || dims > PICO_DATASET_MAX_DIMS) {
+                ok = false;
+                break;
+            }
+            if(dims == 0) n = v;
+            else ds->shape[dims - 1] = v;
+            dims++;
+            p = end;
+            while(*p == ',' || *p == ' ') p++;
+        }
+        if(!ok || dims == 0) {
+            fprintf(stderr, "[Pico] Error: In dataset - bad shape in %s\n", path);
+            ok = false;
+        } else {
+            ds->ndim = dims - 1;
+            ds->data = m + header_at + header_len;
+            ok = pico_dataset_finish(ds, path);
+            if(ok && ds->n != n) {
+                fprintf(stderr, "[Pico] Error: In dataset - %s is truncated\n", path);
+                ok = false;
+            }
+        }
+    }
+    free(header);
+    return ok;
+}
+
+struct PicoDataset* pico_dataset_open_npy(const char* path) {
+    struct PicoDataset* ds = calloc(1, sizeof(struct PicoDataset));
+    ds->map = pico_dataset_map(path, &ds->map_size);
+    if(ds->map == NULL) {
+        free(ds);
+        return NULL;
+    }
+    if(!pico_npy_parse(ds, path)) {
+        pico_dataset_close(ds);
+        return NULL;
+    }
+    return ds;
+}
+
+void pico_dataset_close(struct PicoDataset* ds) {
+    if(ds == NULL) return;
+    if(ds->map != NULL) munmap(ds->map, ds->map_size);
+    free(ds);
+}
+
+// ==================== loader
+
+// splitmix64: the shuffle only needs a well-mixed stream per (seed, epoch)
+static uint64_t pico_loader_mix(uint64_t* state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static void pico_loader_shuffle(struct PicoLoader* l) {
+    for(int64_t i = 0; i < l->n; i++) l->order[i] = i;
+    if(!l->shuffle) return;
+    uint64_t state = l->seed ^ (l->epoch * 0xD1B54A32D192ED03ull);
+    for(int64_t i = l->n - 1; i > 0; i--) {  // Fisher-Yates
+        int64_t j = (int64_t)(pico_loader_mix(&state) % (uint64_t)(i + 1));
+        int64_t t = l->order[i];
+        l->order[i] = l->order[j];
+        l->order[j] = t;
+    }
+}
+
+// the next batch into slot (rows = 0 at the end of the epoch, which also starts the
+// next one). runs on the producer thread, unlocked: the slot isn't the caller's
+static void pico_loader_fill(struct PicoLoader* l, struct PicoLoaderSlot* slot) {
+    int64_t left = l->n - l->cursor;
+    if(left == 0 || (l->drop_last && left < l->batch)) {
+        slot->rows = 0;
+        l->cursor = 0;
+        l->epoch++;
+        pico_loader_shuffle(l);
+        return;
+    }
+    int64_t rows = left < l->batch ? left : l->batch;
+    const int64_t* idx = l->order + l->cursor;
+    for(int s = 0; s < l->n_sets; s++) {
+        const struct PicoDataset* ds = l->sets[s];
+        size_t sb = ds->sample_bytes;
+        uint8_t* dst = slot->buf[s];
+        if(!l->shuffle) {
+            memcpy(dst, ds->data + (size_t)idx[0] * sb, (size_t)rows * sb);
+        } else {
+            for(int64_t r = 0; r < rows; r++) memcpy(dst + r * sb, ds->data + idx[r] * sb, sb);
+        }
+        struct PicoTensor* v = slot->views[s];
+        v->shape[0] = rows;
+        v->numel = rows * (int64_t)(sb / pico_dtype_size(ds->dtype));
+    }
+    slot->rows = rows;
+    l->cursor += rows;
+}
+
+static void* pico_loader_producer(void* arg) {
+    struct PicoLoader* l = (struct PicoLoader*)arg;
+    pthread_mutex_lock(&l->lock);
+    while(!l->stop) {
+        struct PicoLoaderSlot* slot = &l->slots[l->produce];
+        if(slot->full) {
+            pthread_cond_wait(&l->cond, &l->lock);
+            continue;
+        }
+        pthread_mutex_unlock(&l->lock);
+        pico_loader_fill(l, slot);
+        pthread_mutex_lock(&l->lock);
+        slot->full = true;
+        l->produce ^= 1;
+        pthread_cond_broadcast(&l->cond);
+    }
+    pthread_mutex_unlock(&l->lock);
+    return NULL;
+}
+
+// a [batch, sample shape...] view over buf: one block, the struct then shape then strides.
+// it gets a grad buffer of its own so a backward through it has somewhere to write
+static struct PicoTensor* pico_loader_view(const struct PicoDataset* ds, uint8_t* buf,
+                                           int64_t batch) {
+    struct PicoTensor* t =
+        calloc(1, sizeof(struct PicoTensor) + 2 * sizeof(int64_t) * (PICO_DATASET_MAX_DIMS + 1));
+    t->shape = (int64_t*)(t + 1);
+    t->strides = t->shape + PICO_DATASET_MAX_DIMS + 1;
+    t->ndim = (uint8_t)(ds->ndim + 1);
+    t->shape[0] = batch;
+    memcpy(t->shape + 1, ds->shape, sizeof(int64_t) * ds->ndim);
+    pico_compute_strides(t->shape, t->ndim, t->strides);  // stride 0 doesn't depend on rows
+    t->numel = batch * (int64_t)(ds->sample_bytes / pico_dtype_size(ds->dtype));
+    t->data = (float*)buf;
+    t->grad = calloc(t->numel, sizeof(float));
+    t->dtype = ds->dtype;
+    t->backend = CPU;
+    t->is_persistent = 0;  // the loader's: pico_free skips it
+    t->requires_grad = 0;
+    return t;
+}
+
+struct PicoLoader* pico_loader_init(struct PicoDataset** sets, int n_sets, int64_t batch,
+                                    bool shuffle, bool drop_last, uint64_t seed) {
+    if(n_sets < 1 || n_sets > PICO_LOADER_MAX_SETS || batch < 1) {
+        fprintf(stderr, "[Pico] Error: In loader - needs 1..%d datasets and batch >= 1\n",
+                PICO_LOADER_MAX_SETS);
+        return NULL;
+    }
+    for(int s = 0; s < n_sets; s++) {
+        if(sets[s] == NULL || sets[s]->n != sets[0]->n) {
+            fprintf(stderr, "[Pico] Error: In loader - datasets must have the same length\n");
+            return NULL;
+        }
+    }
+    struct PicoLoader* l = calloc(1, sizeof(struct PicoLoader));
+    memcpy(l->sets, sets, sizeof(struct PicoDataset*) * n_sets);
+    l->n_sets = n_sets;
+    l->n = sets[0]->n;
+    l->batch = batch;
+    l->shuffle = shuffle;
+    l->drop_last = drop_last;
+    l->seed = seed;
+    l->order = malloc(sizeof(int64_t) * (l->n > 0 ? l->n : 1));
+    pico_loader_shuffle(l);
+
+    for(int s = 0; s < n_sets; s++) {
+        // shuffled batches jump around the file: don't let readahead pull in neighbours
+        if(shuffle) posix_madvise(sets[s]->map, sets[s]->map_size, POSIX_MADV_RANDOM);
+        size_t bytes = (size_t)batch * sets[s]->sample_bytes;
+        bytes = (bytes + PICO_LOADER_ALIGN - 1) / PICO_LOADER_ALIGN * PICO_LOADER_ALIGN;
+        for(int k = 0; k < 2; k++) {
+            l->slots[k].buf[s] = aligned_alloc(PICO_LOADER_ALIGN, bytes);
+            l->slots[k].views[s] = pico_loader_view(sets[s], l->slots[k].buf[s], batch);
+        }
+    }
+
+    pthread_mutex_init(&l->lock, NULL);
+    pthread_cond_init(&l->cond, NULL);
+    if(pthread_create(&l->thread, NULL, pico_loader_producer, l) != 0) {
+        fprintf(stderr, "[Pico] Error: In loader - can't start the producer thread\n");
+        pthread_mutex_destroy(&l->lock);
+        pthread_cond_destroy(&l->cond);
+        for(int k = 0; k < 2; k++) {
+            for(int s = 0; s < n_sets; s++) {
+                free(l->slots[k].buf[s]);
+                free(l->slots[k].views[s]->grad);
+                free(l->slots[k].views[s]);
+            }
+        }
+        free(l->order);
+        free(l);
+        return NULL;
+    }
+    return l;
+}
+
+bool pico_loader_next(struct PicoLoader* l, struct PicoTensor** out) {
+    pthread_mutex_lock(&l->lock);
+    if(l->holding) {  // the caller is done with the last batch: hand its slot back
+        l->slots[l->consume].full = false;
+        l->consume ^= 1;
+        l->holding = false;
+        pthread_cond_broadcast(&l->cond);
+    }
+    struct PicoLoaderSlot* slot = &l->slots[l->consume];
+    while(!slot->full) pthread_cond_wait(&l->cond, &l->lock);
+    if(slot->rows == 0) {  // end of epoch
+        slot->full = false;
+        l->consume ^= 1;
+        pthread_cond_broadcast(&l->cond);
+        pthread_mutex_unlock(&l->lock);
+        return false;
+    }
+    l->holding = true;
+    pthread_mutex_unlock(&l->lock);
+    for(int s = 0; s < l->n_sets; s++) out[s] = slot->views[s];
+    return true;
+}
+
+void pico_loader_free(struct PicoLoader* l) {
+    if(l == NULL) return;
+    pthread_mutex_lock(&l->lock);
+    l->stop = true;
+    pthread_cond_broadcast(&l->cond);
+    pthread_mutex_unlock(&l->lock);
+    pthread_join(l->thread, NULL);
+    pthread_mutex_destroy(&l->lock);
+    pthread_cond_destroy(&l->cond);
+    for(int k = 0; k < 2; k++) {
+        for(int s = 0; s < l->n_sets; s++) {
+            free(l->slots[k].buf[s]);
+            free(l->slots[k].views[s]->grad);
+            free(l->slots[k].views[s]);
+        }
+    }
+    free(l->order);
+    free(l);
+}
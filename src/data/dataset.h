@@ -0,0 +1,99 @@
+/*
+ * datasets: samples straight out of an mmap'd file, and a loader that batches them on
+ * a producer thread.
+ *
+ * a PicoDataset is one file of n samples back to back, all the same shape and dtype:
+ * either a .npy array (its first dim is n; '<f4' or '<f2', C order) or a raw binary
+ * file whose per-sample shape and dtype the caller gives. nothing is read up front:
+ * the pages come in as the loader touches them. inputs and labels are two datasets
+ * with the same n (labels as floats, the way pico_cross_entropy_loss takes them).
+ *
+ * a PicoLoader walks its datasets together in (optionally shuffled) order. a producer
+ * thread gathers the next batch into one of two fixed slots while the caller computes
+ * on the other, so pico_loader_next usually just hands over a batch that's ready. the
+ * batches come out as tensor views over the slots: made once at init, no malloc per
+ * step, and pico_free on them is a no-op. they don't require grad, but each view has a
+ * grad buffer owned by its slot, so any op's backward can write through a batch.
+ */
+#pragma once
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "tensor.h"
+
+#define PICO_DATASET_MAX_DIMS 7  // per sample: a batch view adds the batch dim
+#define PICO_LOADER_MAX_SETS 4
+#define PICO_LOADER_ALIGN 64
+
+struct PicoDataset {
+    uint8_t* map;  // the whole file, mmap'd read-only
+    size_t map_size;
+    const uint8_t* data;  // the first sample
+    PicoDType dtype;
+    int64_t n;  // samples
+    int ndim;   // per sample (0 for scalars, e.g. labels)
+    int64_t shape[PICO_DATASET_MAX_DIMS];
+    size_t sample_bytes;
+};
+
+// a raw file of samples of `shape` (ndim dims) stored as `dtype`; n is the file size
+// over the sample size, which must divide it. NULL (with a message) on failure
+struct PicoDataset* pico_dataset_open(const char* path, PicoDType dtype, const int64_t* shape,
+                                      int ndim);
+struct PicoDataset* pico_dataset_open_npy(const char* path);
+void pico_dataset_close(struct PicoDataset* ds);
+
+// ==================== loader
+
+struct PicoLoaderSlot {
+    uint8_t* buf[PICO_LOADER_MAX_SETS];  // batch x sample_bytes each, 64-byte aligned
+    struct PicoTensor* views[PICO_LOADER_MAX_SETS];
+    int64_t rows;  // in this batch; 0 marks the end of an epoch
+    bool full;     // filled by the producer, not yet given back by the caller
+};
+
+struct PicoLoader {
+    struct PicoDataset* sets[PICO_LOADER_MAX_SETS];  // not owned
+    int n_sets;
+    int64_t n;  // samples per epoch
+    int64_t batch;
+    bool shuffle;
+    bool drop_last;
+    uint64_t seed;
+
+    // producer side
+    int64_t* order;  // this epoch's sample order
+    int64_t cursor;  // next position in order
+    uint64_t epoch;
+    int produce;  // slot it fills next
+
+    // caller side
+    int consume;   // slot handed out next
+    bool holding;  // the caller has slots[consume] from the last pico_loader_next
+
+    struct PicoLoaderSlot slots[2];
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    bool stop;
+};
+
+// batches of `batch` samples over n_sets datasets of the same n, reshuffled every epoch
+// when shuffle is set (deterministic for a seed). drop_last skips the short batch at
+// the end of an epoch. the producer starts filling right away
+struct PicoLoader* pico_loader_init(struct PicoDataset** sets, int n_sets, int64_t batch,
+                                    bool shuffle, bool drop_last, uint64_t seed);
+
+// out[s] = the next batch of sets[s], shape [rows, sample shape...], rows = batch except
+// maybe at the end of an epoch. the views stay valid until the next call. returns
+// false once at the end of each epoch (out untouched); the call after that starts the
+// next epoch:
+//
+//     while(pico_loader_next(loader, batch)) { forward(batch[0]) ... }
+bool pico_loader_next(struct PicoLoader* l, struct PicoTensor** out);
+
+// stops the producer; the datasets stay open
+void pico_loader_free(struct PicoLoader* l);
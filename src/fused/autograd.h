@@ -0,0 +1,78 @@
+/*
+ * backward for the fused chains. for the chain-rule basics check out ../autograd.h
+ *
+ * each backward is the SUM of the backwards of the ops it replaces, done in one
+ * walk over self->grad instead of one walk per op.
+ */
+
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+
+#include "tensor.h"
+
+// self = a*b + c   ->   da += g*b ,  db += g*a ,  dc += g
+static inline void pico_mul_add_backward(struct PicoTensor* self) {
+    struct PicoTensor* a = self->parents[0];
+    struct PicoTensor* b = self->parents[1];
+    struct PicoTensor* c = self->parents[2];
+
+    if(a->numel == self->numel && b->numel == self->numel && c->numel == self->numel) {
+        for(int64_t i = 0; i < self->numel; i++) {
+            float g = self->grad[i];
+            a->grad[i] += g * b->data[i];
+            b->grad[i] += g * a->data[i];
+            c->grad[i] += g;
+        }
+        return;
+    }
+
+    for(int64_t i = 0; i < self->numel; i++) {
+        int64_t ia = map_index(i, a, self->strides, self->ndim);
+        int64_t ib = map_index(i, b, self->strides, self->ndim);
+        int64_t ic = map_index(i, c, self->strides, self->ndim);
+        float g = self->grad[i];
+        a->grad[ia] += g * b->data[ib];
+        b->grad[ib] += g * a->data[ia];
+        c->grad[ic] += g;
+    }
+}
+
+// self = relu(a*b + c)   ->   same as mul_add, gated by (self > 0). the gate reads
+// the saved output, so a*b + c is never recomputed.
+static inline void pico_mul_add_relu_backward(struct PicoTensor* self) {
+    struct PicoTensor* a = self->parents[0];
+    struct PicoTensor* b = self->parents[1];
+    struct PicoTensor* c = self->parents[2];
+
+    if(a->numel == self->numel && b->numel == self->numel && c->numel == self->numel) {
+        for(int64_t i = 0; i < self->numel; i++) {
+            float g = self->grad[i] * (self->data[i] > 0);
+            a->grad[i] += g * b->data[i];
+            b->grad[i] += g * a->data[i];
+            c->grad[i] += g;
+        }
+        return;
+    }
+
+    for(int64_t i = 0; i < self->numel; i++) {
+        int64_t ia = map_index(i, a, self->strides, self->ndim);
+        int64_t ib = map_index(i, b, self->strides, self->ndim);
+        int64_t ic = map_index(i, c, self->strides, self->ndim);
+        float g = self->grad[i] * (self->data[i] > 0);
+        a->grad[ia] += g * b->data[ib];
+        b->grad[ib] += g * a->data[ia];
+        c->grad[ic] += g;
+    }
+}
+
+// self = x * s(x), s = sigmoid   ->   dx += g * (s + x*s*(1-s)) = g * s * (1 + x*(1-s))
+static inline void pico_silu_backward(struct PicoTensor* self) {
+    struct PicoTensor* x = self->parents[0];
+    for(int64_t i = 0; i < self->numel; i++) {
+        float xi = x->data[i];
+        float s = 1.0f / (1.0f + expf(-xi));
+        x->grad[i] += self->grad[i] * s * (1.0f + xi * (1.0f - s));
+    }
+}
@@ -0,0 +1,108 @@
+#include "fused.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "arena.h"
+#include "fused/autograd.h"
+#include "kernels/cpu_kernels.h"
+#include "tensor.h"
+#include "view/view.h"
+
+// shared front half of every ternary fused op: validate, allocate the broadcasted
+// output, wire the three parents. the caller only picks the kernel + backward, and
+// runs it on out->parents: half inputs are widened to fp32 here.
+static struct PicoTensor* pico_fused_ternary_output(struct PicoTensor* a, struct PicoTensor* b,
+                                                    struct PicoTensor* c,
+                                                    void (*backward)(struct PicoTensor*)) {
+    if(!pico_check_broadcast_compatibility(a, b) || !pico_check_broadcast_compatibility(a, c) ||
+       !pico_check_broadcast_compatibility(b, c)) {
+        fprintf(stderr, "[Pico] Error: Shapes are not broadcastable!\n");
+        return NULL;
+    }
+
+    if(a->backend != b->backend || a->backend != c->backend) {
+        fprintf(stderr, "[Pico] Error: PicoTensor backends are not compatible!\n");
+        return NULL;
+    }
+
+    struct Arena* arena = arena_ctx_current();
+    if(arena == NULL) {
+        fprintf(stderr, "[Pico] Error: No current arena in context!\n");
+        return NULL;
+    }
+    a = pico_as_f32(pico_contiguous(a));
+    b = pico_as_f32(pico_contiguous(b));
+    c = pico_as_f32(pico_contiguous(c));
+
+    int ndim = MAX(MAX(a->ndim, b->ndim), c->ndim);
+    int64_t* a_padded_shape = pad_shape(arena, a, ndim);
+    int64_t* b_padded_shape = pad_shape(arena, b, ndim);
+    int64_t* c_padded_shape = pad_shape(arena, c, ndim);
+
+    int64_t* res_shape = arena_alloc(arena, sizeof(int64_t) * ndim);
+    for(int i = 0; i < ndim; i++)
+        res_shape[i] = MAX(MAX(a_padded_shape[i], b_padded_shape[i]), c_padded_shape[i]);
+
+    struct PicoTensor* out = pico_create_tensor(arena, res_shape, ndim);
+    out->backend = a->backend;
+
+    out->parents = arena_alloc(arena, sizeof(struct PicoTensor*) * 3);
+    out->parents[0] = a;
+    out->parents[1] = b;
+    out->parents[2] = c;
+    out->num_parents = 3;
+    out->_backward = backward;
+
+    return out;
+}
+
+struct PicoTensor* pico_mul_add(struct PicoTensor* a, struct PicoTensor* b, struct PicoTensor* c) {
+    struct PicoTensor* out = pico_fused_ternary_output(a, b, c, pico_mul_add_backward);
+    if(out == NULL) {
+        return NULL;
+    }
+
+    if(out->backend == CPU) {
+        pico_mul_add_cpu(out->parents[0], out->parents[1], out->parents[2], out);
+    }
+
+    return out;
+}
+
+struct PicoTensor* pico_mul_add_relu(struct PicoTensor* a, struct PicoTensor* b,
+                                     struct PicoTensor* c) {
+    struct PicoTensor* out = pico_fused_ternary_output(a, b, c, pico_mul_add_relu_backward);
+    if(out == NULL) {
+        return NULL;
+    }
+
+    if(out->backend == CPU) {
+        pico_mul_add_relu_cpu(out->parents[0], out->parents[1], out->parents[2], out);
+    }
+
+    return out;
+}
+
+struct PicoTensor* pico_silu(struct PicoTensor* x) {
+    struct Arena* arena = arena_ctx_current();
+    if(arena == NULL) {
+        fprintf(stderr, "[Pico] Error: No current arena in context!\n");
+        return NULL;
+    }
+    x = pico_as_f32(pico_contiguous(x));
+
+    struct PicoTensor* out = pico_create_tensor(arena, x->shape, x->ndim);
+    out->backend = x->backend;
+
+    if(x->backend == CPU) {
+        pico_silu_cpu(x, out);
+    }
+
+    out->parents = arena_alloc(arena, sizeof(struct PicoTensor*));
+    out->parents[0] = x;
+    out->num_parents = 1;
+    out->_backward = pico_silu_backward;
+
+    return out;
+}
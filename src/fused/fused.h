@@ -0,0 +1,26 @@
+/*
+ * fused element-wise chains.
+ *
+ * relu(a*b + c) built from pico_mul -> pico_add -> pico_relu costs three arena
+ * tensors (data + grad each), three passes over memory and three backward walks.
+ * these ops do the whole chain in ONE pass: one output allocation, one graph node,
+ * one fused _backward. elementwise chains are memory-bound, so cutting the passes
+ * is the whole win.
+ *
+ * adding a chain: stamp the kernel with PICO_DEFINE_TERNARY_SCALAR_OP /
+ * PICO_DEFINE_TERNARY_OP_AVX2_FP32 (kernels/cpu), add a dispatcher in cpu_kernels.h,
+ * then an op here + its backward in fused/autograd.h.
+ */
+#pragma once
+
+#include "tensor.h"
+
+// a*b + c   (broadcasting like pico_add/pico_mul)
+struct PicoTensor* pico_mul_add(struct PicoTensor* a, struct PicoTensor* b, struct PicoTensor* c);
+
+// relu(a*b + c)   (e.g. a scale-and-shift followed by the activation)
+struct PicoTensor* pico_mul_add_relu(struct PicoTensor* a, struct PicoTensor* b,
+                                     struct PicoTensor* c);
+
+// x * sigmoid(x)   (SiLU / swish), no sigmoid tensor in between
+struct PicoTensor* pico_silu(struct PicoTensor* x);
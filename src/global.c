@@ -5,12 +5,12 @@
 #include <time.h>    // Required for time()
 
 #include "arena.h"
+#include "rng/rng.h"
 #include "tpool.h"
 
 SimdLevel g_simd_level = SIMD_NONE;
 GpuBackend g_gpu_backend = GPU_UNKNOWN;
 int g_pico_initialized = 0;
-uint32_t x_state = 123456789;  // Ultra-fast state variables (non-zero seeds)
 struct PicoTPool* global_tp = NULL;
 static int g_pico_shutdown_registered = 0;
 
@@ -57,7 +57,7 @@ void pico_init(void) {
     printf("  ════════════════════════════════════════════════════════════\n");
     printf("\n");
 
-    x_state = (uint32_t)time(NULL);
+    pico_rng_seed((uint64_t)time(NULL));  // pico_rng_seed(s) after init for repeatable runs
 
     global_tp = pico_tpool_create(8);
     if(global_tp != NULL) {
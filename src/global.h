@@ -13,7 +13,6 @@ extern int g_pico_initialized;
 
 extern struct PicoTPool* global_tp;
 
-extern uint32_t x_state;
 #define PI_F 3.14159265358979323846f  // M_PI isn't exposed under -std=c11
 
 void pico_init(void);
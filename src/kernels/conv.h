@@ -0,0 +1,110 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "tensor.h"
+
+// convolution geometry, shared by the nn layer and the kernels. activations are NHWC
+// (channels innermost, so one pixel's channels are one contiguous run) and weights
+// [k, k, c / groups, oc]: for group g, rows (kh, kw, c) x columns g * og .. (g + 1) * og
+struct PicoConvShape {
+    int64_t n, h, w, c;  // input
+    int64_t oh, ow, oc;  // output
+    int64_t k, stride, pad, dilation;
+    int64_t groups;
+};
+
+// output size along one spatial dim, < 1 when the kernel doesn't fit
+static inline int64_t pico_conv_out_size(int64_t in, int64_t k, int64_t stride, int64_t pad,
+                                         int64_t dilation) {
+    int64_t span = in + 2 * pad - dilation * (k - 1) - 1;
+    return span < 0 ? 0 : span / stride + 1;
+}
+
+// a 1x1 kernel at stride 1 without padding reads the input in place: NHWC x already is
+// the [n * h * w, c] matrix im2col would build
+static inline bool pico_conv_is_pointwise(const struct PicoConvShape* s) {
+    return s->k == 1 && s->stride == 1 && s->pad == 0;
+}
+
+// how a conv runs on CPU (pico_conv2d_cpu), picked from its shape by pico_conv_select:
+//   POINTWISE  1x1, stride 1, no padding: one GEMM straight on x
+//   DEPTHWISE  groups == c == oc: a direct loop, vectorized over channels
+//   WINOGRAD   3x3, stride 1, no dilation, one group, enough channels: F(2x2, 3x3)
+//   IM2COL     everything else: im2col + GEMM per group
+enum PicoConvAlgo {
+    PICO_CONV_IM2COL,
+    PICO_CONV_POINTWISE,
+    PICO_CONV_DEPTHWISE,
+    PICO_CONV_WINOGRAD
+};
+
+// below this many input and output channels the Winograd transforms cost more than the
+// multiplies they save
+#ifndef PICO_WINOGRAD_MIN_CHANNELS
+#define PICO_WINOGRAD_MIN_CHANNELS 16
+#endif
+
+static inline enum PicoConvAlgo pico_conv_select(const struct PicoConvShape* s) {
+    if(pico_conv_is_pointwise(s)) return PICO_CONV_POINTWISE;
+    if(s->groups == s->c && s->oc == s->c) return PICO_CONV_DEPTHWISE;
+    if(s->k == 3 && s->stride == 1 && s->dilation == 1 && s->groups == 1 &&
+       s->c >= PICO_WINOGRAD_MIN_CHANNELS && s->oc >= PICO_WINOGRAD_MIN_CHANNELS)
+        return PICO_CONV_WINOGRAD;
+    return PICO_CONV_IM2COL;
+}
+
+// Winograd works on 2x2 output tiles: n * tiles_h * tiles_w of them
+static inline int64_t pico_winograd_tiles(const struct PicoConvShape* s) {
+    return s->n * ((s->oh + 1) / 2) * ((s->ow + 1) / 2);
+}
+
+// tile t's image, and its top-left output pixel (the input tile starts pad above / left)
+static inline int64_t pico_winograd_tile(const struct PicoConvShape* s, int64_t t, int64_t* oh0,
+                                         int64_t* ow0) {
+    int64_t th = (s->oh + 1) / 2, tw = (s->ow + 1) / 2;
+    *oh0 = t / tw % th * 2;
+    *ow0 = t % tw * 2;
+    return t / (th * tw);
+}
+
+// floats of scratch pico_conv2d_cpu needs for `algo`: the im2col matrix of one group, or
+// Winograd's transformed weights, input tiles and products (16 of each)
+static inline int64_t pico_conv_scratch_floats(const struct PicoConvShape* s,
+                                               enum PicoConvAlgo algo) {
+    switch(algo) {
+        case PICO_CONV_IM2COL: return s->n * s->oh * s->ow * s->k * s->k * (s->c / s->groups);
+        case PICO_CONV_WINOGRAD:
+            return 16 * (s->c * s->oc + pico_winograd_tiles(s) * (s->c + s->oc));
+        default: return 0;
+    }
+}
+
+// a [rows, cols] fp32 matrix header over raw memory, for handing scratch buffers and
+// per-group column slices to the GEMM. keep `m` in place while the header is in use:
+// the tensor points into it
+struct PicoConvMat {
+    struct PicoTensor t;
+    int64_t shape[2];
+    int64_t strides[2];
+};
+
+static inline struct PicoTensor* pico_conv_mat(struct PicoConvMat* m, float* data, int64_t rows,
+                                               int64_t cols, int64_t row_stride,
+                                               int64_t col_stride) {
+    memset(&m->t, 0, sizeof(m->t));
+    m->shape[0] = rows;
+    m->shape[1] = cols;
+    m->strides[0] = row_stride;
+    m->strides[1] = col_stride;
+    m->t.shape = m->shape;
+    m->t.strides = m->strides;
+    m->t.data = data;
+    m->t.numel = rows * cols;
+    m->t.ndim = 2;
+    m->t.backend = CPU;
+    m->t.dtype = PICO_F32;
+    return &m->t;
+}
@@ -4,6 +4,8 @@
 #include <stdbool.h>
 
 #include "global.h"
+#include "kernels/cpu/cpu_avx_2.h"
+#include "kernels/epilogue.h"
 #include "tensor.h"
 #include "tpool.h"
 
@@ -21,7 +23,8 @@
 
 static inline void pico_matmul_cpu_avx_kernel_scalar_Xx8(struct PicoTensor* a, struct PicoTensor* b,
                                                          struct PicoTensor* out, int k_dim, int i,
-                                                         int j, int roll) {
+                                                         int j, int roll,
+                                                         const struct PicoMatmulEpilogue* epi) {
     float m_cells[roll];
     for(int k = 0; k < k_dim; k += 1) {
         _Pragma("GCC unroll 16") for(int r = 0; r < roll; r++) {
@@ -30,26 +33,49 @@ static inline void pico_matmul_cpu_avx_kernel_scalar_Xx8(struct PicoTensor* a, s
 
         _Pragma("GCC unroll 16") for(int r = 0; r < roll; r++) {
             out->data[(i + r) * out->strides[0] + j * out->strides[1]] +=
-                m_cells[r] * b->data[k * b->strides[0] + j * b->strides[1]];
+                m_cells[r] * pico_tensor_get(b, k * b->strides[0] + j * b->strides[1]);
+        }
+    }
+
+    if(epi != NULL) {
+        for(int r = 0; r < roll; r++) {
+            float* cell = &out->data[(i + r) * out->strides[0] + j * out->strides[1]];
+            *cell = pico_epilogue_apply_f32(epi, *cell, j);
         }
     }
 }
 
 static inline void pico_matmul_cpu_avx_kernel_scalar_1x8(struct PicoTensor* a, struct PicoTensor* b,
                                                          struct PicoTensor* out, int k_dim, int i,
-                                                         int j) {
+                                                         int j,
+                                                         const struct PicoMatmulEpilogue* epi) {
     for(int k = 0; k < k_dim; k++) {
         float m_cell = a->data[i * a->strides[0] + k * a->strides[1]];  // M [i,K]
 
         out->data[i * out->strides[0] + j * out->strides[1]] +=
-            m_cell * b->data[k * b->strides[0] + j * b->strides[1]];
+            m_cell * pico_tensor_get(b, k * b->strides[0] + j * b->strides[1]);
+    }
+
+    if(epi != NULL) {
+        float* cell = &out->data[i * out->strides[0] + j * out->strides[1]];
+        *cell = pico_epilogue_apply_f32(epi, *cell, j);
     }
 }
 
-#define PICO_DEFINE_MATMUL_CPU_AVX_MKERNEL_X(roll)                                                 \
-    __attribute__((target("avx2,fma"), always_inline)) static inline void                          \
-    pico_matmul_cpu_avx_kernel_##roll##_8(struct PicoTensor* a, struct PicoTensor* b,              \
-                                          struct PicoTensor* out, int k_dim, int i, int j) {       \
+// B rows are loaded 8 columns at a time by LOAD_B(ptr to B[k, j]) and widened to fp32
+// in registers when B is stored in half precision: the FMAs and the accumulators are
+// fp32 whatever B's dtype, so a half B halves the bytes streamed through the K loop
+// without touching the precision of the sum.
+#define PICO_MATMUL_AVX_LOAD_F32(base, idx) _mm256_loadu_ps(&(base)->data[idx])
+#define PICO_MATMUL_AVX_LOAD_F16(base, idx) \
+    _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)&(base)->data16[idx]))
+#define PICO_MATMUL_AVX_LOAD_BF16(base, idx) pico_avx2_bf16_load(&(base)->data16[idx])
+
+#define PICO_DEFINE_MATMUL_CPU_AVX_MKERNEL_X(roll, suffix, target_isa, LOAD_B)                     \
+    __attribute__((target(target_isa), always_inline)) static inline void                          \
+    pico_matmul_cpu_avx_kernel_##roll##_8##suffix(struct PicoTensor* a, struct PicoTensor* b,      \
+                                                  struct PicoTensor* out, int k_dim, int i, int j, \
+                                                  const struct PicoMatmulEpilogue* epi) {          \
         __m256 acc[roll];                                                                          \
                                                                                                    \
         _Pragma("GCC unroll 16") for(int r = 0; r < roll; r++) {                                   \
@@ -61,70 +87,114 @@ static inline void pico_matmul_cpu_avx_kernel_scalar_1x8(struct PicoTensor* a, s
                 m_vecs[r] = _mm256_set1_ps(a->data[(i + r) * a->strides[0] + k * a->strides[1]]);  \
             }                                                                                      \
                                                                                                    \
-            __m256 n_vec = _mm256_loadu_ps(&b->data[k * b->strides[0] + j * b->strides[1]]);       \
+            __m256 n_vec = LOAD_B(b, k * b->strides[0] + j * b->strides[1]);                       \
                                                                                                    \
             _Pragma("GCC unroll 16") for(int r = 0; r < roll; r++) {                               \
                 acc[r] = _mm256_fmadd_ps(m_vecs[r], n_vec, acc[r]);                                \
             }                                                                                      \
         }                                                                                          \
+        /* epilogue: the tile is still in registers, finish it before the one store */             \
+        if(epi != NULL) {                                                                          \
+            if(epi->bias != NULL) {                                                                \
+                __m256 bias_vec = _mm256_loadu_ps(&epi->bias[j]);                                  \
+                _Pragma("GCC unroll 16") for(int r = 0; r < roll; r++) {                           \
+                    acc[r] = _mm256_add_ps(acc[r], bias_vec);                                      \
+                }                                                                                  \
+            }                                                                                      \
+            if(epi->act == PICO_ACT_RELU) {                                                        \
+                _Pragma("GCC unroll 16") for(int r = 0; r < roll; r++) {                           \
+                    acc[r] = _mm256_max_ps(acc[r], _mm256_setzero_ps());                           \
+                }                                                                                  \
+            }                                                                                      \
+        }                                                                                          \
         _Pragma("GCC unroll 16") for(int r = 0; r < roll; r++) {                                   \
             _mm256_storeu_ps(&out->data[(i + r) * out->strides[0] + j * out->strides[1]], acc[r]); \
         }                                                                                          \
     }
 
-PICO_DEFINE_MATMUL_CPU_AVX_MKERNEL_X(8);
-PICO_DEFINE_MATMUL_CPU_AVX_MKERNEL_X(4);
-PICO_DEFINE_MATMUL_CPU_AVX_MKERNEL_X(2);
-PICO_DEFINE_MATMUL_CPU_AVX_MKERNEL_X(1);
-
-__attribute__((target("avx2,fma"), always_inline)) static inline void pico_matmul_cpu_avx_exec(
-    struct PicoTensor* a, struct PicoTensor* b, struct PicoTensor* out, int row_start, int row_end,
-    int columns, int k_dim) {
-    int i = row_start;
-    int rows = row_end;
-    int roll = 8;
-
-    for(; i + roll <= rows; i += roll) {
-        int j = 0;
-        for(; j + 8 <= columns; j += 8) {
-            pico_matmul_cpu_avx_kernel_8_8(a, b, out, k_dim, i, j);
-        }
-        for(; j < columns; j++) {
-            pico_matmul_cpu_avx_kernel_scalar_Xx8(a, b, out, k_dim, i, j, roll);
-        }
+// the 8 -> 4 -> 2 -> 1 row cascade over [row_start, row_end), one per B dtype
+#define PICO_DEFINE_MATMUL_CPU_AVX_EXEC(suffix, target_isa)                               \
+    __attribute__((target(target_isa), always_inline)) static inline void                 \
+    pico_matmul_cpu_avx_exec##suffix(struct PicoTensor* a, struct PicoTensor* b,          \
+                                     struct PicoTensor* out, int row_start, int row_end,  \
+                                     int columns, int k_dim,                              \
+                                     const struct PicoMatmulEpilogue* epi) {              \
+        int i = row_start;                                                                \
+        int rows = row_end;                                                               \
+        int roll = 8;                                                                     \
+                                                                                          \
+        for(; i + roll <= rows; i += roll) {                                              \
+            int j = 0;                                                                    \
+            for(; j + 8 <= columns; j += 8) {                                             \
+                pico_matmul_cpu_avx_kernel_8_8##suffix(a, b, out, k_dim, i, j, epi);      \
+            }                                                                             \
+            for(; j < columns; j++) {                                                     \
+                pico_matmul_cpu_avx_kernel_scalar_Xx8(a, b, out, k_dim, i, j, roll, epi); \
+            }                                                                             \
+        }                                                                                 \
+                                                                                          \
+        roll = 4;                                                                         \
+        for(; i + roll <= rows; i += roll) {                                              \
+            int j = 0;                                                                    \
+            for(; j + 8 <= columns; j += 8) {                                             \
+                pico_matmul_cpu_avx_kernel_4_8##suffix(a, b, out, k_dim, i, j, epi);      \
+            }                                                                             \
+            for(; j < columns; j++) {                                                     \
+                pico_matmul_cpu_avx_kernel_scalar_Xx8(a, b, out, k_dim, i, j, roll, epi); \
+            }                                                                             \
+        }                                                                                 \
+                                                                                          \
+        roll = 2;                                                                         \
+        for(; i + roll <= rows; i += roll) {                                              \
+            int j = 0;                                                                    \
+            for(; j + 8 <= columns; j += 8) {                                             \
+                pico_matmul_cpu_avx_kernel_2_8##suffix(a, b, out, k_dim, i, j, epi);      \
+            }                                                                             \
+            for(; j < columns; j++) {                                                     \
+                pico_matmul_cpu_avx_kernel_scalar_Xx8(a, b, out, k_dim, i, j, roll, epi); \
+            }                                                                             \
+        }                                                                                 \
+                                                                                          \
+        roll = 1;                                                                         \
+        for(; i + roll <= rows; i += roll) {                                              \
+            int j = 0;                                                                    \
+            for(; j + 8 <= columns; j += 8) {                                             \
+                pico_matmul_cpu_avx_kernel_1_8##suffix(a, b, out, k_dim, i, j, epi);      \
+            }                                                                             \
+            for(; j < columns; j++) {                                                     \
+                pico_matmul_cpu_avx_kernel_scalar_1x8(a, b, out, k_dim, i, j, epi);       \
+            }                                                                             \
+        }                                                                                 \
     }
 
-    roll = 4;
-    for(; i + roll <= rows; i += roll) {
-        int j = 0;
-        for(; j + 8 <= columns; j += 8) {
-            pico_matmul_cpu_avx_kernel_4_8(a, b, out, k_dim, i, j);
-        }
-        for(; j < columns; j++) {
-            pico_matmul_cpu_avx_kernel_scalar_Xx8(a, b, out, k_dim, i, j, roll);
-        }
-    }
-
-    roll = 2;
-    for(; i + roll <= rows; i += roll) {
-        int j = 0;
-        for(; j + 8 <= columns; j += 8) {
-            pico_matmul_cpu_avx_kernel_2_8(a, b, out, k_dim, i, j);
-        }
-        for(; j < columns; j++) {
-            pico_matmul_cpu_avx_kernel_scalar_Xx8(a, b, out, k_dim, i, j, roll);
-        }
-    }
-
-    roll = 1;
-    for(; i + roll <= rows; i += roll) {
-        int j = 0;
-        for(; j + 8 <= columns; j += 8) {
-            pico_matmul_cpu_avx_kernel_1_8(a, b, out, k_dim, i, j);
-        }
-        for(; j < columns; j++) {
-            pico_matmul_cpu_avx_kernel_scalar_1x8(a, b, out, k_dim, i, j);
-        }
+// only the fp16 variant needs F16C: the fp32 kernels stay inlinable into plain
+// avx2,fma callers (the bench drivers)
+#define PICO_DEFINE_MATMUL_CPU_AVX_VARIANT(suffix, target_isa, LOAD_B)  \
+    PICO_DEFINE_MATMUL_CPU_AVX_MKERNEL_X(8, suffix, target_isa, LOAD_B) \
+    PICO_DEFINE_MATMUL_CPU_AVX_MKERNEL_X(4, suffix, target_isa, LOAD_B) \
+    PICO_DEFINE_MATMUL_CPU_AVX_MKERNEL_X(2, suffix, target_isa, LOAD_B) \
+    PICO_DEFINE_MATMUL_CPU_AVX_MKERNEL_X(1, suffix, target_isa, LOAD_B) \
+    PICO_DEFINE_MATMUL_CPU_AVX_EXEC(suffix, target_isa)
+
+PICO_DEFINE_MATMUL_CPU_AVX_VARIANT(, "avx2,fma", PICO_MATMUL_AVX_LOAD_F32)
+PICO_DEFINE_MATMUL_CPU_AVX_VARIANT(_f16, "avx2,fma,f16c", PICO_MATMUL_AVX_LOAD_F16)
+PICO_DEFINE_MATMUL_CPU_AVX_VARIANT(_bf16, "avx2,fma", PICO_MATMUL_AVX_LOAD_BF16)
+
+// A, C and the bias are fp32 here (pico_matmul_epilogue_cpu widens / narrows around
+// the call); B may be any dtype and is read as stored.
+__attribute__((target("avx2,fma,f16c"), always_inline)) static inline void
+pico_matmul_cpu_avx_exec_any(struct PicoTensor* a, struct PicoTensor* b, struct PicoTensor* out,
+                             int row_start, int row_end, int columns, int k_dim,
+                             const struct PicoMatmulEpilogue* epi) {
+    switch(b->dtype) {
+        case PICO_F16:
+            pico_matmul_cpu_avx_exec_f16(a, b, out, row_start, row_end, columns, k_dim, epi);
+            break;
+        case PICO_BF16:
+            pico_matmul_cpu_avx_exec_bf16(a, b, out, row_start, row_end, columns, k_dim, epi);
+            break;
+        default:
+            pico_matmul_cpu_avx_exec(a, b, out, row_start, row_end, columns, k_dim, epi);
     }
 }
 
@@ -138,26 +208,30 @@ struct ThreadArgs {
 
     int columns;
     int k_dim;
+
+    const struct PicoMatmulEpilogue* epi;  // NULL = plain matmul
 };
 
-__attribute__((target("avx2,fma"), always_inline)) static inline void
+__attribute__((target("avx2,fma,f16c"), always_inline)) static inline void
 pico_matmul_cpu_avx_thread_entry(void* arg) {
     struct ThreadArgs* thread_args = (struct ThreadArgs*)arg;
-    pico_matmul_cpu_avx_exec(thread_args->a, thread_args->b, thread_args->out,
-                             thread_args->row_start, thread_args->row_end, thread_args->columns,
-                             thread_args->k_dim);
+    pico_matmul_cpu_avx_exec_any(thread_args->a, thread_args->b, thread_args->out,
+                                 thread_args->row_start, thread_args->row_end,
+                                 thread_args->columns, thread_args->k_dim, thread_args->epi);
 }
 
-__attribute__((target("avx2,fma"))) static inline void pico_matmul_cpu_avx(struct PicoTensor* a,
-                                                                           struct PicoTensor* b,
-                                                                           struct PicoTensor* out) {
+// C = A·B with an optional epilogue (bias + activation) fused into the tile store.
+// epi == NULL is the plain matmul.
+__attribute__((target("avx2,fma,f16c"))) static inline void pico_matmul_epilogue_cpu_avx(
+    struct PicoTensor* a, struct PicoTensor* b, struct PicoTensor* out,
+    const struct PicoMatmulEpilogue* epi) {
     int k_dim = a->shape[1];
     int columns = b->shape[1];
     int rows = a->shape[0];
 
     if(rows < MATMUL_THREAD_MIN_ROWS) {
         int i = 0;
-        pico_matmul_cpu_avx_exec(a, b, out, i, rows, columns, k_dim);
+        pico_matmul_cpu_avx_exec_any(a, b, out, i, rows, columns, k_dim, epi);
         return;
     }
 
@@ -193,6 +267,7 @@ __attribute__((target("avx2,fma"))) static inline void pico_matmul_cpu_avx(struc
         args[thread].row_end = end_row;
         args[thread].columns = columns;
         args[thread].k_dim = k_dim;
+        args[thread].epi = epi;
 
         pico_tpool_add_work(global_tp, pico_matmul_cpu_avx_thread_entry, &args[thread]);
 
@@ -203,3 +278,8 @@ __attribute__((target("avx2,fma"))) static inline void pico_matmul_cpu_avx(struc
 
     free(args);
 }
+
+__attribute__((target("avx2,fma,f16c"))) static inline void pico_matmul_cpu_avx(
+    struct PicoTensor* a, struct PicoTensor* b, struct PicoTensor* out) {
+    pico_matmul_epilogue_cpu_avx(a, b, out, NULL);
+}
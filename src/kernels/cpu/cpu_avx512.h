@@ -0,0 +1,756 @@
+#pragma once
+#include <float.h>
+#include <immintrin.h>
+#include <math.h>
+#include "kernels/cpu/cpu_scalar.h"
+#include "tensor.h"
+
+// AVX-512 (16-lane) versions of the vector math in cpu_avx_2.h. same Cephes
+// polynomials, same range reductions, same special-value handling and the same
+// measured error bounds (see the table at the top of the vector math section there);
+// only the width changes, plus native mask registers for the tails and blends.
+//
+// only AVX-512F is assumed. the float and/or/xor forms are AVX-512DQ, so bit tricks go
+// through the integer domain with casts instead.
+
+__attribute__((target("avx512f"))) static inline __m512 pico_avx512_xor_ps(__m512 a, __m512 b) {
+    return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a), _mm512_castps_si512(b)));
+}
+
+__attribute__((target("avx512f"))) static inline __m512 pico_avx512_abs_ps(__m512 x) {
+    return _mm512_castsi512_ps(
+        _mm512_and_si512(_mm512_castps_si512(x), _mm512_set1_epi32(0x7fffffff)));
+}
+
+__attribute__((target("avx512f"))) static inline __m512 pico_avx512_sign_ps(__m512 x) {
+    return _mm512_castsi512_ps(
+        _mm512_and_si512(_mm512_castps_si512(x), _mm512_set1_epi32((int)0x80000000)));
+}
+
+// lanes [0, min(n, 16)) set
+static inline __mmask16 pico_avx512_tail_mask(int64_t n) {
+    return n >= 16 ? (__mmask16)0xffff : (__mmask16)((1u << n) - 1u);
+}
+
+// e^x, see pico_exp_avx2_ps
+__attribute__((target("avx512f"))) static inline __m512 pico_exp_avx512_ps(__m512 x) {
+    const __m512 hi = _mm512_set1_ps(88.7228391117f);
+    const __m512 lo = _mm512_set1_ps(-87.3365447504f);
+    __m512 xc = _mm512_max_ps(_mm512_min_ps(x, hi), lo);
+
+    __m512 n = _mm512_roundscale_ps(_mm512_mul_ps(xc, _mm512_set1_ps(1.44269504088896341f)),
+                                    _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+
+    __m512 r = _mm512_fnmadd_ps(n, _mm512_set1_ps(0.693359375f), xc);
+    r = _mm512_fnmadd_ps(n, _mm512_set1_ps(-2.12194440e-4f), r);
+
+    __m512 p = _mm512_set1_ps(1.9875691500e-4f);
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(1.3981999507e-3f));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(8.3334519073e-3f));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(4.1665795894e-2f));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(1.6666665459e-1f));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(5.0000001201e-1f));
+    p = _mm512_fmadd_ps(p, _mm512_mul_ps(r, r), _mm512_add_ps(r, _mm512_set1_ps(1.0f)));
+
+    __m512i ni = _mm512_cvtps_epi32(n);
+    __m512i n1 = _mm512_srai_epi32(ni, 1);
+    __m512i n2 = _mm512_sub_epi32(ni, n1);
+    const __m512i bias = _mm512_set1_epi32(127);
+    __m512 s1 = _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_add_epi32(n1, bias), 23));
+    __m512 s2 = _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_add_epi32(n2, bias), 23));
+    p = _mm512_mul_ps(_mm512_mul_ps(p, s1), s2);
+
+    p = _mm512_mask_blend_ps(_mm512_cmp_ps_mask(x, hi, _CMP_GT_OQ), p, _mm512_set1_ps(INFINITY));
+    p = _mm512_mask_blend_ps(_mm512_cmp_ps_mask(x, lo, _CMP_LT_OQ), p, _mm512_setzero_ps());
+    return _mm512_mask_blend_ps(_mm512_cmp_ps_mask(x, x, _CMP_UNORD_Q), p, x);
+}
+
+// ln(x), see pico_log_avx2_ps
+__attribute__((target("avx512f"))) static inline __m512 pico_log_avx512_ps(__m512 x) {
+    const __m512 one = _mm512_set1_ps(1.0f);
+    __m512 in = x;
+
+    __mmask16 denorm = _mm512_cmp_ps_mask(x, _mm512_set1_ps(1.17549435e-38f), _CMP_LT_OQ);
+    x = _mm512_mask_mul_ps(x, denorm, x, _mm512_set1_ps(8388608.0f));
+
+    __m512i bits = _mm512_castps_si512(x);
+    __m512 e = _mm512_cvtepi32_ps(
+        _mm512_sub_epi32(_mm512_srli_epi32(bits, 23), _mm512_set1_epi32(126)));
+    e = _mm512_mask_sub_ps(e, denorm, e, _mm512_set1_ps(23.0f));
+    __m512 m = _mm512_castsi512_ps(_mm512_or_si512(
+        _mm512_and_si512(bits, _mm512_set1_epi32(0x007fffff)), _mm512_set1_epi32(0x3f000000)));
+
+    __mmask16 small = _mm512_cmp_ps_mask(m, _mm512_set1_ps(0.707106781186547524f), _CMP_LT_OQ);
+    e = _mm512_mask_sub_ps(e, small, e, one);
+    m = _mm512_sub_ps(_mm512_mask_add_ps(m, small, m, m), one);
+
+    __m512 z = _mm512_mul_ps(m, m);
+    __m512 y = _mm512_set1_ps(7.0376836292e-2f);
+    y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(-1.1514610310e-1f));
+    y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(1.1676998740e-1f));
+    y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(-1.2420140846e-1f));
+    y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(1.4249322787e-1f));
+    y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(-1.6668057665e-1f));
+    y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(2.0000714765e-1f));
+    y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(-2.4999993993e-1f));
+    y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(3.3333331174e-1f));
+    y = _mm512_mul_ps(_mm512_mul_ps(y, m), z);
+
+    y = _mm512_fmadd_ps(e, _mm512_set1_ps(-2.12194440e-4f), y);
+    y = _mm512_fnmadd_ps(z, _mm512_set1_ps(0.5f), y);
+    __m512 r = _mm512_add_ps(m, y);
+    r = _mm512_fmadd_ps(e, _mm512_set1_ps(0.693359375f), r);
+
+    const __m512 zero = _mm512_setzero_ps();
+    r = _mm512_mask_blend_ps(_mm512_cmp_ps_mask(in, zero, _CMP_EQ_OQ), r,
+                             _mm512_set1_ps(-INFINITY));
+    r = _mm512_mask_blend_ps(_mm512_cmp_ps_mask(in, _mm512_set1_ps(INFINITY), _CMP_EQ_OQ), r, in);
+    return _mm512_mask_blend_ps(_mm512_cmp_ps_mask(in, zero, _CMP_NGE_UQ), r,
+                                _mm512_set1_ps(NAN));
+}
+
+// sin + cos from one reduction, see pico_sincos_avx2_ps
+#define PICO_SINCOS_AVX512_MAX 8192.0f
+
+__attribute__((target("avx512f"))) static inline void pico_sincos_avx512_ps(__m512 x, __m512* s,
+                                                                           __m512* c) {
+    __m512 sign_sin = pico_avx512_sign_ps(x);
+    __m512 ax = pico_avx512_abs_ps(x);
+
+    __m512i j = _mm512_cvttps_epi32(_mm512_mul_ps(ax, _mm512_set1_ps(1.27323954473516f)));
+    j = _mm512_and_si512(_mm512_add_epi32(j, _mm512_set1_epi32(1)), _mm512_set1_epi32(~1));
+    __m512 y = _mm512_cvtepi32_ps(j);
+
+    __m512 swap_sin = _mm512_castsi512_ps(
+        _mm512_slli_epi32(_mm512_and_si512(j, _mm512_set1_epi32(4)), 29));
+    __m512 sign_cos = _mm512_castsi512_ps(_mm512_slli_epi32(
+        _mm512_andnot_si512(_mm512_sub_epi32(j, _mm512_set1_epi32(2)), _mm512_set1_epi32(4)),
+        29));
+    sign_sin = pico_avx512_xor_ps(sign_sin, swap_sin);
+    __mmask16 use_sin_poly = _mm512_testn_epi32_mask(j, _mm512_set1_epi32(2));
+
+    __m512 r = _mm512_fnmadd_ps(y, _mm512_set1_ps(0.78515625f), ax);
+    r = _mm512_fnmadd_ps(y, _mm512_set1_ps(2.4187564849853515625e-4f), r);
+    r = _mm512_fnmadd_ps(y, _mm512_set1_ps(3.77489497744594108e-8f), r);
+    __m512 z = _mm512_mul_ps(r, r);
+
+    __m512 pc = _mm512_set1_ps(2.443315711809948e-5f);
+    pc = _mm512_fmadd_ps(pc, z, _mm512_set1_ps(-1.388731625493765e-3f));
+    pc = _mm512_fmadd_ps(pc, z, _mm512_set1_ps(4.166664568298827e-2f));
+    pc = _mm512_mul_ps(_mm512_mul_ps(pc, z), z);
+    pc = _mm512_fnmadd_ps(z, _mm512_set1_ps(0.5f), pc);
+    pc = _mm512_add_ps(pc, _mm512_set1_ps(1.0f));
+
+    __m512 ps = _mm512_set1_ps(-1.9515295891e-4f);
+    ps = _mm512_fmadd_ps(ps, z, _mm512_set1_ps(8.3321608736e-3f));
+    ps = _mm512_fmadd_ps(ps, z, _mm512_set1_ps(-1.6666654611e-1f));
+    ps = _mm512_fmadd_ps(_mm512_mul_ps(ps, z), r, r);
+
+    *s = pico_avx512_xor_ps(_mm512_mask_blend_ps(use_sin_poly, pc, ps), sign_sin);
+    *c = pico_avx512_xor_ps(_mm512_mask_blend_ps(use_sin_poly, ps, pc), sign_cos);
+
+    __mmask16 big = _mm512_cmp_ps_mask(ax, _mm512_set1_ps(PICO_SINCOS_AVX512_MAX), _CMP_NLE_UQ);
+    if(__builtin_expect(big != 0, 0)) {
+        float xs[16], ss[16], cs[16];
+        _mm512_storeu_ps(xs, x);
+        _mm512_storeu_ps(ss, *s);
+        _mm512_storeu_ps(cs, *c);
+        for(int k = 0; k < 16; k++) {
+            if(big & (1 << k)) {
+                ss[k] = sinf(xs[k]);
+                cs[k] = cosf(xs[k]);
+            }
+        }
+        *s = _mm512_loadu_ps(ss);
+        *c = _mm512_loadu_ps(cs);
+    }
+}
+
+__attribute__((target("avx512f"))) static inline __m512 pico_sin_avx512_ps(__m512 x) {
+    __m512 s, c;
+    pico_sincos_avx512_ps(x, &s, &c);
+    return s;
+}
+
+__attribute__((target("avx512f"))) static inline __m512 pico_cos_avx512_ps(__m512 x) {
+    __m512 s, c;
+    pico_sincos_avx512_ps(x, &s, &c);
+    return c;
+}
+
+__attribute__((target("avx512f"))) static inline __m512 pico_tan_avx512_ps(__m512 x) {
+    __m512 s, c;
+    pico_sincos_avx512_ps(x, &s, &c);
+    return _mm512_div_ps(s, c);
+}
+
+// tanh, see pico_tanh_avx2_ps
+__attribute__((target("avx512f"))) static inline __m512 pico_tanh_avx512_ps(__m512 x) {
+    const __m512 one = _mm512_set1_ps(1.0f);
+    __m512 ax = pico_avx512_abs_ps(x);
+
+    __m512 z = _mm512_mul_ps(x, x);
+    __m512 p = _mm512_set1_ps(-5.70498872745e-3f);
+    p = _mm512_fmadd_ps(p, z, _mm512_set1_ps(2.06390887954e-2f));
+    p = _mm512_fmadd_ps(p, z, _mm512_set1_ps(-5.37397155531e-2f));
+    p = _mm512_fmadd_ps(p, z, _mm512_set1_ps(1.33314422036e-1f));
+    p = _mm512_fmadd_ps(p, z, _mm512_set1_ps(-3.33332819422e-1f));
+    p = _mm512_fmadd_ps(_mm512_mul_ps(p, z), x, x);
+
+    __m512 e = pico_exp_avx512_ps(_mm512_add_ps(ax, ax));
+    __m512 big = _mm512_sub_ps(one, _mm512_div_ps(_mm512_set1_ps(2.0f), _mm512_add_ps(e, one)));
+    big = _mm512_castsi512_ps(_mm512_or_si512(_mm512_castps_si512(big),
+                                              _mm512_castps_si512(pico_avx512_sign_ps(x))));
+
+    return _mm512_mask_blend_ps(_mm512_cmp_ps_mask(ax, _mm512_set1_ps(0.625f), _CMP_LT_OQ), big,
+                                p);
+}
+
+__attribute__((target("avx512f"))) static inline __m512 pico_sqrt_avx512_ps(__m512 x) {
+    return _mm512_sqrt_ps(x);
+}
+
+// 16-wide element-wise kernel. the tail is one masked load/store through the same
+// vector function (masked-off lanes load 0.0f and are never written back).
+#define PICO_DEFINE_UNARY_OP_AVX512_FP32(name, simd_fn)                             \
+    __attribute__((target("avx512f"))) static inline void name##_cpu_avx512_fp32(   \
+        struct PicoTensor* a, struct PicoTensor* out) {                             \
+        int64_t i = 0;                                                              \
+        int64_t size = out->numel;                                                  \
+        for(; i + 16 <= size; i += 16) {                                            \
+            _mm512_storeu_ps(&out->data[i], simd_fn(_mm512_loadu_ps(&a->data[i]))); \
+        }                                                                           \
+        if(i < size) {                                                              \
+            __mmask16 m = (__mmask16)((1u << (size - i)) - 1u);                     \
+            __m512 v = simd_fn(_mm512_maskz_loadu_ps(m, &a->data[i]));              \
+            _mm512_mask_storeu_ps(&out->data[i], m, v);                             \
+        }                                                                           \
+    }
+
+PICO_DEFINE_UNARY_OP_AVX512_FP32(pico_exp, pico_exp_avx512_ps);
+PICO_DEFINE_UNARY_OP_AVX512_FP32(pico_log, pico_log_avx512_ps);
+PICO_DEFINE_UNARY_OP_AVX512_FP32(pico_sin, pico_sin_avx512_ps);
+PICO_DEFINE_UNARY_OP_AVX512_FP32(pico_cos, pico_cos_avx512_ps);
+PICO_DEFINE_UNARY_OP_AVX512_FP32(pico_tan, pico_tan_avx512_ps);
+PICO_DEFINE_UNARY_OP_AVX512_FP32(pico_tanh, pico_tanh_avx512_ps);
+PICO_DEFINE_UNARY_OP_AVX512_FP32(pico_sqrt, pico_sqrt_avx512_ps);
+
+// activation slice kernels, see PICO_DEFINE_ACT_AVX2_FP32
+#define PICO_DEFINE_ACT_AVX512_FP32(name, fwd_ps, deriv_ps)                                  \
+    __attribute__((target("avx512f"))) static inline void name##_fwd_avx512_fp32(            \
+        const float* x, float* y, int64_t n) {                                               \
+        int64_t i = 0;                                                                       \
+        for(; i + 16 <= n; i += 16) {                                                        \
+            _mm512_storeu_ps(&y[i], fwd_ps(_mm512_loadu_ps(&x[i])));                         \
+        }                                                                                    \
+        if(i < n) {                                                                          \
+            __mmask16 m = (__mmask16)((1u << (n - i)) - 1u);                                 \
+            _mm512_mask_storeu_ps(&y[i], m, fwd_ps(_mm512_maskz_loadu_ps(m, &x[i])));        \
+        }                                                                                    \
+    }                                                                                        \
+    __attribute__((target("avx512f"))) static inline void name##_bwd_avx512_fp32(            \
+        const float* y, const float* dy, float* dx, int64_t n) {                             \
+        int64_t i = 0;                                                                       \
+        for(; i + 16 <= n; i += 16) {                                                        \
+            __m512 d = deriv_ps(_mm512_loadu_ps(&y[i]));                                     \
+            __m512 g = _mm512_fmadd_ps(_mm512_loadu_ps(&dy[i]), d, _mm512_loadu_ps(&dx[i])); \
+            _mm512_storeu_ps(&dx[i], g);                                                     \
+        }                                                                                    \
+        if(i < n) {                                                                          \
+            __mmask16 m = (__mmask16)((1u << (n - i)) - 1u);                                 \
+            __m512 d = deriv_ps(_mm512_maskz_loadu_ps(m, &y[i]));                            \
+            __m512 g = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m, &dy[i]), d,                  \
+                                       _mm512_maskz_loadu_ps(m, &dx[i]));                    \
+            _mm512_mask_storeu_ps(&dx[i], m, g);                                             \
+        }                                                                                    \
+    }
+
+__attribute__((target("avx512f"))) static inline __m512 pico_relu_avx512_ps(__m512 x) {
+    return _mm512_max_ps(x, _mm512_setzero_ps());
+}
+
+__attribute__((target("avx512f"))) static inline __m512 pico_relu_deriv_avx512_ps(__m512 y) {
+    __mmask16 pos = _mm512_cmp_ps_mask(y, _mm512_setzero_ps(), _CMP_GT_OQ);
+    return _mm512_maskz_mov_ps(pos, _mm512_set1_ps(1.0f));
+}
+
+__attribute__((target("avx512f"))) static inline __m512 pico_sigmoid_avx512_ps(__m512 x) {
+    __m512 one = _mm512_set1_ps(1.0f);
+    __m512 e = pico_exp_avx512_ps(_mm512_sub_ps(_mm512_setzero_ps(), x));
+    return _mm512_div_ps(one, _mm512_add_ps(one, e));
+}
+
+__attribute__((target("avx512f"))) static inline __m512 pico_sigmoid_deriv_avx512_ps(__m512 y) {
+    return _mm512_mul_ps(y, _mm512_sub_ps(_mm512_set1_ps(1.0f), y));
+}
+
+__attribute__((target("avx512f"))) static inline __m512 pico_tanh_deriv_avx512_ps(__m512 y) {
+    return _mm512_fnmadd_ps(y, y, _mm512_set1_ps(1.0f));
+}
+
+PICO_DEFINE_ACT_AVX512_FP32(pico_relu, pico_relu_avx512_ps, pico_relu_deriv_avx512_ps);
+PICO_DEFINE_ACT_AVX512_FP32(pico_sigmoid, pico_sigmoid_avx512_ps, pico_sigmoid_deriv_avx512_ps);
+PICO_DEFINE_ACT_AVX512_FP32(pico_tanh, pico_tanh_avx512_ps, pico_tanh_deriv_avx512_ps);
+
+// reductions: sum + max rows/cols, see the AVX2 versions. argmax stays on AVX2
+__attribute__((target("avx512f"))) static inline float pico_sum_row_avx512(const float* x,
+                                                                          int64_t n) {
+    if(n > PICO_REDUCE_PAIRWISE_BLOCK) {
+        int64_t half = (n / 2) & ~(int64_t)63;
+        return pico_sum_row_avx512(x, half) + pico_sum_row_avx512(x + half, n - half);
+    }
+    __m512 a0 = _mm512_setzero_ps(), a1 = _mm512_setzero_ps();
+    __m512 a2 = _mm512_setzero_ps(), a3 = _mm512_setzero_ps();
+    int64_t i = 0;
+    for(; i + 64 <= n; i += 64) {
+        a0 = _mm512_add_ps(a0, _mm512_loadu_ps(&x[i]));
+        a1 = _mm512_add_ps(a1, _mm512_loadu_ps(&x[i + 16]));
+        a2 = _mm512_add_ps(a2, _mm512_loadu_ps(&x[i + 32]));
+        a3 = _mm512_add_ps(a3, _mm512_loadu_ps(&x[i + 48]));
+    }
+    for(; i < n; i += 16) {
+        __mmask16 m = pico_avx512_tail_mask(n - i);
+        a0 = _mm512_add_ps(a0, _mm512_maskz_loadu_ps(m, &x[i]));
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(_mm512_add_ps(a0, a1), _mm512_add_ps(a2, a3)));
+}
+
+__attribute__((target("avx512f"))) static inline float pico_max_row_avx512(const float* x,
+                                                                          int64_t n) {
+    const __m512 ninf = _mm512_set1_ps(-INFINITY);
+    __m512 m0 = ninf;
+    __mmask16 nan = 0;
+    for(int64_t i = 0; i < n; i += 16) {
+        __mmask16 m = pico_avx512_tail_mask(n - i);
+        __m512 v = _mm512_mask_loadu_ps(ninf, m, &x[i]);
+        m0 = _mm512_max_ps(m0, v);
+        nan |= _mm512_cmp_ps_mask(v, v, _CMP_UNORD_Q);
+    }
+    if(nan != 0) {
+        for(int64_t k = 0; k < n; k++) {
+            if(isnan(x[k])) return x[k];
+        }
+    }
+    return _mm512_reduce_max_ps(m0);
+}
+
+// same row-sweep layout as the AVX2 col kernels (see cpu_avx_2.h)
+__attribute__((target("avx512f"))) static inline void pico_sum_cols_avx512(const float* x, float* y,
+                                                                          int64_t R, int64_t ld,
+                                                                          int64_t ncols) {
+    float s[PICO_REDUCE_COL_TILE] __attribute__((aligned(64)));
+    float c[PICO_REDUCE_COL_TILE] __attribute__((aligned(64)));
+    for(int64_t j = 0; j < ncols; j += 16) {
+        _mm512_store_ps(&s[j], _mm512_setzero_ps());
+        _mm512_store_ps(&c[j], _mm512_setzero_ps());
+    }
+    for(int64_t r = 0; r < R; r++) {
+        const float* row = x + r * ld;
+        for(int64_t j = 0; j < ncols; j += 16) {
+            __m512 sj = _mm512_load_ps(&s[j]);
+            __m512 xj = _mm512_maskz_loadu_ps(pico_avx512_tail_mask(ncols - j), &row[j]);
+            __m512 v = _mm512_sub_ps(xj, _mm512_load_ps(&c[j]));
+            __m512 t = _mm512_add_ps(sj, v);
+            _mm512_store_ps(&c[j], _mm512_sub_ps(_mm512_sub_ps(t, sj), v));
+            _mm512_store_ps(&s[j], t);
+        }
+    }
+    memcpy(y, s, sizeof(float) * ncols);
+}
+
+__attribute__((target("avx512f"))) static inline void pico_max_cols_avx512(const float* x, float* y,
+                                                                          int64_t R, int64_t ld,
+                                                                          int64_t ncols) {
+    float m[PICO_REDUCE_COL_TILE] __attribute__((aligned(64)));
+    __mmask16 nan[PICO_REDUCE_COL_TILE / 16];
+    for(int64_t j = 0; j < ncols; j += 16) {
+        __m512 v = _mm512_maskz_loadu_ps(pico_avx512_tail_mask(ncols - j), &x[j]);
+        _mm512_store_ps(&m[j], v);
+        nan[j / 16] = _mm512_cmp_ps_mask(v, v, _CMP_UNORD_Q);
+    }
+    for(int64_t r = 1; r < R; r++) {
+        const float* row = x + r * ld;
+        for(int64_t j = 0; j < ncols; j += 16) {
+            __m512 v = _mm512_maskz_loadu_ps(pico_avx512_tail_mask(ncols - j), &row[j]);
+            _mm512_store_ps(&m[j], _mm512_max_ps(_mm512_load_ps(&m[j]), v));
+            nan[j / 16] |= _mm512_cmp_ps_mask(v, v, _CMP_UNORD_Q);
+        }
+    }
+    for(int64_t j = 0; j < ncols; j += 16) {
+        __m512 out = _mm512_mask_blend_ps(nan[j / 16], _mm512_load_ps(&m[j]), _mm512_set1_ps(NAN));
+        _mm512_mask_storeu_ps(&y[j], pico_avx512_tail_mask(ncols - j), out);
+    }
+}
+
+// softmax rows, same scheme as the AVX2 versions (4 vectors per logsumexp rescale)
+__attribute__((target("avx512f"))) static inline float pico_logsumexp_row_avx512(const float* x,
+                                                                                int64_t n) {
+    __m512 m = _mm512_set1_ps(-FLT_MAX);
+    __m512 s = _mm512_setzero_ps();
+    int64_t i = 0;
+    for(; i + 64 <= n; i += 64) {
+        __m512 v0 = _mm512_loadu_ps(&x[i]), v1 = _mm512_loadu_ps(&x[i + 16]);
+        __m512 v2 = _mm512_loadu_ps(&x[i + 32]), v3 = _mm512_loadu_ps(&x[i + 48]);
+        __m512 mn = _mm512_max_ps(_mm512_max_ps(m, _mm512_max_ps(v0, v1)), _mm512_max_ps(v2, v3));
+        __m512 e = _mm512_add_ps(pico_exp_avx512_ps(_mm512_sub_ps(v0, mn)),
+                                 pico_exp_avx512_ps(_mm512_sub_ps(v1, mn)));
+        e = _mm512_add_ps(e, pico_exp_avx512_ps(_mm512_sub_ps(v2, mn)));
+        e = _mm512_add_ps(e, pico_exp_avx512_ps(_mm512_sub_ps(v3, mn)));
+        s = _mm512_fmadd_ps(s, pico_exp_avx512_ps(_mm512_sub_ps(m, mn)), e);
+        m = mn;
+    }
+    for(; i < n; i += 16) {
+        __m512 v = _mm512_mask_loadu_ps(_mm512_set1_ps(-INFINITY), pico_avx512_tail_mask(n - i),
+                                        &x[i]);
+        __m512 mn = _mm512_max_ps(m, v);
+        s = _mm512_fmadd_ps(s, pico_exp_avx512_ps(_mm512_sub_ps(m, mn)),
+                            pico_exp_avx512_ps(_mm512_sub_ps(v, mn)));
+        m = mn;
+    }
+    float M = _mm512_reduce_max_ps(m);
+    __m512 rescale = pico_exp_avx512_ps(_mm512_sub_ps(m, _mm512_set1_ps(M)));
+    return M + logf(_mm512_reduce_add_ps(_mm512_mul_ps(s, rescale)));
+}
+
+__attribute__((target("avx512f"))) static inline void pico_softmax_accum_row_avx512(
+    const float* x, float lse, float scale, float* y, int64_t n) {
+    const __m512 vl = _mm512_set1_ps(lse);
+    const __m512 vs = _mm512_set1_ps(scale);
+    for(int64_t i = 0; i < n; i += 16) {
+        __mmask16 k = pico_avx512_tail_mask(n - i);
+        __m512 e = pico_exp_avx512_ps(_mm512_sub_ps(_mm512_maskz_loadu_ps(k, &x[i]), vl));
+        _mm512_mask_storeu_ps(&y[i], k, _mm512_fmadd_ps(vs, e, _mm512_maskz_loadu_ps(k, &y[i])));
+    }
+}
+
+__attribute__((target("avx512f"))) static inline void pico_softmax_bwd_row_avx512(
+    const float* y, const float* dy, float* dx, int64_t n) {
+    __m512 acc = _mm512_setzero_ps();
+    for(int64_t i = 0; i < n; i += 16) {
+        __mmask16 k = pico_avx512_tail_mask(n - i);
+        acc = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(k, &dy[i]), _mm512_maskz_loadu_ps(k, &y[i]),
+                              acc);
+    }
+    const __m512 dot = _mm512_set1_ps(_mm512_reduce_add_ps(acc));
+    for(int64_t i = 0; i < n; i += 16) {
+        __mmask16 k = pico_avx512_tail_mask(n - i);
+        __m512 g = _mm512_sub_ps(_mm512_maskz_loadu_ps(k, &dy[i]), dot);
+        __m512 r = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(k, &y[i]), g,
+                                   _mm512_maskz_loadu_ps(k, &dx[i]));
+        _mm512_mask_storeu_ps(&dx[i], k, r);
+    }
+}
+
+// mse, see the AVX2 versions
+__attribute__((target("avx512f"))) static inline float pico_sq_diff_sum_row_avx512(
+    const float* a, const float* b, int64_t n) {
+    if(n > PICO_REDUCE_PAIRWISE_BLOCK) {
+        int64_t half = (n / 2) & ~(int64_t)63;
+        return pico_sq_diff_sum_row_avx512(a, b, half) +
+               pico_sq_diff_sum_row_avx512(a + half, b + half, n - half);
+    }
+    __m512 a0 = _mm512_setzero_ps(), a1 = _mm512_setzero_ps();
+    __m512 a2 = _mm512_setzero_ps(), a3 = _mm512_setzero_ps();
+    int64_t i = 0;
+    for(; i + 64 <= n; i += 64) {
+        __m512 d0 = _mm512_sub_ps(_mm512_loadu_ps(&a[i]), _mm512_loadu_ps(&b[i]));
+        __m512 d1 = _mm512_sub_ps(_mm512_loadu_ps(&a[i + 16]), _mm512_loadu_ps(&b[i + 16]));
+        __m512 d2 = _mm512_sub_ps(_mm512_loadu_ps(&a[i + 32]), _mm512_loadu_ps(&b[i + 32]));
+        __m512 d3 = _mm512_sub_ps(_mm512_loadu_ps(&a[i + 48]), _mm512_loadu_ps(&b[i + 48]));
+        a0 = _mm512_fmadd_ps(d0, d0, a0);
+        a1 = _mm512_fmadd_ps(d1, d1, a1);
+        a2 = _mm512_fmadd_ps(d2, d2, a2);
+        a3 = _mm512_fmadd_ps(d3, d3, a3);
+    }
+    for(; i < n; i += 16) {
+        __mmask16 k = pico_avx512_tail_mask(n - i);
+        __m512 d = _mm512_sub_ps(_mm512_maskz_loadu_ps(k, &a[i]), _mm512_maskz_loadu_ps(k, &b[i]));
+        a0 = _mm512_fmadd_ps(d, d, a0);
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(_mm512_add_ps(a0, a1), _mm512_add_ps(a2, a3)));
+}
+
+__attribute__((target("avx512f"))) static inline void pico_sq_diff_avx512(const float* a,
+                                                                          const float* b, float* y,
+                                                                          int64_t n) {
+    for(int64_t i = 0; i < n; i += 16) {
+        __mmask16 k = pico_avx512_tail_mask(n - i);
+        __m512 d = _mm512_sub_ps(_mm512_maskz_loadu_ps(k, &a[i]), _mm512_maskz_loadu_ps(k, &b[i]));
+        _mm512_mask_storeu_ps(&y[i], k, _mm512_mul_ps(d, d));
+    }
+}
+
+__attribute__((target("avx512f"))) static inline void pico_mse_bwd_avx512(
+    const float* a, const float* b, const float* dy, float scale, float* da, float* db,
+    int64_t n) {
+    const __m512 vs = _mm512_set1_ps(scale);
+    for(int64_t i = 0; i < n; i += 16) {
+        __mmask16 k = pico_avx512_tail_mask(n - i);
+        __m512 d = _mm512_sub_ps(_mm512_maskz_loadu_ps(k, &a[i]), _mm512_maskz_loadu_ps(k, &b[i]));
+        __m512 g = dy ? _mm512_mul_ps(vs, _mm512_maskz_loadu_ps(k, &dy[i])) : vs;
+        d = _mm512_mul_ps(g, d);
+        if(da) _mm512_mask_storeu_ps(&da[i], k, _mm512_add_ps(_mm512_maskz_loadu_ps(k, &da[i]), d));
+        if(db) _mm512_mask_storeu_ps(&db[i], k, _mm512_sub_ps(_mm512_maskz_loadu_ps(k, &db[i]), d));
+    }
+}
+
+// optimizer steps, see the AVX2 versions
+#define PICO_OPTIM_AVX512_LOAD(ptr) _mm512_maskz_loadu_ps(k, (ptr) + i)
+#define PICO_OPTIM_AVX512_STORE(ptr, val) _mm512_mask_storeu_ps((ptr) + i, k, (val))
+#define PICO_OPTIM_AVX512_GRAD() pico_optim_take_grad_avx512(g + i, k, h)
+
+__attribute__((target("avx512f"))) static inline __m512 pico_optim_take_grad_avx512(
+    float* g, __mmask16 k, const struct PicoOptimStep* h) {
+    __m512 gv = _mm512_maskz_loadu_ps(k, g);
+    if(h->zero_grad) _mm512_mask_storeu_ps(g, k, _mm512_setzero_ps());
+    return _mm512_mul_ps(_mm512_set1_ps(h->grad_scale), gv);
+}
+
+__attribute__((target("avx512f"))) static inline void pico_sgd_step_avx512(
+    float* p, float* g, int64_t n, const struct PicoOptimStep* h) {
+    const __m512 lr = _mm512_set1_ps(h->lr);
+    for(int64_t i = 0; i < n; i += 16) {
+        __mmask16 k = pico_avx512_tail_mask(n - i);
+        __m512 pv = _mm512_fnmadd_ps(lr, PICO_OPTIM_AVX512_GRAD(), PICO_OPTIM_AVX512_LOAD(p));
+        PICO_OPTIM_AVX512_STORE(p, pv);
+    }
+}
+
+__attribute__((target("avx512f"))) static inline void pico_nag_step_avx512(
+    float* p, float* g, float* buf, int64_t n, const struct PicoOptimStep* h) {
+    const __m512 mu = _mm512_set1_ps(h->momentum), lr = _mm512_set1_ps(h->lr);
+    const __m512 wd = _mm512_set1_ps(h->wd_l2);
+    for(int64_t i = 0; i < n; i += 16) {
+        __mmask16 k = pico_avx512_tail_mask(n - i);
+        __m512 pv = PICO_OPTIM_AVX512_LOAD(p);
+        __m512 gv = _mm512_fmadd_ps(wd, pv, PICO_OPTIM_AVX512_GRAD());
+        __m512 b = _mm512_fmadd_ps(mu, PICO_OPTIM_AVX512_LOAD(buf), gv);
+        PICO_OPTIM_AVX512_STORE(buf, b);
+        PICO_OPTIM_AVX512_STORE(p, _mm512_fnmadd_ps(lr, _mm512_fmadd_ps(mu, b, gv), pv));
+    }
+}
+
+__attribute__((target("avx512f"))) static inline void pico_adagrad_step_avx512(
+    float* p, float* g, float* s, int64_t n, const struct PicoOptimStep* h) {
+    const __m512 lr = _mm512_set1_ps(h->lr), eps = _mm512_set1_ps(h->eps);
+    const __m512 wd = _mm512_set1_ps(h->wd_l2);
+    for(int64_t i = 0; i < n; i += 16) {
+        __mmask16 k = pico_avx512_tail_mask(n - i);
+        __m512 pv = PICO_OPTIM_AVX512_LOAD(p);
+        __m512 gv = _mm512_fmadd_ps(wd, pv, PICO_OPTIM_AVX512_GRAD());
+        __m512 sv = _mm512_fmadd_ps(gv, gv, PICO_OPTIM_AVX512_LOAD(s));
+        PICO_OPTIM_AVX512_STORE(s, sv);
+        __m512 upd = _mm512_div_ps(_mm512_mul_ps(lr, gv), _mm512_add_ps(_mm512_sqrt_ps(sv), eps));
+        PICO_OPTIM_AVX512_STORE(p, _mm512_sub_ps(pv, upd));
+    }
+}
+
+__attribute__((target("avx512f"))) static inline void pico_rmsprop_step_avx512(
+    float* p, float* g, float* s, int64_t n, const struct PicoOptimStep* h) {
+    const __m512 lr = _mm512_set1_ps(h->lr), eps = _mm512_set1_ps(h->eps);
+    const __m512 wd = _mm512_set1_ps(h->wd_l2);
+    const __m512 a = _mm512_set1_ps(h->alpha), a1 = _mm512_set1_ps(1.0f - h->alpha);
+    for(int64_t i = 0; i < n; i += 16) {
+        __mmask16 k = pico_avx512_tail_mask(n - i);
+        __m512 pv = PICO_OPTIM_AVX512_LOAD(p);
+        __m512 gv = _mm512_fmadd_ps(wd, pv, PICO_OPTIM_AVX512_GRAD());
+        __m512 sv = _mm512_fmadd_ps(a, PICO_OPTIM_AVX512_LOAD(s),
+                                    _mm512_mul_ps(a1, _mm512_mul_ps(gv, gv)));
+        PICO_OPTIM_AVX512_STORE(s, sv);
+        __m512 upd = _mm512_div_ps(_mm512_mul_ps(lr, gv), _mm512_add_ps(_mm512_sqrt_ps(sv), eps));
+        PICO_OPTIM_AVX512_STORE(p, _mm512_sub_ps(pv, upd));
+    }
+}
+
+__attribute__((target("avx512f"))) static inline void pico_adam_step_avx512(
+    float* p, float* g, float* m, float* v, int64_t n, const struct PicoOptimStep* h) {
+    const __m512 b1 = _mm512_set1_ps(h->beta1), b1c = _mm512_set1_ps(1.0f - h->beta1);
+    const __m512 b2 = _mm512_set1_ps(h->beta2), b2c = _mm512_set1_ps(1.0f - h->beta2);
+    const __m512 wd = _mm512_set1_ps(h->wd_l2), decay = _mm512_set1_ps(h->decay);
+    const __m512 step = _mm512_set1_ps(h->step_scale), vs = _mm512_set1_ps(h->v_scale);
+    const __m512 eps = _mm512_set1_ps(h->eps);
+    for(int64_t i = 0; i < n; i += 16) {
+        __mmask16 k = pico_avx512_tail_mask(n - i);
+        __m512 pv = PICO_OPTIM_AVX512_LOAD(p);
+        __m512 gv = _mm512_fmadd_ps(wd, pv, PICO_OPTIM_AVX512_GRAD());
+        __m512 mv = _mm512_fmadd_ps(b1, PICO_OPTIM_AVX512_LOAD(m), _mm512_mul_ps(b1c, gv));
+        __m512 vv = _mm512_fmadd_ps(b2, PICO_OPTIM_AVX512_LOAD(v),
+                                    _mm512_mul_ps(b2c, _mm512_mul_ps(gv, gv)));
+        PICO_OPTIM_AVX512_STORE(m, mv);
+        PICO_OPTIM_AVX512_STORE(v, vv);
+        __m512 denom = _mm512_fmadd_ps(_mm512_sqrt_ps(vv), vs, eps);
+        __m512 upd = _mm512_div_ps(_mm512_mul_ps(step, mv), denom);
+        PICO_OPTIM_AVX512_STORE(p, _mm512_fmsub_ps(decay, pv, upd));
+    }
+}
+
+#undef PICO_OPTIM_AVX512_LOAD
+#undef PICO_OPTIM_AVX512_STORE
+#undef PICO_OPTIM_AVX512_GRAD
+
+// ---- dtype conversion -----------------------------------------------------------
+// same scheme as cpu_avx_2.h. vcvtph2ps/vcvtps2ph have 512-bit forms in AVX-512F, and
+// vpmovdw does the 32 -> 16 bit narrowing in one instruction.
+
+__attribute__((target("avx512f"))) static inline void pico_cvt_f16_to_f32_avx512(
+    const uint16_t* src, float* dst, int64_t n) {
+    int64_t i = 0;
+    for(; i + 16 <= n; i += 16) {
+        __m256i h = _mm256_loadu_si256((const __m256i*)(src + i));
+        _mm512_storeu_ps(dst + i, _mm512_cvtph_ps(h));
+    }
+    pico_cvt_f16_to_f32_scalar(src + i, dst + i, n - i);
+}
+
+__attribute__((target("avx512f"))) static inline void pico_cvt_f32_to_f16_avx512(
+    const float* src, uint16_t* dst, int64_t n) {
+    int64_t i = 0;
+    for(; i + 16 <= n; i += 16) {
+        __m256i h = _mm512_cvtps_ph(_mm512_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm256_storeu_si256((__m256i*)(dst + i), h);
+    }
+    pico_cvt_f32_to_f16_scalar(src + i, dst + i, n - i);
+}
+
+__attribute__((target("avx512f"))) static inline __m512 pico_avx512_bf16_load(
+    const uint16_t* src) {
+    __m512i w = _mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i*)src));
+    return _mm512_castsi512_ps(_mm512_slli_epi32(w, 16));
+}
+
+__attribute__((target("avx512f"))) static inline void pico_cvt_bf16_to_f32_avx512(
+    const uint16_t* src, float* dst, int64_t n) {
+    int64_t i = 0;
+    for(; i + 16 <= n; i += 16) _mm512_storeu_ps(dst + i, pico_avx512_bf16_load(src + i));
+    pico_cvt_bf16_to_f32_scalar(src + i, dst + i, n - i);
+}
+
+__attribute__((target("avx512f"))) static inline void pico_cvt_f32_to_bf16_avx512(
+    const float* src, uint16_t* dst, int64_t n) {
+    const __m512i bias = _mm512_set1_epi32(0x7fff), one = _mm512_set1_epi32(1);
+    const __m512i abs_mask = _mm512_set1_epi32(0x7fffffff), inf = _mm512_set1_epi32(0x7f800000);
+    const __m512i quiet = _mm512_set1_epi32(0x400000);
+    int64_t i = 0;
+    for(; i + 16 <= n; i += 16) {
+        __m512i u = _mm512_loadu_si512((const void*)(src + i));
+        __m512i lsb = _mm512_and_si512(_mm512_srli_epi32(u, 16), one);
+        __m512i r = _mm512_add_epi32(u, _mm512_add_epi32(bias, lsb));
+        __mmask16 nan = _mm512_cmpgt_epi32_mask(_mm512_and_si512(u, abs_mask), inf);
+        r = _mm512_mask_or_epi32(r, nan, u, quiet);
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm512_cvtepi32_epi16(_mm512_srli_epi32(r, 16)));
+    }
+    pico_cvt_f32_to_bf16_scalar(src + i, dst + i, n - i);
+}
+
+// ---- int8 GEMM --------------------------------------------------------------------
+// see cpu_scalar.h. needs AVX-512BW + VNNI on top of F (the dispatcher checks; without
+// them the AVX2 kernel runs). vpdpbusd sums 4 unsigned x signed byte products straight
+// into int32 with no int16 stage to saturate, so x is offset into unsigned instead of
+// the AVX2 sign trick: (x + 128) . w = x . w + 128 * sum(w), and the packed column sums
+// in w_sum take the 128 * sum(w) back out. one instruction per x/W vector pair.
+
+#define PICO_QGEMM_VNNI_TARGET "avx512f,avx512bw,avx512vnni"
+
+__attribute__((target(PICO_QGEMM_VNNI_TARGET))) static inline void pico_qgemm_tile_avx512(
+    const int8_t* x, const int8_t* w, const int32_t* w_sum, int64_t kp, int32_t* acc) {
+    const __m512i offset = _mm512_set1_epi8((char)0x80);
+    __m512i c00 = _mm512_setzero_si512(), c01 = c00, c02 = c00, c03 = c00;
+    __m512i c10 = c00, c11 = c00, c12 = c00, c13 = c00;
+    for(int64_t k = 0; k < kp; k += 64) {
+        // x ^ 0x80 == x + 128 read as unsigned
+        __m512i u0 = _mm512_xor_si512(_mm512_loadu_si512((const void*)(x + k)), offset);
+        __m512i u1 = _mm512_xor_si512(_mm512_loadu_si512((const void*)(x + kp + k)), offset);
+        __m512i w0 = _mm512_loadu_si512((const void*)(w + k));
+        __m512i w1 = _mm512_loadu_si512((const void*)(w + kp + k));
+        __m512i w2 = _mm512_loadu_si512((const void*)(w + 2 * kp + k));
+        __m512i w3 = _mm512_loadu_si512((const void*)(w + 3 * kp + k));
+        c00 = _mm512_dpbusd_epi32(c00, u0, w0);
+        c01 = _mm512_dpbusd_epi32(c01, u0, w1);
+        c02 = _mm512_dpbusd_epi32(c02, u0, w2);
+        c03 = _mm512_dpbusd_epi32(c03, u0, w3);
+        c10 = _mm512_dpbusd_epi32(c10, u1, w0);
+        c11 = _mm512_dpbusd_epi32(c11, u1, w1);
+        c12 = _mm512_dpbusd_epi32(c12, u1, w2);
+        c13 = _mm512_dpbusd_epi32(c13, u1, w3);
+    }
+    __m512i sums[PICO_QGEMM_MR * PICO_QGEMM_NR] = {c00, c01, c02, c03, c10, c11, c12, c13};
+    for(int t = 0; t < PICO_QGEMM_MR * PICO_QGEMM_NR; t++) {
+        acc[t] = _mm512_reduce_add_epi32(sums[t]) - 128 * w_sum[t % PICO_QGEMM_NR];
+    }
+}
+
+// ---- random numbers ---------------------------------------------------------------
+
+// pico_philox_scalar on the 16 counters of a super-block in one register per word,
+// bit-identical. vpternlogd does each round's two xors in one
+__attribute__((target("avx512f"))) static inline void pico_philox_avx512(__m512i c[4],
+                                                                        uint32_t k0, uint32_t k1) {
+    const __m512i m0 = _mm512_set1_epi32((int)PICO_PHILOX_M0);
+    const __m512i m1 = _mm512_set1_epi32((int)PICO_PHILOX_M1);
+    for(int r = 0; r < 10; r++) {
+        __m512i e0 = _mm512_mul_epu32(c[0], m0);
+        __m512i o0 = _mm512_mul_epu32(_mm512_srli_epi64(c[0], 32), m0);
+        __m512i e1 = _mm512_mul_epu32(c[2], m1);
+        __m512i o1 = _mm512_mul_epu32(_mm512_srli_epi64(c[2], 32), m1);
+        __m512i hi0 = _mm512_mask_blend_epi32(0xAAAA, _mm512_srli_epi64(e0, 32), o0);
+        __m512i hi1 = _mm512_mask_blend_epi32(0xAAAA, _mm512_srli_epi64(e1, 32), o1);
+        c[0] = _mm512_ternarylogic_epi32(hi1, c[1], _mm512_set1_epi32((int)k0), 0x96);
+        c[2] = _mm512_ternarylogic_epi32(hi0, c[3], _mm512_set1_epi32((int)k1), 0x96);
+        c[1] = _mm512_mask_blend_epi32(0xAAAA, e1, _mm512_slli_epi64(o1, 32));
+        c[3] = _mm512_mask_blend_epi32(0xAAAA, e0, _mm512_slli_epi64(o0, 32));
+        k0 += PICO_PHILOX_W0;
+        k1 += PICO_PHILOX_W1;
+    }
+}
+
+__attribute__((target("avx512f"))) static inline void pico_rng_words_avx512(uint64_t seed,
+                                                                           uint64_t stream,
+                                                                           uint64_t block,
+                                                                           __m512i c[4]) {
+    c[0] = _mm512_add_epi32(_mm512_set1_epi32((int)(uint32_t)block),
+                            _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13,
+                                              14, 15));
+    c[1] = _mm512_set1_epi32((int)(uint32_t)(block >> 32));
+    c[2] = _mm512_set1_epi32((int)(uint32_t)stream);
+    c[3] = _mm512_set1_epi32((int)(uint32_t)(stream >> 32));
+    pico_philox_avx512(c, (uint32_t)seed, (uint32_t)(seed >> 32));
+}
+
+__attribute__((target("avx512f"))) static inline __m512 pico_rng_u01_avx512(__m512i r) {
+    return _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_srli_epi32(r, 8)), _mm512_set1_ps(0x1p-24f));
+}
+
+// bit-identical to pico_rng_uniform_scalar
+__attribute__((target("avx512f"))) static inline void pico_rng_uniform_avx512(
+    uint64_t seed, uint64_t stream, uint64_t block, float lo, float span, float* out) {
+    __m512i c[4];
+    pico_rng_words_avx512(seed, stream, block, c);
+    const __m512 vlo = _mm512_set1_ps(lo), vspan = _mm512_set1_ps(span);
+    for(int k = 0; k < 4; k++) {
+        __m512 u = _mm512_mul_ps(vspan, pico_rng_u01_avx512(c[k]));
+        _mm512_storeu_ps(out + 16 * k, _mm512_add_ps(vlo, u));
+    }
+}
+
+// as pico_rng_normal_avx2, with the AVX-512 log / sincos
+__attribute__((target("avx512f"))) static inline void pico_rng_normal_avx512(uint64_t seed,
+                                                                            uint64_t stream,
+                                                                            uint64_t block,
+                                                                            float mean, float std,
+                                                                            float* out) {
+    __m512i c[4];
+    pico_rng_words_avx512(seed, stream, block, c);
+    const __m512 vmean = _mm512_set1_ps(mean), vstd = _mm512_set1_ps(std);
+    for(int p = 0; p < 4; p += 2) {
+        __m512i open = _mm512_add_epi32(_mm512_srli_epi32(c[p], 8), _mm512_set1_epi32(1));
+        __m512 ln = pico_log_avx512_ps(
+            _mm512_mul_ps(_mm512_cvtepi32_ps(open), _mm512_set1_ps(0x1p-24f)));
+        __m512 r = _mm512_sqrt_ps(
+            _mm512_max_ps(_mm512_mul_ps(_mm512_set1_ps(-2.0f), ln), _mm512_setzero_ps()));
+        __m512 theta = _mm512_mul_ps(_mm512_set1_ps(2.0f * PI_F), pico_rng_u01_avx512(c[p + 1]));
+        __m512 s, co;
+        pico_sincos_avx512_ps(theta, &s, &co);
+        _mm512_storeu_ps(out + 16 * p, _mm512_fmadd_ps(vstd, _mm512_mul_ps(r, co), vmean));
+        _mm512_storeu_ps(out + 16 * (p + 1), _mm512_fmadd_ps(vstd, _mm512_mul_ps(r, s), vmean));
+    }
+}
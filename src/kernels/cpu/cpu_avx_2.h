@@ -1,7 +1,9 @@
 #pragma once
+#include <float.h>
 #include <immintrin.h>
 #include <math.h>
 #include <stdbool.h>
+#include "kernels/cpu/cpu_scalar.h"
 #include "tensor.h"
 
 // AVX_2  element-wise add with broadcasting.
@@ -40,3 +42,1557 @@
 PICO_DEFINE_BINARY_OP_AVX2_FP32(pico_add, _mm256_add_ps, +);
 PICO_DEFINE_BINARY_OP_AVX2_FP32(pico_sub, _mm256_sub_ps, -);
 PICO_DEFINE_BINARY_OP_AVX2_FP32(pico_mul, _mm256_mul_ps, *);
+
+// ---- vector math ------------------------------------------------------------
+// 8-lane float32 transcendentals. all of them are Cephes polynomials evaluated with
+// FMA after a range reduction. max error vs the exact (double) result, measured by
+// bench/bench_unary.c (`make unary`); 0.5 ulp = correctly rounded, libm's expf is 0.5:
+//
+//   exp   1.3 ulp   x in [-87.3, 88.7]. above: +inf. below: 0 (denormal results flush)
+//   log   0.8 ulp   whole float range incl. denormals. x < 0 -> NaN, 0 -> -inf
+//   sin   1.5 ulp   |x| <= 100. up to 8192 the abs error stays <= 8e-8 but the ulp error
+//   cos   1.5 ulp   grows next to the zeros (float reduction). past 8192: libm sinf/cosf
+//   tan   3.5 ulp   |x| <= 100, sin/cos from one shared reduction
+//   tanh  1.4 ulp   (libm's tanhf measures 2.1)
+//   sqrt  0.5 ulp   _mm256_sqrt_ps is correctly rounded
+//
+// NaN in -> NaN out for every function.
+
+// lanes [0, n) set, the rest clear. used for the masked load/store of a < 8 tail
+__attribute__((target("avx2"))) static inline __m256i pico_avx2_tail_mask(int64_t n) {
+    return _mm256_cmpgt_epi32(_mm256_set1_epi32((int)n),
+                              _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+// e^x: split x = n*ln2 + r with |r| <= ln2/2, evaluate a degree-5 polynomial for e^r,
+// then scale by 2^n built directly in the exponent bits. 2^n is applied as two halves
+// so n = 128 (x just under the overflow threshold) doesn't land on the inf exponent.
+__attribute__((target("avx2,fma"))) static inline __m256 pico_exp_avx2_ps(__m256 x) {
+    const __m256 hi = _mm256_set1_ps(88.7228391117f);
+    const __m256 lo = _mm256_set1_ps(-87.3365447504f);
+    __m256 xc = _mm256_max_ps(_mm256_min_ps(x, hi), lo);
+
+    // n = round(x / ln2)
+    __m256 n = _mm256_round_ps(_mm256_mul_ps(xc, _mm256_set1_ps(1.44269504088896341f)),
+                               _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+
+    // r = x - n*ln2, ln2 split hi/lo so the subtraction stays exact
+    __m256 r = _mm256_fnmadd_ps(n, _mm256_set1_ps(0.693359375f), xc);
+    r = _mm256_fnmadd_ps(n, _mm256_set1_ps(-2.12194440e-4f), r);
+
+    __m256 p = _mm256_set1_ps(1.9875691500e-4f);
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(1.3981999507e-3f));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(8.3334519073e-3f));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(4.1665795894e-2f));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(1.6666665459e-1f));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(5.0000001201e-1f));
+    p = _mm256_fmadd_ps(p, _mm256_mul_ps(r, r), _mm256_add_ps(r, _mm256_set1_ps(1.0f)));
+
+    // 2^n = 2^(n/2) * 2^(n - n/2): (k + 127) into the exponent field for each half
+    __m256i ni = _mm256_cvtps_epi32(n);
+    __m256i n1 = _mm256_srai_epi32(ni, 1);
+    __m256i n2 = _mm256_sub_epi32(ni, n1);
+    const __m256i bias = _mm256_set1_epi32(127);
+    __m256 s1 = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(n1, bias), 23));
+    __m256 s2 = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(n2, bias), 23));
+    p = _mm256_mul_ps(_mm256_mul_ps(p, s1), s2);
+
+    p = _mm256_blendv_ps(p, _mm256_set1_ps(INFINITY), _mm256_cmp_ps(x, hi, _CMP_GT_OQ));
+    p = _mm256_blendv_ps(p, _mm256_setzero_ps(), _mm256_cmp_ps(x, lo, _CMP_LT_OQ));
+    return _mm256_blendv_ps(p, x, _mm256_cmp_ps(x, x, _CMP_UNORD_Q));
+}
+
+// ln(x): x = m * 2^e with m in [sqrt(1/2), sqrt(2)), ln(x) = e*ln2 + ln(m) and ln(m)
+// from a degree-9 polynomial in (m - 1). denormals are pre-scaled by 2^23 so the
+// exponent field extraction below always sees a normal number.
+__attribute__((target("avx2,fma"))) static inline __m256 pico_log_avx2_ps(__m256 x) {
+    const __m256 one = _mm256_set1_ps(1.0f);
+    __m256 in = x;
+
+    __m256 denorm = _mm256_cmp_ps(x, _mm256_set1_ps(1.17549435e-38f), _CMP_LT_OQ);
+    x = _mm256_blendv_ps(x, _mm256_mul_ps(x, _mm256_set1_ps(8388608.0f)), denorm);
+    __m256 e_adj = _mm256_and_ps(denorm, _mm256_set1_ps(23.0f));
+
+    __m256i bits = _mm256_castps_si256(x);
+    __m256 e = _mm256_cvtepi32_ps(
+        _mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(126)));
+    e = _mm256_sub_ps(e, e_adj);
+    // mantissa with the exponent forced to 2^-1: m in [0.5, 1)
+    __m256 m = _mm256_castsi256_ps(_mm256_or_si256(
+        _mm256_and_si256(bits, _mm256_set1_epi32(0x007fffff)), _mm256_set1_epi32(0x3f000000)));
+
+    // m < sqrt(1/2): use 2m - 1 and borrow one from the exponent
+    __m256 small = _mm256_cmp_ps(m, _mm256_set1_ps(0.707106781186547524f), _CMP_LT_OQ);
+    e = _mm256_sub_ps(e, _mm256_and_ps(small, one));
+    m = _mm256_sub_ps(_mm256_add_ps(m, _mm256_and_ps(small, m)), one);
+
+    __m256 z = _mm256_mul_ps(m, m);
+    __m256 y = _mm256_set1_ps(7.0376836292e-2f);
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(-1.1514610310e-1f));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(1.1676998740e-1f));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(-1.2420140846e-1f));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(1.4249322787e-1f));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(-1.6668057665e-1f));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(2.0000714765e-1f));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(-2.4999993993e-1f));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(3.3333331174e-1f));
+    y = _mm256_mul_ps(_mm256_mul_ps(y, m), z);
+
+    y = _mm256_fmadd_ps(e, _mm256_set1_ps(-2.12194440e-4f), y);
+    y = _mm256_fnmadd_ps(z, _mm256_set1_ps(0.5f), y);
+    __m256 r = _mm256_add_ps(m, y);
+    r = _mm256_fmadd_ps(e, _mm256_set1_ps(0.693359375f), r);
+
+    r = _mm256_blendv_ps(r, _mm256_set1_ps(-INFINITY),
+                         _mm256_cmp_ps(in, _mm256_setzero_ps(), _CMP_EQ_OQ));
+    r = _mm256_blendv_ps(r, in, _mm256_cmp_ps(in, _mm256_set1_ps(INFINITY), _CMP_EQ_OQ));
+    // x < 0 and NaN: NaN
+    return _mm256_blendv_ps(r, _mm256_set1_ps(NAN),
+                            _mm256_cmp_ps(in, _mm256_setzero_ps(), _CMP_NGE_UQ));
+}
+
+// sin and cos share one reduction: j = the octant of |x| (rounded up to even),
+// r = |x| - j*pi/4 in three parts (DP1+DP2+DP3 = pi/4, DP1/DP2 exact in few bits),
+// then the sin or cos polynomial on r depending on j, with signs fixed up from j.
+// past |x| = 8192 the 3-part reduction loses accuracy, so those lanes (and inf/NaN)
+// go through libm instead — rare in practice, costs nothing when no lane needs it.
+#define PICO_SINCOS_AVX2_MAX 8192.0f
+
+__attribute__((target("avx2,fma"))) static inline void pico_sincos_avx2_ps(__m256 x, __m256* s,
+                                                                         __m256* c) {
+    const __m256 sign_mask = _mm256_set1_ps(-0.0f);
+    __m256 sign_sin = _mm256_and_ps(x, sign_mask);
+    __m256 ax = _mm256_andnot_ps(sign_mask, x);
+
+    __m256i j = _mm256_cvttps_epi32(_mm256_mul_ps(ax, _mm256_set1_ps(1.27323954473516f)));
+    j = _mm256_and_si256(_mm256_add_epi32(j, _mm256_set1_epi32(1)), _mm256_set1_epi32(~1));
+    __m256 y = _mm256_cvtepi32_ps(j);
+
+    // octants 4..7 flip sin; octants 2..5 flip cos
+    __m256 swap_sin = _mm256_castsi256_ps(
+        _mm256_slli_epi32(_mm256_and_si256(j, _mm256_set1_epi32(4)), 29));
+    __m256 sign_cos = _mm256_castsi256_ps(_mm256_slli_epi32(
+        _mm256_andnot_si256(_mm256_sub_epi32(j, _mm256_set1_epi32(2)), _mm256_set1_epi32(4)),
+        29));
+    sign_sin = _mm256_xor_ps(sign_sin, swap_sin);
+    __m256 use_sin_poly = _mm256_castsi256_ps(
+        _mm256_cmpeq_epi32(_mm256_and_si256(j, _mm256_set1_epi32(2)), _mm256_setzero_si256()));
+
+    __m256 r = _mm256_fnmadd_ps(y, _mm256_set1_ps(0.78515625f), ax);
+    r = _mm256_fnmadd_ps(y, _mm256_set1_ps(2.4187564849853515625e-4f), r);
+    r = _mm256_fnmadd_ps(y, _mm256_set1_ps(3.77489497744594108e-8f), r);
+    __m256 z = _mm256_mul_ps(r, r);
+
+    __m256 pc = _mm256_set1_ps(2.443315711809948e-5f);
+    pc = _mm256_fmadd_ps(pc, z, _mm256_set1_ps(-1.388731625493765e-3f));
+    pc = _mm256_fmadd_ps(pc, z, _mm256_set1_ps(4.166664568298827e-2f));
+    pc = _mm256_mul_ps(_mm256_mul_ps(pc, z), z);
+    pc = _mm256_fnmadd_ps(z, _mm256_set1_ps(0.5f), pc);
+    pc = _mm256_add_ps(pc, _mm256_set1_ps(1.0f));
+
+    __m256 ps = _mm256_set1_ps(-1.9515295891e-4f);
+    ps = _mm256_fmadd_ps(ps, z, _mm256_set1_ps(8.3321608736e-3f));
+    ps = _mm256_fmadd_ps(ps, z, _mm256_set1_ps(-1.6666654611e-1f));
+    ps = _mm256_fmadd_ps(_mm256_mul_ps(ps, z), r, r);
+
+    *s = _mm256_xor_ps(_mm256_blendv_ps(pc, ps, use_sin_poly), sign_sin);
+    *c = _mm256_xor_ps(_mm256_blendv_ps(ps, pc, use_sin_poly), sign_cos);
+
+    // out-of-range lanes (incl. inf/NaN, which fail the ordered compare)
+    __m256 big = _mm256_cmp_ps(ax, _mm256_set1_ps(PICO_SINCOS_AVX2_MAX), _CMP_NLE_UQ);
+    if(__builtin_expect(_mm256_movemask_ps(big) != 0, 0)) {
+        float xs[8], ss[8], cs[8];
+        int mask = _mm256_movemask_ps(big);
+        _mm256_storeu_ps(xs, x);
+        _mm256_storeu_ps(ss, *s);
+        _mm256_storeu_ps(cs, *c);
+        for(int k = 0; k < 8; k++) {
+            if(mask & (1 << k)) {
+                ss[k] = sinf(xs[k]);
+                cs[k] = cosf(xs[k]);
+            }
+        }
+        *s = _mm256_loadu_ps(ss);
+        *c = _mm256_loadu_ps(cs);
+    }
+}
+
+__attribute__((target("avx2,fma"))) static inline __m256 pico_sin_avx2_ps(__m256 x) {
+    __m256 s, c;
+    pico_sincos_avx2_ps(x, &s, &c);
+    return s;
+}
+
+__attribute__((target("avx2,fma"))) static inline __m256 pico_cos_avx2_ps(__m256 x) {
+    __m256 s, c;
+    pico_sincos_avx2_ps(x, &s, &c);
+    return c;
+}
+
+__attribute__((target("avx2,fma"))) static inline __m256 pico_tan_avx2_ps(__m256 x) {
+    __m256 s, c;
+    pico_sincos_avx2_ps(x, &s, &c);
+    return _mm256_div_ps(s, c);
+}
+
+// tanh: odd polynomial for |x| < 0.625 (where 1 - 2/(e^2x + 1) would cancel badly),
+// 1 - 2/(e^2|x| + 1) with the sign put back everywhere else. e^2|x| -> inf gives 1.
+__attribute__((target("avx2,fma"))) static inline __m256 pico_tanh_avx2_ps(__m256 x) {
+    const __m256 sign_mask = _mm256_set1_ps(-0.0f);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    __m256 ax = _mm256_andnot_ps(sign_mask, x);
+
+    __m256 z = _mm256_mul_ps(x, x);
+    __m256 p = _mm256_set1_ps(-5.70498872745e-3f);
+    p = _mm256_fmadd_ps(p, z, _mm256_set1_ps(2.06390887954e-2f));
+    p = _mm256_fmadd_ps(p, z, _mm256_set1_ps(-5.37397155531e-2f));
+    p = _mm256_fmadd_ps(p, z, _mm256_set1_ps(1.33314422036e-1f));
+    p = _mm256_fmadd_ps(p, z, _mm256_set1_ps(-3.33332819422e-1f));
+    p = _mm256_fmadd_ps(_mm256_mul_ps(p, z), x, x);
+
+    __m256 e = pico_exp_avx2_ps(_mm256_add_ps(ax, ax));
+    __m256 big = _mm256_sub_ps(one, _mm256_div_ps(_mm256_set1_ps(2.0f), _mm256_add_ps(e, one)));
+    big = _mm256_or_ps(big, _mm256_and_ps(x, sign_mask));
+
+    return _mm256_blendv_ps(big, p, _mm256_cmp_ps(ax, _mm256_set1_ps(0.625f), _CMP_LT_OQ));
+}
+
+__attribute__((target("avx2"))) static inline __m256 pico_sqrt_avx2_ps(__m256 x) {
+    return _mm256_sqrt_ps(x);
+}
+
+// one-input element-wise kernel around a pico_*_avx2_ps function. the < 8 tail goes
+// through the same vector function with a masked load/store instead of libm, so the
+// last few elements get bit-identical results to the rest of the tensor.
+#define PICO_DEFINE_UNARY_OP_AVX2_FP32(name, simd_fn)                               \
+    __attribute__((target("avx2,fma"))) static inline void name##_cpu_avx2_fp32(    \
+        struct PicoTensor* a, struct PicoTensor* out) {                             \
+        int64_t i = 0;                                                              \
+        int64_t size = out->numel;                                                  \
+        for(; i + 8 <= size; i += 8) {                                              \
+            _mm256_storeu_ps(&out->data[i], simd_fn(_mm256_loadu_ps(&a->data[i]))); \
+        }                                                                           \
+        if(i < size) {                                                              \
+            __m256i m = pico_avx2_tail_mask(size - i);                              \
+            __m256 v = simd_fn(_mm256_maskload_ps(&a->data[i], m));                 \
+            _mm256_maskstore_ps(&out->data[i], m, v);                               \
+        }                                                                           \
+    }
+
+PICO_DEFINE_UNARY_OP_AVX2_FP32(pico_exp, pico_exp_avx2_ps);
+PICO_DEFINE_UNARY_OP_AVX2_FP32(pico_log, pico_log_avx2_ps);
+PICO_DEFINE_UNARY_OP_AVX2_FP32(pico_sin, pico_sin_avx2_ps);
+PICO_DEFINE_UNARY_OP_AVX2_FP32(pico_cos, pico_cos_avx2_ps);
+PICO_DEFINE_UNARY_OP_AVX2_FP32(pico_tan, pico_tan_avx2_ps);
+PICO_DEFINE_UNARY_OP_AVX2_FP32(pico_tanh, pico_tanh_avx2_ps);
+PICO_DEFINE_UNARY_OP_AVX2_FP32(pico_sqrt, pico_sqrt_avx2_ps);
+
+// ---- activations ------------------------------------------------------------
+// slice kernels (flat pointers + n) so the dispatcher can thread them. forward applies
+// fwd_ps; backward accumulates dx += dy * deriv_ps(y) from the saved output y.
+#define PICO_DEFINE_ACT_AVX2_FP32(name, fwd_ps, deriv_ps)                                    \
+    __attribute__((target("avx2,fma"))) static inline void name##_fwd_avx2_fp32(             \
+        const float* x, float* y, int64_t n) {                                               \
+        int64_t i = 0;                                                                       \
+        for(; i + 8 <= n; i += 8) {                                                          \
+            _mm256_storeu_ps(&y[i], fwd_ps(_mm256_loadu_ps(&x[i])));                         \
+        }                                                                                    \
+        if(i < n) {                                                                          \
+            __m256i m = pico_avx2_tail_mask(n - i);                                          \
+            _mm256_maskstore_ps(&y[i], m, fwd_ps(_mm256_maskload_ps(&x[i], m)));             \
+        }                                                                                    \
+    }                                                                                        \
+    __attribute__((target("avx2,fma"))) static inline void name##_bwd_avx2_fp32(             \
+        const float* y, const float* dy, float* dx, int64_t n) {                             \
+        int64_t i = 0;                                                                       \
+        for(; i + 8 <= n; i += 8) {                                                          \
+            __m256 d = deriv_ps(_mm256_loadu_ps(&y[i]));                                     \
+            __m256 g = _mm256_fmadd_ps(_mm256_loadu_ps(&dy[i]), d, _mm256_loadu_ps(&dx[i])); \
+            _mm256_storeu_ps(&dx[i], g);                                                     \
+        }                                                                                    \
+        if(i < n) {                                                                          \
+            __m256i m = pico_avx2_tail_mask(n - i);                                          \
+            __m256 d = deriv_ps(_mm256_maskload_ps(&y[i], m));                               \
+            __m256 g = _mm256_fmadd_ps(_mm256_maskload_ps(&dy[i], m), d,                     \
+                                       _mm256_maskload_ps(&dx[i], m));                       \
+            _mm256_maskstore_ps(&dx[i], m, g);                                               \
+        }                                                                                    \
+    }
+
+__attribute__((target("avx2"))) static inline __m256 pico_relu_avx2_ps(__m256 x) {
+    return _mm256_max_ps(x, _mm256_setzero_ps());
+}
+
+// 1.0 where y > 0, else 0.0 (the compare mask ANDed with 1.0f)
+__attribute__((target("avx2"))) static inline __m256 pico_relu_deriv_avx2_ps(__m256 y) {
+    return _mm256_and_ps(_mm256_cmp_ps(y, _mm256_setzero_ps(), _CMP_GT_OQ), _mm256_set1_ps(1.0f));
+}
+
+__attribute__((target("avx2,fma"))) static inline __m256 pico_sigmoid_avx2_ps(__m256 x) {
+    __m256 one = _mm256_set1_ps(1.0f);
+    __m256 e = pico_exp_avx2_ps(_mm256_sub_ps(_mm256_setzero_ps(), x));
+    return _mm256_div_ps(one, _mm256_add_ps(one, e));
+}
+
+__attribute__((target("avx2,fma"))) static inline __m256 pico_sigmoid_deriv_avx2_ps(__m256 y) {
+    return _mm256_mul_ps(y, _mm256_sub_ps(_mm256_set1_ps(1.0f), y));
+}
+
+__attribute__((target("avx2,fma"))) static inline __m256 pico_tanh_deriv_avx2_ps(__m256 y) {
+    return _mm256_fnmadd_ps(y, y, _mm256_set1_ps(1.0f));
+}
+
+PICO_DEFINE_ACT_AVX2_FP32(pico_relu, pico_relu_avx2_ps, pico_relu_deriv_avx2_ps);
+PICO_DEFINE_ACT_AVX2_FP32(pico_sigmoid, pico_sigmoid_avx2_ps, pico_sigmoid_deriv_avx2_ps);
+PICO_DEFINE_ACT_AVX2_FP32(pico_tanh, pico_tanh_avx2_ps, pico_tanh_deriv_avx2_ps);
+
+// ---- fused chains -----------------------------------------------------------
+// x * sigmoid(x) = x / (1 + e^-x), one read of x, one write of out.
+__attribute__((target("avx2,fma"))) static inline __m256 pico_silu_avx2_ps(__m256 x) {
+    __m256 one = _mm256_set1_ps(1.0f);
+    __m256 e = pico_exp_avx2_ps(_mm256_sub_ps(_mm256_setzero_ps(), x));
+    return _mm256_div_ps(x, _mm256_add_ps(one, e));
+}
+
+// three-input version of the binary macro: same-shape inputs take the 8-wide path,
+// anything broadcast falls back to the scalar map_index walk. SIMD_EXPR sees va/vb/vc,
+// EXPR (the tail + broadcast path) sees the scalar a/b/c elements at ia/ib/ic.
+#define PICO_DEFINE_TERNARY_OP_AVX2_FP32(name, SIMD_EXPR, EXPR)                  \
+    __attribute__((target("avx2,fma"))) static inline void name##_cpu_avx2_fp32( \
+        struct PicoTensor* a, struct PicoTensor* b, struct PicoTensor* c,        \
+        struct PicoTensor* out) {                                                \
+        int64_t i = 0;                                                           \
+        int64_t size = out->numel;                                               \
+        if(a->numel == size && b->numel == size && c->numel == size) {           \
+            for(; i + 8 <= size; i += 8) {                                       \
+                __m256 va = _mm256_loadu_ps(&a->data[i]);                        \
+                __m256 vb = _mm256_loadu_ps(&b->data[i]);                        \
+                __m256 vc = _mm256_loadu_ps(&c->data[i]);                        \
+                _mm256_storeu_ps(&out->data[i], SIMD_EXPR);                      \
+            }                                                                    \
+            for(; i < size; i++) {                                               \
+                int64_t ia = i, ib = i, ic = i;                                  \
+                out->data[i] = EXPR;                                             \
+            }                                                                    \
+        } else {                                                                 \
+            for(; i < size; i++) {                                               \
+                int64_t ia = map_index(i, a, out->strides, out->ndim);           \
+                int64_t ib = map_index(i, b, out->strides, out->ndim);           \
+                int64_t ic = map_index(i, c, out->strides, out->ndim);           \
+                out->data[i] = EXPR;                                             \
+            }                                                                    \
+        }                                                                        \
+    }
+
+PICO_DEFINE_TERNARY_OP_AVX2_FP32(pico_mul_add, _mm256_fmadd_ps(va, vb, vc),
+                                 a->data[ia] * b->data[ib] + c->data[ic]);
+PICO_DEFINE_TERNARY_OP_AVX2_FP32(pico_mul_add_relu,
+                                 _mm256_max_ps(_mm256_fmadd_ps(va, vb, vc), _mm256_setzero_ps()),
+                                 MAX(a->data[ia] * b->data[ib] + c->data[ic], 0.0f));
+
+PICO_DEFINE_UNARY_OP_AVX2_FP32(pico_silu, pico_silu_avx2_ps);
+
+// ---- reductions ---------------------------------------------------------------
+// same contracts as the scalar row/col reductions in cpu_scalar.h. rows: 4 vector
+// accumulators (32 floats in flight) inside a pairwise block, then a horizontal tree.
+// cols: row sweeps over the tile, per-column state in L1 scratch (see below).
+
+__attribute__((target("avx2"))) static inline float pico_hsum_avx2(__m256 v) {
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_movehdup_ps(s));
+    return _mm_cvtss_f32(s);
+}
+
+__attribute__((target("avx2"))) static inline float pico_hmax_avx2(__m256 v) {
+    __m128 m = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+    m = _mm_max_ss(m, _mm_movehdup_ps(m));
+    return _mm_cvtss_f32(m);
+}
+
+__attribute__((target("avx2"))) static inline float pico_sum_row_avx2(const float* x, int64_t n) {
+    if(n > PICO_REDUCE_PAIRWISE_BLOCK) {
+        int64_t half = (n / 2) & ~(int64_t)31;
+        return pico_sum_row_avx2(x, half) + pico_sum_row_avx2(x + half, n - half);
+    }
+    __m256 a0 = _mm256_setzero_ps(), a1 = _mm256_setzero_ps();
+    __m256 a2 = _mm256_setzero_ps(), a3 = _mm256_setzero_ps();
+    int64_t i = 0;
+    for(; i + 32 <= n; i += 32) {
+        a0 = _mm256_add_ps(a0, _mm256_loadu_ps(&x[i]));
+        a1 = _mm256_add_ps(a1, _mm256_loadu_ps(&x[i + 8]));
+        a2 = _mm256_add_ps(a2, _mm256_loadu_ps(&x[i + 16]));
+        a3 = _mm256_add_ps(a3, _mm256_loadu_ps(&x[i + 24]));
+    }
+    for(; i + 8 <= n; i += 8) {
+        a0 = _mm256_add_ps(a0, _mm256_loadu_ps(&x[i]));
+    }
+    if(i < n) {
+        a1 = _mm256_add_ps(a1, _mm256_maskload_ps(&x[i], pico_avx2_tail_mask(n - i)));
+    }
+    return pico_hsum_avx2(_mm256_add_ps(_mm256_add_ps(a0, a1), _mm256_add_ps(a2, a3)));
+}
+
+// max + a "saw a NaN" flag in one pass. the tail lanes past n are filled with -inf
+__attribute__((target("avx2"))) static inline float pico_max_row_avx2(const float* x, int64_t n) {
+    const __m256 ninf = _mm256_set1_ps(-INFINITY);
+    __m256 m0 = ninf, m1 = ninf;
+    __m256 nan = _mm256_setzero_ps();
+    int64_t i = 0;
+    for(; i + 16 <= n; i += 16) {
+        __m256 v0 = _mm256_loadu_ps(&x[i]);
+        __m256 v1 = _mm256_loadu_ps(&x[i + 8]);
+        m0 = _mm256_max_ps(m0, v0);
+        m1 = _mm256_max_ps(m1, v1);
+        nan = _mm256_or_ps(nan, _mm256_cmp_ps(v0, v1, _CMP_UNORD_Q));  // NaN in either
+    }
+    for(; i < n; i += 8) {
+        __m256i mask = pico_avx2_tail_mask(n - i);
+        __m256 v = _mm256_blendv_ps(ninf, _mm256_maskload_ps(&x[i], mask),
+                                    _mm256_castsi256_ps(mask));
+        m0 = _mm256_max_ps(m0, v);
+        nan = _mm256_or_ps(nan, _mm256_cmp_ps(v, v, _CMP_UNORD_Q));
+    }
+    if(_mm256_movemask_ps(nan) != 0) {
+        for(int64_t k = 0; k < n; k++) {
+            if(isnan(x[k])) return x[k];
+        }
+    }
+    return pico_hmax_avx2(_mm256_max_ps(m0, m1));
+}
+
+// two passes: vector max (NaN-aware), then the first index holding it
+__attribute__((target("avx2"))) static inline int64_t pico_argmax_row_avx2(const float* x,
+                                                                          int64_t n) {
+    float m = pico_max_row_avx2(x, n);
+    if(isnan(m)) {
+        for(int64_t k = 0; k < n; k++) {
+            if(isnan(x[k])) return k;
+        }
+    }
+    for(int64_t k = 0; k < n; k++) {
+        if(x[k] == m) return k;
+    }
+    return 0;
+}
+
+// the col kernels sweep whole rows of the tile (contiguous, prefetch-friendly) and
+// keep the per-column state in L1 stack arrays, so every column is an independent
+// chain instead of one long dependent walk down a strided column.
+// ncols <= PICO_REDUCE_COL_TILE; lanes past ncols load 0 and are never stored.
+
+// Kahan per column
+__attribute__((target("avx2"))) static inline void pico_sum_cols_avx2(const float* x, float* y,
+                                                                      int64_t R, int64_t ld,
+                                                                      int64_t ncols) {
+    float s[PICO_REDUCE_COL_TILE] __attribute__((aligned(32)));
+    float c[PICO_REDUCE_COL_TILE] __attribute__((aligned(32)));
+    for(int64_t j = 0; j < ncols; j += 8) {
+        _mm256_store_ps(&s[j], _mm256_setzero_ps());
+        _mm256_store_ps(&c[j], _mm256_setzero_ps());
+    }
+    for(int64_t r = 0; r < R; r++) {
+        const float* row = x + r * ld;
+        for(int64_t j = 0; j < ncols; j += 8) {
+            __m256 sj = _mm256_load_ps(&s[j]);
+            __m256 v = _mm256_sub_ps(_mm256_maskload_ps(&row[j], pico_avx2_tail_mask(ncols - j)),
+                                     _mm256_load_ps(&c[j]));
+            __m256 t = _mm256_add_ps(sj, v);
+            _mm256_store_ps(&c[j], _mm256_sub_ps(_mm256_sub_ps(t, sj), v));
+            _mm256_store_ps(&s[j], t);
+        }
+    }
+    memcpy(y, s, sizeof(float) * ncols);
+}
+
+__attribute__((target("avx2"))) static inline void pico_max_cols_avx2(const float* x, float* y,
+                                                                      int64_t R, int64_t ld,
+                                                                      int64_t ncols) {
+    float m[PICO_REDUCE_COL_TILE] __attribute__((aligned(32)));
+    float nan[PICO_REDUCE_COL_TILE] __attribute__((aligned(32)));  // all-ones lane = saw NaN
+    for(int64_t j = 0; j < ncols; j += 8) {
+        __m256 v = _mm256_maskload_ps(&x[j], pico_avx2_tail_mask(ncols - j));
+        _mm256_store_ps(&m[j], v);
+        _mm256_store_ps(&nan[j], _mm256_cmp_ps(v, v, _CMP_UNORD_Q));
+    }
+    for(int64_t r = 1; r < R; r++) {
+        const float* row = x + r * ld;
+        for(int64_t j = 0; j < ncols; j += 8) {
+            __m256 v = _mm256_maskload_ps(&row[j], pico_avx2_tail_mask(ncols - j));
+            _mm256_store_ps(&m[j], _mm256_max_ps(_mm256_load_ps(&m[j]), v));
+            _mm256_store_ps(&nan[j], _mm256_or_ps(_mm256_load_ps(&nan[j]),
+                                                  _mm256_cmp_ps(v, v, _CMP_UNORD_Q)));
+        }
+    }
+    for(int64_t j = 0; j < ncols; j += 8) {
+        __m256 out = _mm256_blendv_ps(_mm256_load_ps(&m[j]), _mm256_set1_ps(NAN),
+                                      _mm256_load_ps(&nan[j]));
+        _mm256_maskstore_ps(&y[j], pico_avx2_tail_mask(ncols - j), out);
+    }
+}
+
+// running best + its row index per column; a column stops updating once it saw a NaN
+__attribute__((target("avx2"))) static inline void pico_argmax_cols_avx2(const float* x, float* y,
+                                                                         int64_t R, int64_t ld,
+                                                                         int64_t ncols) {
+    float best[PICO_REDUCE_COL_TILE] __attribute__((aligned(32)));
+    float done[PICO_REDUCE_COL_TILE] __attribute__((aligned(32)));
+    float idx[PICO_REDUCE_COL_TILE] __attribute__((aligned(32)));
+    for(int64_t j = 0; j < ncols; j += 8) {
+        __m256 v = _mm256_maskload_ps(&x[j], pico_avx2_tail_mask(ncols - j));
+        _mm256_store_ps(&best[j], v);
+        _mm256_store_ps(&done[j], _mm256_cmp_ps(v, v, _CMP_UNORD_Q));
+        _mm256_store_ps(&idx[j], _mm256_setzero_ps());
+    }
+    for(int64_t r = 1; r < R; r++) {
+        const float* row = x + r * ld;
+        __m256 rv = _mm256_set1_ps((float)r);
+        for(int64_t j = 0; j < ncols; j += 8) {
+            __m256 v = _mm256_maskload_ps(&row[j], pico_avx2_tail_mask(ncols - j));
+            __m256 b = _mm256_load_ps(&best[j]);
+            __m256 d = _mm256_load_ps(&done[j]);
+            __m256 isnan_v = _mm256_cmp_ps(v, v, _CMP_UNORD_Q);
+            __m256 upd = _mm256_or_ps(_mm256_cmp_ps(v, b, _CMP_GT_OQ), isnan_v);
+            upd = _mm256_andnot_ps(d, upd);
+            _mm256_store_ps(&best[j], _mm256_blendv_ps(b, v, upd));
+            _mm256_store_ps(&idx[j], _mm256_blendv_ps(_mm256_load_ps(&idx[j]), rv, upd));
+            _mm256_store_ps(&done[j], _mm256_or_ps(d, isnan_v));
+        }
+    }
+    memcpy(y, idx, sizeof(float) * ncols);
+}
+
+// ---- softmax ----------------------------------------------------------------
+// see cpu_scalar.h. logsumexp keeps a running max + sum PER LANE and folds four
+// vectors per rescale, so it costs 1.25 exps per vector instead of 2; the lanes are
+// merged once at the end. lanes past n load -inf, which exp() sends to 0.
+
+__attribute__((target("avx2,fma"))) static inline float pico_logsumexp_row_avx2(const float* x,
+                                                                               int64_t n) {
+    const __m256 ninf = _mm256_set1_ps(-INFINITY);
+    __m256 m = _mm256_set1_ps(-FLT_MAX);  // finite, so exp(m - m_new) is never inf - inf
+    __m256 s = _mm256_setzero_ps();
+    int64_t i = 0;
+    for(; i + 32 <= n; i += 32) {
+        __m256 v0 = _mm256_loadu_ps(&x[i]), v1 = _mm256_loadu_ps(&x[i + 8]);
+        __m256 v2 = _mm256_loadu_ps(&x[i + 16]), v3 = _mm256_loadu_ps(&x[i + 24]);
+        __m256 mn = _mm256_max_ps(_mm256_max_ps(m, _mm256_max_ps(v0, v1)), _mm256_max_ps(v2, v3));
+        __m256 e = _mm256_add_ps(pico_exp_avx2_ps(_mm256_sub_ps(v0, mn)),
+                                 pico_exp_avx2_ps(_mm256_sub_ps(v1, mn)));
+        e = _mm256_add_ps(e, pico_exp_avx2_ps(_mm256_sub_ps(v2, mn)));
+        e = _mm256_add_ps(e, pico_exp_avx2_ps(_mm256_sub_ps(v3, mn)));
+        s = _mm256_fmadd_ps(s, pico_exp_avx2_ps(_mm256_sub_ps(m, mn)), e);
+        m = mn;
+    }
+    for(; i < n; i += 8) {
+        __m256i mask = pico_avx2_tail_mask(n - i);
+        __m256 v = _mm256_maskload_ps(&x[i], mask);
+        v = _mm256_blendv_ps(ninf, v, _mm256_castsi256_ps(mask));
+        __m256 mn = _mm256_max_ps(m, v);
+        s = _mm256_fmadd_ps(s, pico_exp_avx2_ps(_mm256_sub_ps(m, mn)),
+                            pico_exp_avx2_ps(_mm256_sub_ps(v, mn)));
+        m = mn;
+    }
+    float M = pico_hmax_avx2(m);
+    __m256 rescale = pico_exp_avx2_ps(_mm256_sub_ps(m, _mm256_set1_ps(M)));
+    float S = pico_hsum_avx2(_mm256_mul_ps(s, rescale));
+    return M + logf(S);
+}
+
+__attribute__((target("avx2,fma"))) static inline void pico_softmax_accum_row_avx2(
+    const float* x, float lse, float scale, float* y, int64_t n) {
+    const __m256 vl = _mm256_set1_ps(lse);
+    const __m256 vs = _mm256_set1_ps(scale);
+    int64_t i = 0;
+    for(; i + 8 <= n; i += 8) {
+        __m256 e = pico_exp_avx2_ps(_mm256_sub_ps(_mm256_loadu_ps(&x[i]), vl));
+        _mm256_storeu_ps(&y[i], _mm256_fmadd_ps(vs, e, _mm256_loadu_ps(&y[i])));
+    }
+    if(i < n) {
+        __m256i mask = pico_avx2_tail_mask(n - i);
+        __m256 e = pico_exp_avx2_ps(_mm256_sub_ps(_mm256_maskload_ps(&x[i], mask), vl));
+        _mm256_maskstore_ps(&y[i], mask, _mm256_fmadd_ps(vs, e, _mm256_maskload_ps(&y[i], mask)));
+    }
+}
+
+__attribute__((target("avx2,fma"))) static inline void pico_softmax_bwd_row_avx2(const float* y,
+                                                                                const float* dy,
+                                                                                float* dx,
+                                                                                int64_t n) {
+    __m256 acc = _mm256_setzero_ps();
+    int64_t i = 0;
+    for(; i + 8 <= n; i += 8) {
+        acc = _mm256_fmadd_ps(_mm256_loadu_ps(&dy[i]), _mm256_loadu_ps(&y[i]), acc);
+    }
+    __m256i mask = pico_avx2_tail_mask(n - i);
+    if(i < n) {
+        acc = _mm256_fmadd_ps(_mm256_maskload_ps(&dy[i], mask), _mm256_maskload_ps(&y[i], mask),
+                              acc);
+    }
+    const __m256 dot = _mm256_set1_ps(pico_hsum_avx2(acc));
+    for(i = 0; i + 8 <= n; i += 8) {
+        __m256 g = _mm256_sub_ps(_mm256_loadu_ps(&dy[i]), dot);
+        __m256 r = _mm256_fmadd_ps(_mm256_loadu_ps(&y[i]), g, _mm256_loadu_ps(&dx[i]));
+        _mm256_storeu_ps(&dx[i], r);
+    }
+    if(i < n) {
+        __m256 g = _mm256_sub_ps(_mm256_maskload_ps(&dy[i], mask), dot);
+        __m256 r = _mm256_fmadd_ps(_mm256_maskload_ps(&y[i], mask), g,
+                                   _mm256_maskload_ps(&dx[i], mask));
+        _mm256_maskstore_ps(&dx[i], mask, r);
+    }
+}
+
+// ---- mse --------------------------------------------------------------------
+// see cpu_scalar.h. the sum is pico_sum_row_avx2's layout with an fma per vector
+
+__attribute__((target("avx2,fma"))) static inline float pico_sq_diff_sum_row_avx2(const float* a,
+                                                                                 const float* b,
+                                                                                 int64_t n) {
+    if(n > PICO_REDUCE_PAIRWISE_BLOCK) {
+        int64_t half = (n / 2) & ~(int64_t)31;
+        return pico_sq_diff_sum_row_avx2(a, b, half) +
+               pico_sq_diff_sum_row_avx2(a + half, b + half, n - half);
+    }
+    __m256 a0 = _mm256_setzero_ps(), a1 = _mm256_setzero_ps();
+    __m256 a2 = _mm256_setzero_ps(), a3 = _mm256_setzero_ps();
+    int64_t i = 0;
+    for(; i + 32 <= n; i += 32) {
+        __m256 d0 = _mm256_sub_ps(_mm256_loadu_ps(&a[i]), _mm256_loadu_ps(&b[i]));
+        __m256 d1 = _mm256_sub_ps(_mm256_loadu_ps(&a[i + 8]), _mm256_loadu_ps(&b[i + 8]));
+        __m256 d2 = _mm256_sub_ps(_mm256_loadu_ps(&a[i + 16]), _mm256_loadu_ps(&b[i + 16]));
+        __m256 d3 = _mm256_sub_ps(_mm256_loadu_ps(&a[i + 24]), _mm256_loadu_ps(&b[i + 24]));
+        a0 = _mm256_fmadd_ps(d0, d0, a0);
+        a1 = _mm256_fmadd_ps(d1, d1, a1);
+        a2 = _mm256_fmadd_ps(d2, d2, a2);
+        a3 = _mm256_fmadd_ps(d3, d3, a3);
+    }
+    for(; i < n; i += 8) {
+        __m256i mask = pico_avx2_tail_mask(n - i);
+        __m256 d = _mm256_sub_ps(_mm256_maskload_ps(&a[i], mask), _mm256_maskload_ps(&b[i], mask));
+        a0 = _mm256_fmadd_ps(d, d, a0);
+    }
+    return pico_hsum_avx2(_mm256_add_ps(_mm256_add_ps(a0, a1), _mm256_add_ps(a2, a3)));
+}
+
+__attribute__((target("avx2"))) static inline void pico_sq_diff_avx2(const float* a,
+                                                                     const float* b, float* y,
+                                                                     int64_t n) {
+    for(int64_t i = 0; i < n; i += 8) {
+        __m256i mask = pico_avx2_tail_mask(n - i);
+        __m256 d = _mm256_sub_ps(_mm256_maskload_ps(&a[i], mask), _mm256_maskload_ps(&b[i], mask));
+        _mm256_maskstore_ps(&y[i], mask, _mm256_mul_ps(d, d));
+    }
+}
+
+__attribute__((target("avx2,fma"))) static inline void pico_mse_bwd_avx2(
+    const float* a, const float* b, const float* dy, float scale, float* da, float* db,
+    int64_t n) {
+    const __m256 vs = _mm256_set1_ps(scale);
+    for(int64_t i = 0; i < n; i += 8) {
+        __m256i mask = pico_avx2_tail_mask(n - i);
+        __m256 d = _mm256_sub_ps(_mm256_maskload_ps(&a[i], mask), _mm256_maskload_ps(&b[i], mask));
+        __m256 g = dy ? _mm256_mul_ps(vs, _mm256_maskload_ps(&dy[i], mask)) : vs;
+        d = _mm256_mul_ps(g, d);
+        if(da) {
+            _mm256_maskstore_ps(&da[i], mask, _mm256_add_ps(_mm256_maskload_ps(&da[i], mask), d));
+        }
+        if(db) {
+            _mm256_maskstore_ps(&db[i], mask, _mm256_sub_ps(_mm256_maskload_ps(&db[i], mask), d));
+        }
+    }
+}
+
+// ---- optimizer steps ----------------------------------------------------------
+// see cpu_scalar.h for the math. one masked loop each (no separate tail): every array
+// is loaded and stored through the tail mask, so the last partial vector is free.
+
+#define PICO_OPTIM_AVX2_LOAD(ptr) _mm256_maskload_ps((ptr) + i, mask)
+#define PICO_OPTIM_AVX2_STORE(ptr, val) _mm256_maskstore_ps((ptr) + i, mask, (val))
+#define PICO_OPTIM_AVX2_GRAD() pico_optim_take_grad_avx2(g + i, mask, h)
+
+__attribute__((target("avx2"))) static inline __m256 pico_optim_take_grad_avx2(
+    float* g, __m256i mask, const struct PicoOptimStep* h) {
+    __m256 gv = _mm256_maskload_ps(g, mask);
+    if(h->zero_grad) _mm256_maskstore_ps(g, mask, _mm256_setzero_ps());
+    return _mm256_mul_ps(_mm256_set1_ps(h->grad_scale), gv);
+}
+
+__attribute__((target("avx2,fma"))) static inline void pico_sgd_step_avx2(
+    float* p, float* g, int64_t n, const struct PicoOptimStep* h) {
+    const __m256 lr = _mm256_set1_ps(h->lr);
+    for(int64_t i = 0; i < n; i += 8) {
+        __m256i mask = pico_avx2_tail_mask(n - i);
+        __m256 pv = _mm256_fnmadd_ps(lr, PICO_OPTIM_AVX2_GRAD(), PICO_OPTIM_AVX2_LOAD(p));
+        PICO_OPTIM_AVX2_STORE(p, pv);
+    }
+}
+
+__attribute__((target("avx2,fma"))) static inline void pico_nag_step_avx2(
+    float* p, float* g, float* buf, int64_t n, const struct PicoOptimStep* h) {
+    const __m256 mu = _mm256_set1_ps(h->momentum), lr = _mm256_set1_ps(h->lr);
+    const __m256 wd = _mm256_set1_ps(h->wd_l2);
+    for(int64_t i = 0; i < n; i += 8) {
+        __m256i mask = pico_avx2_tail_mask(n - i);
+        __m256 pv = PICO_OPTIM_AVX2_LOAD(p);
+        __m256 gv = _mm256_fmadd_ps(wd, pv, PICO_OPTIM_AVX2_GRAD());
+        __m256 b = _mm256_fmadd_ps(mu, PICO_OPTIM_AVX2_LOAD(buf), gv);
+        PICO_OPTIM_AVX2_STORE(buf, b);
+        PICO_OPTIM_AVX2_STORE(p, _mm256_fnmadd_ps(lr, _mm256_fmadd_ps(mu, b, gv), pv));
+    }
+}
+
+__attribute__((target("avx2,fma"))) static inline void pico_adagrad_step_avx2(
+    float* p, float* g, float* s, int64_t n, const struct PicoOptimStep* h) {
+    const __m256 lr = _mm256_set1_ps(h->lr), eps = _mm256_set1_ps(h->eps);
+    const __m256 wd = _mm256_set1_ps(h->wd_l2);
+    for(int64_t i = 0; i < n; i += 8) {
+        __m256i mask = pico_avx2_tail_mask(n - i);
+        __m256 pv = PICO_OPTIM_AVX2_LOAD(p);
+        __m256 gv = _mm256_fmadd_ps(wd, pv, PICO_OPTIM_AVX2_GRAD());
+        __m256 sv = _mm256_fmadd_ps(gv, gv, PICO_OPTIM_AVX2_LOAD(s));
+        PICO_OPTIM_AVX2_STORE(s, sv);
+        __m256 upd = _mm256_div_ps(_mm256_mul_ps(lr, gv), _mm256_add_ps(_mm256_sqrt_ps(sv), eps));
+        PICO_OPTIM_AVX2_STORE(p, _mm256_sub_ps(pv, upd));
+    }
+}
+
+__attribute__((target("avx2,fma"))) static inline void pico_rmsprop_step_avx2(
+    float* p, float* g, float* s, int64_t n, const struct PicoOptimStep* h) {
+    const __m256 lr = _mm256_set1_ps(h->lr), eps = _mm256_set1_ps(h->eps);
+    const __m256 wd = _mm256_set1_ps(h->wd_l2);
+    const __m256 a = _mm256_set1_ps(h->alpha), a1 = _mm256_set1_ps(1.0f - h->alpha);
+    for(int64_t i = 0; i < n; i += 8) {
+        __m256i mask = pico_avx2_tail_mask(n - i);
+        __m256 pv = PICO_OPTIM_AVX2_LOAD(p);
+        __m256 gv = _mm256_fmadd_ps(wd, pv, PICO_OPTIM_AVX2_GRAD());
+        __m256 sv = _mm256_fmadd_ps(a, PICO_OPTIM_AVX2_LOAD(s),
+                                    _mm256_mul_ps(a1, _mm256_mul_ps(gv, gv)));
+        PICO_OPTIM_AVX2_STORE(s, sv);
+        __m256 upd = _mm256_div_ps(_mm256_mul_ps(lr, gv), _mm256_add_ps(_mm256_sqrt_ps(sv), eps));
+        PICO_OPTIM_AVX2_STORE(p, _mm256_sub_ps(pv, upd));
+    }
+}
+
+__attribute__((target("avx2,fma"))) static inline void pico_adam_step_avx2(
+    float* p, float* g, float* m, float* v, int64_t n, const struct PicoOptimStep* h) {
+    const __m256 b1 = _mm256_set1_ps(h->beta1), b1c = _mm256_set1_ps(1.0f - h->beta1);
+    const __m256 b2 = _mm256_set1_ps(h->beta2), b2c = _mm256_set1_ps(1.0f - h->beta2);
+    const __m256 wd = _mm256_set1_ps(h->wd_l2), decay = _mm256_set1_ps(h->decay);
+    const __m256 step = _mm256_set1_ps(h->step_scale), vs = _mm256_set1_ps(h->v_scale);
+    const __m256 eps = _mm256_set1_ps(h->eps);
+    for(int64_t i = 0; i < n; i += 8) {
+        __m256i mask = pico_avx2_tail_mask(n - i);
+        __m256 pv = PICO_OPTIM_AVX2_LOAD(p);
+        __m256 gv = _mm256_fmadd_ps(wd, pv, PICO_OPTIM_AVX2_GRAD());
+        __m256 mv = _mm256_fmadd_ps(b1, PICO_OPTIM_AVX2_LOAD(m), _mm256_mul_ps(b1c, gv));
+        __m256 vv = _mm256_fmadd_ps(b2, PICO_OPTIM_AVX2_LOAD(v),
+                                    _mm256_mul_ps(b2c, _mm256_mul_ps(gv, gv)));
+        PICO_OPTIM_AVX2_STORE(m, mv);
+        PICO_OPTIM_AVX2_STORE(v, vv);
+        __m256 denom = _mm256_fmadd_ps(_mm256_sqrt_ps(vv), vs, eps);
+        __m256 upd = _mm256_div_ps(_mm256_mul_ps(step, mv), denom);
+        PICO_OPTIM_AVX2_STORE(p, _mm256_fmsub_ps(decay, pv, upd));
+    }
+}
+
+#undef PICO_OPTIM_AVX2_LOAD
+#undef PICO_OPTIM_AVX2_STORE
+#undef PICO_OPTIM_AVX2_GRAD
+
+// ---- dtype conversion -----------------------------------------------------------
+// fp16 goes through F16C (vcvtph2ps / vcvtps2ph), which every AVX2 part has. bf16 is
+// just the top half of an fp32: widening is a zero-extend and a shift; narrowing adds
+// the round-to-nearest-even bias first and keeps NaNs NaN, as pico_f32_to_bf16 does.
+// tails go through the scalar converters.
+
+__attribute__((target("avx2,f16c"))) static inline void pico_cvt_f16_to_f32_avx2(
+    const uint16_t* src, float* dst, int64_t n) {
+    int64_t i = 0;
+    for(; i + 8 <= n; i += 8) {
+        __m128i h = _mm_loadu_si128((const __m128i*)(src + i));
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+    }
+    pico_cvt_f16_to_f32_scalar(src + i, dst + i, n - i);
+}
+
+__attribute__((target("avx2,f16c"))) static inline void pico_cvt_f32_to_f16_avx2(
+    const float* src, uint16_t* dst, int64_t n) {
+    int64_t i = 0;
+    for(; i + 8 <= n; i += 8) {
+        __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128((__m128i*)(dst + i), h);
+    }
+    pico_cvt_f32_to_f16_scalar(src + i, dst + i, n - i);
+}
+
+__attribute__((target("avx2"))) static inline __m256 pico_avx2_bf16_load(const uint16_t* src) {
+    __m256i w = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)src));
+    return _mm256_castsi256_ps(_mm256_slli_epi32(w, 16));
+}
+
+__attribute__((target("avx2"))) static inline void pico_cvt_bf16_to_f32_avx2(const uint16_t* src,
+                                                                              float* dst,
+                                                                              int64_t n) {
+    int64_t i = 0;
+    for(; i + 8 <= n; i += 8) _mm256_storeu_ps(dst + i, pico_avx2_bf16_load(src + i));
+    pico_cvt_bf16_to_f32_scalar(src + i, dst + i, n - i);
+}
+
+__attribute__((target("avx2"))) static inline void pico_cvt_f32_to_bf16_avx2(const float* src,
+                                                                              uint16_t* dst,
+                                                                              int64_t n) {
+    const __m256i bias = _mm256_set1_epi32(0x7fff), one = _mm256_set1_epi32(1);
+    const __m256i abs_mask = _mm256_set1_epi32(0x7fffffff), inf = _mm256_set1_epi32(0x7f800000);
+    const __m256i quiet = _mm256_set1_epi32(0x400000);
+    int64_t i = 0;
+    for(; i + 8 <= n; i += 8) {
+        __m256i u = _mm256_loadu_si256((const __m256i*)(src + i));
+        __m256i lsb = _mm256_and_si256(_mm256_srli_epi32(u, 16), one);
+        __m256i r = _mm256_add_epi32(u, _mm256_add_epi32(bias, lsb));
+        __m256i nan = _mm256_cmpgt_epi32(_mm256_and_si256(u, abs_mask), inf);
+        r = _mm256_blendv_epi8(r, _mm256_or_si256(u, quiet), nan);
+        r = _mm256_srli_epi32(r, 16);
+        // 8 x u32 -> 8 x u16: packus works per 128-bit lane, so stitch the two halves
+        __m256i p = _mm256_packus_epi32(r, r);
+        __m128i h = _mm_unpacklo_epi64(_mm256_castsi256_si128(p), _mm256_extracti128_si256(p, 1));
+        _mm_storeu_si128((__m128i*)(dst + i), h);
+    }
+    pico_cvt_f32_to_bf16_scalar(src + i, dst + i, n - i);
+}
+
+// ---- int8 GEMM --------------------------------------------------------------------
+// see cpu_scalar.h. vpmaddubsw multiplies unsigned x signed bytes into int16 pairs, so
+// x is made unsigned with the sign trick: |x| * (w with x's sign applied). both factors
+// are within 127, so a pair sums to at most 2 * 127 * 127 = 32258 and never saturates;
+// vpmaddwd against ones then widens the pairs into the int32 accumulators.
+
+__attribute__((target("avx2"))) static inline float pico_absmax_avx2(const float* x, int64_t n) {
+    const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    __m256 m0 = _mm256_setzero_ps(), m1 = _mm256_setzero_ps();
+    int64_t i = 0;
+    // max(|x|, m) keeps m when |x| is NaN, like fmaxf
+    for(; i + 16 <= n; i += 16) {
+        m0 = _mm256_max_ps(_mm256_and_ps(_mm256_loadu_ps(x + i), abs_mask), m0);
+        m1 = _mm256_max_ps(_mm256_and_ps(_mm256_loadu_ps(x + i + 8), abs_mask), m1);
+    }
+    float lanes[8];
+    _mm256_storeu_ps(lanes, _mm256_max_ps(m0, m1));
+    float m = pico_absmax_scalar(x + i, n - i);
+    for(int l = 0; l < 8; l++) m = fmaxf(m, lanes[l]);
+    return m;
+}
+
+// same rounding as the scalar version: vcvtps2dq rounds to nearest even, and max(v, lo)
+// turns a NaN into -127 just as fmaxf does
+__attribute__((target("avx2"))) static inline __m256i pico_quantize_s8_avx2_epi32(
+    const float* x, __m256 inv, __m256 lo, __m256 hi) {
+    __m256 v = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(x), inv), lo), hi);
+    return _mm256_cvtps_epi32(v);
+}
+
+__attribute__((target("avx2"))) static inline void pico_quantize_s8_avx2(const float* x, int8_t* q,
+                                                                          int64_t n,
+                                                                          float inv_scale) {
+    const __m256 inv = _mm256_set1_ps(inv_scale);
+    const __m256 lo = _mm256_set1_ps(-127.0f), hi = _mm256_set1_ps(127.0f);
+    // the packs work per 128-bit lane: after both, dword d of the result holds 4 bytes of
+    // input vector (d % 4), half (d / 4). this permute puts them back in order
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    int64_t i = 0;
+    for(; i + 32 <= n; i += 32) {
+        __m256i q0 = pico_quantize_s8_avx2_epi32(x + i, inv, lo, hi);
+        __m256i q1 = pico_quantize_s8_avx2_epi32(x + i + 8, inv, lo, hi);
+        __m256i q2 = pico_quantize_s8_avx2_epi32(x + i + 16, inv, lo, hi);
+        __m256i q3 = pico_quantize_s8_avx2_epi32(x + i + 24, inv, lo, hi);
+        __m256i p = _mm256_packs_epi16(_mm256_packs_epi32(q0, q1), _mm256_packs_epi32(q2, q3));
+        _mm256_storeu_si256((__m256i*)(q + i), _mm256_permutevar8x32_epi32(p, order));
+    }
+    pico_quantize_s8_scalar(x + i, q + i, n - i, inv_scale);
+}
+
+// 8 int32 accumulators -> their 4 horizontal sums for one tile row
+__attribute__((target("avx2"))) static inline __m128i pico_qgemm_hsum4_avx2(__m256i c0, __m256i c1,
+                                                                             __m256i c2,
+                                                                             __m256i c3) {
+    __m256i s = _mm256_hadd_epi32(_mm256_hadd_epi32(c0, c1), _mm256_hadd_epi32(c2, c3));
+    return _mm_add_epi32(_mm256_castsi256_si128(s), _mm256_extracti128_si256(s, 1));
+}
+
+// acc += the int32 pair sums of |x| * (w signed like x); fixed to the MR = 2, NR = 4 tile
+#define PICO_QGEMM_AVX2_DOT(acc, ax, sx, wv)                                         \
+    acc = _mm256_add_epi32(                                                          \
+        acc, _mm256_madd_epi16(_mm256_maddubs_epi16(ax, _mm256_sign_epi8(wv, sx)), ones))
+
+__attribute__((target("avx2"))) static inline void pico_qgemm_tile_avx2(const int8_t* x,
+                                                                         const int8_t* w,
+                                                                         const int32_t* w_sum,
+                                                                         int64_t kp,
+                                                                         int32_t* acc) {
+    (void)w_sum;
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i c00 = _mm256_setzero_si256(), c01 = c00, c02 = c00, c03 = c00;
+    __m256i c10 = c00, c11 = c00, c12 = c00, c13 = c00;
+    for(int64_t k = 0; k < kp; k += 32) {
+        __m256i x0 = _mm256_loadu_si256((const __m256i*)(x + k));
+        __m256i x1 = _mm256_loadu_si256((const __m256i*)(x + kp + k));
+        __m256i a0 = _mm256_sign_epi8(x0, x0), a1 = _mm256_sign_epi8(x1, x1);
+        __m256i w0 = _mm256_loadu_si256((const __m256i*)(w + k));
+        __m256i w1 = _mm256_loadu_si256((const __m256i*)(w + kp + k));
+        __m256i w2 = _mm256_loadu_si256((const __m256i*)(w + 2 * kp + k));
+        __m256i w3 = _mm256_loadu_si256((const __m256i*)(w + 3 * kp + k));
+        PICO_QGEMM_AVX2_DOT(c00, a0, x0, w0);
+        PICO_QGEMM_AVX2_DOT(c01, a0, x0, w1);
+        PICO_QGEMM_AVX2_DOT(c02, a0, x0, w2);
+        PICO_QGEMM_AVX2_DOT(c03, a0, x0, w3);
+        PICO_QGEMM_AVX2_DOT(c10, a1, x1, w0);
+        PICO_QGEMM_AVX2_DOT(c11, a1, x1, w1);
+        PICO_QGEMM_AVX2_DOT(c12, a1, x1, w2);
+        PICO_QGEMM_AVX2_DOT(c13, a1, x1, w3);
+    }
+    _mm_storeu_si128((__m128i*)acc, pico_qgemm_hsum4_avx2(c00, c01, c02, c03));
+    _mm_storeu_si128((__m128i*)(acc + PICO_QGEMM_NR), pico_qgemm_hsum4_avx2(c10, c11, c12, c13));
+}
+
+#undef PICO_QGEMM_AVX2_DOT
+
+// ---- random numbers ---------------------------------------------------------------
+
+// 32x32 -> 64 multiply of all 8 lanes: vpmuludq does the even lanes, the odd ones are
+// shifted down first. returns the low halves, high halves in *hi
+__attribute__((target("avx2"))) static inline __m256i pico_philox_mulhilo_avx2(__m256i a,
+                                                                              __m256i m,
+                                                                              __m256i* hi) {
+    __m256i even = _mm256_mul_epu32(a, m);
+    __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), m);
+    *hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+    return _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+}
+
+// pico_philox_scalar on the 16 counters of a super-block, bit-identical: lanes 0-7 in
+// c[0..3], 8-15 in c[4..7]. two independent chains keep the multiplier busy through
+// each round's mul -> xor latency
+__attribute__((target("avx2"))) static inline void pico_philox_avx2(__m256i c[8], uint32_t k0,
+                                                                   uint32_t k1) {
+    const __m256i m0 = _mm256_set1_epi32((int)PICO_PHILOX_M0);
+    const __m256i m1 = _mm256_set1_epi32((int)PICO_PHILOX_M1);
+    for(int r = 0; r < 10; r++) {
+        const __m256i vk0 = _mm256_set1_epi32((int)k0), vk1 = _mm256_set1_epi32((int)k1);
+        for(int h = 0; h < 8; h += 4) {
+            __m256i hi0, hi1;
+            __m256i lo0 = pico_philox_mulhilo_avx2(c[h], m0, &hi0);
+            __m256i lo1 = pico_philox_mulhilo_avx2(c[h + 2], m1, &hi1);
+            c[h] = _mm256_xor_si256(_mm256_xor_si256(hi1, c[h + 1]), vk0);
+            c[h + 2] = _mm256_xor_si256(_mm256_xor_si256(hi0, c[h + 3]), vk1);
+            c[h + 1] = lo1;
+            c[h + 3] = lo0;
+        }
+        k0 += PICO_PHILOX_W0;
+        k1 += PICO_PHILOX_W1;
+    }
+}
+
+// the super-block's 4 words per lane: c[k] = word k of lanes 0..7, c[4 + k] of lanes
+// 8..15. block is a multiple of PICO_RNG_LANES, so block + lane never carries into the
+// counter's second word
+__attribute__((target("avx2"))) static inline void pico_rng_words_avx2(uint64_t seed,
+                                                                      uint64_t stream,
+                                                                      uint64_t block,
+                                                                      __m256i c[8]) {
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    for(int h = 0; h < 2; h++) {
+        c[4 * h] = _mm256_add_epi32(_mm256_set1_epi32((int)(uint32_t)block + 8 * h), lanes);
+        c[4 * h + 1] = _mm256_set1_epi32((int)(uint32_t)(block >> 32));
+        c[4 * h + 2] = _mm256_set1_epi32((int)(uint32_t)stream);
+        c[4 * h + 3] = _mm256_set1_epi32((int)(uint32_t)(stream >> 32));
+    }
+    pico_philox_avx2(c, (uint32_t)seed, (uint32_t)(seed >> 32));
+}
+
+__attribute__((target("avx2"))) static inline __m256 pico_rng_u01_avx2(__m256i r) {
+    return _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(r, 8)), _mm256_set1_ps(0x1p-24f));
+}
+
+__attribute__((target("avx2"))) static inline __m256 pico_rng_u01_open_avx2(__m256i r) {
+    __m256i v = _mm256_add_epi32(_mm256_srli_epi32(r, 8), _mm256_set1_epi32(1));
+    return _mm256_mul_ps(_mm256_cvtepi32_ps(v), _mm256_set1_ps(0x1p-24f));
+}
+
+// bit-identical to pico_rng_uniform_scalar (mul then add, like the scalar code: no fma)
+__attribute__((target("avx2"))) static inline void pico_rng_uniform_avx2(uint64_t seed,
+                                                                        uint64_t stream,
+                                                                        uint64_t block, float lo,
+                                                                        float span, float* out) {
+    __m256i c[8];
+    pico_rng_words_avx2(seed, stream, block, c);
+    const __m256 vlo = _mm256_set1_ps(lo), vspan = _mm256_set1_ps(span);
+    for(int h = 0; h < 2; h++) {
+        for(int k = 0; k < 4; k++) {
+            __m256 u = _mm256_mul_ps(vspan, pico_rng_u01_avx2(c[4 * h + k]));
+            _mm256_storeu_ps(out + k * PICO_RNG_LANES + 8 * h, _mm256_add_ps(vlo, u));
+        }
+    }
+}
+
+// Box-Muller with the polynomial log / sincos above: the same distribution as
+// pico_rng_normal_scalar, equal to within their few-ulp error rather than bit for bit
+__attribute__((target("avx2,fma"))) static inline void pico_rng_normal_avx2(uint64_t seed,
+                                                                           uint64_t stream,
+                                                                           uint64_t block,
+                                                                           float mean, float std,
+                                                                           float* out) {
+    __m256i c[8];
+    pico_rng_words_avx2(seed, stream, block, c);
+    const __m256 vmean = _mm256_set1_ps(mean), vstd = _mm256_set1_ps(std);
+    for(int h = 0; h < 2; h++) {
+        for(int p = 0; p < 4; p += 2) {
+            __m256 ln = pico_log_avx2_ps(pico_rng_u01_open_avx2(c[4 * h + p]));
+            __m256 r = pico_sqrt_avx2_ps(  // max: ln(1) must not come out a hair above 0
+                _mm256_max_ps(_mm256_mul_ps(_mm256_set1_ps(-2.0f), ln), _mm256_setzero_ps()));
+            __m256 theta =
+                _mm256_mul_ps(_mm256_set1_ps(2.0f * PI_F), pico_rng_u01_avx2(c[4 * h + p + 1]));
+            __m256 s, co;
+            pico_sincos_avx2_ps(theta, &s, &co);
+            float* o = out + p * PICO_RNG_LANES + 8 * h;
+            _mm256_storeu_ps(o, _mm256_fmadd_ps(vstd, _mm256_mul_ps(r, co), vmean));
+            _mm256_storeu_ps(o + PICO_RNG_LANES, _mm256_fmadd_ps(vstd, _mm256_mul_ps(r, s), vmean));
+        }
+    }
+}
+
+// pico_erfinv_scalar with both polynomials evaluated and blended per lane
+__attribute__((target("avx2,fma"))) static inline __m256 pico_erfinv_avx2_ps(__m256 x) {
+    const __m256 one = _mm256_set1_ps(1.0f);
+    __m256 w = _mm256_sub_ps(_mm256_setzero_ps(),
+                             pico_log_avx2_ps(_mm256_mul_ps(_mm256_sub_ps(one, x),
+                                                            _mm256_add_ps(one, x))));
+    __m256 a = _mm256_sub_ps(w, _mm256_set1_ps(2.5f));
+    __m256 p = _mm256_set1_ps(2.81022636e-08f);
+    p = _mm256_fmadd_ps(p, a, _mm256_set1_ps(3.43273939e-07f));
+    p = _mm256_fmadd_ps(p, a, _mm256_set1_ps(-3.5233877e-06f));
+    p = _mm256_fmadd_ps(p, a, _mm256_set1_ps(-4.39150654e-06f));
+    p = _mm256_fmadd_ps(p, a, _mm256_set1_ps(0.00021858087f));
+    p = _mm256_fmadd_ps(p, a, _mm256_set1_ps(-0.00125372503f));
+    p = _mm256_fmadd_ps(p, a, _mm256_set1_ps(-0.00417768164f));
+    p = _mm256_fmadd_ps(p, a, _mm256_set1_ps(0.246640727f));
+    p = _mm256_fmadd_ps(p, a, _mm256_set1_ps(1.50140941f));
+    __m256 b = _mm256_sub_ps(_mm256_sqrt_ps(w), _mm256_set1_ps(3.0f));
+    __m256 q = _mm256_set1_ps(-0.000200214257f);
+    q = _mm256_fmadd_ps(q, b, _mm256_set1_ps(0.000100950558f));
+    q = _mm256_fmadd_ps(q, b, _mm256_set1_ps(0.00134934322f));
+    q = _mm256_fmadd_ps(q, b, _mm256_set1_ps(-0.00367342844f));
+    q = _mm256_fmadd_ps(q, b, _mm256_set1_ps(0.00573950773f));
+    q = _mm256_fmadd_ps(q, b, _mm256_set1_ps(-0.0076224613f));
+    q = _mm256_fmadd_ps(q, b, _mm256_set1_ps(0.00943887047f));
+    q = _mm256_fmadd_ps(q, b, _mm256_set1_ps(1.00167406f));
+    q = _mm256_fmadd_ps(q, b, _mm256_set1_ps(2.83297682f));
+    __m256 tail = _mm256_cmp_ps(w, _mm256_set1_ps(5.0f), _CMP_GE_OQ);
+    return _mm256_mul_ps(_mm256_blendv_ps(p, q, tail), x);
+}
+
+__attribute__((target("avx2,fma"))) static inline void pico_erfinv_affine_avx2(float* x,
+                                                                              int64_t n,
+                                                                              float shift,
+                                                                              float scale,
+                                                                              float lo, float hi) {
+    const __m256 vshift = _mm256_set1_ps(shift), vscale = _mm256_set1_ps(scale);
+    const __m256 vlo = _mm256_set1_ps(lo), vhi = _mm256_set1_ps(hi);
+    int64_t i = 0;
+    for(; i + 8 <= n; i += 8) {
+        __m256 v = _mm256_fmadd_ps(vscale, pico_erfinv_avx2_ps(_mm256_loadu_ps(x + i)), vshift);
+        _mm256_storeu_ps(x + i, _mm256_min_ps(_mm256_max_ps(v, vlo), vhi));
+    }
+    pico_erfinv_affine_scalar(x + i, n - i, shift, scale, lo, hi);
+}
+
+// ---- transpose ------------------------------------------------------------------------
+// one 8x8 tile through registers: 8 row loads, three shuffle stages (unpack pairs of
+// rows, shuffle pairs of those, swap 128-bit lanes) and 8 row stores, so both sides are
+// touched a full 32-byte row at a time instead of one strided float at a time
+
+__attribute__((target("avx2"))) static inline void pico_transpose_8x8_avx2(const float* src,
+                                                                           int64_t lds,
+                                                                           float* dst,
+                                                                           int64_t ldd,
+                                                                           bool acc) {
+    __m256 r0 = _mm256_loadu_ps(src + 0 * lds), r1 = _mm256_loadu_ps(src + 1 * lds);
+    __m256 r2 = _mm256_loadu_ps(src + 2 * lds), r3 = _mm256_loadu_ps(src + 3 * lds);
+    __m256 r4 = _mm256_loadu_ps(src + 4 * lds), r5 = _mm256_loadu_ps(src + 5 * lds);
+    __m256 r6 = _mm256_loadu_ps(src + 6 * lds), r7 = _mm256_loadu_ps(src + 7 * lds);
+
+    __m256 t0 = _mm256_unpacklo_ps(r0, r1), t1 = _mm256_unpackhi_ps(r0, r1);
+    __m256 t2 = _mm256_unpacklo_ps(r2, r3), t3 = _mm256_unpackhi_ps(r2, r3);
+    __m256 t4 = _mm256_unpacklo_ps(r4, r5), t5 = _mm256_unpackhi_ps(r4, r5);
+    __m256 t6 = _mm256_unpacklo_ps(r6, r7), t7 = _mm256_unpackhi_ps(r6, r7);
+
+    __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+    // straight-line stores: an array + loop here gets spilled and copied through the stack
+    if(acc) {
+        _mm256_storeu_ps(dst + 0 * ldd, _mm256_add_ps(_mm256_loadu_ps(dst + 0 * ldd),
+                                                      _mm256_permute2f128_ps(s0, s4, 0x20)));
+        _mm256_storeu_ps(dst + 1 * ldd, _mm256_add_ps(_mm256_loadu_ps(dst + 1 * ldd),
+                                                      _mm256_permute2f128_ps(s1, s5, 0x20)));
+        _mm256_storeu_ps(dst + 2 * ldd, _mm256_add_ps(_mm256_loadu_ps(dst + 2 * ldd),
+                                                      _mm256_permute2f128_ps(s2, s6, 0x20)));
+        _mm256_storeu_ps(dst + 3 * ldd, _mm256_add_ps(_mm256_loadu_ps(dst + 3 * ldd),
+                                                      _mm256_permute2f128_ps(s3, s7, 0x20)));
+        _mm256_storeu_ps(dst + 4 * ldd, _mm256_add_ps(_mm256_loadu_ps(dst + 4 * ldd),
+                                                      _mm256_permute2f128_ps(s0, s4, 0x31)));
+        _mm256_storeu_ps(dst + 5 * ldd, _mm256_add_ps(_mm256_loadu_ps(dst + 5 * ldd),
+                                                      _mm256_permute2f128_ps(s1, s5, 0x31)));
+        _mm256_storeu_ps(dst + 6 * ldd, _mm256_add_ps(_mm256_loadu_ps(dst + 6 * ldd),
+                                                      _mm256_permute2f128_ps(s2, s6, 0x31)));
+        _mm256_storeu_ps(dst + 7 * ldd, _mm256_add_ps(_mm256_loadu_ps(dst + 7 * ldd),
+                                                      _mm256_permute2f128_ps(s3, s7, 0x31)));
+        return;
+    }
+    _mm256_storeu_ps(dst + 0 * ldd, _mm256_permute2f128_ps(s0, s4, 0x20));
+    _mm256_storeu_ps(dst + 1 * ldd, _mm256_permute2f128_ps(s1, s5, 0x20));
+    _mm256_storeu_ps(dst + 2 * ldd, _mm256_permute2f128_ps(s2, s6, 0x20));
+    _mm256_storeu_ps(dst + 3 * ldd, _mm256_permute2f128_ps(s3, s7, 0x20));
+    _mm256_storeu_ps(dst + 4 * ldd, _mm256_permute2f128_ps(s0, s4, 0x31));
+    _mm256_storeu_ps(dst + 5 * ldd, _mm256_permute2f128_ps(s1, s5, 0x31));
+    _mm256_storeu_ps(dst + 6 * ldd, _mm256_permute2f128_ps(s2, s6, 0x31));
+    _mm256_storeu_ps(dst + 7 * ldd, _mm256_permute2f128_ps(s3, s7, 0x31));
+}
+
+// a rows x cols block (see pico_transpose_f32_scalar) as 8x8 tiles, scalar at the ragged
+// right and bottom edges
+__attribute__((target("avx2"))) static inline void pico_transpose_f32_avx2(const float* src,
+                                                                           int64_t lds,
+                                                                           float* dst,
+                                                                           int64_t ldd,
+                                                                           int64_t rows,
+                                                                           int64_t cols,
+                                                                           bool acc) {
+    int64_t rows8 = rows & ~(int64_t)7;
+    int64_t cols8 = cols & ~(int64_t)7;
+    for(int64_t i = 0; i < rows8; i += 8)
+        for(int64_t j = 0; j < cols8; j += 8)
+            pico_transpose_8x8_avx2(src + i * lds + j, lds, dst + j * ldd + i, ldd, acc);
+    if(cols8 < cols)
+        pico_transpose_f32_scalar(src + cols8, lds, dst + cols8 * ldd, ldd, rows8, cols - cols8,
+                                  acc);
+    if(rows8 < rows)
+        pico_transpose_f32_scalar(src + rows8 * lds, lds, dst + rows8, ldd, rows - rows8, cols,
+                                  acc);
+}
+
+// ---- streaming copy ---------------------------------------------------------------------
+
+// memcpy through non-temporal stores: dst goes straight out to memory instead of being
+// read into cache first and evicting everything else, for outputs too big to stay cached
+// anyway. the stores are weakly ordered, the caller issues one _mm_sfence when it's done
+__attribute__((target("avx2"))) static inline void pico_copy_stream_avx2(void* dst,
+                                                                         const void* src,
+                                                                         size_t bytes) {
+    char* d = (char*)dst;
+    const char* s = (const char*)src;
+    size_t head = (32 - ((uintptr_t)d & 31)) & 31;  // up to the first aligned store
+    if(head > bytes) head = bytes;
+    memcpy(d, s, head);
+    d += head;
+    s += head;
+    bytes -= head;
+    for(; bytes >= 128; bytes -= 128, d += 128, s += 128) {
+        __m256i v0 = _mm256_loadu_si256((const __m256i*)(s + 0));
+        __m256i v1 = _mm256_loadu_si256((const __m256i*)(s + 32));
+        __m256i v2 = _mm256_loadu_si256((const __m256i*)(s + 64));
+        __m256i v3 = _mm256_loadu_si256((const __m256i*)(s + 96));
+        _mm256_stream_si256((__m256i*)(d + 0), v0);
+        _mm256_stream_si256((__m256i*)(d + 32), v1);
+        _mm256_stream_si256((__m256i*)(d + 64), v2);
+        _mm256_stream_si256((__m256i*)(d + 96), v3);
+    }
+    for(; bytes >= 32; bytes -= 32, d += 32, s += 32)
+        _mm256_stream_si256((__m256i*)d, _mm256_loadu_si256((const __m256i*)s));
+    memcpy(d, s, bytes);
+}
+
+// ---- depthwise conv ---------------------------------------------------------------------
+
+// pico_depthwise_scalar 8 channels at a time, each vector accumulating all k x k taps in
+// a register before its one store; the scalar loop takes the last c % 8 channels
+__attribute__((target("avx2,fma"))) static inline void pico_depthwise_avx2(
+    const float* x, const float* w, const float* bias, float* y, const struct PicoConvShape* s,
+    bool relu, int64_t start, int64_t end) {
+    int64_t c8 = s->c & ~(int64_t)7;
+    for(int64_t r = start; r < end; r++) {
+        int64_t oh = r % s->oh, n = r / s->oh;
+        for(int64_t ow = 0; ow < s->ow; ow++) {
+            float* out = y + (r * s->ow + ow) * s->c;
+            for(int64_t c = 0; c < c8; c += 8) {
+                __m256 acc = bias != NULL ? _mm256_loadu_ps(bias + c) : _mm256_setzero_ps();
+                for(int64_t kh = 0; kh < s->k; kh++) {
+                    int64_t ih = oh * s->stride - s->pad + kh * s->dilation;
+                    if(ih < 0 || ih >= s->h) continue;
+                    const float* row = x + (n * s->h + ih) * s->w * s->c + c;
+                    const float* wk = w + kh * s->k * s->c + c;
+                    for(int64_t kw = 0; kw < s->k; kw++) {
+                        int64_t iw = ow * s->stride - s->pad + kw * s->dilation;
+                        if(iw < 0 || iw >= s->w) continue;
+                        acc = _mm256_fmadd_ps(_mm256_loadu_ps(row + iw * s->c),
+                                              _mm256_loadu_ps(wk + kw * s->c), acc);
+                    }
+                }
+                if(relu) acc = _mm256_max_ps(acc, _mm256_setzero_ps());
+                _mm256_storeu_ps(out + c, acc);
+            }
+        }
+        if(c8 < s->c) pico_depthwise_scalar(x, w, bias, y, s, relu, r, r + 1, c8, s->c);
+    }
+}
+
+// ---- winograd conv ----------------------------------------------------------------------
+// the tile transforms of pico_winograd_input_scalar / _output_scalar on 8 channels per
+// vector, scalar for the last c % 8
+
+__attribute__((target("avx2"))) static inline void pico_winograd_input_avx2(
+    const float* x, float* v, const struct PicoConvShape* s, int64_t start, int64_t end) {
+    int64_t tiles = pico_winograd_tiles(s);
+    int64_t c8 = s->c & ~(int64_t)7;
+    int64_t plane = tiles * s->c;  // floats between two of the 16 v matrices
+    for(int64_t t = start; t < end; t++) {
+        int64_t oh0, ow0;
+        int64_t n = pico_winograd_tile(s, t, &oh0, &ow0);
+        int64_t ih0 = oh0 - s->pad, iw0 = ow0 - s->pad;
+        const float* src[4][4];  // the tile's 16 pixels, NULL in the padding
+        for(int i = 0; i < 4; i++) {
+            for(int j = 0; j < 4; j++) {
+                int64_t ih = ih0 + i, iw = iw0 + j;
+                bool in = ih >= 0 && ih < s->h && iw >= 0 && iw < s->w;
+                src[i][j] = in ? x + ((n * s->h + ih) * s->w + iw) * s->c : NULL;
+            }
+        }
+        for(int64_t c = 0; c < c8; c += 8) {
+            __m256 b[4][4];
+            for(int j = 0; j < 4; j++) {
+                __m256 d0 = src[0][j] ? _mm256_loadu_ps(src[0][j] + c) : _mm256_setzero_ps();
+                __m256 d1 = src[1][j] ? _mm256_loadu_ps(src[1][j] + c) : _mm256_setzero_ps();
+                __m256 d2 = src[2][j] ? _mm256_loadu_ps(src[2][j] + c) : _mm256_setzero_ps();
+                __m256 d3 = src[3][j] ? _mm256_loadu_ps(src[3][j] + c) : _mm256_setzero_ps();
+                b[0][j] = _mm256_sub_ps(d0, d2);
+                b[1][j] = _mm256_add_ps(d1, d2);
+                b[2][j] = _mm256_sub_ps(d2, d1);
+                b[3][j] = _mm256_sub_ps(d1, d3);
+            }
+            for(int i = 0; i < 4; i++) {
+                float* out = v + (i * 4 * tiles + t) * s->c + c;
+                _mm256_storeu_ps(out, _mm256_sub_ps(b[i][0], b[i][2]));
+                _mm256_storeu_ps(out + plane, _mm256_add_ps(b[i][1], b[i][2]));
+                _mm256_storeu_ps(out + 2 * plane, _mm256_sub_ps(b[i][2], b[i][1]));
+                _mm256_storeu_ps(out + 3 * plane, _mm256_sub_ps(b[i][1], b[i][3]));
+            }
+        }
+        if(c8 < s->c) pico_winograd_input_scalar(x, v, s, t, t + 1, c8, s->c);
+    }
+}
+
+__attribute__((target("avx2"))) static inline void pico_winograd_output_avx2(
+    const float* m, const float* bias, float* y, const struct PicoConvShape* s, bool relu,
+    int64_t start, int64_t end) {
+    int64_t tiles = pico_winograd_tiles(s);
+    int64_t o8 = s->oc & ~(int64_t)7;
+    int64_t plane = tiles * s->oc;
+    for(int64_t t = start; t < end; t++) {
+        int64_t oh0, ow0;
+        int64_t n = pico_winograd_tile(s, t, &oh0, &ow0);
+        int rows = oh0 + 1 < s->oh ? 2 : 1, cols = ow0 + 1 < s->ow ? 2 : 1;
+        float* dst = y + ((n * s->oh + oh0) * s->ow + ow0) * s->oc;
+        for(int64_t o = 0; o < o8; o += 8) {
+            const float* in = m + t * s->oc + o;
+            __m256 r[2][4];
+            for(int j = 0; j < 4; j++) {
+                __m256 a0 = _mm256_loadu_ps(in + (0 * 4 + j) * plane);
+                __m256 a1 = _mm256_loadu_ps(in + (1 * 4 + j) * plane);
+                __m256 a2 = _mm256_loadu_ps(in + (2 * 4 + j) * plane);
+                __m256 a3 = _mm256_loadu_ps(in + (3 * 4 + j) * plane);
+                r[0][j] = _mm256_add_ps(_mm256_add_ps(a0, a1), a2);
+                r[1][j] = _mm256_sub_ps(_mm256_sub_ps(a1, a2), a3);
+            }
+            __m256 b = bias != NULL ? _mm256_loadu_ps(bias + o) : _mm256_setzero_ps();
+            for(int i = 0; i < rows; i++) {
+                __m256 y0 = _mm256_add_ps(_mm256_add_ps(r[i][0], r[i][1]), r[i][2]);
+                __m256 y1 = _mm256_sub_ps(_mm256_sub_ps(r[i][1], r[i][2]), r[i][3]);
+                y0 = _mm256_add_ps(y0, b);
+                y1 = _mm256_add_ps(y1, b);
+                if(relu) {
+                    y0 = _mm256_max_ps(y0, _mm256_setzero_ps());
+                    y1 = _mm256_max_ps(y1, _mm256_setzero_ps());
+                }
+                _mm256_storeu_ps(dst + i * s->ow * s->oc + o, y0);
+                if(cols == 2) _mm256_storeu_ps(dst + (i * s->ow + 1) * s->oc + o, y1);
+            }
+        }
+        if(o8 < s->oc) pico_winograd_output_scalar(m, bias, y, s, relu, t, t + 1, o8, s->oc);
+    }
+}
+
+// ---- normalization ----------------------------------------------------------------------
+// see cpu_scalar.h. the Welford stats run 16 lanes (two vectors, for two independent
+// dependency chains), lane l seeing elements l, l + 16, ...: every lane has the same
+// count, so each step's 1 / count is one scalar broadcast. the lanes merge by Chan's
+// rule for equal counts k (mean of the means, M2 = Σ M2_l + k Σ (mean_l - mean)²) and
+// the last n % 16 elements take scalar Welford steps. the rest use masked tails
+
+__attribute__((target("avx2,fma"))) static inline void pico_layernorm_stats_avx2(
+    const float* x, int64_t n, float eps, float* mean, float* rstd) {
+    int64_t n16 = n & ~(int64_t)15;
+    float m = 0.0f, m2 = 0.0f;
+    if(n16 > 0) {
+        __m256 m_a = _mm256_setzero_ps(), m_b = _mm256_setzero_ps();
+        __m256 s_a = _mm256_setzero_ps(), s_b = _mm256_setzero_ps();
+        for(int64_t i = 0, k = 1; i < n16; i += 16, k++) {
+            __m256 inv = _mm256_set1_ps(1.0f / (float)k);
+            __m256 va = _mm256_loadu_ps(x + i), vb = _mm256_loadu_ps(x + i + 8);
+            __m256 da = _mm256_sub_ps(va, m_a), db = _mm256_sub_ps(vb, m_b);
+            m_a = _mm256_fmadd_ps(da, inv, m_a);
+            m_b = _mm256_fmadd_ps(db, inv, m_b);
+            s_a = _mm256_fmadd_ps(da, _mm256_sub_ps(va, m_a), s_a);
+            s_b = _mm256_fmadd_ps(db, _mm256_sub_ps(vb, m_b), s_b);
+        }
+        float lm[16], ls[16];
+        _mm256_storeu_ps(lm, m_a);
+        _mm256_storeu_ps(lm + 8, m_b);
+        _mm256_storeu_ps(ls, s_a);
+        _mm256_storeu_ps(ls + 8, s_b);
+        for(int l = 0; l < 16; l++) m += lm[l];
+        m /= 16.0f;
+        float spread = 0.0f;
+        for(int l = 0; l < 16; l++) {
+            m2 += ls[l];
+            spread += (lm[l] - m) * (lm[l] - m);
+        }
+        m2 += (float)(n16 / 16) * spread;
+    }
+    for(int64_t i = n16; i < n; i++) {
+        float d = x[i] - m;
+        m += d / (float)(i + 1);
+        m2 += d * (x[i] - m);
+    }
+    *mean = m;
+    *rstd = 1.0f / sqrtf(m2 / (float)n + eps);
+}
+
+__attribute__((target("avx2,fma"))) static inline float pico_rmsnorm_rstd_avx2(const float* x,
+                                                                              int64_t n,
+                                                                              float eps) {
+    __m256 a0 = _mm256_setzero_ps(), a1 = _mm256_setzero_ps();
+    int64_t i = 0;
+    for(; i + 16 <= n; i += 16) {
+        __m256 v0 = _mm256_loadu_ps(x + i), v1 = _mm256_loadu_ps(x + i + 8);
+        a0 = _mm256_fmadd_ps(v0, v0, a0);
+        a1 = _mm256_fmadd_ps(v1, v1, a1);
+    }
+    for(; i < n; i += 8) {
+        __m256 v = _mm256_maskload_ps(x + i, pico_avx2_tail_mask(n - i));
+        a0 = _mm256_fmadd_ps(v, v, a0);
+    }
+    return 1.0f / sqrtf(pico_hsum_avx2(_mm256_add_ps(a0, a1)) / (float)n + eps);
+}
+
+__attribute__((target("avx2,fma"))) static inline void pico_norm_apply_row_avx2(
+    const float* x, float mean, float rstd, const float* w, const float* b, float* y, int64_t n) {
+    const __m256 vm = _mm256_set1_ps(mean), vr = _mm256_set1_ps(rstd);
+    const __m256 one = _mm256_set1_ps(1.0f), zero = _mm256_setzero_ps();
+    for(int64_t i = 0; i < n; i += 8) {
+        __m256i mask = pico_avx2_tail_mask(n - i);
+        __m256 t = _mm256_mul_ps(_mm256_sub_ps(_mm256_maskload_ps(x + i, mask), vm), vr);
+        __m256 vw = w != NULL ? _mm256_maskload_ps(w + i, mask) : one;
+        __m256 vb = b != NULL ? _mm256_maskload_ps(b + i, mask) : zero;
+        _mm256_maskstore_ps(y + i, mask, _mm256_fmadd_ps(t, vw, vb));
+    }
+}
+
+__attribute__((target("avx2,fma"))) static inline void pico_norm_bwd_row_avx2(
+    const float* x, const float* dy, const float* w, float mean, float rstd, bool center,
+    float* dx, int64_t n) {
+    const __m256 vm = _mm256_set1_ps(mean), vr = _mm256_set1_ps(rstd);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    __m256 sg = _mm256_setzero_ps(), sgx = _mm256_setzero_ps();
+    for(int64_t i = 0; i < n; i += 8) {
+        __m256i mask = pico_avx2_tail_mask(n - i);
+        __m256 vw = w != NULL ? _mm256_maskload_ps(w + i, mask) : one;
+        __m256 g = _mm256_mul_ps(_mm256_maskload_ps(dy + i, mask), vw);
+        __m256 xh = _mm256_mul_ps(_mm256_sub_ps(_mm256_maskload_ps(x + i, mask), vm), vr);
+        sg = _mm256_add_ps(sg, g);
+        sgx = _mm256_fmadd_ps(g, xh, sgx);
+    }
+    const __m256 a = _mm256_set1_ps(center ? pico_hsum_avx2(sg) / (float)n : 0.0f);
+    const __m256 c = _mm256_set1_ps(pico_hsum_avx2(sgx) / (float)n);
+    for(int64_t i = 0; i < n; i += 8) {
+        __m256i mask = pico_avx2_tail_mask(n - i);
+        __m256 vw = w != NULL ? _mm256_maskload_ps(w + i, mask) : one;
+        __m256 g = _mm256_mul_ps(_mm256_maskload_ps(dy + i, mask), vw);
+        __m256 xh = _mm256_mul_ps(_mm256_sub_ps(_mm256_maskload_ps(x + i, mask), vm), vr);
+        __m256 d = _mm256_fnmadd_ps(xh, c, _mm256_sub_ps(g, a));
+        __m256 r = _mm256_fmadd_ps(d, vr, _mm256_maskload_ps(dx + i, mask));
+        _mm256_maskstore_ps(dx + i, mask, r);
+    }
+}
+
+__attribute__((target("avx2,fma"))) static inline void pico_norm_param_grad_avx2(
+    const float* x, const float* dy, const float* mean, const float* rstd, float* dw, float* db,
+    int64_t rows, int64_t n, int64_t c0, int64_t c1) {
+    for(int64_t j = c0; j < c1; j += 8) {
+        __m256i mask = pico_avx2_tail_mask(c1 - j);
+        __m256 aw = _mm256_setzero_ps(), ab = _mm256_setzero_ps();
+        for(int64_t r = 0; r < rows; r++) {
+            __m256 g = _mm256_maskload_ps(dy + r * n + j, mask);
+            __m256 xh = _mm256_maskload_ps(x + r * n + j, mask);
+            if(mean != NULL) xh = _mm256_sub_ps(xh, _mm256_set1_ps(mean[r]));
+            aw = _mm256_fmadd_ps(g, _mm256_mul_ps(xh, _mm256_set1_ps(rstd[r])), aw);
+            ab = _mm256_add_ps(ab, g);
+        }
+        if(dw != NULL)
+            _mm256_maskstore_ps(dw + j, mask, _mm256_add_ps(_mm256_maskload_ps(dw + j, mask), aw));
+        if(db != NULL)
+            _mm256_maskstore_ps(db + j, mask, _mm256_add_ps(_mm256_maskload_ps(db + j, mask), ab));
+    }
+}
+
+// ---- attention ----------------------------------------------------------------------
+// see cpu_scalar.h. scores take four key rows per pass so each q vector load feeds four
+// FMAs; pv keeps 32 output columns in registers across the whole key block, so acc is
+// read and written once per block instead of once per key. tails are masked
+
+__attribute__((target("avx2,fma"))) static inline void pico_attn_scores_avx2(
+    const float* q, const float* k, const float* mask, float* s, int64_t bc, int64_t d,
+    float scale) {
+    int64_t d8 = d & ~(int64_t)7, c = 0;
+    __m256i tm = pico_avx2_tail_mask(d - d8);
+    for(; c + 4 <= bc; c += 4) {
+        const float* k0 = k + c * d;
+        const float *k1 = k0 + d, *k2 = k1 + d, *k3 = k2 + d;
+        __m256 a0 = _mm256_setzero_ps(), a1 = _mm256_setzero_ps();
+        __m256 a2 = _mm256_setzero_ps(), a3 = _mm256_setzero_ps();
+        for(int64_t j = 0; j < d8; j += 8) {
+            __m256 vq = _mm256_loadu_ps(q + j);
+            a0 = _mm256_fmadd_ps(vq, _mm256_loadu_ps(k0 + j), a0);
+            a1 = _mm256_fmadd_ps(vq, _mm256_loadu_ps(k1 + j), a1);
+            a2 = _mm256_fmadd_ps(vq, _mm256_loadu_ps(k2 + j), a2);
+            a3 = _mm256_fmadd_ps(vq, _mm256_loadu_ps(k3 + j), a3);
+        }
+        if(d8 < d) {
+            __m256 vq = _mm256_maskload_ps(q + d8, tm);
+            a0 = _mm256_fmadd_ps(vq, _mm256_maskload_ps(k0 + d8, tm), a0);
+            a1 = _mm256_fmadd_ps(vq, _mm256_maskload_ps(k1 + d8, tm), a1);
+            a2 = _mm256_fmadd_ps(vq, _mm256_maskload_ps(k2 + d8, tm), a2);
+            a3 = _mm256_fmadd_ps(vq, _mm256_maskload_ps(k3 + d8, tm), a3);
+        }
+        s[c] = scale * pico_hsum_avx2(a0);
+        s[c + 1] = scale * pico_hsum_avx2(a1);
+        s[c + 2] = scale * pico_hsum_avx2(a2);
+        s[c + 3] = scale * pico_hsum_avx2(a3);
+    }
+    for(; c < bc; c++) {
+        const float* kc = k + c * d;
+        __m256 a = _mm256_setzero_ps();
+        for(int64_t j = 0; j < d8; j += 8)
+            a = _mm256_fmadd_ps(_mm256_loadu_ps(q + j), _mm256_loadu_ps(kc + j), a);
+        if(d8 < d)
+            a = _mm256_fmadd_ps(_mm256_maskload_ps(q + d8, tm), _mm256_maskload_ps(kc + d8, tm), a);
+        s[c] = scale * pico_hsum_avx2(a);
+    }
+    if(mask != NULL)
+        for(c = 0; c < bc; c++) s[c] += mask[c];
+}
+
+__attribute__((target("avx2,fma"))) static inline float pico_attn_online_avx2(float* s,
+                                                                             int64_t bc, float* m,
+                                                                             float* l) {
+    const __m256 ninf = _mm256_set1_ps(-INFINITY);
+    __m256 vm = _mm256_set1_ps(*m);
+    for(int64_t c = 0; c < bc; c += 8) {
+        __m256i tm = pico_avx2_tail_mask(bc - c);
+        __m256 v = _mm256_blendv_ps(ninf, _mm256_maskload_ps(s + c, tm), _mm256_castsi256_ps(tm));
+        vm = _mm256_max_ps(vm, v);
+    }
+    float mn = pico_hmax_avx2(vm);
+    const __m256 vmn = _mm256_set1_ps(mn);
+    __m256 sum = _mm256_setzero_ps();
+    for(int64_t c = 0; c < bc; c += 8) {
+        __m256i tm = pico_avx2_tail_mask(bc - c);
+        __m256 e = pico_exp_avx2_ps(_mm256_sub_ps(_mm256_maskload_ps(s + c, tm), vmn));
+        e = _mm256_and_ps(e, _mm256_castsi256_ps(tm));
+        _mm256_maskstore_ps(s + c, tm, e);
+        sum = _mm256_add_ps(sum, e);
+    }
+    float alpha = expf(*m - mn);
+    *l = *l * alpha + pico_hsum_avx2(sum);
+    *m = mn;
+    return alpha;
+}
+
+__attribute__((target("avx2,fma"))) static inline void pico_attn_pv_avx2(const float* p,
+                                                                        const float* v, float* acc,
+                                                                        int64_t bc, int64_t dv,
+                                                                        float alpha) {
+    const __m256 va = _mm256_set1_ps(alpha);
+    int64_t j = 0;
+    for(; j + 32 <= dv; j += 32) {
+        __m256 a0 = _mm256_mul_ps(_mm256_loadu_ps(acc + j), va);
+        __m256 a1 = _mm256_mul_ps(_mm256_loadu_ps(acc + j + 8), va);
+        __m256 a2 = _mm256_mul_ps(_mm256_loadu_ps(acc + j + 16), va);
+        __m256 a3 = _mm256_mul_ps(_mm256_loadu_ps(acc + j + 24), va);
+        for(int64_t c = 0; c < bc; c++) {
+            const float* vc = v + c * dv + j;
+            __m256 vp = _mm256_set1_ps(p[c]);
+            a0 = _mm256_fmadd_ps(vp, _mm256_loadu_ps(vc), a0);
+            a1 = _mm256_fmadd_ps(vp, _mm256_loadu_ps(vc + 8), a1);
+            a2 = _mm256_fmadd_ps(vp, _mm256_loadu_ps(vc + 16), a2);
+            a3 = _mm256_fmadd_ps(vp, _mm256_loadu_ps(vc + 24), a3);
+        }
+        _mm256_storeu_ps(acc + j, a0);
+        _mm256_storeu_ps(acc + j + 8, a1);
+        _mm256_storeu_ps(acc + j + 16, a2);
+        _mm256_storeu_ps(acc + j + 24, a3);
+    }
+    for(; j < dv; j += 8) {
+        __m256i tm = pico_avx2_tail_mask(dv - j);
+        __m256 a = _mm256_mul_ps(_mm256_maskload_ps(acc + j, tm), va);
+        for(int64_t c = 0; c < bc; c++)
+            a = _mm256_fmadd_ps(_mm256_set1_ps(p[c]), _mm256_maskload_ps(v + c * dv + j, tm), a);
+        _mm256_maskstore_ps(acc + j, tm, a);
+    }
+}
+
+__attribute__((target("avx2,fma"))) static inline void pico_attn_outer_avx2(const float* a,
+                                                                           const float* x,
+                                                                           float* out, int64_t bc,
+                                                                           int64_t d) {
+    int64_t d8 = d & ~(int64_t)7;
+    __m256i tm = pico_avx2_tail_mask(d - d8);
+    for(int64_t c = 0; c < bc; c++) {
+        if(a[c] == 0.0f) continue;
+        const __m256 vc = _mm256_set1_ps(a[c]);
+        float* oc = out + c * d;
+        for(int64_t j = 0; j < d8; j += 8)
+            _mm256_storeu_ps(oc + j, _mm256_fmadd_ps(vc, _mm256_loadu_ps(x + j),
+                                                     _mm256_loadu_ps(oc + j)));
+        if(d8 < d) {
+            __m256 r = _mm256_fmadd_ps(vc, _mm256_maskload_ps(x + d8, tm),
+                                       _mm256_maskload_ps(oc + d8, tm));
+            _mm256_maskstore_ps(oc + d8, tm, r);
+        }
+    }
+}
+
+__attribute__((target("avx2,fma"))) static inline void pico_attn_probs_avx2(float* s, int64_t bc,
+                                                                           float lse) {
+    const __m256 vl = _mm256_set1_ps(lse);
+    for(int64_t c = 0; c < bc; c += 8) {
+        __m256i tm = pico_avx2_tail_mask(bc - c);
+        __m256 e = pico_exp_avx2_ps(_mm256_sub_ps(_mm256_maskload_ps(s + c, tm), vl));
+        _mm256_maskstore_ps(s + c, tm, e);
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <stdint.h>
+
+#include "global.h"
+#include "tpool.h"
+
+// parallel-for over a flat index range on global_tp. the matmul splits rows by hand
+// (cpu_avx.h); element-wise kernels only need [start, end) slices, so they share this.
+//
+// [0, n) is cut into at most PICO_PARALLEL_MAX_CHUNKS slices of >= min_chunk elements.
+// slices of 16+ are rounded to a multiple of 16 so every thread sees whole AVX-512
+// vectors (and never shares a cache line with its neighbour's output); coarse units
+// like reduction rows stay unrounded. the calling thread runs slice 0 itself, then
+// waits on the pool.
+//
+// runs inline (no threads) when n is too small to split, when pico_init() hasn't made
+// a pool, or when queuing fails. NOT reentrant: calling it from inside a pool job
+// would wait on its own job.
+
+#ifndef PICO_PARALLEL_MAX_CHUNKS
+#define PICO_PARALLEL_MAX_CHUNKS 8
+#endif
+
+typedef void (*PicoRangeFn)(void* ctx, int64_t start, int64_t end);
+
+struct PicoParallelSlice {
+    PicoRangeFn fn;
+    void* ctx;
+    int64_t start;  // inclusive
+    int64_t end;    // exclusive
+};
+
+static inline void pico_parallel_slice_entry(void* arg) {
+    struct PicoParallelSlice* s = (struct PicoParallelSlice*)arg;
+    s->fn(s->ctx, s->start, s->end);
+}
+
+// the slice length pico_parallel_for(n, min_chunk, ...) cuts [0, n) into, n when it
+// runs inline. slice s starts at s * per, so a job that hands each slice its own
+// scratch finds it at start / per
+static inline int64_t pico_parallel_slice_len(int64_t n, int64_t min_chunk) {
+    int64_t chunks = min_chunk > 0 ? n / min_chunk : 1;
+    if(chunks > PICO_PARALLEL_MAX_CHUNKS)
+        chunks = PICO_PARALLEL_MAX_CHUNKS;
+    if(chunks <= 1 || global_tp == NULL)
+        return n > 0 ? n : 1;
+    int64_t per = (n + chunks - 1) / chunks;
+    if(per >= 16)
+        per = (per + 15) & ~(int64_t)15;
+    return per;
+}
+
+static inline void pico_parallel_for(int64_t n, int64_t min_chunk, PicoRangeFn fn, void* ctx) {
+    int64_t per = pico_parallel_slice_len(n, min_chunk);
+    if(per >= n) {
+        fn(ctx, 0, n);
+        return;
+    }
+
+    // slices live on this stack frame: safe because we wait before returning
+    struct PicoParallelSlice slices[PICO_PARALLEL_MAX_CHUNKS];
+    int count = 0;
+    for(int64_t start = 0; start < n; start += per) {
+        slices[count].fn = fn;
+        slices[count].ctx = ctx;
+        slices[count].start = start;
+        slices[count].end = start + per < n ? start + per : n;
+        count++;
+    }
+
+    for(int s = 1; s < count; s++) {
+        if(!pico_tpool_add_work(global_tp, pico_parallel_slice_entry, &slices[s]))
+            pico_parallel_slice_entry(&slices[s]);
+    }
+    pico_parallel_slice_entry(&slices[0]);
+    pico_tpool_wait(global_tp);
+}
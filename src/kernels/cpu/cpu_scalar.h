@@ -2,6 +2,8 @@
 
 #include <math.h>
 
+#include "kernels/conv.h"
+#include "kernels/epilogue.h"
 #include "tensor.h"
 
 // scalar (no SIMD) element-wise add with broadcasting.
@@ -25,16 +27,81 @@
         }                                                                   \
     }
 
+// fused three-input chains (a*b + c, relu(a*b + c), ...). same idea as the binary
+// macro, one more map_index: every input is read ONCE, the result is written ONCE,
+// and the intermediates (a*b) never touch memory. a new fused chain = 1 line here.
+#define PICO_DEFINE_TERNARY_SCALAR_OP(name, EXPR)                                             \
+    static inline void name(struct PicoTensor* a, struct PicoTensor* b, struct PicoTensor* c, \
+                            struct PicoTensor* out) {                                         \
+        for(int64_t i = 0; i < out->numel; i++) {                                             \
+            int64_t ia = map_index(i, a, out->strides, out->ndim);                            \
+            int64_t ib = map_index(i, b, out->strides, out->ndim);                            \
+            int64_t ic = map_index(i, c, out->strides, out->ndim);                            \
+            out->data[i] = EXPR;                                                              \
+        }                                                                                     \
+    }
+
+// x * sigmoid(x) folded into one expression: x / (1 + e^-x). no sigmoid tensor.
+static inline float pico_silu_f32(float x) {
+    return x / (1.0f + expf(-x));
+}
+
+// activations work on flat [0, n) slices instead of tensors so the dispatcher can hand
+// each thread its own slice (see cpu_parallel.h). forward: y = FWD(x). backward uses
+// the SAVED OUTPUT only: dx += dy * DERIV(y), no recomputing sigmoid/tanh from x.
+#define PICO_DEFINE_ACT_SCALAR(name, FWD, DERIV)                                     \
+    static inline void name##_fwd_scalar(const float* x, float* y, int64_t n) {      \
+        for(int64_t i = 0; i < n; i++) {                                             \
+            y[i] = FWD(x[i]);                                                        \
+        }                                                                            \
+    }                                                                                \
+    static inline void name##_bwd_scalar(const float* y, const float* dy, float* dx, \
+                                         int64_t n) {                                \
+        for(int64_t i = 0; i < n; i++) {                                             \
+            dx[i] += dy[i] * DERIV(y[i]);                                            \
+        }                                                                            \
+    }
+
+static inline float pico_relu_f32(float x) {
+    return x > 0.0f ? x : 0.0f;
+}
+
+static inline float pico_relu_deriv_f32(float y) {
+    return y > 0.0f ? 1.0f : 0.0f;
+}
+
+static inline float pico_sigmoid_f32(float x) {
+    return 1.0f / (1.0f + expf(-x));
+}
+
+static inline float pico_sigmoid_deriv_f32(float y) {
+    return y * (1.0f - y);
+}
+
+static inline float pico_tanh_deriv_f32(float y) {
+    return 1.0f - y * y;
+}
+
 PICO_DEFINE_BINARY_SCALAR_OP(pico_add_cpu_scalar, a->data[ia] + b->data[ib])
 PICO_DEFINE_BINARY_SCALAR_OP(pico_sub_cpu_scalar, a->data[ia] - b->data[ib])
 PICO_DEFINE_BINARY_SCALAR_OP(pico_mul_cpu_scalar, a->data[ia] * b->data[ib])
 
 PICO_DEFINE_UNARY_SCALAR_OP(pico_sqrt_cpu_scalar, sqrtf)
-PICO_DEFINE_UNARY_SCALAR_OP(pico_sin_cpu_scalar, sin)
-PICO_DEFINE_UNARY_SCALAR_OP(pico_cos_cpu_scalar, cos)
-PICO_DEFINE_UNARY_SCALAR_OP(pico_tan_cpu_scalar, tan)
-PICO_DEFINE_UNARY_SCALAR_OP(pico_tanh_cpu_scalar, tanh)
+PICO_DEFINE_UNARY_SCALAR_OP(pico_sin_cpu_scalar, sinf)
+PICO_DEFINE_UNARY_SCALAR_OP(pico_cos_cpu_scalar, cosf)
+PICO_DEFINE_UNARY_SCALAR_OP(pico_tan_cpu_scalar, tanf)
+PICO_DEFINE_UNARY_SCALAR_OP(pico_tanh_cpu_scalar, tanhf)
 PICO_DEFINE_UNARY_SCALAR_OP(pico_log_cpu_scalar, logf)
+PICO_DEFINE_UNARY_SCALAR_OP(pico_exp_cpu_scalar, expf)
+PICO_DEFINE_UNARY_SCALAR_OP(pico_silu_cpu_scalar, pico_silu_f32)
+
+PICO_DEFINE_ACT_SCALAR(pico_relu, pico_relu_f32, pico_relu_deriv_f32)
+PICO_DEFINE_ACT_SCALAR(pico_sigmoid, pico_sigmoid_f32, pico_sigmoid_deriv_f32)
+PICO_DEFINE_ACT_SCALAR(pico_tanh, tanhf, pico_tanh_deriv_f32)
+
+PICO_DEFINE_TERNARY_SCALAR_OP(pico_mul_add_cpu_scalar, a->data[ia] * b->data[ib] + c->data[ic])
+PICO_DEFINE_TERNARY_SCALAR_OP(pico_mul_add_relu_cpu_scalar,
+                              MAX(a->data[ia] * b->data[ib] + c->data[ic], 0.0f))
 
 static inline void pico_matmul_cpu_scalar(struct PicoTensor* a, struct PicoTensor* b,
                                           struct PicoTensor* out) {
@@ -52,3 +119,879 @@ static inline void pico_matmul_cpu_scalar(struct PicoTensor* a, struct PicoTenso
         }
     }
 }
+
+// same i-k-j loop, plus the epilogue applied to row i right after it's finished —
+// the row was just written, so it's still in L1 (the "tile" of the scalar path).
+static inline void pico_matmul_epilogue_cpu_scalar(struct PicoTensor* a, struct PicoTensor* b,
+                                                   struct PicoTensor* out,
+                                                   const struct PicoMatmulEpilogue* epi) {
+    int rows = a->shape[0];
+    int columns = b->shape[1];
+    int k_dim = a->shape[1];
+
+    for(int i = 0; i < rows; i++) {
+        for(int k = 0; k < k_dim; k++) {
+            float m_cell = a->data[i * a->strides[0] + k * a->strides[1]];
+            for(int j = 0; j < columns; j++) {
+                out->data[i * out->strides[0] + j * out->strides[1]] +=
+                    m_cell * b->data[k * b->strides[0] + j * b->strides[1]];
+            }
+        }
+        if(epi != NULL) {
+            for(int j = 0; j < columns; j++) {
+                float* cell = &out->data[i * out->strides[0] + j * out->strides[1]];
+                *cell = pico_epilogue_apply_f32(epi, *cell, j);
+            }
+        }
+    }
+}
+
+// ---- reductions -------------------------------------------------------------
+// two shapes of reduction, both on contiguous memory (see pico_reduce_ori_cpu):
+//   row: n contiguous floats -> 1   (reducing the innermost axis)
+//   col: R rows of ncols floats, row stride ld -> ncols   (reducing an outer axis)
+// sums are compensated: rows are pairwise (split in half down to a block, 8
+// independent accumulators inside), cols are Kahan per column. max/argmax propagate
+// NaN (first NaN wins) and return the FIRST index on ties.
+
+#define PICO_REDUCE_PAIRWISE_BLOCK 256  // floats summed straight before splitting
+#define PICO_REDUCE_COL_TILE 1024       // max ncols per col call (stack scratch)
+
+static inline float pico_sum_row_scalar(const float* x, int64_t n) {
+    if(n > PICO_REDUCE_PAIRWISE_BLOCK) {
+        int64_t half = (n / 2) & ~(int64_t)7;
+        return pico_sum_row_scalar(x, half) + pico_sum_row_scalar(x + half, n - half);
+    }
+    float acc[8] = {0};
+    int64_t i = 0;
+    for(; i + 8 <= n; i += 8) {
+        for(int k = 0; k < 8; k++) acc[k] += x[i + k];
+    }
+    float tail = 0.0f;
+    for(; i < n; i++) tail += x[i];
+    return ((acc[0] + acc[1]) + (acc[2] + acc[3])) + ((acc[4] + acc[5]) + (acc[6] + acc[7])) + tail;
+}
+
+static inline float pico_max_row_scalar(const float* x, int64_t n) {
+    float m = x[0];
+    for(int64_t i = 0; i < n; i++) {
+        if(isnan(x[i])) return x[i];
+        if(x[i] > m) m = x[i];
+    }
+    return m;
+}
+
+static inline int64_t pico_argmax_row_scalar(const float* x, int64_t n) {
+    int64_t best = 0;
+    for(int64_t i = 0; i < n; i++) {
+        if(isnan(x[i])) return i;
+        if(x[i] > x[best]) best = i;
+    }
+    return best;
+}
+
+static inline void pico_sum_cols_scalar(const float* x, float* y, int64_t R, int64_t ld,
+                                        int64_t ncols) {
+    float comp[PICO_REDUCE_COL_TILE];
+    for(int64_t j = 0; j < ncols; j++) {
+        y[j] = 0.0f;
+        comp[j] = 0.0f;
+    }
+    for(int64_t r = 0; r < R; r++) {
+        const float* row = x + r * ld;
+        for(int64_t j = 0; j < ncols; j++) {
+            float v = row[j] - comp[j];
+            float t = y[j] + v;
+            comp[j] = (t - y[j]) - v;
+            y[j] = t;
+        }
+    }
+}
+
+static inline void pico_max_cols_scalar(const float* x, float* y, int64_t R, int64_t ld,
+                                        int64_t ncols) {
+    for(int64_t j = 0; j < ncols; j++) y[j] = x[j];
+    for(int64_t r = 1; r < R; r++) {
+        const float* row = x + r * ld;
+        for(int64_t j = 0; j < ncols; j++) {
+            if(isnan(y[j])) continue;
+            if(isnan(row[j]) || row[j] > y[j]) y[j] = row[j];
+        }
+    }
+}
+
+// y gets the index along R, as float
+static inline void pico_argmax_cols_scalar(const float* x, float* y, int64_t R, int64_t ld,
+                                           int64_t ncols) {
+    float best[PICO_REDUCE_COL_TILE];
+    for(int64_t j = 0; j < ncols; j++) {
+        best[j] = x[j];
+        y[j] = 0.0f;
+    }
+    for(int64_t r = 1; r < R; r++) {
+        const float* row = x + r * ld;
+        for(int64_t j = 0; j < ncols; j++) {
+            if(isnan(best[j])) continue;
+            if(isnan(row[j]) || row[j] > best[j]) {
+                best[j] = row[j];
+                y[j] = (float)r;
+            }
+        }
+    }
+}
+
+// ---- softmax ----------------------------------------------------------------
+// everything softmax / cross-entropy needs, on one contiguous row of n:
+//   logsumexp  max + log(sum exp(x - max)) in ONE online pass: the running sum is
+//              rescaled by exp(old_max - new_max) whenever the max moves
+//   accum      y += scale * exp(x - lse)   (softmax itself, or the CE gradient)
+//   bwd        dx += y * (dy - dot(dy, y))  (the Jacobian-vector product, no Jacobian)
+
+static inline float pico_logsumexp_row_scalar(const float* x, int64_t n) {
+    float m = -INFINITY;
+    float s = 0.0f;
+    for(int64_t i = 0; i < n; i++) {
+        if(x[i] > m) {
+            s = s * expf(m - x[i]) + 1.0f;
+            m = x[i];
+        } else {
+            s += expf(x[i] - m);
+        }
+    }
+    return m + logf(s);
+}
+
+static inline void pico_softmax_accum_row_scalar(const float* x, float lse, float scale, float* y,
+                                                 int64_t n) {
+    for(int64_t i = 0; i < n; i++) y[i] += scale * expf(x[i] - lse);
+}
+
+static inline void pico_softmax_bwd_row_scalar(const float* y, const float* dy, float* dx,
+                                               int64_t n) {
+    float dot = 0.0f;
+    for(int64_t i = 0; i < n; i++) dot += dy[i] * y[i];
+    for(int64_t i = 0; i < n; i++) dx[i] += y[i] * (dy[i] - dot);
+}
+
+// ---- mse --------------------------------------------------------------------
+//   sq_diff_sum  sum (a - b)^2, pairwise like pico_sum_row_scalar
+//   sq_diff      y = (a - b)^2                     (reduction NONE)
+//   mse_bwd      d = scale * dy * (a - b);  da += d,  db -= d
+//                dy == NULL means dy = 1 (MEAN/SUM fold the upstream into scale),
+//                da / db == NULL skips that side
+
+static inline float pico_sq_diff_sum_row_scalar(const float* a, const float* b, int64_t n) {
+    if(n > PICO_REDUCE_PAIRWISE_BLOCK) {
+        int64_t half = (n / 2) & ~(int64_t)7;
+        return pico_sq_diff_sum_row_scalar(a, b, half) +
+               pico_sq_diff_sum_row_scalar(a + half, b + half, n - half);
+    }
+    float acc[8] = {0};
+    int64_t i = 0;
+    for(; i + 8 <= n; i += 8) {
+        for(int k = 0; k < 8; k++) {
+            float d = a[i + k] - b[i + k];
+            acc[k] += d * d;
+        }
+    }
+    float tail = 0.0f;
+    for(; i < n; i++) tail += (a[i] - b[i]) * (a[i] - b[i]);
+    return ((acc[0] + acc[1]) + (acc[2] + acc[3])) + ((acc[4] + acc[5]) + (acc[6] + acc[7])) + tail;
+}
+
+static inline void pico_sq_diff_scalar(const float* a, const float* b, float* y, int64_t n) {
+    for(int64_t i = 0; i < n; i++) y[i] = (a[i] - b[i]) * (a[i] - b[i]);
+}
+
+static inline void pico_mse_bwd_scalar(const float* a, const float* b, const float* dy,
+                                       float scale, float* da, float* db, int64_t n) {
+    for(int64_t i = 0; i < n; i++) {
+        float d = scale * (dy ? dy[i] : 1.0f) * (a[i] - b[i]);
+        if(da) da[i] += d;
+        if(db) db[i] -= d;
+    }
+}
+
+// ---- optimizer steps ----------------------------------------------------------
+// one fused pass per param: each array (param, grad, state) is read once and the
+// param + state written once. the per-step constants come in a PicoOptimStep, built
+// by pico_optim_step (optim/optim.c). every kernel first folds L2 weight decay into
+// the gradient (g' = g + wd_l2 * p); AdamW uses the decoupled `decay` instead.
+// the grad is scaled by grad_scale as it's read (1/K when K micro-batches were
+// accumulated into it), and with zero_grad set each grad element is cleared right
+// after, which saves zero_grad its own sweep over every grad.
+
+struct PicoOptimStep {
+    float lr;
+    float eps;
+    float momentum;    // NAG
+    float alpha;       // RMSProp smoothing
+    float beta1;       // Adam
+    float beta2;       // Adam
+    float wd_l2;       // coupled weight decay, added to the gradient
+    float decay;       // decoupled (AdamW): p *= decay before the update, 1 - lr*wd
+    float step_scale;  // Adam: lr / (1 - beta1^t)
+    float v_scale;     // Adam: 1 / sqrt(1 - beta2^t)
+    float grad_scale;  // g is read as grad_scale * g
+    int zero_grad;     // write 0 to g after reading it
+};
+
+// grad_scale * g[i], cleared behind the read when the step owns zero-grad
+static inline float pico_optim_take_grad_scalar(float* g, int64_t i,
+                                                const struct PicoOptimStep* h) {
+    float gi = g[i];
+    if(h->zero_grad) g[i] = 0.0f;
+    return h->grad_scale * gi;
+}
+
+// p -= lr * g
+static inline void pico_sgd_step_scalar(float* p, float* g, int64_t n,
+                                        const struct PicoOptimStep* h) {
+    for(int64_t i = 0; i < n; i++) p[i] -= h->lr * pico_optim_take_grad_scalar(g, i, h);
+}
+
+// buf = mu*buf + g';  p -= lr * (g' + mu*buf)
+static inline void pico_nag_step_scalar(float* p, float* g, float* buf, int64_t n,
+                                        const struct PicoOptimStep* h) {
+    for(int64_t i = 0; i < n; i++) {
+        float gi = pico_optim_take_grad_scalar(g, i, h) + h->wd_l2 * p[i];
+        float b = h->momentum * buf[i] + gi;
+        buf[i] = b;
+        p[i] -= h->lr * (gi + h->momentum * b);
+    }
+}
+
+// s += g'^2;  p -= lr * g' / (sqrt(s) + eps)
+static inline void pico_adagrad_step_scalar(float* p, float* g, float* s, int64_t n,
+                                            const struct PicoOptimStep* h) {
+    for(int64_t i = 0; i < n; i++) {
+        float gi = pico_optim_take_grad_scalar(g, i, h) + h->wd_l2 * p[i];
+        float si = s[i] + gi * gi;
+        s[i] = si;
+        p[i] -= h->lr * gi / (sqrtf(si) + h->eps);
+    }
+}
+
+// s = alpha*s + (1-alpha)*g'^2;  p -= lr * g' / (sqrt(s) + eps)
+static inline void pico_rmsprop_step_scalar(float* p, float* g, float* s, int64_t n,
+                                            const struct PicoOptimStep* h) {
+    for(int64_t i = 0; i < n; i++) {
+        float gi = pico_optim_take_grad_scalar(g, i, h) + h->wd_l2 * p[i];
+        float si = h->alpha * s[i] + (1.0f - h->alpha) * gi * gi;
+        s[i] = si;
+        p[i] -= h->lr * gi / (sqrtf(si) + h->eps);
+    }
+}
+
+// m = b1*m + (1-b1)*g';  v = b2*v + (1-b2)*g'^2
+// p = decay*p - step_scale * m / (sqrt(v)*v_scale + eps)
+static inline void pico_adam_step_scalar(float* p, float* g, float* m, float* v, int64_t n,
+                                         const struct PicoOptimStep* h) {
+    for(int64_t i = 0; i < n; i++) {
+        float gi = pico_optim_take_grad_scalar(g, i, h) + h->wd_l2 * p[i];
+        float mi = h->beta1 * m[i] + (1.0f - h->beta1) * gi;
+        float vi = h->beta2 * v[i] + (1.0f - h->beta2) * gi * gi;
+        m[i] = mi;
+        v[i] = vi;
+        p[i] = h->decay * p[i] - h->step_scale * mi / (sqrtf(vi) * h->v_scale + h->eps);
+    }
+}
+
+// ---- dtype conversion ---------------------------------------------------------
+// bulk half <-> fp32, the reference for the SIMD converters (and their tails).
+
+static inline void pico_cvt_bf16_to_f32_scalar(const uint16_t* src, float* dst, int64_t n) {
+    for(int64_t i = 0; i < n; i++) dst[i] = pico_bf16_to_f32(src[i]);
+}
+
+static inline void pico_cvt_f32_to_bf16_scalar(const float* src, uint16_t* dst, int64_t n) {
+    for(int64_t i = 0; i < n; i++) dst[i] = pico_f32_to_bf16(src[i]);
+}
+
+static inline void pico_cvt_f16_to_f32_scalar(const uint16_t* src, float* dst, int64_t n) {
+    for(int64_t i = 0; i < n; i++) dst[i] = pico_f16_to_f32(src[i]);
+}
+
+static inline void pico_cvt_f32_to_f16_scalar(const float* src, uint16_t* dst, int64_t n) {
+    for(int64_t i = 0; i < n; i++) dst[i] = pico_f32_to_f16(src[i]);
+}
+
+// ---- int8 GEMM ------------------------------------------------------------------
+// the quantized Linear (nn/qlinear.h): x and W as symmetric int8 in [-127, 127], products
+// summed exactly in int32, so every SIMD level gives bit-identical sums. W is packed
+// column-major (column j contiguous along K) and a tile is MR x NR dot products over K.
+// rows are zero padded to a multiple of PICO_QGEMM_KALIGN and the packed columns / x
+// rows to a multiple of NR / MR, so no kernel has a tail.
+
+#define PICO_QGEMM_MR 2
+#define PICO_QGEMM_NR 4
+#define PICO_QGEMM_KALIGN 64
+
+// max |x[i]|. NaNs are skipped
+static inline float pico_absmax_scalar(const float* x, int64_t n) {
+    float m = 0.0f;
+    for(int64_t i = 0; i < n; i++) m = fmaxf(m, fabsf(x[i]));
+    return m;
+}
+
+// q[i] = x[i] * inv_scale clamped to [-127, 127], rounded to nearest even (NaN -> -127)
+static inline void pico_quantize_s8_scalar(const float* x, int8_t* q, int64_t n,
+                                           float inv_scale) {
+    for(int64_t i = 0; i < n; i++) {
+        float v = fminf(fmaxf(x[i] * inv_scale, -127.0f), 127.0f);
+        q[i] = (int8_t)lrintf(v);
+    }
+}
+
+// acc[r*NR + c] = dot(x row r, W column c) over kp. x rows and W columns are kp apart.
+// w_sum is only needed by the VNNI kernel (see cpu_avx512.h)
+static inline void pico_qgemm_tile_scalar(const int8_t* x, const int8_t* w, const int32_t* w_sum,
+                                          int64_t kp, int32_t* acc) {
+    (void)w_sum;
+    for(int r = 0; r < PICO_QGEMM_MR; r++) {
+        for(int c = 0; c < PICO_QGEMM_NR; c++) {
+            const int8_t* xr = x + r * kp;
+            const int8_t* wc = w + c * kp;
+            int32_t s = 0;
+            for(int64_t k = 0; k < kp; k++) s += (int32_t)xr[k] * (int32_t)wc[k];
+            acc[r * PICO_QGEMM_NR + c] = s;
+        }
+    }
+}
+
+// ---- random numbers ---------------------------------------------------------------
+//
+// Philox4x32-10: a counter-based generator, so the numbers at any position are a pure
+// function of (key, counter) and any thread can produce any slice. one super-block of
+// PICO_RNG_BLOCK floats is PICO_RNG_LANES Philox blocks (counter block + lane) of 4
+// words each, with word w of lane l at out[w * PICO_RNG_LANES + l]: the SIMD kernels
+// store the lanes of a word straight from their registers, no transpose (one zmm, or
+// two ymm).
+
+#define PICO_RNG_LANES 16
+#define PICO_RNG_BLOCK (4 * PICO_RNG_LANES)
+
+#define PICO_PHILOX_M0 0xD2511F53u
+#define PICO_PHILOX_M1 0xCD9E8D57u
+#define PICO_PHILOX_W0 0x9E3779B9u
+#define PICO_PHILOX_W1 0xBB67AE85u
+
+static inline void pico_philox_scalar(uint32_t c[4], uint32_t k0, uint32_t k1) {
+    for(int r = 0; r < 10; r++) {
+        uint64_t p0 = (uint64_t)PICO_PHILOX_M0 * c[0];
+        uint64_t p1 = (uint64_t)PICO_PHILOX_M1 * c[2];
+        uint32_t c0 = (uint32_t)(p1 >> 32) ^ c[1] ^ k0;
+        uint32_t c2 = (uint32_t)(p0 >> 32) ^ c[3] ^ k1;
+        c[0] = c0;
+        c[1] = (uint32_t)p1;
+        c[2] = c2;
+        c[3] = (uint32_t)p0;
+        k0 += PICO_PHILOX_W0;
+        k1 += PICO_PHILOX_W1;
+    }
+}
+
+// 24 random bits -> [0, 1), and -> (0, 1] for the log in Box-Muller
+static inline float pico_rng_u01(uint32_t r) {
+    return (float)(r >> 8) * 0x1p-24f;
+}
+
+static inline float pico_rng_u01_open(uint32_t r) {
+    return (float)((r >> 8) + 1) * 0x1p-24f;
+}
+
+// the 4 words of every lane of super-block `block` (counter low half; a multiple of
+// PICO_RNG_LANES) in `stream` (counter high half)
+static inline void pico_rng_words_scalar(uint64_t seed, uint64_t stream, uint64_t block,
+                                         uint32_t w[PICO_RNG_BLOCK]) {
+    for(int l = 0; l < PICO_RNG_LANES; l++) {
+        uint64_t b = block + (uint64_t)l;
+        uint32_t c[4] = {(uint32_t)b, (uint32_t)(b >> 32), (uint32_t)stream,
+                         (uint32_t)(stream >> 32)};
+        pico_philox_scalar(c, (uint32_t)seed, (uint32_t)(seed >> 32));
+        for(int k = 0; k < 4; k++) w[k * PICO_RNG_LANES + l] = c[k];
+    }
+}
+
+// lo + span * u, u uniform on [0, 1)
+static inline void pico_rng_uniform_scalar(uint64_t seed, uint64_t stream, uint64_t block,
+                                           float lo, float span, float* out) {
+    uint32_t w[PICO_RNG_BLOCK];
+    pico_rng_words_scalar(seed, stream, block, w);
+    for(int i = 0; i < PICO_RNG_BLOCK; i++) out[i] = lo + span * pico_rng_u01(w[i]);
+}
+
+// Box-Muller on words (0, 1) and (2, 3) of each lane: r = sqrt(-2 ln u1) with u1 in
+// (0, 1] (never log(0)), then r cos(2 pi u2) and r sin(2 pi u2)
+static inline void pico_rng_normal_scalar(uint64_t seed, uint64_t stream, uint64_t block,
+                                          float mean, float std, float* out) {
+    uint32_t w[PICO_RNG_BLOCK];
+    pico_rng_words_scalar(seed, stream, block, w);
+    for(int p = 0; p < PICO_RNG_BLOCK; p += 2 * PICO_RNG_LANES) {
+        for(int l = 0; l < PICO_RNG_LANES; l++) {
+            float r = sqrtf(-2.0f * logf(pico_rng_u01_open(w[p + l])));
+            float theta = 2.0f * PI_F * pico_rng_u01(w[p + PICO_RNG_LANES + l]);
+            out[p + l] = mean + std * (r * cosf(theta));
+            out[p + PICO_RNG_LANES + l] = mean + std * (r * sinf(theta));
+        }
+    }
+}
+
+// erfinv(x) for x in (-1, 1): Giles' single-precision approximation ("Approximating the
+// erfinv function", GPU Computing Gems), two polynomials in w = -ln(1 - x^2), split
+// at w = 5. relative error ~4e-7 over the range
+static inline float pico_erfinv_scalar(float x) {
+    float w = -logf((1.0f - x) * (1.0f + x));
+    float p;
+    if(w < 5.0f) {
+        w = w - 2.5f;
+        p = 2.81022636e-08f;
+        p = 3.43273939e-07f + p * w;
+        p = -3.5233877e-06f + p * w;
+        p = -4.39150654e-06f + p * w;
+        p = 0.00021858087f + p * w;
+        p = -0.00125372503f + p * w;
+        p = -0.00417768164f + p * w;
+        p = 0.246640727f + p * w;
+        p = 1.50140941f + p * w;
+    } else {
+        w = sqrtf(w) - 3.0f;
+        p = -0.000200214257f;
+        p = 0.000100950558f + p * w;
+        p = 0.00134934322f + p * w;
+        p = -0.00367342844f + p * w;
+        p = 0.00573950773f + p * w;
+        p = -0.0076224613f + p * w;
+        p = 0.00943887047f + p * w;
+        p = 1.00167406f + p * w;
+        p = 2.83297682f + p * w;
+    }
+    return p * x;
+}
+
+// x[i] = clamp(shift + scale * erfinv(x[i]), lo, hi)
+static inline void pico_erfinv_affine_scalar(float* x, int64_t n, float shift, float scale,
+                                             float lo, float hi) {
+    for(int64_t i = 0; i < n; i++)
+        x[i] = fminf(fmaxf(shift + scale * pico_erfinv_scalar(x[i]), lo), hi);
+}
+
+// ---- strided copy ----
+// a strided view walked as rows of its last dim: shape / strides (in elements, 0 along
+// an expanded dim) are coalesced by the caller, so there's no size-1 dim and no pair of
+// neighbours that could merge. the other side is contiguous. rows [start, end)
+
+static inline int64_t pico_strided_row_offset(int64_t row, const int64_t* shape,
+                                              const int64_t* strides, int ndim) {
+    int64_t off = 0;
+    for(int d = ndim - 2; d >= 0; d--) {
+        off += (row % shape[d]) * strides[d];
+        row /= shape[d];
+    }
+    return off;
+}
+
+// dst[r * n + j] = src[view row r, element j], elements of `elem` (2 or 4) bytes
+static inline void pico_strided_gather_scalar(const void* src, void* dst, const int64_t* shape,
+                                              const int64_t* strides, int ndim, size_t elem,
+                                              int64_t start, int64_t end) {
+    int64_t n = shape[ndim - 1];
+    int64_t s = strides[ndim - 1];
+    for(int64_t r = start; r < end; r++) {
+        int64_t off = pico_strided_row_offset(r, shape, strides, ndim);
+        if(s == 1) {
+            memcpy((char*)dst + r * n * elem, (const char*)src + off * elem, n * elem);
+        } else if(elem == sizeof(float)) {
+            const uint32_t* in = (const uint32_t*)src + off;
+            uint32_t* out = (uint32_t*)dst + r * n;
+            for(int64_t j = 0; j < n; j++) out[j] = in[j * s];
+        } else {
+            const uint16_t* in = (const uint16_t*)src + off;
+            uint16_t* out = (uint16_t*)dst + r * n;
+            for(int64_t j = 0; j < n; j++) out[j] = in[j * s];
+        }
+    }
+}
+
+// the gather's backward: dst[view row r, element j] += src[r * n + j]. an expanded
+// (stride 0) dim makes rows overlap, so those must not be split across threads
+static inline void pico_strided_scatter_add_scalar(const float* src, float* dst,
+                                                   const int64_t* shape, const int64_t* strides,
+                                                   int ndim, int64_t start, int64_t end) {
+    int64_t n = shape[ndim - 1];
+    int64_t s = strides[ndim - 1];
+    for(int64_t r = start; r < end; r++) {
+        float* out = dst + pico_strided_row_offset(r, shape, strides, ndim);
+        const float* in = src + r * n;
+        for(int64_t j = 0; j < n; j++) out[j * s] += in[j];
+    }
+}
+
+// ---- transpose ----
+// dst[j * ldd + i] = src[i * lds + j] for a rows x cols block of src (+= when acc).
+// the 16-bit copy has no accumulate: grads are always fp32
+
+static inline void pico_transpose_f32_scalar(const float* src, int64_t lds, float* dst,
+                                             int64_t ldd, int64_t rows, int64_t cols, bool acc) {
+    for(int64_t i = 0; i < rows; i++) {
+        for(int64_t j = 0; j < cols; j++) {
+            if(acc) dst[j * ldd + i] += src[i * lds + j];
+            else dst[j * ldd + i] = src[i * lds + j];
+        }
+    }
+}
+
+static inline void pico_transpose_u16_scalar(const uint16_t* src, int64_t lds, uint16_t* dst,
+                                             int64_t ldd, int64_t rows, int64_t cols) {
+    for(int64_t i = 0; i < rows; i++)
+        for(int64_t j = 0; j < cols; j++) dst[j * ldd + i] = src[i * lds + j];
+}
+
+// ---- im2col ----
+// row r = (n, oh, ow) of group g's im2col matrix: the k * k * cg inputs under the
+// kernel at that output pixel, (kh, kw, c) order like the weight rows. NHWC makes every
+// (kh, kw) one contiguous run of cg channels; taps in the padding are 0
+
+static inline void pico_im2col_scalar(const float* x, float* col, const struct PicoConvShape* s,
+                                      int64_t g, int64_t start, int64_t end) {
+    int64_t cg = s->c / s->groups;
+    int64_t kcols = s->k * s->k * cg;
+    for(int64_t r = start; r < end; r++) {
+        int64_t ow = r % s->ow, oh = r / s->ow % s->oh, n = r / (s->ow * s->oh);
+        float* out = col + r * kcols;
+        for(int64_t kh = 0; kh < s->k; kh++) {
+            int64_t ih = oh * s->stride - s->pad + kh * s->dilation;
+            for(int64_t kw = 0; kw < s->k; kw++, out += cg) {
+                int64_t iw = ow * s->stride - s->pad + kw * s->dilation;
+                if(ih < 0 || ih >= s->h || iw < 0 || iw >= s->w) {
+                    memset(out, 0, sizeof(float) * cg);
+                    continue;
+                }
+                memcpy(out, x + ((n * s->h + ih) * s->w + iw) * s->c + g * cg,
+                       sizeof(float) * cg);
+            }
+        }
+    }
+}
+
+// the backward: dx += each im2col row scattered back to its taps, images [start, end).
+// rows of one image overlap (neighbouring windows share taps), so an image is one unit
+static inline void pico_col2im_scalar(const float* col, float* dx, const struct PicoConvShape* s,
+                                      int64_t g, int64_t start, int64_t end) {
+    int64_t cg = s->c / s->groups;
+    int64_t kcols = s->k * s->k * cg;
+    for(int64_t r = start * s->oh * s->ow; r < end * s->oh * s->ow; r++) {
+        int64_t ow = r % s->ow, oh = r / s->ow % s->oh, n = r / (s->ow * s->oh);
+        const float* in = col + r * kcols;
+        for(int64_t kh = 0; kh < s->k; kh++) {
+            int64_t ih = oh * s->stride - s->pad + kh * s->dilation;
+            for(int64_t kw = 0; kw < s->k; kw++, in += cg) {
+                int64_t iw = ow * s->stride - s->pad + kw * s->dilation;
+                if(ih < 0 || ih >= s->h || iw < 0 || iw >= s->w) continue;
+                float* out = dx + ((n * s->h + ih) * s->w + iw) * s->c + g * cg;
+                for(int64_t c = 0; c < cg; c++) out[c] += in[c];
+            }
+        }
+    }
+}
+
+// ---- depthwise conv ----
+// groups == c == oc: output channel c is input channel c under its own k x k taps, so
+// a pixel's channels run side by side through the whole kernel (weights [k, k, 1, c]).
+// output rows [start, end) of n * oh, channels [c0, c1); bias may be NULL
+
+static inline void pico_depthwise_scalar(const float* x, const float* w, const float* bias,
+                                         float* y, const struct PicoConvShape* s, bool relu,
+                                         int64_t start, int64_t end, int64_t c0, int64_t c1) {
+    for(int64_t r = start; r < end; r++) {
+        int64_t oh = r % s->oh, n = r / s->oh;
+        for(int64_t ow = 0; ow < s->ow; ow++) {
+            float* out = y + (r * s->ow + ow) * s->c;
+            for(int64_t c = c0; c < c1; c++) out[c] = bias != NULL ? bias[c] : 0.0f;
+            for(int64_t kh = 0; kh < s->k; kh++) {
+                int64_t ih = oh * s->stride - s->pad + kh * s->dilation;
+                if(ih < 0 || ih >= s->h) continue;
+                for(int64_t kw = 0; kw < s->k; kw++) {
+                    int64_t iw = ow * s->stride - s->pad + kw * s->dilation;
+                    if(iw < 0 || iw >= s->w) continue;
+                    const float* in = x + ((n * s->h + ih) * s->w + iw) * s->c;
+                    const float* wk = w + (kh * s->k + kw) * s->c;
+                    for(int64_t c = c0; c < c1; c++) out[c] += in[c] * wk[c];
+                }
+            }
+            if(relu)
+                for(int64_t c = c0; c < c1; c++) out[c] = MAX(out[c], 0.0f);
+        }
+    }
+}
+
+// the backward, both halves walking every (output pixel, tap) pair:
+//   dx += dy * w over images [start, end) (taps of one image overlap)
+//   dw += dy * x over channels [start, end), all pixels (each channel is its own sum)
+static inline void pico_depthwise_dx_scalar(const float* w, const float* dy, float* dx,
+                                            const struct PicoConvShape* s, int64_t start,
+                                            int64_t end) {
+    for(int64_t r = start * s->oh; r < end * s->oh; r++) {
+        int64_t oh = r % s->oh, n = r / s->oh;
+        for(int64_t ow = 0; ow < s->ow; ow++) {
+            const float* g = dy + (r * s->ow + ow) * s->c;
+            for(int64_t kh = 0; kh < s->k; kh++) {
+                int64_t ih = oh * s->stride - s->pad + kh * s->dilation;
+                if(ih < 0 || ih >= s->h) continue;
+                for(int64_t kw = 0; kw < s->k; kw++) {
+                    int64_t iw = ow * s->stride - s->pad + kw * s->dilation;
+                    if(iw < 0 || iw >= s->w) continue;
+                    float* out = dx + ((n * s->h + ih) * s->w + iw) * s->c;
+                    const float* wk = w + (kh * s->k + kw) * s->c;
+                    for(int64_t c = 0; c < s->c; c++) out[c] += g[c] * wk[c];
+                }
+            }
+        }
+    }
+}
+
+static inline void pico_depthwise_dw_scalar(const float* x, const float* dy, float* dw,
+                                            const struct PicoConvShape* s, int64_t start,
+                                            int64_t end) {
+    for(int64_t r = 0; r < s->n * s->oh; r++) {
+        int64_t oh = r % s->oh, n = r / s->oh;
+        for(int64_t ow = 0; ow < s->ow; ow++) {
+            const float* g = dy + (r * s->ow + ow) * s->c;
+            for(int64_t kh = 0; kh < s->k; kh++) {
+                int64_t ih = oh * s->stride - s->pad + kh * s->dilation;
+                if(ih < 0 || ih >= s->h) continue;
+                for(int64_t kw = 0; kw < s->k; kw++) {
+                    int64_t iw = ow * s->stride - s->pad + kw * s->dilation;
+                    if(iw < 0 || iw >= s->w) continue;
+                    const float* in = x + ((n * s->h + ih) * s->w + iw) * s->c;
+                    float* out = dw + (kh * s->k + kw) * s->c;
+                    for(int64_t c = start; c < end; c++) out[c] += g[c] * in[c];
+                }
+            }
+        }
+    }
+}
+
+// ---- winograd conv ----
+// F(2x2, 3x3): a 2x2 output tile from a 4x4 input tile as Y = Aᵀ[(G g Gᵀ) ⊙ (Bᵀ d B)]A,
+// 16 multiplies per (input, output) channel pair where the direct conv takes 36. the
+// ⊙ over channels is 16 GEMMs of [tiles, c] x [c, oc] (pico_conv2d_cpu); the transforms
+// here run per tile over a channel range, NHWC keeping the channels contiguous
+//   Bᵀ = [1 0 -1 0; 0 1 1 0; 0 -1 1 0; 0 1 0 -1]
+//   G  = [1 0 0; 1/2 1/2 1/2; 1/2 -1/2 1/2; 0 0 1]
+//   Aᵀ = [1 1 1 0; 0 1 -1 -1]
+// layouts: u [16][c][oc], v [16][tiles][c], m [16][tiles][oc]
+
+// u = G g Gᵀ for every (c, o) pair [start, end) of the flattened c * oc
+static inline void pico_winograd_weights_scalar(const float* w, float* u, int64_t pairs,
+                                                int64_t start, int64_t end) {
+    for(int64_t p = start; p < end; p++) {
+        float g[3][3], t[4][3];
+        for(int i = 0; i < 9; i++) g[i / 3][i % 3] = w[i * pairs + p];
+        for(int j = 0; j < 3; j++) {
+            t[0][j] = g[0][j];
+            t[1][j] = 0.5f * (g[0][j] + g[1][j] + g[2][j]);
+            t[2][j] = 0.5f * (g[0][j] - g[1][j] + g[2][j]);
+            t[3][j] = g[2][j];
+        }
+        for(int i = 0; i < 4; i++) {
+            u[(i * 4 + 0) * pairs + p] = t[i][0];
+            u[(i * 4 + 1) * pairs + p] = 0.5f * (t[i][0] + t[i][1] + t[i][2]);
+            u[(i * 4 + 2) * pairs + p] = 0.5f * (t[i][0] - t[i][1] + t[i][2]);
+            u[(i * 4 + 3) * pairs + p] = t[i][2];
+        }
+    }
+}
+
+// v = Bᵀ d B for tiles [start, end), channels [c0, c1)
+static inline void pico_winograd_input_scalar(const float* x, float* v,
+                                              const struct PicoConvShape* s, int64_t start,
+                                              int64_t end, int64_t c0, int64_t c1) {
+    int64_t tiles = pico_winograd_tiles(s);
+    for(int64_t t = start; t < end; t++) {
+        int64_t oh0, ow0;
+        int64_t n = pico_winograd_tile(s, t, &oh0, &ow0);
+        int64_t ih0 = oh0 - s->pad, iw0 = ow0 - s->pad;
+        for(int64_t c = c0; c < c1; c++) {
+            float d[4][4], b[4][4];
+            for(int i = 0; i < 4; i++) {
+                for(int j = 0; j < 4; j++) {
+                    int64_t ih = ih0 + i, iw = iw0 + j;
+                    bool in = ih >= 0 && ih < s->h && iw >= 0 && iw < s->w;
+                    d[i][j] = in ? x[((n * s->h + ih) * s->w + iw) * s->c + c] : 0.0f;
+                }
+            }
+            for(int j = 0; j < 4; j++) {
+                b[0][j] = d[0][j] - d[2][j];
+                b[1][j] = d[1][j] + d[2][j];
+                b[2][j] = d[2][j] - d[1][j];
+                b[3][j] = d[1][j] - d[3][j];
+            }
+            for(int i = 0; i < 4; i++) {
+                float* out = v + (i * 4 * tiles + t) * s->c + c;
+                out[0 * tiles * s->c] = b[i][0] - b[i][2];
+                out[1 * tiles * s->c] = b[i][1] + b[i][2];
+                out[2 * tiles * s->c] = b[i][2] - b[i][1];
+                out[3 * tiles * s->c] = b[i][1] - b[i][3];
+            }
+        }
+    }
+}
+
+// y = Aᵀ m A (+ bias, relu) for tiles [start, end), output channels [o0, o1); the
+// half-outside tiles of an odd-sized output drop their extra row / column
+static inline void pico_winograd_output_scalar(const float* m, const float* bias, float* y,
+                                               const struct PicoConvShape* s, bool relu,
+                                               int64_t start, int64_t end, int64_t o0,
+                                               int64_t o1) {
+    int64_t tiles = pico_winograd_tiles(s);
+    for(int64_t t = start; t < end; t++) {
+        int64_t oh0, ow0;
+        int64_t n = pico_winograd_tile(s, t, &oh0, &ow0);
+        for(int64_t o = o0; o < o1; o++) {
+            float a[4][4], r[2][4];
+            for(int k = 0; k < 16; k++) a[k / 4][k % 4] = m[(k * tiles + t) * s->oc + o];
+            for(int j = 0; j < 4; j++) {
+                r[0][j] = a[0][j] + a[1][j] + a[2][j];
+                r[1][j] = a[1][j] - a[2][j] - a[3][j];
+            }
+            float b = bias != NULL ? bias[o] : 0.0f;
+            for(int i = 0; i < 2 && oh0 + i < s->oh; i++) {
+                float yo[2] = {r[i][0] + r[i][1] + r[i][2] + b, r[i][1] - r[i][2] - r[i][3] + b};
+                for(int j = 0; j < 2 && ow0 + j < s->ow; j++) {
+                    y[((n * s->oh + oh0 + i) * s->ow + ow0 + j) * s->oc + o] =
+                        relu ? MAX(yo[j], 0.0f) : yo[j];
+                }
+            }
+        }
+    }
+}
+
+// ---- normalization ----
+// layernorm / rmsnorm on one contiguous row of n:
+//   layernorm stats  Welford's running mean and sum of squared deviations in one pass
+//                    (no E[x²] - E[x]² cancellation), rstd = 1 / sqrt(var + eps)
+//   rmsnorm rstd     1 / sqrt(mean(x²) + eps), the mean taken as 0
+//   apply            y = (x - mean) * rstd * w + b, w / b NULL for none
+//   bwd              dx += rstd * (g - mean(g) - x̂ * mean(g * x̂)), g = dy * w and
+//                    x̂ = (x - mean) * rstd; rmsnorm (center false) drops the mean(g)
+//   param grad       dw[j] += Σ_r dy[r, j] * x̂[r, j], db[j] += Σ_r dy[r, j] for
+//                    columns [c0, c1) of [rows, n]; mean NULL for rmsnorm
+
+static inline void pico_layernorm_stats_scalar(const float* x, int64_t n, float eps, float* mean,
+                                               float* rstd) {
+    float m = 0.0f, m2 = 0.0f;
+    for(int64_t i = 0; i < n; i++) {
+        float d = x[i] - m;
+        m += d / (float)(i + 1);
+        m2 += d * (x[i] - m);
+    }
+    *mean = m;
+    *rstd = 1.0f / sqrtf(m2 / (float)n + eps);
+}
+
+static inline float pico_rmsnorm_rstd_scalar(const float* x, int64_t n, float eps) {
+    float ss = 0.0f;
+    for(int64_t i = 0; i < n; i++) ss += x[i] * x[i];
+    return 1.0f / sqrtf(ss / (float)n + eps);
+}
+
+static inline void pico_norm_apply_row_scalar(const float* x, float mean, float rstd,
+                                              const float* w, const float* b, float* y,
+                                              int64_t n) {
+    for(int64_t i = 0; i < n; i++) {
+        float v = (x[i] - mean) * rstd;
+        if(w != NULL) v *= w[i];
+        if(b != NULL) v += b[i];
+        y[i] = v;
+    }
+}
+
+static inline void pico_norm_bwd_row_scalar(const float* x, const float* dy, const float* w,
+                                            float mean, float rstd, bool center, float* dx,
+                                            int64_t n) {
+    float sg = 0.0f, sgx = 0.0f;
+    for(int64_t i = 0; i < n; i++) {
+        float g = w != NULL ? dy[i] * w[i] : dy[i];
+        sg += g;
+        sgx += g * (x[i] - mean) * rstd;
+    }
+    float a = center ? sg / (float)n : 0.0f, c = sgx / (float)n;
+    for(int64_t i = 0; i < n; i++) {
+        float g = w != NULL ? dy[i] * w[i] : dy[i];
+        dx[i] += rstd * (g - a - (x[i] - mean) * rstd * c);
+    }
+}
+
+static inline void pico_norm_param_grad_scalar(const float* x, const float* dy, const float* mean,
+                                               const float* rstd, float* dw, float* db,
+                                               int64_t rows, int64_t n, int64_t c0, int64_t c1) {
+    for(int64_t r = 0; r < rows; r++) {
+        const float* xr = x + r * n;
+        const float* gr = dy + r * n;
+        float m = mean != NULL ? mean[r] : 0.0f, s = rstd[r];
+        if(dw != NULL)
+            for(int64_t j = c0; j < c1; j++) dw[j] += gr[j] * (xr[j] - m) * s;
+        if(db != NULL)
+            for(int64_t j = c0; j < c1; j++) db[j] += gr[j];
+    }
+}
+
+// ---- attention ----
+// the per-row steps of tiled attention (see pico_attention_cpu), on one query row
+// against a block of bc key / value rows, each row contiguous:
+//   scores   s[c] = scale * q · k[c] (+ mask[c] when mask is given)
+//   online   the online softmax step: m_new = max(m, max(s)), s = exp(s - m_new),
+//            l = l * exp(m - m_new) + Σ s, m = m_new. returns exp(m - m_new), the
+//            factor the running output must be rescaled by. m starts at -FLT_MAX, so
+//            a block of -inf scores gives s = 0 and never inf - inf
+//   pv       acc = alpha * acc + Σ_c p[c] * v[c]
+//   outer    out[c] += a[c] * x for every c (the backward's dK / dV rows)
+//   probs    s = exp(s - lse), the saved logsumexp turning scores back into P
+
+static inline void pico_attn_scores_scalar(const float* q, const float* k, const float* mask,
+                                           float* s, int64_t bc, int64_t d, float scale) {
+    for(int64_t c = 0; c < bc; c++) {
+        const float* kc = k + c * d;
+        float acc = 0.0f;
+        for(int64_t j = 0; j < d; j++) acc += q[j] * kc[j];
+        s[c] = scale * acc + (mask != NULL ? mask[c] : 0.0f);
+    }
+}
+
+static inline float pico_attn_online_scalar(float* s, int64_t bc, float* m, float* l) {
+    float mn = *m;
+    for(int64_t c = 0; c < bc; c++) mn = fmaxf(mn, s[c]);
+    float sum = 0.0f;
+    for(int64_t c = 0; c < bc; c++) {
+        s[c] = expf(s[c] - mn);
+        sum += s[c];
+    }
+    float alpha = expf(*m - mn);
+    *l = *l * alpha + sum;
+    *m = mn;
+    return alpha;
+}
+
+static inline void pico_attn_pv_scalar(const float* p, const float* v, float* acc, int64_t bc,
+                                       int64_t dv, float alpha) {
+    if(alpha != 1.0f)
+        for(int64_t j = 0; j < dv; j++) acc[j] *= alpha;
+    for(int64_t c = 0; c < bc; c++) {
+        const float* vc = v + c * dv;
+        for(int64_t j = 0; j < dv; j++) acc[j] += p[c] * vc[j];
+    }
+}
+
+static inline void pico_attn_outer_scalar(const float* a, const float* x, float* out, int64_t bc,
+                                          int64_t d) {
+    for(int64_t c = 0; c < bc; c++) {
+        if(a[c] == 0.0f) continue;
+        float* oc = out + c * d;
+        for(int64_t j = 0; j < d; j++) oc[j] += a[c] * x[j];
+    }
+}
+
+static inline void pico_attn_probs_scalar(float* s, int64_t bc, float lse) {
+    for(int64_t c = 0; c < bc; c++) s[c] = expf(s[c] - lse);
+}
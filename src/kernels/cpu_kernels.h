@@ -1,18 +1,179 @@
 #pragma once
 
+#include <float.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include "global.h"
 #include "kernels/cpu/cpu_avx.h"
 #include "kernels/cpu/cpu_avx_2.h"
+#include "kernels/cpu/cpu_avx512.h"
+#include "kernels/cpu/cpu_parallel.h"
 #include "kernels/cpu/cpu_scalar.h"
 #include "tensor.h"
 
 // CPU dispatch: pick the kernel variant for the detected SIMD level.
 // g_simd_level is set once by pico_init(); default falls back to scalar so an
-// unknown/unsupported level still computes correctly (just slower).
+// unknown/unsupported level still computes correctly (just slower). a level without its
+// own kernel falls through to the next narrower one (AVX512 -> AVX2 -> AVX).
+
+// dtype conversion. pico_widen_cpu / pico_narrow_cpu convert one tile on the calling
+// thread (kernels call them per PICO_HALF_TILE block so the fp32 copy stays in L1);
+// pico_convert_cpu converts a whole buffer between any two dtypes across global_tp.
+#ifndef PICO_HALF_TILE
+#define PICO_HALF_TILE 512
+#endif
+
+#ifndef PICO_CVT_THREAD_MIN_CHUNK
+#define PICO_CVT_THREAD_MIN_CHUNK (1 << 16)
+#endif
+
+static inline void pico_widen_cpu(const uint16_t* src, PicoDType dtype, float* dst, int64_t n) {
+    switch(g_simd_level) {
+        case SIMD_AVX512:
+            if(dtype == PICO_F16) pico_cvt_f16_to_f32_avx512(src, dst, n);
+            else pico_cvt_bf16_to_f32_avx512(src, dst, n);
+            break;
+        case SIMD_AVX2:
+            if(dtype == PICO_F16) pico_cvt_f16_to_f32_avx2(src, dst, n);
+            else pico_cvt_bf16_to_f32_avx2(src, dst, n);
+            break;
+        default:
+            if(dtype == PICO_F16) pico_cvt_f16_to_f32_scalar(src, dst, n);
+            else pico_cvt_bf16_to_f32_scalar(src, dst, n);
+    }
+}
+
+static inline void pico_narrow_cpu(const float* src, uint16_t* dst, PicoDType dtype, int64_t n) {
+    switch(g_simd_level) {
+        case SIMD_AVX512:
+            if(dtype == PICO_F16) pico_cvt_f32_to_f16_avx512(src, dst, n);
+            else pico_cvt_f32_to_bf16_avx512(src, dst, n);
+            break;
+        case SIMD_AVX2:
+            if(dtype == PICO_F16) pico_cvt_f32_to_f16_avx2(src, dst, n);
+            else pico_cvt_f32_to_bf16_avx2(src, dst, n);
+            break;
+        default:
+            if(dtype == PICO_F16) pico_cvt_f32_to_f16_scalar(src, dst, n);
+            else pico_cvt_f32_to_bf16_scalar(src, dst, n);
+    }
+}
+
+struct PicoConvertJob {
+    const void* src;
+    void* dst;
+    PicoDType src_dtype;
+    PicoDType dst_dtype;
+};
+
+static inline void pico_convert_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoConvertJob* job = (struct PicoConvertJob*)ctx;
+    const float* src32 = (const float*)job->src + start;
+    const uint16_t* src16 = (const uint16_t*)job->src + start;
+    float* dst32 = (float*)job->dst + start;
+    uint16_t* dst16 = (uint16_t*)job->dst + start;
+    int64_t n = end - start;
+
+    if(job->src_dtype == job->dst_dtype) {
+        size_t size = pico_dtype_size(job->src_dtype);
+        memcpy((char*)job->dst + start * size, (const char*)job->src + start * size, n * size);
+    } else if(job->src_dtype == PICO_F32) {
+        pico_narrow_cpu(src32, dst16, job->dst_dtype, n);
+    } else if(job->dst_dtype == PICO_F32) {
+        pico_widen_cpu(src16, job->src_dtype, dst32, n);
+    } else {
+        // bf16 <-> fp16: through fp32, one tile at a time
+        float buf[PICO_HALF_TILE];
+        for(int64_t i = 0; i < n; i += PICO_HALF_TILE) {
+            int64_t m = MIN(PICO_HALF_TILE, n - i);
+            pico_widen_cpu(src16 + i, job->src_dtype, buf, m);
+            pico_narrow_cpu(buf, dst16 + i, job->dst_dtype, m);
+        }
+    }
+}
+
+// dst[i] = src[i] for n elements, converted from src_dtype to dst_dtype
+static inline void pico_convert_cpu(const void* src, PicoDType src_dtype, void* dst,
+                                    PicoDType dst_dtype, int64_t n) {
+    struct PicoConvertJob job = {
+        .src = src, .dst = dst, .src_dtype = src_dtype, .dst_dtype = dst_dtype};
+    pico_parallel_for(n, PICO_CVT_THREAD_MIN_CHUNK, pico_convert_slice, &job);
+}
+
+// t's data as fp32, for kernels without a half path: t itself when it already is fp32,
+// otherwise `tmp` filled in as a copy of t with malloc'd fp32 data (same shape, strides
+// and grad, so gradients written through it land in t). pair with
+// pico_tensor_f32_release; pico_tensor_f32_commit first if the copy was written to.
+static inline struct PicoTensor* pico_tensor_f32_borrow(struct PicoTensor* t,
+                                                        struct PicoTensor* tmp) {
+    if(t->dtype == PICO_F32) return t;
+    *tmp = *t;
+    tmp->dtype = PICO_F32;
+    tmp->data = (float*)malloc(sizeof(float) * t->numel);
+    pico_convert_cpu(t->data16, t->dtype, tmp->data, PICO_F32, t->numel);
+    return tmp;
+}
+
+// narrow a borrowed copy's data back into t
+static inline void pico_tensor_f32_commit(struct PicoTensor* borrowed, struct PicoTensor* t) {
+    if(borrowed != t) pico_convert_cpu(borrowed->data, PICO_F32, t->data16, t->dtype, t->numel);
+}
+
+static inline void pico_tensor_f32_release(struct PicoTensor* borrowed, struct PicoTensor* t) {
+    if(borrowed != t) free(borrowed->data);
+}
+
+// half add / sub / mul: a, b and out share one half dtype and one shape (the op layer
+// widens everything else to fp32 first). each tile of a and b is widened, combined in
+// fp32 and narrowed once into out.
+enum PicoBinaryOp { PICO_BINARY_ADD, PICO_BINARY_SUB, PICO_BINARY_MUL };
+
+struct PicoBinaryHalfJob {
+    enum PicoBinaryOp op;
+    const uint16_t* a;
+    const uint16_t* b;
+    uint16_t* out;
+    PicoDType dtype;
+};
+
+static inline void pico_binary_half_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoBinaryHalfJob* job = (struct PicoBinaryHalfJob*)ctx;
+    float va[PICO_HALF_TILE], vb[PICO_HALF_TILE];
+    for(int64_t i = start; i < end; i += PICO_HALF_TILE) {
+        int64_t n = MIN(PICO_HALF_TILE, end - i);
+        pico_widen_cpu(job->a + i, job->dtype, va, n);
+        pico_widen_cpu(job->b + i, job->dtype, vb, n);
+        switch(job->op) {
+            case PICO_BINARY_ADD:
+                for(int64_t k = 0; k < n; k++) va[k] += vb[k];
+                break;
+            case PICO_BINARY_SUB:
+                for(int64_t k = 0; k < n; k++) va[k] -= vb[k];
+                break;
+            case PICO_BINARY_MUL:
+                for(int64_t k = 0; k < n; k++) va[k] *= vb[k];
+                break;
+        }
+        pico_narrow_cpu(va, job->out + i, job->dtype, n);
+    }
+}
+
+static inline void pico_binary_half_cpu(enum PicoBinaryOp op, struct PicoTensor* a,
+                                        struct PicoTensor* b, struct PicoTensor* out) {
+    struct PicoBinaryHalfJob job = {
+        .op = op, .a = a->data16, .b = b->data16, .out = out->data16, .dtype = out->dtype};
+    pico_parallel_for(out->numel, PICO_CVT_THREAD_MIN_CHUNK, pico_binary_half_slice, &job);
+}
 
 static inline void pico_add_cpu(struct PicoTensor* a, struct PicoTensor* b,
                                 struct PicoTensor* out) {
+    if(out->dtype != PICO_F32) {
+        pico_binary_half_cpu(PICO_BINARY_ADD, a, b, out);
+        return;
+    }
     switch(g_simd_level) {
+        case SIMD_AVX512:
         case SIMD_AVX2:
             pico_add_cpu_avx2_fp32(a, b, out);
             break;
@@ -23,7 +184,12 @@ static inline void pico_add_cpu(struct PicoTensor* a, struct PicoTensor* b,
 
 static inline void pico_sub_cpu(struct PicoTensor* a, struct PicoTensor* b,
                                 struct PicoTensor* out) {
+    if(out->dtype != PICO_F32) {
+        pico_binary_half_cpu(PICO_BINARY_SUB, a, b, out);
+        return;
+    }
     switch(g_simd_level) {
+        case SIMD_AVX512:
         case SIMD_AVX2:
             pico_sub_cpu_avx2_fp32(a, b, out);
             break;
@@ -34,7 +200,12 @@ static inline void pico_sub_cpu(struct PicoTensor* a, struct PicoTensor* b,
 
 static inline void pico_mul_cpu(struct PicoTensor* a, struct PicoTensor* b,
                                 struct PicoTensor* out) {
+    if(out->dtype != PICO_F32) {
+        pico_binary_half_cpu(PICO_BINARY_MUL, a, b, out);
+        return;
+    }
     switch(g_simd_level) {
+        case SIMD_AVX512:
         case SIMD_AVX2:
             pico_mul_cpu_avx2_fp32(a, b, out);
             break;
@@ -43,22 +214,49 @@ static inline void pico_mul_cpu(struct PicoTensor* a, struct PicoTensor* b,
     }
 }
 
-static inline void pico_matmul_cpu(struct PicoTensor* a, struct PicoTensor* b,
-                                   struct PicoTensor* out) {
+// matmul with bias + activation fused into the tile store (see kernels/epilogue.h).
+// any mix of dtypes: the AVX kernels read a half B as stored and widen it in
+// registers; a half A (or B, on the scalar path) is widened up front, and a half out
+// is computed in fp32 and narrowed once at the end. accumulation is always fp32.
+static inline void pico_matmul_epilogue_cpu(struct PicoTensor* a, struct PicoTensor* b,
+                                            struct PicoTensor* out,
+                                            const struct PicoMatmulEpilogue* epi) {
+    struct PicoTensor a_tmp, b_tmp, out_tmp;
+    struct PicoTensor* a32 = pico_tensor_f32_borrow(a, &a_tmp);
+    struct PicoTensor* out32 = pico_tensor_f32_borrow(out, &out_tmp);
     switch(g_simd_level) {
+        case SIMD_AVX512:
+        case SIMD_AVX2:
         case SIMD_AVX:
-            pico_matmul_cpu_avx(a, b, out);
+            pico_matmul_epilogue_cpu_avx(a32, b, out32, epi);
             break;
-        default:
-            pico_matmul_cpu_scalar(a, b, out);
+        default: {
+            struct PicoTensor* b32 = pico_tensor_f32_borrow(b, &b_tmp);
+            pico_matmul_epilogue_cpu_scalar(a32, b32, out32, epi);
+            pico_tensor_f32_release(b32, b);
+        }
     }
+    pico_tensor_f32_commit(out32, out);
+    pico_tensor_f32_release(out32, out);
+    pico_tensor_f32_release(a32, a);
 }
 
-// unary element-wise math. same switch shape as above — ripe for the future
-// pico_op_cpu(a, out, op) bundling once there's more than one SIMD variant.
+static inline void pico_matmul_cpu(struct PicoTensor* a, struct PicoTensor* b,
+                                   struct PicoTensor* out) {
+    pico_matmul_epilogue_cpu(a, b, out, NULL);
+}
+
+// unary element-wise math: polynomial SIMD kernels (error bounds documented in
+// cpu_avx_2.h) at AVX2/AVX-512, libm float functions otherwise.
 
 static inline void pico_sqrt_cpu(struct PicoTensor* a, struct PicoTensor* out) {
     switch(g_simd_level) {
+        case SIMD_AVX512:
+            pico_sqrt_cpu_avx512_fp32(a, out);
+            break;
+        case SIMD_AVX2:
+            pico_sqrt_cpu_avx2_fp32(a, out);
+            break;
         default:
             pico_sqrt_cpu_scalar(a, out);
     }
@@ -66,6 +264,12 @@ static inline void pico_sqrt_cpu(struct PicoTensor* a, struct PicoTensor* out) {
 
 static inline void pico_sin_cpu(struct PicoTensor* a, struct PicoTensor* out) {
     switch(g_simd_level) {
+        case SIMD_AVX512:
+            pico_sin_cpu_avx512_fp32(a, out);
+            break;
+        case SIMD_AVX2:
+            pico_sin_cpu_avx2_fp32(a, out);
+            break;
         default:
             pico_sin_cpu_scalar(a, out);
     }
@@ -73,6 +277,12 @@ static inline void pico_sin_cpu(struct PicoTensor* a, struct PicoTensor* out) {
 
 static inline void pico_cos_cpu(struct PicoTensor* a, struct PicoTensor* out) {
     switch(g_simd_level) {
+        case SIMD_AVX512:
+            pico_cos_cpu_avx512_fp32(a, out);
+            break;
+        case SIMD_AVX2:
+            pico_cos_cpu_avx2_fp32(a, out);
+            break;
         default:
             pico_cos_cpu_scalar(a, out);
     }
@@ -80,21 +290,1770 @@ static inline void pico_cos_cpu(struct PicoTensor* a, struct PicoTensor* out) {
 
 static inline void pico_tan_cpu(struct PicoTensor* a, struct PicoTensor* out) {
     switch(g_simd_level) {
+        case SIMD_AVX512:
+            pico_tan_cpu_avx512_fp32(a, out);
+            break;
+        case SIMD_AVX2:
+            pico_tan_cpu_avx2_fp32(a, out);
+            break;
         default:
             pico_tan_cpu_scalar(a, out);
     }
 }
 
-static inline void pico_tanh_cpu(struct PicoTensor* a, struct PicoTensor* out) {
+static inline void pico_log_cpu(struct PicoTensor* a, struct PicoTensor* out) {
     switch(g_simd_level) {
+        case SIMD_AVX512:
+            pico_log_cpu_avx512_fp32(a, out);
+            break;
+        case SIMD_AVX2:
+            pico_log_cpu_avx2_fp32(a, out);
+            break;
         default:
-            pico_tanh_cpu_scalar(a, out);
+            pico_log_cpu_scalar(a, out);
     }
 }
 
-static inline void pico_log_cpu(struct PicoTensor* a, struct PicoTensor* out) {
+static inline void pico_exp_cpu(struct PicoTensor* a, struct PicoTensor* out) {
     switch(g_simd_level) {
+        case SIMD_AVX512:
+            pico_exp_cpu_avx512_fp32(a, out);
+            break;
+        case SIMD_AVX2:
+            pico_exp_cpu_avx2_fp32(a, out);
+            break;
         default:
-            pico_log_cpu_scalar(a, out);
+            pico_exp_cpu_scalar(a, out);
+    }
+}
+
+// activations (relu / sigmoid / tanh): slice kernels picked per SIMD level, run over
+// [0, numel) with pico_parallel_for once a tensor is big enough for threads to pay off.
+// tanh lives here rather than with the unary math so pico_tensor_tanh gets the same
+// threaded path and the same saved-output backward. half x and y go through the same
+// fp32 kernels one PICO_HALF_TILE at a time: widen, apply, narrow. dy and dx are
+// grads, so always fp32.
+#ifndef PICO_ACT_THREAD_MIN_CHUNK
+#define PICO_ACT_THREAD_MIN_CHUNK (1 << 16)
+#endif
+
+typedef void (*PicoActFwdFn)(const float* x, float* y, int64_t n);
+typedef void (*PicoActBwdFn)(const float* y, const float* dy, float* dx, int64_t n);
+
+struct PicoActJob {
+    PicoActFwdFn fwd;
+    PicoActBwdFn bwd;
+    union {
+        const float* src;  // fwd: x.  bwd: the saved output y
+        const uint16_t* src16;
+    };
+    const float* dy;  // bwd only
+    union {
+        float* dst;  // fwd: y.  bwd: dx (accumulated into)
+        uint16_t* dst16;
+    };
+    PicoDType dtype;  // of x and y
+};
+
+static inline void pico_act_fwd_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoActJob* job = (struct PicoActJob*)ctx;
+    job->fwd(job->src + start, job->dst + start, end - start);
+}
+
+static inline void pico_act_bwd_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoActJob* job = (struct PicoActJob*)ctx;
+    job->bwd(job->src + start, job->dy + start, job->dst + start, end - start);
+}
+
+static inline void pico_act_fwd_half_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoActJob* job = (struct PicoActJob*)ctx;
+    float buf[PICO_HALF_TILE];
+    for(int64_t i = start; i < end; i += PICO_HALF_TILE) {
+        int64_t n = MIN(PICO_HALF_TILE, end - i);
+        pico_widen_cpu(job->src16 + i, job->dtype, buf, n);
+        job->fwd(buf, buf, n);
+        pico_narrow_cpu(buf, job->dst16 + i, job->dtype, n);
+    }
+}
+
+static inline void pico_act_bwd_half_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoActJob* job = (struct PicoActJob*)ctx;
+    float buf[PICO_HALF_TILE];
+    for(int64_t i = start; i < end; i += PICO_HALF_TILE) {
+        int64_t n = MIN(PICO_HALF_TILE, end - i);
+        pico_widen_cpu(job->src16 + i, job->dtype, buf, n);
+        job->bwd(buf, job->dy + i, job->dst + i, n);
+    }
+}
+
+// stamps name_cpu(a, out) and name_backward_cpu(out, a). the backward reads only out's
+// data + grad and accumulates into a->grad. out has a's dtype.
+#define PICO_DEFINE_ACT_DISPATCH(name)                                                          \
+    static inline void name##_cpu(struct PicoTensor* a, struct PicoTensor* out) {               \
+        struct PicoActJob job = {.src = a->data, .dst = out->data, .dtype = a->dtype};          \
+        switch(g_simd_level) {                                                                  \
+            case SIMD_AVX512:                                                                   \
+                job.fwd = name##_fwd_avx512_fp32;                                               \
+                break;                                                                          \
+            case SIMD_AVX2:                                                                     \
+                job.fwd = name##_fwd_avx2_fp32;                                                 \
+                break;                                                                          \
+            default:                                                                            \
+                job.fwd = name##_fwd_scalar;                                                    \
+        }                                                                                       \
+        pico_parallel_for(out->numel, PICO_ACT_THREAD_MIN_CHUNK,                                \
+                          job.dtype == PICO_F32 ? pico_act_fwd_slice : pico_act_fwd_half_slice, \
+                          &job);                                                                \
+    }                                                                                           \
+    static inline void name##_backward_cpu(struct PicoTensor* out, struct PicoTensor* a) {      \
+        struct PicoActJob job = {                                                               \
+            .src = out->data, .dy = out->grad, .dst = a->grad, .dtype = out->dtype};            \
+        switch(g_simd_level) {                                                                  \
+            case SIMD_AVX512:                                                                   \
+                job.bwd = name##_bwd_avx512_fp32;                                               \
+                break;                                                                          \
+            case SIMD_AVX2:                                                                     \
+                job.bwd = name##_bwd_avx2_fp32;                                                 \
+                break;                                                                          \
+            default:                                                                            \
+                job.bwd = name##_bwd_scalar;                                                    \
+        }                                                                                       \
+        pico_parallel_for(out->numel, PICO_ACT_THREAD_MIN_CHUNK,                                \
+                          job.dtype == PICO_F32 ? pico_act_bwd_slice : pico_act_bwd_half_slice, \
+                          &job);                                                                \
+    }
+
+PICO_DEFINE_ACT_DISPATCH(pico_relu)
+PICO_DEFINE_ACT_DISPATCH(pico_sigmoid)
+PICO_DEFINE_ACT_DISPATCH(pico_tanh)
+
+// fused chains (see fused/fused.h). AVX2 kernels read each input once and write the
+// result once; the scalar fallback does the same through map_index.
+
+static inline void pico_mul_add_cpu(struct PicoTensor* a, struct PicoTensor* b,
+                                    struct PicoTensor* c, struct PicoTensor* out) {
+    switch(g_simd_level) {
+        case SIMD_AVX512:
+        case SIMD_AVX2:
+            pico_mul_add_cpu_avx2_fp32(a, b, c, out);
+            break;
+        default:
+            pico_mul_add_cpu_scalar(a, b, c, out);
+    }
+}
+
+static inline void pico_mul_add_relu_cpu(struct PicoTensor* a, struct PicoTensor* b,
+                                         struct PicoTensor* c, struct PicoTensor* out) {
+    switch(g_simd_level) {
+        case SIMD_AVX512:
+        case SIMD_AVX2:
+            pico_mul_add_relu_cpu_avx2_fp32(a, b, c, out);
+            break;
+        default:
+            pico_mul_add_relu_cpu_scalar(a, b, c, out);
+    }
+}
+
+static inline void pico_silu_cpu(struct PicoTensor* a, struct PicoTensor* out) {
+    switch(g_simd_level) {
+        case SIMD_AVX512:
+        case SIMD_AVX2:
+            pico_silu_cpu_avx2_fp32(a, out);
+            break;
+        default:
+            pico_silu_cpu_scalar(a, out);
+    }
+}
+
+// reductions (see reduce/reduce.h). every reduction the op layer asks for is split
+// into passes of one shape: x viewed as [O, R, I] (contiguous), y[o, i] = op over r.
+//   I == 1: each output is a contiguous row of R   -> *_row kernels, threads over O
+//   I  > 1: each output row is a column sweep      -> *_cols kernels on tiles of
+//           PICO_REDUCE_COL_TILE columns, threads over (o, tile) pairs
+enum PicoReduceOp { PICO_REDUCE_SUM, PICO_REDUCE_MAX, PICO_REDUCE_ARGMAX };
+
+#ifndef PICO_REDUCE_THREAD_MIN_ELEMS
+#define PICO_REDUCE_THREAD_MIN_ELEMS (1 << 16)  // input floats per thread slice
+#endif
+
+struct PicoReduceJob {
+    enum PicoReduceOp op;
+    const float* x;
+    float* y;
+    int64_t R;
+    int64_t I;
+    int64_t tiles;  // column tiles per o (I > 1 only)
+};
+
+// argmax has no AVX-512 kernel: that level uses the AVX2 one
+static inline float pico_reduce_row_cpu(enum PicoReduceOp op, const float* x, int64_t n) {
+    switch(g_simd_level) {
+        case SIMD_AVX512:
+            if(op == PICO_REDUCE_SUM) return pico_sum_row_avx512(x, n);
+            if(op == PICO_REDUCE_MAX) return pico_max_row_avx512(x, n);
+            return (float)pico_argmax_row_avx2(x, n);
+        case SIMD_AVX2:
+            if(op == PICO_REDUCE_SUM) return pico_sum_row_avx2(x, n);
+            if(op == PICO_REDUCE_MAX) return pico_max_row_avx2(x, n);
+            return (float)pico_argmax_row_avx2(x, n);
+        default:
+            if(op == PICO_REDUCE_SUM) return pico_sum_row_scalar(x, n);
+            if(op == PICO_REDUCE_MAX) return pico_max_row_scalar(x, n);
+            return (float)pico_argmax_row_scalar(x, n);
+    }
+}
+
+static inline void pico_reduce_cols_cpu(enum PicoReduceOp op, const float* x, float* y, int64_t R,
+                                        int64_t ld, int64_t ncols) {
+    switch(g_simd_level) {
+        case SIMD_AVX512:
+            if(op == PICO_REDUCE_SUM) pico_sum_cols_avx512(x, y, R, ld, ncols);
+            else if(op == PICO_REDUCE_MAX) pico_max_cols_avx512(x, y, R, ld, ncols);
+            else pico_argmax_cols_avx2(x, y, R, ld, ncols);
+            break;
+        case SIMD_AVX2:
+            if(op == PICO_REDUCE_SUM) pico_sum_cols_avx2(x, y, R, ld, ncols);
+            else if(op == PICO_REDUCE_MAX) pico_max_cols_avx2(x, y, R, ld, ncols);
+            else pico_argmax_cols_avx2(x, y, R, ld, ncols);
+            break;
+        default:
+            if(op == PICO_REDUCE_SUM) pico_sum_cols_scalar(x, y, R, ld, ncols);
+            else if(op == PICO_REDUCE_MAX) pico_max_cols_scalar(x, y, R, ld, ncols);
+            else pico_argmax_cols_scalar(x, y, R, ld, ncols);
+    }
+}
+
+static inline void pico_reduce_rows_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoReduceJob* job = (struct PicoReduceJob*)ctx;
+    for(int64_t o = start; o < end; o++) {
+        job->y[o] = pico_reduce_row_cpu(job->op, job->x + o * job->R, job->R);
+    }
+}
+
+static inline void pico_reduce_cols_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoReduceJob* job = (struct PicoReduceJob*)ctx;
+    for(int64_t u = start; u < end; u++) {
+        int64_t o = u / job->tiles;
+        int64_t j = (u % job->tiles) * PICO_REDUCE_COL_TILE;
+        int64_t ncols = MIN(PICO_REDUCE_COL_TILE, job->I - j);
+        pico_reduce_cols_cpu(job->op, job->x + o * job->R * job->I + j, job->y + o * job->I + j,
+                             job->R, job->I, ncols);
+    }
+}
+
+// y[o, i] = op_r x[o, r, i]. y must not alias x
+static inline void pico_reduce_ori_cpu(enum PicoReduceOp op, const float* x, float* y, int64_t O,
+                                       int64_t R, int64_t I) {
+    struct PicoReduceJob job = {.op = op, .x = x, .y = y, .R = R, .I = I};
+    if(I == 1) {
+        pico_parallel_for(O, MAX(1, PICO_REDUCE_THREAD_MIN_ELEMS / R), pico_reduce_rows_slice,
+                          &job);
+        return;
+    }
+    job.tiles = (I + PICO_REDUCE_COL_TILE - 1) / PICO_REDUCE_COL_TILE;
+    int64_t per_unit = R * MIN(I, PICO_REDUCE_COL_TILE);
+    pico_parallel_for(O * job.tiles, MAX(1, PICO_REDUCE_THREAD_MIN_ELEMS / per_unit),
+                      pico_reduce_cols_slice, &job);
+}
+
+// softmax along one axis of x viewed as [O, R, I] (contiguous), over R. each of the
+// O*I rows is handled on its own; with I == 1 a row is contiguous and the kernels run
+// in place, otherwise it's strided by I and gets gathered into per-slice scratch the
+// caller hands in (pico_softmax_scratch_floats). rows are split across global_tp like
+// the reductions.
+#ifndef PICO_SOFTMAX_THREAD_MIN_ELEMS
+#define PICO_SOFTMAX_THREAD_MIN_ELEMS (1 << 14)  // exp-heavy, so smaller than reductions
+#endif
+
+static inline float pico_logsumexp_row_cpu(const float* x, int64_t n) {
+    switch(g_simd_level) {
+        case SIMD_AVX512:
+            return pico_logsumexp_row_avx512(x, n);
+        case SIMD_AVX2:
+            return pico_logsumexp_row_avx2(x, n);
+        default:
+            return pico_logsumexp_row_scalar(x, n);
+    }
+}
+
+// y += scale * exp(x - lse)
+static inline void pico_softmax_accum_row_cpu(const float* x, float lse, float scale, float* y,
+                                              int64_t n) {
+    switch(g_simd_level) {
+        case SIMD_AVX512:
+            pico_softmax_accum_row_avx512(x, lse, scale, y, n);
+            break;
+        case SIMD_AVX2:
+            pico_softmax_accum_row_avx2(x, lse, scale, y, n);
+            break;
+        default:
+            pico_softmax_accum_row_scalar(x, lse, scale, y, n);
+    }
+}
+
+static inline void pico_softmax_bwd_row_cpu(const float* y, const float* dy, float* dx,
+                                            int64_t n) {
+    switch(g_simd_level) {
+        case SIMD_AVX512:
+            pico_softmax_bwd_row_avx512(y, dy, dx, n);
+            break;
+        case SIMD_AVX2:
+            pico_softmax_bwd_row_avx2(y, dy, dx, n);
+            break;
+        default:
+            pico_softmax_bwd_row_scalar(y, dy, dx, n);
+    }
+}
+
+struct PicoSoftmaxJob {
+    const float* x;   // forward: logits           backward: softmax output y
+    const float* dy;  // backward only
+    float* out;       // forward: y (zeroed)       backward: dx
+    float* scratch;   // I > 1: 2R (forward) / 3R (backward) floats per slice
+    int64_t per;      // rows per slice: slice start / per picks its scratch
+    int64_t R;
+    int64_t I;
+};
+
+// floats of scratch pico_softmax_cpu (or, backward, pico_softmax_backward_cpu) needs:
+// none for a contiguous row, else a gathered row or two plus the result, per slice
+static inline int64_t pico_softmax_scratch_floats(int64_t O, int64_t R, int64_t I,
+                                                  bool backward) {
+    if(I == 1) return 0;
+    int64_t n = O * I;
+    int64_t per = pico_parallel_slice_len(n, MAX(1, PICO_SOFTMAX_THREAD_MIN_ELEMS / R));
+    return (n + per - 1) / per * (backward ? 3 : 2) * R;
+}
+
+static inline void pico_softmax_strided_gather(float* dst, const float* src, int64_t R, int64_t I) {
+    for(int64_t r = 0; r < R; r++) dst[r] = src[r * I];
+}
+
+static inline void pico_softmax_fwd_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoSoftmaxJob* job = (struct PicoSoftmaxJob*)ctx;
+    int64_t R = job->R, I = job->I;
+    if(I == 1) {
+        for(int64_t row = start; row < end; row++) {
+            const float* x = job->x + row * R;
+            float lse = pico_logsumexp_row_cpu(x, R);
+            pico_softmax_accum_row_cpu(x, lse, 1.0f, job->out + row * R, R);
+        }
+        return;
+    }
+    float* buf = job->scratch + start / job->per * 2 * R;
+    for(int64_t row = start; row < end; row++) {
+        int64_t base = (row / I) * R * I + row % I;
+        pico_softmax_strided_gather(buf, job->x + base, R, I);
+        memset(buf + R, 0, sizeof(float) * R);
+        pico_softmax_accum_row_cpu(buf, pico_logsumexp_row_cpu(buf, R), 1.0f, buf + R, R);
+        for(int64_t r = 0; r < R; r++) job->out[base + r * I] = buf[R + r];
+    }
+}
+
+static inline void pico_softmax_bwd_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoSoftmaxJob* job = (struct PicoSoftmaxJob*)ctx;
+    int64_t R = job->R, I = job->I;
+    if(I == 1) {
+        for(int64_t row = start; row < end; row++) {
+            pico_softmax_bwd_row_cpu(job->x + row * R, job->dy + row * R, job->out + row * R, R);
+        }
+        return;
+    }
+    float* buf = job->scratch + start / job->per * 3 * R;
+    for(int64_t row = start; row < end; row++) {
+        int64_t base = (row / I) * R * I + row % I;
+        pico_softmax_strided_gather(buf, job->x + base, R, I);
+        pico_softmax_strided_gather(buf + R, job->dy + base, R, I);
+        memset(buf + 2 * R, 0, sizeof(float) * R);
+        pico_softmax_bwd_row_cpu(buf, buf + R, buf + 2 * R, R);
+        for(int64_t r = 0; r < R; r++) job->out[base + r * I] += buf[2 * R + r];
+    }
+}
+
+// y = softmax over R of x[O, R, I]. y must be zeroed; scratch holds
+// pico_softmax_scratch_floats(O, R, I, false) floats (NULL when that's 0)
+static inline void pico_softmax_cpu(const float* x, float* y, float* scratch, int64_t O,
+                                    int64_t R, int64_t I) {
+    int64_t min_chunk = MAX(1, PICO_SOFTMAX_THREAD_MIN_ELEMS / R);
+    struct PicoSoftmaxJob job = {.x = x, .out = y, .scratch = scratch,
+                                 .per = pico_parallel_slice_len(O * I, min_chunk), .R = R, .I = I};
+    pico_parallel_for(O * I, min_chunk, pico_softmax_fwd_slice, &job);
+}
+
+// dx += y * (dy - dot(dy, y)) along R. scratch as above, with backward = true
+static inline void pico_softmax_backward_cpu(const float* y, const float* dy, float* dx,
+                                             float* scratch, int64_t O, int64_t R, int64_t I) {
+    int64_t min_chunk = MAX(1, PICO_SOFTMAX_THREAD_MIN_ELEMS / R);
+    struct PicoSoftmaxJob job = {.x = y, .dy = dy, .out = dx, .scratch = scratch,
+                                 .per = pico_parallel_slice_len(O * I, min_chunk), .R = R, .I = I};
+    pico_parallel_for(O * I, min_chunk, pico_softmax_bwd_slice, &job);
+}
+
+// cross-entropy on [N, C] logits with float class labels. forward keeps the per-row
+// logsumexp; backward rebuilds softmax from it on the fly, straight into dx:
+//   loss[n] = lse[n] - x[n, label]        dx[n] += scale * (softmax(x[n]) - onehot)
+struct PicoCrossEntropyJob {
+    const float* logits;
+    const float* labels;
+    float* lse;
+    float* loss;  // forward only
+    float* dx;    // backward only
+    float scale;
+    int64_t C;
+};
+
+static inline void pico_cross_entropy_fwd_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoCrossEntropyJob* job = (struct PicoCrossEntropyJob*)ctx;
+    for(int64_t n = start; n < end; n++) {
+        const float* x = job->logits + n * job->C;
+        job->lse[n] = pico_logsumexp_row_cpu(x, job->C);
+        job->loss[n] = job->lse[n] - x[(int64_t)job->labels[n]];
+    }
+}
+
+static inline void pico_cross_entropy_bwd_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoCrossEntropyJob* job = (struct PicoCrossEntropyJob*)ctx;
+    for(int64_t n = start; n < end; n++) {
+        float* dx = job->dx + n * job->C;
+        pico_softmax_accum_row_cpu(job->logits + n * job->C, job->lse[n], job->scale, dx, job->C);
+        dx[(int64_t)job->labels[n]] -= job->scale;
+    }
+}
+
+static inline void pico_cross_entropy_cpu(const float* logits, const float* labels, float* lse,
+                                          float* loss, int64_t N, int64_t C) {
+    struct PicoCrossEntropyJob job = {
+        .logits = logits, .labels = labels, .lse = lse, .loss = loss, .C = C};
+    pico_parallel_for(N, MAX(1, PICO_SOFTMAX_THREAD_MIN_ELEMS / C), pico_cross_entropy_fwd_slice,
+                      &job);
+}
+
+static inline void pico_cross_entropy_backward_cpu(const float* logits, const float* labels,
+                                                   const float* lse, float scale, float* dx,
+                                                   int64_t N, int64_t C) {
+    struct PicoCrossEntropyJob job = {
+        .logits = logits, .labels = labels, .lse = (float*)lse, .dx = dx, .scale = scale, .C = C};
+    pico_parallel_for(N, MAX(1, PICO_SOFTMAX_THREAD_MIN_ELEMS / C), pico_cross_entropy_bwd_slice,
+                      &job);
+}
+
+// mse. the sum is cut into fixed PICO_MSE_BLOCK blocks whose partial sums are then
+// summed pairwise: threads take whole blocks, and the result doesn't depend on how
+// many threads ran (same blocks, same order).
+#ifndef PICO_MSE_BLOCK
+#define PICO_MSE_BLOCK (1 << 14)
+#endif
+
+static inline float pico_sq_diff_sum_row_cpu(const float* a, const float* b, int64_t n) {
+    switch(g_simd_level) {
+        case SIMD_AVX512:
+            return pico_sq_diff_sum_row_avx512(a, b, n);
+        case SIMD_AVX2:
+            return pico_sq_diff_sum_row_avx2(a, b, n);
+        default:
+            return pico_sq_diff_sum_row_scalar(a, b, n);
+    }
+}
+
+struct PicoMSEJob {
+    const float* a;
+    const float* b;
+    const float* dy;
+    float* y;  // forward: partials (sum) or per-element losses (NONE)
+    float* da;
+    float* db;
+    float scale;
+    int64_t n;
+};
+
+static inline void pico_mse_sum_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoMSEJob* job = (struct PicoMSEJob*)ctx;
+    for(int64_t blk = start; blk < end; blk++) {
+        int64_t i = blk * PICO_MSE_BLOCK;
+        job->y[blk] = pico_sq_diff_sum_row_cpu(job->a + i, job->b + i,
+                                               MIN(PICO_MSE_BLOCK, job->n - i));
+    }
+}
+
+static inline void pico_sq_diff_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoMSEJob* job = (struct PicoMSEJob*)ctx;
+    const float *a = job->a + start, *b = job->b + start;
+    switch(g_simd_level) {
+        case SIMD_AVX512:
+            pico_sq_diff_avx512(a, b, job->y + start, end - start);
+            break;
+        case SIMD_AVX2:
+            pico_sq_diff_avx2(a, b, job->y + start, end - start);
+            break;
+        default:
+            pico_sq_diff_scalar(a, b, job->y + start, end - start);
+    }
+}
+
+static inline void pico_mse_bwd_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoMSEJob* job = (struct PicoMSEJob*)ctx;
+    const float *a = job->a + start, *b = job->b + start;
+    const float* dy = job->dy ? job->dy + start : NULL;
+    float* da = job->da ? job->da + start : NULL;
+    float* db = job->db ? job->db + start : NULL;
+    switch(g_simd_level) {
+        case SIMD_AVX512:
+            pico_mse_bwd_avx512(a, b, dy, job->scale, da, db, end - start);
+            break;
+        case SIMD_AVX2:
+            pico_mse_bwd_avx2(a, b, dy, job->scale, da, db, end - start);
+            break;
+        default:
+            pico_mse_bwd_scalar(a, b, dy, job->scale, da, db, end - start);
+    }
+}
+
+// sum (a - b)^2. partials needs ceil(n / PICO_MSE_BLOCK) floats of scratch
+static inline float pico_mse_sum_cpu(const float* a, const float* b, float* partials, int64_t n) {
+    int64_t blocks = (n + PICO_MSE_BLOCK - 1) / PICO_MSE_BLOCK;
+    struct PicoMSEJob job = {.a = a, .b = b, .y = partials, .n = n};
+    pico_parallel_for(blocks, MAX(1, PICO_ACT_THREAD_MIN_CHUNK / PICO_MSE_BLOCK),
+                      pico_mse_sum_slice, &job);
+    return pico_reduce_row_cpu(PICO_REDUCE_SUM, partials, blocks);
+}
+
+// y = (a - b)^2
+static inline void pico_sq_diff_cpu(const float* a, const float* b, float* y, int64_t n) {
+    struct PicoMSEJob job = {.a = a, .b = b, .y = y, .n = n};
+    pico_parallel_for(n, PICO_ACT_THREAD_MIN_CHUNK, pico_sq_diff_slice, &job);
+}
+
+// da += scale * dy * (a - b), db -= the same. dy/da/db may be NULL (see mse_bwd)
+static inline void pico_mse_backward_cpu(const float* a, const float* b, const float* dy,
+                                         float scale, float* da, float* db, int64_t n) {
+    struct PicoMSEJob job = {.a = a, .b = b, .dy = dy, .da = da, .db = db, .scale = scale, .n = n};
+    pico_parallel_for(n, PICO_ACT_THREAD_MIN_CHUNK, pico_mse_bwd_slice, &job);
+}
+
+// optimizer steps (optim/optim.c picks one per algorithm). s0/s1 are the param's
+// slices of the optimizer state; SGD ignores both, the one-state algorithms s1.
+#define PICO_DEFINE_OPTIM_STEP_DISPATCH(name, CALL_ARGS)                               \
+    static inline void name##_cpu(float* p, float* g, float* s0, float* s1, int64_t n, \
+                                  const struct PicoOptimStep* h) {                     \
+        (void)s0;                                                                      \
+        (void)s1;                                                                      \
+        switch(g_simd_level) {                                                         \
+            case SIMD_AVX512:                                                          \
+                name##_avx512 CALL_ARGS;                                               \
+                break;                                                                 \
+            case SIMD_AVX2:                                                            \
+                name##_avx2 CALL_ARGS;                                                 \
+                break;                                                                 \
+            default:                                                                   \
+                name##_scalar CALL_ARGS;                                               \
+        }                                                                              \
+    }
+
+PICO_DEFINE_OPTIM_STEP_DISPATCH(pico_sgd_step, (p, g, n, h))
+PICO_DEFINE_OPTIM_STEP_DISPATCH(pico_nag_step, (p, g, s0, n, h))
+PICO_DEFINE_OPTIM_STEP_DISPATCH(pico_adagrad_step, (p, g, s0, n, h))
+PICO_DEFINE_OPTIM_STEP_DISPATCH(pico_rmsprop_step, (p, g, s0, n, h))
+PICO_DEFINE_OPTIM_STEP_DISPATCH(pico_adam_step, (p, g, s0, s1, n, h))
+
+typedef void (*PicoOptimStepFn)(float* p, float* g, float* s0, float* s1, int64_t n,
+                                const struct PicoOptimStep* h);
+
+// int8 GEMM for the quantized Linear (nn/qlinear.c). AVX-512 uses the VNNI kernel when
+// the CPU has VNNI + BW, the AVX2 one otherwise; the quantizers have no AVX-512 form.
+// all levels give the same int32 sums, so the outputs are bit-identical.
+#ifndef PICO_QGEMM_NC
+#define PICO_QGEMM_NC 64  // columns per block: their W panel stays hot while every row passes
+#endif
+
+#ifndef PICO_QGEMM_THREAD_MIN_MACS
+#define PICO_QGEMM_THREAD_MIN_MACS (1 << 18)
+#endif
+
+typedef void (*PicoQGemmTileFn)(const int8_t* x, const int8_t* w, const int32_t* w_sum,
+                                int64_t kp, int32_t* acc);
+
+static inline float pico_absmax_cpu(const float* x, int64_t n) {
+    switch(g_simd_level) {
+        case SIMD_AVX512:
+        case SIMD_AVX2:
+            return pico_absmax_avx2(x, n);
+        default:
+            return pico_absmax_scalar(x, n);
+    }
+}
+
+static inline void pico_quantize_s8_cpu(const float* x, int8_t* q, int64_t n, float inv_scale) {
+    switch(g_simd_level) {
+        case SIMD_AVX512:
+        case SIMD_AVX2:
+            pico_quantize_s8_avx2(x, q, n, inv_scale);
+            break;
+        default:
+            pico_quantize_s8_scalar(x, q, n, inv_scale);
+    }
+}
+
+static inline PicoQGemmTileFn pico_qgemm_tile_fn(void) {
+    switch(g_simd_level) {
+        case SIMD_AVX512:
+            if(__builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vnni")) {
+                return pico_qgemm_tile_avx512;
+            }
+            return pico_qgemm_tile_avx2;
+        case SIMD_AVX2:
+            return pico_qgemm_tile_avx2;
+        default:
+            return pico_qgemm_tile_scalar;
+    }
+}
+
+// the scale that maps a row with max |x| == absmax onto [-127, 127]. 1 for an all-zero
+// row, so it quantizes to zeros instead of dividing by 0
+static inline float pico_quant_scale(float absmax) {
+    return absmax > 0.0f ? absmax / 127.0f : 1.0f;
+}
+
+struct PicoQuantRowsJob {
+    const float* x;  // [m, k]
+    int8_t* q;       // [m, kp]
+    float* scale;    // [m]
+    int64_t k;
+    int64_t kp;
+    float fixed_scale;  // > 0: every row uses it. 0: each row gets its own from its max |x|
+};
+
+static inline void pico_quantize_rows_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoQuantRowsJob* job = (struct PicoQuantRowsJob*)ctx;
+    for(int64_t i = start; i < end; i++) {
+        const float* xr = job->x + i * job->k;
+        float s = job->fixed_scale > 0.0f ? job->fixed_scale
+                                          : pico_quant_scale(pico_absmax_cpu(xr, job->k));
+        job->scale[i] = s;
+        pico_quantize_s8_cpu(xr, job->q + i * job->kp, job->k, 1.0f / s);
+        memset(job->q + i * job->kp + job->k, 0, job->kp - job->k);
+    }
+}
+
+// rows of x [m, k] -> int8 rows of q [m, kp] (zero padded past k) + one scale per row
+static inline void pico_quantize_rows_cpu(const float* x, int8_t* q, float* scale, int64_t m,
+                                          int64_t k, int64_t kp, float fixed_scale) {
+    struct PicoQuantRowsJob job = {
+        .x = x, .q = q, .scale = scale, .k = k, .kp = kp, .fixed_scale = fixed_scale};
+    int64_t min_rows = MAX(1, PICO_ACT_THREAD_MIN_CHUNK / MAX(k, 1));
+    pico_parallel_for(m, min_rows, pico_quantize_rows_slice, &job);
+}
+
+struct PicoQGemmJob {
+    const int8_t* xq;       // [m rounded up to MR, kp]
+    const float* x_scale;   // [m]
+    const int8_t* wq;       // [n rounded up to NR, kp], packed columns
+    const int32_t* w_sum;   // [n rounded up to NR]
+    const float* w_scale;   // [n]
+    float* out;             // [m, n]
+    int64_t m, n, kp;
+    const struct PicoMatmulEpilogue* epi;
+    PicoQGemmTileFn tile;
+};
+
+// [start, end) is a range of NR-column tiles. blocks of PICO_QGEMM_NC columns go
+// column-block outer, rows inner, so a block's W panel is read from memory once
+static inline void pico_qgemm_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoQGemmJob* job = (struct PicoQGemmJob*)ctx;
+    const int64_t kp = job->kp, n = job->n;
+    const int64_t block = PICO_QGEMM_NC / PICO_QGEMM_NR;
+    int32_t acc[PICO_QGEMM_MR * PICO_QGEMM_NR];
+    for(int64_t tb = start; tb < end; tb += block) {
+        int64_t te = MIN(end, tb + block);
+        for(int64_t i = 0; i < job->m; i += PICO_QGEMM_MR) {
+            for(int64_t t = tb; t < te; t++) {
+                int64_t j0 = t * PICO_QGEMM_NR;
+                job->tile(job->xq + i * kp, job->wq + j0 * kp, job->w_sum + j0, kp, acc);
+                for(int r = 0; r < PICO_QGEMM_MR && i + r < job->m; r++) {
+                    float* orow = job->out + (i + r) * n;
+                    for(int c = 0; c < PICO_QGEMM_NR && j0 + c < n; c++) {
+                        float v = (float)acc[r * PICO_QGEMM_NR + c] *
+                                  (job->x_scale[i + r] * job->w_scale[j0 + c]);
+                        orow[j0 + c] = job->epi ? pico_epilogue_apply_f32(job->epi, v, j0 + c) : v;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// out[m, n] = epilogue(dequant(xq @ W)): int32 tile sums times x_scale[i] * w_scale[j],
+// then bias + activation. epi may be NULL
+static inline void pico_qgemm_cpu(const int8_t* xq, const float* x_scale, const int8_t* wq,
+                                  const int32_t* w_sum, const float* w_scale, float* out,
+                                  int64_t m, int64_t n, int64_t kp,
+                                  const struct PicoMatmulEpilogue* epi) {
+    struct PicoQGemmJob job = {.xq = xq,
+                               .x_scale = x_scale,
+                               .wq = wq,
+                               .w_sum = w_sum,
+                               .w_scale = w_scale,
+                               .out = out,
+                               .m = m,
+                               .n = n,
+                               .kp = kp,
+                               .epi = epi,
+                               .tile = pico_qgemm_tile_fn()};
+    if(m == 0) return;
+    int64_t tiles = (n + PICO_QGEMM_NR - 1) / PICO_QGEMM_NR;
+    int64_t min_tiles = MAX(1, PICO_QGEMM_THREAD_MIN_MACS / (m * PICO_QGEMM_NR * kp));
+    pico_parallel_for(tiles, min_tiles, pico_qgemm_slice, &job);
+}
+
+// random fills (rng/rng.c). the buffer is cut into PICO_RNG_BLOCK-float super-blocks and
+// the threads split whole super-blocks, so every value depends only on its position:
+// the output is the same for any thread count. a short last super-block is generated
+// whole into a temp and truncated, through the same kernel as the rest. uniforms are
+// bit-identical across SIMD levels; normals differ by the log / sincos rounding
+#ifndef PICO_RNG_THREAD_MIN_BLOCKS
+#define PICO_RNG_THREAD_MIN_BLOCKS (PICO_ACT_THREAD_MIN_CHUNK / PICO_RNG_BLOCK)
+#endif
+
+struct PicoRngJob {
+    float* out;
+    int64_t n;
+    uint64_t seed;
+    uint64_t stream;
+    uint64_t block;  // counter of the first super-block
+    bool normal;
+    float shift;  // out = shift + scale * (uniform [0, 1) or standard normal)
+    float scale;
+};
+
+static inline void pico_rng_block_cpu(const struct PicoRngJob* job, uint64_t block, float* out) {
+    switch(g_simd_level) {
+        case SIMD_AVX512:
+            if(job->normal)
+                pico_rng_normal_avx512(job->seed, job->stream, block, job->shift, job->scale,
+                                       out);
+            else pico_rng_uniform_avx512(job->seed, job->stream, block, job->shift, job->scale,
+                                         out);
+            break;
+        case SIMD_AVX2:
+            if(job->normal)
+                pico_rng_normal_avx2(job->seed, job->stream, block, job->shift, job->scale, out);
+            else pico_rng_uniform_avx2(job->seed, job->stream, block, job->shift, job->scale, out);
+            break;
+        default:
+            if(job->normal)
+                pico_rng_normal_scalar(job->seed, job->stream, block, job->shift, job->scale,
+                                       out);
+            else pico_rng_uniform_scalar(job->seed, job->stream, block, job->shift, job->scale,
+                                         out);
+            break;
+    }
+}
+
+// [start, end) is a range of super-blocks
+static inline void pico_rng_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoRngJob* job = (struct PicoRngJob*)ctx;
+    for(int64_t s = start; s < end; s++) {
+        uint64_t block = job->block + (uint64_t)s * PICO_RNG_LANES;
+        int64_t at = s * PICO_RNG_BLOCK;
+        if(at + PICO_RNG_BLOCK <= job->n) {
+            pico_rng_block_cpu(job, block, job->out + at);
+        } else {
+            float tmp[PICO_RNG_BLOCK];
+            pico_rng_block_cpu(job, block, tmp);
+            memcpy(job->out + at, tmp, sizeof(float) * (job->n - at));
+        }
+    }
+}
+
+// n values from counter `block` on: shift + scale * u with u uniform [0, 1), or
+// normal(shift, scale) when normal is set. uses (n + PICO_RNG_BLOCK - 1) / PICO_RNG_BLOCK
+// super-blocks of the counter
+static inline void pico_rng_fill_cpu(float* out, int64_t n, uint64_t seed, uint64_t stream,
+                                     uint64_t block, bool normal, float shift, float scale) {
+    struct PicoRngJob job = {.out = out,
+                             .n = n,
+                             .seed = seed,
+                             .stream = stream,
+                             .block = block,
+                             .normal = normal,
+                             .shift = shift,
+                             .scale = scale};
+    int64_t blocks = (n + PICO_RNG_BLOCK - 1) / PICO_RNG_BLOCK;
+    pico_parallel_for(blocks, PICO_RNG_THREAD_MIN_BLOCKS, pico_rng_slice, &job);
+}
+
+// x[i] = clamp(shift + scale * erfinv(x[i]), lo, hi): uniforms on (-1, 1) to a
+// truncated normal (rng/rng.c). element-wise, so any split gives the same result
+struct PicoErfinvJob {
+    float* x;
+    float shift, scale, lo, hi;
+};
+
+static inline void pico_erfinv_affine_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoErfinvJob* job = (struct PicoErfinvJob*)ctx;
+    switch(g_simd_level) {
+        case SIMD_AVX512:
+        case SIMD_AVX2:
+            pico_erfinv_affine_avx2(job->x + start, end - start, job->shift, job->scale, job->lo,
+                                    job->hi);
+            break;
+        default:
+            pico_erfinv_affine_scalar(job->x + start, end - start, job->shift, job->scale,
+                                      job->lo, job->hi);
+            break;
+    }
+}
+
+static inline void pico_erfinv_affine_cpu(float* x, int64_t n, float shift, float scale, float lo,
+                                          float hi) {
+    struct PicoErfinvJob job = {.x = x, .shift = shift, .scale = scale, .lo = lo, .hi = hi};
+    pico_parallel_for(n, PICO_ACT_THREAD_MIN_CHUNK, pico_erfinv_affine_slice, &job);
+}
+
+// strided view <-> contiguous copies (view/view.c): pico_contiguous's gather and its
+// backward's scatter-add. a view whose last dim isn't unit-stride but whose second to
+// last is (a transpose of the last two dims, batched over any outer ones) goes through
+// the blocked transpose below; anything else is walked as rows of its last dim, split
+// across threads
+#ifndef PICO_STRIDED_THREAD_MIN_ELEMS
+#define PICO_STRIDED_THREAD_MIN_ELEMS (1 << 16)
+#endif
+
+// transposes run in BLOCK x BLOCK blocks: 16 KB of fp32 per side, so a block's source
+// rows and destination rows both stay in L1 while its 8x8 tiles go by
+#ifndef PICO_TRANSPOSE_BLOCK
+#define PICO_TRANSPOSE_BLOCK 64
+#endif
+
+// dst[j * ldd + i] = src[i * lds + j] (+= when acc) for a rows x cols block of src
+static inline void pico_transpose_block_cpu(const void* src, int64_t lds, void* dst, int64_t ldd,
+                                            int64_t rows, int64_t cols, size_t elem, bool acc) {
+    if(elem != sizeof(float)) {
+        pico_transpose_u16_scalar(src, lds, dst, ldd, rows, cols);
+        return;
+    }
+    switch(g_simd_level) {
+        case SIMD_AVX512:
+        case SIMD_AVX2:
+            pico_transpose_f32_avx2(src, lds, dst, ldd, rows, cols, acc);
+            break;
+        default:
+            pico_transpose_f32_scalar(src, lds, dst, ldd, rows, cols, acc);
+    }
+}
+
+struct PicoTransposeJob {
+    const char* src;
+    char* dst;
+    int64_t lds, ldd;
+    int64_t rows, cols;  // of one src matrix
+    int64_t row_blocks, col_blocks;
+    // the batch: outer dims of the strided side (coalesced shape / strides), and the
+    // matrix size on the contiguous side
+    const int64_t* shape;
+    const int64_t* strides;
+    int outer;
+    bool src_strided;  // gather: src is the view. scatter-add: dst is
+    size_t elem;
+    bool acc;
+};
+
+// [start, end) is a range of blocks, batch-major
+static inline void pico_transpose_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoTransposeJob* job = (struct PicoTransposeJob*)ctx;
+    int64_t per_matrix = job->row_blocks * job->col_blocks;
+    for(int64_t u = start; u < end; u++) {
+        int64_t b = u / per_matrix;
+        int64_t i0 = (u % per_matrix) / job->col_blocks * PICO_TRANSPOSE_BLOCK;
+        int64_t j0 = (u % per_matrix) % job->col_blocks * PICO_TRANSPOSE_BLOCK;
+        int64_t view_off = pico_strided_row_offset(b, job->shape, job->strides, job->outer + 1);
+        int64_t dense_off = b * job->rows * job->cols;
+        int64_t src_off = (job->src_strided ? view_off : dense_off) + i0 * job->lds + j0;
+        int64_t dst_off = (job->src_strided ? dense_off : view_off) + j0 * job->ldd + i0;
+        pico_transpose_block_cpu(job->src + src_off * job->elem, job->lds,
+                                 job->dst + dst_off * job->elem, job->ldd,
+                                 MIN(PICO_TRANSPOSE_BLOCK, job->rows - i0),
+                                 MIN(PICO_TRANSPOSE_BLOCK, job->cols - j0), job->elem, job->acc);
+    }
+}
+
+// the view (ndim coalesced dims) is a batched transpose worth tiling: unit stride one dim
+// in, at least one full tile each way
+static inline bool pico_strided_is_transpose(const int64_t* shape, const int64_t* strides,
+                                             int ndim) {
+    return ndim >= 2 && strides[ndim - 2] == 1 && strides[ndim - 1] > 1 && shape[ndim - 2] >= 8 &&
+           shape[ndim - 1] >= 8;
+}
+
+static inline void pico_transpose_run_cpu(struct PicoTransposeJob* job, int64_t batch,
+                                          bool serial) {
+    job->row_blocks = (job->rows + PICO_TRANSPOSE_BLOCK - 1) / PICO_TRANSPOSE_BLOCK;
+    job->col_blocks = (job->cols + PICO_TRANSPOSE_BLOCK - 1) / PICO_TRANSPOSE_BLOCK;
+    int64_t blocks = batch * job->row_blocks * job->col_blocks;
+    if(serial) {
+        pico_transpose_slice(job, 0, blocks);
+        return;
+    }
+    pico_parallel_for(blocks,
+                      MAX(1, PICO_STRIDED_THREAD_MIN_ELEMS /
+                                 (PICO_TRANSPOSE_BLOCK * PICO_TRANSPOSE_BLOCK)),
+                      pico_transpose_slice, job);
+}
+
+struct PicoStridedJob {
+    const void* src;
+    void* dst;
+    const int64_t* shape;  // coalesced, see pico_strided_gather_scalar
+    const int64_t* strides;
+    int ndim;
+    size_t elem;
+};
+
+static inline void pico_strided_gather_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoStridedJob* job = (struct PicoStridedJob*)ctx;
+    pico_strided_gather_scalar(job->src, job->dst, job->shape, job->strides, job->ndim,
+                               job->elem, start, end);
+}
+
+static inline void pico_strided_scatter_add_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoStridedJob* job = (struct PicoStridedJob*)ctx;
+    pico_strided_scatter_add_scalar(job->src, job->dst, job->shape, job->strides, job->ndim,
+                                    start, end);
+}
+
+// dst (contiguous) = the view (src, shape, strides), elements of `elem` bytes
+static inline void pico_strided_gather_cpu(const void* src, void* dst, const int64_t* shape,
+                                           const int64_t* strides, int ndim, size_t elem) {
+    int64_t rows = 1;
+    for(int d = 0; d < ndim - 1; d++) rows *= shape[d];
+
+    if(pico_strided_is_transpose(shape, strides, ndim)) {
+        // view element (.., r, c) sits at r + c * ld: src is a [C, R] matrix with row
+        // stride ld, dst its [R, C] transpose
+        struct PicoTransposeJob job = {.src = src,
+                                       .dst = dst,
+                                       .lds = strides[ndim - 1],
+                                       .ldd = shape[ndim - 1],
+                                       .rows = shape[ndim - 1],
+                                       .cols = shape[ndim - 2],
+                                       .shape = shape,
+                                       .strides = strides,
+                                       .outer = ndim - 2,
+                                       .src_strided = true,
+                                       .elem = elem,
+                                       .acc = false};
+        pico_transpose_run_cpu(&job, rows / shape[ndim - 2], false);
+        return;
+    }
+
+    struct PicoStridedJob job = {.src = src,
+                                 .dst = dst,
+                                 .shape = shape,
+                                 .strides = strides,
+                                 .ndim = ndim,
+                                 .elem = elem};
+    pico_parallel_for(rows, MAX(1, PICO_STRIDED_THREAD_MIN_ELEMS / shape[ndim - 1]),
+                      pico_strided_gather_slice, &job);
+}
+
+// the view (dst, shape, strides) += src (contiguous), fp32. serial when a stride is 0:
+// then several rows land on the same elements
+static inline void pico_strided_scatter_add_cpu(const float* src, float* dst,
+                                                const int64_t* shape, const int64_t* strides,
+                                                int ndim) {
+    int64_t rows = 1;
+    bool overlap = false;
+    for(int d = 0; d < ndim - 1; d++) {
+        rows *= shape[d];
+        overlap |= strides[d] == 0;
+    }
+
+    if(pico_strided_is_transpose(shape, strides, ndim)) {
+        // the gather's mirror: src is [R, C] contiguous, dst the strided [C, R]
+        struct PicoTransposeJob job = {.src = (const char*)src,
+                                       .dst = (char*)dst,
+                                       .lds = shape[ndim - 1],
+                                       .ldd = strides[ndim - 1],
+                                       .rows = shape[ndim - 2],
+                                       .cols = shape[ndim - 1],
+                                       .shape = shape,
+                                       .strides = strides,
+                                       .outer = ndim - 2,
+                                       .src_strided = false,
+                                       .elem = sizeof(float),
+                                       .acc = true};
+        pico_transpose_run_cpu(&job, rows / shape[ndim - 2], overlap);
+        return;
+    }
+
+    struct PicoStridedJob job = {.src = src,
+                                 .dst = dst,
+                                 .shape = shape,
+                                 .strides = strides,
+                                 .ndim = ndim,
+                                 .elem = sizeof(float)};
+    if(overlap) {
+        pico_strided_scatter_add_slice(&job, 0, rows);
+        return;
+    }
+    pico_parallel_for(rows, MAX(1, PICO_STRIDED_THREAD_MIN_ELEMS / shape[ndim - 1]),
+                      pico_strided_scatter_add_slice, &job);
+}
+
+// concatenation (pico_cat_n in tensor.c). the output is walked as one flat range of
+// elements, split evenly across threads whatever the input sizes: every output row (one
+// index of the dims before `dim`) is input 0's chunk, then input 1's, ... at offsets
+// computed once by the forward. outputs past PICO_CAT_STREAM_MIN_BYTES are written with
+// non-temporal stores when the runs are long enough to fill whole lines (short ones
+// interleaved row by row stream slower than they cache), and the backward walks the same
+// range adding each window of dy into its input's grad
+#ifndef PICO_CAT_STREAM_MIN_BYTES
+#define PICO_CAT_STREAM_MIN_BYTES (8 << 20)
+#endif
+
+#ifndef PICO_CAT_STREAM_MIN_RUN_BYTES
+#define PICO_CAT_STREAM_MIN_RUN_BYTES 4096
+#endif
+
+#ifndef PICO_CAT_THREAD_MIN_ELEMS
+#define PICO_CAT_THREAD_MIN_ELEMS (1 << 16)
+#endif
+
+struct PicoCatJob {
+    const char* const* src;  // n contiguous inputs. the backward: unused
+    char* dst;
+    const float* dy;  // the backward: the output's grad
+    float* const* dx;  //               and the inputs' (NULL to skip one)
+    const int64_t* offsets;  // where input k's chunk starts in an output row, in elements
+    const int64_t* chunks;   // input k's elements per output row
+    int64_t row;             // elements per output row
+    int n;
+    size_t elem;
+    bool stream;
+};
+
+static inline void pico_cat_copy(void* dst, const void* src, size_t bytes, bool stream) {
+    switch(g_simd_level) {
+        case SIMD_AVX512:
+        case SIMD_AVX2:
+            if(stream) {
+                pico_copy_stream_avx2(dst, src, bytes);
+                break;
+            }
+            // fall through
+        default:
+            memcpy(dst, src, bytes);
     }
 }
+
+// output elements [start, end): find the (row, input) the range starts in, then hand out
+// one run per input chunk
+static inline void pico_cat_walk(const struct PicoCatJob* job, int64_t start, int64_t end,
+                                 bool backward) {
+    int64_t o = start / job->row;
+    int64_t c = start % job->row;
+    int k = 0;
+    while(c >= job->offsets[k] + job->chunks[k]) k++;
+    for(int64_t p = start; p < end;) {
+        int64_t in = c - job->offsets[k];
+        int64_t len = MIN(job->chunks[k] - in, end - p);
+        int64_t src_off = o * job->chunks[k] + in;
+        if(!backward) {
+            pico_cat_copy(job->dst + p * job->elem, job->src[k] + src_off * job->elem,
+                          len * job->elem, job->stream);
+        } else if(job->dx[k] != NULL) {
+            float* dx = job->dx[k] + src_off;
+            const float* dy = job->dy + p;
+            for(int64_t i = 0; i < len; i++) dx[i] += dy[i];
+        }
+        p += len;
+        c += len;
+        if(c == job->offsets[k] + job->chunks[k] && ++k == job->n) {
+            k = 0;
+            c = 0;
+            o++;
+        }
+    }
+    if(!backward && job->stream) _mm_sfence();
+}
+
+static inline void pico_cat_fwd_slice(void* ctx, int64_t start, int64_t end) {
+    pico_cat_walk((const struct PicoCatJob*)ctx, start, end, false);
+}
+
+static inline void pico_cat_bwd_slice(void* ctx, int64_t start, int64_t end) {
+    pico_cat_walk((const struct PicoCatJob*)ctx, start, end, true);
+}
+
+// dst = the n inputs joined, numel elements of job->elem bytes
+static inline void pico_cat_cpu(struct PicoCatJob* job, int64_t numel) {
+    job->stream = (size_t)numel * job->elem >= PICO_CAT_STREAM_MIN_BYTES &&
+                  (size_t)job->row * job->elem / job->n >= PICO_CAT_STREAM_MIN_RUN_BYTES;
+    pico_parallel_for(numel, PICO_CAT_THREAD_MIN_ELEMS, pico_cat_fwd_slice, job);
+}
+
+// dx[k] += input k's window of dy. serial when two inputs' grads overlap (the same
+// tensor twice, or two views of one base): their windows would add into the same floats
+static inline void pico_cat_backward_cpu(struct PicoCatJob* job, int64_t numel) {
+    int64_t outer = numel / job->row;
+    bool overlap = false;
+    for(int k = 0; k < job->n && !overlap; k++) {
+        for(int j = 0; j < k && job->dx[k] != NULL; j++) {
+            overlap |= job->dx[j] != NULL && job->dx[j] < job->dx[k] + outer * job->chunks[k] &&
+                       job->dx[k] < job->dx[j] + outer * job->chunks[j];
+        }
+    }
+    if(overlap) {
+        pico_cat_bwd_slice(job, 0, numel);
+        return;
+    }
+    pico_parallel_for(numel, PICO_CAT_THREAD_MIN_ELEMS, pico_cat_bwd_slice, job);
+}
+
+// im2col / col2im for the conv layer (nn/conv.c): rows split across threads going in,
+// whole images coming back (see pico_col2im_scalar)
+#ifndef PICO_IM2COL_THREAD_MIN_ELEMS
+#define PICO_IM2COL_THREAD_MIN_ELEMS (1 << 15)
+#endif
+
+struct PicoIm2colJob {
+    const float* src;
+    float* dst;
+    const struct PicoConvShape* s;
+    int64_t g;
+};
+
+static inline void pico_im2col_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoIm2colJob* job = (struct PicoIm2colJob*)ctx;
+    pico_im2col_scalar(job->src, job->dst, job->s, job->g, start, end);
+}
+
+static inline void pico_col2im_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoIm2colJob* job = (struct PicoIm2colJob*)ctx;
+    pico_col2im_scalar(job->src, job->dst, job->s, job->g, start, end);
+}
+
+// col = group g's im2col matrix of x, [n * oh * ow, k * k * cg]
+static inline void pico_im2col_cpu(const float* x, float* col, const struct PicoConvShape* s,
+                                   int64_t g) {
+    struct PicoIm2colJob job = {.src = x, .dst = col, .s = s, .g = g};
+    int64_t row = s->k * s->k * (s->c / s->groups);
+    pico_parallel_for(s->n * s->oh * s->ow, MAX(1, PICO_IM2COL_THREAD_MIN_ELEMS / row),
+                      pico_im2col_slice, &job);
+}
+
+// dx (NHWC) += col scattered back through group g's taps
+static inline void pico_col2im_cpu(const float* col, float* dx, const struct PicoConvShape* s,
+                                   int64_t g) {
+    struct PicoIm2colJob job = {.src = col, .dst = dx, .s = s, .g = g};
+    int64_t per_image = s->oh * s->ow * s->k * s->k * (s->c / s->groups);
+    pico_parallel_for(s->n, MAX(1, PICO_IM2COL_THREAD_MIN_ELEMS / per_image), pico_col2im_slice,
+                      &job);
+}
+
+// the conv forward on CPU (nn/conv.c), by algorithm (see kernels/conv.h): y = act(conv(x,
+// w) + bias) over NHWC x / y, weights [k, k, c / groups, oc], bias NULL or [oc].
+// scratch holds pico_conv_scratch_floats(s, algo) floats. the transforms and the
+// depthwise loop split tiles / rows across threads, the GEMMs split their own rows
+#ifndef PICO_CONV_THREAD_MIN_ELEMS
+#define PICO_CONV_THREAD_MIN_ELEMS (1 << 14)
+#endif
+
+struct PicoConvJob {
+    const float* x;
+    const float* w;
+    const float* bias;
+    float* y;
+    float* v;  // winograd: transformed input tiles
+    float* m;  //           and the products
+    const struct PicoConvShape* s;
+    bool relu;
+};
+
+static inline void pico_depthwise_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoConvJob* job = (struct PicoConvJob*)ctx;
+    switch(g_simd_level) {
+        case SIMD_AVX512:
+        case SIMD_AVX2:
+            pico_depthwise_avx2(job->x, job->w, job->bias, job->y, job->s, job->relu, start, end);
+            break;
+        default:
+            pico_depthwise_scalar(job->x, job->w, job->bias, job->y, job->s, job->relu, start,
+                                  end, 0, job->s->c);
+    }
+}
+
+static inline void pico_winograd_input_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoConvJob* job = (struct PicoConvJob*)ctx;
+    switch(g_simd_level) {
+        case SIMD_AVX512:
+        case SIMD_AVX2:
+            pico_winograd_input_avx2(job->x, job->v, job->s, start, end);
+            break;
+        default:
+            pico_winograd_input_scalar(job->x, job->v, job->s, start, end, 0, job->s->c);
+    }
+}
+
+static inline void pico_winograd_output_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoConvJob* job = (struct PicoConvJob*)ctx;
+    switch(g_simd_level) {
+        case SIMD_AVX512:
+        case SIMD_AVX2:
+            pico_winograd_output_avx2(job->m, job->bias, job->y, job->s, job->relu, start, end);
+            break;
+        default:
+            pico_winograd_output_scalar(job->m, job->bias, job->y, job->s, job->relu, start,
+                                        end, 0, job->s->oc);
+    }
+}
+
+static inline void pico_winograd_weights_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoConvJob* job = (struct PicoConvJob*)ctx;
+    pico_winograd_weights_scalar(job->w, job->v, job->s->c * job->s->oc, start, end);
+}
+
+// transform the weights and the input tiles, one GEMM per point of the 4x4 transform
+// domain, transform the products back
+static inline void pico_winograd_cpu(struct PicoConvJob* job, float* scratch) {
+    const struct PicoConvShape* s = job->s;
+    int64_t tiles = pico_winograd_tiles(s);
+    float* u = scratch;
+    job->v = u + 16 * s->c * s->oc;
+    job->m = job->v + 16 * tiles * s->c;
+
+    struct PicoConvJob wjob = {.w = job->w, .v = u, .s = s};
+    pico_parallel_for(s->c * s->oc, PICO_CONV_THREAD_MIN_ELEMS / 16, pico_winograd_weights_slice,
+                      &wjob);
+    pico_parallel_for(tiles, MAX(1, PICO_CONV_THREAD_MIN_ELEMS / (16 * s->c)),
+                      pico_winograd_input_slice, job);
+
+    memset(job->m, 0, sizeof(float) * 16 * tiles * s->oc);  // the GEMM accumulates
+    for(int64_t p = 0; p < 16; p++) {
+        struct PicoConvMat am, bm, om;
+        pico_matmul_cpu(pico_conv_mat(&am, job->v + p * tiles * s->c, tiles, s->c, s->c, 1),
+                        pico_conv_mat(&bm, u + p * s->c * s->oc, s->c, s->oc, s->oc, 1),
+                        pico_conv_mat(&om, job->m + p * tiles * s->oc, tiles, s->oc, s->oc, 1));
+    }
+
+    pico_parallel_for(tiles, MAX(1, PICO_CONV_THREAD_MIN_ELEMS / (16 * s->oc)),
+                      pico_winograd_output_slice, job);
+}
+
+// one GEMM per group against its column slice of the weights, bias and activation in
+// the epilogue. the pointwise path's A is x itself, read through its channel stride
+static inline void pico_conv_gemm_cpu(const float* x, const float* w, const float* bias,
+                                      float* y, const struct PicoConvShape* s,
+                                      enum PicoActivation act, bool pointwise, float* col) {
+    int64_t cg = s->c / s->groups, og = s->oc / s->groups;
+    int64_t rows = s->n * s->oh * s->ow, kcols = s->k * s->k * cg;
+    memset(y, 0, sizeof(float) * rows * s->oc);  // the GEMM accumulates
+    for(int64_t g = 0; g < s->groups; g++) {
+        struct PicoConvMat am, bm, om;
+        struct PicoTensor* a;
+        if(pointwise) {
+            a = pico_conv_mat(&am, (float*)x + g * cg, rows, cg, s->c, 1);
+        } else {
+            pico_im2col_cpu(x, col, s, g);
+            a = pico_conv_mat(&am, col, rows, kcols, kcols, 1);
+        }
+        struct PicoMatmulEpilogue epi = {.bias = bias != NULL ? bias + g * og : NULL, .act = act};
+        pico_matmul_epilogue_cpu(a, pico_conv_mat(&bm, (float*)w + g * og, kcols, og, s->oc, 1),
+                                 pico_conv_mat(&om, y + g * og, rows, og, s->oc, 1), &epi);
+    }
+}
+
+static inline void pico_conv2d_cpu(const float* x, const float* w, const float* bias, float* y,
+                                   const struct PicoConvShape* s, enum PicoActivation act,
+                                   enum PicoConvAlgo algo, float* scratch) {
+    struct PicoConvJob job = {
+        .x = x, .w = w, .bias = bias, .y = y, .s = s, .relu = act == PICO_ACT_RELU};
+    switch(algo) {
+        case PICO_CONV_DEPTHWISE:
+            pico_parallel_for(s->n * s->oh,
+                              MAX(1, PICO_CONV_THREAD_MIN_ELEMS / (s->ow * s->c * s->k * s->k)),
+                              pico_depthwise_slice, &job);
+            break;
+        case PICO_CONV_WINOGRAD:
+            pico_winograd_cpu(&job, scratch);
+            break;
+        default:
+            pico_conv_gemm_cpu(x, w, bias, y, s, act, algo == PICO_CONV_POINTWISE, scratch);
+    }
+}
+
+// the depthwise backward, straight from dy (no im2col, no per-channel GEMMs): dx split
+// by image, dw by channel. either may be NULL
+struct PicoDepthwiseBwdJob {
+    const float* x;
+    const float* w;
+    const float* dy;
+    float* dx;
+    float* dw;
+    const struct PicoConvShape* s;
+};
+
+static inline void pico_depthwise_dx_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoDepthwiseBwdJob* job = (struct PicoDepthwiseBwdJob*)ctx;
+    pico_depthwise_dx_scalar(job->w, job->dy, job->dx, job->s, start, end);
+}
+
+static inline void pico_depthwise_dw_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoDepthwiseBwdJob* job = (struct PicoDepthwiseBwdJob*)ctx;
+    pico_depthwise_dw_scalar(job->x, job->dy, job->dw, job->s, start, end);
+}
+
+static inline void pico_depthwise_backward_cpu(const float* x, const float* w, const float* dy,
+                                               float* dx, float* dw,
+                                               const struct PicoConvShape* s) {
+    struct PicoDepthwiseBwdJob job = {.x = x, .w = w, .dy = dy, .dx = dx, .dw = dw, .s = s};
+    int64_t per_image = s->oh * s->ow * s->c * s->k * s->k;
+    if(dx != NULL)
+        pico_parallel_for(s->n, MAX(1, PICO_CONV_THREAD_MIN_ELEMS / per_image),
+                          pico_depthwise_dx_slice, &job);
+    if(dw != NULL)
+        pico_parallel_for(s->c, MAX(8, PICO_CONV_THREAD_MIN_ELEMS * s->c / (per_image * s->n)),
+                          pico_depthwise_dw_slice, &job);
+}
+
+// layernorm / rmsnorm over the last dim of a contiguous [rows, n] (norm/norm.h). the
+// forward splits rows across threads, each row one stats pass and one apply pass; the
+// backward's dx splits rows the same way, while dw / db (sums over rows) split column
+// tiles so no two threads write the same column. mean NULL means rmsnorm throughout
+#ifndef PICO_NORM_THREAD_MIN_ELEMS
+#define PICO_NORM_THREAD_MIN_ELEMS (1 << 15)
+#endif
+#ifndef PICO_NORM_COL_TILE
+#define PICO_NORM_COL_TILE 64
+#endif
+
+struct PicoNormJob {
+    const float* x;
+    const float* w;
+    const float* b;
+    const float* dy;  // backward only
+    float* y;         // forward only
+    float* mean;
+    float* rstd;
+    float* dx;  // backward only, NULL to skip
+    float* dw;
+    float* db;
+    float eps;
+    int64_t rows;
+    int64_t n;
+};
+
+static inline void pico_norm_fwd_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoNormJob* job = (struct PicoNormJob*)ctx;
+    int64_t n = job->n;
+    for(int64_t r = start; r < end; r++) {
+        const float* x = job->x + r * n;
+        float mean = 0.0f, rstd;
+        switch(g_simd_level) {
+            case SIMD_AVX512:
+            case SIMD_AVX2:
+                if(job->mean != NULL) pico_layernorm_stats_avx2(x, n, job->eps, &mean, &rstd);
+                else rstd = pico_rmsnorm_rstd_avx2(x, n, job->eps);
+                pico_norm_apply_row_avx2(x, mean, rstd, job->w, job->b, job->y + r * n, n);
+                break;
+            default:
+                if(job->mean != NULL) pico_layernorm_stats_scalar(x, n, job->eps, &mean, &rstd);
+                else rstd = pico_rmsnorm_rstd_scalar(x, n, job->eps);
+                pico_norm_apply_row_scalar(x, mean, rstd, job->w, job->b, job->y + r * n, n);
+        }
+        if(job->mean != NULL) job->mean[r] = mean;
+        job->rstd[r] = rstd;
+    }
+}
+
+static inline void pico_norm_dx_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoNormJob* job = (struct PicoNormJob*)ctx;
+    int64_t n = job->n;
+    bool center = job->mean != NULL;
+    for(int64_t r = start; r < end; r++) {
+        float mean = center ? job->mean[r] : 0.0f;
+        const float* x = job->x + r * n;
+        const float* dy = job->dy + r * n;
+        switch(g_simd_level) {
+            case SIMD_AVX512:
+            case SIMD_AVX2:
+                pico_norm_bwd_row_avx2(x, dy, job->w, mean, job->rstd[r], center, job->dx + r * n,
+                                       n);
+                break;
+            default:
+                pico_norm_bwd_row_scalar(x, dy, job->w, mean, job->rstd[r], center,
+                                         job->dx + r * n, n);
+        }
+    }
+}
+
+static inline void pico_norm_param_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoNormJob* job = (struct PicoNormJob*)ctx;
+    int64_t c0 = start * PICO_NORM_COL_TILE, c1 = MIN(end * PICO_NORM_COL_TILE, job->n);
+    switch(g_simd_level) {
+        case SIMD_AVX512:
+        case SIMD_AVX2:
+            pico_norm_param_grad_avx2(job->x, job->dy, job->mean, job->rstd, job->dw, job->db,
+                                      job->rows, job->n, c0, c1);
+            break;
+        default:
+            pico_norm_param_grad_scalar(job->x, job->dy, job->mean, job->rstd, job->dw, job->db,
+                                        job->rows, job->n, c0, c1);
+    }
+}
+
+// y = norm(x) * w + b per row, keeping mean (layernorm only) and rstd per row. w / b
+// may be NULL
+static inline void pico_norm_cpu(const float* x, const float* w, const float* b, float* y,
+                                 float* mean, float* rstd, float eps, int64_t rows, int64_t n) {
+    struct PicoNormJob job = {
+        .x = x, .w = w, .b = b, .y = y, .mean = mean, .rstd = rstd, .eps = eps, .n = n};
+    pico_parallel_for(rows, MAX(1, PICO_NORM_THREAD_MIN_ELEMS / n), pico_norm_fwd_slice, &job);
+}
+
+// dx += d norm(x), dw += Σ dy * x̂, db += Σ dy from the saved mean / rstd. dx, dw and db
+// may each be NULL
+static inline void pico_norm_backward_cpu(const float* x, const float* dy, const float* w,
+                                          float* mean, float* rstd, float* dx, float* dw,
+                                          float* db, int64_t rows, int64_t n) {
+    struct PicoNormJob job = {.x = x, .w = w, .dy = dy, .mean = mean, .rstd = rstd, .dx = dx,
+                              .dw = dw, .db = db, .rows = rows, .n = n};
+    if(dx != NULL)
+        pico_parallel_for(rows, MAX(1, PICO_NORM_THREAD_MIN_ELEMS / n), pico_norm_dx_slice, &job);
+    if(dw != NULL || db != NULL) {
+        int64_t tiles = (n + PICO_NORM_COL_TILE - 1) / PICO_NORM_COL_TILE;
+        pico_parallel_for(tiles, MAX(1, PICO_NORM_THREAD_MIN_ELEMS / (rows * PICO_NORM_COL_TILE)),
+                          pico_norm_param_slice, &job);
+    }
+}
+
+// embedding lookup and its grads (nn/embedding.c). ids are row indices held as floats
+// (like class labels), already range-checked. the gather splits ids across threads. a
+// dense grad is scattered serially (two ids may name one row); the sparse grad sorts
+// the ids instead, so every touched row is summed by one thread and no writes collide
+#ifndef PICO_EMBEDDING_THREAD_MIN_ELEMS
+#define PICO_EMBEDDING_THREAD_MIN_ELEMS (1 << 15)
+#endif
+
+struct PicoEmbeddingId {
+    int64_t row;
+    int64_t pos;  // into ids / dy
+};
+
+struct PicoEmbeddingJob {
+    const float* table;
+    const float* ids;
+    const float* dy;
+    float* out;
+    const struct PicoEmbeddingId* sorted;  // sparse backward: ids by (row, pos)
+    const int64_t* starts;                 // row k's ids are sorted[starts[k], starts[k + 1])
+    const int64_t* old;                    // row k's slot in the old values, -1 for new
+    const float* old_values;
+    int64_t dim;
+};
+
+static inline void pico_embedding_gather_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoEmbeddingJob* job = (struct PicoEmbeddingJob*)ctx;
+    for(int64_t i = start; i < end; i++) {
+        memcpy(job->out + i * job->dim, job->table + (int64_t)job->ids[i] * job->dim,
+               sizeof(float) * job->dim);
+    }
+}
+
+static inline void pico_embedding_sum_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoEmbeddingJob* job = (struct PicoEmbeddingJob*)ctx;
+    int64_t dim = job->dim;
+    for(int64_t k = start; k < end; k++) {
+        float* dst = job->out + k * dim;
+        if(job->old[k] >= 0) memcpy(dst, job->old_values + job->old[k] * dim, sizeof(float) * dim);
+        else memset(dst, 0, sizeof(float) * dim);
+        for(int64_t p = job->starts[k]; p < job->starts[k + 1]; p++) {
+            const float* g = job->dy + job->sorted[p].pos * dim;
+            for(int64_t j = 0; j < dim; j++) dst[j] += g[j];
+        }
+    }
+}
+
+static inline int pico_embedding_id_cmp(const void* a, const void* b) {
+    const struct PicoEmbeddingId* x = (const struct PicoEmbeddingId*)a;
+    const struct PicoEmbeddingId* y = (const struct PicoEmbeddingId*)b;
+    if(x->row != y->row) return x->row < y->row ? -1 : 1;
+    return (x->pos > y->pos) - (x->pos < y->pos);
+}
+
+// out[i] = table[ids[i]], n rows of dim
+static inline void pico_embedding_gather_cpu(const float* table, const float* ids, float* out,
+                                             int64_t n, int64_t dim) {
+    struct PicoEmbeddingJob job = {.table = table, .ids = ids, .out = out, .dim = dim};
+    pico_parallel_for(n, MAX(1, PICO_EMBEDDING_THREAD_MIN_ELEMS / dim),
+                      pico_embedding_gather_slice, &job);
+}
+
+// grad[ids[i]] += dy[i]
+static inline void pico_embedding_scatter_cpu(const float* ids, const float* dy, float* grad,
+                                              int64_t n, int64_t dim) {
+    for(int64_t i = 0; i < n; i++) {
+        float* dst = grad + (int64_t)ids[i] * dim;
+        for(int64_t j = 0; j < dim; j++) dst[j] += dy[i * dim + j];
+    }
+}
+
+// the sparse grad += dy[i] on row ids[i]: ids sorted by row, merged with the rows
+// already there, then each row of the merged list summed on its own
+static inline bool pico_embedding_sparse_add_cpu(struct PicoSparseGrad* grad, const float* ids,
+                                                 const float* dy, int64_t n) {
+    int64_t cap = grad->n + n, dim = grad->dim;
+    struct PicoEmbeddingId* sorted = malloc(sizeof(struct PicoEmbeddingId) * (n > 0 ? n : 1));
+    int64_t* rows = malloc(sizeof(int64_t) * (cap > 0 ? cap : 1));
+    int64_t* old = malloc(sizeof(int64_t) * (cap > 0 ? cap : 1));
+    int64_t* starts = malloc(sizeof(int64_t) * (cap + 1));
+    if(sorted == NULL || rows == NULL || old == NULL || starts == NULL) {
+        free(sorted);
+        free(rows);
+        free(old);
+        free(starts);
+        return false;
+    }
+    for(int64_t i = 0; i < n; i++) {
+        sorted[i].row = (int64_t)ids[i];
+        sorted[i].pos = i;
+    }
+    qsort(sorted, n, sizeof(struct PicoEmbeddingId), pico_embedding_id_cmp);
+
+    int64_t m = 0, i = 0, p = 0;
+    while(i < grad->n || p < n) {
+        int64_t r_old = i < grad->n ? grad->rows[i] : INT64_MAX;
+        int64_t r_new = p < n ? sorted[p].row : INT64_MAX;
+        int64_t r = MIN(r_old, r_new);
+        rows[m] = r;
+        old[m] = r_old == r ? i++ : -1;
+        starts[m] = p;
+        while(p < n && sorted[p].row == r) p++;
+        m++;
+    }
+    starts[m] = n;
+
+    float* values = malloc(sizeof(float) * (m > 0 ? m : 1) * dim);
+    if(values == NULL) {
+        free(sorted);
+        free(rows);
+        free(old);
+        free(starts);
+        return false;
+    }
+    struct PicoEmbeddingJob job = {.dy = dy, .out = values, .sorted = sorted, .starts = starts,
+                                   .old = old, .old_values = grad->values, .dim = dim};
+    pico_parallel_for(m, MAX(1, PICO_EMBEDDING_THREAD_MIN_ELEMS / dim), pico_embedding_sum_slice,
+                      &job);
+
+    free(grad->rows);
+    free(grad->values);
+    grad->rows = rows;
+    grad->values = values;
+    grad->n = m;
+    free(sorted);
+    free(old);
+    free(starts);
+    return true;
+}
+
+// scaled-dot-product attention, flash style (attention/attention.h), on contiguous
+// q [bh, lq, d], k [bh, lk, d], v [bh, lk, dv]. the L×L score matrix is never built:
+// each block of PICO_ATTN_BLOCK_Q query rows walks the keys a block at a time, the key
+// block sized so its K and V rows fit PICO_ATTN_TILE_FLOATS (an L1), and every query row
+// keeps a running max m, sum l and output, rescaled by the online softmax as each block
+// lands. only the per-row logsumexp m + log(l) is saved. the backward recomputes each
+// score block from q, k and it (FlashAttention-2): keys outer, so a block's dK / dV rows
+// stay hot while every query row streams past. both split batch × heads across threads,
+// one (batch, head) per thread at a time, so no two threads ever write the same row
+#ifndef PICO_ATTN_THREAD_MIN_ELEMS
+#define PICO_ATTN_THREAD_MIN_ELEMS (1 << 15)
+#endif
+#ifndef PICO_ATTN_BLOCK_Q
+#define PICO_ATTN_BLOCK_Q 32
+#endif
+#ifndef PICO_ATTN_TILE_FLOATS
+#define PICO_ATTN_TILE_FLOATS (1 << 13)
+#endif
+#define PICO_ATTN_MAX_BLOCK_K 256
+
+struct PicoAttentionJob {
+    const float* q;
+    const float* k;
+    const float* v;
+    const float* mask;  // additive [lq, lk] per (batch, head), NULL for none
+    const float* out;   // backward: the forward's output
+    const float* dout;  // backward only
+    float* y;           // forward only
+    float* lse;         // [bh, lq]
+    float* delta;       // backward: Σ dout * out per query row, [bh, lq]
+    float* dq;          // backward, each NULL to skip
+    float* dk;
+    float* dv;
+    int64_t mask_stride;  // 0 when one mask is shared by every (batch, head)
+    int64_t lq;
+    int64_t lk;
+    int64_t dim;
+    int64_t vdim;
+    int64_t block_k;
+    float scale;
+};
+
+// keys per block: K + V rows within the tile, a multiple of 8 for the vector loops
+static inline int64_t pico_attn_block_k(int64_t dim, int64_t vdim) {
+    int64_t bk = PICO_ATTN_TILE_FLOATS / (dim + vdim) & ~(int64_t)7;
+    return MIN(PICO_ATTN_MAX_BLOCK_K, MAX(8, bk));
+}
+
+static inline void pico_attn_fwd_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoAttentionJob* job = (struct PicoAttentionJob*)ctx;
+    int64_t lq = job->lq, lk = job->lk, dim = job->dim, vdim = job->vdim;
+    float s[PICO_ATTN_MAX_BLOCK_K], m[PICO_ATTN_BLOCK_Q], l[PICO_ATTN_BLOCK_Q];
+    for(int64_t b = start; b < end; b++) {
+        const float* q = job->q + b * lq * dim;
+        const float* k = job->k + b * lk * dim;
+        const float* v = job->v + b * lk * vdim;
+        const float* mask = job->mask != NULL ? job->mask + b * job->mask_stride : NULL;
+        float* y = job->y + b * lq * vdim;
+        float* lse = job->lse + b * lq;
+        for(int64_t i0 = 0; i0 < lq; i0 += PICO_ATTN_BLOCK_Q) {
+            int64_t br = MIN(PICO_ATTN_BLOCK_Q, lq - i0);
+            for(int64_t r = 0; r < br; r++) {
+                m[r] = -FLT_MAX;
+                l[r] = 0.0f;
+            }
+            for(int64_t j0 = 0; j0 < lk; j0 += job->block_k) {
+                int64_t bc = MIN(job->block_k, lk - j0);
+                for(int64_t r = 0; r < br; r++) {
+                    int64_t i = i0 + r;
+                    const float* mrow = mask != NULL ? mask + i * lk + j0 : NULL;
+                    float alpha;
+                    switch(g_simd_level) {
+                        case SIMD_AVX512:
+                        case SIMD_AVX2:
+                            pico_attn_scores_avx2(q + i * dim, k + j0 * dim, mrow, s, bc, dim,
+                                                  job->scale);
+                            alpha = pico_attn_online_avx2(s, bc, &m[r], &l[r]);
+                            pico_attn_pv_avx2(s, v + j0 * vdim, y + i * vdim, bc, vdim, alpha);
+                            break;
+                        default:
+                            pico_attn_scores_scalar(q + i * dim, k + j0 * dim, mrow, s, bc, dim,
+                                                    job->scale);
+                            alpha = pico_attn_online_scalar(s, bc, &m[r], &l[r]);
+                            pico_attn_pv_scalar(s, v + j0 * vdim, y + i * vdim, bc, vdim, alpha);
+                    }
+                }
+            }
+            // a row whose every key is masked out gets y = 0, and lse = inf gives it
+            // P = 0 in the backward
+            for(int64_t r = 0; r < br; r++) {
+                float* yr = y + (i0 + r) * vdim;
+                float inv = l[r] > 0.0f ? 1.0f / l[r] : 0.0f;
+                for(int64_t j = 0; j < vdim; j++) yr[j] *= inv;
+                lse[i0 + r] = l[r] > 0.0f ? m[r] + logf(l[r]) : INFINITY;
+            }
+        }
+    }
+}
+
+// with P = exp(S - lse) and D = Σ dout * out per row:
+//   dV += Pᵀ dout,   dS = P ∘ (dout Vᵀ - D),   dQ += scale dS K,   dK += scale dSᵀ Q
+static inline void pico_attn_bwd_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoAttentionJob* job = (struct PicoAttentionJob*)ctx;
+    int64_t lq = job->lq, lk = job->lk, dim = job->dim, vdim = job->vdim;
+    bool need_ds = job->dq != NULL || job->dk != NULL;
+    float p[PICO_ATTN_MAX_BLOCK_K], ds[PICO_ATTN_MAX_BLOCK_K];
+    for(int64_t b = start; b < end; b++) {
+        const float* q = job->q + b * lq * dim;
+        const float* k = job->k + b * lk * dim;
+        const float* v = job->v + b * lk * vdim;
+        const float* mask = job->mask != NULL ? job->mask + b * job->mask_stride : NULL;
+        const float* out = job->out + b * lq * vdim;
+        const float* dout = job->dout + b * lq * vdim;
+        const float* lse = job->lse + b * lq;
+        float* delta = job->delta + b * lq;
+        float* dq = job->dq != NULL ? job->dq + b * lq * dim : NULL;
+        float* dk = job->dk != NULL ? job->dk + b * lk * dim : NULL;
+        float* dv = job->dv != NULL ? job->dv + b * lk * vdim : NULL;
+        for(int64_t i = 0; i < lq; i++) {
+            float acc = 0.0f;
+            for(int64_t j = 0; j < vdim; j++) acc += dout[i * vdim + j] * out[i * vdim + j];
+            delta[i] = acc;
+        }
+        for(int64_t j0 = 0; j0 < lk; j0 += job->block_k) {
+            int64_t bc = MIN(job->block_k, lk - j0);
+            for(int64_t i = 0; i < lq; i++) {
+                const float* mrow = mask != NULL ? mask + i * lk + j0 : NULL;
+                const float* gi = dout + i * vdim;
+                switch(g_simd_level) {
+                    case SIMD_AVX512:
+                    case SIMD_AVX2:
+                        pico_attn_scores_avx2(q + i * dim, k + j0 * dim, mrow, p, bc, dim,
+                                              job->scale);
+                        pico_attn_probs_avx2(p, bc, lse[i]);
+                        if(dv != NULL) pico_attn_outer_avx2(p, gi, dv + j0 * vdim, bc, vdim);
+                        if(need_ds)
+                            pico_attn_scores_avx2(gi, v + j0 * vdim, NULL, ds, bc, vdim, 1.0f);
+                        break;
+                    default:
+                        pico_attn_scores_scalar(q + i * dim, k + j0 * dim, mrow, p, bc, dim,
+                                                job->scale);
+                        pico_attn_probs_scalar(p, bc, lse[i]);
+                        if(dv != NULL) pico_attn_outer_scalar(p, gi, dv + j0 * vdim, bc, vdim);
+                        if(need_ds)
+                            pico_attn_scores_scalar(gi, v + j0 * vdim, NULL, ds, bc, vdim, 1.0f);
+                }
+                if(!need_ds) continue;
+                for(int64_t c = 0; c < bc; c++) ds[c] = job->scale * p[c] * (ds[c] - delta[i]);
+                switch(g_simd_level) {
+                    case SIMD_AVX512:
+                    case SIMD_AVX2:
+                        if(dq != NULL)
+                            pico_attn_pv_avx2(ds, k + j0 * dim, dq + i * dim, bc, dim, 1.0f);
+                        if(dk != NULL)
+                            pico_attn_outer_avx2(ds, q + i * dim, dk + j0 * dim, bc, dim);
+                        break;
+                    default:
+                        if(dq != NULL)
+                            pico_attn_pv_scalar(ds, k + j0 * dim, dq + i * dim, bc, dim, 1.0f);
+                        if(dk != NULL)
+                            pico_attn_outer_scalar(ds, q + i * dim, dk + j0 * dim, bc, dim);
+                }
+            }
+        }
+    }
+}
+
+// y = softmax(q kᵀ * scale + mask) v over bh (batch, head) pairs, keeping the per-row
+// logsumexp in lse [bh, lq]. y must start zeroed. mask may be NULL; mask_stride is 0 when
+// one [lq, lk] mask serves every pair
+static inline void pico_attention_cpu(const float* q, const float* k, const float* v,
+                                      const float* mask, int64_t mask_stride, float* y,
+                                      float* lse, int64_t bh, int64_t lq, int64_t lk,
+                                      int64_t dim, int64_t vdim, float scale) {
+    struct PicoAttentionJob job = {.q = q, .k = k, .v = v, .mask = mask, .y = y, .lse = lse,
+                                   .mask_stride = mask_stride, .lq = lq, .lk = lk, .dim = dim,
+                                   .vdim = vdim, .block_k = pico_attn_block_k(dim, vdim),
+                                   .scale = scale};
+    int64_t work = lq * lk * (dim + vdim);
+    pico_parallel_for(bh, MAX(1, PICO_ATTN_THREAD_MIN_ELEMS / MAX(1, work)), pico_attn_fwd_slice,
+                      &job);
+}
+
+// dq, dk, dv += the grads of y given dout, from the forward's y and lse. delta is
+// [bh, lq] scratch; dq, dk and dv may each be NULL
+static inline void pico_attention_backward_cpu(const float* q, const float* k, const float* v,
+                                               const float* mask, int64_t mask_stride,
+                                               const float* y, const float* dout,
+                                               float* lse, float* delta, float* dq,
+                                               float* dk, float* dv, int64_t bh, int64_t lq,
+                                               int64_t lk, int64_t dim, int64_t vdim,
+                                               float scale) {
+    struct PicoAttentionJob job = {.q = q, .k = k, .v = v, .mask = mask, .out = y,
+                                   .dout = dout, .lse = lse, .delta = delta, .dq = dq,
+                                   .dk = dk, .dv = dv, .mask_stride = mask_stride, .lq = lq,
+                                   .lk = lk, .dim = dim, .vdim = vdim,
+                                   .block_k = pico_attn_block_k(dim, vdim), .scale = scale};
+    int64_t work = 2 * lq * lk * (dim + vdim);
+    pico_parallel_for(bh, MAX(1, PICO_ATTN_THREAD_MIN_ELEMS / MAX(1, work)), pico_attn_bwd_slice,
+                      &job);
+}
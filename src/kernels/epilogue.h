@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "tensor.h"
+
+// GEMM epilogue: work done on a C tile right before it is stored, while it is still
+// in registers (AVX) or in L1 (scalar). `C = A·B` followed by `+ bias` and an
+// activation becomes one pass instead of three (matmul, broadcast add, activation).
+
+enum PicoActivation { PICO_ACT_NONE, PICO_ACT_RELU };
+
+struct PicoMatmulEpilogue {
+    const float* bias;  // [columns], added to every row. NULL = no bias
+    enum PicoActivation act;
+};
+
+static inline float pico_epilogue_apply_f32(const struct PicoMatmulEpilogue* epi, float v,
+                                            int64_t j) {
+    if(epi->bias != NULL) {
+        v += epi->bias[j];
+    }
+    if(epi->act == PICO_ACT_RELU) {
+        v = MAX(v, 0.0f);
+    }
+    return v;
+}
@@ -3,39 +3,48 @@
  */
 
 #pragma once
+#include "kernels/cpu_kernels.h"
 #include "tensor.h"
 
 
-static inline void pico_mse_loss_mean_backward(struct PicoTensor* self) {
+// d(loss)/d(pred_i) = k * (pred_i - actual_i) * upstream, and minus that for actual_i.
+// k = 2/N (mean) or 2 (sum); the one kernel pass writes both sides, and skips any
+// side with requires_grad == 0 (usually the targets).
+static inline void pico_mse_loss_backward_scaled(struct PicoTensor* self, const float* dy,
+                                                 float scale) {
     struct PicoTensor* prediction = self->parents[0];
     struct PicoTensor* actuals = self->parents[1];
+    if(prediction->backend != CPU) return;
 
-    float upstream = self->grad[0];  // the loss is a single scalar
-    int64_t N = prediction->numel;
-
-    for(int64_t i = 0; i < N; i++) {
-        
-        // local sensitivity: d(loss)/d(pred_i) = (2/N) * (pred_i - actual_i)
-        float local = (2.0f / N) * (prediction->data[i] - actuals->data[i]);
+    pico_mse_backward_cpu(prediction->data, actuals->data, dy, scale,
+                          prediction->requires_grad ? prediction->grad : NULL,
+                          actuals->requires_grad ? actuals->grad : NULL, prediction->numel);
+}
 
-        prediction->grad[i] += local * upstream;
-        actuals->grad[i] += -local * upstream;
-    }
+static inline void pico_mse_loss_mean_backward(struct PicoTensor* self) {
+    int64_t N = self->parents[0]->numel;
+    pico_mse_loss_backward_scaled(self, NULL, 2.0f / (float)N * self->grad[0]);
 }
 
 static inline void pico_mse_loss_sum_backward(struct PicoTensor* self) {
-    struct PicoTensor* prediction = self->parents[0];
-    struct PicoTensor* actuals = self->parents[1];
-
-    float upstream = self->grad[0];  // the loss is a single scalar
-    int64_t N = prediction->numel;
+    pico_mse_loss_backward_scaled(self, NULL, 2.0f * self->grad[0]);
+}
 
-    for(int64_t i = 0; i < N; i++) {
-        
-        // local sensitivity: d(loss)/d(pred_i) = 2 * (pred_i - actual_i)
-        float local = (2.0f) * (prediction->data[i] - actuals->data[i]);
+// per-element losses: each one has its own upstream grad
+static inline void pico_mse_loss_none_backward(struct PicoTensor* self) {
+    pico_mse_loss_backward_scaled(self, self->grad, 2.0f);
+}
 
-        prediction->grad[i] += local * upstream;
-        actuals->grad[i] += -local * upstream;
+// d(loss)/d(logits[n]) = (softmax(logits[n]) - onehot(labels[n])) / N. softmax comes
+// back from the per-row logsumexp the forward saved in self->_ctx. labels get no grad.
+static inline void pico_cross_entropy_loss_backward(struct PicoTensor* self) {
+    struct PicoTensor* logits = self->parents[0];
+    struct PicoTensor* labels = self->parents[1];
+    int64_t C = logits->shape[logits->ndim - 1];
+    int64_t N = logits->numel / C;
+
+    if(logits->backend == CPU) {
+        pico_cross_entropy_backward_cpu(logits->data, labels->data, (float*)self->_ctx,
+                                        self->grad[0] / (float)N, logits->grad, N, C);
     }
 }
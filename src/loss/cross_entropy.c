@@ -0,0 +1,64 @@
+#include <stdint.h>
+#include <stdio.h>
+
+#include "arena.h"
+#include "kernels/cpu_kernels.h"
+#include "loss.h"
+#include "loss/autograd.h"
+#include "tensor.h"
+#include "view/view.h"
+
+struct PicoTensor* pico_cross_entropy_loss(struct PicoTensor* logits, struct PicoTensor* labels) {
+    if(logits->ndim < 1 || logits->ndim > 2) {
+        fprintf(stderr, "[Pico] Error: Cross-entropy logits must be [N, C] or [C]!\n");
+        return NULL;
+    }
+
+    int64_t C = logits->shape[logits->ndim - 1];
+    int64_t N = logits->numel / C;
+    if(labels->numel != N) {
+        fprintf(stderr, "[Pico] Error: Cross-entropy needs one label per row of logits!\n");
+        return NULL;
+    }
+    if(logits->backend != labels->backend) {
+        fprintf(stderr, "[Pico] Error: PicoTensor backends are not compatible!\n");
+        return NULL;
+    }
+
+    struct Arena* arena = arena_ctx_current();
+    if(arena == NULL) {
+        fprintf(stderr, "[Pico] Error: No current arena in context!\n");
+        return NULL;
+    }
+    logits = pico_as_f32(pico_contiguous(logits));
+    labels = pico_as_f32(pico_contiguous(labels));
+    // checked in logical order: a strided or expanded labels view is dense by now
+    for(int64_t n = 0; n < N; n++) {
+        float l = labels->data[n];
+        if(!(l >= 0.0f && l < (float)C) || l != (float)(int64_t)l) {
+            fprintf(stderr, "[Pico] Error: Cross-entropy label %g is not a class in [0, %ld)!\n",
+                    l, (long)C);
+            return NULL;
+        }
+    }
+    int64_t shape[] = {1};
+    struct PicoTensor* out = pico_create_tensor(arena, shape, 1);
+    out->backend = logits->backend;
+
+    // per-row logsumexp, kept for the backward
+    float* lse = arena_alloc(arena, sizeof(float) * N);
+    if(logits->backend == CPU) {
+        float* row_loss = arena_alloc(arena, sizeof(float) * N);
+        pico_cross_entropy_cpu(logits->data, labels->data, lse, row_loss, N, C);
+        out->data[0] = pico_reduce_row_cpu(PICO_REDUCE_SUM, row_loss, N) / (float)N;
+    }
+
+    out->parents = arena_alloc(arena, sizeof(struct PicoTensor*) * 2);
+    out->parents[0] = logits;
+    out->parents[1] = labels;
+    out->num_parents = 2;
+    out->_ctx = lse;
+    out->_backward = pico_cross_entropy_loss_backward;
+
+    return out;
+}
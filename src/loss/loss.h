@@ -5,6 +5,9 @@
 
 // ==================== MSE
 
+// MEAN / SUM give a {1} loss; NONE gives the per-element (pred - actual)^2 in the
+// predictions' shape. shapes must match exactly. set actuals->requires_grad = 0 for
+// constant targets and the backward won't write their grad.
 enum PicoMSEReductionType { MEAN, SUM, NONE };
 
 struct PicoMSELoss {
@@ -14,3 +17,12 @@ struct PicoMSELoss {
 struct PicoMSELoss* pico_mse_loss_init(struct Arena * arena, enum PicoMSEReductionType reduction);
 struct PicoTensor* pico_mse_loss(struct PicoMSELoss * mse, struct PicoTensor* predictions, struct PicoTensor* actuals);
 
+
+
+// ==================== Cross-entropy
+
+// mean over the batch of -log softmax(logits[n])[labels[n]]. logits is [N, C] (or [C]
+// for a single sample), labels holds N class indices as floats. fused: log-softmax is
+// one online max/sum-exp pass per row, and the backward writes softmax - onehot
+// straight into logits->grad, so the probabilities are never stored.
+struct PicoTensor* pico_cross_entropy_loss(struct PicoTensor* logits, struct PicoTensor* labels);
@@ -1,16 +1,12 @@
-#include <math.h>
 #include <stdint.h>
+#include <stdio.h>
 
 #include "arena.h"
+#include "kernels/cpu_kernels.h"
 #include "loss.h"
 #include "loss/autograd.h"
 #include "tensor.h"
-
-void pico_mse_loss_mean(struct PicoTensor* out, struct PicoTensor* prediction,
-                        struct PicoTensor* actuals);
-
-void pico_mse_loss_sum(struct PicoTensor* out, struct PicoTensor* prediction,
-                       struct PicoTensor* actuals);
+#include "view/view.h"
 
 struct PicoMSELoss* pico_mse_loss_init(struct Arena* arena, enum PicoMSEReductionType reduction) {
     struct PicoMSELoss* mse = (struct PicoMSELoss*)arena_alloc(arena, sizeof(struct PicoMSELoss));
@@ -20,12 +16,15 @@ struct PicoMSELoss* pico_mse_loss_init(struct Arena* arena, enum PicoMSEReductio
 
 struct PicoTensor* pico_mse_loss(struct PicoMSELoss* mse, struct PicoTensor* predictions,
                                  struct PicoTensor* actuals) {
-    // if(predictions->shape != actuals->shape) {
-    //     fprintf(stderr, "[Pico] Error: PicoTensors are not compatible!\n");
-    //     return NULL;
-    // }
-    // TODO:
-    // WARN:: loop through shape and compare then check ndiim too
+    // exact shape match, no broadcasting: a [N, 1] vs [N] mixup should fail loudly
+    bool same_shape = predictions->ndim == actuals->ndim;
+    for(int d = 0; same_shape && d < predictions->ndim; d++) {
+        same_shape = predictions->shape[d] == actuals->shape[d];
+    }
+    if(!same_shape) {
+        fprintf(stderr, "[Pico] Error: MSE predictions and actuals must have the same shape!\n");
+        return NULL;
+    }
 
     if(predictions->backend != actuals->backend) {
         fprintf(stderr, "[Pico] Error: PicoTensor backends are not compatible!\n");
@@ -37,16 +36,39 @@ struct PicoTensor* pico_mse_loss(struct PicoMSELoss* mse, struct PicoTensor* pre
         fprintf(stderr, "[Pico] Error: No current arena in context!\n");
         return NULL;
     }
-    struct PicoTensor* out = pico_create_tensor(arena, predictions->shape, predictions->ndim);
+    predictions = pico_as_f32(pico_contiguous(predictions));
+    actuals = pico_as_f32(pico_contiguous(actuals));
+
+    int64_t scalar_shape[] = {1};
+    struct PicoTensor* out;
+    if(mse->reduction == NONE) {
+        out = pico_create_tensor(arena, predictions->shape, predictions->ndim);
+    } else {
+        out = pico_create_tensor(arena, scalar_shape, 1);
+    }
+    out->backend = predictions->backend;
 
+    int64_t n = predictions->numel;
     switch(mse->reduction) {
-        case SUM:
-            pico_mse_loss_sum(out, predictions, actuals);
-            out->_backward = pico_mse_loss_sum_backward;
+        case NONE:
+            if(predictions->backend == CPU) {
+                pico_sq_diff_cpu(predictions->data, actuals->data, out->data, n);
+            }
+            out->_backward = pico_mse_loss_none_backward;
             break;
-        default:
-            pico_mse_loss_mean(out, predictions, actuals);
-            out->_backward = pico_mse_loss_mean_backward;
+        case SUM:
+        case MEAN:
+            if(predictions->backend == CPU) {
+                int64_t blocks = (n + PICO_MSE_BLOCK - 1) / PICO_MSE_BLOCK;
+                float* partials = arena_alloc(arena, sizeof(float) * blocks);
+                out->data[0] = pico_mse_sum_cpu(predictions->data, actuals->data, partials, n);
+            }
+            if(mse->reduction == MEAN) {
+                out->data[0] /= (float)n;
+                out->_backward = pico_mse_loss_mean_backward;
+            } else {
+                out->_backward = pico_mse_loss_sum_backward;
+            }
             break;
     }
 
@@ -55,31 +77,5 @@ struct PicoTensor* pico_mse_loss(struct PicoMSELoss* mse, struct PicoTensor* pre
     out->parents[1] = actuals;
     out->num_parents = 2;
 
-    out->ndim = 0;
-    out->shape = NULL;
-    out->numel = 1;
-
     return out;
 }
-
-void pico_mse_loss_mean(struct PicoTensor* out, struct PicoTensor* prediction,
-                        struct PicoTensor* actuals) {
-    float loss = 0;
-    for(int i = 0; i < prediction->numel; i++) {
-        loss += powf((prediction->data[i] - actuals->data[i]), 2.0f);
-    }
-
-    loss = loss / prediction->numel;
-
-    out->data[0] = loss;
-}
-
-void pico_mse_loss_sum(struct PicoTensor* out, struct PicoTensor* prediction,
-                       struct PicoTensor* actuals) {
-    float loss = 0;
-    for(int i = 0; i < prediction->numel; i++) {
-        loss += powf((prediction->data[i] - actuals->data[i]), 2.0f);
-    }
-
-    out->data[0] = loss;
-}
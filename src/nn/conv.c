@@ -0,0 +1,133 @@
+#include "conv.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "arena.h"
+#include "kernels/cpu_kernels.h"
+#include "nn/init.h"
+#include "nn/nn_autograd.h"
+#include "tensor.h"
+#include "view/view.h"
+
+struct PicoConv2d* pico_nn_conv2d_init(int in_channels, int out_channels, int kernel_size,
+                                       int stride, int padding, int dilation, int groups,
+                                       bool bias) {
+    if(in_channels < 1 || out_channels < 1 || kernel_size < 1 || stride < 1 || padding < 0 ||
+       dilation < 1 || groups < 1 || in_channels % groups != 0 || out_channels % groups != 0) {
+        fprintf(stderr, "[Pico] Error: In Conv2d - bad configuration!\n");
+        return NULL;
+    }
+
+    int64_t w_shape[4] = {kernel_size, kernel_size, in_channels / groups, out_channels};
+    int64_t b_shape[1] = {out_channels};
+    struct PicoTensor* weights_t = pico_param(w_shape, 4);
+    struct PicoTensor* bias_t = bias ? pico_param(b_shape, 1) : NULL;
+
+    float bound = 1.0f / sqrtf((float)(kernel_size * kernel_size * (in_channels / groups)));
+    pico_nn_init_uniform(weights_t, -bound, bound);
+    if(bias_t != NULL) pico_nn_init_uniform(bias_t, -bound, bound);
+
+    struct PicoConv2d* conv = malloc(sizeof(struct PicoConv2d));
+    conv->in_channels = in_channels;
+    conv->out_channels = out_channels;
+    conv->kernel_size = kernel_size;
+    conv->stride = stride;
+    conv->padding = padding;
+    conv->dilation = dilation;
+    conv->groups = groups;
+    conv->weights = weights_t;
+    conv->bias = bias_t;
+    return conv;
+}
+
+struct PicoTensor* pico_nn_conv2d_forward(struct PicoConv2d* layer, struct PicoTensor* input) {
+    return pico_nn_conv2d_forward_act(layer, input, PICO_ACT_NONE);
+}
+
+struct PicoTensor* pico_nn_conv2d_forward_act(struct PicoConv2d* layer, struct PicoTensor* input,
+                                              enum PicoActivation act) {
+    if(input->ndim != 4 || input->shape[3] != layer->in_channels) {
+        fprintf(stderr, "[Pico] Error: In Conv2d - input must be [n, h, w, %d]!\n",
+                layer->in_channels);
+        return NULL;
+    }
+    if(layer->weights->backend != input->backend) {
+        fprintf(stderr, "[Pico] Error: In Conv2d - PicoTensor backends are not compatible!\n");
+        return NULL;
+    }
+
+    struct Arena* arena = arena_ctx_current();
+    if(arena == NULL) {
+        fprintf(stderr, "[Pico] Error: In Conv2d - No current arena in context!\n");
+        return NULL;
+    }
+
+    struct PicoConvShape* s = arena_alloc(arena, sizeof(struct PicoConvShape));
+    s->n = input->shape[0];
+    s->h = input->shape[1];
+    s->w = input->shape[2];
+    s->c = layer->in_channels;
+    s->oc = layer->out_channels;
+    s->k = layer->kernel_size;
+    s->stride = layer->stride;
+    s->pad = layer->padding;
+    s->dilation = layer->dilation;
+    s->groups = layer->groups;
+    s->oh = pico_conv_out_size(s->h, s->k, s->stride, s->pad, s->dilation);
+    s->ow = pico_conv_out_size(s->w, s->k, s->stride, s->pad, s->dilation);
+    if(s->oh < 1 || s->ow < 1) {
+        fprintf(stderr, "[Pico] Error: In Conv2d - the kernel doesn't fit a %lldx%lld input!\n",
+                (long long)s->h, (long long)s->w);
+        return NULL;
+    }
+    input = pico_as_f32(pico_contiguous(input));
+
+    int64_t out_shape[4] = {s->n, s->oh, s->ow, s->oc};
+    struct PicoTensor* output = pico_create_tensor(arena, out_shape, 4);
+    output->backend = input->backend;
+
+    if(input->backend == CPU) {
+        enum PicoConvAlgo algo = pico_conv_select(s);
+        int64_t scratch_floats = pico_conv_scratch_floats(s, algo);
+        float* scratch =
+            scratch_floats > 0 ? arena_alloc(arena, sizeof(float) * scratch_floats) : NULL;
+
+        struct PicoTensor w_tmp;
+        struct PicoTensor* w32 = pico_tensor_f32_borrow(layer->weights, &w_tmp);
+        struct PicoTensor bias_tmp;
+        struct PicoTensor* bias32 =
+            layer->bias != NULL ? pico_tensor_f32_borrow(layer->bias, &bias_tmp) : NULL;
+
+        pico_conv2d_cpu(input->data, w32->data, bias32 != NULL ? bias32->data : NULL,
+                        output->data, s, act, algo, scratch);
+
+        if(bias32 != NULL) pico_tensor_f32_release(bias32, layer->bias);
+        pico_tensor_f32_release(w32, layer->weights);
+    }
+
+    int num_parents = layer->bias != NULL ? 3 : 2;
+    output->parents = arena_alloc(arena, sizeof(struct PicoTensor*) * num_parents);
+    output->parents[0] = input;
+    output->parents[1] = layer->weights;
+    if(layer->bias != NULL) {
+        output->parents[2] = layer->bias;
+    }
+    output->num_parents = num_parents;
+    output->_ctx = s;
+    output->_backward =
+        act == PICO_ACT_RELU ? pico_nn_conv2d_relu_backward : pico_nn_conv2d_backward;
+
+    return output;
+}
+
+void pico_nn_conv2d_free(struct PicoConv2d* layer) {
+    if(layer == NULL) {
+        return;
+    }
+
+    pico_free(layer->weights);
+    pico_free(layer->bias);
+    free(layer);
+}
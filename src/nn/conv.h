@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include "kernels/conv.h"
+#include "kernels/epilogue.h"
+#include "tensor.h"
+
+// 2-d convolution on NHWC activations ([batch, height, width, channels]): square
+// kernels, zero padding, dilation, and groups (in_channels and out_channels both
+// divisible by groups; groups == in_channels is a depthwise conv). each group is an
+// im2col of the input into arena scratch followed by one GEMM against its slice of the
+// weights. a 1x1 conv with stride 1 and no padding skips the im2col: NHWC input is
+// already the [batch * height * width, channels] matrix the GEMM wants. depthwise convs
+// run a direct loop instead, and wide 3x3 stride-1 convs Winograd F(2x2, 3x3) (the
+// shape picks: pico_conv_select in kernels/conv.h).
+struct PicoConv2d {
+    int in_channels;
+    int out_channels;
+    int kernel_size;
+    int stride;
+    int padding;
+    int dilation;
+    int groups;
+    struct PicoTensor* weights;  // Shape: [kernel_size, kernel_size, in_channels / groups,
+                                 //         out_channels]
+    struct PicoTensor* bias;     // Shape: [out_channels], NULL without
+};
+
+// weights and bias start uniform on +-1/sqrt(fan_in), fan_in = k * k * in_channels /
+// groups (PyTorch's default), drawn from g_pico_rng. NULL on a bad configuration
+struct PicoConv2d* pico_nn_conv2d_init(int in_channels, int out_channels, int kernel_size,
+                                       int stride, int padding, int dilation, int groups,
+                                       bool bias);
+
+// input [n, h, w, in_channels] -> [n, oh, ow, out_channels]
+struct PicoTensor* pico_nn_conv2d_forward(struct PicoConv2d* layer, struct PicoTensor* input);
+
+// act(conv + bias) as one node: bias and activation run in the GEMM epilogue, like
+// pico_nn_linear_forward_act
+struct PicoTensor* pico_nn_conv2d_forward_act(struct PicoConv2d* layer, struct PicoTensor* input,
+                                              enum PicoActivation act);
+
+void pico_nn_conv2d_free(struct PicoConv2d* layer);
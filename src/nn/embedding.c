@@ -0,0 +1,95 @@
+#include "embedding.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "arena.h"
+#include "kernels/cpu_kernels.h"
+#include "nn/init.h"
+#include "nn/nn_autograd.h"
+#include "tensor.h"
+#include "view/view.h"
+
+struct PicoEmbedding* pico_nn_embedding_init(int num_embeddings, int embedding_dim, bool sparse) {
+    if(num_embeddings < 1 || embedding_dim < 1) {
+        fprintf(stderr, "[Pico] Error: In Embedding - bad configuration!\n");
+        return NULL;
+    }
+
+    int64_t shape[2] = {num_embeddings, embedding_dim};
+    struct PicoTensor* weights_t = pico_param(shape, 2);
+    pico_nn_init_normal(weights_t, 0.0f, 1.0f);
+    if(sparse) {
+        free(weights_t->grad);
+        weights_t->grad = NULL;
+    }
+
+    struct PicoEmbedding* emb = calloc(1, sizeof(struct PicoEmbedding));
+    emb->num_embeddings = num_embeddings;
+    emb->embedding_dim = embedding_dim;
+    emb->sparse = sparse;
+    emb->weights = weights_t;
+    emb->grad.dim = embedding_dim;
+    return emb;
+}
+
+struct PicoTensor* pico_nn_embedding_forward(struct PicoEmbedding* layer, struct PicoTensor* ids) {
+    if(ids->ndim < 1 || ids->ndim > 254) {
+        fprintf(stderr, "[Pico] Error: In Embedding - ids need 1 to 254 dims!\n");
+        return NULL;
+    }
+    if(layer->weights->backend != ids->backend) {
+        fprintf(stderr, "[Pico] Error: In Embedding - PicoTensor backends are not compatible!\n");
+        return NULL;
+    }
+
+    struct Arena* arena = arena_ctx_current();
+    if(arena == NULL) {
+        fprintf(stderr, "[Pico] Error: In Embedding - No current arena in context!\n");
+        return NULL;
+    }
+    // check the ids in logical order, after a strided or expanded view is made dense
+    ids = pico_as_f32(pico_contiguous(ids));
+    for(int64_t i = 0; i < ids->numel; i++) {
+        float id = ids->data[i];
+        if(!(id >= 0.0f && id < (float)layer->num_embeddings) || id != (float)(int64_t)id) {
+            fprintf(stderr, "[Pico] Error: In Embedding - id %g is not a row in [0, %d)!\n", id,
+                    layer->num_embeddings);
+            return NULL;
+        }
+    }
+
+    int64_t* out_shape = arena_alloc(arena, sizeof(int64_t) * (ids->ndim + 1));
+    memcpy(out_shape, ids->shape, sizeof(int64_t) * ids->ndim);
+    out_shape[ids->ndim] = layer->embedding_dim;
+    struct PicoTensor* output = pico_create_tensor(arena, out_shape, ids->ndim + 1);
+    output->backend = ids->backend;
+
+    if(ids->backend == CPU) {
+        struct PicoTensor w_tmp;
+        struct PicoTensor* w32 = pico_tensor_f32_borrow(layer->weights, &w_tmp);
+        pico_embedding_gather_cpu(w32->data, ids->data, output->data, ids->numel,
+                                  layer->embedding_dim);
+        pico_tensor_f32_release(w32, layer->weights);
+    }
+
+    output->parents = arena_alloc(arena, sizeof(struct PicoTensor*) * 2);
+    output->parents[0] = layer->weights;
+    output->parents[1] = ids;
+    output->num_parents = 2;
+    output->_ctx = layer->sparse ? &layer->grad : NULL;
+    output->_backward = pico_nn_embedding_backward;
+
+    return output;
+}
+
+void pico_nn_embedding_free(struct PicoEmbedding* layer) {
+    if(layer == NULL) {
+        return;
+    }
+
+    pico_sparse_grad_clear(&layer->grad);
+    pico_free(layer->weights);
+    free(layer);
+}
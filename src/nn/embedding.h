@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include "tensor.h"
+
+// a lookup table: row i of `weights` is the vector for id i. the forward gathers one
+// row per id (threads split the ids). the backward adds each output row's grad into
+// the row it came from, either into weights->grad (dense) or, with sparse = true, into
+// `grad`: the touched rows only, ids sorted so each row is summed by one thread. a
+// sparse table has no dense grad at all (weights->grad == NULL), so backward memory and
+// optimizer traffic scale with the ids in the batch, not with num_embeddings: register
+// it with pico_optim_add_sparse(optim, layer->weights, &layer->grad) (or the SGD one).
+struct PicoEmbedding {
+    int num_embeddings;
+    int embedding_dim;
+    bool sparse;
+    struct PicoTensor* weights;  // Shape: [num_embeddings, embedding_dim]
+    struct PicoSparseGrad grad;  // the weights' grad when sparse, empty otherwise
+};
+
+// weights start N(0, 1) (PyTorch's default), drawn from g_pico_rng. NULL on a bad size
+struct PicoEmbedding* pico_nn_embedding_init(int num_embeddings, int embedding_dim, bool sparse);
+
+// ids: any shape, integer-valued floats in [0, num_embeddings) -> [...ids shape,
+// embedding_dim]. ids get no grad
+struct PicoTensor* pico_nn_embedding_forward(struct PicoEmbedding* layer, struct PicoTensor* ids);
+
+void pico_nn_embedding_free(struct PicoEmbedding* layer);
@@ -0,0 +1,106 @@
+#include "init.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "kernels/cpu_kernels.h"
+#include "rng/rng.h"
+
+void pico_nn_init_fans(const struct PicoTensor* t, int64_t* fan_in, int64_t* fan_out) {
+    if(t->ndim < 2) {
+        *fan_in = *fan_out = t->numel;
+        return;
+    }
+    *fan_in = t->numel / t->shape[t->ndim - 1];
+    *fan_out = t->numel / t->shape[t->ndim - 2];
+}
+
+float pico_nn_init_gain(enum PicoActivation act) {
+    return act == PICO_ACT_RELU ? sqrtf(2.0f) : 1.0f;
+}
+
+enum PicoInitDist {
+    PICO_INIT_CONSTANT,  // p0 everywhere, no draw: g_pico_rng is left where it was
+    PICO_INIT_UNIFORM,
+    PICO_INIT_NORMAL,
+    PICO_INIT_TRUNC_NORMAL
+};
+
+// draw straight into an fp32 param; a half one gets an fp32 scratch, rounded into it once
+static void pico_nn_init_fill(struct PicoTensor* t, enum PicoInitDist dist, float p0, float p1,
+                              float a, float b) {
+    if(t == NULL || t->backend != CPU) {
+        fprintf(stderr, "[Pico] Error: In init - needs a CPU tensor\n");
+        return;
+    }
+    float* dst = t->dtype == PICO_F32 ? t->data : malloc(sizeof(float) * t->numel);
+    switch(dist) {
+        case PICO_INIT_CONSTANT:
+            for(int64_t i = 0; i < t->numel; i++) dst[i] = p0;
+            break;
+        case PICO_INIT_UNIFORM: pico_rng_uniform(&g_pico_rng, dst, t->numel, p0, p1); break;
+        case PICO_INIT_NORMAL: pico_rng_normal(&g_pico_rng, dst, t->numel, p0, p1); break;
+        case PICO_INIT_TRUNC_NORMAL:
+            pico_rng_trunc_normal(&g_pico_rng, dst, t->numel, p0, p1, a, b);
+            break;
+    }
+    if(dst != t->data) {
+        pico_convert_cpu(dst, PICO_F32, t->data16, t->dtype, t->numel);
+        free(dst);
+    }
+}
+
+void pico_nn_init_constant(struct PicoTensor* t, float value) {
+    pico_nn_init_fill(t, PICO_INIT_CONSTANT, value, 0.0f, 0.0f, 0.0f);
+}
+
+void pico_nn_init_uniform(struct PicoTensor* t, float lo, float hi) {
+    if(!(lo <= hi)) {
+        fprintf(stderr, "[Pico] Error: In init - uniform needs lo <= hi\n");
+        return;
+    }
+    pico_nn_init_fill(t, PICO_INIT_UNIFORM, lo, hi, 0.0f, 0.0f);
+}
+
+void pico_nn_init_normal(struct PicoTensor* t, float mean, float std) {
+    if(!(std >= 0.0f)) {
+        fprintf(stderr, "[Pico] Error: In init - normal needs std >= 0\n");
+        return;
+    }
+    pico_nn_init_fill(t, PICO_INIT_NORMAL, mean, std, 0.0f, 0.0f);
+}
+
+void pico_nn_init_trunc_normal(struct PicoTensor* t, float mean, float std, float a, float b) {
+    if(!(std > 0.0f) || !(a < b)) {
+        fprintf(stderr, "[Pico] Error: In init - trunc_normal needs std > 0 and a < b\n");
+        return;
+    }
+    pico_nn_init_fill(t, PICO_INIT_TRUNC_NORMAL, mean, std, a, b);
+}
+
+void pico_nn_init_xavier_uniform(struct PicoTensor* t, float gain) {
+    int64_t fan_in, fan_out;
+    pico_nn_init_fans(t, &fan_in, &fan_out);
+    float bound = gain * sqrtf(6.0f / (float)(fan_in + fan_out));
+    pico_nn_init_uniform(t, -bound, bound);
+}
+
+void pico_nn_init_xavier_normal(struct PicoTensor* t, float gain) {
+    int64_t fan_in, fan_out;
+    pico_nn_init_fans(t, &fan_in, &fan_out);
+    pico_nn_init_normal(t, 0.0f, gain * sqrtf(2.0f / (float)(fan_in + fan_out)));
+}
+
+void pico_nn_init_kaiming_uniform(struct PicoTensor* t, enum PicoFanMode mode, float gain) {
+    int64_t fan_in, fan_out;
+    pico_nn_init_fans(t, &fan_in, &fan_out);
+    float bound = gain * sqrtf(3.0f / (float)(mode == PICO_FAN_IN ? fan_in : fan_out));
+    pico_nn_init_uniform(t, -bound, bound);
+}
+
+void pico_nn_init_kaiming_normal(struct PicoTensor* t, enum PicoFanMode mode, float gain) {
+    int64_t fan_in, fan_out;
+    pico_nn_init_fans(t, &fan_in, &fan_out);
+    pico_nn_init_normal(t, 0.0f, gain / sqrtf((float)(mode == PICO_FAN_IN ? fan_in : fan_out)));
+}
@@ -0,0 +1,41 @@
+/*
+ * weight initialization: fill a param in place from g_pico_rng (rng/rng.h), through the
+ * threaded SIMD fills, so even multi-GB models initialize at memory speed. seed with
+ * pico_rng_seed(s) for a repeatable model. fp32 and half params both work (a half
+ * param is filled in fp32 and rounded once). initialize before handing a half param
+ * to an optimizer: its fp32 master is copied from the param on the first step.
+ *
+ * fans follow pico's layout, outputs in the last dim ([in, out] for a Linear):
+ * fan_in = numel / shape[last], fan_out = numel / shape[last - 1]. 1-D tensors use
+ * their length for both.
+ */
+#pragma once
+
+#include <stdint.h>
+
+#include "kernels/epilogue.h"
+#include "tensor.h"
+
+enum PicoFanMode { PICO_FAN_IN, PICO_FAN_OUT };
+
+void pico_nn_init_fans(const struct PicoTensor* t, int64_t* fan_in, int64_t* fan_out);
+
+// the gain that keeps activations' variance through `act`: 1, sqrt(2) for relu
+float pico_nn_init_gain(enum PicoActivation act);
+
+void pico_nn_init_constant(struct PicoTensor* t, float value);
+void pico_nn_init_uniform(struct PicoTensor* t, float lo, float hi);
+void pico_nn_init_normal(struct PicoTensor* t, float mean, float std);
+
+// normal(mean, std) restricted to [a, b]
+void pico_nn_init_trunc_normal(struct PicoTensor* t, float mean, float std, float a, float b);
+
+// Glorot: uniform(+-gain * sqrt(6 / (fan_in + fan_out))), or normal with
+// std = gain * sqrt(2 / (fan_in + fan_out))
+void pico_nn_init_xavier_uniform(struct PicoTensor* t, float gain);
+void pico_nn_init_xavier_normal(struct PicoTensor* t, float gain);
+
+// He: uniform(+-gain * sqrt(3 / fan)), or normal with std = gain / sqrt(fan), fan picked
+// by mode. gain = pico_nn_init_gain(PICO_ACT_RELU) for relu layers
+void pico_nn_init_kaiming_uniform(struct PicoTensor* t, enum PicoFanMode mode, float gain);
+void pico_nn_init_kaiming_normal(struct PicoTensor* t, enum PicoFanMode mode, float gain);
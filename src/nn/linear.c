@@ -1,10 +1,15 @@
 #include "linear.h"
 
+#include <math.h>
 #include <stdbool.h>
 
 #include "arena.h"
+#include "kernels/cpu_kernels.h"
+#include "nn/init.h"
+#include "nn/nn_autograd.h"
 #include "ops.h"
 #include "tensor.h"
+#include "view/view.h"
 
 struct PicoLinear* pico_nn_linear_init(int in_features, int out_features, bool bias) {
     struct Arena* arena = arena_ctx_current();
@@ -27,6 +32,12 @@ struct PicoLinear* pico_nn_linear_init(int in_features, int out_features, bool b
         bias_t = pico_param(bias_shape, 1);
     }
 
+    // PyTorch's default: weights and bias uniform on +-1/sqrt(in_features)
+    // (kaiming_uniform with gain 1/sqrt(3))
+    float bound = 1.0f / sqrtf((float)in_features);
+    pico_nn_init_uniform(weights_t, -bound, bound);
+    if(bias_t != NULL) pico_nn_init_uniform(bias_t, -bound, bound);
+
     struct PicoLinear* linear = malloc(sizeof(struct PicoLinear));
 
     linear->weights = weights_t;
@@ -38,11 +49,13 @@ struct PicoLinear* pico_nn_linear_init(int in_features, int out_features, bool b
 }
 
 struct PicoTensor* pico_nn_linear_forward(struct PicoLinear* layer, struct PicoTensor* input) {
-    //
-    //
-    //
-    if(input->shape[input->ndim - 1] != layer->weights->shape[0]) {
-        perror("[Pico] Error:  In Linear - 2 matmuls matrices must be compatible");
+    return pico_nn_linear_forward_act(layer, input, PICO_ACT_NONE);
+}
+
+struct PicoTensor* pico_nn_linear_forward_act(struct PicoLinear* layer, struct PicoTensor* input,
+                                              enum PicoActivation act) {
+    if(input->ndim != 2 || input->shape[1] != layer->weights->shape[0]) {
+        fprintf(stderr, "[Pico] Error: In Linear - 2 matmuls matrices must be compatible\n");
         return NULL;
     }
 
@@ -56,12 +69,39 @@ struct PicoTensor* pico_nn_linear_forward(struct PicoLinear* layer, struct PicoT
         fprintf(stderr, "[Pico] Error: In Linear - No current arena in context!\n");
         return NULL;
     }
+    input = pico_contiguous(input);
+
+    int64_t res_shape[2] = {input->shape[0], layer->out_features};
+    struct PicoTensor* output = pico_create_tensor_dtype(arena, res_shape, 2, input->dtype);
+    output->backend = input->backend;
+
+    // matmul + bias + activation in one sweep: no [batch, out] intermediate for the
+    // matmul, no map_index broadcast pass for the bias, no separate relu pass.
+    // the epilogue adds an fp32 bias: a half one is widened for the call.
+    struct PicoTensor bias_tmp;
+    struct PicoTensor* bias32 =
+        layer->bias != NULL ? pico_tensor_f32_borrow(layer->bias, &bias_tmp) : NULL;
+    struct PicoMatmulEpilogue epi = {
+        .bias = bias32 != NULL ? bias32->data : NULL,
+        .act = act,
+    };
+    if(input->backend == CPU) {
+        pico_matmul_epilogue_cpu(input, layer->weights, output, &epi);
+    }
+    if(bias32 != NULL) {
+        pico_tensor_f32_release(bias32, layer->bias);
+    }
 
-    struct PicoTensor* output = pico_matmul(input, layer->weights);
-
+    int num_parents = layer->bias != NULL ? 3 : 2;
+    output->parents = arena_alloc(arena, sizeof(struct PicoTensor*) * num_parents);
+    output->parents[0] = input;
+    output->parents[1] = layer->weights;
     if(layer->bias != NULL) {
-        output = pico_add(output, layer->bias);
+        output->parents[2] = layer->bias;
     }
+    output->num_parents = num_parents;
+    output->_backward =
+        act == PICO_ACT_RELU ? pico_nn_linear_relu_backward : pico_nn_linear_backward;
 
     return output;
 }
@@ -1,6 +1,8 @@
+#pragma once
 
 #include <stdbool.h>
 
+#include "kernels/epilogue.h"
 #include "tensor.h"
 
 struct PicoLinear {
@@ -10,6 +12,15 @@ struct PicoLinear {
     struct PicoTensor* bias;     // Shape: [out_features, 1]
 };
 
+// weights and bias start uniform on +-1/sqrt(in_features), drawn from g_pico_rng;
+// re-fill them with nn/init.h for another scheme
 struct PicoLinear* pico_nn_linear_init(int in_features, int out_features, bool bias);
 struct PicoTensor* pico_nn_linear_forward(struct PicoLinear* layer, struct PicoTensor* input);
+
+// act(input @ weights + bias) as ONE node: bias and activation run in the GEMM
+// epilogue while each output tile is still in registers, and the backward gets
+// db as a column reduction of dZ. pico_nn_linear_forward == this with PICO_ACT_NONE.
+struct PicoTensor* pico_nn_linear_forward_act(struct PicoLinear* layer, struct PicoTensor* input,
+                                              enum PicoActivation act);
+
 void pico_nn_linear_free(struct PicoLinear* linear);
@@ -0,0 +1,190 @@
+/*
+ * backward for the nn layers. for the chain-rule basics check out ../autograd.h
+ * (named nn_autograd.h, not autograd.h, so including the root autograd.h from
+ * here can't resolve back to this file — see the naming note in todo.md)
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "arena.h"
+#include "autograd.h"
+#include "kernels/conv.h"
+#include "kernels/epilogue.h"
+#include "tensor.h"
+
+// Y = act(X·W + b)   (one fused node, see pico_nn_linear_forward_act)
+//   dZ = dY ⊙ act'(Z)            relu: gate on the saved output, Y > 0
+//   dX = dZ·Wᵀ ,  dW = Xᵀ·dZ     same as matmul backward, fed dZ instead of dY
+//   db = Σ_rows dZ               column reduction, one row-major sweep
+static inline void pico_nn_linear_backward_act(struct PicoTensor* self, enum PicoActivation act) {
+    struct PicoTensor* input = self->parents[0];
+    struct PicoTensor* weights = self->parents[1];
+    struct PicoTensor* bias = self->num_parents > 2 ? self->parents[2] : NULL;
+
+    int64_t rows = self->shape[0];
+    int64_t columns = self->shape[1];
+    const float* dz = self->grad;
+    float* gated = NULL;
+    int gated_on_heap = 0;
+
+    if(act == PICO_ACT_RELU) {
+        // materialize dZ once: both GEMMs and the bias reduction read it
+        struct Arena* arena = arena_ctx_current();
+        size_t bytes = (size_t)self->numel * sizeof(float);
+        gated = arena != NULL ? arena_alloc(arena, bytes) : malloc(bytes);
+        gated_on_heap = (arena == NULL);
+        for(int64_t i = 0; i < self->numel; i++) {
+            gated[i] = self->grad[i] * (pico_tensor_get(self, i) > 0);
+        }
+        dz = gated;
+    }
+
+    pico_matmul_backward_accumulate(input, weights, dz, columns);
+
+    if(bias != NULL) {
+        for(int64_t i = 0; i < rows; i++) {
+            for(int64_t j = 0; j < columns; j++) {
+                bias->grad[j] += dz[i * columns + j];
+            }
+        }
+    }
+
+    if(gated_on_heap) {
+        free(gated);
+    }
+}
+
+static inline void pico_nn_linear_backward(struct PicoTensor* self) {
+    pico_nn_linear_backward_act(self, PICO_ACT_NONE);
+}
+
+static inline void pico_nn_linear_relu_backward(struct PicoTensor* self) {
+    pico_nn_linear_backward_act(self, PICO_ACT_RELU);
+}
+
+// Y = act(conv(X, W) + b), per group g an im2col GEMM  Y_g = col_g(X)·W_g
+//   dZ   = dY ⊙ act'(Z)          as for Linear
+//   dW_g += col_gᵀ·dZ_g          col_g rebuilt from X: nothing was kept from the forward
+//   dX   += col2im(dZ_g·W_gᵀ)    every window's share scattered back to its taps
+//   db   = Σ_rows dZ
+// the 1x1 path reads X as the matrix directly, so dX_g is a GEMM straight into X's grad.
+// dX is skipped when X doesn't need it (an input image)
+static inline void pico_nn_conv2d_backward_act(struct PicoTensor* self, enum PicoActivation act) {
+    struct PicoTensor* input = self->parents[0];
+    struct PicoTensor* weights = self->parents[1];
+    struct PicoTensor* bias = self->num_parents > 2 ? self->parents[2] : NULL;
+    const struct PicoConvShape* s = (const struct PicoConvShape*)self->_ctx;
+
+    int64_t cg = s->c / s->groups, og = s->oc / s->groups;
+    int64_t rows = s->n * s->oh * s->ow, kcols = s->k * s->k * cg;
+    enum PicoConvAlgo algo = pico_conv_select(s);
+    bool direct = algo == PICO_CONV_POINTWISE;
+    bool depthwise = algo == PICO_CONV_DEPTHWISE;
+    bool need_dx = input->requires_grad && input->grad != NULL;
+
+    // scratch from the current arena, as in the forward: the relu-gated dZ, col_g and its
+    // grad for im2col, and the packed W_gᵀ for dX. one block, carved up below
+    bool gemm = !depthwise;
+    int64_t n_gated = act == PICO_ACT_RELU ? self->numel : 0;
+    int64_t n_col = gemm && !direct ? rows * kcols : 0;
+    int64_t n_dcol = gemm && !direct && need_dx ? rows * kcols : 0;
+    int64_t n_wt = gemm && need_dx ? og * kcols : 0;
+    int64_t n_scratch = n_gated + n_col + n_dcol + n_wt;
+    struct Arena* arena = arena_ctx_current();
+    float* scratch = NULL;
+    if(n_scratch > 0) {
+        scratch = arena != NULL ? arena_alloc(arena, sizeof(float) * n_scratch) : NULL;
+        if(scratch == NULL) {
+            fprintf(stderr, "[Pico] Error: In Conv2d - no arena space for the backward's "
+                            "scratch!\n");
+            return;
+        }
+    }
+    float* gated = n_gated > 0 ? scratch : NULL;
+    float* col = n_col > 0 ? scratch + n_gated : NULL;
+    float* dcol = n_dcol > 0 ? scratch + n_gated + n_col : NULL;
+    float* wt = n_wt > 0 ? scratch + n_gated + n_col + n_dcol : NULL;
+
+    float* dz = self->grad;
+    if(gated != NULL) {
+        for(int64_t i = 0; i < self->numel; i++) gated[i] = self->grad[i] * (self->data[i] > 0);
+        dz = gated;
+    }
+
+    struct PicoTensor w_tmp;
+    struct PicoTensor* w32 = pico_tensor_f32_borrow(weights, &w_tmp);
+
+    // depthwise: c one-channel groups would be c skinny GEMMs, the direct loop beats them
+    if(depthwise)
+        pico_depthwise_backward_cpu(input->data, w32->data, dz, need_dx ? input->grad : NULL,
+                                    weights->grad, s);
+
+    for(int64_t g = 0; gemm && g < s->groups; g++) {
+        struct PicoConvMat am, bm, om;
+        struct PicoTensor* dz_g = pico_conv_mat(&bm, dz + g * og, rows, og, s->oc, 1);
+
+        // dW_g += col_gᵀ·dZ_g: col_gᵀ is read through its strides, no transposed copy
+        struct PicoTensor* col_t;
+        if(direct) {
+            col_t = pico_conv_mat(&am, input->data + g * cg, cg, rows, 1, s->c);
+        } else {
+            pico_im2col_cpu(input->data, col, s, g);
+            col_t = pico_conv_mat(&am, col, kcols, rows, 1, kcols);
+        }
+        pico_matmul_cpu(col_t, dz_g, pico_conv_mat(&om, weights->grad + g * og, kcols, og,
+                                                   s->oc, 1));
+        if(!need_dx) continue;
+
+        // dX: W_gᵀ packed once ([og, kcols], the GEMM wants unit-stride B rows)
+        pico_transpose_block_cpu(w32->data + g * og, s->oc, wt, kcols, kcols, og,
+                                 sizeof(float), false);
+        struct PicoConvMat wm;
+        struct PicoTensor* w_t = pico_conv_mat(&wm, wt, og, kcols, kcols, 1);
+        if(direct) {
+            pico_matmul_cpu(dz_g, w_t,
+                            pico_conv_mat(&om, input->grad + g * cg, rows, cg, s->c, 1));
+        } else {
+            memset(dcol, 0, sizeof(float) * rows * kcols);
+            pico_matmul_cpu(dz_g, w_t, pico_conv_mat(&om, dcol, rows, kcols, kcols, 1));
+            pico_col2im_cpu(dcol, input->grad, s, g);
+        }
+    }
+
+    if(bias != NULL) {
+        for(int64_t i = 0; i < rows; i++) {
+            for(int64_t j = 0; j < s->oc; j++) {
+                bias->grad[j] += dz[i * s->oc + j];
+            }
+        }
+    }
+
+    pico_tensor_f32_release(w32, weights);
+}
+
+static inline void pico_nn_conv2d_backward(struct PicoTensor* self) {
+    pico_nn_conv2d_backward_act(self, PICO_ACT_NONE);
+}
+
+static inline void pico_nn_conv2d_relu_backward(struct PicoTensor* self) {
+    pico_nn_conv2d_backward_act(self, PICO_ACT_RELU);
+}
+
+// Y[i] = W[ids[i]]
+//   dW[ids[i]] += dY[i]     into W's dense grad, or, when the forward saved a sparse grad
+//                           in _ctx, merged into its row list
+static inline void pico_nn_embedding_backward(struct PicoTensor* self) {
+    struct PicoTensor* weights = self->parents[0];
+    struct PicoTensor* ids = self->parents[1];
+    struct PicoSparseGrad* sparse = (struct PicoSparseGrad*)self->_ctx;
+    if(!weights->requires_grad || self->backend != CPU) return;
+
+    int64_t dim = weights->shape[1];
+    if(sparse == NULL) {
+        pico_embedding_scatter_cpu(ids->data, self->grad, weights->grad, ids->numel, dim);
+    } else if(!pico_embedding_sparse_add_cpu(sparse, ids->data, self->grad, ids->numel)) {
+        fprintf(stderr, "[Pico] Error: In Embedding - sparse grad allocation failed!\n");
+    }
+}
@@ -0,0 +1,125 @@
+#include "qlinear.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+#include "kernels/cpu_kernels.h"
+#include "tensor.h"
+#include "view/view.h"
+
+struct PicoQLinear* pico_qlinear_from_linear(struct PicoLinear* layer) {
+    if(layer == NULL || layer->weights == NULL) {
+        fprintf(stderr, "[Pico] Error: In QLinear - no layer to quantize\n");
+        return NULL;
+    }
+
+    int64_t K = layer->in_features, N = layer->out_features;
+    int64_t k_pad = (K + PICO_QGEMM_KALIGN - 1) / PICO_QGEMM_KALIGN * PICO_QGEMM_KALIGN;
+    int64_t n_pad = (N + PICO_QGEMM_NR - 1) / PICO_QGEMM_NR * PICO_QGEMM_NR;
+
+    struct PicoQLinear* q = malloc(sizeof(struct PicoQLinear));
+    q->in_features = layer->in_features;
+    q->out_features = layer->out_features;
+    q->k_pad = k_pad;
+    q->weights = calloc(n_pad * k_pad, sizeof(int8_t));
+    q->w_sum = calloc(n_pad, sizeof(int32_t));
+    q->w_scale = malloc(sizeof(float) * N);
+    q->bias = NULL;
+    q->act_absmax = 0.0f;
+
+    // W is [K, N] row-major: gather each column, give it its own scale, pack it
+    float* col = malloc(sizeof(float) * K);
+    for(int64_t j = 0; j < N; j++) {
+        for(int64_t k = 0; k < K; k++) col[k] = pico_tensor_get(layer->weights, k * N + j);
+        float s = pico_quant_scale(pico_absmax_cpu(col, K));
+        int8_t* packed = q->weights + j * k_pad;
+        pico_quantize_s8_cpu(col, packed, K, 1.0f / s);
+        int32_t sum = 0;
+        for(int64_t k = 0; k < K; k++) sum += packed[k];
+        q->w_scale[j] = s;
+        q->w_sum[j] = sum;
+    }
+    free(col);
+
+    if(layer->bias != NULL) {
+        q->bias = malloc(sizeof(float) * N);
+        for(int64_t j = 0; j < N; j++) q->bias[j] = pico_tensor_get(layer->bias, j);
+    }
+    return q;
+}
+
+void pico_qlinear_calibrate(struct PicoQLinear* layer, struct PicoTensor* input) {
+    if(layer == NULL || input == NULL) return;
+    struct PicoTensor tmp;
+    struct PicoTensor* x = pico_tensor_f32_borrow(input, &tmp);
+    layer->act_absmax = MAX(layer->act_absmax, pico_absmax_cpu(x->data, x->numel));
+    pico_tensor_f32_release(x, input);
+}
+
+struct PicoTensor* pico_qlinear_forward(struct PicoQLinear* layer, struct PicoTensor* input) {
+    return pico_qlinear_forward_act(layer, input, PICO_ACT_NONE);
+}
+
+struct PicoTensor* pico_qlinear_forward_act(struct PicoQLinear* layer, struct PicoTensor* input,
+                                            enum PicoActivation act) {
+    if(input->ndim != 2 || input->shape[1] != layer->in_features) {
+        fprintf(stderr, "[Pico] Error: In QLinear - input must be [batch, in_features]\n");
+        return NULL;
+    }
+
+    if(input->backend != CPU) {
+        fprintf(stderr, "[Pico] Error: In QLinear - only the CPU backend is supported\n");
+        return NULL;
+    }
+
+    struct Arena* arena = arena_ctx_current();
+    if(arena == NULL) {
+        fprintf(stderr, "[Pico] Error: In QLinear - No current arena in context!\n");
+        return NULL;
+    }
+    input = pico_contiguous(input);
+
+    int64_t M = input->shape[0], K = layer->in_features, N = layer->out_features;
+    int64_t res_shape[2] = {M, N};
+    struct PicoTensor* output = pico_create_tensor(arena, res_shape, 2);
+    output->backend = input->backend;
+    output->requires_grad = 0;
+
+    // x rows -> int8, padded to whole MR-row tiles of k_pad bytes (the pad stays zero).
+    // one arena block: the row scales, then the int8 rows
+    int64_t m_pad = (M + PICO_QGEMM_MR - 1) / PICO_QGEMM_MR * PICO_QGEMM_MR;
+    size_t scale_bytes = sizeof(float) * MAX(M, 1);
+    size_t xq_bytes = (size_t)(m_pad * layer->k_pad);
+    float* x_scale = arena_alloc(arena, scale_bytes + xq_bytes);
+    if(x_scale == NULL) {
+        fprintf(stderr, "[Pico] Error: In QLinear - no arena space for the quantized input!\n");
+        return NULL;
+    }
+    int8_t* xq = (int8_t*)x_scale + scale_bytes;
+    memset(xq, 0, xq_bytes);
+    struct PicoTensor tmp;
+    struct PicoTensor* x = pico_tensor_f32_borrow(input, &tmp);
+    float fixed_scale = layer->act_absmax > 0.0f ? pico_quant_scale(layer->act_absmax) : 0.0f;
+    pico_quantize_rows_cpu(x->data, xq, x_scale, M, K, layer->k_pad, fixed_scale);
+    pico_tensor_f32_release(x, input);
+
+    struct PicoMatmulEpilogue epi = {.bias = layer->bias, .act = act};
+    pico_qgemm_cpu(xq, x_scale, layer->weights, layer->w_sum, layer->w_scale, output->data, M, N,
+                   layer->k_pad, &epi);
+
+    return output;
+}
+
+void pico_qlinear_free(struct PicoQLinear* layer) {
+    if(layer == NULL) {
+        return;
+    }
+
+    free(layer->weights);
+    free(layer->w_sum);
+    free(layer->w_scale);
+    free(layer->bias);
+    free(layer);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "kernels/epilogue.h"
+#include "nn/linear.h"
+#include "tensor.h"
+
+// post-training int8 copy of a PicoLinear, for inference. W is quantized per output
+// channel (one scale per column), activations per row at run time (or with one
+// calibrated scale, see below). the GEMM multiplies int8 x int8 into int32, and the
+// epilogue dequantizes, adds the fp32 bias and applies the activation in one pass.
+// forward-only: the output has no parents and requires_grad = 0.
+struct PicoQLinear {
+    int in_features;
+    int out_features;
+    int64_t k_pad;     // in_features rounded up to PICO_QGEMM_KALIGN
+    int8_t* weights;   // [out_features rounded up to PICO_QGEMM_NR, k_pad], column j of W
+                       // contiguous, zero padded
+    int32_t* w_sum;    // sum of each packed column (the VNNI kernel's offset correction)
+    float* w_scale;    // [out_features]: W[:, j] ~= weights[j] * w_scale[j]
+    float* bias;       // [out_features] fp32 copy, NULL when the layer has none
+    float act_absmax;  // calibrated max |x|. 0 = scale every row by its own max |x|
+};
+
+// quantize a trained layer (any weight dtype). the PicoLinear is left untouched
+struct PicoQLinear* pico_qlinear_from_linear(struct PicoLinear* layer);
+
+// calibration: call with representative inputs for this layer (e.g. the fp32 model's
+// activations on a few batches); each call folds max |input| into act_absmax. after
+// that, forward quantizes every row with the one scale act_absmax / 127: no per-row max
+// pass, and a row's output no longer depends on its own range. values past the
+// calibrated range clip to +-127. set act_absmax back to 0 for dynamic scales.
+void pico_qlinear_calibrate(struct PicoQLinear* layer, struct PicoTensor* input);
+
+struct PicoTensor* pico_qlinear_forward(struct PicoQLinear* layer, struct PicoTensor* input);
+struct PicoTensor* pico_qlinear_forward_act(struct PicoQLinear* layer, struct PicoTensor* input,
+                                            enum PicoActivation act);
+
+void pico_qlinear_free(struct PicoQLinear* layer);
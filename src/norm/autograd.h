@@ -0,0 +1,35 @@
+/*
+ * for better details onbackward functions check out ../autograd.h
+ */
+
+#pragma once
+#include "kernels/cpu_kernels.h"
+#include "tensor.h"
+
+// what pico_layernorm / pico_rmsnorm keep for the backward. parents are x, then weight
+// and bias when given
+struct PicoNormCtx {
+    float* mean;  // [rows], NULL for rmsnorm
+    float* rstd;  // [rows], 1 / sqrt(var + eps)
+    bool has_weight;
+    bool has_bias;
+};
+
+// with g = dy * weight and x̂ = (x - mean) * rstd, per row:
+//   dx      += rstd * (g - mean(g) - x̂ * mean(g * x̂))   (rmsnorm: no mean(g) term)
+//   dweight += Σ_rows dy * x̂,   dbias += Σ_rows dy
+static inline void pico_norm_backward(struct PicoTensor* self) {
+    struct PicoNormCtx* ctx = (struct PicoNormCtx*)self->_ctx;
+    struct PicoTensor* x = self->parents[0];
+    struct PicoTensor* weight = ctx->has_weight ? self->parents[1] : NULL;
+    struct PicoTensor* bias = ctx->has_bias ? self->parents[1 + ctx->has_weight] : NULL;
+    int64_t n = x->shape[x->ndim - 1];
+
+    if(self->backend == CPU) {
+        pico_norm_backward_cpu(x->data, self->grad, weight != NULL ? weight->data : NULL,
+                               ctx->mean, ctx->rstd, x->requires_grad ? x->grad : NULL,
+                               weight != NULL && weight->requires_grad ? weight->grad : NULL,
+                               bias != NULL && bias->requires_grad ? bias->grad : NULL,
+                               x->numel / n, n);
+    }
+}
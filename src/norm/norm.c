@@ -0,0 +1,75 @@
+#include "norm.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "arena.h"
+#include "kernels/cpu_kernels.h"
+#include "norm/autograd.h"
+#include "tensor.h"
+#include "view/view.h"
+
+static bool pico_norm_param_ok(struct PicoTensor* p, struct PicoTensor* x, const char* what) {
+    if(p == NULL) return true;
+    if(p->numel != x->shape[x->ndim - 1] || p->backend != x->backend) {
+        fprintf(stderr, "[Pico] Error: Norm %s must be [%ld], like x's last dim!\n", what,
+                (long)x->shape[x->ndim - 1]);
+        return false;
+    }
+    return true;
+}
+
+static struct PicoTensor* pico_norm(struct PicoTensor* x, struct PicoTensor* weight,
+                                    struct PicoTensor* bias, float eps, bool center) {
+    if(x->ndim < 1 || x->numel == 0) {
+        fprintf(stderr, "[Pico] Error: Norm needs a non-empty tensor!\n");
+        return NULL;
+    }
+    if(!pico_norm_param_ok(weight, x, "weight") || !pico_norm_param_ok(bias, x, "bias")) {
+        return NULL;
+    }
+
+    struct Arena* arena = arena_ctx_current();
+    if(arena == NULL) {
+        fprintf(stderr, "[Pico] Error: No current arena in context!\n");
+        return NULL;
+    }
+    x = pico_as_f32(pico_contiguous(x));
+    weight = weight != NULL ? pico_as_f32(pico_contiguous(weight)) : NULL;
+    bias = bias != NULL ? pico_as_f32(pico_contiguous(bias)) : NULL;
+    struct PicoTensor* out = pico_create_tensor(arena, x->shape, x->ndim);
+    out->backend = x->backend;
+
+    int64_t n = x->shape[x->ndim - 1], rows = x->numel / n;
+    struct PicoNormCtx* ctx = arena_alloc(arena, sizeof(struct PicoNormCtx));
+    ctx->mean = center ? arena_alloc(arena, sizeof(float) * rows) : NULL;
+    ctx->rstd = arena_alloc(arena, sizeof(float) * rows);
+    ctx->has_weight = weight != NULL;
+    ctx->has_bias = bias != NULL;
+
+    if(x->backend == CPU) {
+        pico_norm_cpu(x->data, weight != NULL ? weight->data : NULL,
+                      bias != NULL ? bias->data : NULL, out->data, ctx->mean, ctx->rstd, eps,
+                      rows, n);
+    }
+
+    int num_parents = 1 + ctx->has_weight + ctx->has_bias;
+    out->parents = arena_alloc(arena, sizeof(struct PicoTensor*) * num_parents);
+    out->parents[0] = x;
+    if(weight != NULL) out->parents[1] = weight;
+    if(bias != NULL) out->parents[num_parents - 1] = bias;
+    out->num_parents = num_parents;
+    out->_ctx = ctx;
+    out->_backward = pico_norm_backward;
+
+    return out;
+}
+
+struct PicoTensor* pico_layernorm(struct PicoTensor* x, struct PicoTensor* weight,
+                                  struct PicoTensor* bias, float eps) {
+    return pico_norm(x, weight, bias, eps, true);
+}
+
+struct PicoTensor* pico_rmsnorm(struct PicoTensor* x, struct PicoTensor* weight, float eps) {
+    return pico_norm(x, weight, NULL, eps, false);
+}
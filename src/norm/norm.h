@@ -0,0 +1,15 @@
+#pragma once
+
+#include "tensor.h"
+
+// normalization over the last dim of x, each row on its own, with an optional per-feature
+// scale `weight` and shift `bias` ([d] for x [..., d], NULL for none):
+//   layernorm  y = (x - mean) / sqrt(var + eps) * weight + bias   (var biased, /d)
+//   rmsnorm    y = x / sqrt(mean(x²) + eps) * weight
+// one node each instead of the sub / mul / sum / sqrt / div chain: per row, one pass for
+// the stats (Welford for layernorm) and one that normalizes, scales and shifts. only the
+// per-row mean and 1 / std are kept, and the backward rebuilds x̂ from them and x.
+// rows run across global_tp.
+struct PicoTensor* pico_layernorm(struct PicoTensor* x, struct PicoTensor* weight,
+                                  struct PicoTensor* bias, float eps);
+struct PicoTensor* pico_rmsnorm(struct PicoTensor* x, struct PicoTensor* weight, float eps);
@@ -8,6 +8,22 @@
 #include "autograd.h"
 #include "kernels/cpu_kernels.h"
 #include "tensor.h"
+#include "view/view.h"
+
+// add / sub / mul keep half inputs half when both share the dtype and the shape (the
+// kernels widen per tile, see pico_binary_half_cpu); any other mix is done in fp32.
+// strided views are made contiguous first.
+static PicoDType pico_binary_dtype(struct PicoTensor** a, struct PicoTensor** b) {
+    *a = pico_contiguous(*a);
+    *b = pico_contiguous(*b);
+    if((*a)->dtype != PICO_F32 && (*a)->dtype == (*b)->dtype &&
+       pico_tensor_shapes_are_equal(*a, *b)) {
+        return (*a)->dtype;
+    }
+    *a = pico_as_f32(*a);
+    *b = pico_as_f32(*b);
+    return PICO_F32;
+}
 
 struct PicoTensor* pico_add(struct PicoTensor* a, struct PicoTensor* b) {
     if(!pico_check_broadcast_compatibility(a, b)) {
@@ -25,6 +41,7 @@ struct PicoTensor* pico_add(struct PicoTensor* a, struct PicoTensor* b) {
         fprintf(stderr, "[Pico] Error: No current arena in context!\n");
         return NULL;
     }
+    PicoDType dtype = pico_binary_dtype(&a, &b);
 
     int ndim = MAX(a->ndim, b->ndim);
     int64_t* a_padded_shape = pad_shape(arena, a, ndim);
@@ -34,7 +51,7 @@ struct PicoTensor* pico_add(struct PicoTensor* a, struct PicoTensor* b) {
     for(int i = 0; i < ndim; i++)
         res_shape[i] = MAX(a_padded_shape[i], b_padded_shape[i]);
 
-    struct PicoTensor* out = pico_create_tensor(arena, res_shape, ndim);
+    struct PicoTensor* out = pico_create_tensor_dtype(arena, res_shape, ndim, dtype);
     out->backend = a->backend;
 
     if(a->backend == CPU) {
@@ -69,6 +86,7 @@ struct PicoTensor* pico_sub(struct PicoTensor* a, struct PicoTensor* b) {
         fprintf(stderr, "[Pico] Error: No current arena in context!\n");
         return NULL;
     }
+    PicoDType dtype = pico_binary_dtype(&a, &b);
 
     int ndim = MAX(a->ndim, b->ndim);
     int64_t* a_padded_shape = pad_shape(arena, a, ndim);
@@ -78,7 +96,7 @@ struct PicoTensor* pico_sub(struct PicoTensor* a, struct PicoTensor* b) {
     for(int i = 0; i < ndim; i++)
         res_shape[i] = MAX(a_padded_shape[i], b_padded_shape[i]);
 
-    struct PicoTensor* out = pico_create_tensor(arena, res_shape, ndim);
+    struct PicoTensor* out = pico_create_tensor_dtype(arena, res_shape, ndim, dtype);
     out->backend = a->backend;
 
     if(a->backend == CPU) {
@@ -113,6 +131,7 @@ struct PicoTensor* pico_mul(struct PicoTensor* a, struct PicoTensor* b) {
         fprintf(stderr, "[Pico] Error: No current arena in context!\n");
         return NULL;
     }
+    PicoDType dtype = pico_binary_dtype(&a, &b);
 
     int ndim = MAX(a->ndim, b->ndim);
     int64_t* a_padded_shape = pad_shape(arena, a, ndim);
@@ -122,7 +141,7 @@ struct PicoTensor* pico_mul(struct PicoTensor* a, struct PicoTensor* b) {
     for(int i = 0; i < ndim; i++)
         res_shape[i] = MAX(a_padded_shape[i], b_padded_shape[i]);
 
-    struct PicoTensor* out = pico_create_tensor(arena, res_shape, ndim);
+    struct PicoTensor* out = pico_create_tensor_dtype(arena, res_shape, ndim, dtype);
     out->backend = a->backend;
 
     if(a->backend == CPU) {
@@ -162,6 +181,8 @@ struct PicoTensor* pico_matmul(struct PicoTensor* a, struct PicoTensor* b) {
         fprintf(stderr, "[Pico] Error: No current arena in context!\n");
         return NULL;
     }
+    a = pico_contiguous(a);
+    b = pico_contiguous(b);
 
     int ndim = MAX(a->ndim, b->ndim);
     int rows = a->shape[0];
@@ -171,7 +192,8 @@ struct PicoTensor* pico_matmul(struct PicoTensor* a, struct PicoTensor* b) {
     res_shape[0] = rows;
     res_shape[1] = columns;
 
-    struct PicoTensor* out = pico_create_tensor(arena, res_shape, ndim);
+    // stored like A; B (usually the weights) can be anything, it's widened as it's read
+    struct PicoTensor* out = pico_create_tensor_dtype(arena, res_shape, ndim, a->dtype);
     out->backend = a->backend;  // new tensor backend is consistent with it's parents, born in the
                                 // same fucking realm
 
@@ -191,7 +213,8 @@ struct PicoTensor* pico_matmul(struct PicoTensor* a, struct PicoTensor* b) {
 
 // ---- unary element-wise math (forward only) -------------------------------
 // same shape as `out`, dispatch to the CPU kernel, wire the single parent so the
-// graph stays intact. _backward is NULL for now — the per-op backwards are TODO
+// graph stays intact. half inputs are widened first, except for tanh, which shares
+// the activations' half path. _backward is NULL for now — the per-op backwards are TODO
 // (sin'=cos, cos'=-sin, tan'=sec^2, tanh'=1-tanh^2, sqrt'=1/(2*sqrt)). unary =>
 // num_parents == 1. these five are near-identical: prime for a later bundle.
 
@@ -201,6 +224,7 @@ struct PicoTensor* pico_tensor_sqrt(struct PicoTensor* a) {
         fprintf(stderr, "[Pico] Error: No current arena in context!\n");
         return NULL;
     }
+    a = pico_as_f32(pico_contiguous(a));
 
     struct PicoTensor* out = pico_create_tensor(arena, a->shape, a->ndim);
     out->backend = a->backend;
@@ -223,6 +247,7 @@ struct PicoTensor* pico_tensor_sin(struct PicoTensor* a) {
         fprintf(stderr, "[Pico] Error: No current arena in context!\n");
         return NULL;
     }
+    a = pico_as_f32(pico_contiguous(a));
 
     struct PicoTensor* out = pico_create_tensor(arena, a->shape, a->ndim);
     out->backend = a->backend;
@@ -245,6 +270,7 @@ struct PicoTensor* pico_tensor_cos(struct PicoTensor* a) {
         fprintf(stderr, "[Pico] Error: No current arena in context!\n");
         return NULL;
     }
+    a = pico_as_f32(pico_contiguous(a));
 
     struct PicoTensor* out = pico_create_tensor(arena, a->shape, a->ndim);
     out->backend = a->backend;
@@ -267,6 +293,7 @@ struct PicoTensor* pico_tensor_tan(struct PicoTensor* a) {
         fprintf(stderr, "[Pico] Error: No current arena in context!\n");
         return NULL;
     }
+    a = pico_as_f32(pico_contiguous(a));
 
     struct PicoTensor* out = pico_create_tensor(arena, a->shape, a->ndim);
     out->backend = a->backend;
@@ -289,8 +316,9 @@ struct PicoTensor* pico_tensor_tanh(struct PicoTensor* a) {
         fprintf(stderr, "[Pico] Error: No current arena in context!\n");
         return NULL;
     }
+    a = pico_contiguous(a);
 
-    struct PicoTensor* out = pico_create_tensor(arena, a->shape, a->ndim);
+    struct PicoTensor* out = pico_create_tensor_dtype(arena, a->shape, a->ndim, a->dtype);
     out->backend = a->backend;
 
     if(a->backend == CPU) {
@@ -311,6 +339,7 @@ struct PicoTensor* pico_tensor_log(struct PicoTensor* a) {
         fprintf(stderr, "[Pico] Error: No current arena in context!\n");
         return NULL;
     }
+    a = pico_as_f32(pico_contiguous(a));
 
     struct PicoTensor* out = pico_create_tensor(arena, a->shape, a->ndim);
     out->backend = a->backend;
@@ -326,3 +355,26 @@ struct PicoTensor* pico_tensor_log(struct PicoTensor* a) {
 
     return out;
 }
+
+struct PicoTensor* pico_tensor_exp(struct PicoTensor* a) {
+    struct Arena* arena = arena_ctx_current();
+    if(arena == NULL) {
+        fprintf(stderr, "[Pico] Error: No current arena in context!\n");
+        return NULL;
+    }
+    a = pico_as_f32(pico_contiguous(a));
+
+    struct PicoTensor* out = pico_create_tensor(arena, a->shape, a->ndim);
+    out->backend = a->backend;
+
+    if(a->backend == CPU) {
+        pico_exp_cpu(a, out);
+    }
+
+    out->parents = arena_alloc(arena, sizeof(struct PicoTensor*));
+    out->parents[0] = a;
+    out->num_parents = 1;
+    out->_backward = pico_tensor_exp_backward;
+
+    return out;
+}
@@ -16,3 +16,4 @@ struct PicoTensor* pico_tensor_cos(struct PicoTensor* a);
 struct PicoTensor* pico_tensor_tan(struct PicoTensor* a);
 struct PicoTensor* pico_tensor_tanh(struct PicoTensor* a);
 struct PicoTensor* pico_tensor_log(struct PicoTensor* a);
+struct PicoTensor* pico_tensor_exp(struct PicoTensor* a);
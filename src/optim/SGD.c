@@ -9,7 +9,9 @@
 
 #include <stdlib.h>
 
+#include "kernels/cpu_kernels.h"
 #include "lib/pico_vector.h"
+#include "multi_tensor.h"
 #include "optim.h"
 #include "tensor.h"
 
@@ -26,27 +28,38 @@ void pico_optim_sgd_add(struct PicoOptimSGD* optim, struct PicoTensor* param) {
     pico_vec_push(&optim->params, param);
 }
 
-void pico_optim_sgd_step(struct PicoOptimSGD* optim) {
-    struct PicoTensor* tensor = NULL;
-    for(int i = 0; i < optim->params.size; i++) {
-        tensor = optim->params.data[i];
-        for(int j = 0; j < tensor->numel; j++) {
-            tensor->data[j] -= optim->lr * tensor->grad[j];
-        }
+void pico_optim_sgd_add_sparse(struct PicoOptimSGD* optim, struct PicoTensor* param,
+                               struct PicoSparseGrad* grad) {
+    pico_vec_push(&optim->params, param);
+    if(!pico_optim_chunks_add_sparse(&optim->chunks, &optim->params, param, grad)) {
+        optim->params.size--;
     }
 }
 
+void pico_optim_sgd_step(struct PicoOptimSGD* optim) {
+    if(!pico_optim_chunks_sync(&optim->chunks, &optim->params)) return;
+    struct PicoOptimStep h = {.lr = optim->lr,
+                              .grad_scale = pico_optim_grad_scale(optim->accum_steps),
+                              .zero_grad = optim->fuse_zero_grad};
+    struct PicoOptimApply job = {
+        .params = &optim->params, .chunks = &optim->chunks, .fn = pico_sgd_step_cpu, .h = &h};
+    pico_optim_apply(&job);
+}
+
+bool pico_optim_sgd_accum_step(struct PicoOptimSGD* optim) {
+    if(!pico_optim_accum_tick(&optim->accum_count, optim->accum_steps)) return false;
+    pico_optim_sgd_step(optim);
+    return true;
+}
+
 void pico_optim_sgd_zero_grad(struct PicoOptimSGD* optim) {
-    struct PicoTensor* tensor = NULL;
-    for(int i = 0; i < optim->params.size; i++) {
-        tensor = optim->params.data[i];
-        for(int j = 0; j < tensor->numel; j++) {
-            tensor->grad[j] = 0;
-        }
-    }
+    if(!pico_optim_chunks_sync(&optim->chunks, &optim->params)) return;
+    struct PicoOptimApply job = {.params = &optim->params, .chunks = &optim->chunks};
+    pico_optim_apply(&job);
 }
 
 void pico_optim_sgd_free(struct PicoOptimSGD* optim) {
     pico_vec_free(&optim->params);
+    pico_optim_chunks_free(&optim->chunks);
     free(optim);
 }
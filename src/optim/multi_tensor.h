@@ -0,0 +1,235 @@
+/*
+ * multi-tensor apply, shared by SGD.c and optim.c.
+ *
+ * every registered param is cut into PICO_OPTIM_CHUNK-float work items (a bias is one
+ * item, a big weight several). the item list is built once per param list and cached
+ * on the optimizer, so a step is ONE pico_parallel_for over a flat array: many small
+ * tensors share a thread and a big one spreads over all of them, with no per-tensor
+ * loop or threading decision in between.
+ */
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "kernels/cpu_kernels.h"
+#include "lib/pico_vector.h"
+#include "optim.h"
+#include "tensor.h"
+
+#define PICO_OPTIM_CHUNK (1 << 14)  // floats per work item; a multiple of 16
+
+// lay out fp32 masters for the half params: ones the old list already had keep their
+// values, new ones start as the param widened
+static inline bool pico_optim_masters_sync(struct PicoOptimChunks* c, struct PicoVec* params) {
+    int n_params = (int)params->size;
+    int64_t* offsets = malloc(sizeof(int64_t) * (n_params > 0 ? n_params : 1));
+    if(offsets == NULL) return false;
+    int64_t len = 0;
+    for(int i = 0; i < n_params; i++) {
+        struct PicoTensor* t = params->data[i];
+        offsets[i] = t->dtype == PICO_F32 ? -1 : len;
+        if(t->dtype != PICO_F32) len += t->numel;
+    }
+    if(len == 0) {
+        free(offsets);
+        return true;
+    }
+    float* master = malloc(sizeof(float) * len);
+    if(master == NULL) {
+        free(offsets);
+        return false;
+    }
+    for(int i = 0; i < n_params; i++) {
+        struct PicoTensor* t = params->data[i];
+        if(offsets[i] < 0) continue;
+        if(i < c->params && c->master_offsets != NULL && c->master_offsets[i] >= 0) {
+            memcpy(master + offsets[i], c->master + c->master_offsets[i],
+                   sizeof(float) * t->numel);
+        } else {
+            pico_convert_cpu(t->data16, t->dtype, master + offsets[i], PICO_F32, t->numel);
+        }
+    }
+    free(c->master);
+    free(c->master_offsets);
+    c->master = master;
+    c->master_offsets = offsets;
+    return true;
+}
+
+static inline struct PicoSparseGrad* pico_optim_sparse_grad(const struct PicoOptimChunks* c,
+                                                            int param) {
+    return param < c->n_sparse ? c->sparse[param] : NULL;
+}
+
+// register params->data[param] (just pushed) as row-sparse with `grad`
+static inline bool pico_optim_chunks_add_sparse(struct PicoOptimChunks* c, struct PicoVec* params,
+                                                struct PicoTensor* param,
+                                                struct PicoSparseGrad* grad) {
+    if(param->ndim != 2 || param->dtype != PICO_F32 || grad->dim != param->shape[1]) {
+        fprintf(stderr, "[Pico] Error: A sparse param must be fp32 [rows, dim] with a "
+                        "dim-wide grad!\n");
+        return false;
+    }
+    int n = (int)params->size;
+    struct PicoSparseGrad** sparse = realloc(c->sparse, sizeof(struct PicoSparseGrad*) * n);
+    if(sparse == NULL) {
+        fprintf(stderr, "[Pico] Error: Optimizer sparse list allocation failed!\n");
+        return false;
+    }
+    for(int i = c->n_sparse; i < n; i++) sparse[i] = NULL;
+    sparse[n - 1] = grad;
+    c->sparse = sparse;
+    c->n_sparse = n;
+    return true;
+}
+
+// (re)build the item list when params were added since the last build. sparse params
+// get no items: pico_optim_apply walks their rows separately
+static inline bool pico_optim_chunks_sync(struct PicoOptimChunks* c, struct PicoVec* params) {
+    int n_params = (int)params->size;
+    if(c->items != NULL && c->params == n_params) return true;
+
+    int64_t n = 0, numel = 0;
+    for(int i = 0; i < n_params; i++) {
+        if(pico_optim_sparse_grad(c, i) != NULL) continue;
+        numel += params->data[i]->numel;
+        n += (params->data[i]->numel + PICO_OPTIM_CHUNK - 1) / PICO_OPTIM_CHUNK;
+    }
+    struct PicoOptimChunk* items = malloc(sizeof(struct PicoOptimChunk) * (n > 0 ? n : 1));
+    if(items == NULL || !pico_optim_masters_sync(c, params)) {
+        free(items);
+        fprintf(stderr, "[Pico] Error: Optimizer chunk allocation failed!\n");
+        return false;
+    }
+
+    int64_t k = 0;
+    for(int i = 0; i < n_params; i++) {
+        int64_t len = pico_optim_sparse_grad(c, i) != NULL ? 0 : params->data[i]->numel;
+        for(int64_t start = 0; start < len; start += PICO_OPTIM_CHUNK) {
+            items[k].param = i;
+            items[k].start = start;
+            items[k].n = len - start < PICO_OPTIM_CHUNK ? len - start : PICO_OPTIM_CHUNK;
+            k++;
+        }
+    }
+
+    free(c->items);
+    c->items = items;
+    c->n = n;
+    c->numel = numel;
+    c->params = n_params;
+    return true;
+}
+
+static inline void pico_optim_chunks_free(struct PicoOptimChunks* c) {
+    free(c->items);
+    free(c->master);
+    free(c->master_offsets);
+    free(c->sparse);
+    c->items = NULL;
+    c->master = NULL;
+    c->master_offsets = NULL;
+    c->sparse = NULL;
+    c->n = 0;
+    c->n_sparse = 0;
+}
+
+// 1/K for K accumulated micro-batches
+static inline float pico_optim_grad_scale(int accum_steps) {
+    return accum_steps > 1 ? 1.0f / (float)accum_steps : 1.0f;
+}
+
+// count one micro-batch; true when it completes the window (and restarts it)
+static inline bool pico_optim_accum_tick(int* count, int accum_steps) {
+    if(++*count < accum_steps) return false;
+    *count = 0;
+    return true;
+}
+
+struct PicoOptimApply {
+    struct PicoVec* params;
+    const struct PicoOptimChunks* chunks;
+    const int64_t* state_offsets;  // per param, into each state array; NULL without state
+    float* state;
+    int64_t state_len;
+    PicoOptimStepFn fn;  // NULL: only zero the grads
+    const struct PicoOptimStep* h;
+};
+
+static inline void pico_optim_apply_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoOptimApply* job = (struct PicoOptimApply*)ctx;
+    for(int64_t k = start; k < end; k++) {
+        const struct PicoOptimChunk* c = &job->chunks->items[k];
+        struct PicoTensor* t = job->params->data[c->param];
+        float* g = t->grad + c->start;
+        if(job->fn == NULL) {
+            memset(g, 0, sizeof(float) * c->n);
+            continue;
+        }
+        float* s0 = NULL;
+        if(job->state != NULL) s0 = job->state + job->state_offsets[c->param] + c->start;
+        // half params: step the fp32 master, then round it back into the param
+        float* p = t->dtype == PICO_F32
+                       ? t->data + c->start
+                       : job->chunks->master + job->chunks->master_offsets[c->param] + c->start;
+        job->fn(p, g, s0, s0 ? s0 + job->state_len : NULL, c->n, job->h);
+        if(t->dtype != PICO_F32) pico_narrow_cpu(p, t->data16 + c->start, t->dtype, c->n);
+    }
+}
+
+// one sparse param: row r of the param and of its state, stepped with the grad row that
+// lists r. rows are unique, so slices never share a row
+struct PicoOptimSparseApply {
+    const struct PicoOptimApply* apply;
+    struct PicoTensor* param;
+    const struct PicoSparseGrad* grad;
+    float* s0;  // the param's state slices, NULL without state
+    float* s1;
+};
+
+static inline void pico_optim_sparse_slice(void* ctx, int64_t start, int64_t end) {
+    struct PicoOptimSparseApply* job = (struct PicoOptimSparseApply*)ctx;
+    int64_t dim = job->grad->dim;
+    for(int64_t k = start; k < end; k++) {
+        int64_t off = job->grad->rows[k] * dim;
+        job->apply->fn(job->param->data + off, job->grad->values + k * dim,
+                       job->s0 ? job->s0 + off : NULL, job->s1 ? job->s1 + off : NULL, dim,
+                       job->apply->h);
+    }
+}
+
+// step (or, with no fn, clear) every sparse param's listed rows
+static inline void pico_optim_apply_sparse(struct PicoOptimApply* job) {
+    const struct PicoOptimChunks* c = job->chunks;
+    for(int i = 0; i < c->n_sparse; i++) {
+        struct PicoSparseGrad* g = c->sparse[i];
+        if(g == NULL) continue;
+        if(job->fn != NULL && g->n > 0) {
+            struct PicoOptimSparseApply sj = {.apply = job, .param = job->params->data[i],
+                                              .grad = g};
+            if(job->state != NULL) {
+                sj.s0 = job->state + job->state_offsets[i];
+                sj.s1 = sj.s0 + job->state_len;
+            }
+            pico_parallel_for(g->n, MAX(1, PICO_ACT_THREAD_MIN_CHUNK / g->dim),
+                              pico_optim_sparse_slice, &sj);
+        }
+        if(job->fn == NULL || job->h->zero_grad) pico_sparse_grad_clear(g);
+    }
+}
+
+// about PICO_ACT_THREAD_MIN_CHUNK floats per thread; anything under two threads' worth
+// runs inline
+static inline void pico_optim_apply(struct PicoOptimApply* job) {
+    const struct PicoOptimChunks* c = job->chunks;
+    if(c->n > 0) {
+        int64_t min_items = c->n;
+        if(c->numel >= 2 * PICO_ACT_THREAD_MIN_CHUNK) {
+            min_items = (PICO_ACT_THREAD_MIN_CHUNK * c->n + c->numel - 1) / c->numel;
+        }
+        pico_parallel_for(c->n, min_items, pico_optim_apply_slice, job);
+    }
+    pico_optim_apply_sparse(job);
+}
@@ -0,0 +1,178 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "kernels/cpu_kernels.h"
+#include "lib/pico_vector.h"
+#include "multi_tensor.h"
+#include "optim.h"
+#include "tensor.h"
+
+#define PICO_OPTIM_ALIGN 64  // bytes: one cache line, one AVX-512 vector
+#define PICO_OPTIM_PAD 16    // floats each param's state slice is rounded up to
+
+static struct PicoOptim* pico_optim_init(enum PicoOptimKind kind, float lr) {
+    struct PicoOptim* optim = (struct PicoOptim*)calloc(1, sizeof(struct PicoOptim));
+    pico_vec_init(&optim->params, 25);
+    optim->kind = kind;
+    optim->lr = lr;
+    optim->eps = 1e-8f;
+    return optim;
+}
+
+struct PicoOptim* pico_optim_nag_init(float lr, float momentum) {
+    struct PicoOptim* optim = pico_optim_init(PICO_OPTIM_NAG, lr);
+    optim->momentum = momentum;
+    return optim;
+}
+
+struct PicoOptim* pico_optim_adagrad_init(float lr) {
+    struct PicoOptim* optim = pico_optim_init(PICO_OPTIM_ADAGRAD, lr);
+    optim->eps = 1e-10f;
+    return optim;
+}
+
+struct PicoOptim* pico_optim_rmsprop_init(float lr, float alpha) {
+    struct PicoOptim* optim = pico_optim_init(PICO_OPTIM_RMSPROP, lr);
+    optim->alpha = alpha;
+    return optim;
+}
+
+struct PicoOptim* pico_optim_adam_init(float lr, float beta1, float beta2) {
+    struct PicoOptim* optim = pico_optim_init(PICO_OPTIM_ADAM, lr);
+    optim->beta1 = beta1;
+    optim->beta2 = beta2;
+    return optim;
+}
+
+struct PicoOptim* pico_optim_adamw_init(float lr, float beta1, float beta2, float weight_decay) {
+    struct PicoOptim* optim = pico_optim_adam_init(lr, beta1, beta2);
+    optim->kind = PICO_OPTIM_ADAMW;
+    optim->weight_decay = weight_decay;
+    return optim;
+}
+
+void pico_optim_add(struct PicoOptim* optim, struct PicoTensor* param) {
+    pico_vec_push(&optim->params, param);
+}
+
+void pico_optim_add_sparse(struct PicoOptim* optim, struct PicoTensor* param,
+                           struct PicoSparseGrad* grad) {
+    pico_vec_push(&optim->params, param);
+    if(!pico_optim_chunks_add_sparse(&optim->chunks, &optim->params, param, grad)) {
+        optim->params.size--;
+    }
+}
+
+int pico_optim_n_state(enum PicoOptimKind kind) {
+    return kind == PICO_OPTIM_ADAM || kind == PICO_OPTIM_ADAMW ? 2 : 1;
+}
+
+// (re)build the state slab and the chunk list so they cover every registered param.
+// existing state is carried over; new params start at zero. only runs when params
+// were added.
+bool pico_optim_ensure_state(struct PicoOptim* optim) {
+    int n_params = (int)optim->params.size;
+    if(optim->state != NULL && optim->state_params == n_params) return true;
+
+    int64_t* offsets = malloc(sizeof(int64_t) * (n_params > 0 ? n_params : 1));
+    int64_t len = 0;
+    for(int i = 0; i < n_params; i++) {
+        offsets[i] = len;
+        int64_t numel = optim->params.data[i]->numel;
+        len += (numel + PICO_OPTIM_PAD - 1) / PICO_OPTIM_PAD * PICO_OPTIM_PAD;
+    }
+
+    int n_state = pico_optim_n_state(optim->kind);
+    size_t bytes = sizeof(float) * (size_t)(len > 0 ? len : PICO_OPTIM_PAD) * n_state;
+    bytes = (bytes + PICO_OPTIM_ALIGN - 1) / PICO_OPTIM_ALIGN * PICO_OPTIM_ALIGN;
+    float* state = aligned_alloc(PICO_OPTIM_ALIGN, bytes);
+    if(offsets == NULL || state == NULL) {
+        fprintf(stderr, "[Pico] Error: Optimizer state allocation failed!\n");
+        free(offsets);
+        free(state);
+        return false;
+    }
+    memset(state, 0, bytes);
+
+    // old params keep their index, so their slices just move
+    for(int s = 0; s < n_state && optim->state != NULL; s++) {
+        for(int i = 0; i < optim->state_params; i++) {
+            memcpy(state + s * len + offsets[i],
+                   optim->state + s * optim->state_len + optim->offsets[i],
+                   sizeof(float) * optim->params.data[i]->numel);
+        }
+    }
+
+    free(optim->state);
+    free(optim->offsets);
+    optim->state = state;
+    optim->offsets = offsets;
+    optim->state_len = len;
+    optim->state_params = n_params;
+    return pico_optim_chunks_sync(&optim->chunks, &optim->params);
+}
+
+void pico_optim_step(struct PicoOptim* optim) {
+    if(!pico_optim_ensure_state(optim)) return;
+    optim->t++;
+
+    struct PicoOptimStep step = {.grad_scale = pico_optim_grad_scale(optim->accum_steps),
+                                 .zero_grad = optim->fuse_zero_grad};
+    struct PicoOptimStep* h = &step;
+    struct PicoOptimApply job = {.params = &optim->params,
+                                 .chunks = &optim->chunks,
+                                 .state_offsets = optim->offsets,
+                                 .state = optim->state,
+                                 .state_len = optim->state_len,
+                                 .h = h};
+    h->lr = optim->lr;
+    h->eps = optim->eps;
+    h->momentum = optim->momentum;
+    h->alpha = optim->alpha;
+    h->beta1 = optim->beta1;
+    h->beta2 = optim->beta2;
+    h->wd_l2 = optim->kind == PICO_OPTIM_ADAMW ? 0.0f : optim->weight_decay;
+    h->decay = optim->kind == PICO_OPTIM_ADAMW ? 1.0f - optim->lr * optim->weight_decay : 1.0f;
+
+    switch(optim->kind) {
+        case PICO_OPTIM_NAG:
+            job.fn = pico_nag_step_cpu;
+            break;
+        case PICO_OPTIM_ADAGRAD:
+            job.fn = pico_adagrad_step_cpu;
+            break;
+        case PICO_OPTIM_RMSPROP:
+            job.fn = pico_rmsprop_step_cpu;
+            break;
+        case PICO_OPTIM_ADAM:
+        case PICO_OPTIM_ADAMW:
+            job.fn = pico_adam_step_cpu;
+            h->step_scale = optim->lr / (1.0f - powf(optim->beta1, (float)optim->t));
+            h->v_scale = 1.0f / sqrtf(1.0f - powf(optim->beta2, (float)optim->t));
+            break;
+    }
+
+    pico_optim_apply(&job);
+}
+
+bool pico_optim_accum_step(struct PicoOptim* optim) {
+    if(!pico_optim_accum_tick(&optim->accum_count, optim->accum_steps)) return false;
+    pico_optim_step(optim);
+    return true;
+}
+
+void pico_optim_zero_grad(struct PicoOptim* optim) {
+    if(!pico_optim_chunks_sync(&optim->chunks, &optim->params)) return;
+    struct PicoOptimApply job = {.params = &optim->params, .chunks = &optim->chunks};
+    pico_optim_apply(&job);
+}
+
+void pico_optim_free(struct PicoOptim* optim) {
+    pico_vec_free(&optim->params);
+    free(optim->state);
+    free(optim->offsets);
+    pico_optim_chunks_free(&optim->chunks);
+    free(optim);
+}
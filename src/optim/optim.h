@@ -1,23 +1,139 @@
-
+#pragma once
 #include "lib/pico_vector.h"
 #include "tensor.h"
 
+// every optimizer steps through a flat list of <= 16K-float pieces of its params,
+// rebuilt when params are added (see multi_tensor.h)
+struct PicoOptimChunk {
+    int param;  // index into params
+    int64_t start;
+    int64_t n;
+};
+
+struct PicoOptimChunks {
+    struct PicoOptimChunk* items;
+    int64_t n;
+    int64_t numel;  // over all params
+    int params;     // params the list covers
+    float* master;            // fp32 master copies of the half params, back to back
+    int64_t* master_offsets;  // per param, into master; -1 for fp32 params
+    struct PicoSparseGrad** sparse;  // per param, its row-sparse grad; NULL: dense grad
+    int n_sparse;                    // entries in sparse
+};
+
+// set fuse_zero_grad on any optimizer to have step() clear each grad right after
+// reading it: grads come out of the step zeroed, and the separate zero_grad sweep
+// can go.
+//
+// gradient accumulation: set accum_steps = K, run K micro-batches (forward +
+// pico_backward, arena_reset in between; param grads keep summing since they live
+// outside the arena), then step once. step() reads every grad as grad / K inside its
+// fused pass, so the update matches one batch K times the size with no extra scale
+// sweep. the *_accum_step calls do the counting: call one after each micro-batch's
+// backward and it steps on every K-th call, returning true when it did. pair with
+// fuse_zero_grad (or zero_grad when it returns true) so the next window starts at 0.
+//
+// mixed precision: a bf16/fp16 param is stepped on an fp32 master copy the optimizer
+// keeps (copied from the param the first time it's walked), and the result is rounded
+// back into the param. updates far below the half ulp of a weight still add up in the
+// master instead of rounding away every step. the master is the source of truth from
+// then on: write to a half param directly and the next step overwrites it.
+//
+// row-sparse params: *_add_sparse registers an fp32 [rows, dim] param with the sparse
+// grad that stands in for its dense one (a sparse PicoEmbedding's weights + grad). the
+// step runs the same kernels on the listed rows only, and zero_grad / fuse_zero_grad
+// clear the list, so step and zero cost O(rows touched), not O(rows). updates are lazy
+// like PyTorch's SparseAdam: rows not in the list keep their state as it is (no
+// momentum carried, no weight decay) until they are next touched. the optimizer state
+// itself is still one slice per row.
+
 // ========== SGD
 
 struct PicoOptimSGD {
     struct PicoVec params;
     float lr;
+    bool fuse_zero_grad;
+    int accum_steps;  // micro-batches per step, grads averaged over them (0 or 1: off)
+    int accum_count;  // micro-batches seen in the current window
+    struct PicoOptimChunks chunks;
 };
 
 struct PicoOptimSGD* pico_optim_sgd_init(float lr);
 void pico_optim_sgd_add(struct PicoOptimSGD* optim, struct PicoTensor* param);
+void pico_optim_sgd_add_sparse(struct PicoOptimSGD* optim, struct PicoTensor* param,
+                               struct PicoSparseGrad* grad);
 void pico_optim_sgd_step(struct PicoOptimSGD* optim);
+bool pico_optim_sgd_accum_step(struct PicoOptimSGD* optim);
 void pico_optim_sgd_zero_grad(struct PicoOptimSGD* optim);
 void pico_optim_sgd_free(struct PicoOptimSGD* optim);
 
 
+// ==================== stateful optimizers
+//
+// NAG, AdaGrad, RMSProp, Adam and AdamW share one struct + one set of calls
+// (pico_optim_add / _step / _zero_grad / _free); the *_init picks the algorithm.
+// each step is ONE fused SIMD pass over param/grad/state, run over the optimizer's
+// chunk list in parallel on global_tp. the state (momentum / squared-grad averages)
+// is one 64-byte aligned slab, each param's slice padded to whole AVX-512 vectors.
+//
+// weight_decay is L2 (added to the gradient) for every algorithm except AdamW, where
+// it's decoupled (p *= 1 - lr*wd before the update). eps and weight_decay have
+// defaults from the init and can be changed on the struct between steps.
+//
+// Muon isn't here: its update orthogonalises each weight matrix with Newton-Schulz
+// matmuls, so it isn't an element-wise step and doesn't fit this pass.
+
+enum PicoOptimKind {
+    PICO_OPTIM_NAG,
+    PICO_OPTIM_ADAGRAD,
+    PICO_OPTIM_RMSPROP,
+    PICO_OPTIM_ADAM,
+    PICO_OPTIM_ADAMW,
+};
+
+struct PicoOptim {
+    struct PicoVec params;
+    enum PicoOptimKind kind;
+    float lr;
+    float momentum;  // NAG
+    float alpha;     // RMSProp
+    float beta1;     // Adam(W)
+    float beta2;     // Adam(W)
+    float eps;
+    float weight_decay;
+    bool fuse_zero_grad;
+    int accum_steps;  // see SGD
+    int accum_count;
+    int64_t t;  // steps taken (Adam bias correction)
+
+    float* state;       // n_state arrays of state_len floats, back to back
+    int64_t* offsets;   // per param, into each state array
+    int64_t state_len;  // floats per state array
+    int state_params;   // params the slab covers (grows on the first step after an add)
+    struct PicoOptimChunks chunks;
+};
+
 // ==================== Nesterov accelerated gradient (NAG)
+struct PicoOptim* pico_optim_nag_init(float lr, float momentum);
 // ==================== AdaGrad
+struct PicoOptim* pico_optim_adagrad_init(float lr);
 // ==================== RMSProp
+struct PicoOptim* pico_optim_rmsprop_init(float lr, float alpha);
 // ==================== ADAM
-// ==================== Muon
+struct PicoOptim* pico_optim_adam_init(float lr, float beta1, float beta2);
+struct PicoOptim* pico_optim_adamw_init(float lr, float beta1, float beta2, float weight_decay);
+
+void pico_optim_add(struct PicoOptim* optim, struct PicoTensor* param);
+void pico_optim_add_sparse(struct PicoOptim* optim, struct PicoTensor* param,
+                           struct PicoSparseGrad* grad);
+void pico_optim_step(struct PicoOptim* optim);
+bool pico_optim_accum_step(struct PicoOptim* optim);
+void pico_optim_zero_grad(struct PicoOptim* optim);
+void pico_optim_free(struct PicoOptim* optim);
+
+// state arrays per param: 2 for Adam(W) (m, v), 1 for the others
+int pico_optim_n_state(enum PicoOptimKind kind);
+
+// lay out the state slab so it covers every registered param (new ones start at zero).
+// step() calls it; checkpointing calls it to reach the state before the first step
+bool pico_optim_ensure_state(struct PicoOptim* optim);
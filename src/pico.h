@@ -9,6 +9,18 @@
 #include "Error.h"
 #include "lib/pico_vector.h"
 #include "act/activations.h"
+#include "attention/attention.h"
+#include "fused/fused.h"
 #include "loss/loss.h"
+#include "nn/conv.h"
+#include "nn/embedding.h"
+#include "nn/init.h"
 #include "nn/linear.h"
+#include "nn/qlinear.h"
+#include "checkpoint/checkpoint.h"
+#include "data/dataset.h"
+#include "norm/norm.h"
 #include "optim/optim.h"
+#include "reduce/reduce.h"
+#include "rng/rng.h"
+#include "view/view.h"
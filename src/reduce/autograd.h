@@ -0,0 +1,101 @@
+/*
+ * backward for the reductions. for the chain-rule basics check out ../autograd.h
+ *
+ * every x element feeds exactly one output element, so backward is a single walk over
+ * x: an odometer over x's shape tracks the matching output offset (output stride is 0
+ * along reduced axes), and dx picks up that output's gradient.
+ */
+
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "arena.h"
+#include "reduce/reduce.h"
+#include "tensor.h"
+
+// saved in out->_ctx by the forward
+struct PicoReduceCtx {
+    uint32_t mask;  // bit d set = axis d of x was reduced
+    float scale;    // 1 for sum, 1/count for mean
+};
+
+// output offset for every x element, in x's (contiguous) order. out_strides are the
+// keepdim-layout strides with 0 along reduced axes
+static inline void pico_reduce_out_offsets(struct PicoTensor* x, uint32_t mask, int64_t* offsets) {
+    int64_t out_strides[PICO_REDUCE_MAX_DIMS];
+    int64_t idx[PICO_REDUCE_MAX_DIMS] = {0};
+    int64_t stride = 1;
+    for(int d = x->ndim - 1; d >= 0; d--) {
+        out_strides[d] = (mask >> d) & 1u ? 0 : stride;
+        if(!((mask >> d) & 1u)) stride *= x->shape[d];
+    }
+
+    int64_t o = 0;
+    for(int64_t i = 0; i < x->numel; i++) {
+        offsets[i] = o;
+        for(int d = x->ndim - 1; d >= 0; d--) {
+            o += out_strides[d];
+            if(++idx[d] < x->shape[d]) break;
+            o -= out_strides[d] * idx[d];
+            idx[d] = 0;
+        }
+    }
+}
+
+// backward scratch from the current arena, as the forwards take theirs. NULL (with a
+// message) when there's no arena or the block doesn't fit
+static inline void* pico_reduce_scratch(size_t bytes) {
+    struct Arena* arena = arena_ctx_current();
+    void* p = arena != NULL ? arena_alloc(arena, bytes) : NULL;
+    if(p == NULL) {
+        fprintf(stderr, "[Pico] Error: In reduce - no arena space for the backward's scratch!\n");
+    }
+    return p;
+}
+
+// sum / mean:  dx += dy * scale
+static inline void pico_sum_backward(struct PicoTensor* self) {
+    struct PicoTensor* x = self->parents[0];
+    struct PicoReduceCtx* ctx = (struct PicoReduceCtx*)self->_ctx;
+    if(!x->requires_grad || x->grad == NULL) return;
+
+    if(self->numel == 1) {
+        float g = self->grad[0] * ctx->scale;
+        for(int64_t i = 0; i < x->numel; i++) x->grad[i] += g;
+        return;
+    }
+
+    int64_t* offsets = pico_reduce_scratch(sizeof(int64_t) * x->numel);
+    if(offsets == NULL) return;
+    pico_reduce_out_offsets(x, ctx->mask, offsets);
+    for(int64_t i = 0; i < x->numel; i++) {
+        x->grad[i] += self->grad[offsets[i]] * ctx->scale;
+    }
+}
+
+// max: the first x equal to its output (or the first NaN, if the output is NaN) gets dy
+static inline void pico_max_backward(struct PicoTensor* self) {
+    struct PicoTensor* x = self->parents[0];
+    struct PicoReduceCtx* ctx = (struct PicoReduceCtx*)self->_ctx;
+    if(!x->requires_grad || x->grad == NULL) return;
+
+    // one block: the offsets, then a claimed flag per output
+    int64_t* offsets = pico_reduce_scratch(sizeof(int64_t) * x->numel + self->numel);
+    if(offsets == NULL) return;
+    uint8_t* claimed = (uint8_t*)(offsets + x->numel);
+    memset(claimed, 0, self->numel);
+    pico_reduce_out_offsets(x, ctx->mask, offsets);
+    for(int64_t i = 0; i < x->numel; i++) {
+        int64_t o = offsets[i];
+        if(claimed[o]) continue;
+        float y = self->data[o];
+        if(x->data[i] == y || (isnan(y) && isnan(x->data[i]))) {
+            x->grad[i] += self->grad[o];
+            claimed[o] = 1;
+        }
+    }
+}
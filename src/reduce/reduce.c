@@ -0,0 +1,195 @@
+#include "reduce.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "arena.h"
+#include "kernels/cpu_kernels.h"
+#include "reduce/autograd.h"
+#include "tensor.h"
+#include "view/view.h"
+
+// axes -> bitmask over x's dims. NULL/0 axes = all of them. 0 on a bad/duplicate axis
+static uint32_t pico_reduce_mask(struct PicoTensor* x, const int* axes, int n_axes) {
+    if(axes == NULL || n_axes == 0) return (uint32_t)((1ull << x->ndim) - 1);
+
+    uint32_t mask = 0;
+    for(int k = 0; k < n_axes; k++) {
+        int d = axes[k] < 0 ? axes[k] + x->ndim : axes[k];
+        if(d < 0 || d >= x->ndim || (mask >> d) & 1u) {
+            fprintf(stderr, "[Pico] Error: Bad reduction axis %d for a %d-d tensor!\n", axes[k],
+                    x->ndim);
+            return 0;
+        }
+        mask |= 1u << d;
+    }
+    return mask;
+}
+
+// x's shape as alternating kept/reduced blocks: size-1 dims are dropped, neighbours
+// with the same flag are merged. returns the block count
+static int pico_reduce_coalesce(struct PicoTensor* x, uint32_t mask, int64_t* sizes,
+                                bool* reduced) {
+    int n = 0;
+    for(int d = 0; d < x->ndim; d++) {
+        if(x->shape[d] == 1) continue;
+        bool r = (mask >> d) & 1u;
+        if(n > 0 && reduced[n - 1] == r) {
+            sizes[n - 1] *= x->shape[d];
+        } else {
+            sizes[n] = x->shape[d];
+            reduced[n] = r;
+            n++;
+        }
+    }
+    return n;
+}
+
+// shared front half: validate, build the output shape, allocate
+static struct PicoTensor* pico_reduce_output(struct PicoTensor* x, uint32_t mask, bool keepdim) {
+    if(x->ndim > PICO_REDUCE_MAX_DIMS) {
+        fprintf(stderr, "[Pico] Error: Reductions support at most %d dims!\n",
+                PICO_REDUCE_MAX_DIMS);
+        return NULL;
+    }
+
+    struct Arena* arena = arena_ctx_current();
+    if(arena == NULL) {
+        fprintf(stderr, "[Pico] Error: No current arena in context!\n");
+        return NULL;
+    }
+
+    int64_t* shape = arena_alloc(arena, sizeof(int64_t) * x->ndim);
+    int ndim = 0;
+    for(int d = 0; d < x->ndim; d++) {
+        if(!((mask >> d) & 1u)) shape[ndim++] = x->shape[d];
+        else if(keepdim) shape[ndim++] = 1;
+    }
+    if(ndim == 0) shape[ndim++] = 1;
+
+    struct PicoTensor* out = pico_create_tensor(arena, shape, (uint8_t)ndim);
+    out->backend = x->backend;
+    return out;
+}
+
+// run the reduction one reduced block at a time, innermost first: each pass is an
+// [O, R, I] reduce, after which the block is gone and its kept neighbours merge.
+// intermediate passes go to arena scratch, the last one lands in y
+static void pico_reduce_forward(enum PicoReduceOp op, struct PicoTensor* x, uint32_t mask,
+                                float* y) {
+    int64_t sizes[PICO_REDUCE_MAX_DIMS];
+    bool reduced[PICO_REDUCE_MAX_DIMS];
+    int n = pico_reduce_coalesce(x, mask, sizes, reduced);
+
+    int n_reduced = 0;
+    for(int b = 0; b < n; b++) n_reduced += reduced[b];
+    if(n_reduced == 0) {
+        memcpy(y, x->data, sizeof(float) * x->numel);  // only size-1 axes were reduced
+        return;
+    }
+
+    const float* src = x->data;
+    int64_t remaining = x->numel;
+    while(n_reduced > 0) {
+        int j = n - 1;
+        while(!reduced[j]) j--;
+
+        int64_t O = 1, I = 1;
+        for(int b = 0; b < j; b++) O *= sizes[b];
+        for(int b = j + 1; b < n; b++) I *= sizes[b];
+        remaining /= sizes[j];
+
+        float* dst = y;
+        if(n_reduced > 1) dst = arena_alloc(arena_ctx_current(), sizeof(float) * remaining);
+        pico_reduce_ori_cpu(op, src, dst, O, sizes[j], I);
+        src = dst;
+
+        // drop block j, merge the kept blocks on either side of it
+        if(j > 0 && j + 1 < n) {
+            sizes[j - 1] *= sizes[j + 1];
+            memmove(&sizes[j], &sizes[j + 2], sizeof(int64_t) * (n - j - 2));
+            memmove(&reduced[j], &reduced[j + 2], sizeof(bool) * (n - j - 2));
+            n -= 2;
+        } else {
+            memmove(&sizes[j], &sizes[j + 1], sizeof(int64_t) * (n - j - 1));
+            memmove(&reduced[j], &reduced[j + 1], sizeof(bool) * (n - j - 1));
+            n -= 1;
+        }
+        n_reduced--;
+    }
+}
+
+// sum / mean / max share everything but the kernel op, the scale and the backward
+static struct PicoTensor* pico_reduce_op(enum PicoReduceOp op, struct PicoTensor* x,
+                                         const int* axes, int n_axes, bool keepdim, bool mean,
+                                         void (*backward)(struct PicoTensor*)) {
+    uint32_t mask = pico_reduce_mask(x, axes, n_axes);
+    if(mask == 0) return NULL;
+
+    struct PicoTensor* out = pico_reduce_output(x, mask, keepdim);
+    if(out == NULL) return NULL;
+    x = pico_as_f32(pico_contiguous(x));
+
+    struct PicoReduceCtx* ctx = arena_alloc(arena_ctx_current(), sizeof(struct PicoReduceCtx));
+    ctx->mask = mask;
+    ctx->scale = mean ? (float)out->numel / (float)x->numel : 1.0f;
+
+    if(x->backend == CPU) {
+        pico_reduce_forward(op, x, mask, out->data);
+        if(mean) {
+            for(int64_t i = 0; i < out->numel; i++) out->data[i] *= ctx->scale;
+        }
+    }
+
+    out->parents = arena_alloc(arena_ctx_current(), sizeof(struct PicoTensor*));
+    out->parents[0] = x;
+    out->num_parents = 1;
+    out->_ctx = ctx;
+    out->_backward = backward;
+
+    return out;
+}
+
+struct PicoTensor* pico_sum(struct PicoTensor* x, const int* axes, int n_axes, bool keepdim) {
+    return pico_reduce_op(PICO_REDUCE_SUM, x, axes, n_axes, keepdim, false, pico_sum_backward);
+}
+
+struct PicoTensor* pico_mean(struct PicoTensor* x, const int* axes, int n_axes, bool keepdim) {
+    return pico_reduce_op(PICO_REDUCE_SUM, x, axes, n_axes, keepdim, true, pico_sum_backward);
+}
+
+struct PicoTensor* pico_max(struct PicoTensor* x, const int* axes, int n_axes, bool keepdim) {
+    return pico_reduce_op(PICO_REDUCE_MAX, x, axes, n_axes, keepdim, false, pico_max_backward);
+}
+
+struct PicoTensor* pico_argmax(struct PicoTensor* x, const int* axes, int n_axes, bool keepdim) {
+    uint32_t mask = pico_reduce_mask(x, axes, n_axes);
+    if(mask == 0) return NULL;
+
+    // an index into several separate blocks would need a multi-pass argmax that
+    // carries indices along; keep it to one block
+    int64_t sizes[PICO_REDUCE_MAX_DIMS];
+    bool reduced[PICO_REDUCE_MAX_DIMS];
+    int n = x->ndim <= PICO_REDUCE_MAX_DIMS ? pico_reduce_coalesce(x, mask, sizes, reduced) : 0;
+    int n_reduced = 0;
+    for(int b = 0; b < n; b++) n_reduced += reduced[b];
+    if(n_reduced > 1) {
+        fprintf(stderr, "[Pico] Error: pico_argmax needs adjacent axes!\n");
+        return NULL;
+    }
+
+    struct PicoTensor* out = pico_reduce_output(x, mask, keepdim);
+    if(out == NULL) return NULL;
+    x = pico_as_f32(pico_contiguous(x));
+
+    if(x->backend == CPU) {
+        if(n_reduced == 0) {
+            memset(out->data, 0, sizeof(float) * out->numel);  // every index is 0
+        } else {
+            pico_reduce_forward(PICO_REDUCE_ARGMAX, x, mask, out->data);
+        }
+    }
+
+    return out;
+}
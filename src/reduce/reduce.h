@@ -0,0 +1,30 @@
+/*
+ * reductions over a list of axes: sum, mean, max, argmax.
+ *
+ * axes may be negative (-1 = last). axes == NULL or n_axes == 0 reduces everything.
+ * keepdim leaves the reduced axes in the shape as size 1, otherwise they're dropped;
+ * a full reduction without keepdim gives shape {1} (pico has no 0-d tensors).
+ *
+ * the work is done by pico_reduce_ori_cpu (kernels/cpu_kernels.h): adjacent axes are
+ * coalesced first, so reducing axes {1, 2} of a contiguous [A, B, C] is ONE pass over
+ * [A, B*C], and scattered axes become one pass per reduced block, innermost first.
+ * sums are pairwise (inner axis) / Kahan (outer axes), so they don't drift with size.
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "tensor.h"
+
+#define PICO_REDUCE_MAX_DIMS 16
+
+struct PicoTensor* pico_sum(struct PicoTensor* x, const int* axes, int n_axes, bool keepdim);
+struct PicoTensor* pico_mean(struct PicoTensor* x, const int* axes, int n_axes, bool keepdim);
+
+// max propagates NaN. backward routes the gradient to the FIRST max (ties are not split)
+struct PicoTensor* pico_max(struct PicoTensor* x, const int* axes, int n_axes, bool keepdim);
+
+// index of the (first) max along the reduced axes, stored as float. not differentiable
+// (no parents, no _backward). the reduced axes must be adjacent, e.g. {1} or {1, 2}:
+// the index is the flat position inside that block.
+struct PicoTensor* pico_argmax(struct PicoTensor* x, const int* axes, int n_axes, bool keepdim);
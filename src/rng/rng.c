@@ -0,0 +1,45 @@
+#include "rng.h"
+
+#include <math.h>
+
+#include "kernels/cpu_kernels.h"
+
+struct PicoRng g_pico_rng = {.seed = 123456789u};
+
+struct PicoRng pico_rng_init(uint64_t seed, uint64_t stream) {
+    struct PicoRng rng = {.seed = seed, .stream = stream, .offset = 0};
+    return rng;
+}
+
+void pico_rng_seed(uint64_t seed) {
+    g_pico_rng = pico_rng_init(seed, 0);
+}
+
+// claim the counter range for n values: whole super-blocks, so the kernels never share
+// a Philox block between two fills
+static uint64_t pico_rng_claim(struct PicoRng* rng, int64_t n) {
+    uint64_t blocks = (uint64_t)((n + PICO_RNG_BLOCK - 1) / PICO_RNG_BLOCK) * PICO_RNG_LANES;
+    return __atomic_fetch_add(&rng->offset, blocks, __ATOMIC_RELAXED);
+}
+
+void pico_rng_uniform(struct PicoRng* rng, float* out, int64_t n, float lo, float hi) {
+    if(n <= 0) return;
+    uint64_t block = pico_rng_claim(rng, n);
+    pico_rng_fill_cpu(out, n, rng->seed, rng->stream, block, false, lo, hi - lo);
+}
+
+void pico_rng_normal(struct PicoRng* rng, float* out, int64_t n, float mean, float std) {
+    if(n <= 0) return;
+    uint64_t block = pico_rng_claim(rng, n);
+    pico_rng_fill_cpu(out, n, rng->seed, rng->stream, block, true, mean, std);
+}
+
+void pico_rng_trunc_normal(struct PicoRng* rng, float* out, int64_t n, float mean, float std,
+                           float a, float b) {
+    // Phi(z) = (1 + erf(z / sqrt 2)) / 2, so a uniform on [erf(alpha), erf(beta)) maps
+    // back through erfinv to a normal between the bounds
+    const float inv_sqrt2 = 0.70710678118654752f;
+    pico_rng_uniform(rng, out, n, erff((a - mean) / std * inv_sqrt2),
+                     erff((b - mean) / std * inv_sqrt2));
+    pico_erfinv_affine_cpu(out, n, mean, std / inv_sqrt2, a, b);
+}
@@ -0,0 +1,43 @@
+/*
+ * random numbers: a counter-based generator (Philox4x32-10).
+ *
+ * a PicoRng is a key (seed), a stream id and a position (offset). the value at any
+ * position is a pure function of the three, so a fill is split across global_tp in
+ * any way and still comes out the same, and there's no shared state to race on
+ * between threads except the offset, which each fill bumps atomically to claim its
+ * range. different streams of one seed are independent sequences: give each worker,
+ * layer or data shard its own stream instead of its own seed.
+ *
+ * pico_rand / pico_randn draw from g_pico_rng, which pico_init seeds from the clock;
+ * pico_rng_seed(s) makes them reproducible.
+ */
+#pragma once
+
+#include <stdint.h>
+
+struct PicoRng {
+    uint64_t seed;    // the Philox key
+    uint64_t stream;  // high half of the counter
+    uint64_t offset;  // low half: Philox blocks used so far (4 values each)
+};
+
+extern struct PicoRng g_pico_rng;
+
+struct PicoRng pico_rng_init(uint64_t seed, uint64_t stream);
+
+// g_pico_rng = pico_rng_init(seed, 0)
+void pico_rng_seed(uint64_t seed);
+
+// n floats uniform on [lo, hi) (24 random bits each; pico_rand uses 0, 1)
+void pico_rng_uniform(struct PicoRng* rng, float* out, int64_t n, float lo, float hi);
+
+// n floats normal(mean, std): Box-Muller straight into out, with the log's argument in
+// (0, 1] so it never sees 0
+void pico_rng_normal(struct PicoRng* rng, float* out, int64_t n, float mean, float std);
+
+// n floats normal(mean, std) restricted to [a, b], by inverse CDF: uniforms between
+// erf at the two bounds, then mean + std * sqrt(2) * erfinv. every value is one draw
+// (no rejection loop), so the fill stays element-wise and thread-count independent.
+// for bounds within ~4 std of the mean; further out the float CDF runs out of bits
+void pico_rng_trunc_normal(struct PicoRng* rng, float* out, int64_t n, float mean, float std,
+                           float a, float b);
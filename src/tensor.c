@@ -6,9 +6,13 @@
 #include <string.h>
 
 #include "arena.h"
+#include "autograd.h"
 #include "global.h"
+#include "kernels/cpu_kernels.h"
 #include "lib/pico_vector.h"
 #include "ops.h"
+#include "rng/rng.h"
+#include "view/view.h"
 
 void postorder(struct PicoTensor* root, struct PicoVec* vector, struct PicoVec* visited);
 
@@ -41,7 +45,19 @@ void pico_backward(struct Arena* arena, struct PicoTensor* entry) {
     pico_vec_free(&visited);
 }
 
+void pico_sparse_grad_clear(struct PicoSparseGrad* grad) {
+    free(grad->rows);
+    free(grad->values);
+    grad->rows = NULL;
+    grad->values = NULL;
+    grad->n = 0;
+}
+
 struct PicoTensor* pico_param(int64_t* shape, uint8_t ndim) {
+    return pico_param_dtype(shape, ndim, PICO_F32);
+}
+
+struct PicoTensor* pico_param_dtype(int64_t* shape, uint8_t ndim, PicoDType dtype) {
     struct PicoTensor* tensor = (struct PicoTensor*)calloc(1, sizeof(struct PicoTensor));
     if(tensor == NULL) {
         printf("Memory allocation failed!\n");
@@ -50,6 +66,8 @@ struct PicoTensor* pico_param(int64_t* shape, uint8_t ndim) {
 
     tensor->ndim = ndim;
     tensor->is_persistent = 1;
+    tensor->requires_grad = 1;
+    tensor->dtype = dtype;
 
     // allocate and copy the shape array
     tensor->shape = (int64_t*)calloc(ndim, sizeof(int64_t));
@@ -62,7 +80,7 @@ struct PicoTensor* pico_param(int64_t* shape, uint8_t ndim) {
     // compute number of elements
     int numel = pico_compute_numel(tensor->shape, tensor->ndim);
 
-    tensor->data = (float*)calloc(numel, sizeof(float));
+    tensor->data = (float*)calloc(numel, pico_dtype_size(dtype));
     tensor->grad = (float*)calloc(numel, sizeof(float));
     tensor->strides = (int64_t*)calloc(tensor->ndim, sizeof(int64_t));
 
@@ -84,6 +102,11 @@ struct PicoTensor* pico_param(int64_t* shape, uint8_t ndim) {
 }
 
 struct PicoTensor* pico_create_tensor(struct Arena* arena, int64_t* shape, uint8_t ndim) {
+    return pico_create_tensor_dtype(arena, shape, ndim, PICO_F32);
+}
+
+struct PicoTensor* pico_create_tensor_dtype(struct Arena* arena, int64_t* shape, uint8_t ndim,
+                                            PicoDType dtype) {
     struct PicoTensor* tensor = (struct PicoTensor*)arena_alloc(arena, sizeof(struct PicoTensor));
     if(tensor == NULL) {
         printf("Memory allocation failed!\n");
@@ -92,13 +115,16 @@ struct PicoTensor* pico_create_tensor(struct Arena* arena, int64_t* shape, uint8
 
     tensor->ndim = ndim;
     tensor->is_persistent = 0;
+    tensor->requires_grad = 1;
 
     // arena_alloc returns GARBAGE (not zeroed like calloc), so init these by hand
     // or the op/autograd code will read junk pointers.
     tensor->_backward = NULL;
     tensor->parents = NULL;
+    tensor->_ctx = NULL;
     tensor->num_parents = 0;
     tensor->backend = CPU;  // ops override this to inherit from inputs
+    tensor->dtype = dtype;
 
     // allocate and copy the shape array
     tensor->shape = (int64_t*)arena_alloc(arena, (ndim * sizeof(int64_t)));
@@ -111,8 +137,10 @@ struct PicoTensor* pico_create_tensor(struct Arena* arena, int64_t* shape, uint8
     // compute number of elements
     int numel = pico_compute_numel(tensor->shape, tensor->ndim);
 
-    tensor->data = (float*)arena_alloc(arena, numel * sizeof(float));
-    memset(tensor->data, 0, numel * sizeof(float));
+    // rounded to 4 bytes: arena_alloc doesn't align, and the grad comes right after
+    size_t data_bytes = ((size_t)numel * pico_dtype_size(dtype) + 3) & ~(size_t)3;
+    tensor->data = (float*)arena_alloc(arena, data_bytes);
+    memset(tensor->data, 0, data_bytes);
     tensor->grad = (float*)arena_alloc(arena, numel * sizeof(float));
     memset(tensor->grad, 0, numel * sizeof(float));
     tensor->strides = (int64_t*)arena_alloc(arena, tensor->ndim * sizeof(int64_t));
@@ -187,13 +215,42 @@ struct PicoTensor* pico_tensor_from_scalar(float value) {
     return tensor;
 }
 
+struct PicoTensor* pico_to_dtype(struct PicoTensor* x, PicoDType dtype) {
+    if(x->dtype == dtype) {
+        return x;
+    }
+
+    struct Arena* arena = arena_ctx_current();
+    if(arena == NULL) {
+        fprintf(stderr, "[Pico] Error: No current arena in context!\n");
+        return NULL;
+    }
+    x = pico_contiguous(x);
+
+    struct PicoTensor* out = pico_create_tensor_dtype(arena, x->shape, x->ndim, dtype);
+    out->backend = x->backend;
+    out->requires_grad = x->requires_grad;  // a cast of a constant is a constant
+    memcpy(out->strides, x->strides, sizeof(int64_t) * x->ndim);
+
+    if(x->backend == CPU) {
+        pico_convert_cpu(x->data, x->dtype, out->data, dtype, x->numel);
+    }
+
+    out->parents = arena_alloc(arena, sizeof(struct PicoTensor*));
+    out->parents[0] = x;
+    out->num_parents = 1;
+    out->_backward = pico_to_dtype_backward;
+
+    return out;
+}
+
 // recursive helper: walk one dim, indent nested brackets, use strides so a
 // non-contiguous / broadcasted view still prints in logical shape order.
 static void pico_print_recursive(struct PicoTensor* t, int dim, int64_t offset) {
     if(dim == t->ndim - 1) {  // innermost axis -> print the row
         printf("[");
         for(int64_t i = 0; i < t->shape[dim]; i++) {
-            printf("%g", t->data[offset + i * t->strides[dim]]);
+            printf("%g", pico_tensor_get(t, offset + i * t->strides[dim]));
             if(i != t->shape[dim] - 1) printf(", ");
         }
         printf("]");
@@ -245,48 +302,41 @@ void pico_transpose_2d(struct PicoTensor* tensor) {
 
 // ============================= pico_rand
 
-// Fast Xorshift32 generator
-static inline uint32_t xorshift32(void) {
-    uint32_t x = x_state;
-    x ^= x << 13;
-    x ^= x >> 17;
-    x ^= x << 5;
-    return x_state = x;
-}
-
-// Bulk generate floats directly via IEEE-754 bit-casting
-void generate_random_floats_fast(float* arr, size_t size) {
-    for(size_t i = 0; i < size; i++) {
-        uint32_t r = xorshift32();
-        // Construct a float in the range [1.0, 2.0) by setting mantissa bits
-        uint32_t bits = (r >> 9) | 0x3F800000;
-        float f = *(float*)&bits;
-        arr[i] = f - 1.0f;  // Shift range down to [0.0, 1.0)
-    }
-}
-
 struct PicoTensor* pico_rand(struct Arena* arena, int64_t* shape, uint8_t ndim) {
     struct PicoTensor* tensor = pico_create_tensor(arena, shape, ndim);
-    // dispatch properly into backends
-    generate_random_floats_fast(tensor->data, tensor->numel);
+    pico_rng_uniform(&g_pico_rng, tensor->data, tensor->numel, 0.0f, 1.0f);
     return tensor;
 }
 
-// ============================= pico_randn
+// ============================= pico_cat
 
-struct PicoTensor* pico_cat(struct PicoTensor* a, struct PicoTensor* b, int dim) {
-    if(a->backend != b->backend) {
-        fprintf(
-            stderr,
-            "[Pico] Error: PicoTensor backends are not compatible, Mismatch found in backends!\n");
+struct PicoTensor* pico_cat_n(struct PicoTensor** tensors, int n, int dim) {
+    if(n < 1 || n > PICO_CAT_MAX_TENSORS) {
+        fprintf(stderr, "[Pico] Error: In cat - 1 to %d tensors, got %d!\n",
+                PICO_CAT_MAX_TENSORS, n);
         return NULL;
     }
-    if(a->ndim != b->ndim) {
-        fprintf(stderr,
-                "[Pico] Error: PicoTensors are not compatible for contatenation, Mismatch found in "
-                "ndim!\n");
+    struct PicoTensor* first = tensors[0];
+    int ndim = first->ndim;
+    int d = dim < 0 ? dim + ndim : dim;
+    if(d < 0 || d >= ndim || ndim > PICO_VIEW_MAX_DIMS) {
+        fprintf(stderr, "[Pico] Error: In cat - bad dim %d for %d dims!\n", dim, ndim);
         return NULL;
     }
+    for(int k = 1; k < n; k++) {
+        struct PicoTensor* t = tensors[k];
+        if(t->backend != first->backend || t->dtype != first->dtype || t->ndim != ndim) {
+            fprintf(stderr, "[Pico] Error: In cat - tensor %d doesn't match the backend, dtype "
+                            "or ndim of the first!\n", k);
+            return NULL;
+        }
+        for(int i = 0; i < ndim; i++) {
+            if(i != d && t->shape[i] != first->shape[i]) {
+                fprintf(stderr, "[Pico] Error: In cat - tensor %d differs in dim %d!\n", k, i);
+                return NULL;
+            }
+        }
+    }
 
     struct Arena* arena = arena_ctx_current();
     if(arena == NULL) {
@@ -294,75 +344,101 @@ struct PicoTensor* pico_cat(struct PicoTensor* a, struct PicoTensor* b, int dim)
         return NULL;
     }
 
-    int64_t* res_shape = arena_alloc(arena, sizeof(int64_t) * a->ndim);
-
-    // dim=0 means stack them over each other dim=1 means side by side
-    for(int i = 0; i < a->ndim; i++) {
-        if(i == dim) {
-            res_shape[i] = a->shape[i] + b->shape[i];
-            continue;
-        }
-        if(a->shape[i] != b->shape[i]) {
-            fprintf(stderr,
-                    "[Pico] Error: PicoTensors are not compatible for contatenation, Mismatch "
-                    "found in shape!\n");
-            return NULL;
-        }
-        res_shape[i] = a->shape[i];
-    }
-
-    struct PicoTensor* out = pico_create_tensor(arena, res_shape, a->ndim);
-
-    float* src_a = (float*)a->data;
-    float* src_b = (float*)b->data;
-    float* dst = (float*)out->data;
+    // every input's place in an output row, up front: the copy and the backward both
+    // index with these and never search the inputs' shapes again
+    struct PicoCatCtx* ctx = arena_alloc(arena, sizeof(struct PicoCatCtx));
+    ctx->offsets = arena_alloc(arena, sizeof(int64_t) * n);
+    ctx->chunks = arena_alloc(arena, sizeof(int64_t) * n);
+    const char** src = arena_alloc(arena, sizeof(char*) * n);
+    struct PicoTensor** parents = arena_alloc(arena, sizeof(struct PicoTensor*) * n);
+
+    int64_t inner = 1;
+    for(int i = d + 1; i < ndim; i++) inner *= first->shape[i];
+    int64_t res_shape[PICO_VIEW_MAX_DIMS];
+    memcpy(res_shape, first->shape, sizeof(int64_t) * ndim);
+    res_shape[d] = 0;
+    ctx->row = 0;
+    for(int k = 0; k < n; k++) {
+        parents[k] = pico_contiguous(tensors[k]);
+        if(parents[k] == NULL) return NULL;
+        src[k] = (const char*)parents[k]->data;
+        ctx->offsets[k] = ctx->row;
+        ctx->chunks[k] = tensors[k]->shape[d] * inner;
+        ctx->row += ctx->chunks[k];
+        res_shape[d] += tensors[k]->shape[d];
+    }
+
+    struct PicoTensor* out = pico_create_tensor_dtype(arena, res_shape, ndim, first->dtype);
+    out->backend = first->backend;
+
+    if(out->backend == CPU) {
+        struct PicoCatJob job = {.src = src,
+                                 .dst = (char*)out->data,
+                                 .offsets = ctx->offsets,
+                                 .chunks = ctx->chunks,
+                                 .row = ctx->row,
+                                 .n = n,
+                                 .elem = pico_dtype_size(out->dtype)};
+        pico_cat_cpu(&job, out->numel);
+    }
+
+    out->parents = parents;
+    out->num_parents = (uint8_t)n;
+    out->_ctx = ctx;
+    out->_backward = pico_cat_backward;
+    return out;
+}
 
-    int64_t outer_count = 1;
-    for(int i = 0; i < dim; i++) {
-        outer_count *= a->shape[i];
-    }
+struct PicoTensor* pico_cat(struct PicoTensor* a, struct PicoTensor* b, int dim) {
+    struct PicoTensor* tensors[2] = {a, b};
+    return pico_cat_n(tensors, 2, dim);
+}
 
-    int64_t inner_size = 1;
-    for(int i = dim + 1; i < a->ndim; i++) {
-        inner_size *= a->shape[i];
+struct PicoTensor* pico_stack(struct PicoTensor** tensors, int n, int dim) {
+    if(n < 1 || n > PICO_CAT_MAX_TENSORS) {
+        fprintf(stderr, "[Pico] Error: In stack - 1 to %d tensors, got %d!\n",
+                PICO_CAT_MAX_TENSORS, n);
+        return NULL;
     }
-
-    int64_t a_copy_size = a->shape[dim] * inner_size;
-    int64_t b_copy_size = b->shape[dim] * inner_size;
-
-    for(int64_t o = 0; o < outer_count; o++) {
-        // 1. Copy chunk from tensor A
-        memcpy(dst, src_a, a_copy_size * sizeof(float));
-        dst += a_copy_size;
-        src_a += a_copy_size;
-
-        // 2. Copy chunk from tensor B right next to it
-        memcpy(dst, src_b, b_copy_size * sizeof(float));
-        dst += b_copy_size;
-        src_b += b_copy_size;
+    int ndim = tensors[0]->ndim;
+    int d = dim < 0 ? dim + ndim + 1 : dim;
+    if(d < 0 || d > ndim || ndim + 1 > PICO_VIEW_MAX_DIMS) {
+        fprintf(stderr, "[Pico] Error: In stack - bad dim %d for %d dims!\n", dim, ndim);
+        return NULL;
     }
 
-    return out;
+    // each input as a view with a size-1 dim at d, joined along it. the views are free
+    // and their grads are windows of the inputs', so the backward lands straight in them
+    struct PicoTensor* views[PICO_CAT_MAX_TENSORS];
+    for(int k = 0; k < n; k++) {
+        struct PicoTensor* t = tensors[k];
+        if(t->ndim != ndim) {
+            fprintf(stderr, "[Pico] Error: In stack - tensor %d has %d dims, not %d!\n", k,
+                    t->ndim, ndim);
+            return NULL;
+        }
+        for(int i = 0; i < ndim; i++) {
+            if(t->shape[i] != tensors[0]->shape[i]) {
+                fprintf(stderr, "[Pico] Error: In stack - tensor %d differs in dim %d!\n", k,
+                        i);
+                return NULL;
+            }
+        }
+        int64_t shape[PICO_VIEW_MAX_DIMS];
+        memcpy(shape, t->shape, sizeof(int64_t) * d);
+        shape[d] = 1;
+        memcpy(shape + d + 1, t->shape + d, sizeof(int64_t) * (ndim - d));
+        views[k] = pico_reshape(t, shape, ndim + 1);
+        if(views[k] == NULL) return NULL;
+    }
+    return pico_cat_n(views, n, d);
 }
 
-struct PicoTensor* pico_randn(struct Arena* arena, int64_t* shape, uint8_t ndim) {
-    int64_t* res_shape = arena_alloc(arena, sizeof(int64_t) * ndim);
-    memcpy(res_shape, shape, sizeof(int64_t) * ndim);
-    res_shape[ndim - 1] = res_shape[ndim - 1] / 2;
-
-    struct PicoTensor* u1 = pico_rand(arena, res_shape, ndim);
-    struct PicoTensor* u2 = pico_rand(arena, res_shape, ndim);
-
-    struct PicoTensor* mag =
-        pico_tensor_sqrt(pico_mul(pico_tensor_from_scalar(-2.0), pico_tensor_log(u1)));
-    struct PicoTensor* angle =
-        pico_mul(pico_tensor_from_scalar(2.0), pico_mul(pico_tensor_from_scalar(PI_F), u2));
-
-    struct PicoTensor* z0 = pico_mul(mag, pico_tensor_cos(angle));
-    struct PicoTensor* z1 = pico_mul(mag, pico_tensor_sin(angle));
-
-    struct PicoTensor* tensor = pico_cat(z0, z1, 0);
+// ============================= pico_randn
 
+struct PicoTensor* pico_randn(struct Arena* arena, int64_t* shape, uint8_t ndim) {
+    struct PicoTensor* tensor = pico_create_tensor(arena, shape, ndim);
+    pico_rng_normal(&g_pico_rng, tensor->data, tensor->numel, 0.0f, 1.0f);
     return tensor;
 }
 
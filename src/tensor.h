@@ -8,24 +8,62 @@
 #define PI_F 3.14159265358979323846f  // M_PI isn't exposed under -std=c11
 typedef enum { CPU, GPU } PicoBackend;
 
+// storage type of a tensor's data. grads are always fp32, whatever the dtype: they
+// accumulate across consumers and micro-batches, which 8 mantissa bits can't hold.
+// half tensors keep raw 16-bit values in data16 (same pointer as data).
+typedef enum { PICO_F32, PICO_BF16, PICO_F16 } PicoDType;
+
 struct PicoTensor {
     int64_t* shape;
     int64_t* strides;
-    float* data;
+    union {
+        float* data;        // PICO_F32
+        uint16_t* data16;   // PICO_BF16 / PICO_F16
+    };
     float* grad;
     void (*_backward)(struct PicoTensor*);
     struct PicoTensor** parents;
+    void* _ctx;  // op state saved for _backward (arena-allocated), NULL if the op has none
     int64_t numel;
     PicoBackend backend;
+    PicoDType dtype;  // PICO_F32 unless created with a *_dtype constructor or pico_to_dtype
     uint8_t ndim;
     uint8_t num_parents;
     uint8_t is_persistent;  // memory malloc'd ?
+    uint8_t requires_grad;  // 1 by default. set 0 on constants (targets, inputs) so the
+                            // backwards that check it can skip writing their grad
 };
 
 void pico_backward(struct Arena* arena, struct PicoTensor* entry);
 
+// a row-sparse grad for a [rows, dim] param whose dense grad would be mostly zeros (an
+// embedding table, nn/embedding.h): the rows written since the last clear, ascending
+// and unique, each with its summed grad. such a param has grad == NULL; optimizers take
+// the pair through pico_optim_add_sparse and step only the listed rows.
+struct PicoSparseGrad {
+    int64_t* rows;   // [n]
+    float* values;   // [n, dim]
+    int64_t n;
+    int64_t dim;
+};
+
+// back to no rows (frees the lists)
+void pico_sparse_grad_clear(struct PicoSparseGrad* grad);
+
 struct PicoTensor* pico_param(int64_t* shape, uint8_t ndim);
 struct PicoTensor* pico_create_tensor(struct Arena* arena, int64_t* shape, uint8_t ndim);
+struct PicoTensor* pico_param_dtype(int64_t* shape, uint8_t ndim, PicoDType dtype);
+struct PicoTensor* pico_create_tensor_dtype(struct Arena* arena, int64_t* shape, uint8_t ndim,
+                                            PicoDType dtype);
+
+// x stored as `dtype` (round to nearest even on the way down). an op: the grad passes
+// straight through to x. x itself when it already has that dtype.
+struct PicoTensor* pico_to_dtype(struct PicoTensor* x, PicoDType dtype);
+
+// x as fp32 for ops without a half-precision path: x itself, or pico_to_dtype(x, PICO_F32)
+static inline struct PicoTensor* pico_as_f32(struct PicoTensor* x) {
+    return x == NULL || x->dtype == PICO_F32 ? x : pico_to_dtype(x, PICO_F32);
+}
 
 // a 1-element tensor (shape {1}) holding a single scalar. broadcasts against any
 // shape, so you can do pico_mul(pico_tensor_from_scalar(2.0f), t). uses the current
@@ -38,26 +76,125 @@ void pico_free(struct PicoTensor* tensor);
 void pico_tensor_print(struct PicoTensor* t);
 
 // ====================================== important ops
-// TODO: siji don't forget about these guys
+// views (reshape, slice, permute, expand, contiguous, ...) live in view/view.h
 
-void pico_transpose(struct PicoTensor* tensor);
+// swaps the dims of a 2-d tensor in place (its shape and strides, not its data)
 void pico_transpose_2d(struct PicoTensor* tensor);
 
-void pico_transpose_reshape(struct PicoTensor* tensor, int64_t* shape, int ndim);
-
-struct PicoTensor* pico_transpose_clone(struct PicoTensor* tensor);
-
+// the n tensors joined along dim (negative counts from the end): all the same backend,
+// dtype and shape except along dim. inputs of any layout; the grad flows back to each.
+// n is at most PICO_CAT_MAX_TENSORS (a tensor holds up to 255 parents)
+#define PICO_CAT_MAX_TENSORS 255
+struct PicoTensor* pico_cat_n(struct PicoTensor** tensors, int n, int dim);
 struct PicoTensor* pico_cat(struct PicoTensor* a, struct PicoTensor* b, int dim);
 
-// returns a tensor filled with random numbers from a uniform distribution on the interval ([0,1])
+// the n tensors (all the same shape) joined along a new dim at `dim`, in [-ndim-1, ndim]
+struct PicoTensor* pico_stack(struct PicoTensor** tensors, int n, int dim);
+
+// a tensor of uniform [0, 1) values from g_pico_rng (rng/rng.h)
 struct PicoTensor* pico_rand(struct Arena* arena, int64_t* shape, uint8_t ndim);
 
-// returns a tensor filled with random numbers drawn from a standard normal distribution (Gaussian
-// distribution) with a mean of 0 and a variance (and standard deviation) of 1
+// a tensor of standard normal (mean 0, std 1) values from g_pico_rng, in exactly the
+// requested shape
 struct PicoTensor* pico_randn(struct Arena* arena, int64_t* shape, uint8_t ndim);
 
 // ============================= helpers
 
+static inline size_t pico_dtype_size(PicoDType dtype) {
+    return dtype == PICO_F32 ? sizeof(float) : sizeof(uint16_t);
+}
+
+// scalar half <-> fp32, round to nearest even. NaN stays NaN (quieted), overflow goes
+// to inf, fp16 keeps its subnormals. the SIMD converters in kernels/ (F16C for fp16)
+// match these bit for bit, NaN payloads included.
+static inline float pico_bf16_to_f32(uint16_t h) {
+    uint32_t u = (uint32_t)h << 16;
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+static inline uint16_t pico_f32_to_bf16(float f) {
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    if((u & 0x7fffffffu) > 0x7f800000u) return (uint16_t)((u >> 16) | 0x40);
+    u += 0x7fffu + ((u >> 16) & 1u);
+    return (uint16_t)(u >> 16);
+}
+
+static inline float pico_f16_to_f32(uint16_t h) {
+    uint32_t u = (uint32_t)(h & 0x7fff) << 13;
+    uint32_t exp = u & 0x0f800000u;
+    u += (127 - 15) << 23;
+    if(exp == 0x0f800000u) {
+        u += (128 - 16) << 23;  // inf / NaN
+        if(h & 0x3ff) u |= 0x400000u;  // quiet the NaN, as F16C does
+    } else if(exp == 0) {
+        // subnormal: renormalise through the FPU
+        float f, magic;
+        uint32_t m = 113u << 23;
+        u += 1u << 23;
+        memcpy(&f, &u, sizeof(f));
+        memcpy(&magic, &m, sizeof(magic));
+        f -= magic;
+        memcpy(&u, &f, sizeof(u));
+    }
+    u |= (uint32_t)(h & 0x8000) << 16;
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+static inline uint16_t pico_f32_to_f16(float f) {
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    uint32_t sign = u & 0x80000000u;
+    u ^= sign;
+    uint16_t h;
+    if(u >= 0x47800000u) {
+        // NaN stays NaN (quieted, top of the payload kept, as F16C does), too big -> inf
+        h = u > 0x7f800000u ? (uint16_t)(0x7e00 | ((u >> 13) & 0x3ff)) : 0x7c00;
+    } else if(u < 0x38800000u) {
+        // fp16 subnormal or zero: adding 0.5 lines the 10 mantissa bits up at the
+        // bottom of the float, and the FPU's own rounding is the round to nearest even
+        float v, magic = 0.5f;
+        memcpy(&v, &u, sizeof(v));
+        v += magic;
+        memcpy(&u, &v, sizeof(u));
+        h = (uint16_t)(u - 0x3f000000u);
+    } else {
+        uint32_t odd = (u >> 13) & 1u;
+        u += ((uint32_t)(15 - 127) << 23) + 0xfffu + odd;
+        h = (uint16_t)(u >> 13);
+    }
+    return h | (uint16_t)(sign >> 16);
+}
+
+// element i of t's storage as fp32, whatever its dtype
+static inline float pico_tensor_get(const struct PicoTensor* t, int64_t i) {
+    switch(t->dtype) {
+        case PICO_BF16:
+            return pico_bf16_to_f32(t->data16[i]);
+        case PICO_F16:
+            return pico_f16_to_f32(t->data16[i]);
+        default:
+            return t->data[i];
+    }
+}
+
+static inline void pico_tensor_set(struct PicoTensor* t, int64_t i, float v) {
+    switch(t->dtype) {
+        case PICO_BF16:
+            t->data16[i] = pico_f32_to_bf16(v);
+            break;
+        case PICO_F16:
+            t->data16[i] = pico_f32_to_f16(v);
+            break;
+        default:
+            t->data[i] = v;
+    }
+}
+
 #define MAX(a, b) (((a) > (b)) ? (a) : (b))
 #define MIN(a, b) (((a) < (b)) ? (a) : (b))
 
@@ -0,0 +1,46 @@
+/*
+ * backward for pico_contiguous. the views themselves need none: their grad is a window
+ * of their base's (see view.h). for the chain-rule basics check out ../autograd.h
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "kernels/cpu_kernels.h"
+#include "tensor.h"
+#include "view/view.h"
+
+// t's shape / strides with size-1 dims dropped and neighbours merged where
+// strides[d] == strides[d + 1] * shape[d + 1]: the fewest dims that walk the same
+// elements. returns the dim count, at least 1
+static inline int pico_view_coalesce(const struct PicoTensor* t, int64_t* shape,
+                                     int64_t* strides) {
+    int n = 0;
+    for(int d = 0; d < t->ndim; d++) {
+        if(t->shape[d] == 1) continue;
+        if(n > 0 && strides[n - 1] == t->strides[d] * t->shape[d]) {
+            shape[n - 1] *= t->shape[d];
+            strides[n - 1] = t->strides[d];
+            continue;
+        }
+        shape[n] = t->shape[d];
+        strides[n] = t->strides[d];
+        n++;
+    }
+    if(n == 0) {
+        shape[0] = 1;
+        strides[0] = 1;
+        n = 1;
+    }
+    return n;
+}
+
+// dx (through x's strides) += dy (contiguous)
+static inline void pico_contiguous_backward(struct PicoTensor* self) {
+    struct PicoTensor* x = self->parents[0];
+    if(x->grad == NULL) return;
+    int64_t shape[PICO_VIEW_MAX_DIMS], strides[PICO_VIEW_MAX_DIMS];
+    int n = pico_view_coalesce(x, shape, strides);
+    pico_strided_scatter_add_cpu(self->grad, x->grad, shape, strides, n);
+}
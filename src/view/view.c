@@ -0,0 +1,255 @@
+#include "view.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "arena.h"
+#include "kernels/cpu_kernels.h"
+#include "tensor.h"
+#include "view/autograd.h"
+
+bool pico_is_contiguous(const struct PicoTensor* t) {
+    int64_t expected = 1;
+    for(int d = t->ndim - 1; d >= 0; d--) {
+        if(t->shape[d] == 1) continue;
+        if(t->strides[d] != expected) return false;
+        expected *= t->shape[d];
+    }
+    return true;
+}
+
+// dim counted from the end when negative; -1 when out of range
+static int pico_view_dim(const struct PicoTensor* x, int dim) {
+    int d = dim < 0 ? dim + x->ndim : dim;
+    return d < 0 || d >= x->ndim ? -1 : d;
+}
+
+// the view header: x's data and grad moved `offset` elements on, under shape / strides.
+// x is its parent so the graph still reaches whatever x came from
+static struct PicoTensor* pico_view_make(struct PicoTensor* x, const int64_t* shape,
+                                         const int64_t* strides, int ndim, int64_t offset) {
+    struct Arena* arena = arena_ctx_current();
+    if(arena == NULL) {
+        fprintf(stderr, "[Pico] Error: No current arena in context!\n");
+        return NULL;
+    }
+    if(ndim < 1 || ndim > PICO_VIEW_MAX_DIMS) {
+        fprintf(stderr, "[Pico] Error: In view - views support 1 to %d dims!\n",
+                PICO_VIEW_MAX_DIMS);
+        return NULL;
+    }
+
+    struct PicoTensor* v = arena_alloc(arena, sizeof(struct PicoTensor));
+    memset(v, 0, sizeof(*v));
+    v->shape = arena_alloc(arena, sizeof(int64_t) * ndim);
+    v->strides = arena_alloc(arena, sizeof(int64_t) * ndim);
+    memcpy(v->shape, shape, sizeof(int64_t) * ndim);
+    memcpy(v->strides, strides, sizeof(int64_t) * ndim);
+    v->ndim = (uint8_t)ndim;
+    v->numel = 1;
+    for(int d = 0; d < ndim; d++) v->numel *= shape[d];
+
+    v->data = (float*)((char*)x->data + offset * (int64_t)pico_dtype_size(x->dtype));
+    v->grad = x->grad != NULL ? x->grad + offset : NULL;
+    v->backend = x->backend;
+    v->dtype = x->dtype;
+    v->requires_grad = x->requires_grad;
+
+    v->parents = arena_alloc(arena, sizeof(struct PicoTensor*));
+    v->parents[0] = x;
+    v->num_parents = 1;
+    return v;
+}
+
+// a fresh contiguous tensor holding x's elements, whatever x's layout
+static struct PicoTensor* pico_contiguous_copy(struct PicoTensor* x) {
+    struct Arena* arena = arena_ctx_current();
+    if(arena == NULL) {
+        fprintf(stderr, "[Pico] Error: No current arena in context!\n");
+        return NULL;
+    }
+
+    struct PicoTensor* out = pico_create_tensor_dtype(arena, x->shape, x->ndim, x->dtype);
+    out->backend = x->backend;
+    out->requires_grad = x->requires_grad;
+
+    if(x->backend == CPU) {
+        int64_t shape[PICO_VIEW_MAX_DIMS], strides[PICO_VIEW_MAX_DIMS];
+        int n = pico_view_coalesce(x, shape, strides);
+        pico_strided_gather_cpu(x->data, out->data, shape, strides, n,
+                                pico_dtype_size(x->dtype));
+    }
+
+    out->parents = arena_alloc(arena, sizeof(struct PicoTensor*));
+    out->parents[0] = x;
+    out->num_parents = 1;
+    out->_backward = pico_contiguous_backward;
+
+    return out;
+}
+
+struct PicoTensor* pico_contiguous(struct PicoTensor* x) {
+    if(x == NULL || pico_is_contiguous(x)) return x;
+    return pico_contiguous_copy(x);
+}
+
+// strides that walk x's elements in row-major order under new_shape, if x's layout
+// allows it: each run of x dims that is contiguous in memory may be split or merged
+// freely, but never across two runs. false when a copy is needed
+static bool pico_reshape_strides(const struct PicoTensor* x, const int64_t* new_shape,
+                                 int new_ndim, int64_t* new_strides) {
+    int view_d = new_ndim - 1;
+    int64_t chunk_stride = x->strides[x->ndim - 1];
+    int64_t tensor_numel = 1;
+    int64_t view_numel = 1;
+    for(int d = x->ndim - 1; d >= 0; d--) {
+        tensor_numel *= x->shape[d];
+        // the end of a contiguous run: the dim before doesn't continue it
+        if(d == 0 || (x->shape[d - 1] != 1 && x->strides[d - 1] != tensor_numel * chunk_stride)) {
+            while(view_d >= 0 && (view_numel < tensor_numel || new_shape[view_d] == 1)) {
+                new_strides[view_d] = view_numel * chunk_stride;
+                view_numel *= new_shape[view_d];
+                view_d--;
+            }
+            if(view_numel != tensor_numel) return false;
+            if(d > 0) {
+                chunk_stride = x->strides[d - 1];
+                tensor_numel = 1;
+                view_numel = 1;
+            }
+        }
+    }
+    return view_d == -1;
+}
+
+struct PicoTensor* pico_reshape(struct PicoTensor* x, const int64_t* shape, int ndim) {
+    if(ndim < 1 || ndim > PICO_VIEW_MAX_DIMS) {
+        fprintf(stderr, "[Pico] Error: In reshape - 1 to %d dims!\n", PICO_VIEW_MAX_DIMS);
+        return NULL;
+    }
+
+    int64_t new_shape[PICO_VIEW_MAX_DIMS];
+    int64_t known = 1;
+    int infer = -1;
+    for(int d = 0; d < ndim; d++) {
+        new_shape[d] = shape[d];
+        if(shape[d] == -1 && infer < 0) {
+            infer = d;
+        } else if(shape[d] < 1) {
+            fprintf(stderr, "[Pico] Error: In reshape - bad size %lld!\n", (long long)shape[d]);
+            return NULL;
+        } else {
+            known *= shape[d];
+        }
+    }
+    if(infer >= 0) new_shape[infer] = x->numel / known;
+    if(known * (infer >= 0 ? new_shape[infer] : 1) != x->numel) {
+        fprintf(stderr, "[Pico] Error: In reshape - %lld elements don't fit the new shape!\n",
+                (long long)x->numel);
+        return NULL;
+    }
+
+    int64_t new_strides[PICO_VIEW_MAX_DIMS];
+    if(!pico_reshape_strides(x, new_shape, ndim, new_strides)) {
+        x = pico_contiguous(x);
+        if(x == NULL) return NULL;
+        pico_compute_strides(new_shape, ndim, new_strides);
+    }
+    return pico_view_make(x, new_shape, new_strides, ndim, 0);
+}
+
+struct PicoTensor* pico_slice(struct PicoTensor* x, int dim, int64_t start, int64_t end,
+                              int64_t step) {
+    int d = pico_view_dim(x, dim);
+    if(d < 0 || step < 1) {
+        fprintf(stderr, "[Pico] Error: In slice - bad dim %d or step %lld!\n", dim,
+                (long long)step);
+        return NULL;
+    }
+    int64_t size = x->shape[d];
+    if(start < 0) start += size;
+    if(end < 0) end += size;
+    start = MAX(0, MIN(start, size));
+    end = MAX(0, MIN(end, size));
+    if(start >= end) {
+        fprintf(stderr, "[Pico] Error: In slice - the slice is empty!\n");
+        return NULL;
+    }
+
+    int64_t shape[PICO_VIEW_MAX_DIMS], strides[PICO_VIEW_MAX_DIMS];
+    memcpy(shape, x->shape, sizeof(int64_t) * x->ndim);
+    memcpy(strides, x->strides, sizeof(int64_t) * x->ndim);
+    shape[d] = (end - start + step - 1) / step;
+    strides[d] = x->strides[d] * step;
+    return pico_view_make(x, shape, strides, x->ndim, start * x->strides[d]);
+}
+
+struct PicoTensor* pico_narrow(struct PicoTensor* x, int dim, int64_t start, int64_t length) {
+    int d = pico_view_dim(x, dim);
+    if(d < 0 || start < 0 || length < 1 || start + length > x->shape[d]) {
+        fprintf(stderr, "[Pico] Error: In narrow - out of range!\n");
+        return NULL;
+    }
+    return pico_slice(x, d, start, start + length, 1);
+}
+
+struct PicoTensor* pico_permute(struct PicoTensor* x, const int* dims) {
+    int64_t shape[PICO_VIEW_MAX_DIMS], strides[PICO_VIEW_MAX_DIMS];
+    uint32_t seen = 0;
+    for(int i = 0; i < x->ndim; i++) {
+        int d = pico_view_dim(x, dims[i]);
+        if(d < 0 || (seen >> d) & 1u) {
+            fprintf(stderr, "[Pico] Error: In permute - dims must be a permutation!\n");
+            return NULL;
+        }
+        seen |= 1u << d;
+        shape[i] = x->shape[d];
+        strides[i] = x->strides[d];
+    }
+    return pico_view_make(x, shape, strides, x->ndim, 0);
+}
+
+struct PicoTensor* pico_transpose(struct PicoTensor* x, int dim0, int dim1) {
+    int d0 = pico_view_dim(x, dim0);
+    int d1 = pico_view_dim(x, dim1);
+    if(d0 < 0 || d1 < 0) {
+        fprintf(stderr, "[Pico] Error: In transpose - bad dims %d, %d!\n", dim0, dim1);
+        return NULL;
+    }
+    int dims[PICO_VIEW_MAX_DIMS];
+    for(int i = 0; i < x->ndim; i++) dims[i] = i;
+    dims[d0] = d1;
+    dims[d1] = d0;
+    return pico_permute(x, dims);
+}
+
+struct PicoTensor* pico_expand(struct PicoTensor* x, const int64_t* shape, int ndim) {
+    if(ndim < x->ndim || ndim > PICO_VIEW_MAX_DIMS) {
+        fprintf(stderr, "[Pico] Error: In expand - can't expand to fewer dims!\n");
+        return NULL;
+    }
+    int64_t new_shape[PICO_VIEW_MAX_DIMS], strides[PICO_VIEW_MAX_DIMS];
+    int diff = ndim - x->ndim;
+    for(int d = 0; d < ndim; d++) {
+        int sd = d - diff;  // matching dim of x, < 0 for a new leading one
+        int64_t size = shape[d] == -1 && sd >= 0 ? x->shape[sd] : shape[d];
+        if(size < 1 || (sd >= 0 && x->shape[sd] != 1 && x->shape[sd] != size)) {
+            fprintf(stderr, "[Pico] Error: In expand - dim %d can't become %lld!\n", d,
+                    (long long)shape[d]);
+            return NULL;
+        }
+        new_shape[d] = size;
+        strides[d] = sd >= 0 && x->shape[sd] == size ? x->strides[sd] : 0;
+    }
+    return pico_view_make(x, new_shape, strides, ndim, 0);
+}
+
+struct PicoTensor* pico_transpose_clone(struct PicoTensor* x) {
+    if(x->ndim < 2) {
+        fprintf(stderr, "[Pico] Error: In transpose_clone - needs 2 or more dims!\n");
+        return NULL;
+    }
+    struct PicoTensor* t = pico_transpose(x, -2, -1);
+    return t == NULL ? NULL : pico_contiguous_copy(t);
+}
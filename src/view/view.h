@@ -0,0 +1,57 @@
+/*
+ * views: tensors that share another tensor's memory.
+ *
+ * reshape / slice / narrow / permute / transpose / expand make a new header (shape,
+ * strides, data pointer moved to the first element) over the same data: no copy, the
+ * cost doesn't depend on the size. an expanded dim has stride 0, so every position
+ * along it reads the same element.
+ *
+ * autograd: a view's grad is the matching window of its base's grad, laid out with the
+ * same strides, so whatever a consumer accumulates into the view's grad already sits in
+ * the base's. the base is the view's parent (it runs its backward after the view's
+ * consumers) and the view itself has no _backward.
+ *
+ * most ops read their inputs as dense row-major buffers, so they call pico_contiguous
+ * on them first: a no-op for a tensor that already is, one strided gather for a view
+ * that isn't (a transpose, a column slice, an expand). views live in the current
+ * arena; pico_free on one is a no-op.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "tensor.h"
+
+#define PICO_VIEW_MAX_DIMS 16
+
+// row-major with no gaps (strides of size-1 dims don't matter)
+bool pico_is_contiguous(const struct PicoTensor* t);
+
+// x itself when contiguous, otherwise a contiguous copy. backward scatters the grad
+// back through x's strides (summing over expanded dims)
+struct PicoTensor* pico_contiguous(struct PicoTensor* x);
+
+// the same elements in row-major order under a new shape. one dim may be -1 (inferred).
+// a view whenever x's strides allow it (always for a contiguous x), a copy otherwise
+struct PicoTensor* pico_reshape(struct PicoTensor* x, const int64_t* shape, int ndim);
+
+// elements start, start + step, ... before end along dim. dim, start and end may be
+// negative (counted from the end); start / end are clamped to the dim, step >= 1
+struct PicoTensor* pico_slice(struct PicoTensor* x, int dim, int64_t start, int64_t end,
+                              int64_t step);
+
+// length elements of dim from start, which must all be in range
+struct PicoTensor* pico_narrow(struct PicoTensor* x, int dim, int64_t start, int64_t length);
+
+// out dim i is x dim dims[i]; dims is a permutation of x's dims (negatives allowed)
+struct PicoTensor* pico_permute(struct PicoTensor* x, const int* dims);
+struct PicoTensor* pico_transpose(struct PicoTensor* x, int dim0, int dim1);
+
+// x broadcast to shape (ndim >= x's): size-1 and new leading dims are stretched with
+// stride 0, -1 keeps x's size. the backward sums the stretched dims
+struct PicoTensor* pico_expand(struct PicoTensor* x, const int64_t* shape, int ndim);
+
+// a copy of x with its last two dims swapped, always contiguous (a new tensor even when
+// the transposed view already is)
+struct PicoTensor* pico_transpose_clone(struct PicoTensor* x);
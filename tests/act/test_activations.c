@@ -1,13 +1,20 @@
 /*
- * Tests for activation functions (relu so far).
+ * Tests for activation functions (relu, sigmoid, tanh, softmax).
  * NOTE: no UTEST_MAIN here, test_basic.c owns main + UTEST_STATE.
  * relu is the first UNARY op (one parent) — these also check that wiring.
+ * The act_simd tests force g_simd_level like tests/kernels/test_avx2.c and restore
+ * it before asserting.
  */
+#include <math.h>
+
 #include "act/activations.h"
 #include "arena.h"
+#include "global.h"
 #include "tensor.h"
 #include "utest.h"
 
+#define ACT_NEAR(a, b) (fabsf((a) - (b)) < 1e-6f)
+
 // relu(x) = max(0, x), element-wise: negatives + zero -> 0, positives pass
 UTEST(act_relu, forward_clamps_negatives) {
     struct Arena* ar = arena_init(4096);
@@ -163,3 +170,297 @@ UTEST(act_relu, through_pico_backward) {
     arena_ctx_pop();
     arena_destroy(ar);
 }
+
+// sigmoid(0) = 0.5, sigmoid(-x) = 1 - sigmoid(x); reads x, not the fresh output
+UTEST(act_sigmoid, forward_values) {
+    struct Arena* ar = arena_init(4096);
+    arena_ctx_push(ar);
+
+    int64_t s[] = {3};
+    struct PicoTensor* x = pico_param(s, 1);
+    x->data[0] = 0.0f;
+    x->data[1] = 2.0f;
+    x->data[2] = -2.0f;
+
+    struct PicoTensor* out = pico_sigmoid(x);
+    float y0 = out->data[0], y1 = out->data[1], y2 = out->data[2];
+
+    pico_free(x);
+    arena_ctx_pop();
+    arena_destroy(ar);
+
+    ASSERT_TRUE(ACT_NEAR(y0, 0.5f));
+    ASSERT_TRUE(ACT_NEAR(y1, 1.0f / (1.0f + expf(-2.0f))));
+    ASSERT_TRUE(ACT_NEAR(y1 + y2, 1.0f));
+}
+
+// sigmoid' = y(1 - y) from the saved output: 0.25 at x=0, scaled by upstream 4
+UTEST(act_sigmoid, backward_from_output) {
+    struct Arena* ar = arena_init(4096);
+    arena_ctx_push(ar);
+
+    int64_t s[] = {1};
+    struct PicoTensor* x = pico_param(s, 1);
+    struct PicoTensor* out = pico_sigmoid(x);
+    out->grad[0] = 4.0f;
+    out->_backward(out);
+    float gx = x->grad[0];
+
+    pico_free(x);
+    arena_ctx_pop();
+    arena_destroy(ar);
+
+    ASSERT_TRUE(ACT_NEAR(gx, 1.0f));
+}
+
+// tanh' = 1 - y^2, with an upstream grad != 1 so a precedence slip (g*1 - y^2) shows
+UTEST(act_tanh, backward_scales_upstream) {
+    struct Arena* ar = arena_init(4096);
+    arena_ctx_push(ar);
+
+    int64_t s[] = {1};
+    struct PicoTensor* x = pico_param(s, 1);
+    x->data[0] = 0.5f;
+    struct PicoTensor* out = pico_tanh(x);
+    float y = out->data[0];
+    out->grad[0] = 3.0f;
+    out->_backward(out);
+    float gx = x->grad[0];
+
+    pico_free(x);
+    arena_ctx_pop();
+    arena_destroy(ar);
+
+    ASSERT_TRUE(ACT_NEAR(y, tanhf(0.5f)));
+    ASSERT_TRUE(ACT_NEAR(gx, 3.0f * (1.0f - tanhf(0.5f) * tanhf(0.5f))));
+}
+
+typedef struct PicoTensor* (*act_fn)(struct PicoTensor*);
+
+// forward + backward of `act` at `level`, max abs diff vs the scalar path. n is odd
+// so the masked tail runs; big n also crosses the threading threshold once
+// pico_init() has made the pool.
+static float act_simd_max_diff(SimdLevel level, act_fn act, int64_t n) {
+    struct Arena* ar = arena_init((size_t)n * sizeof(float) * 6 + (1 << 16));
+    arena_ctx_push(ar);
+
+    int64_t s[] = {n};
+    struct PicoTensor* x = pico_param(s, 1);
+    for(int64_t i = 0; i < n; i++) {
+        x->data[i] = (float)((i * 37) % 201 - 100) * 0.05f;
+    }
+
+    SimdLevel saved = g_simd_level;  // before pico_init(), which sets its own level
+    pico_init();
+    g_simd_level = SIMD_NONE;
+    struct PicoTensor* ref = act(x);
+    for(int64_t i = 0; i < n; i++) ref->grad[i] = (float)(i % 5) - 2.0f;
+    ref->_backward(ref);
+    g_simd_level = level;
+    struct PicoTensor* out = act(x);
+    for(int64_t i = 0; i < n; i++) out->grad[i] = -((float)(i % 5) - 2.0f);
+    out->_backward(out);  // x->grad: ref contribution + (-same) -> ~0
+    g_simd_level = saved;
+
+    float worst = 0.0f;
+    for(int64_t i = 0; i < n; i++) {
+        worst = fmaxf(worst, fabsf(out->data[i] - ref->data[i]));
+        worst = fmaxf(worst, fabsf(x->grad[i]));
+    }
+
+    pico_free(x);
+    arena_ctx_pop();
+    arena_destroy(ar);
+    return worst;
+}
+
+UTEST(act_simd, avx2_matches_scalar) {
+    if(!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("fma")) return;
+    float d_relu = act_simd_max_diff(SIMD_AVX2, pico_relu, 1001);
+    float d_sig = act_simd_max_diff(SIMD_AVX2, pico_sigmoid, 1001);
+    float d_tanh = act_simd_max_diff(SIMD_AVX2, pico_tanh, 1001);
+    ASSERT_TRUE(d_relu == 0.0f);
+    ASSERT_TRUE(d_sig < 1e-6f);
+    ASSERT_TRUE(d_tanh < 1e-6f);
+}
+
+UTEST(act_simd, avx512_matches_scalar) {
+    if(!__builtin_cpu_supports("avx512f")) return;
+    float d_relu = act_simd_max_diff(SIMD_AVX512, pico_relu, 1001);
+    float d_sig = act_simd_max_diff(SIMD_AVX512, pico_sigmoid, 1001);
+    float d_tanh = act_simd_max_diff(SIMD_AVX512, pico_tanh, 1001);
+    ASSERT_TRUE(d_relu == 0.0f);
+    ASSERT_TRUE(d_sig < 1e-6f);
+    ASSERT_TRUE(d_tanh < 1e-6f);
+}
+
+// > 2 x PICO_ACT_THREAD_MIN_CHUNK: split across the pool, slices must stitch exactly
+UTEST(act_simd, threaded_matches_scalar) {
+    if(!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("fma")) return;
+    float d_relu = act_simd_max_diff(SIMD_AVX2, pico_relu, 3 * (1 << 16) + 7);
+    float d_tanh = act_simd_max_diff(SIMD_AVX2, pico_tanh, 3 * (1 << 16) + 7);
+    ASSERT_TRUE(d_relu == 0.0f);
+    ASSERT_TRUE(d_tanh < 1e-6f);
+}
+
+// reference softmax of one (strided) row in double
+static void act_softmax_ref(const float* x, float* y, int64_t n, int64_t stride) {
+    double m = -INFINITY, s = 0.0;
+    for(int64_t i = 0; i < n; i++) m = fmax(m, x[i * stride]);
+    for(int64_t i = 0; i < n; i++) s += exp(x[i * stride] - m);
+    for(int64_t i = 0; i < n; i++) y[i * stride] = (float)(exp(x[i * stride] - m) / s);
+}
+
+// logits far past expf's overflow point must not blow up (max is subtracted first)
+UTEST(act_softmax, forward_last_axis_is_stable) {
+    struct Arena* ar = arena_init(1 << 14);
+    arena_ctx_push(ar);
+
+    int64_t s[] = {2, 3};
+    struct PicoTensor* x = pico_param(s, 2);
+    float v[] = {1.0f, 2.0f, 3.0f, 1000.0f, 1001.0f, 1002.0f};
+    for(int i = 0; i < 6; i++) x->data[i] = v[i];
+
+    struct PicoTensor* y = pico_softmax(x, -1);
+    float want[6];
+    act_softmax_ref(x->data, want, 3, 1);
+    act_softmax_ref(x->data + 3, want + 3, 3, 1);
+    // lse ~ 1002.4 only has ~6e-5 of float resolution, hence the looser second row
+    for(int i = 0; i < 6; i++) ASSERT_TRUE(fabsf(y->data[i] - want[i]) < (i < 3 ? 1e-6f : 1e-4f));
+
+    pico_free(x);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+// axis 0 of [3, 2]: each column is a strided row
+UTEST(act_softmax, forward_outer_axis) {
+    struct Arena* ar = arena_init(1 << 14);
+    arena_ctx_push(ar);
+
+    int64_t s[] = {3, 2};
+    struct PicoTensor* x = pico_param(s, 2);
+    for(int i = 0; i < 6; i++) x->data[i] = (float)(i * i) * 0.1f;
+
+    struct PicoTensor* y = pico_softmax(x, 0);
+    float want[6];
+    act_softmax_ref(x->data, want, 3, 2);
+    act_softmax_ref(x->data + 1, want + 1, 3, 2);
+    for(int i = 0; i < 6; i++) ASSERT_TRUE(ACT_NEAR(y->data[i], want[i]));
+    ASSERT_TRUE(pico_softmax(x, 2) == NULL);
+
+    pico_free(x);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+// dx = y * (g - dot(g, y)) per row
+UTEST(act_softmax, backward_matches_jacobian) {
+    struct Arena* ar = arena_init(1 << 14);
+    arena_ctx_push(ar);
+
+    int64_t s[] = {2, 4};
+    struct PicoTensor* x = pico_param(s, 2);
+    for(int i = 0; i < 8; i++) x->data[i] = (float)(i % 3) - 0.5f * (float)i;
+
+    struct PicoTensor* y = pico_softmax(x, 1);
+    for(int i = 0; i < 8; i++) y->grad[i] = (float)i;
+    y->_backward(y);
+
+    for(int r = 0; r < 2; r++) {
+        float dot = 0.0f;
+        for(int j = 0; j < 4; j++) dot += y->grad[r * 4 + j] * y->data[r * 4 + j];
+        for(int j = 0; j < 4; j++) {
+            int i = r * 4 + j;
+            ASSERT_TRUE(ACT_NEAR(x->grad[i], y->data[i] * (y->grad[i] - dot)));
+        }
+    }
+
+    pico_free(x);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+// a strided middle axis with enough rows to split across threads: each slice gathers
+// into its own part of the arena scratch, forward and backward
+UTEST(act_softmax, strided_rows_split_across_threads) {
+    pico_init();
+    struct Arena* ar = arena_init(1 << 22);
+    arena_ctx_push(ar);
+
+    int64_t s[] = {4, 64, 300};
+    struct PicoTensor* x = pico_param(s, 3);
+    for(int64_t i = 0; i < x->numel; i++) x->data[i] = (float)((i * 37) % 201 - 100) * 0.03f;
+
+    struct PicoTensor* y = pico_softmax(x, 1);
+    ASSERT_TRUE(y != NULL);
+    for(int64_t i = 0; i < y->numel; i++) y->grad[i] = (float)(i % 7) - 3.0f;
+    y->_backward(y);
+
+    int ok = 1;
+    float row[64], want[64];
+    for(int64_t o = 0; o < 4; o++) {
+        for(int64_t c = 0; c < 300; c++) {
+            int64_t base = o * 64 * 300 + c;
+            for(int64_t r = 0; r < 64; r++) row[r] = x->data[base + r * 300];
+            act_softmax_ref(row, want, 64, 1);
+            double dot = 0.0;
+            for(int64_t r = 0; r < 64; r++) dot += (double)y->grad[base + r * 300] * want[r];
+            for(int64_t r = 0; r < 64; r++) {
+                int64_t i = base + r * 300;
+                ok &= fabsf(y->data[i] - want[r]) < 1e-6f;
+                ok &= fabsf(x->grad[i] - (float)(want[r] * (y->grad[i] - dot))) < 1e-5f;
+            }
+        }
+    }
+    ASSERT_TRUE(ok);
+
+    pico_free(x);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+// forward + backward at `level` vs scalar, last axis and a strided middle axis
+static float act_softmax_simd_max_diff(SimdLevel level) {
+    struct Arena* ar = arena_init(1 << 20);
+    SimdLevel saved = g_simd_level;
+    pico_init();
+    arena_ctx_push(ar);
+
+    int64_t s[] = {3, 101, 5};
+    struct PicoTensor* x = pico_param(s, 3);
+    for(int64_t i = 0; i < x->numel; i++) x->data[i] = (float)((i * 37) % 201 - 100) * 0.07f;
+
+    float worst = 0.0f;
+    int axes[] = {2, 1};
+    for(int k = 0; k < 2; k++) {
+        g_simd_level = SIMD_NONE;
+        struct PicoTensor* ref = pico_softmax(x, axes[k]);
+        for(int64_t i = 0; i < x->numel; i++) ref->grad[i] = (float)(i % 7) - 3.0f;
+        ref->_backward(ref);
+        g_simd_level = level;
+        struct PicoTensor* out = pico_softmax(x, axes[k]);
+        for(int64_t i = 0; i < x->numel; i++) out->grad[i] = -((float)(i % 7) - 3.0f);
+        out->_backward(out);  // x->grad: ref contribution + (-same) -> ~0
+        g_simd_level = saved;
+        for(int64_t i = 0; i < x->numel; i++) {
+            worst = fmaxf(worst, fabsf(out->data[i] - ref->data[i]));
+            worst = fmaxf(worst, fabsf(x->grad[i]));
+        }
+    }
+
+    pico_free(x);
+    arena_ctx_pop();
+    arena_destroy(ar);
+    return worst;
+}
+
+UTEST(act_simd, softmax_avx2_matches_scalar) {
+    if(!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("fma")) return;
+    ASSERT_TRUE(act_softmax_simd_max_diff(SIMD_AVX2) < 1e-5f);
+}
+
+UTEST(act_simd, softmax_avx512_matches_scalar) {
+    if(!__builtin_cpu_supports("avx512f")) return;
+    ASSERT_TRUE(act_softmax_simd_max_diff(SIMD_AVX512) < 1e-5f);
+}
@@ -0,0 +1,223 @@
+/*
+ * Tests for pico_attention (attention/attention.h). The reference builds the whole
+ * lq × lk score matrix in double and takes q / k / v grads from it by definition; the
+ * op, which only ever sees key blocks and one logsumexp per row, must match it when
+ * lk spans several key blocks, when lq spans several query blocks, under a shared
+ * causal mask, and under per-head masks with a query row that sees no key at all.
+ * Also: heads split out by a transpose view, and mismatched shapes refused.
+ * NOTE: no UTEST_MAIN here, test_basic.c owns main + UTEST_STATE.
+ */
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "arena.h"
+#include "attention/attention.h"
+#include "global.h"
+#include "ops.h"
+#include "reduce/reduce.h"
+#include "tensor.h"
+#include "test_common.h"
+#include "utest.h"
+#include "view/view.h"
+
+// y and the grads of sum(y * dy) by definition, one (batch, head) pair. mask may be NULL
+static void attention_reference(const float* q, const float* k, const float* v,
+                                const float* mask, const float* dy, int64_t lq, int64_t lk,
+                                int64_t d, int64_t dv, double* y, double* dq, double* dk,
+                                double* dvv) {
+    double scale = 1.0 / sqrt((double)d);
+    double* p = malloc(sizeof(double) * lk);
+    double* dp = malloc(sizeof(double) * lk);
+    for(int64_t i = 0; i < lq; i++) {
+        double mx = -INFINITY, sum = 0.0;
+        for(int64_t c = 0; c < lk; c++) {
+            double s = 0.0;
+            for(int64_t j = 0; j < d; j++) s += (double)q[i * d + j] * k[c * d + j];
+            p[c] = s * scale + (mask != NULL ? mask[i * lk + c] : 0.0);
+            if(p[c] > mx) mx = p[c];
+        }
+        for(int64_t c = 0; c < lk; c++) {
+            p[c] = mx == -INFINITY ? 0.0 : exp(p[c] - mx);
+            sum += p[c];
+        }
+        double pdp = 0.0;
+        for(int64_t c = 0; c < lk; c++) {
+            p[c] = sum > 0.0 ? p[c] / sum : 0.0;
+            dp[c] = 0.0;
+            for(int64_t j = 0; j < dv; j++) {
+                y[i * dv + j] += p[c] * v[c * dv + j];
+                dvv[c * dv + j] += p[c] * dy[i * dv + j];
+                dp[c] += (double)dy[i * dv + j] * v[c * dv + j];
+            }
+            pdp += p[c] * dp[c];
+        }
+        for(int64_t c = 0; c < lk; c++) {
+            double ds = p[c] * (dp[c] - pdp) * scale;
+            for(int64_t j = 0; j < d; j++) {
+                dq[i * d + j] += ds * k[c * d + j];
+                dk[c * d + j] += ds * q[i * d + j];
+            }
+        }
+    }
+    free(p);
+    free(dp);
+}
+
+// 0 shared causal, 1 per-head: random-ish -inf holes and query row 1 fully masked
+static struct PicoTensor* make_mask(struct Arena* ar, int kind, int64_t bh, int64_t lq,
+                                    int64_t lk) {
+    int64_t ms[] = {bh, lq, lk};
+    struct PicoTensor* mask = kind == 0 ? pico_create_tensor(ar, ms + 1, 2)
+                                        : pico_create_tensor(ar, ms, 3);
+    for(int64_t i = 0; i < mask->numel; i++) {
+        int64_t r = i / lk % lq, c = i % lk;
+        bool drop = kind == 0 ? c > r + (lk - lq) : (r == 1 || (i * 7919) % 5 == 0);
+        mask->data[i] = drop ? -INFINITY : (kind == 0 ? 0.0f : test_wave(i, 0.5f));
+    }
+    mask->requires_grad = 0;
+    return mask;
+}
+
+// the op against the reference at the current SIMD level, on [2, heads, l*, d*]
+static int check_attention(int64_t heads, int64_t lq, int64_t lk, int64_t d, int64_t dv,
+                           int mask_kind) {
+    struct Arena* ar = arena_init(1 << 24);
+    arena_ctx_push(ar);
+    int64_t bh = 2 * heads;
+    int64_t qs[] = {2, heads, lq, d}, ks[] = {2, heads, lk, d}, vs[] = {2, heads, lk, dv};
+    struct PicoTensor* q = pico_param(qs, 4);
+    struct PicoTensor* k = pico_param(ks, 4);
+    struct PicoTensor* v = pico_param(vs, 4);
+    for(int64_t i = 0; i < q->numel; i++) q->data[i] = test_wave(i, 1.5f);
+    for(int64_t i = 0; i < k->numel; i++) k->data[i] = test_wave(i * 3 + 1, 1.5f);
+    for(int64_t i = 0; i < v->numel; i++) v->data[i] = test_wave(i * 5 + 2, 1.0f);
+    struct PicoTensor* mask = mask_kind < 0 ? NULL : make_mask(ar, mask_kind, bh, lq, lk);
+
+    struct PicoTensor* y = pico_attention(q, k, v, mask);
+    struct PicoTensor* dy = pico_create_tensor(ar, y->shape, y->ndim);
+    for(int64_t i = 0; i < dy->numel; i++) dy->data[i] = test_wave(i * 7 + 3, 0.5f);
+    pico_backward(ar, pico_sum(pico_mul(y, dy), NULL, 0, false));
+
+    double* ry = calloc(y->numel, sizeof(double));
+    double* rdq = calloc(q->numel, sizeof(double));
+    double* rdk = calloc(k->numel, sizeof(double));
+    double* rdv = calloc(v->numel, sizeof(double));
+    for(int64_t b = 0; b < bh; b++) {
+        const float* mb = NULL;
+        if(mask != NULL) mb = mask->data + (mask_kind == 0 ? 0 : b * lq * lk);
+        attention_reference(q->data + b * lq * d, k->data + b * lk * d, v->data + b * lk * dv,
+                            mb, dy->data + b * lq * dv, lq, lk, d, dv, ry + b * lq * dv,
+                            rdq + b * lq * d, rdk + b * lk * d, rdv + b * lk * dv);
+    }
+
+    int ok = y->ndim == 4 && y->shape[2] == lq && y->shape[3] == dv;
+    for(int64_t i = 0; i < y->numel; i++) ok &= test_near(y->data[i], ry[i], 1e-4f);
+    for(int64_t i = 0; i < q->numel; i++) ok &= test_near(q->grad[i], rdq[i], 1e-4f);
+    for(int64_t i = 0; i < k->numel; i++) ok &= test_near(k->grad[i], rdk[i], 1e-4f);
+    for(int64_t i = 0; i < v->numel; i++) ok &= test_near(v->grad[i], rdv[i], 1e-4f);
+
+    free(ry);
+    free(rdq);
+    free(rdk);
+    free(rdv);
+    pico_free(q);
+    pico_free(k);
+    pico_free(v);
+    arena_ctx_pop();
+    arena_destroy(ar);
+    return ok;
+}
+
+UTEST(attention, matches_reference) {
+    pico_init();
+    // {heads, lq, lk, d, dv}: one key, vector tails, two query blocks against two key
+    // blocks (a 64 + 64 tile holds 64 keys), and 4 pairs of 40 × 300 to split across
+    // threads
+    int64_t shapes[][5] = {{1, 3, 1, 4, 4}, {1, 5, 37, 13, 7}, {2, 70, 100, 64, 64},
+                           {2, 40, 300, 12, 36}};
+    bool avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    SimdLevel saved = g_simd_level;
+    for(int level = 0; level < (avx2 ? 2 : 1); level++) {
+        for(size_t i = 0; i < sizeof(shapes) / sizeof(shapes[0]); i++) {
+            for(int mask_kind = -1; mask_kind < 2; mask_kind++) {
+                if(mask_kind == 1 && shapes[i][1] < 2) continue;
+                int64_t* s = shapes[i];
+                g_simd_level = level == 0 ? SIMD_NONE : SIMD_AVX2;
+                int ok = check_attention(s[0], s[1], s[2], s[3], s[4], mask_kind);
+                g_simd_level = saved;
+                ASSERT_TRUE(ok);
+            }
+        }
+    }
+}
+
+// heads split out of [l, heads, d] by a transpose view, the usual layout after a
+// projection: the op makes them contiguous, and the grad lands back in the source
+UTEST(attention, transposed_heads) {
+    struct Arena* ar = arena_init(1 << 20);
+    arena_ctx_push(ar);
+    int64_t xs[] = {6, 2, 8};
+    struct PicoTensor* x = pico_param(xs, 3);
+    for(int64_t i = 0; i < x->numel; i++) x->data[i] = test_wave(i, 1.0f);
+    struct PicoTensor* h = pico_transpose(x, 0, 1);  // [2, 6, 8]
+    struct PicoTensor* hc = pico_contiguous(h);
+
+    struct PicoTensor* y = pico_attention(h, h, h, NULL);
+    ASSERT_TRUE(y != NULL);
+    double ry[2 * 6 * 8] = {0}, g[3][2 * 6 * 8] = {{0}};
+    float ones[2 * 6 * 8];
+    for(int i = 0; i < 2 * 6 * 8; i++) ones[i] = 1.0f;
+    for(int64_t b = 0; b < 2; b++) {
+        const float* hb = hc->data + b * 48;
+        attention_reference(hb, hb, hb, NULL, ones, 6, 6, 8, 8, ry + b * 48, g[0] + b * 48,
+                            g[1] + b * 48, g[2] + b * 48);
+    }
+    for(int64_t i = 0; i < y->numel; i++) ASSERT_TRUE(test_near(y->data[i], ry[i], 1e-4f));
+
+    pico_backward(ar, pico_sum(y, NULL, 0, false));
+    // x[l, head, j] is h[head, l, j]; its grad sums the q, k and v grads
+    int ok = 1;
+    for(int64_t l = 0; l < 6; l++) {
+        for(int64_t hd = 0; hd < 2; hd++) {
+            for(int64_t j = 0; j < 8; j++) {
+                int64_t hi = hd * 48 + l * 8 + j;
+                double want = g[0][hi] + g[1][hi] + g[2][hi];
+                ok &= test_near(x->grad[l * 16 + hd * 8 + j], want, 1e-4f);
+            }
+        }
+    }
+    ASSERT_TRUE(ok);
+
+    pico_free(x);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+UTEST(attention, shapes_and_refusals) {
+    struct Arena* ar = arena_init(1 << 16);
+    arena_ctx_push(ar);
+    int64_t qs[] = {2, 3, 4}, ks[] = {2, 5, 4}, vs[] = {2, 5, 6};
+    int64_t bad_d[] = {2, 5, 3}, bad_b[] = {1, 5, 4}, bad_m[] = {3, 4};
+    struct PicoTensor* q = pico_create_tensor(ar, qs, 3);
+    struct PicoTensor* k = pico_create_tensor(ar, ks, 3);
+    struct PicoTensor* v = pico_create_tensor(ar, vs, 3);
+    for(int64_t i = 0; i < v->numel; i++) v->data[i] = (float)i;
+
+    struct PicoTensor* y = pico_attention(q, k, v, NULL);
+    ASSERT_EQ(y->ndim, 3);
+    ASSERT_EQ(y->shape[1], 3);
+    ASSERT_EQ(y->shape[2], 6);
+    ASSERT_EQ(y->num_parents, 3);
+    // zero scores: every output row is the mean of v's rows, (0 + 6 + ... + 24) / 5
+    ASSERT_NEAR(y->data[0], 12.0f, 1e-5f);
+    ASSERT_NEAR(y->data[1 * 3 * 6 + 2 * 6 + 1], 43.0f, 1e-5f);
+
+    ASSERT_TRUE(pico_attention(q, pico_create_tensor(ar, bad_d, 3), v, NULL) == NULL);
+    ASSERT_TRUE(pico_attention(q, pico_create_tensor(ar, bad_b, 3), v, NULL) == NULL);
+    ASSERT_TRUE(pico_attention(q, k, q, NULL) == NULL);
+    ASSERT_TRUE(pico_attention(q, k, v, pico_create_tensor(ar, bad_m, 2)) == NULL);
+
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
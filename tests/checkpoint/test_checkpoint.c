@@ -0,0 +1,266 @@
+/*
+ * Tests for checkpoints (checkpoint/checkpoint.h): the file layout, zero-copy mmap
+ * loading, copying into live params, optimizer state round trips, async saves, and
+ * rejection of damaged files.
+ * NOTE: no UTEST_MAIN here, test_basic.c owns main + UTEST_STATE.
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "arena.h"
+#include "checkpoint/checkpoint.h"
+#include "global.h"
+#include "nn/linear.h"
+#include "optim/optim.h"
+#include "tensor.h"
+#include "utest.h"
+#include "view/view.h"
+
+#define CKPT_TEST_PATH "/tmp/pico_test_checkpoint.bin"
+
+static void ckpt_fill(struct PicoTensor* t, float base) {
+    for(int64_t i = 0; i < t->numel; i++) pico_tensor_set(t, i, base + 0.25f * (float)(i % 11));
+}
+
+// header + aligned offsets on disk; mapped tensors point into the file, bit-exact
+UTEST(checkpoint, round_trip_zero_copy) {
+    int64_t s1[] = {3, 5}, s2[] = {7}, s3[] = {2, 3, 4};
+    struct PicoTensor* a = pico_param(s1, 2);
+    struct PicoTensor* b = pico_param(s2, 1);
+    struct PicoTensor* c = pico_param_dtype(s3, 3, PICO_BF16);
+    ckpt_fill(a, 1.0f);
+    ckpt_fill(b, -2.0f);
+    ckpt_fill(c, 0.5f);
+
+    struct PicoCkptWriter* w = pico_ckpt_writer_init();
+    ASSERT_TRUE(pico_ckpt_add(w, "a", a));
+    ASSERT_TRUE(pico_ckpt_add(w, "layer.b", b));
+    ASSERT_TRUE(pico_ckpt_add(w, "c16", c));
+    ASSERT_FALSE(pico_ckpt_add(w, "a", b));  // names are unique
+    // a transposed view would be written in storage order: refused
+    struct Arena* ar = arena_init(1 << 12);
+    arena_ctx_push(ar);
+    ASSERT_FALSE(pico_ckpt_add(w, "a.T", pico_transpose(a, 0, 1)));
+    arena_ctx_pop();
+    arena_destroy(ar);
+    ASSERT_TRUE(pico_ckpt_write(w, CKPT_TEST_PATH));
+    pico_ckpt_writer_free(w);
+
+    struct PicoCkpt* ck = pico_ckpt_open(CKPT_TEST_PATH);
+    ASSERT_TRUE(ck != NULL);
+    ASSERT_EQ(ck->header->count, 3u);
+    ASSERT_EQ(ck->header->data_offset % PICO_CKPT_ALIGN, 0u);
+
+    struct PicoTensor* ta = pico_ckpt_tensor(ck, "a");
+    struct PicoTensor* tb = pico_ckpt_tensor(ck, "layer.b");
+    struct PicoTensor* tc = pico_ckpt_tensor(ck, "c16");
+    ASSERT_TRUE(ta != NULL && tb != NULL && tc != NULL);
+    ASSERT_TRUE(pico_ckpt_tensor(ck, "missing") == NULL);
+    ASSERT_TRUE(pico_ckpt_tensor(ck, "a") == ta);  // one view per entry
+
+    // zero-copy: the data lives inside the mapping, 64-byte aligned
+    ASSERT_TRUE((uint8_t*)ta->data >= ck->map && (uint8_t*)ta->data < ck->map + ck->size);
+    ASSERT_EQ((uintptr_t)ta->data % PICO_CKPT_ALIGN, 0u);
+    ASSERT_EQ((uintptr_t)tc->data % PICO_CKPT_ALIGN, 0u);
+
+    ASSERT_EQ(ta->ndim, 2);
+    ASSERT_EQ(ta->shape[1], 5);
+    ASSERT_EQ(ta->strides[0], 5);
+    ASSERT_EQ(tc->dtype, PICO_BF16);
+    ASSERT_EQ(ta->requires_grad, 0);
+    ASSERT_EQ(memcmp(ta->data, a->data, sizeof(float) * a->numel), 0);
+    ASSERT_EQ(memcmp(tb->data, b->data, sizeof(float) * b->numel), 0);
+    ASSERT_EQ(memcmp(tc->data16, c->data16, sizeof(uint16_t) * c->numel), 0);
+
+    // the mapping is private: writing a mapped tensor leaves the file alone
+    ta->data[0] = 1234.0f;
+    pico_ckpt_close(ck);
+    ck = pico_ckpt_open(CKPT_TEST_PATH);
+    ASSERT_EQ(pico_ckpt_tensor(ck, "a")->data[0], a->data[0]);
+
+    pico_ckpt_close(ck);
+    pico_free(a);
+    pico_free(b);
+    pico_free(c);
+    remove(CKPT_TEST_PATH);
+}
+
+// a Linear saved, then bound (mmap) or loaded (copy) into a fresh one, gives the same output
+UTEST(checkpoint, linear_bind_and_load) {
+    struct Arena* ar = arena_init(1 << 16);
+    arena_ctx_push(ar);
+    struct PicoLinear* src = pico_nn_linear_init(6, 4, true);
+    ckpt_fill(src->weights, -0.5f);
+    ckpt_fill(src->bias, 0.1f);
+
+    struct PicoCkptWriter* w = pico_ckpt_writer_init();
+    ASSERT_TRUE(pico_ckpt_add_linear(w, "fc", src));
+    ASSERT_TRUE(pico_ckpt_write(w, CKPT_TEST_PATH));
+    pico_ckpt_writer_free(w);
+
+    int64_t sx[] = {3, 6};
+    struct PicoTensor* x = pico_create_tensor(ar, sx, 2);
+    ckpt_fill(x, 0.0f);
+    struct PicoTensor* want = pico_nn_linear_forward_act(src, x, PICO_ACT_RELU);
+
+    struct PicoCkpt* ck = pico_ckpt_open(CKPT_TEST_PATH);
+    struct PicoLinear* mapped = pico_nn_linear_init(6, 4, true);
+    struct PicoLinear* copied = pico_nn_linear_init(6, 4, true);
+    ASSERT_TRUE(pico_ckpt_bind_linear(ck, "fc", mapped));
+    ASSERT_TRUE(pico_ckpt_load_linear(ck, "fc", copied));
+    ASSERT_TRUE(mapped->weights == pico_ckpt_tensor(ck, "fc.weight"));
+    ASSERT_TRUE(copied->weights->data != pico_ckpt_tensor(ck, "fc.weight")->data);
+
+    struct PicoTensor* got_mapped = pico_nn_linear_forward_act(mapped, x, PICO_ACT_RELU);
+    struct PicoTensor* got_copied = pico_nn_linear_forward_act(copied, x, PICO_ACT_RELU);
+    for(int64_t i = 0; i < want->numel; i++) {
+        ASSERT_EQ(got_mapped->data[i], want->data[i]);
+        ASSERT_EQ(got_copied->data[i], want->data[i]);
+    }
+
+    // shape mismatches are refused
+    struct PicoLinear* wrong = pico_nn_linear_init(4, 6, true);
+    ASSERT_FALSE(pico_ckpt_load_linear(ck, "fc", wrong));
+    ASSERT_FALSE(pico_ckpt_bind_linear(ck, "fc", wrong));
+
+    pico_nn_linear_free(mapped);  // the mapped params are the checkpoint's, not freed here
+    pico_nn_linear_free(copied);
+    pico_nn_linear_free(wrong);
+    pico_nn_linear_free(src);
+    pico_ckpt_close(ck);
+    arena_ctx_pop();
+    arena_destroy(ar);
+    remove(CKPT_TEST_PATH);
+}
+
+// Adam state + step count + a bf16 param's master survive a save/load: the resumed
+// optimizer takes exactly the step the original one takes
+UTEST(checkpoint, optimizer_resume) {
+    int64_t s1[] = {40}, s2[] = {3, 7};
+    struct PicoTensor* p[2] = {pico_param(s1, 1), pico_param_dtype(s2, 2, PICO_BF16)};
+    struct PicoTensor* q[2] = {pico_param(s1, 1), pico_param_dtype(s2, 2, PICO_BF16)};
+    struct PicoOptim* opt = pico_optim_adamw_init(0.01f, 0.9f, 0.999f, 0.01f);
+    struct PicoOptim* resumed = pico_optim_adamw_init(0.01f, 0.9f, 0.999f, 0.01f);
+    for(int k = 0; k < 2; k++) {
+        ckpt_fill(p[k], 0.3f);
+        pico_optim_add(opt, p[k]);
+        pico_optim_add(resumed, q[k]);
+    }
+    for(int step = 0; step < 3; step++) {
+        for(int k = 0; k < 2; k++)
+            for(int64_t i = 0; i < p[k]->numel; i++) p[k]->grad[i] = 0.01f * (float)(i % 5 - 2);
+        pico_optim_step(opt);
+    }
+
+    struct PicoCkptWriter* w = pico_ckpt_writer_init();
+    ASSERT_TRUE(pico_ckpt_add(w, "p0", p[0]));
+    ASSERT_TRUE(pico_ckpt_add(w, "p1", p[1]));
+    ASSERT_TRUE(pico_ckpt_add_optim(w, "opt", opt));
+    ASSERT_TRUE(pico_ckpt_write(w, CKPT_TEST_PATH));
+    pico_ckpt_writer_free(w);
+
+    struct PicoCkpt* ck = pico_ckpt_open(CKPT_TEST_PATH);
+    ASSERT_TRUE(pico_ckpt_load(ck, "p0", q[0]));
+    ASSERT_TRUE(pico_ckpt_load(ck, "p1", q[1]));
+    ASSERT_TRUE(pico_ckpt_load_optim(ck, "opt", resumed));
+    ASSERT_EQ(resumed->t, 3);
+    pico_ckpt_close(ck);
+
+    for(int k = 0; k < 2; k++) {
+        for(int64_t i = 0; i < p[k]->numel; i++) {
+            p[k]->grad[i] = 0.02f * (float)(i % 3);
+            q[k]->grad[i] = 0.02f * (float)(i % 3);
+        }
+    }
+    pico_optim_step(opt);
+    pico_optim_step(resumed);
+    ASSERT_EQ(memcmp(p[0]->data, q[0]->data, sizeof(float) * p[0]->numel), 0);
+    ASSERT_EQ(memcmp(p[1]->data16, q[1]->data16, sizeof(uint16_t) * p[1]->numel), 0);
+    ASSERT_EQ(memcmp(opt->chunks.master, resumed->chunks.master, sizeof(float) * 21), 0);
+
+    pico_optim_free(opt);
+    pico_optim_free(resumed);
+    for(int k = 0; k < 2; k++) {
+        pico_free(p[k]);
+        pico_free(q[k]);
+    }
+    remove(CKPT_TEST_PATH);
+}
+
+// a truncated file, a wrong magic and a missing file are all refused
+UTEST(checkpoint, rejects_damaged_files) {
+    int64_t s[] = {100};
+    struct PicoTensor* a = pico_param(s, 1);
+    struct PicoCkptWriter* w = pico_ckpt_writer_init();
+    pico_ckpt_add(w, "a", a);
+    ASSERT_TRUE(pico_ckpt_write(w, CKPT_TEST_PATH));
+    pico_ckpt_writer_free(w);
+
+    FILE* f = fopen(CKPT_TEST_PATH, "rb");
+    char buf[1024];
+    size_t n = fread(buf, 1, sizeof(buf), f);
+    fclose(f);
+    ASSERT_GT(n, 128u);
+
+    f = fopen(CKPT_TEST_PATH, "wb");
+    fwrite(buf, 1, n - 16, f);  // truncated
+    fclose(f);
+    ASSERT_TRUE(pico_ckpt_open(CKPT_TEST_PATH) == NULL);
+
+    buf[0] = 'X';
+    f = fopen(CKPT_TEST_PATH, "wb");
+    fwrite(buf, 1, n, f);  // full length, wrong magic
+    fclose(f);
+    ASSERT_TRUE(pico_ckpt_open(CKPT_TEST_PATH) == NULL);
+
+    remove(CKPT_TEST_PATH);
+    ASSERT_TRUE(pico_ckpt_open(CKPT_TEST_PATH) == NULL);
+    pico_free(a);
+}
+
+// an async save holds the values from the time of the call, not from when it hits disk,
+// and writes the same bytes as pico_ckpt_write; back-to-back saves wait for each other
+UTEST(checkpoint, async_snapshot) {
+    int64_t s1[] = {33, 9}, s2[] = {5};
+    struct PicoTensor* a = pico_param(s1, 2);
+    struct PicoTensor* b = pico_param_dtype(s2, 1, PICO_F16);
+    ckpt_fill(a, 2.0f);
+    ckpt_fill(b, -1.0f);
+    struct PicoCkptWriter* w = pico_ckpt_writer_init();
+    ASSERT_TRUE(pico_ckpt_add(w, "a", a));
+    ASSERT_TRUE(pico_ckpt_add(w, "b", b));
+    ASSERT_TRUE(pico_ckpt_write(w, CKPT_TEST_PATH ".sync"));
+
+    struct PicoCkptAsync* as = pico_ckpt_async_init();
+    ASSERT_TRUE(pico_ckpt_write_async(as, w, CKPT_TEST_PATH));
+    ckpt_fill(a, 100.0f);  // the next "step" runs while the save is in flight
+    ASSERT_TRUE(pico_ckpt_async_wait(as));
+
+    FILE* fs = fopen(CKPT_TEST_PATH ".sync", "rb");
+    FILE* fa = fopen(CKPT_TEST_PATH, "rb");
+    char bs[4096], ba[4096];
+    size_t ns = fread(bs, 1, sizeof(bs), fs), na = fread(ba, 1, sizeof(ba), fa);
+    fclose(fs);
+    fclose(fa);
+    ASSERT_EQ(ns, na);
+    ASSERT_EQ(memcmp(bs, ba, ns), 0);
+
+    // saved twice in a row: the second call waits for the first, the file holds the second
+    ASSERT_TRUE(pico_ckpt_write_async(as, w, CKPT_TEST_PATH));
+    ckpt_fill(a, 7.0f);
+    ASSERT_TRUE(pico_ckpt_write_async(as, w, CKPT_TEST_PATH));
+    pico_ckpt_async_free(as);
+
+    struct PicoCkpt* ck = pico_ckpt_open(CKPT_TEST_PATH);
+    ASSERT_TRUE(ck != NULL);
+    ASSERT_EQ(memcmp(pico_ckpt_tensor(ck, "a")->data, a->data, sizeof(float) * a->numel), 0);
+    ASSERT_EQ(memcmp(pico_ckpt_tensor(ck, "b")->data16, b->data16, sizeof(uint16_t) * b->numel),
+              0);
+
+    pico_ckpt_close(ck);
+    pico_ckpt_writer_free(w);
+    pico_free(a);
+    pico_free(b);
+    remove(CKPT_TEST_PATH);
+    remove(CKPT_TEST_PATH ".sync");
+}
@@ -0,0 +1,239 @@
+/*
+ * Tests for datasets + the batch loader (data/dataset.h): .npy and raw files, shuffled
+ * epochs that cover every sample once with inputs and labels kept together, the short
+ * last batch / drop_last, and the fixed double-buffered views.
+ * NOTE: no UTEST_MAIN here, test_basic.c owns main + UTEST_STATE.
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "arena.h"
+#include "data/dataset.h"
+#include "loss/loss.h"
+#include "nn/linear.h"
+#include "ops.h"
+#include "optim/optim.h"
+#include "reduce/reduce.h"
+#include "tensor.h"
+#include "utest.h"
+#include "view/view.h"
+
+#define DATA_X_PATH "/tmp/pico_test_dataset_x.npy"
+#define DATA_Y_PATH "/tmp/pico_test_dataset_y.bin"
+#define DATA_N 10
+#define DATA_D 3
+
+// x[i] = {10i, 10i + 1, 10i + 2} as a (10, 3) '<f4' .npy (v1 header padded to 128);
+// y[i] = i as raw floats
+static void write_files(void) {
+    char header[128 - 10];
+    memset(header, ' ', sizeof(header));
+    int len = snprintf(header, sizeof(header),
+                       "{'descr': '<f4', 'fortran_order': False, 'shape': (%d, %d), }", DATA_N,
+                       DATA_D);
+    header[len] = ' ';
+    header[sizeof(header) - 1] = '\n';
+    uint16_t hlen = sizeof(header);
+    FILE* f = fopen(DATA_X_PATH, "wb");
+    fwrite("\x93NUMPY\x01\x00", 1, 8, f);
+    fwrite(&hlen, 2, 1, f);
+    fwrite(header, 1, sizeof(header), f);
+    float y[DATA_N];
+    for(int i = 0; i < DATA_N; i++) {
+        y[i] = (float)i;
+        for(int j = 0; j < DATA_D; j++) {
+            float v = (float)(10 * i + j);
+            fwrite(&v, sizeof(float), 1, f);
+        }
+    }
+    fclose(f);
+    f = fopen(DATA_Y_PATH, "wb");
+    fwrite(y, sizeof(float), DATA_N, f);
+    fclose(f);
+}
+
+// every epoch is a permutation, in batches of 4, 4, 2 with rows matching their labels;
+// epochs are shuffled differently, and the batches are always one of the two slot views
+UTEST(dataset, shuffled_epochs) {
+    write_files();
+    struct PicoDataset* sets[2] = {pico_dataset_open_npy(DATA_X_PATH),
+                                   pico_dataset_open(DATA_Y_PATH, PICO_F32, NULL, 0)};
+    ASSERT_TRUE(sets[0] != NULL && sets[1] != NULL);
+    ASSERT_EQ(sets[0]->n, DATA_N);
+    ASSERT_EQ(sets[0]->ndim, 1);
+    ASSERT_EQ(sets[0]->shape[0], DATA_D);
+    ASSERT_EQ(sets[1]->n, DATA_N);
+
+    struct PicoLoader* l = pico_loader_init(sets, 2, 4, true, false, 42);
+    ASSERT_TRUE(l != NULL);
+    float first_order[2][DATA_N];
+    for(int epoch = 0; epoch < 2; epoch++) {
+        int seen[DATA_N] = {0}, count = 0, batches = 0;
+        struct PicoTensor* b[2];
+        while(pico_loader_next(l, b)) {
+            ASSERT_TRUE(b[0] == l->slots[0].views[0] || b[0] == l->slots[1].views[0]);
+            ASSERT_EQ(b[0]->ndim, 2);
+            ASSERT_EQ(b[0]->shape[1], DATA_D);
+            ASSERT_EQ(b[1]->ndim, 1);
+            ASSERT_EQ(b[0]->shape[0], batches < 2 ? 4 : 2);
+            ASSERT_EQ(b[0]->numel, b[0]->shape[0] * DATA_D);
+            ASSERT_EQ(b[1]->numel, b[0]->shape[0]);
+            for(int64_t r = 0; r < b[1]->numel; r++) {
+                int label = (int)b[1]->data[r];
+                for(int j = 0; j < DATA_D; j++)
+                    ASSERT_EQ(b[0]->data[r * DATA_D + j], (float)(10 * label + j));
+                seen[label]++;
+                first_order[epoch][count++] = (float)label;
+            }
+            batches++;
+        }
+        ASSERT_EQ(batches, 3);
+        for(int i = 0; i < DATA_N; i++) ASSERT_EQ(seen[i], 1);
+    }
+    ASSERT_NE(memcmp(first_order[0], first_order[1], sizeof(first_order[0])), 0);
+    pico_loader_free(l);
+
+    // in order, dropping the short batch
+    l = pico_loader_init(sets, 2, 4, false, true, 0);
+    struct PicoTensor* b[2];
+    for(int k = 0; k < 2; k++) {
+        ASSERT_TRUE(pico_loader_next(l, b));
+        for(int r = 0; r < 4; r++) ASSERT_EQ(b[1]->data[r], (float)(4 * k + r));
+    }
+    ASSERT_FALSE(pico_loader_next(l, b));
+    ASSERT_TRUE(pico_loader_next(l, b));  // next epoch
+    ASSERT_EQ(b[1]->data[0], 0.0f);
+    pico_loader_free(l);
+
+    pico_dataset_close(sets[0]);
+    pico_dataset_close(sets[1]);
+    remove(DATA_X_PATH);
+    remove(DATA_Y_PATH);
+}
+
+// sizes that don't add up are refused
+UTEST(dataset, rejects_mismatches) {
+    write_files();
+    int64_t four[] = {4};
+    ASSERT_TRUE(pico_dataset_open(DATA_Y_PATH, PICO_F32, four, 1) == NULL);  // 10 floats
+    ASSERT_TRUE(pico_dataset_open_npy(DATA_Y_PATH) == NULL);                 // not .npy
+    ASSERT_TRUE(pico_dataset_open_npy("/tmp/pico_test_dataset_missing.npy") == NULL);
+
+    int64_t two[] = {2};
+    struct PicoDataset* sets[2] = {pico_dataset_open_npy(DATA_X_PATH),
+                                   pico_dataset_open(DATA_Y_PATH, PICO_F32, two, 1)};
+    ASSERT_EQ(sets[1]->n, 5);
+    ASSERT_TRUE(pico_loader_init(sets, 2, 4, true, false, 0) == NULL);  // 10 vs 5 samples
+    ASSERT_TRUE(pico_loader_init(sets, 1, 0, true, false, 0) == NULL);  // batch 0
+
+    pico_dataset_close(sets[0]);
+    pico_dataset_close(sets[1]);
+    remove(DATA_X_PATH);
+    remove(DATA_Y_PATH);
+}
+
+// loader batches feed a real training loop: fp32 inputs through a Linear, fp16 targets
+// cast for the MSE. y = 2 x0 - x1 + 0.5 x2 + 1 is learned by SGD
+UTEST(dataset, trains_a_linear) {
+    const char* xp = "/tmp/pico_test_dataset_train_x.bin";
+    const char* yp = "/tmp/pico_test_dataset_train_y.bin";
+    int64_t n = 64, xs[] = {64, 3}, ys[] = {64, 1}, one[] = {1};
+    struct PicoTensor* x = pico_param(xs, 2);
+    struct PicoTensor* y = pico_param_dtype(ys, 2, PICO_F16);
+    for(int64_t i = 0; i < n; i++) {
+        float a = (float)(i % 4) * 0.25f, b = (float)(i / 4 % 4) * 0.25f;
+        float c = (float)(i / 16) * 0.25f;
+        x->data[i * 3] = a;
+        x->data[i * 3 + 1] = b;
+        x->data[i * 3 + 2] = c;
+        pico_tensor_set(y, i, 2.0f * a - b + 0.5f * c + 1.0f);
+    }
+    FILE* f = fopen(xp, "wb");
+    fwrite(x->data, sizeof(float), x->numel, f);
+    fclose(f);
+    f = fopen(yp, "wb");
+    fwrite(y->data16, sizeof(uint16_t), y->numel, f);
+    fclose(f);
+    int64_t three[] = {3};
+    struct PicoDataset* sets[2] = {pico_dataset_open(xp, PICO_F32, three, 1),
+                                   pico_dataset_open(yp, PICO_F16, one, 1)};
+    ASSERT_TRUE(sets[0] != NULL && sets[1] != NULL);
+
+    struct Arena* ar = arena_init(1 << 20);
+    arena_ctx_push(ar);
+    struct PicoLinear* layer = pico_nn_linear_init(3, 1, true);
+    struct PicoOptimSGD* sgd = pico_optim_sgd_init(0.2f);
+    pico_optim_sgd_add(sgd, layer->weights);
+    pico_optim_sgd_add(sgd, layer->bias);
+    struct PicoLoader* l = pico_loader_init(sets, 2, 16, true, false, 7);
+    struct PicoTensor* b[2];
+    float first = -1.0f, last = 0.0f;
+    for(int epoch = 0; epoch < 60; epoch++) {
+        while(pico_loader_next(l, b)) {
+            struct PicoMSELoss* mse = pico_mse_loss_init(ar, MEAN);
+            struct PicoTensor* pred = pico_nn_linear_forward(layer, b[0]);
+            struct PicoTensor* loss = pico_mse_loss(mse, pred, b[1]);
+            ASSERT_TRUE(loss != NULL);
+            last = loss->data[0];
+            if(first < 0.0f) first = last;
+            pico_backward(ar, loss);
+            pico_optim_sgd_step(sgd);
+            pico_optim_sgd_zero_grad(sgd);
+            arena_reset(ar);
+        }
+    }
+    ASSERT_LT(last, first * 1e-3f);
+    ASSERT_NEAR(layer->weights->data[0], 2.0f, 0.05f);
+    ASSERT_NEAR(layer->bias->data[0], 1.0f, 0.05f);
+
+    pico_loader_free(l);
+    pico_optim_sgd_free(sgd);
+    pico_nn_linear_free(layer);
+    arena_ctx_pop();
+    arena_destroy(ar);
+    pico_dataset_close(sets[0]);
+    pico_dataset_close(sets[1]);
+    pico_free(x);
+    pico_free(y);
+    remove(xp);
+    remove(yp);
+}
+
+// elementwise ops and reduces straight on a batch: their backwards write through the
+// batch too, and the param's grad comes out as for any other input. with w = 1,
+// x * w + x - y is 2x - i on row i, its max the last column, 2 (10i + 2) - i = 19i + 4;
+// w's grad is column 2 of x, 10i + 2, summed over the rows whose max it is
+UTEST(dataset, backward_through_a_batch) {
+    write_files();
+    struct PicoDataset* sets[2] = {pico_dataset_open_npy(DATA_X_PATH),
+                                   pico_dataset_open(DATA_Y_PATH, PICO_F32, NULL, 0)};
+    struct Arena* ar = arena_init(1 << 16);
+    arena_ctx_push(ar);
+    int64_t ws[] = {DATA_D}, ys[] = {4, 1};
+    int axis[] = {1};
+    struct PicoTensor* w = pico_param(ws, 1);
+    for(int j = 0; j < DATA_D; j++) w->data[j] = 1.0f;
+    struct PicoLoader* l = pico_loader_init(sets, 2, 4, false, false, 0);
+    struct PicoTensor* b[2];
+    for(int k = 0; k < 2; k++) {
+        ASSERT_TRUE(pico_loader_next(l, b));
+        struct PicoTensor* y = pico_reshape(b[1], ys, 2);
+        struct PicoTensor* z = pico_sub(pico_add(pico_mul(b[0], w), b[0]), y);
+        struct PicoTensor* loss = pico_sum(pico_max(z, axis, 1, false), NULL, 0, false);
+        ASSERT_EQ(loss->data[0], (float)(304 * k + 130));  // rows 4k .. 4k + 3
+        pico_backward(ar, loss);
+        arena_reset(ar);
+    }
+    ASSERT_EQ(w->grad[0], 0.0f);
+    ASSERT_EQ(w->grad[1], 0.0f);
+    ASSERT_EQ(w->grad[2], 296.0f);  // rows 0 .. 7
+
+    pico_loader_free(l);
+    pico_free(w);
+    arena_ctx_pop();
+    arena_destroy(ar);
+    pico_dataset_close(sets[0]);
+    pico_dataset_close(sets[1]);
+    remove(DATA_X_PATH);
+    remove(DATA_Y_PATH);
+}
@@ -0,0 +1,190 @@
+/*
+ * Tests for the fused element-wise chains (pico_mul_add, pico_mul_add_relu, pico_silu).
+ * NOTE: no UTEST_MAIN here, test_basic.c owns main + UTEST_STATE.
+ *
+ * Each fused op is checked against the UNFUSED chain it replaces (pico_mul ->
+ * pico_add -> pico_relu), forward and backward, plus a forced-AVX2 run that covers
+ * the vector body and the scalar tail (save/restore, cpu-supports guard).
+ */
+#include <math.h>
+
+#include "act/activations.h"
+#include "arena.h"
+#include "fused/fused.h"
+#include "global.h"
+#include "ops.h"
+#include "tensor.h"
+#include "utest.h"
+
+#define NEAR(a, b) (fabsf((a) - (b)) < 1e-5f)
+
+// a*b + c, same shapes
+UTEST(fused, mul_add_forward) {
+    struct Arena* ar = arena_init(4096);
+    arena_ctx_push(ar);
+
+    int64_t s[] = {3};
+    struct PicoTensor* a = pico_param(s, 1);
+    struct PicoTensor* b = pico_param(s, 1);
+    struct PicoTensor* c = pico_param(s, 1);
+    for(int i = 0; i < 3; i++) {
+        a->data[i] = (float)(i + 1);  // 1 2 3
+        b->data[i] = 2.0f;
+        c->data[i] = -1.0f;
+    }
+
+    struct PicoTensor* out = pico_mul_add(a, b, c);
+    ASSERT_TRUE(out->data[0] == 1.0f);
+    ASSERT_TRUE(out->data[1] == 3.0f);
+    ASSERT_TRUE(out->data[2] == 5.0f);
+    ASSERT_EQ(out->num_parents, 3);
+
+    pico_free(a);
+    pico_free(b);
+    pico_free(c);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+// relu(x*w + bias) with a broadcast bias row: [2,3] * [2,3] + [3]
+UTEST(fused, mul_add_relu_broadcast_bias) {
+    struct Arena* ar = arena_init(4096);
+    arena_ctx_push(ar);
+
+    int64_t s[] = {2, 3};
+    int64_t sb[] = {3};
+    struct PicoTensor* a = pico_param(s, 2);
+    struct PicoTensor* b = pico_param(s, 2);
+    struct PicoTensor* c = pico_param(sb, 1);
+    float av[] = {1, -2, 3, -4, 5, -6};
+    for(int i = 0; i < 6; i++) {
+        a->data[i] = av[i];
+        b->data[i] = 1.0f;
+    }
+    c->data[0] = 1.0f;
+    c->data[1] = 1.0f;
+    c->data[2] = -10.0f;
+
+    struct PicoTensor* out = pico_mul_add_relu(a, b, c);
+    ASSERT_EQ(out->ndim, 2);
+    ASSERT_TRUE(out->data[0] == 2.0f);  // 1 + 1
+    ASSERT_TRUE(out->data[1] == 0.0f);  // -2 + 1 -> clamped
+    ASSERT_TRUE(out->data[2] == 0.0f);  // 3 - 10 -> clamped
+    ASSERT_TRUE(out->data[4] == 6.0f);  // 5 + 1
+
+    pico_free(a);
+    pico_free(b);
+    pico_free(c);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+// fused backward == backward of the unfused mul -> add -> relu chain (bias broadcast)
+UTEST(fused, mul_add_relu_backward_matches_unfused) {
+    struct Arena* ar = arena_init(1 << 16);
+    arena_ctx_push(ar);
+
+    int64_t s[] = {2, 3};
+    int64_t sb[] = {3};
+    struct PicoTensor* a = pico_param(s, 2);
+    struct PicoTensor* b = pico_param(s, 2);
+    struct PicoTensor* c = pico_param(sb, 1);
+    struct PicoTensor* a2 = pico_param(s, 2);
+    struct PicoTensor* b2 = pico_param(s, 2);
+    struct PicoTensor* c2 = pico_param(sb, 1);
+    float av[] = {1, -2, 3, -4, 5, -6};
+    float bv[] = {0.5f, 2, -1, 1, 3, 0.25f};
+    for(int i = 0; i < 6; i++) {
+        a->data[i] = a2->data[i] = av[i];
+        b->data[i] = b2->data[i] = bv[i];
+    }
+    for(int i = 0; i < 3; i++) c->data[i] = c2->data[i] = (float)i - 1.0f;
+
+    pico_backward(ar, pico_mul_add_relu(a, b, c));
+    pico_backward(ar, pico_relu(pico_add(pico_mul(a2, b2), c2)));
+
+    for(int i = 0; i < 6; i++) {
+        ASSERT_TRUE(NEAR(a->grad[i], a2->grad[i]));
+        ASSERT_TRUE(NEAR(b->grad[i], b2->grad[i]));
+    }
+    for(int i = 0; i < 3; i++) ASSERT_TRUE(NEAR(c->grad[i], c2->grad[i]));
+
+    pico_free(a);
+    pico_free(b);
+    pico_free(c);
+    pico_free(a2);
+    pico_free(b2);
+    pico_free(c2);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+// silu(0) = 0, silu(x) = x*sigmoid(x); d/dx at 0 = 0.5
+UTEST(fused, silu_forward_backward) {
+    struct Arena* ar = arena_init(4096);
+    arena_ctx_push(ar);
+
+    int64_t s[] = {2};
+    struct PicoTensor* x = pico_param(s, 1);
+    x->data[0] = 0.0f;
+    x->data[1] = 2.0f;
+
+    struct PicoTensor* out = pico_silu(x);
+    ASSERT_TRUE(NEAR(out->data[0], 0.0f));
+    ASSERT_TRUE(NEAR(out->data[1], 2.0f / (1.0f + expf(-2.0f))));
+
+    out->grad[0] = 2.0f;  // upstream != 1 so a missing multiply shows up
+    out->grad[1] = 1.0f;
+    out->_backward(out);
+    float s2 = 1.0f / (1.0f + expf(-2.0f));
+    ASSERT_TRUE(NEAR(x->grad[0], 1.0f));
+    ASSERT_TRUE(NEAR(x->grad[1], s2 + 2.0f * s2 * (1.0f - s2)));
+
+    pico_free(x);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+// forced AVX2: 19 elements = two vectors + a 3-element tail, compared to the scalar path
+UTEST(fused, avx2_matches_scalar) {
+    if(!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("fma")) return;
+
+    SimdLevel saved = g_simd_level;
+    pico_init();
+
+    struct Arena* ar = arena_init(1 << 16);
+    arena_ctx_push(ar);
+
+    int64_t s[] = {19};
+    struct PicoTensor* a = pico_param(s, 1);
+    struct PicoTensor* b = pico_param(s, 1);
+    struct PicoTensor* c = pico_param(s, 1);
+    for(int i = 0; i < 19; i++) {
+        a->data[i] = (float)(i - 9) * 0.5f;
+        b->data[i] = (float)(i % 4) - 1.0f;
+        c->data[i] = 0.25f;
+    }
+
+    g_simd_level = SIMD_NONE;
+    struct PicoTensor* ref_relu = pico_mul_add_relu(a, b, c);
+    struct PicoTensor* ref_silu = pico_silu(a);
+    g_simd_level = SIMD_AVX2;
+    struct PicoTensor* out_relu = pico_mul_add_relu(a, b, c);
+    struct PicoTensor* out_silu = pico_silu(a);
+    g_simd_level = saved;
+
+    int relu_ok = 1, silu_ok = 1;
+    for(int i = 0; i < 19; i++) {
+        relu_ok &= out_relu->data[i] == ref_relu->data[i];
+        silu_ok &= fabsf(out_silu->data[i] - ref_silu->data[i]) < 1e-5f;
+    }
+
+    pico_free(a);
+    pico_free(b);
+    pico_free(c);
+    arena_ctx_pop();
+    arena_destroy(ar);
+
+    ASSERT_TRUE(relu_ok);
+    ASSERT_TRUE(silu_ok);
+}
@@ -0,0 +1,147 @@
+/*
+ * Tests for the AVX2 / AVX-512 polynomial unary kernels (exp, log, sin, cos, tan,
+ * tanh, sqrt) against libm.
+ * NOTE: no UTEST_MAIN here, test_basic.c owns main + UTEST_STATE.
+ *
+ * Same forcing pattern as test_avx2.c: set g_simd_level, run the op, restore the
+ * level BEFORE asserting. Sizes are odd on purpose so every run hits the masked tail.
+ * Tolerance is a few ulp (the bounds documented in cpu_avx_2.h) plus a tiny absolute
+ * slack for results that land next to zero, where ulp distances explode.
+ */
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "arena.h"
+#include "global.h"
+#include "ops.h"
+#include "tensor.h"
+#include "utest.h"
+
+#define AVX_UNARY_N 37  // 2 x 16 + 5: full AVX-512 vectors, full AVX2 vectors, and a tail
+
+typedef struct PicoTensor* (*unary_op_fn)(struct PicoTensor*);
+
+static int64_t avx_unary_ulp_diff(float a, float b) {
+    int32_t ia, ib;
+    memcpy(&ia, &a, sizeof(ia));
+    memcpy(&ib, &b, sizeof(ib));
+    // map sign-magnitude to a monotonic integer line
+    if(ia < 0) ia = INT32_MIN - ia;
+    if(ib < 0) ib = INT32_MIN - ib;
+    int64_t d = (int64_t)ia - (int64_t)ib;
+    return d < 0 ? -d : d;
+}
+
+static int avx_unary_close(float got, float want, int64_t max_ulp) {
+    if(isnan(want)) return isnan(got);
+    if(isinf(want)) return got == want;
+    if(fabsf(got - want) <= 1e-7f) return 1;
+    return avx_unary_ulp_diff(got, want) <= max_ulp;
+}
+
+// run op over lo..hi at `level`, return the number of elements off by > max_ulp
+static int avx_unary_mismatches(SimdLevel level, unary_op_fn op, float (*ref)(float), float lo,
+                                float hi, int64_t max_ulp) {
+    struct Arena* ar = arena_init(1 << 16);
+    arena_ctx_push(ar);
+
+    int64_t s[] = {AVX_UNARY_N};
+    struct PicoTensor* x = pico_param(s, 1);
+    for(int i = 0; i < AVX_UNARY_N; i++) {
+        x->data[i] = lo + (hi - lo) * (float)i / (float)(AVX_UNARY_N - 1);
+    }
+
+    SimdLevel saved = g_simd_level;
+    g_simd_level = level;
+    struct PicoTensor* out = op(x);
+    g_simd_level = saved;
+
+    int bad = 0;
+    for(int i = 0; i < AVX_UNARY_N; i++) {
+        if(!avx_unary_close(out->data[i], ref(x->data[i]), max_ulp)) bad++;
+    }
+
+    pico_free(x);
+    arena_ctx_pop();
+    arena_destroy(ar);
+    return bad;
+}
+
+static int avx_unary_all_close(SimdLevel level) {
+    int bad = 0;
+    bad += avx_unary_mismatches(level, pico_tensor_exp, expf, -80.0f, 80.0f, 2);
+    bad += avx_unary_mismatches(level, pico_tensor_log, logf, 1e-30f, 1e30f, 2);
+    bad += avx_unary_mismatches(level, pico_tensor_log, logf, 0.01f, 4.0f, 2);
+    bad += avx_unary_mismatches(level, pico_tensor_sin, sinf, -100.0f, 100.0f, 2);
+    bad += avx_unary_mismatches(level, pico_tensor_cos, cosf, -100.0f, 100.0f, 2);
+    bad += avx_unary_mismatches(level, pico_tensor_tan, tanf, -1.5f, 1.5f, 4);
+    bad += avx_unary_mismatches(level, pico_tensor_tanh, tanhf, -6.0f, 6.0f, 3);
+    bad += avx_unary_mismatches(level, pico_tensor_tanh, tanhf, -0.7f, 0.7f, 3);
+    bad += avx_unary_mismatches(level, pico_tensor_sqrt, sqrtf, 0.0f, 1000.0f, 0);
+    // past the 3-part reduction range: lanes fall back to libm
+    bad += avx_unary_mismatches(level, pico_tensor_sin, sinf, 1e4f, 1e6f, 2);
+    return bad;
+}
+
+UTEST(kernel_avx_unary, avx2_matches_libm) {
+    if(!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("fma")) return;
+    ASSERT_EQ(avx_unary_all_close(SIMD_AVX2), 0);
+}
+
+UTEST(kernel_avx_unary, avx512_matches_libm) {
+    if(!__builtin_cpu_supports("avx512f")) return;
+    ASSERT_EQ(avx_unary_all_close(SIMD_AVX512), 0);
+}
+
+// NaN/inf/0/out-of-domain inputs follow libm
+UTEST(kernel_avx_unary, avx2_special_values) {
+    if(!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("fma")) return;
+
+    struct Arena* ar = arena_init(1 << 14);
+    arena_ctx_push(ar);
+
+    int64_t s[] = {6};
+    struct PicoTensor* x = pico_param(s, 1);
+    float in[6] = {NAN, INFINITY, -INFINITY, 0.0f, -1.0f, 100.0f};
+    memcpy(x->data, in, sizeof(in));
+
+    SimdLevel saved = g_simd_level;
+    g_simd_level = SIMD_AVX2;
+    struct PicoTensor* e = pico_tensor_exp(x);
+    struct PicoTensor* l = pico_tensor_log(x);
+    struct PicoTensor* t = pico_tensor_tanh(x);
+    struct PicoTensor* sn = pico_tensor_sin(x);
+    g_simd_level = saved;
+
+    float ev[6], lv[6], tv[6], sv[6];
+    memcpy(ev, e->data, sizeof(ev));
+    memcpy(lv, l->data, sizeof(lv));
+    memcpy(tv, t->data, sizeof(tv));
+    memcpy(sv, sn->data, sizeof(sv));
+
+    pico_free(x);
+    arena_ctx_pop();
+    arena_destroy(ar);
+
+    ASSERT_TRUE(isnan(ev[0]));
+    ASSERT_TRUE(ev[1] == INFINITY);
+    ASSERT_TRUE(ev[2] == 0.0f);
+    ASSERT_TRUE(ev[3] == 1.0f);
+    ASSERT_TRUE(ev[5] == INFINITY);
+
+    ASSERT_TRUE(isnan(lv[0]));
+    ASSERT_TRUE(lv[1] == INFINITY);
+    ASSERT_TRUE(isnan(lv[2]));
+    ASSERT_TRUE(lv[3] == -INFINITY);
+    ASSERT_TRUE(isnan(lv[4]));
+
+    ASSERT_TRUE(isnan(tv[0]));
+    ASSERT_TRUE(tv[1] == 1.0f);
+    ASSERT_TRUE(tv[2] == -1.0f);
+    ASSERT_TRUE(tv[3] == 0.0f);
+
+    ASSERT_TRUE(isnan(sv[0]));
+    ASSERT_TRUE(isnan(sv[1]));
+    ASSERT_TRUE(sv[3] == 0.0f);
+}
@@ -0,0 +1,138 @@
+/*
+ * Tests for the half <-> fp32 converters: the scalar ones in tensor.h (known values,
+ * rounding, specials) and the F16C / AVX2 / AVX-512 bulk kernels, which must match
+ * the scalar ones bit for bit. fp16 -> fp32 is checked over all 65536 inputs; the
+ * narrowing direction over a stride through every float bit pattern.
+ * NOTE: no UTEST_MAIN here, test_basic.c owns main + UTEST_STATE.
+ */
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "global.h"
+#include "kernels/cpu_kernels.h"
+#include "tensor.h"
+#include "utest.h"
+
+#define CVT_SAMPLE_STRIDE 4099u  // odd, so the samples walk every low-bit pattern
+
+static float cvt_bits_to_f32(uint32_t u) {
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+static uint32_t cvt_f32_to_bits(float f) {
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+// every float bit pattern at CVT_SAMPLE_STRIDE, plus the boundaries; returns the count
+static int64_t cvt_fill_samples(float** out) {
+    int64_t n = (int64_t)(0xffffffffu / CVT_SAMPLE_STRIDE) + 1 + 8;
+    float* x = malloc(sizeof(float) * n);
+    int64_t k = 0;
+    for(uint64_t u = 0; u <= 0xffffffffu; u += CVT_SAMPLE_STRIDE) x[k++] = cvt_bits_to_f32(u);
+    float specials[] = {0.0f, -0.0f, INFINITY, -INFINITY, NAN, 65504.0f, 65520.0f, 5.96e-8f};
+    for(int i = 0; i < 8; i++) x[k++] = specials[i];
+    *out = x;
+    return k;
+}
+
+UTEST(cvt, scalar_known_values) {
+    ASSERT_EQ(pico_f32_to_bf16(1.0f), 0x3f80);
+    ASSERT_EQ(pico_f32_to_bf16(-2.0f), 0xc000);
+    // ties go to even: 1 + 2^-8 is halfway between 1 and 1 + 2^-7
+    ASSERT_EQ(pico_f32_to_bf16(cvt_bits_to_f32(0x3f808000u)), 0x3f80);
+    ASSERT_EQ(pico_f32_to_bf16(cvt_bits_to_f32(0x3f818000u)), 0x3f82);
+    ASSERT_EQ(pico_f32_to_bf16(cvt_bits_to_f32(0x3f808001u)), 0x3f81);
+    ASSERT_TRUE(isnan(pico_bf16_to_f32(pico_f32_to_bf16(NAN))));
+    ASSERT_EQ(pico_f32_to_bf16(INFINITY), 0x7f80);
+
+    ASSERT_EQ(pico_f32_to_f16(1.0f), 0x3c00);
+    ASSERT_EQ(pico_f32_to_f16(-0.5f), 0xb800);
+    ASSERT_EQ(pico_f32_to_f16(65504.0f), 0x7bff);   // largest finite
+    ASSERT_EQ(pico_f32_to_f16(65520.0f), 0x7c00);   // rounds past it -> inf
+    ASSERT_EQ(pico_f32_to_f16(0x1p-24f), 0x0001);   // smallest subnormal
+    ASSERT_EQ(pico_f32_to_f16(0x1p-26f), 0x0000);   // below half of it -> 0
+    ASSERT_EQ(pico_f32_to_f16(0x1.8p-24f), 0x0002); // subnormal tie -> even
+    ASSERT_TRUE(pico_f16_to_f32(0x0001) == 0x1p-24f);
+    ASSERT_TRUE(pico_f16_to_f32(0x7bff) == 65504.0f);
+    ASSERT_TRUE(pico_f16_to_f32(0xfc00) == -INFINITY);
+    ASSERT_TRUE(isnan(pico_f16_to_f32(0x7e00)));
+}
+
+// every non-NaN half survives widen -> narrow unchanged
+UTEST(cvt, scalar_round_trip) {
+    int bad = 0;
+    for(uint32_t h = 0; h <= 0xffff; h++) {
+        float f16 = pico_f16_to_f32((uint16_t)h);
+        float bf16 = pico_bf16_to_f32((uint16_t)h);
+        if(!isnan(f16) && pico_f32_to_f16(f16) != h) bad++;
+        if(!isnan(bf16) && pico_f32_to_bf16(bf16) != h) bad++;
+    }
+    ASSERT_EQ(bad, 0);
+}
+
+// bulk converters at `level` vs the scalar ones, bitwise
+static int cvt_mismatches(SimdLevel level) {
+    uint16_t* halves = malloc(sizeof(uint16_t) * 65536);
+    float* wide = malloc(sizeof(float) * 65536);
+    for(uint32_t h = 0; h <= 0xffff; h++) halves[h] = (uint16_t)h;
+
+    float* x;
+    int64_t n = cvt_fill_samples(&x);
+    uint16_t* narrow = malloc(sizeof(uint16_t) * n);
+
+    int bad = 0;
+    PicoDType dtypes[] = {PICO_F16, PICO_BF16};
+    for(int d = 0; d < 2; d++) {
+        SimdLevel saved = g_simd_level;
+        g_simd_level = level;
+        pico_widen_cpu(halves, dtypes[d], wide, 65536);
+        g_simd_level = saved;
+        for(uint32_t h = 0; h <= 0xffff; h++) {
+            float want = dtypes[d] == PICO_F16 ? pico_f16_to_f32((uint16_t)h)
+                                               : pico_bf16_to_f32((uint16_t)h);
+            if(cvt_f32_to_bits(wide[h]) != cvt_f32_to_bits(want)) bad++;
+        }
+
+        saved = g_simd_level;
+        g_simd_level = level;
+        pico_narrow_cpu(x, narrow, dtypes[d], n);
+        g_simd_level = saved;
+        for(int64_t i = 0; i < n; i++) {
+            uint16_t want = dtypes[d] == PICO_F16 ? pico_f32_to_f16(x[i]) : pico_f32_to_bf16(x[i]);
+            if(narrow[i] != want) bad++;
+        }
+    }
+
+    free(halves);
+    free(wide);
+    free(x);
+    free(narrow);
+    return bad;
+}
+
+UTEST(cvt, avx2_matches_scalar) {
+    if(!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("f16c")) return;
+    ASSERT_EQ(cvt_mismatches(SIMD_AVX2), 0);
+}
+
+UTEST(cvt, avx512_matches_scalar) {
+    if(!__builtin_cpu_supports("avx512f")) return;
+    ASSERT_EQ(cvt_mismatches(SIMD_AVX512), 0);
+}
+
+// bf16 <-> fp16 goes through fp32; every f16 value that fits bf16's 8 mantissa bits
+// comes back unchanged
+UTEST(cvt, half_to_half) {
+    uint16_t src[] = {0x3c00, 0xc000, 0x3800, 0x7c00, 0x0000, 0x4900};
+    uint16_t mid[6], back[6];
+    pico_convert_cpu(src, PICO_F16, mid, PICO_BF16, 6);
+    pico_convert_cpu(mid, PICO_BF16, back, PICO_F16, 6);
+    for(int i = 0; i < 6; i++) ASSERT_EQ(back[i], src[i]);
+    ASSERT_EQ(mid[0], 0x3f80);  // 1.0
+}
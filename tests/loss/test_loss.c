@@ -1,13 +1,20 @@
 /*
- * Tests for pico_mse_loss (forward value, graph wiring, backward correctness).
+ * Tests for pico_mse_loss (forward value, graph wiring, backward correctness,
+ * reductions, requires_grad, SIMD paths) and
+ * pico_cross_entropy_loss (value, stability, strided labels, fused backward, SIMD
+ * paths).
  * NOTE: no UTEST_MAIN here, test_basic.c owns main + UTEST_STATE.
  */
 
+#include <math.h>
+
 #include "arena.h"
+#include "global.h"
 #include "loss/loss.h"
 #include "ops.h"
 #include "tensor.h"
 #include "utest.h"
+#include "view/view.h"
 
 // MSE of a single element: (pred - actual)^2 / 1
 UTEST(loss, mse_forward_single_element) {
@@ -267,3 +274,295 @@ UTEST(loss, mse_through_pico_backward) {
     arena_ctx_pop();
     arena_destroy(ar);
 }
+
+UTEST(loss, mse_shape_mismatch_is_null) {
+    struct Arena* ar = arena_init(4096);
+    arena_ctx_push(ar);
+
+    int64_t s3[] = {3};
+    int64_t s31[] = {3, 1};
+    struct PicoTensor* pred = pico_param(s3, 1);
+    struct PicoTensor* actual = pico_param(s31, 2);
+
+    struct PicoMSELoss mse = {.reduction = MEAN};
+    ASSERT_TRUE(pico_mse_loss(&mse, pred, actual) == NULL);
+
+    pico_free(pred);
+    pico_free(actual);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+// NONE: per-element losses in the input shape, each with its own upstream grad
+UTEST(loss, mse_none_forward_backward) {
+    struct Arena* ar = arena_init(4096);
+    arena_ctx_push(ar);
+
+    int64_t s[] = {2, 2};
+    struct PicoTensor* pred = pico_param(s, 2);
+    struct PicoTensor* actual = pico_param(s, 2);
+    for(int i = 0; i < 4; i++) {
+        pred->data[i] = (float)i;
+        actual->data[i] = 1.0f;
+    }
+
+    struct PicoMSELoss mse = {.reduction = NONE};
+    struct PicoTensor* loss = pico_mse_loss(&mse, pred, actual);
+    ASSERT_EQ(loss->ndim, 2);
+    ASSERT_EQ(loss->numel, 4);
+    float want[] = {1.0f, 0.0f, 1.0f, 4.0f};
+    for(int i = 0; i < 4; i++) ASSERT_TRUE(loss->data[i] == want[i]);
+
+    for(int i = 0; i < 4; i++) loss->grad[i] = (float)(i + 1);
+    loss->_backward(loss);
+    for(int i = 0; i < 4; i++) {
+        float g = 2.0f * (float)(i + 1) * (pred->data[i] - 1.0f);
+        ASSERT_TRUE(pred->grad[i] == g);
+        ASSERT_TRUE(actual->grad[i] == -g);
+    }
+
+    pico_free(pred);
+    pico_free(actual);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+// constant targets: requires_grad = 0 keeps their grad untouched
+UTEST(loss, mse_skips_targets_without_grad) {
+    struct Arena* ar = arena_init(4096);
+    arena_ctx_push(ar);
+
+    int64_t s[] = {2};
+    struct PicoTensor* pred = pico_param(s, 1);
+    struct PicoTensor* actual = pico_param(s, 1);
+    pred->data[0] = 5.0f;
+    pred->data[1] = -1.0f;
+    actual->data[0] = 3.0f;
+    actual->data[1] = 2.0f;
+    actual->requires_grad = 0;
+
+    struct PicoMSELoss mse = {.reduction = SUM};
+    struct PicoTensor* loss = pico_mse_loss(&mse, pred, actual);
+    ASSERT_TRUE(loss->data[0] == 13.0f);
+
+    pico_backward(ar, loss);
+    ASSERT_TRUE(pred->grad[0] == 4.0f);
+    ASSERT_TRUE(pred->grad[1] == -6.0f);
+    ASSERT_TRUE(actual->grad[0] == 0.0f);
+    ASSERT_TRUE(actual->grad[1] == 0.0f);
+
+    pico_free(pred);
+    pico_free(actual);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+// 3M elements: spans many PICO_MSE_BLOCKs; a running float sum would be off ~1e-3
+UTEST(loss, mse_large_batch_is_accurate) {
+    struct Arena* ar = arena_init(1 << 16);
+    arena_ctx_push(ar);
+
+    int64_t s[] = {3 * (1 << 20) + 5};
+    struct PicoTensor* pred = pico_param(s, 1);
+    struct PicoTensor* actual = pico_param(s, 1);
+    double want = 0.0;
+    for(int64_t i = 0; i < pred->numel; i++) {
+        pred->data[i] = (float)(i % 17) * 0.1f;
+        double d = (double)pred->data[i];
+        want += d * d;
+    }
+    want /= (double)pred->numel;
+
+    struct PicoMSELoss mse = {.reduction = MEAN};
+    struct PicoTensor* loss = pico_mse_loss(&mse, pred, actual);
+    ASSERT_TRUE(fabs(loss->data[0] - want) / want < 1e-6);
+
+    pico_free(pred);
+    pico_free(actual);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+// all three reductions + backward at `level` vs scalar, odd size for the tails
+static float mse_simd_max_diff(SimdLevel level) {
+    struct Arena* ar = arena_init(1 << 16);
+    SimdLevel saved = g_simd_level;
+    pico_init();
+    arena_ctx_push(ar);
+
+    int64_t s[] = {1003};
+    struct PicoTensor* pred = pico_param(s, 1);
+    struct PicoTensor* actual = pico_param(s, 1);
+    for(int64_t i = 0; i < 1003; i++) {
+        pred->data[i] = (float)((i * 37) % 101) * 0.03f;
+        actual->data[i] = (float)(i % 7) * 0.5f;
+    }
+
+    float worst = 0.0f;
+    enum PicoMSEReductionType reds[] = {MEAN, SUM, NONE};
+    for(int r = 0; r < 3; r++) {
+        struct PicoMSELoss mse = {.reduction = reds[r]};
+        g_simd_level = SIMD_NONE;
+        struct PicoTensor* ref = pico_mse_loss(&mse, pred, actual);
+        for(int64_t i = 0; i < ref->numel; i++) ref->grad[i] = 1.0f + (float)(i % 3);
+        ref->_backward(ref);
+        g_simd_level = level;
+        struct PicoTensor* out = pico_mse_loss(&mse, pred, actual);
+        for(int64_t i = 0; i < out->numel; i++) out->grad[i] = -(1.0f + (float)(i % 3));
+        out->_backward(out);  // grads: ref contribution + (-same) -> ~0
+        g_simd_level = saved;
+        for(int64_t i = 0; i < out->numel; i++) {
+            worst = fmaxf(worst, fabsf(out->data[i] - ref->data[i]) / fmaxf(1.0f, ref->data[i]));
+        }
+        for(int64_t i = 0; i < 1003; i++) {
+            worst = fmaxf(worst, fmaxf(fabsf(pred->grad[i]), fabsf(actual->grad[i])));
+        }
+    }
+
+    pico_free(pred);
+    pico_free(actual);
+    arena_ctx_pop();
+    arena_destroy(ar);
+    return worst;
+}
+
+UTEST(loss, mse_avx2_matches_scalar) {
+    if(!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("fma")) return;
+    ASSERT_TRUE(mse_simd_max_diff(SIMD_AVX2) < 1e-5f);
+}
+
+UTEST(loss, mse_avx512_matches_scalar) {
+    if(!__builtin_cpu_supports("avx512f")) return;
+    ASSERT_TRUE(mse_simd_max_diff(SIMD_AVX512) < 1e-5f);
+}
+
+// mean over rows of logsumexp(row) - row[label], in double
+static double ce_ref(const float* x, const float* labels, int64_t N, int64_t C) {
+    double total = 0.0;
+    for(int64_t n = 0; n < N; n++) {
+        double m = -INFINITY, s = 0.0;
+        for(int64_t c = 0; c < C; c++) m = fmax(m, x[n * C + c]);
+        for(int64_t c = 0; c < C; c++) s += exp(x[n * C + c] - m);
+        total += m + log(s) - x[n * C + (int64_t)labels[n]];
+    }
+    return total / (double)N;
+}
+
+UTEST(loss, cross_entropy_forward_backward) {
+    struct Arena* ar = arena_init(1 << 14);
+    arena_ctx_push(ar);
+
+    int64_t s[] = {2, 3};
+    int64_t ls[] = {2};
+    struct PicoTensor* logits = pico_param(s, 2);
+    struct PicoTensor* labels = pico_param(ls, 1);
+    float v[] = {2.0f, 1.0f, 0.1f, 0.5f, 2.5f, -1.0f};
+    for(int i = 0; i < 6; i++) logits->data[i] = v[i];
+    labels->data[0] = 0.0f;
+    labels->data[1] = 2.0f;
+
+    struct PicoTensor* loss = pico_cross_entropy_loss(logits, labels);
+    ASSERT_EQ(loss->numel, 1);
+    ASSERT_TRUE(fabs(loss->data[0] - ce_ref(logits->data, labels->data, 2, 3)) < 1e-5);
+
+    pico_backward(ar, loss);
+    for(int n = 0; n < 2; n++) {
+        double m = 0.0;
+        for(int c = 0; c < 3; c++) m += exp(v[n * 3 + c]);
+        for(int c = 0; c < 3; c++) {
+            double want = (exp(v[n * 3 + c]) / m - (c == (int)labels->data[n])) / 2.0;
+            ASSERT_TRUE(fabs(logits->grad[n * 3 + c] - want) < 1e-6);
+        }
+    }
+    ASSERT_TRUE(labels->grad[0] == 0.0f);
+
+    pico_free(logits);
+    pico_free(labels);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+// huge logits: a naive exp() overflows to inf, the fused path must stay finite. also
+// labels out of range, directly and through a strided view
+UTEST(loss, cross_entropy_is_stable) {
+    struct Arena* ar = arena_init(1 << 14);
+    arena_ctx_push(ar);
+
+    int64_t s[] = {1, 3};
+    int64_t ls[] = {1};
+    struct PicoTensor* logits = pico_param(s, 2);
+    struct PicoTensor* labels = pico_param(ls, 1);
+    logits->data[0] = 1000.0f;
+    logits->data[1] = 990.0f;
+    logits->data[2] = -1000.0f;
+    labels->data[0] = 1.0f;
+
+    struct PicoTensor* loss = pico_cross_entropy_loss(logits, labels);
+    ASSERT_TRUE(isfinite(loss->data[0]));
+    ASSERT_TRUE(fabs(loss->data[0] - ce_ref(logits->data, labels->data, 1, 3)) < 1e-3);
+
+    labels->data[0] = 3.0f;  // out of range
+    ASSERT_TRUE(pico_cross_entropy_loss(logits, labels) == NULL);
+
+    // labels as a step-2 view: its 2nd label is storage element 2, out of range
+    int64_t s2[] = {2, 3}, ws[] = {4};
+    struct PicoTensor* wide = pico_create_tensor(ar, ws, 1);
+    wide->data[0] = wide->data[1] = wide->data[3] = 1.0f;
+    wide->data[2] = 7.0f;
+    struct PicoTensor* two = pico_create_tensor(ar, s2, 2);
+    for(int i = 0; i < 6; i++) two->data[i] = (float)i;
+    ASSERT_TRUE(pico_cross_entropy_loss(two, pico_slice(wide, 0, 0, 4, 2)) == NULL);
+    wide->data[2] = 2.0f;
+    ASSERT_TRUE(pico_cross_entropy_loss(two, pico_slice(wide, 0, 0, 4, 2)) != NULL);
+
+    pico_free(logits);
+    pico_free(labels);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+// loss + logits->grad at `level` vs scalar on a shape with vector tails
+static float ce_simd_max_diff(SimdLevel level) {
+    struct Arena* ar = arena_init(1 << 20);
+    SimdLevel saved = g_simd_level;
+    pico_init();
+    arena_ctx_push(ar);
+
+    int64_t s[] = {7, 1003};
+    int64_t ls[] = {7};
+    struct PicoTensor* logits = pico_param(s, 2);
+    struct PicoTensor* labels = pico_param(ls, 1);
+    for(int64_t i = 0; i < logits->numel; i++) {
+        logits->data[i] = (float)((i * 7919) % 1013) * 0.02f - 10.0f;
+    }
+    for(int n = 0; n < 7; n++) labels->data[n] = (float)((n * 331) % 1003);
+
+    g_simd_level = SIMD_NONE;
+    struct PicoTensor* ref = pico_cross_entropy_loss(logits, labels);
+    ref->grad[0] = 1.0f;
+    ref->_backward(ref);
+    g_simd_level = level;
+    struct PicoTensor* out = pico_cross_entropy_loss(logits, labels);
+    out->grad[0] = -1.0f;
+    out->_backward(out);  // logits->grad: ref contribution + (-same) -> ~0
+    g_simd_level = saved;
+
+    float worst = fabsf(out->data[0] - ref->data[0]);
+    for(int64_t i = 0; i < logits->numel; i++) worst = fmaxf(worst, fabsf(logits->grad[i]));
+
+    pico_free(logits);
+    pico_free(labels);
+    arena_ctx_pop();
+    arena_destroy(ar);
+    return worst;
+}
+
+UTEST(loss, cross_entropy_avx2_matches_scalar) {
+    if(!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("fma")) return;
+    ASSERT_TRUE(ce_simd_max_diff(SIMD_AVX2) < 1e-5f);
+}
+
+UTEST(loss, cross_entropy_avx512_matches_scalar) {
+    if(!__builtin_cpu_supports("avx512f")) return;
+    ASSERT_TRUE(ce_simd_max_diff(SIMD_AVX512) < 1e-5f);
+}
@@ -0,0 +1,242 @@
+/*
+ * Tests for the PicoConv2d layer (nn/conv.h): forward and every grad against a direct
+ * seven-loop convolution, across stride / padding / dilation / groups, the 1x1,
+ * depthwise and Winograd paths, the fused relu, and configurations that must be refused.
+ * NOTE: no UTEST_MAIN here, test_basic.c owns main + UTEST_STATE.
+ */
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+#include "global.h"
+#include "kernels/cpu_kernels.h"
+#include "nn/conv.h"
+#include "ops.h"
+#include "reduce/reduce.h"
+#include "tensor.h"
+#include "test_common.h"
+#include "utest.h"
+
+struct conv_case {
+    int n, h, w, c, oc, k, stride, pad, dilation, groups;
+};
+
+// y = conv(x, W) + b, and for dy the grads dx, dW, db, all by definition
+static void conv_reference(const struct conv_case* cc, const float* x, const float* wt,
+                           const float* b, const float* dy, float* y, float* dx, float* dw,
+                           float* db, int oh, int ow) {
+    int cg = cc->c / cc->groups, og = cc->oc / cc->groups;
+    for(int n = 0; n < cc->n; n++)
+        for(int p = 0; p < oh; p++)
+            for(int q = 0; q < ow; q++)
+                for(int o = 0; o < cc->oc; o++) {
+                    int64_t yi = ((int64_t)(n * oh + p) * ow + q) * cc->oc + o;
+                    int g = o / og;
+                    float acc = b[o];
+                    for(int kh = 0; kh < cc->k; kh++)
+                        for(int kw = 0; kw < cc->k; kw++)
+                            for(int ci = 0; ci < cg; ci++) {
+                                int ih = p * cc->stride - cc->pad + kh * cc->dilation;
+                                int iw = q * cc->stride - cc->pad + kw * cc->dilation;
+                                if(ih < 0 || ih >= cc->h || iw < 0 || iw >= cc->w) continue;
+                                int64_t xi = ((int64_t)(n * cc->h + ih) * cc->w + iw) * cc->c +
+                                             g * cg + ci;
+                                int64_t wi = ((int64_t)(kh * cc->k + kw) * cg + ci) * cc->oc + o;
+                                acc += x[xi] * wt[wi];
+                                dx[xi] += dy[yi] * wt[wi];
+                                dw[wi] += dy[yi] * x[xi];
+                            }
+                    y[yi] = acc;
+                    db[o] += dy[yi];
+                }
+}
+
+// the layer against the reference: forward, then sum(y * dy) backward
+static int check_case(const struct conv_case* cc) {
+    struct Arena* ar = arena_init(1 << 20);
+    arena_ctx_push(ar);
+    struct PicoConv2d* conv = pico_nn_conv2d_init(cc->c, cc->oc, cc->k, cc->stride, cc->pad,
+                                                  cc->dilation, cc->groups, true);
+    int64_t xs[] = {cc->n, cc->h, cc->w, cc->c};
+    struct PicoTensor* x = pico_param(xs, 4);
+    for(int64_t i = 0; i < x->numel; i++) x->data[i] = test_wave(i, 1.0f);
+
+    struct PicoTensor* y = pico_nn_conv2d_forward(conv, x);
+    int oh = (int)y->shape[1], ow = (int)y->shape[2];
+    struct PicoTensor* dy = pico_create_tensor(ar, y->shape, 4);
+    for(int64_t i = 0; i < dy->numel; i++) dy->data[i] = test_wave(i * 7 + 3, 0.5f);
+    pico_backward(ar, pico_sum(pico_mul(y, dy), NULL, 0, false));
+
+    float* ry = calloc(y->numel, sizeof(float));
+    float* rdx = calloc(x->numel, sizeof(float));
+    float* rdw = calloc(conv->weights->numel, sizeof(float));
+    float* rdb = calloc(cc->oc, sizeof(float));
+    conv_reference(cc, x->data, conv->weights->data, conv->bias->data, dy->data, ry, rdx, rdw,
+                   rdb, oh, ow);
+
+    int ok = 1;
+    for(int64_t i = 0; i < y->numel; i++) ok &= test_near(y->data[i], ry[i], 1e-4f);
+    for(int64_t i = 0; i < x->numel; i++) ok &= test_near(x->grad[i], rdx[i], 1e-4f);
+    for(int64_t i = 0; i < conv->weights->numel; i++)
+        ok &= test_near(conv->weights->grad[i], rdw[i], 1e-4f);
+    for(int i = 0; i < cc->oc; i++) ok &= test_near(conv->bias->grad[i], rdb[i], 1e-4f);
+
+    free(ry);
+    free(rdx);
+    free(rdw);
+    free(rdb);
+    pico_free(x);
+    pico_nn_conv2d_free(conv);
+    arena_ctx_pop();
+    arena_destroy(ar);
+    return ok;
+}
+
+UTEST(conv2d, shapes_and_init) {
+    struct PicoConv2d* conv = pico_nn_conv2d_init(16, 32, 3, 1, 1, 1, 4, true);
+    ASSERT_TRUE(conv != NULL);
+    ASSERT_EQ(conv->weights->shape[0], 3);
+    ASSERT_EQ(conv->weights->shape[2], 4);
+    ASSERT_EQ(conv->weights->shape[3], 32);
+    float bound = 1.0f / sqrtf(3.0f * 3.0f * 4.0f);
+    float lo = INFINITY, hi = -INFINITY;
+    for(int64_t i = 0; i < conv->weights->numel; i++) {
+        lo = fminf(lo, conv->weights->data[i]);
+        hi = fmaxf(hi, conv->weights->data[i]);
+    }
+    ASSERT_TRUE(lo >= -bound && hi <= bound && lo < hi);
+    pico_nn_conv2d_free(conv);
+
+    ASSERT_TRUE(pico_nn_conv2d_init(6, 8, 3, 1, 1, 1, 4, true) == NULL);  // 6 % 4
+    ASSERT_TRUE(pico_nn_conv2d_init(4, 8, 3, 0, 1, 1, 1, true) == NULL);  // stride 0
+}
+
+UTEST(conv2d, matches_reference) {
+    pico_init();
+    struct conv_case cases[] = {
+        {2, 7, 6, 3, 8, 3, 1, 1, 1, 1},    // same padding
+        {2, 9, 9, 4, 10, 3, 2, 1, 1, 1},   // strided, odd out channels
+        {1, 10, 8, 6, 6, 3, 1, 2, 2, 2},   // dilated, grouped
+        {2, 5, 5, 8, 8, 3, 1, 1, 1, 8},    // depthwise
+        {2, 6, 7, 12, 20, 1, 1, 0, 1, 1},  // 1x1: no im2col
+        {1, 6, 6, 8, 12, 1, 1, 0, 1, 4},   // grouped 1x1
+        {1, 8, 8, 4, 4, 1, 2, 0, 1, 1},    // 1x1 strided: im2col again
+        {1, 12, 12, 3, 16, 7, 2, 3, 1, 1}, // a ResNet stem
+        {1, 40, 40, 8, 16, 3, 1, 1, 1, 1}, // 1600 rows: the GEMMs split across threads
+        {2, 9, 7, 16, 24, 3, 1, 1, 1, 1},  // Winograd, odd output
+        {2, 9, 9, 20, 20, 3, 2, 2, 2, 20}, // depthwise, strided + dilated, channel tail
+    };
+    for(size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        ASSERT_TRUE(check_case(&cases[i]));
+    }
+}
+
+// pico_conv2d_cpu's depthwise and Winograd paths against im2col + GEMM on the same
+// shape, scalar and AVX2: odd output sizes (half-outside Winograd tiles), channel
+// counts that leave a vector tail, padding 0 and 2
+UTEST(conv2d, algorithms_match_im2col) {
+    struct conv_case cases[] = {
+        {2, 7, 9, 19, 21, 3, 1, 1, 1, 1},   // Winograd
+        {1, 6, 6, 16, 16, 3, 1, 0, 1, 1},   // Winograd, no padding
+        {1, 5, 8, 24, 17, 3, 1, 2, 1, 1},   // Winograd, wide padding
+        {1, 11, 10, 13, 13, 5, 2, 2, 1, 13}, // depthwise 5x5 / 2
+        {2, 8, 8, 24, 24, 3, 1, 2, 2, 24},  // depthwise dilated
+    };
+    enum PicoConvAlgo want[] = {PICO_CONV_WINOGRAD, PICO_CONV_WINOGRAD, PICO_CONV_WINOGRAD,
+                                PICO_CONV_DEPTHWISE, PICO_CONV_DEPTHWISE};
+    bool avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    SimdLevel saved = g_simd_level;
+    for(size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        struct conv_case cc = cases[i];
+        struct PicoConvShape s = {.n = cc.n, .h = cc.h, .w = cc.w, .c = cc.c, .oc = cc.oc,
+                                  .k = cc.k, .stride = cc.stride, .pad = cc.pad,
+                                  .dilation = cc.dilation, .groups = cc.groups};
+        s.oh = pico_conv_out_size(s.h, s.k, s.stride, s.pad, s.dilation);
+        s.ow = pico_conv_out_size(s.w, s.k, s.stride, s.pad, s.dilation);
+        enum PicoConvAlgo algo = pico_conv_select(&s);
+        ASSERT_EQ(algo, want[i]);
+
+        int64_t xn = s.n * s.h * s.w * s.c, yn = s.n * s.oh * s.ow * s.oc;
+        int64_t wn = s.k * s.k * (s.c / s.groups) * s.oc;
+        float* x = malloc(sizeof(float) * xn);
+        float* w = malloc(sizeof(float) * wn);
+        float* b = malloc(sizeof(float) * s.oc);
+        for(int64_t j = 0; j < xn; j++) x[j] = test_wave(j, 1.0f);
+        for(int64_t j = 0; j < wn; j++) w[j] = test_wave(j * 5 + 1, 0.3f);
+        for(int64_t j = 0; j < s.oc; j++) b[j] = test_wave(j * 3 + 2, 0.2f);
+        float* ref = malloc(sizeof(float) * yn);
+        float* got = malloc(sizeof(float) * yn);
+        float* scratch = malloc(sizeof(float) * (pico_conv_scratch_floats(&s, PICO_CONV_IM2COL) +
+                                                 pico_conv_scratch_floats(&s, algo) + 1));
+
+        for(int relu = 0; relu < 2; relu++) {
+            enum PicoActivation act = relu ? PICO_ACT_RELU : PICO_ACT_NONE;
+            g_simd_level = SIMD_NONE;
+            pico_conv2d_cpu(x, w, b, ref, &s, act, PICO_CONV_IM2COL, scratch);
+            for(int level = 0; level < (avx2 ? 2 : 1); level++) {
+                g_simd_level = level == 0 ? SIMD_NONE : SIMD_AVX2;
+                memset(got, 0xff, sizeof(float) * yn);  // every output must be written
+                pico_conv2d_cpu(x, w, b, got, &s, act, algo, scratch);
+                int ok = 1;
+                for(int64_t j = 0; j < yn; j++) ok &= test_near(got[j], ref[j], 1e-4f);
+                g_simd_level = saved;
+                ASSERT_TRUE(ok);
+            }
+        }
+        g_simd_level = saved;
+
+        free(x);
+        free(w);
+        free(b);
+        free(ref);
+        free(got);
+        free(scratch);
+    }
+}
+
+// relu fused into the epilogue, and its gate in the backward; an input that doesn't
+// need a grad gets none written
+UTEST(conv2d, relu_and_constant_input) {
+    struct Arena* ar = arena_init(1 << 18);
+    arena_ctx_push(ar);
+    struct PicoConv2d* conv = pico_nn_conv2d_init(4, 6, 3, 1, 1, 1, 1, true);
+    int64_t xs[] = {1, 5, 5, 4};
+    struct PicoTensor* x = pico_param(xs, 4);
+    for(int64_t i = 0; i < x->numel; i++) x->data[i] = test_wave(i, 1.0f);
+
+    struct PicoTensor* plain = pico_nn_conv2d_forward(conv, x);
+    struct PicoTensor* relu = pico_nn_conv2d_forward_act(conv, x, PICO_ACT_RELU);
+    int negatives = 0;
+    for(int64_t i = 0; i < plain->numel; i++) {
+        ASSERT_EQ(relu->data[i], fmaxf(plain->data[i], 0.0f));
+        negatives += plain->data[i] < 0;
+    }
+    ASSERT_GT(negatives, 0);
+
+    // d sum(relu) / db[o] = the number of positive outputs in channel o
+    x->requires_grad = 0;
+    pico_backward(ar, pico_sum(relu, NULL, 0, false));
+    for(int o = 0; o < 6; o++) {
+        float positive = 0.0f;
+        for(int64_t i = o; i < relu->numel; i += 6) positive += relu->data[i] > 0;
+        ASSERT_EQ(conv->bias->grad[o], positive);
+    }
+    for(int64_t i = 0; i < x->numel; i++) ASSERT_EQ(x->grad[i], 0.0f);
+
+    int64_t bad[] = {1, 5, 5, 3};
+    struct PicoTensor* wrong = pico_param(bad, 4);
+    ASSERT_TRUE(pico_nn_conv2d_forward(conv, wrong) == NULL);
+    int64_t tiny[] = {1, 1, 1, 4};
+    struct PicoConv2d* big = pico_nn_conv2d_init(4, 4, 5, 1, 1, 1, 1, false);
+    struct PicoTensor* small = pico_param(tiny, 4);
+    ASSERT_TRUE(pico_nn_conv2d_forward(big, small) == NULL);
+
+    pico_free(x);
+    pico_free(wrong);
+    pico_free(small);
+    pico_nn_conv2d_free(conv);
+    pico_nn_conv2d_free(big);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
@@ -0,0 +1,228 @@
+/*
+ * Tests for the PicoEmbedding layer (nn/embedding.h): the row gather, the dense and
+ * the sparse backward agreeing (repeated ids, two uses in one graph, two backwards
+ * accumulating), ids given as strided and expanded views, and the optimizers' sparse
+ * path against the dense one.
+ * NOTE: no UTEST_MAIN here, test_basic.c owns main + UTEST_STATE.
+ */
+#include <math.h>
+#include <stdbool.h>
+
+#include "arena.h"
+#include "global.h"
+#include "nn/embedding.h"
+#include "ops.h"
+#include "optim/optim.h"
+#include "reduce/reduce.h"
+#include "tensor.h"
+#include "utest.h"
+#include "view/view.h"
+
+#define VOCAB 50
+#define DIM 12
+
+static struct PicoTensor* make_ids(struct Arena* ar, int64_t n, int64_t mul) {
+    int64_t s[] = {n};
+    struct PicoTensor* ids = pico_create_tensor(ar, s, 1);
+    for(int64_t i = 0; i < n; i++) ids->data[i] = (float)((i * mul + 3) % 17);  // repeats
+    ids->requires_grad = 0;
+    return ids;
+}
+
+// sum(emb(a) * w) + sum(emb(b)), one backward: each table row's grad is the sum over
+// the positions that read it
+static void run_backward(struct Arena* ar, struct PicoEmbedding* emb, struct PicoTensor* a,
+                         struct PicoTensor* b) {
+    struct PicoTensor* ya = pico_nn_embedding_forward(emb, a);
+    struct PicoTensor* w = pico_create_tensor(ar, ya->shape, ya->ndim);
+    for(int64_t i = 0; i < w->numel; i++) w->data[i] = 0.01f * (float)(i % 23) - 0.1f;
+    struct PicoTensor* loss = pico_add(pico_sum(pico_mul(ya, w), NULL, 0, false),
+                                       pico_sum(pico_nn_embedding_forward(emb, b), NULL, 0, false));
+    pico_backward(ar, loss);
+}
+
+UTEST(embedding, gather) {
+    pico_init();
+    struct Arena* ar = arena_init(1 << 22);
+    arena_ctx_push(ar);
+    struct PicoEmbedding* emb = pico_nn_embedding_init(VOCAB, DIM, false);
+    ASSERT_TRUE(emb != NULL);
+
+    int64_t s[] = {3, 1000};  // 36000 floats out: the gather splits across threads
+    struct PicoTensor* ids = pico_create_tensor(ar, s, 2);
+    for(int64_t i = 0; i < ids->numel; i++) ids->data[i] = (float)((i * 7) % VOCAB);
+    struct PicoTensor* y = pico_nn_embedding_forward(emb, ids);
+    ASSERT_EQ(y->ndim, 3);
+    ASSERT_EQ(y->shape[1], 1000);
+    ASSERT_EQ(y->shape[2], DIM);
+    int ok = 1;
+    for(int64_t i = 0; i < ids->numel; i++) {
+        for(int j = 0; j < DIM; j++) {
+            ok &= y->data[i * DIM + j] == emb->weights->data[(int64_t)ids->data[i] * DIM + j];
+        }
+    }
+    ASSERT_TRUE(ok);
+
+    ids->data[5] = (float)VOCAB;
+    ASSERT_TRUE(pico_nn_embedding_forward(emb, ids) == NULL);
+    ids->data[5] = 1.5f;
+    ASSERT_TRUE(pico_nn_embedding_forward(emb, ids) == NULL);
+    ASSERT_TRUE(pico_nn_embedding_init(0, DIM, true) == NULL);
+
+    pico_nn_embedding_free(emb);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+// ids that are a view: the range check sees them in logical order, not storage order
+UTEST(embedding, strided_ids) {
+    struct Arena* ar = arena_init(1 << 20);
+    arena_ctx_push(ar);
+    struct PicoEmbedding* emb = pico_nn_embedding_init(VOCAB, DIM, false);
+
+    // a step-2 slice: its 5th id is storage element 8, out of range
+    struct PicoTensor* base = make_ids(ar, 20, 1);
+    base->data[8] = 100000.0f;
+    ASSERT_TRUE(pico_nn_embedding_forward(emb, pico_slice(base, 0, 0, 20, 2)) == NULL);
+    base->data[8] = 4.0f;
+    struct PicoTensor* y = pico_nn_embedding_forward(emb, pico_slice(base, 0, 0, 20, 2));
+    ASSERT_TRUE(y != NULL);
+    ASSERT_EQ(y->data[4 * DIM], emb->weights->data[4 * DIM]);
+
+    // one stored id expanded to 64: every row is row 2
+    int64_t one[] = {1}, many[] = {64};
+    struct PicoTensor* id = pico_create_tensor(ar, one, 1);
+    id->data[0] = 2.0f;
+    id->requires_grad = 0;
+    y = pico_nn_embedding_forward(emb, pico_expand(id, many, 1));
+    ASSERT_TRUE(y != NULL);
+    int ok = 1;
+    for(int64_t i = 0; i < 64 * DIM; i++) ok &= y->data[i] == emb->weights->data[2 * DIM + i % DIM];
+    ASSERT_TRUE(ok);
+
+    pico_nn_embedding_free(emb);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+UTEST(embedding, sparse_grad_matches_dense) {
+    struct Arena* ar = arena_init(1 << 20);
+    arena_ctx_push(ar);
+    struct PicoEmbedding* dense = pico_nn_embedding_init(VOCAB, DIM, false);
+    struct PicoEmbedding* sparse = pico_nn_embedding_init(VOCAB, DIM, true);
+    memcpy(sparse->weights->data, dense->weights->data, sizeof(float) * VOCAB * DIM);
+    ASSERT_TRUE(sparse->weights->grad == NULL);
+
+    // two micro-batches: the second merges into the rows the first left
+    for(int step = 0; step < 2; step++) {
+        struct PicoTensor* a = make_ids(ar, 40, 5 + step);
+        struct PicoTensor* b = make_ids(ar, 9, 11 + 3 * step);
+        run_backward(ar, dense, a, b);
+        run_backward(ar, sparse, a, b);
+    }
+
+    const struct PicoSparseGrad* g = &sparse->grad;
+    ASSERT_GT(g->n, 0);
+    ASSERT_LE(g->n, 17);
+    int ok = 1, listed = 0;
+    for(int64_t k = 0; k < g->n; k++) {
+        if(k > 0) ok &= g->rows[k] > g->rows[k - 1];
+        for(int j = 0; j < DIM; j++) {
+            float want = dense->weights->grad[g->rows[k] * DIM + j];
+            ok &= fabsf(g->values[k * DIM + j] - want) <= 1e-5f;
+        }
+    }
+    // every row off the list has no grad
+    for(int64_t r = 0; r < VOCAB; r++) {
+        bool on_list = false;
+        for(int64_t k = 0; k < g->n; k++) on_list |= g->rows[k] == r;
+        listed += on_list;
+        for(int j = 0; j < DIM && !on_list; j++) ok &= dense->weights->grad[r * DIM + j] == 0.0f;
+    }
+    ASSERT_TRUE(ok);
+    ASSERT_EQ(listed, g->n);
+
+    pico_nn_embedding_free(dense);
+    pico_nn_embedding_free(sparse);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+// one step of each optimizer, dense table vs sparse table. from zero state the first
+// step matches everywhere (a zero grad leaves Adam's row alone too); SGD matches for
+// every step. the sparse list is cleared by zero_grad or by fuse_zero_grad
+UTEST(embedding, sparse_optimizer_steps) {
+    struct Arena* ar = arena_init(1 << 20);
+    arena_ctx_push(ar);
+    for(int kind = 0; kind < 2; kind++) {
+        struct PicoEmbedding* dense = pico_nn_embedding_init(VOCAB, DIM, false);
+        struct PicoEmbedding* sparse = pico_nn_embedding_init(VOCAB, DIM, true);
+        memcpy(sparse->weights->data, dense->weights->data, sizeof(float) * VOCAB * DIM);
+
+        struct PicoOptimSGD* sgd[2] = {NULL, NULL};
+        struct PicoOptim* adam[2] = {NULL, NULL};
+        if(kind == 0) {
+            sgd[0] = pico_optim_sgd_init(0.1f);
+            sgd[1] = pico_optim_sgd_init(0.1f);
+            sgd[1]->fuse_zero_grad = true;
+            pico_optim_sgd_add(sgd[0], dense->weights);
+            pico_optim_sgd_add_sparse(sgd[1], sparse->weights, &sparse->grad);
+        } else {
+            adam[0] = pico_optim_adamw_init(0.01f, 0.9f, 0.999f, 0.1f);
+            adam[1] = pico_optim_adamw_init(0.01f, 0.9f, 0.999f, 0.1f);
+            pico_optim_add(adam[0], dense->weights);
+            pico_optim_add_sparse(adam[1], sparse->weights, &sparse->grad);
+        }
+
+        int steps = kind == 0 ? 3 : 1;
+        for(int t = 0; t < steps; t++) {
+            struct PicoTensor* a = make_ids(ar, 30, 7 + t);
+            struct PicoTensor* b = make_ids(ar, 5, 3);
+            run_backward(ar, dense, a, b);
+            run_backward(ar, sparse, a, b);
+            if(kind == 0) {
+                pico_optim_sgd_step(sgd[0]);
+                pico_optim_sgd_zero_grad(sgd[0]);
+                pico_optim_sgd_step(sgd[1]);
+                ASSERT_EQ(sparse->grad.n, 0);
+            } else {
+                pico_optim_step(adam[0]);
+                pico_optim_step(adam[1]);
+                ASSERT_GT(sparse->grad.n, 0);
+                pico_optim_zero_grad(adam[1]);
+                ASSERT_EQ(sparse->grad.n, 0);
+            }
+            arena_reset(ar);
+        }
+        // AdamW decays only the rows it steps; the dense table decays every row
+        int ok = 1;
+        for(int64_t i = 0; i < VOCAB * DIM; i++) {
+            float d = dense->weights->data[i], s = sparse->weights->data[i];
+            ok &= kind == 0 ? fabsf(d - s) <= 1e-6f
+                            : fabsf(d - s) <= 1e-6f || fabsf(d - s * (1.0f - 0.001f)) <= 1e-6f;
+        }
+        ASSERT_TRUE(ok);
+
+        if(kind == 0) {
+            pico_optim_sgd_free(sgd[0]);
+            pico_optim_sgd_free(sgd[1]);
+        } else {
+            pico_optim_free(adam[0]);
+            pico_optim_free(adam[1]);
+        }
+        pico_nn_embedding_free(dense);
+        pico_nn_embedding_free(sparse);
+    }
+
+    // a sparse grad must match the param's row width
+    struct PicoEmbedding* emb = pico_nn_embedding_init(VOCAB, DIM, true);
+    struct PicoSparseGrad wrong = {.dim = DIM + 1};
+    struct PicoOptimSGD* opt = pico_optim_sgd_init(0.1f);
+    pico_optim_sgd_add_sparse(opt, emb->weights, &wrong);
+    ASSERT_EQ(opt->params.size, 0);
+    pico_optim_sgd_free(opt);
+    pico_nn_embedding_free(emb);
+
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
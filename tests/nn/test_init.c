@@ -0,0 +1,196 @@
+/*
+ * Tests for the weight initializers (nn/init.h): fans, the bounds and moments of each
+ * scheme, truncation, reproducible seeding, half params, and Linear's default.
+ * NOTE: no UTEST_MAIN here, test_basic.c owns main + UTEST_STATE.
+ */
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+#include "nn/init.h"
+#include "nn/linear.h"
+#include "rng/rng.h"
+#include "tensor.h"
+#include "utest.h"
+
+static void moments(const struct PicoTensor* t, double* mean, double* std, float* lo,
+                    float* hi) {
+    double s = 0.0, s2 = 0.0;
+    *lo = INFINITY;
+    *hi = -INFINITY;
+    for(int64_t i = 0; i < t->numel; i++) {
+        float v = pico_tensor_get(t, i);
+        s += v;
+        s2 += (double)v * v;
+        if(v < *lo) *lo = v;
+        if(v > *hi) *hi = v;
+    }
+    *mean = s / t->numel;
+    *std = sqrt(s2 / t->numel - *mean * *mean);
+}
+
+UTEST(nn_init, fans) {
+    int64_t s2[] = {300, 200};
+    int64_t s4[] = {3, 3, 16, 32};  // a conv kernel: kh, kw, in, out
+    int64_t s1[] = {7};
+    struct PicoTensor* a = pico_param(s2, 2);
+    struct PicoTensor* b = pico_param(s4, 4);
+    struct PicoTensor* c = pico_param(s1, 1);
+    int64_t fi, fo;
+    pico_nn_init_fans(a, &fi, &fo);
+    ASSERT_EQ(fi, 300);
+    ASSERT_EQ(fo, 200);
+    pico_nn_init_fans(b, &fi, &fo);
+    ASSERT_EQ(fi, 3 * 3 * 16);
+    ASSERT_EQ(fo, 3 * 3 * 32);
+    pico_nn_init_fans(c, &fi, &fo);
+    ASSERT_EQ(fi, 7);
+    ASSERT_EQ(fo, 7);
+    pico_free(a);
+    pico_free(b);
+    pico_free(c);
+}
+
+// every value inside the bound, and the moments of U(-b, b): mean 0, std b / sqrt(3)
+UTEST(nn_init, uniform_schemes) {
+    int64_t shape[] = {512, 256};
+    struct PicoTensor* w = pico_param(shape, 2);
+    double mean, std;
+    float lo, hi;
+
+    pico_nn_init_xavier_uniform(w, 1.0f);
+    float bound = sqrtf(6.0f / (512 + 256));
+    moments(w, &mean, &std, &lo, &hi);
+    ASSERT_TRUE(lo >= -bound && hi <= bound);
+    ASSERT_LT(fabs(mean), 0.01 * bound);
+    ASSERT_LT(fabs(std - bound / sqrt(3.0)), 0.01 * bound);
+
+    pico_nn_init_kaiming_uniform(w, PICO_FAN_IN, pico_nn_init_gain(PICO_ACT_RELU));
+    bound = sqrtf(2.0f) * sqrtf(3.0f / 512);
+    moments(w, &mean, &std, &lo, &hi);
+    ASSERT_TRUE(lo >= -bound && hi <= bound);
+    ASSERT_LT(fabs(std - bound / sqrt(3.0)), 0.01 * bound);
+
+    pico_nn_init_uniform(w, 2.0f, 5.0f);
+    moments(w, &mean, &std, &lo, &hi);
+    ASSERT_TRUE(lo >= 2.0f && hi <= 5.0f);
+    ASSERT_LT(fabs(mean - 3.5), 0.02);
+
+    pico_nn_init_constant(w, 0.25f);
+    moments(w, &mean, &std, &lo, &hi);
+    ASSERT_EQ(lo, 0.25f);
+    ASSERT_EQ(hi, 0.25f);
+    pico_free(w);
+}
+
+UTEST(nn_init, normal_schemes) {
+    int64_t shape[] = {512, 256};
+    struct PicoTensor* w = pico_param(shape, 2);
+    double mean, std;
+    float lo, hi;
+
+    pico_nn_init_xavier_normal(w, 1.0f);
+    double want = sqrt(2.0 / (512 + 256));
+    moments(w, &mean, &std, &lo, &hi);
+    ASSERT_LT(fabs(mean), 0.01 * want);
+    ASSERT_LT(fabs(std - want), 0.01 * want);
+
+    pico_nn_init_kaiming_normal(w, PICO_FAN_OUT, 1.0f);
+    want = 1.0 / sqrt(256.0);
+    moments(w, &mean, &std, &lo, &hi);
+    ASSERT_LT(fabs(std - want), 0.01 * want);
+
+    pico_nn_init_normal(w, -1.0f, 0.5f);
+    moments(w, &mean, &std, &lo, &hi);
+    ASSERT_LT(fabs(mean + 1.0), 0.01);
+    ASSERT_LT(fabs(std - 0.5), 0.01);
+    pico_free(w);
+}
+
+// truncation to [a, b]: nothing outside, and the moments of the truncated normal.
+// N(0, 1) on [-2, 2] has std 0.8796; on [0, 3] (one-sided) mean 0.7868
+UTEST(nn_init, trunc_normal) {
+    int64_t shape[] = {1 << 18};
+    struct PicoTensor* w = pico_param(shape, 1);
+    double mean, std;
+    float lo, hi;
+
+    pico_nn_init_trunc_normal(w, 0.0f, 1.0f, -2.0f, 2.0f);
+    moments(w, &mean, &std, &lo, &hi);
+    ASSERT_TRUE(lo >= -2.0f && hi <= 2.0f);
+    ASSERT_LT(fabs(mean), 0.01);
+    ASSERT_LT(fabs(std - 0.8796), 0.01);
+
+    pico_nn_init_trunc_normal(w, 0.0f, 1.0f, 0.0f, 3.0f);
+    moments(w, &mean, &std, &lo, &hi);
+    ASSERT_TRUE(lo >= 0.0f && hi <= 3.0f);
+    ASSERT_LT(fabs(mean - 0.7868), 0.01);
+
+    // a window far out in the tail still lands inside it
+    pico_nn_init_trunc_normal(w, 0.0f, 0.02f, 0.1f, 0.2f);
+    moments(w, &mean, &std, &lo, &hi);
+    ASSERT_TRUE(lo >= 0.1f && hi <= 0.2f);
+    pico_free(w);
+}
+
+// the same seed gives the same weights; bad arguments leave the tensor alone
+UTEST(nn_init, seeded_and_validated) {
+    int64_t shape[] = {100, 33};
+    struct PicoTensor* a = pico_param(shape, 2);
+    struct PicoTensor* b = pico_param(shape, 2);
+    pico_rng_seed(1234);
+    pico_nn_init_kaiming_normal(a, PICO_FAN_IN, 1.0f);
+    pico_rng_seed(1234);
+    pico_nn_init_kaiming_normal(b, PICO_FAN_IN, 1.0f);
+    ASSERT_EQ(memcmp(a->data, b->data, sizeof(float) * a->numel), 0);
+
+    // a constant fill (a zeroed bias) doesn't draw, so it can't shift the fills after it
+    pico_rng_seed(1234);
+    pico_nn_init_constant(b, 0.0f);
+    ASSERT_EQ(g_pico_rng.offset, 0u);
+    pico_nn_init_kaiming_normal(b, PICO_FAN_IN, 1.0f);
+    ASSERT_EQ(memcmp(a->data, b->data, sizeof(float) * a->numel), 0);
+
+    pico_nn_init_constant(a, 3.0f);
+    pico_nn_init_trunc_normal(a, 0.0f, 1.0f, 1.0f, -1.0f);
+    pico_nn_init_normal(a, 0.0f, -1.0f);
+    ASSERT_EQ(a->data[0], 3.0f);
+    ASSERT_EQ(a->data[a->numel - 1], 3.0f);
+    pico_free(a);
+    pico_free(b);
+}
+
+// a bf16 param gets the fp32 draw rounded once: the same values as an fp32 param filled
+// from the same seed, to bf16 precision
+UTEST(nn_init, half_params) {
+    int64_t shape[] = {64, 48};
+    struct PicoTensor* h = pico_param_dtype(shape, 2, PICO_BF16);
+    struct PicoTensor* f = pico_param(shape, 2);
+    pico_rng_seed(99);
+    pico_nn_init_xavier_uniform(h, 1.0f);
+    pico_rng_seed(99);
+    pico_nn_init_xavier_uniform(f, 1.0f);
+    for(int64_t i = 0; i < f->numel; i++) {
+        ASSERT_EQ(pico_tensor_get(h, i), pico_bf16_to_f32(pico_f32_to_bf16(f->data[i])));
+    }
+    pico_free(h);
+    pico_free(f);
+}
+
+UTEST(nn_init, linear_default_is_not_zero) {
+    struct Arena* ar = arena_init(1 << 16);
+    arena_ctx_push(ar);
+    struct PicoLinear* fc = pico_nn_linear_init(64, 16, true);
+    double mean, std;
+    float lo, hi;
+    moments(fc->weights, &mean, &std, &lo, &hi);
+    ASSERT_TRUE(lo >= -0.125f && hi <= 0.125f);
+    ASSERT_GT(std, 0.05);
+    moments(fc->bias, &mean, &std, &lo, &hi);
+    ASSERT_TRUE(lo >= -0.125f && hi <= 0.125f);
+    ASSERT_LT(lo, hi);
+    pico_nn_linear_free(fc);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
@@ -15,8 +15,13 @@
  */
 #include <stdbool.h>
 
+#include <math.h>
+
+#include "act/activations.h"
 #include "arena.h"
+#include "global.h"
 #include "loss/loss.h"
+#include "nn/init.h"
 #include "nn/linear.h"
 #include "optim/optim.h"
 #include "ops.h"
@@ -263,7 +268,9 @@ UTEST(linear, backward_populates_grads) {
     struct Arena* ar = arena_init(1 << 16);
     arena_ctx_push(ar);
 
-    struct PicoLinear* fc = pico_nn_linear_init(2, 1, true);  // W,b start at 0 (calloc)
+    struct PicoLinear* fc = pico_nn_linear_init(2, 1, true);
+    pico_nn_init_constant(fc->weights, 0.0f);
+    pico_nn_init_constant(fc->bias, 0.0f);
 
     int64_t si[] = {1, 2};
     struct PicoTensor* x = pico_param(si, 2);
@@ -299,6 +306,8 @@ UTEST(linear, trains_one_step_lowers_loss) {
     arena_ctx_push(ar);
 
     struct PicoLinear* fc = pico_nn_linear_init(2, 1, true);
+    pico_nn_init_constant(fc->weights, 0.0f);
+    pico_nn_init_constant(fc->bias, 0.0f);
 
     int64_t si[] = {1, 2};
     struct PicoTensor* x = pico_param(si, 2);
@@ -381,3 +390,84 @@ UTEST(linear, trains_converges) {
     arena_ctx_pop();
     arena_destroy(ar);
 }
+
+// ---- fused forward: act(x @ W + b) in the GEMM epilogue ---------------------
+
+// fill a layer + input with small deterministic values (some outputs go negative,
+// so relu actually gates something)
+static void linear_fill(struct PicoLinear* fc, struct PicoTensor* x) {
+    for(int64_t i = 0; i < fc->weights->numel; i++)
+        fc->weights->data[i] = (float)((i % 7) - 3) * 0.25f;
+    for(int64_t i = 0; i < fc->bias->numel; i++) fc->bias->data[i] = (float)((i % 3) - 1) * 0.5f;
+    for(int64_t i = 0; i < x->numel; i++) x->data[i] = (float)((i % 5) - 2) * 0.5f;
+}
+
+// fused relu forward + backward == the unfused matmul -> add -> relu chain
+UTEST(linear, fused_relu_matches_unfused_chain) {
+    struct Arena* ar = arena_init(1 << 18);
+    arena_ctx_push(ar);
+
+    struct PicoLinear* fc = pico_nn_linear_init(5, 11, true);
+    int64_t si[] = {3, 5};
+    struct PicoTensor* x = pico_param(si, 2);
+    linear_fill(fc, x);
+
+    struct PicoTensor* fused = pico_nn_linear_forward_act(fc, x, PICO_ACT_RELU);
+    struct PicoTensor* chain = pico_relu(pico_add(pico_matmul(x, fc->weights), fc->bias));
+    ASSERT_EQ(fused->numel, chain->numel);
+    for(int64_t i = 0; i < fused->numel; i++) ASSERT_TRUE(fused->data[i] == chain->data[i]);
+
+    // grads through the fused node, saved, then through the chain
+    pico_backward(ar, fused);
+    float w_grad[55], b_grad[11], x_grad[15];
+    memcpy(w_grad, fc->weights->grad, sizeof(w_grad));
+    memcpy(b_grad, fc->bias->grad, sizeof(b_grad));
+    memcpy(x_grad, x->grad, sizeof(x_grad));
+    memset(fc->weights->grad, 0, sizeof(w_grad));
+    memset(fc->bias->grad, 0, sizeof(b_grad));
+    memset(x->grad, 0, sizeof(x_grad));
+    pico_backward(ar, chain);
+
+    for(int i = 0; i < 55; i++) ASSERT_TRUE(fabsf(w_grad[i] - fc->weights->grad[i]) < 1e-5f);
+    for(int i = 0; i < 11; i++) ASSERT_TRUE(fabsf(b_grad[i] - fc->bias->grad[i]) < 1e-5f);
+    for(int i = 0; i < 15; i++) ASSERT_TRUE(fabsf(x_grad[i] - x->grad[i]) < 1e-5f);
+
+    pico_free(x);
+    pico_nn_linear_free(fc);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+// forced AVX epilogue: 13 rows x 19 cols exercises the 8/4/1-row microkernels plus
+// the scalar column tail, all of which must apply bias + relu before the store
+UTEST(linear, fused_relu_avx_epilogue_matches_scalar) {
+    if(!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("fma")) return;
+
+    SimdLevel saved = g_simd_level;
+    pico_init();
+
+    struct Arena* ar = arena_init(1 << 18);
+    arena_ctx_push(ar);
+
+    struct PicoLinear* fc = pico_nn_linear_init(6, 19, true);
+    int64_t si[] = {13, 6};
+    struct PicoTensor* x = pico_param(si, 2);
+    linear_fill(fc, x);
+
+    g_simd_level = SIMD_NONE;
+    struct PicoTensor* ref = pico_nn_linear_forward_act(fc, x, PICO_ACT_RELU);
+    g_simd_level = SIMD_AVX;
+    struct PicoTensor* out = pico_nn_linear_forward_act(fc, x, PICO_ACT_RELU);
+    g_simd_level = saved;
+
+    float max_diff = 0.0f;
+    for(int64_t i = 0; i < out->numel; i++)
+        max_diff = fmaxf(max_diff, fabsf(out->data[i] - ref->data[i]));
+
+    pico_free(x);
+    pico_nn_linear_free(fc);
+    arena_ctx_pop();
+    arena_destroy(ar);
+
+    ASSERT_TRUE(max_diff < 1e-5f);
+}
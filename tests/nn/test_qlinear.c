@@ -0,0 +1,189 @@
+/*
+ * Tests for the int8 Linear (pico_qlinear_*): per-channel weight quantization, the
+ * forward against the fp32 layer it came from, bit-identical outputs across the
+ * scalar / AVX2 / AVX-512 VNNI GEMMs, and calibrated (fixed) activation scales.
+ * NOTE: no UTEST_MAIN here, test_basic.c owns main + UTEST_STATE.
+ */
+#include <math.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "arena.h"
+#include "global.h"
+#include "kernels/cpu_kernels.h"
+#include "nn/linear.h"
+#include "nn/qlinear.h"
+#include "tensor.h"
+#include "utest.h"
+
+// deterministic, sign-mixed values with a different range per column
+static void qlinear_fill(struct PicoLinear* fc) {
+    int64_t N = fc->out_features;
+    for(int64_t i = 0; i < fc->weights->numel; i++) {
+        float range = 0.05f + 0.1f * (float)(i % N);
+        fc->weights->data[i] = range * (float)((i * 37 + 5) % 19 - 9) / 9.0f;
+    }
+    if(fc->bias != NULL) {
+        for(int64_t j = 0; j < N; j++) fc->bias->data[j] = 0.1f * (float)(j % 5) - 0.2f;
+    }
+}
+
+static struct PicoTensor* qlinear_input(int64_t M, int64_t K) {
+    int64_t shape[] = {M, K};
+    struct PicoTensor* x = pico_create_tensor(arena_ctx_current(), shape, 2);
+    for(int64_t i = 0; i < x->numel; i++) x->data[i] = (float)((i * 13 + 3) % 29 - 14) / 7.0f;
+    return x;
+}
+
+// every packed weight dequantizes to within half a step of the original, and the
+// padding past K / past N stays zero
+UTEST(qlinear, per_channel_weights) {
+    struct Arena* ar = arena_init(1 << 16);
+    arena_ctx_push(ar);
+    struct PicoLinear* fc = pico_nn_linear_init(70, 6, true);
+    qlinear_fill(fc);
+    struct PicoQLinear* q = pico_qlinear_from_linear(fc);
+    ASSERT_TRUE(q != NULL);
+    ASSERT_EQ(q->k_pad % PICO_QGEMM_KALIGN, 0);
+    ASSERT_TRUE(q->k_pad >= 70);
+
+    for(int64_t j = 0; j < 6; j++) {
+        float maxw = 0.0f;
+        int32_t sum = 0;
+        for(int64_t k = 0; k < 70; k++) {
+            float w = fc->weights->data[k * 6 + j];
+            float back = q->weights[j * q->k_pad + k] * q->w_scale[j];
+            ASSERT_LE(fabsf(back - w), 0.5f * q->w_scale[j] + 1e-6f);
+            maxw = fmaxf(maxw, fabsf(w));
+            sum += q->weights[j * q->k_pad + k];
+        }
+        ASSERT_NEAR(q->w_scale[j], maxw / 127.0f, 1e-7f);
+        ASSERT_EQ(q->w_sum[j], sum);
+        for(int64_t k = 70; k < q->k_pad; k++) ASSERT_EQ(q->weights[j * q->k_pad + k], 0);
+    }
+    for(int64_t k = 0; k < q->k_pad; k++) ASSERT_EQ(q->weights[6 * q->k_pad + k], 0);
+
+    pico_qlinear_free(q);
+    pico_nn_linear_free(fc);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+// int8 forward tracks the fp32 layer, with and without the fused relu
+UTEST(qlinear, forward_matches_fp32) {
+    struct Arena* ar = arena_init(1 << 18);
+    arena_ctx_push(ar);
+    struct PicoLinear* fc = pico_nn_linear_init(96, 10, true);
+    qlinear_fill(fc);
+    struct PicoQLinear* q = pico_qlinear_from_linear(fc);
+    struct PicoTensor* x = qlinear_input(7, 96);
+
+    enum PicoActivation acts[] = {PICO_ACT_NONE, PICO_ACT_RELU};
+    for(int a = 0; a < 2; a++) {
+        struct PicoTensor* ref = pico_nn_linear_forward_act(fc, x, acts[a]);
+        struct PicoTensor* out = pico_qlinear_forward_act(q, x, acts[a]);
+        ASSERT_TRUE(out != NULL);
+        ASSERT_EQ(out->shape[0], 7);
+        ASSERT_EQ(out->shape[1], 10);
+        ASSERT_EQ(out->num_parents, 0);
+        ASSERT_EQ(out->requires_grad, 0);
+        float max_ref = 0.0f, max_err = 0.0f;
+        for(int64_t i = 0; i < ref->numel; i++) {
+            max_ref = fmaxf(max_ref, fabsf(ref->data[i]));
+            max_err = fmaxf(max_err, fabsf(out->data[i] - ref->data[i]));
+            if(acts[a] == PICO_ACT_RELU) ASSERT_GE(out->data[i], 0.0f);
+        }
+        ASSERT_LT(max_err, 0.02f * max_ref);
+    }
+
+    pico_qlinear_free(q);
+    pico_nn_linear_free(fc);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+// the int32 sums are exact at every level, so the outputs match bit for bit. odd M,
+// K and N exercise the row / column / K padding
+UTEST(qlinear, simd_levels_bit_identical) {
+    struct Arena* ar = arena_init(1 << 20);
+    arena_ctx_push(ar);
+    struct PicoLinear* fc = pico_nn_linear_init(203, 37, true);
+    qlinear_fill(fc);
+    struct PicoQLinear* q = pico_qlinear_from_linear(fc);
+    struct PicoTensor* x = qlinear_input(9, 203);
+
+    SimdLevel saved = g_simd_level;
+    g_simd_level = SIMD_NONE;
+    struct PicoTensor* ref = pico_qlinear_forward_act(q, x, PICO_ACT_RELU);
+    struct PicoTensor* avx2 = NULL;
+    struct PicoTensor* avx512 = NULL;
+    if(__builtin_cpu_supports("avx2")) {
+        g_simd_level = SIMD_AVX2;
+        avx2 = pico_qlinear_forward_act(q, x, PICO_ACT_RELU);
+    }
+    if(__builtin_cpu_supports("avx512f")) {
+        g_simd_level = SIMD_AVX512;
+        avx512 = pico_qlinear_forward_act(q, x, PICO_ACT_RELU);
+    }
+    g_simd_level = saved;
+
+    if(avx2 != NULL) ASSERT_EQ(memcmp(ref->data, avx2->data, sizeof(float) * ref->numel), 0);
+    if(avx512 != NULL) ASSERT_EQ(memcmp(ref->data, avx512->data, sizeof(float) * ref->numel), 0);
+
+    pico_qlinear_free(q);
+    pico_nn_linear_free(fc);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+// the SIMD quantizer rounds (ties to even) and clamps exactly like the scalar one
+UTEST(qlinear, quantize_matches_scalar) {
+    if(!__builtin_cpu_supports("avx2")) return;
+    float x[100];
+    int8_t want[100], got[100];
+    for(int i = 0; i < 100; i++) x[i] = (float)(i - 50) * 0.25f;  // many exact .5 ties
+    x[7] = NAN;
+    x[8] = 1e9f;
+    pico_quantize_s8_scalar(x, want, 100, 2.0f);
+    pico_quantize_s8_avx2(x, got, 100, 2.0f);
+    ASSERT_EQ(memcmp(want, got, sizeof(want)), 0);
+    ASSERT_EQ(pico_absmax_avx2(x, 100), pico_absmax_scalar(x, 100));
+    ASSERT_EQ(want[8], 127);
+}
+
+// calibration fixes one scale for every row: a row's output no longer depends on its
+// own range, and inputs past the calibrated range clip
+UTEST(qlinear, calibrated_scale) {
+    struct Arena* ar = arena_init(1 << 16);
+    arena_ctx_push(ar);
+    struct PicoLinear* fc = pico_nn_linear_init(8, 1, false);
+    for(int k = 0; k < 8; k++) fc->weights->data[k] = 1.0f;
+    struct PicoQLinear* q = pico_qlinear_from_linear(fc);
+
+    struct PicoTensor* calib = qlinear_input(4, 8);
+    for(int64_t i = 0; i < calib->numel; i++) calib->data[i] = 0.0f;
+    calib->data[3] = -2.0f;
+    pico_qlinear_calibrate(q, calib);
+    calib->data[3] = 1.5f;
+    pico_qlinear_calibrate(q, calib);  // keeps the running max
+    ASSERT_EQ(q->act_absmax, 2.0f);
+
+    // row 0 all 1.0 -> exact; row 1 is 4.0 everywhere -> clipped to 2.0
+    struct PicoTensor* x = qlinear_input(2, 8);
+    for(int k = 0; k < 8; k++) {
+        x->data[k] = 1.0f;
+        x->data[8 + k] = 4.0f;
+    }
+    struct PicoTensor* out = pico_qlinear_forward(q, x);
+    ASSERT_NEAR(out->data[0], 8.0f, 0.1f);
+    ASSERT_NEAR(out->data[1], 16.0f, 1e-3f);
+
+    q->act_absmax = 0.0f;  // back to per-row scales: no clipping
+    out = pico_qlinear_forward(q, x);
+    ASSERT_NEAR(out->data[1], 32.0f, 1e-3f);
+
+    pico_qlinear_free(q);
+    pico_nn_linear_free(fc);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
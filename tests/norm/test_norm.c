@@ -0,0 +1,156 @@
+/*
+ * Tests for pico_layernorm / pico_rmsnorm (norm/norm.h). Every grad of sum(y * dy)
+ * is checked against per-row mean / variance taken in double, for both norms with and
+ * without weight / bias; row widths 1 and 37 leave Welford remainders and masked tails.
+ * Rows sitting on 1e4 check the variance doesn't cancel, and params of the wrong
+ * length are refused.
+ * NOTE: no UTEST_MAIN here, test_basic.c owns main + UTEST_STATE.
+ */
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "arena.h"
+#include "global.h"
+#include "norm/norm.h"
+#include "ops.h"
+#include "reduce/reduce.h"
+#include "tensor.h"
+#include "test_common.h"
+#include "utest.h"
+
+// y and the grads of sum(y * dy) by definition, in double. w / b may be NULL
+static void norm_reference(const float* x, const float* w, const float* b, const float* dy,
+                           bool center, float eps, int64_t rows, int64_t n, double* y,
+                           double* dx, double* dw, double* db) {
+    for(int64_t r = 0; r < rows; r++) {
+        const float* xr = x + r * n;
+        const float* gr = dy + r * n;
+        double mean = 0.0, var = 0.0;
+        if(center) {
+            for(int64_t j = 0; j < n; j++) mean += xr[j];
+            mean /= (double)n;
+        }
+        for(int64_t j = 0; j < n; j++) var += (xr[j] - mean) * (xr[j] - mean);
+        double rstd = 1.0 / sqrt(var / (double)n + eps);
+        double sg = 0.0, sgx = 0.0;
+        for(int64_t j = 0; j < n; j++) {
+            double xh = (xr[j] - mean) * rstd;
+            double g = gr[j] * (w != NULL ? w[j] : 1.0);
+            y[r * n + j] = xh * (w != NULL ? w[j] : 1.0) + (b != NULL ? b[j] : 0.0);
+            dw[j] += gr[j] * xh;
+            db[j] += gr[j];
+            sg += g;
+            sgx += g * xh;
+        }
+        for(int64_t j = 0; j < n; j++) {
+            double xh = (xr[j] - mean) * rstd;
+            double g = gr[j] * (w != NULL ? w[j] : 1.0);
+            dx[r * n + j] = rstd * (g - (center ? sg / n : 0.0) - xh * sgx / n);
+        }
+    }
+}
+
+// the op against the reference at the current SIMD level
+static int check_norm(int64_t rows, int64_t n, bool center, bool affine) {
+    struct Arena* ar = arena_init(1 << 22);
+    arena_ctx_push(ar);
+    int64_t xs[] = {rows, n}, ps[] = {n};
+    struct PicoTensor* x = pico_param(xs, 2);
+    struct PicoTensor* w = affine ? pico_param(ps, 1) : NULL;
+    struct PicoTensor* b = affine && center ? pico_param(ps, 1) : NULL;
+    for(int64_t i = 0; i < x->numel; i++)
+        x->data[i] = test_wave(i, 2.0f) + 0.5f * (float)(i / n % 3);
+    for(int64_t j = 0; affine && j < n; j++) {
+        w->data[j] = 1.0f + test_wave(j * 3 + 1, 0.5f);
+        if(b != NULL) b->data[j] = test_wave(j * 5 + 2, 0.3f);
+    }
+
+    struct PicoTensor* y = center ? pico_layernorm(x, w, b, 1e-5f) : pico_rmsnorm(x, w, 1e-5f);
+    struct PicoTensor* dy = pico_create_tensor(ar, xs, 2);
+    for(int64_t i = 0; i < dy->numel; i++) dy->data[i] = test_wave(i * 7 + 3, 0.5f);
+    pico_backward(ar, pico_sum(pico_mul(y, dy), NULL, 0, false));
+
+    double* ry = calloc(x->numel, sizeof(double));
+    double* rdx = calloc(x->numel, sizeof(double));
+    double* rdw = calloc(n, sizeof(double));
+    double* rdb = calloc(n, sizeof(double));
+    norm_reference(x->data, w != NULL ? w->data : NULL, b != NULL ? b->data : NULL, dy->data,
+                   center, 1e-5f, rows, n, ry, rdx, rdw, rdb);
+
+    int ok = 1;
+    for(int64_t i = 0; i < x->numel; i++) ok &= test_near(y->data[i], ry[i], 1e-5f);
+    for(int64_t i = 0; i < x->numel; i++) ok &= test_near(x->grad[i], rdx[i], 1e-4f);
+    for(int64_t j = 0; w != NULL && j < n; j++) ok &= test_near(w->grad[j], rdw[j], 1e-4f);
+    for(int64_t j = 0; b != NULL && j < n; j++) ok &= test_near(b->grad[j], rdb[j], 1e-4f);
+
+    free(ry);
+    free(rdx);
+    free(rdw);
+    free(rdb);
+    pico_free(x);
+    pico_free(w);
+    pico_free(b);
+    arena_ctx_pop();
+    arena_destroy(ar);
+    return ok;
+}
+
+UTEST(norm, matches_reference) {
+    pico_init();
+    // {rows, n}: one element, a Welford / vector tail, exact vectors, and 600 rows
+    // (36000 elements) to split across threads
+    int64_t shapes[][2] = {{3, 1}, {5, 37}, {4, 64}, {600, 60}};
+    bool avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    SimdLevel saved = g_simd_level;
+    for(int level = 0; level < (avx2 ? 2 : 1); level++) {
+        for(size_t i = 0; i < sizeof(shapes) / sizeof(shapes[0]); i++) {
+            for(int k = 0; k < 4; k++) {
+                g_simd_level = level == 0 ? SIMD_NONE : SIMD_AVX2;
+                int ok = check_norm(shapes[i][0], shapes[i][1], k & 1, k & 2);
+                g_simd_level = saved;
+                ASSERT_TRUE(ok);
+            }
+        }
+    }
+}
+
+// rows sitting on a large offset: E[x²] - E[x]² in fp32 would cancel to garbage,
+// Welford keeps the variance. each row is 1e4 + a unit-variance pattern
+UTEST(norm, welford_large_offset) {
+    struct Arena* ar = arena_init(1 << 16);
+    arena_ctx_push(ar);
+    int64_t xs[] = {2, 200};
+    struct PicoTensor* x = pico_param(xs, 2);
+    for(int64_t i = 0; i < x->numel; i++) x->data[i] = 1e4f + (i % 2 ? 1.0f : -1.0f);
+
+    struct PicoTensor* y = pico_layernorm(x, NULL, NULL, 0.0f);
+    for(int64_t i = 0; i < y->numel; i++) ASSERT_NEAR(y->data[i], i % 2 ? 1.0f : -1.0f, 1e-3f);
+
+    pico_free(x);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+UTEST(norm, shapes_and_refusals) {
+    struct Arena* ar = arena_init(1 << 16);
+    arena_ctx_push(ar);
+    int64_t xs[] = {2, 3, 8}, good[] = {8}, bad[] = {3};
+    struct PicoTensor* x = pico_param(xs, 3);
+    struct PicoTensor* w = pico_param(good, 1);
+    struct PicoTensor* wrong = pico_param(bad, 1);
+    for(int64_t i = 0; i < x->numel; i++) x->data[i] = test_wave(i, 1.0f);
+
+    struct PicoTensor* y = pico_rmsnorm(x, w, 1e-6f);
+    ASSERT_EQ(y->ndim, 3);
+    ASSERT_EQ(y->shape[1], 3);
+    ASSERT_EQ(y->num_parents, 2);
+    ASSERT_TRUE(pico_layernorm(x, wrong, NULL, 1e-5f) == NULL);
+    ASSERT_TRUE(pico_layernorm(x, w, wrong, 1e-5f) == NULL);
+
+    pico_free(x);
+    pico_free(w);
+    pico_free(wrong);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
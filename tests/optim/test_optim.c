@@ -1,12 +1,16 @@
 /*
- * Tests for the SGD optimizer.
+ * Tests for the SGD optimizer and the stateful ones (NAG, AdaGrad, RMSProp, Adam,
+ * AdamW), the latter against a double-precision reference of the textbook update.
  * NOTE: no UTEST_MAIN here, test_basic.c owns main + UTEST_STATE.
- * Values chosen to be exact in float (no 0.1-style rounding) so == is safe.
+ * SGD values chosen to be exact in float (no 0.1-style rounding) so == is safe.
  * TODO(pico): there's no pico_optim_sgd_free yet, so each test frees the
  * optimizer by hand (pico_vec_free + free). Add a free fn and swap these.
  */
+#include <math.h>
+#include <stdint.h>
 #include <stdlib.h>
 
+#include "global.h"
 #include "lib/pico_vector.h"
 #include "optim/optim.h"
 #include "tensor.h"
@@ -90,3 +94,341 @@ UTEST(optim_sgd, step_multiple_params) {
     pico_free(w1);
     pico_free(w2);
 }
+
+// ==================== stateful optimizers
+
+// reference update for one element, straight from the textbook formulas (double)
+struct OptimRef {
+    double p, m, v;
+};
+
+static void optim_ref_step(struct PicoOptim* o, struct OptimRef* r, double g, int t) {
+    double wd = o->kind == PICO_OPTIM_ADAMW ? 0.0 : o->weight_decay;
+    g += wd * r->p;
+    switch(o->kind) {
+        case PICO_OPTIM_NAG:
+            r->m = o->momentum * r->m + g;
+            r->p -= o->lr * (g + o->momentum * r->m);
+            break;
+        case PICO_OPTIM_ADAGRAD:
+            r->m += g * g;
+            r->p -= o->lr * g / (sqrt(r->m) + o->eps);
+            break;
+        case PICO_OPTIM_RMSPROP:
+            r->m = o->alpha * r->m + (1.0 - o->alpha) * g * g;
+            r->p -= o->lr * g / (sqrt(r->m) + o->eps);
+            break;
+        case PICO_OPTIM_ADAM:
+        case PICO_OPTIM_ADAMW: {
+            if(o->kind == PICO_OPTIM_ADAMW) r->p *= 1.0 - o->lr * o->weight_decay;
+            r->m = o->beta1 * r->m + (1.0 - o->beta1) * g;
+            r->v = o->beta2 * r->v + (1.0 - o->beta2) * g * g;
+            double mh = r->m / (1.0 - pow(o->beta1, t));
+            double vh = r->v / (1.0 - pow(o->beta2, t));
+            r->p -= o->lr * mh / (sqrt(vh) + o->eps);
+            break;
+        }
+    }
+}
+
+// 3 steps on a 37-element param (vector body + tail) against the reference
+static double optim_max_err(struct PicoOptim* o) {
+    int64_t s[] = {37};
+    struct PicoTensor* w = pico_param(s, 1);
+    struct OptimRef ref[37];
+    for(int i = 0; i < 37; i++) {
+        w->data[i] = (float)(i % 5) - 2.0f;
+        ref[i] = (struct OptimRef){.p = w->data[i]};
+    }
+    pico_optim_add(o, w);
+
+    double worst = 0.0;
+    for(int t = 1; t <= 3; t++) {
+        for(int i = 0; i < 37; i++) w->grad[i] = (float)((i * 7 + t) % 11) * 0.1f - 0.5f;
+        pico_optim_step(o);
+        for(int i = 0; i < 37; i++) {
+            optim_ref_step(o, &ref[i], w->grad[i], t);
+            worst = fmax(worst, fabs(w->data[i] - ref[i].p));
+        }
+    }
+
+    pico_optim_free(o);
+    pico_free(w);
+    return worst;
+}
+
+UTEST(optim, nag_matches_reference) {
+    ASSERT_TRUE(optim_max_err(pico_optim_nag_init(0.1f, 0.9f)) < 1e-5);
+}
+
+UTEST(optim, adagrad_matches_reference) {
+    ASSERT_TRUE(optim_max_err(pico_optim_adagrad_init(0.1f)) < 1e-5);
+}
+
+UTEST(optim, rmsprop_matches_reference) {
+    struct PicoOptim* o = pico_optim_rmsprop_init(0.01f, 0.99f);
+    o->weight_decay = 0.1f;  // L2 path
+    ASSERT_TRUE(optim_max_err(o) < 1e-5);
+}
+
+UTEST(optim, adam_matches_reference) {
+    ASSERT_TRUE(optim_max_err(pico_optim_adam_init(0.01f, 0.9f, 0.999f)) < 1e-5);
+}
+
+UTEST(optim, adamw_matches_reference) {
+    ASSERT_TRUE(optim_max_err(pico_optim_adamw_init(0.01f, 0.9f, 0.999f, 0.1f)) < 1e-5);
+}
+
+// AdamW's decay is decoupled: with zero grad the param still shrinks by lr*wd
+UTEST(optim, adamw_decay_is_decoupled) {
+    int64_t s[] = {1};
+    struct PicoTensor* w = pico_param(s, 1);
+    w->data[0] = 2.0f;
+
+    struct PicoOptim* o = pico_optim_adamw_init(0.5f, 0.9f, 0.999f, 0.1f);
+    pico_optim_add(o, w);
+    pico_optim_step(o);
+    ASSERT_TRUE(fabsf(w->data[0] - 2.0f * (1.0f - 0.05f)) < 1e-6f);
+
+    pico_optim_free(o);
+    pico_free(w);
+}
+
+// a param added after the first step gets fresh state; the old one keeps its moments
+UTEST(optim, add_after_step_keeps_state) {
+    int64_t s[] = {3};
+    struct PicoTensor* a = pico_param(s, 1);
+    struct PicoTensor* b = pico_param(s, 1);
+    struct PicoOptim* o = pico_optim_nag_init(0.1f, 0.5f);
+
+    pico_optim_add(o, a);
+    a->grad[0] = 1.0f;
+    pico_optim_step(o);  // buf_a[0] = 1
+    pico_optim_add(o, b);
+    a->grad[0] = 0.0f;
+    pico_optim_step(o);  // buf_a[0] = 0.5: p -= 0.1 * 0.25
+
+    ASSERT_TRUE(fabsf(a->data[0] - (-0.15f - 0.025f)) < 1e-6f);
+    ASSERT_TRUE(b->data[0] == 0.0f);
+    ASSERT_EQ((long)((uintptr_t)o->state % 64), 0l);
+
+    pico_optim_free(o);
+    pico_free(a);
+    pico_free(b);
+}
+
+// minimise sum (w - 3)^2 with Adam
+UTEST(optim, adam_converges) {
+    int64_t s[] = {20};
+    struct PicoTensor* w = pico_param(s, 1);
+    struct PicoOptim* o = pico_optim_adam_init(0.1f, 0.9f, 0.999f);
+    pico_optim_add(o, w);
+
+    for(int step = 0; step < 500; step++) {
+        pico_optim_zero_grad(o);
+        for(int i = 0; i < 20; i++) w->grad[i] = 2.0f * (w->data[i] - 3.0f);
+        pico_optim_step(o);
+    }
+    for(int i = 0; i < 20; i++) ASSERT_TRUE(fabsf(w->data[i] - 3.0f) < 1e-2f);
+
+    pico_optim_free(o);
+    pico_free(w);
+}
+
+// forced levels: AVX2 / AVX-512 steps land on the scalar result
+static float optim_level_diff(SimdLevel level, struct PicoOptim* (*make)(void)) {
+    int64_t s[] = {301};
+    struct PicoTensor* w[2];
+    struct PicoOptim* o[2];
+    SimdLevel saved = g_simd_level;
+    for(int k = 0; k < 2; k++) {
+        w[k] = pico_param(s, 1);
+        o[k] = make();
+        pico_optim_add(o[k], w[k]);
+    }
+    for(int t = 0; t < 3; t++) {
+        for(int k = 0; k < 2; k++) {
+            for(int i = 0; i < 301; i++) w[k]->grad[i] = (float)((i * 13 + t) % 17) * 0.1f - 0.8f;
+            g_simd_level = k == 0 ? SIMD_NONE : level;
+            pico_optim_step(o[k]);
+            g_simd_level = saved;
+        }
+    }
+    float worst = 0.0f;
+    for(int i = 0; i < 301; i++) worst = fmaxf(worst, fabsf(w[0]->data[i] - w[1]->data[i]));
+    for(int k = 0; k < 2; k++) {
+        pico_optim_free(o[k]);
+        pico_free(w[k]);
+    }
+    return worst;
+}
+
+static struct PicoOptim* optim_make_nag(void) { return pico_optim_nag_init(0.1f, 0.9f); }
+static struct PicoOptim* optim_make_adagrad(void) { return pico_optim_adagrad_init(0.1f); }
+static struct PicoOptim* optim_make_rmsprop(void) { return pico_optim_rmsprop_init(0.01f, 0.9f); }
+static struct PicoOptim* optim_make_adamw(void) {
+    return pico_optim_adamw_init(0.01f, 0.9f, 0.999f, 0.01f);
+}
+
+static float optim_level_all_diff(SimdLevel level) {
+    float worst = optim_level_diff(level, optim_make_nag);
+    worst = fmaxf(worst, optim_level_diff(level, optim_make_adagrad));
+    worst = fmaxf(worst, optim_level_diff(level, optim_make_rmsprop));
+    return fmaxf(worst, optim_level_diff(level, optim_make_adamw));
+}
+
+UTEST(optim, avx2_matches_scalar) {
+    if(!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("fma")) return;
+    ASSERT_TRUE(optim_level_all_diff(SIMD_AVX2) < 1e-6f);
+}
+
+UTEST(optim, avx512_matches_scalar) {
+    if(!__builtin_cpu_supports("avx512f")) return;
+    ASSERT_TRUE(optim_level_all_diff(SIMD_AVX512) < 1e-6f);
+}
+
+// ==================== multi-tensor apply
+
+// tiny biases next to weights bigger than one 16K chunk, ~140K floats in all so the
+// step goes through the thread pool
+static int64_t optim_mt_sizes[] = {1, 3, 17, 50000, 50000, 40001};
+#define OPTIM_MT_N 6
+
+static void optim_mt_fill(struct PicoTensor** w) {
+    for(int k = 0; k < OPTIM_MT_N; k++) {
+        for(int64_t i = 0; i < w[k]->numel; i++) {
+            w[k]->data[i] = (float)(i % 7) * 0.25f;
+            w[k]->grad[i] = (float)((i + k) % 9) * 0.5f - 2.0f;
+        }
+    }
+}
+
+// fused zero-grad: SGD lands on p - lr*g everywhere and leaves every grad at 0
+UTEST(optim_sgd, fused_step_zeroes_grads) {
+    struct PicoTensor* w[OPTIM_MT_N];
+    struct PicoOptimSGD* opt = pico_optim_sgd_init(0.5f);
+    opt->fuse_zero_grad = true;
+    for(int k = 0; k < OPTIM_MT_N; k++) {
+        w[k] = pico_param(&optim_mt_sizes[k], 1);
+        pico_optim_sgd_add(opt, w[k]);
+    }
+    optim_mt_fill(w);
+    pico_optim_sgd_step(opt);
+
+    int bad = 0;
+    for(int k = 0; k < OPTIM_MT_N; k++) {
+        for(int64_t i = 0; i < w[k]->numel; i++) {
+            float want = (float)(i % 7) * 0.25f - 0.5f * ((float)((i + k) % 9) * 0.5f - 2.0f);
+            if(w[k]->data[i] != want || w[k]->grad[i] != 0.0f) bad++;
+        }
+    }
+    ASSERT_EQ(opt->chunks.n, 3 + 4 + 4 + 3);
+
+    pico_optim_sgd_free(opt);
+    for(int k = 0; k < OPTIM_MT_N; k++) pico_free(w[k]);
+    ASSERT_EQ(bad, 0);
+}
+
+// zero_grad goes through the same chunk list, a param added later included
+UTEST(optim_sgd, zero_grad_after_add) {
+    struct PicoTensor* w[OPTIM_MT_N];
+    struct PicoOptimSGD* opt = pico_optim_sgd_init(0.5f);
+    for(int k = 0; k < OPTIM_MT_N; k++) w[k] = pico_param(&optim_mt_sizes[k], 1);
+    optim_mt_fill(w);
+    for(int k = 0; k < OPTIM_MT_N; k++) {
+        pico_optim_sgd_add(opt, w[k]);
+        if(k == 2) pico_optim_sgd_zero_grad(opt);  // builds a list of 3
+    }
+    pico_optim_sgd_zero_grad(opt);
+
+    int bad = 0;
+    for(int k = 0; k < OPTIM_MT_N; k++) {
+        for(int64_t i = 0; i < w[k]->numel; i++) bad += w[k]->grad[i] != 0.0f;
+    }
+
+    pico_optim_sgd_free(opt);
+    for(int k = 0; k < OPTIM_MT_N; k++) pico_free(w[k]);
+    ASSERT_EQ(bad, 0);
+}
+
+// forced SIMD level vs scalar through the chunked, threaded path: Adam with the fused
+// zero-grad, two steps (grads refilled in between)
+static float optim_mt_level_diff(SimdLevel level) {
+    struct PicoTensor* w[2][OPTIM_MT_N];
+    struct PicoOptim* o[2];
+    SimdLevel saved = g_simd_level;
+    int bad_grads = 0;
+    for(int r = 0; r < 2; r++) {
+        o[r] = pico_optim_adam_init(0.01f, 0.9f, 0.999f);
+        o[r]->fuse_zero_grad = true;
+        for(int k = 0; k < OPTIM_MT_N; k++) {
+            w[r][k] = pico_param(&optim_mt_sizes[k], 1);
+            pico_optim_add(o[r], w[r][k]);
+        }
+        for(int t = 0; t < 2; t++) {
+            optim_mt_fill(w[r]);
+            g_simd_level = r == 0 ? SIMD_NONE : level;
+            pico_optim_step(o[r]);
+            g_simd_level = saved;
+            for(int k = 0; k < OPTIM_MT_N; k++) {
+                for(int64_t i = 0; i < w[r][k]->numel; i++) bad_grads += w[r][k]->grad[i] != 0;
+            }
+        }
+    }
+
+    float worst = bad_grads ? INFINITY : 0.0f;
+    for(int k = 0; k < OPTIM_MT_N; k++) {
+        for(int64_t i = 0; i < w[0][k]->numel; i++) {
+            worst = fmaxf(worst, fabsf(w[0][k]->data[i] - w[1][k]->data[i]));
+        }
+    }
+    for(int r = 0; r < 2; r++) {
+        pico_optim_free(o[r]);
+        for(int k = 0; k < OPTIM_MT_N; k++) pico_free(w[r][k]);
+    }
+    return worst;
+}
+
+UTEST(optim, multi_tensor_avx2_matches_scalar) {
+    if(!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("fma")) return;
+    ASSERT_TRUE(optim_mt_level_diff(SIMD_AVX2) < 1e-6f);
+}
+
+UTEST(optim, multi_tensor_avx512_matches_scalar) {
+    if(!__builtin_cpu_supports("avx512f")) return;
+    ASSERT_TRUE(optim_mt_level_diff(SIMD_AVX512) < 1e-6f);
+}
+
+// ==================== gradient accumulation
+
+// accum_steps = 2 over a grad summed from two micro-batches == a plain step on their
+// mean (0.5 is exact, so the two runs agree bit for bit)
+UTEST(optim, accum_scales_grad) {
+    int64_t s[] = {37};
+    struct PicoTensor* w[2];
+    struct PicoOptim* o[2];
+    for(int r = 0; r < 2; r++) {
+        w[r] = pico_param(s, 1);
+        o[r] = pico_optim_adamw_init(0.01f, 0.9f, 0.999f, 0.1f);
+        o[r]->accum_steps = r == 0 ? 0 : 2;
+        pico_optim_add(o[r], w[r]);
+    }
+
+    int mismatched = 0;
+    for(int t = 0; t < 3; t++) {
+        for(int i = 0; i < 37; i++) {
+            float g = (float)((i * 5 + t) % 13) * 0.25f - 1.5f;
+            w[0]->grad[i] = g;
+            w[1]->grad[i] = 2.0f * g;
+        }
+        pico_optim_step(o[0]);
+        pico_optim_step(o[1]);
+        for(int i = 0; i < 37; i++) mismatched += w[0]->data[i] != w[1]->data[i];
+    }
+
+    for(int r = 0; r < 2; r++) {
+        pico_optim_free(o[r]);
+        pico_free(w[r]);
+    }
+    ASSERT_EQ(mismatched, 0);
+}
@@ -0,0 +1,329 @@
+/*
+ * Tests for the reductions (pico_sum, pico_mean, pico_max, pico_argmax).
+ * NOTE: no UTEST_MAIN here, test_basic.c owns main + UTEST_STATE.
+ *
+ * Shapes + values on small hand-checked tensors, backward through pico_backward
+ * (also past a constant input with no grad buffer), then the kernel paths: forced
+ * AVX2 / AVX-512 against scalar on inner- and outer-axis shapes with ragged tails
+ * (save/restore, cpu-supports guard), and a tensor big enough to take the threaded
+ * split.
+ */
+#include <math.h>
+#include <stdlib.h>
+
+#include "arena.h"
+#include "global.h"
+#include "reduce/reduce.h"
+#include "tensor.h"
+#include "utest.h"
+
+#define RED_NEAR(a, b) (fabsf((a) - (b)) < 1e-4f)
+
+// x = [[0 1 2], [3 4 5]]
+static struct PicoTensor* reduce_2x3(void) {
+    int64_t s[] = {2, 3};
+    struct PicoTensor* x = pico_param(s, 2);
+    for(int i = 0; i < 6; i++) x->data[i] = (float)i;
+    return x;
+}
+
+UTEST(reduce, sum_all) {
+    struct Arena* ar = arena_init(1 << 14);
+    arena_ctx_push(ar);
+    struct PicoTensor* x = reduce_2x3();
+
+    struct PicoTensor* out = pico_sum(x, NULL, 0, false);
+    ASSERT_EQ(out->ndim, 1);
+    ASSERT_EQ(out->shape[0], 1);
+    ASSERT_TRUE(out->data[0] == 15.0f);
+
+    struct PicoTensor* kd = pico_sum(x, NULL, 0, true);
+    ASSERT_EQ(kd->ndim, 2);
+    ASSERT_EQ(kd->shape[0], 1);
+    ASSERT_EQ(kd->shape[1], 1);
+
+    pico_free(x);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+UTEST(reduce, sum_axis) {
+    struct Arena* ar = arena_init(1 << 14);
+    arena_ctx_push(ar);
+    struct PicoTensor* x = reduce_2x3();
+
+    int ax0[] = {0};
+    struct PicoTensor* s0 = pico_sum(x, ax0, 1, false);
+    ASSERT_EQ(s0->ndim, 1);
+    ASSERT_EQ(s0->shape[0], 3);
+    ASSERT_TRUE(s0->data[0] == 3.0f);
+    ASSERT_TRUE(s0->data[1] == 5.0f);
+    ASSERT_TRUE(s0->data[2] == 7.0f);
+
+    int ax1[] = {-1};
+    struct PicoTensor* s1 = pico_sum(x, ax1, 1, true);
+    ASSERT_EQ(s1->ndim, 2);
+    ASSERT_EQ(s1->shape[0], 2);
+    ASSERT_EQ(s1->shape[1], 1);
+    ASSERT_TRUE(s1->data[0] == 3.0f);
+    ASSERT_TRUE(s1->data[1] == 12.0f);
+
+    pico_free(x);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+// axes {0, 2} of [2, 3, 4]: two separate blocks -> two passes
+UTEST(reduce, sum_split_axes) {
+    struct Arena* ar = arena_init(1 << 14);
+    arena_ctx_push(ar);
+
+    int64_t s[] = {2, 3, 4};
+    struct PicoTensor* x = pico_param(s, 3);
+    for(int i = 0; i < 24; i++) x->data[i] = (float)i;
+
+    int axes[] = {2, 0};
+    struct PicoTensor* out = pico_sum(x, axes, 2, false);
+    ASSERT_EQ(out->ndim, 1);
+    ASSERT_EQ(out->shape[0], 3);
+    for(int j = 0; j < 3; j++) {
+        float want = 0.0f;
+        for(int a = 0; a < 2; a++)
+            for(int k = 0; k < 4; k++) want += x->data[a * 12 + j * 4 + k];
+        ASSERT_TRUE(out->data[j] == want);
+    }
+
+    pico_backward(ar, out);
+    for(int i = 0; i < 24; i++) ASSERT_TRUE(x->grad[i] == 1.0f);
+
+    pico_free(x);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+UTEST(reduce, mean_forward_backward) {
+    struct Arena* ar = arena_init(1 << 14);
+    arena_ctx_push(ar);
+    struct PicoTensor* x = reduce_2x3();
+
+    int ax[] = {1};
+    struct PicoTensor* m = pico_mean(x, ax, 1, false);
+    ASSERT_TRUE(RED_NEAR(m->data[0], 1.0f));
+    ASSERT_TRUE(RED_NEAR(m->data[1], 4.0f));
+
+    struct PicoTensor* total = pico_sum(m, NULL, 0, false);
+    pico_backward(ar, total);
+    for(int i = 0; i < 6; i++) ASSERT_TRUE(RED_NEAR(x->grad[i], 1.0f / 3.0f));
+
+    pico_free(x);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+// ties: only the first max gets the gradient
+UTEST(reduce, max_forward_backward) {
+    struct Arena* ar = arena_init(1 << 14);
+    arena_ctx_push(ar);
+
+    int64_t s[] = {2, 3};
+    struct PicoTensor* x = pico_param(s, 2);
+    float v[] = {1.0f, 7.0f, 7.0f, -2.0f, -5.0f, -1.0f};
+    for(int i = 0; i < 6; i++) x->data[i] = v[i];
+
+    int ax[] = {1};
+    struct PicoTensor* m = pico_max(x, ax, 1, false);
+    ASSERT_TRUE(m->data[0] == 7.0f);
+    ASSERT_TRUE(m->data[1] == -1.0f);
+
+    pico_backward(ar, m);
+    float want[] = {0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+    for(int i = 0; i < 6; i++) ASSERT_TRUE(x->grad[i] == want[i]);
+
+    x->data[4] = NAN;
+    struct PicoTensor* mn = pico_max(x, ax, 1, false);
+    ASSERT_TRUE(isnan(mn->data[1]));
+
+    pico_free(x);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+// a constant input with no grad buffer: the sum, mean and max backwards leave it alone
+UTEST(reduce, backward_skips_constants) {
+    struct Arena* ar = arena_init(1 << 14);
+    arena_ctx_push(ar);
+
+    struct PicoTensor* x = reduce_2x3();
+    float* grad = x->grad;
+    x->grad = NULL;
+    x->requires_grad = 0;
+    int ax[] = {1};
+    pico_backward(ar, pico_sum(x, ax, 1, false));
+    pico_backward(ar, pico_sum(x, NULL, 0, false));
+    pico_backward(ar, pico_mean(x, ax, 1, false));
+    pico_backward(ar, pico_max(x, ax, 1, false));
+    ASSERT_TRUE(x->grad == NULL);
+
+    x->grad = grad;
+    pico_free(x);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+UTEST(reduce, argmax) {
+    struct Arena* ar = arena_init(1 << 14);
+    arena_ctx_push(ar);
+
+    int64_t s[] = {2, 3};
+    struct PicoTensor* x = pico_param(s, 2);
+    float v[] = {1.0f, 7.0f, 7.0f, 9.0f, -5.0f, -1.0f};
+    for(int i = 0; i < 6; i++) x->data[i] = v[i];
+
+    int ax1[] = {1};
+    struct PicoTensor* a1 = pico_argmax(x, ax1, 1, false);
+    ASSERT_TRUE(a1->data[0] == 1.0f);
+    ASSERT_TRUE(a1->data[1] == 0.0f);
+    ASSERT_EQ(a1->num_parents, 0);
+
+    int ax0[] = {0};
+    struct PicoTensor* a0 = pico_argmax(x, ax0, 1, true);
+    ASSERT_EQ(a0->shape[0], 1);
+    ASSERT_TRUE(a0->data[0] == 1.0f);
+    ASSERT_TRUE(a0->data[1] == 0.0f);
+    ASSERT_TRUE(a0->data[2] == 0.0f);
+
+    struct PicoTensor* all = pico_argmax(x, NULL, 0, false);
+    ASSERT_TRUE(all->data[0] == 3.0f);
+
+    pico_free(x);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+UTEST(reduce, bad_axes) {
+    struct Arena* ar = arena_init(1 << 14);
+    arena_ctx_push(ar);
+
+    int64_t s[] = {2, 3, 4};
+    struct PicoTensor* x = pico_param(s, 3);
+
+    int oob[] = {3};
+    ASSERT_TRUE(pico_sum(x, oob, 1, false) == NULL);
+    int dup[] = {1, -2};
+    ASSERT_TRUE(pico_max(x, dup, 2, false) == NULL);
+    int split[] = {0, 2};
+    ASSERT_TRUE(pico_argmax(x, split, 2, false) == NULL);
+
+    pico_free(x);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+// 1M copies of 0.1: a naive running float sum drifts by ~1e-2 relative
+UTEST(reduce, sum_is_compensated) {
+    struct Arena* ar = arena_init(1 << 14);
+    arena_ctx_push(ar);
+
+    int64_t s[] = {1 << 20};
+    struct PicoTensor* x = pico_param(s, 1);
+    for(int64_t i = 0; i < x->numel; i++) x->data[i] = 0.1f;
+    double want = (double)0.1f * (double)x->numel;
+
+    struct PicoTensor* out = pico_sum(x, NULL, 0, false);
+    ASSERT_TRUE(fabs(out->data[0] - want) / want < 1e-6);
+
+    int64_t s2[] = {1 << 14, 3};
+    struct PicoTensor* col = pico_param(s2, 2);
+    for(int64_t i = 0; i < col->numel; i++) col->data[i] = 0.1f;
+    int ax[] = {0};
+    struct PicoTensor* cs = pico_sum(col, ax, 1, false);
+    double cwant = (double)0.1f * (double)(1 << 14);
+    ASSERT_TRUE(fabs(cs->data[2] - cwant) / cwant < 1e-6);
+
+    pico_free(x);
+    pico_free(col);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+// worst |diff| between `level` and scalar for sum/max/argmax over `axis` of x
+static float reduce_level_max_diff(SimdLevel level, struct PicoTensor* x, int axis) {
+    struct Arena* ar = arena_init(1 << 22);
+    SimdLevel saved = g_simd_level;
+    pico_init();
+    arena_ctx_push(ar);
+
+    float worst = 0.0f;
+    struct PicoTensor* (*ops[])(struct PicoTensor*, const int*, int, bool) = {pico_sum, pico_max,
+                                                                             pico_argmax};
+    for(int k = 0; k < 3; k++) {
+        g_simd_level = SIMD_NONE;
+        struct PicoTensor* ref = ops[k](x, &axis, 1, false);
+        g_simd_level = level;
+        struct PicoTensor* got = ops[k](x, &axis, 1, false);
+        g_simd_level = saved;
+        for(int64_t i = 0; i < ref->numel; i++) {
+            float d = fabsf(got->data[i] - ref->data[i]) / fmaxf(1.0f, fabsf(ref->data[i]));
+            worst = fmaxf(worst, d);
+        }
+    }
+
+    arena_ctx_pop();
+    arena_destroy(ar);
+    return worst;
+}
+
+static float reduce_level_all_diff(SimdLevel level) {
+    int64_t s[] = {5, 37, 300};  // odd everywhere: masked tails on rows and column tiles
+    struct PicoTensor* x = pico_param(s, 3);
+    for(int64_t i = 0; i < x->numel; i++) x->data[i] = (float)((i * 7919) % 1013) * 0.01f - 5.0f;
+
+    float worst = 0.0f;
+    for(int axis = 0; axis < 3; axis++) worst = fmaxf(worst, reduce_level_max_diff(level, x, axis));
+    pico_free(x);
+    return worst;
+}
+
+UTEST(reduce_simd, avx2_matches_scalar) {
+    if(!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("fma")) return;
+    ASSERT_TRUE(reduce_level_all_diff(SIMD_AVX2) < 1e-5f);
+}
+
+UTEST(reduce_simd, avx512_matches_scalar) {
+    if(!__builtin_cpu_supports("avx512f")) return;
+    ASSERT_TRUE(reduce_level_all_diff(SIMD_AVX512) < 1e-5f);
+}
+
+// big enough that both the row and the column paths split across global_tp
+UTEST(reduce_simd, threaded) {
+    int64_t s[] = {512, 1024};
+    struct PicoTensor* x = pico_param(s, 2);
+    for(int64_t i = 0; i < x->numel; i++) x->data[i] = (float)(i % 97) - 48.0f;
+
+    SimdLevel saved = g_simd_level;
+    pico_init();
+    g_simd_level = saved;
+    struct Arena* ar = arena_init(1 << 16);
+    arena_ctx_push(ar);
+
+    int ax0[] = {0}, ax1[] = {1};
+    struct PicoTensor* cols = pico_sum(x, ax0, 1, false);
+    struct PicoTensor* rows = pico_max(x, ax1, 1, false);
+
+    int bad = 0;
+    for(int64_t j = 0; j < 1024; j++) {
+        double want = 0.0;
+        for(int64_t r = 0; r < 512; r++) want += x->data[r * 1024 + j];
+        if(fabs(cols->data[j] - want) > 1e-3) bad++;
+    }
+    for(int64_t r = 0; r < 512; r++) {
+        float want = -INFINITY;
+        for(int64_t j = 0; j < 1024; j++) want = fmaxf(want, x->data[r * 1024 + j]);
+        if(rows->data[r] != want) bad++;
+    }
+
+    pico_free(x);
+    arena_ctx_pop();
+    arena_destroy(ar);
+    ASSERT_EQ(bad, 0);
+}
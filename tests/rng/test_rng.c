@@ -0,0 +1,125 @@
+/*
+ * Tests for the counter-based generator (rng/rng.h + the Philox kernels): the
+ * Random123 known answers, SIMD == scalar, the same output for any thread split,
+ * streams, and the shape / domain of the normal fill.
+ * NOTE: no UTEST_MAIN here, test_basic.c owns main + UTEST_STATE.
+ */
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "global.h"
+#include "kernels/cpu_kernels.h"
+#include "rng/rng.h"
+#include "utest.h"
+
+// Philox4x32-10 known-answer vectors from Random123
+UTEST(rng, philox_known_answers) {
+    uint32_t c[4] = {0, 0, 0, 0};
+    pico_philox_scalar(c, 0, 0);
+    ASSERT_EQ(c[0], 0x6627e8d5u);
+    ASSERT_EQ(c[1], 0xe169c58du);
+    ASSERT_EQ(c[2], 0xbc57ac4cu);
+    ASSERT_EQ(c[3], 0x9b00dbd8u);
+
+    uint32_t d[4] = {0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu};
+    pico_philox_scalar(d, 0xffffffffu, 0xffffffffu);
+    ASSERT_EQ(d[0], 0x408f276du);
+    ASSERT_EQ(d[1], 0x41c83b0eu);
+    ASSERT_EQ(d[2], 0xa20bc7c6u);
+    ASSERT_EQ(d[3], 0x6d5451fdu);
+}
+
+// the AVX2 / AVX-512 super-blocks are the scalar one bit for bit (uniforms), and within
+// the polynomial error (normals)
+UTEST(rng, simd_matches_scalar) {
+    if(!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("fma")) return;
+    int has_avx512 = __builtin_cpu_supports("avx512f");
+    float us[PICO_RNG_BLOCK], ua[PICO_RNG_BLOCK], ns[PICO_RNG_BLOCK], na[PICO_RNG_BLOCK];
+    float ub[PICO_RNG_BLOCK], nb[PICO_RNG_BLOCK];
+    for(uint64_t block = 0; block < 8192; block += PICO_RNG_LANES) {
+        uint64_t seed = 0x243F6A8885A308D3ull, stream = block % 3;
+        pico_rng_uniform_scalar(seed, stream, block << 20, -1.5f, 3.0f, us);
+        pico_rng_uniform_avx2(seed, stream, block << 20, -1.5f, 3.0f, ua);
+        ASSERT_EQ(memcmp(us, ua, sizeof(us)), 0);
+        pico_rng_normal_scalar(seed, stream, block, 1.0f, 2.0f, ns);
+        pico_rng_normal_avx2(seed, stream, block, 1.0f, 2.0f, na);
+        for(int i = 0; i < PICO_RNG_BLOCK; i++)
+            ASSERT_NEAR(ns[i], na[i], 1e-4f * (1.0f + fabsf(ns[i])));
+        if(!has_avx512) continue;
+        pico_rng_uniform_avx512(seed, stream, block << 20, -1.5f, 3.0f, ub);
+        ASSERT_EQ(memcmp(us, ub, sizeof(us)), 0);
+        pico_rng_normal_avx512(seed, stream, block, 1.0f, 2.0f, nb);
+        for(int i = 0; i < PICO_RNG_BLOCK; i++)
+            ASSERT_NEAR(ns[i], nb[i], 1e-4f * (1.0f + fabsf(ns[i])));
+    }
+}
+
+// one thread or many: the same values, also for a length that ends mid super-block
+UTEST(rng, same_for_any_thread_split) {
+    int64_t n = 300001;
+    float* threaded = malloc(sizeof(float) * n);
+    float* serial = malloc(sizeof(float) * n);
+    for(int normal = 0; normal < 2; normal++) {
+        pico_rng_fill_cpu(threaded, n, 7, 1, 64, normal, 0.0f, 1.0f);
+        struct PicoRngJob job = {.out = serial,
+                                 .n = n,
+                                 .seed = 7,
+                                 .stream = 1,
+                                 .block = 64,
+                                 .normal = normal,
+                                 .shift = 0.0f,
+                                 .scale = 1.0f};
+        pico_rng_slice(&job, 0, (n + PICO_RNG_BLOCK - 1) / PICO_RNG_BLOCK);
+        ASSERT_EQ(memcmp(threaded, serial, sizeof(float) * n), 0);
+    }
+    free(threaded);
+    free(serial);
+}
+
+// a seed + stream replays; other streams and later fills differ; uniforms stay in [0, 1)
+UTEST(rng, streams_and_replay) {
+    float a[100], b[100], c[100], d[100];
+    struct PicoRng r1 = pico_rng_init(42, 0), r2 = pico_rng_init(42, 0);
+    struct PicoRng r3 = pico_rng_init(42, 1);
+    pico_rng_uniform(&r1, a, 100, 0.0f, 1.0f);
+    pico_rng_uniform(&r2, b, 100, 0.0f, 1.0f);
+    pico_rng_uniform(&r3, c, 100, 0.0f, 1.0f);
+    pico_rng_uniform(&r1, d, 100, 0.0f, 1.0f);
+    ASSERT_EQ(memcmp(a, b, sizeof(a)), 0);
+    ASSERT_NE(memcmp(a, c, sizeof(a)), 0);
+    ASSERT_NE(memcmp(a, d, sizeof(a)), 0);
+    ASSERT_EQ(r1.offset, 2u * 2u * PICO_RNG_LANES);  // 100 values: 2 super-blocks a fill
+    for(int i = 0; i < 100; i++) ASSERT_TRUE(a[i] >= 0.0f && a[i] < 1.0f);
+}
+
+// normals are finite at every SIMD level (the log never sees 0) with mean / std applied
+UTEST(rng, normal_finite_and_scaled) {
+    int64_t n = 1 << 18;
+    float* x = malloc(sizeof(float) * n);
+    SimdLevel saved = g_simd_level;
+    SimdLevel levels[] = {SIMD_NONE, SIMD_AVX2, SIMD_AVX512};
+    int n_levels = !__builtin_cpu_supports("avx2") ? 1 : __builtin_cpu_supports("avx512f") ? 3 : 2;
+    int bad = 0;
+    double mean[3], var[3];
+    for(int l = 0; l < n_levels; l++) {
+        g_simd_level = levels[l];
+        struct PicoRng r = pico_rng_init(3, 0);
+        pico_rng_normal(&r, x, n, 5.0f, 0.5f);
+        double s = 0.0, sq = 0.0;
+        for(int64_t i = 0; i < n; i++) {
+            if(!isfinite(x[i])) bad++;
+            s += x[i];
+            sq += (double)x[i] * x[i];
+        }
+        mean[l] = s / (double)n;
+        var[l] = sq / (double)n - mean[l] * mean[l];
+    }
+    g_simd_level = saved;
+    free(x);
+    ASSERT_EQ(bad, 0);
+    for(int l = 0; l < n_levels; l++) {
+        ASSERT_NEAR(mean[l], 5.0, 0.01);
+        ASSERT_NEAR(sqrt(var[l]), 0.5, 0.01);
+    }
+}
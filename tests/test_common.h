@@ -0,0 +1,22 @@
+/*
+ * test_common.h — small fixtures shared by the test suites (tests-only).
+ *
+ * The op-vs-reference suites fill their tensors with a smooth deterministic pattern
+ * and compare against a reference computed by definition, with a tolerance relative
+ * to the expected value.
+ */
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+
+// a bounded, non-periodic-looking fill: scale * sin(0.37 i + 0.11). vary i's stride and
+// offset (wave(i * 7 + 3, ...)) for unrelated tensors
+static inline float test_wave(int64_t i, float scale) {
+    return scale * sinf(0.37f * (float)i + 0.11f);
+}
+
+// |got - want| <= tol * (1 + |want|): absolute near 0, relative for large values
+static inline int test_near(float got, double want, float tol) {
+    return fabs((double)got - want) <= tol * (1.0 + fabs(want));
+}
@@ -0,0 +1,354 @@
+/*
+ * Tests for bf16 / fp16 tensors: pico_to_dtype, the ops with a half path (matmul,
+ * Linear, relu / sigmoid / tanh, add / sub / mul), the fp32 fallback of the rest, and
+ * the optimizers' fp32 master weights.
+ * NOTE: no UTEST_MAIN here, test_basic.c owns main + UTEST_STATE.
+ *
+ * Half ops compute in fp32 and round once on the store, so most checks compare
+ * against the fp32 op run on the widened inputs, within one half ulp of the result.
+ */
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "act/activations.h"
+#include "arena.h"
+#include "global.h"
+#include "loss/loss.h"
+#include "nn/linear.h"
+#include "ops.h"
+#include "optim/optim.h"
+#include "reduce/reduce.h"
+#include "tensor.h"
+#include "utest.h"
+
+// one ulp of `dtype` at v, relative (bf16: 2^-7, fp16: 2^-10), plus a floor near 0
+static float dtype_tol(PicoDType dtype, float v) {
+    float rel = dtype == PICO_BF16 ? 0x1p-7f : 0x1p-10f;
+    return fabsf(v) * rel + 1e-6f;
+}
+
+static void dtype_fill(struct PicoTensor* t, float scale, int salt) {
+    for(int64_t i = 0; i < t->numel; i++) {
+        pico_tensor_set(t, i, scale * (float)((i * 37 + salt * 11) % 23 - 11) / 11.0f);
+    }
+}
+
+UTEST(dtype, to_dtype_round_trip_and_grad) {
+    struct Arena* ar = arena_init(1 << 16);
+    arena_ctx_push(ar);
+
+    int64_t s[] = {2, 3};
+    struct PicoTensor* x = pico_param(s, 2);
+    float vals[] = {1.0f, -2.5f, 0.1f, 1000.0f, 3.14159f, -0.0f};
+    for(int i = 0; i < 6; i++) x->data[i] = vals[i];
+
+    struct PicoTensor* h = pico_to_dtype(x, PICO_BF16);
+    struct PicoTensor* back = pico_to_dtype(h, PICO_F32);
+    struct PicoTensor* same = pico_to_dtype(x, PICO_F32);
+    pico_backward(ar, pico_sum(back, NULL, 0, false));
+
+    ASSERT_TRUE(same == x);
+    ASSERT_EQ(h->dtype, PICO_BF16);
+    ASSERT_EQ(back->dtype, PICO_F32);
+    for(int i = 0; i < 6; i++) {
+        ASSERT_EQ(h->data16[i], pico_f32_to_bf16(vals[i]));
+        ASSERT_NEAR(back->data[i], vals[i], dtype_tol(PICO_BF16, vals[i]));
+        ASSERT_TRUE(x->grad[i] == 1.0f);  // the cast passes the grad straight through
+    }
+
+    pico_free(x);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+// half B (the weights) read natively by the AVX kernels, or widened on the scalar path:
+// the sum is fp32 either way, so it matches the fp32 matmul on the widened B
+static int dtype_matmul_mismatches(SimdLevel level, PicoDType dtype) {
+    struct Arena* ar = arena_init(1 << 20);
+    arena_ctx_push(ar);
+
+    int64_t sa[] = {13, 37}, sb[] = {37, 29};  // odd sizes: every tile + tail path
+    struct PicoTensor* a = pico_param(sa, 2);
+    struct PicoTensor* b = pico_param_dtype(sb, 2, dtype);
+    dtype_fill(a, 1.0f, 1);
+    dtype_fill(b, 0.5f, 2);
+    struct PicoTensor* b32 = pico_to_dtype(b, PICO_F32);
+
+    SimdLevel saved = g_simd_level;
+    g_simd_level = level;
+    struct PicoTensor* c = pico_matmul(a, b);
+    struct PicoTensor* ref = pico_matmul(a, b32);
+    // half A as well: the output is stored half
+    struct PicoTensor* ch = pico_matmul(pico_to_dtype(a, dtype), b);
+    g_simd_level = saved;
+
+    int bad = c->dtype != PICO_F32 || ch->dtype != dtype;
+    for(int64_t i = 0; i < c->numel; i++) {
+        if(fabsf(c->data[i] - ref->data[i]) > 1e-5f * (1.0f + fabsf(ref->data[i]))) bad++;
+        // A rounded to half too, then C: a couple of ulps of the result's dtype
+        float want = ref->data[i];
+        if(fabsf(pico_tensor_get(ch, i) - want) > 4.0f * dtype_tol(dtype, want) + 0.05f) bad++;
+    }
+
+    pico_free(a);
+    pico_free(b);
+    arena_ctx_pop();
+    arena_destroy(ar);
+    return bad;
+}
+
+UTEST(dtype, matmul_half_weights_scalar) {
+    ASSERT_EQ(dtype_matmul_mismatches(SIMD_NONE, PICO_BF16), 0);
+    ASSERT_EQ(dtype_matmul_mismatches(SIMD_NONE, PICO_F16), 0);
+}
+
+UTEST(dtype, matmul_half_weights_avx) {
+    if(!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("f16c")) return;
+    ASSERT_EQ(dtype_matmul_mismatches(SIMD_AVX2, PICO_BF16), 0);
+    ASSERT_EQ(dtype_matmul_mismatches(SIMD_AVX2, PICO_F16), 0);
+}
+
+// bf16 Linear: forward close to fp32, grads (always fp32) close to the fp32 layer's
+UTEST(dtype, linear_bf16_weights) {
+    struct Arena* ar = arena_init(1 << 20);
+    arena_ctx_push(ar);
+
+    struct PicoLinear* fc = pico_nn_linear_init(19, 11, true);
+    struct PicoLinear* fc32 = pico_nn_linear_init(19, 11, true);
+    pico_free(fc->weights);
+    pico_free(fc->bias);
+    int64_t sw[] = {19, 11}, sbias[] = {11};
+    fc->weights = pico_param_dtype(sw, 2, PICO_BF16);
+    fc->bias = pico_param_dtype(sbias, 1, PICO_BF16);
+    dtype_fill(fc->weights, 0.3f, 3);
+    dtype_fill(fc->bias, 0.1f, 4);
+    for(int64_t i = 0; i < fc->weights->numel; i++) {
+        fc32->weights->data[i] = pico_tensor_get(fc->weights, i);
+    }
+    for(int64_t i = 0; i < fc->bias->numel; i++) {
+        fc32->bias->data[i] = pico_tensor_get(fc->bias, i);
+    }
+
+    int64_t sx[] = {9, 19};
+    struct PicoTensor* x = pico_create_tensor(ar, sx, 2);
+    dtype_fill(x, 1.0f, 5);
+
+    struct PicoTensor* y = pico_nn_linear_forward_act(fc, x, PICO_ACT_RELU);
+    struct PicoTensor* y32 = pico_nn_linear_forward_act(fc32, x, PICO_ACT_RELU);
+    pico_backward(ar, pico_sum(y, NULL, 0, false));
+    pico_backward(ar, pico_sum(y32, NULL, 0, false));
+
+    for(int64_t i = 0; i < y->numel; i++) {
+        ASSERT_NEAR(y->data[i], y32->data[i], 1e-5f);
+    }
+    for(int64_t i = 0; i < fc->weights->numel; i++) {
+        ASSERT_NEAR(fc->weights->grad[i], fc32->weights->grad[i], 1e-4f);
+    }
+    for(int64_t i = 0; i < fc->bias->numel; i++) {
+        ASSERT_NEAR(fc->bias->grad[i], fc32->bias->grad[i], 1e-5f);
+    }
+
+    pico_nn_linear_free(fc);
+    pico_nn_linear_free(fc32);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+typedef struct PicoTensor* (*dtype_act_fn)(struct PicoTensor*);
+
+// half activation == fp32 activation on the widened input, rounded once; the
+// backward (fp32 grads, derivative from the stored half output) matches too
+static int dtype_act_mismatches(SimdLevel level, PicoDType dtype, dtype_act_fn act) {
+    struct Arena* ar = arena_init(1 << 20);
+    arena_ctx_push(ar);
+
+    int64_t s[] = {1037};  // two PICO_HALF_TILE tiles and a tail
+    struct PicoTensor* xh = pico_param_dtype(s, 1, dtype);
+    dtype_fill(xh, 4.0f, 6);
+    struct PicoTensor* x32 = pico_param(s, 1);
+    for(int64_t i = 0; i < x32->numel; i++) x32->data[i] = pico_tensor_get(xh, i);
+
+    SimdLevel saved = g_simd_level;
+    g_simd_level = level;
+    struct PicoTensor* yh = act(xh);
+    struct PicoTensor* y32 = act(x32);
+    pico_backward(ar, pico_sum(yh, NULL, 0, false));
+    pico_backward(ar, pico_sum(y32, NULL, 0, false));
+    g_simd_level = saved;
+
+    int bad = yh->dtype != dtype;
+    for(int64_t i = 0; i < yh->numel; i++) {
+        float want = y32->data[i];
+        if(fabsf(pico_tensor_get(yh, i) - want) > dtype_tol(dtype, want)) bad++;
+        // derivative taken at the rounded output: off by about one ulp of it
+        if(fabsf(xh->grad[i] - x32->grad[i]) > 4.0f * dtype_tol(dtype, 1.0f)) bad++;
+    }
+
+    pico_free(xh);
+    pico_free(x32);
+    arena_ctx_pop();
+    arena_destroy(ar);
+    return bad;
+}
+
+static int dtype_act_all(SimdLevel level) {
+    int bad = 0;
+    PicoDType dtypes[] = {PICO_BF16, PICO_F16};
+    for(int d = 0; d < 2; d++) {
+        bad += dtype_act_mismatches(level, dtypes[d], pico_relu);
+        bad += dtype_act_mismatches(level, dtypes[d], pico_sigmoid);
+        bad += dtype_act_mismatches(level, dtypes[d], pico_tanh);
+        bad += dtype_act_mismatches(level, dtypes[d], pico_tensor_tanh);
+    }
+    return bad;
+}
+
+UTEST(dtype, activations_half_scalar) {
+    ASSERT_EQ(dtype_act_all(SIMD_NONE), 0);
+}
+
+UTEST(dtype, activations_half_avx2) {
+    if(!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("f16c")) return;
+    ASSERT_EQ(dtype_act_all(SIMD_AVX2), 0);
+}
+
+UTEST(dtype, activations_half_avx512) {
+    if(!__builtin_cpu_supports("avx512f")) return;
+    ASSERT_EQ(dtype_act_all(SIMD_AVX512), 0);
+}
+
+// same dtype + same shape stays half (exactly the fp32 result, rounded once); any
+// other mix runs in fp32
+UTEST(dtype, binary_ops) {
+    struct Arena* ar = arena_init(1 << 20);
+    arena_ctx_push(ar);
+
+    int64_t s[] = {3, 701};
+    struct PicoTensor* a = pico_param_dtype(s, 2, PICO_F16);
+    struct PicoTensor* b = pico_param_dtype(s, 2, PICO_F16);
+    dtype_fill(a, 3.0f, 7);
+    dtype_fill(b, 2.0f, 8);
+
+    struct PicoTensor* sum = pico_add(a, b);
+    struct PicoTensor* diff = pico_sub(a, b);
+    struct PicoTensor* prod = pico_mul(a, b);
+    struct PicoTensor* mixed = pico_mul(a, pico_tensor_from_scalar(0.5f));
+    pico_backward(ar, pico_sum(prod, NULL, 0, false));
+
+    ASSERT_EQ(sum->dtype, PICO_F16);
+    ASSERT_EQ(prod->dtype, PICO_F16);
+    ASSERT_EQ(mixed->dtype, PICO_F32);
+    for(int64_t i = 0; i < a->numel; i++) {
+        float va = pico_tensor_get(a, i), vb = pico_tensor_get(b, i);
+        ASSERT_EQ(sum->data16[i], pico_f32_to_f16(va + vb));
+        ASSERT_EQ(diff->data16[i], pico_f32_to_f16(va - vb));
+        ASSERT_EQ(prod->data16[i], pico_f32_to_f16(va * vb));
+        ASSERT_TRUE(mixed->data[i] == va * 0.5f);
+        ASSERT_TRUE(a->grad[i] == vb);
+        ASSERT_TRUE(b->grad[i] == va);
+    }
+
+    pico_free(a);
+    pico_free(b);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+// ops without a half path widen: exp of a bf16 tensor is the fp32 exp, grads reach it
+UTEST(dtype, fallback_ops_widen) {
+    struct Arena* ar = arena_init(1 << 16);
+    arena_ctx_push(ar);
+
+    int64_t s[] = {4, 5};
+    struct PicoTensor* x = pico_param_dtype(s, 2, PICO_BF16);
+    dtype_fill(x, 2.0f, 9);
+
+    struct PicoTensor* e = pico_tensor_exp(x);
+    struct PicoTensor* m = pico_sum(x, (int[]){1}, 1, false);
+    pico_backward(ar, pico_sum(pico_softmax(x, -1), NULL, 0, false));
+
+    ASSERT_EQ(e->dtype, PICO_F32);
+    for(int64_t i = 0; i < x->numel; i++) {
+        ASSERT_NEAR(e->data[i], expf(pico_tensor_get(x, i)), 1e-5f * e->data[i]);
+        ASSERT_NEAR(x->grad[i], 0.0f, 1e-6f);  // softmax rows sum to 1: zero gradient
+    }
+    for(int r = 0; r < 4; r++) {
+        float want = 0.0f;
+        for(int c = 0; c < 5; c++) want += pico_tensor_get(x, r * 5 + c);
+        ASSERT_NEAR(m->data[r], want, 1e-5f);
+    }
+
+    pico_free(x);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+// lr * grad = 1e-4 is far under bf16's ulp at 1.0 (2^-7): stepping the param itself
+// would round every update away. the fp32 master keeps them
+UTEST(dtype, sgd_bf16_param_keeps_master) {
+    int64_t s[] = {40};
+    struct PicoTensor* w = pico_param_dtype(s, 1, PICO_BF16);
+    for(int64_t i = 0; i < w->numel; i++) pico_tensor_set(w, i, 1.0f);
+
+    struct PicoOptimSGD* opt = pico_optim_sgd_init(1e-4f);
+    pico_optim_sgd_add(opt, w);
+    for(int step = 0; step < 100; step++) {
+        for(int64_t i = 0; i < w->numel; i++) w->grad[i] = 1.0f;
+        pico_optim_sgd_step(opt);
+    }
+
+    for(int64_t i = 0; i < w->numel; i++) {
+        ASSERT_NEAR(opt->chunks.master[i], 0.99f, 1e-5f);
+        ASSERT_EQ(w->data16[i], pico_f32_to_bf16(opt->chunks.master[i]));
+    }
+
+    pico_optim_sgd_free(opt);
+    pico_free(w);
+}
+
+// Adam on a half + an fp32 param (mixed in one optimizer) tracks the all-fp32 run;
+// masters survive a param added later
+UTEST(dtype, adam_mixed_params) {
+    int64_t s[] = {300};
+    struct PicoTensor* h = pico_param_dtype(s, 1, PICO_F16);
+    struct PicoTensor* f = pico_param(s, 1);
+    struct PicoTensor* late = pico_param_dtype(s, 1, PICO_BF16);
+    struct PicoTensor* ref = pico_param(s, 1);
+    dtype_fill(h, 1.0f, 10);
+    dtype_fill(late, 1.0f, 11);
+    for(int64_t i = 0; i < s[0]; i++) {
+        f->data[i] = pico_tensor_get(h, i);
+        ref->data[i] = pico_tensor_get(h, i);
+    }
+
+    struct PicoOptim* opt = pico_optim_adam_init(1e-3f, 0.9f, 0.999f);
+    struct PicoOptim* opt_ref = pico_optim_adam_init(1e-3f, 0.9f, 0.999f);
+    pico_optim_add(opt, h);
+    pico_optim_add(opt, f);
+    pico_optim_add(opt_ref, ref);
+    for(int step = 0; step < 20; step++) {
+        if(step == 10) pico_optim_add(opt, late);
+        for(int64_t i = 0; i < s[0]; i++) {
+            float g = 0.01f * (float)(i % 7 - 3);
+            h->grad[i] = f->grad[i] = ref->grad[i] = g;
+            late->grad[i] = g;
+        }
+        pico_optim_step(opt);
+        pico_optim_step(opt_ref);
+    }
+
+    for(int64_t i = 0; i < s[0]; i++) {
+        // the master follows the fp32 run exactly; the param is it rounded
+        ASSERT_NEAR(opt->chunks.master[i], ref->data[i], 1e-6f);
+        ASSERT_NEAR(pico_tensor_get(h, i), ref->data[i], dtype_tol(PICO_F16, ref->data[i]));
+        ASSERT_NEAR(f->data[i], ref->data[i], 1e-6f);
+    }
+
+    pico_optim_free(opt);
+    pico_optim_free(opt_ref);
+    pico_free(h);
+    pico_free(f);
+    pico_free(late);
+    pico_free(ref);
+}
@@ -4,11 +4,16 @@
  */
 
 #include <math.h>
+#include <string.h>
 
 #include "arena.h"
+#include "global.h"
+#include "kernels/cpu_kernels.h"
 #include "ops.h"
+#include "reduce/reduce.h"
 #include "tensor.h"
 #include "utest.h"
+#include "view/view.h"
 
 // just make sure we actually get a tensor back and not null
 UTEST(pico_param, returns_non_null) {
@@ -182,7 +187,7 @@ UTEST(pico_tensor_from_scalar, broadcasts_through_mul) {
 }
 
 // ===================================================================
-//  pico_rand / pico_randn  (these describe the TARGET behavior)
+//  pico_rand / pico_randn
 // ===================================================================
 
 // pico_rand keeps the requested shape (it's just a filled tensor)
@@ -227,9 +232,8 @@ UTEST(pico_rand, uniform_unit_range) {
     arena_destroy(ar);
 }
 
-// TARGET (currently FAILS — randn is still a uniform stub): a standard-normal
-// generator must produce NEGATIVE values. uniform [0,1) never does. When randn
-// is real (Box-Muller / etc.), ~half of a big sample is < 0.
+// a standard normal produces NEGATIVE values, which uniform [0,1) never does: ~half of
+// a big sample is < 0.
 UTEST(pico_randn, produces_negatives) {
     struct Arena* ar = arena_init(1 << 16);
     arena_ctx_push(ar);
@@ -245,13 +249,41 @@ UTEST(pico_randn, produces_negatives) {
         }
     }
 
-    // tear down BEFORE asserting: this fails on purpose (randn is a uniform stub),
-    // and a failed ASSERT returns early — asserting first would skip the pop and
-    // leave this arena on the ctx stack, breaking later arena_ctx tests.
+    // tear down BEFORE asserting: a failed ASSERT returns early and would leave this
+    // arena on the ctx stack, breaking later arena_ctx tests.
     arena_ctx_pop();
     arena_destroy(ar);
 
-    ASSERT_TRUE(found_negative);  // FAILS until randn is a real normal distribution
+    ASSERT_TRUE(found_negative);
+}
+
+// randn keeps the requested shape exactly: odd 1D lengths and multi-dim shapes too
+// (bugs.md #1), with every value finite (bugs.md #2: the log never sees 0)
+UTEST(pico_randn, keeps_shape) {
+    struct Arena* ar = arena_init(1 << 16);
+    arena_ctx_push(ar);
+
+    int64_t s1[] = {7}, s2[] = {3, 5}, s3[] = {2, 3, 5};
+    struct PicoTensor* a = pico_randn(ar, s1, 1);
+    struct PicoTensor* b = pico_randn(ar, s2, 2);
+    struct PicoTensor* c = pico_randn(ar, s3, 3);
+    int finite = 1;
+    for(int64_t i = 0; i < c->numel; i++) finite &= isfinite(c->data[i]) ? 1 : 0;
+    int64_t na = a->numel, nb = b->numel, nc = c->numel;
+    int64_t b0 = b->shape[0], b1 = b->shape[1], c2 = c->shape[2];
+    uint8_t cdim = c->ndim;
+
+    arena_ctx_pop();
+    arena_destroy(ar);
+
+    ASSERT_EQ(na, 7);
+    ASSERT_EQ(nb, 15);
+    ASSERT_EQ(b0, 3);
+    ASSERT_EQ(b1, 5);
+    ASSERT_EQ(nc, 30);
+    ASSERT_EQ(cdim, 3);
+    ASSERT_EQ(c2, 5);
+    ASSERT_TRUE(finite);
 }
 
 // the REAL spec: randn is a STANDARD normal -> over a big sample, mean ~ 0 and
@@ -280,7 +312,150 @@ UTEST(pico_randn, is_standard_normal) {
     arena_ctx_pop();
     arena_destroy(ar);
 
-    ASSERT_EQ(n, 10000);                          // cat(z0,z1) reassembles the full size
+    ASSERT_EQ(n, 10000);
     ASSERT_TRUE(mean > -0.1 && mean < 0.1);       // centered on 0
     ASSERT_TRUE(stddev > 0.85 && stddev < 1.15);  // unit variance
 }
+
+// ============================= pico_cat_n / pico_stack
+
+static struct PicoTensor* iota_from(int64_t* shape, int ndim, float start) {
+    struct PicoTensor* t = pico_param(shape, (uint8_t)ndim);
+    for(int64_t i = 0; i < t->numel; i++) t->data[i] = start + (float)i;
+    return t;
+}
+
+// three inputs along the middle dim, one of them a transposed view: every output row is
+// the three chunks in order, and a weighted sum's grad lands back in each input
+UTEST(pico_cat, joins_n_tensors_and_backprops) {
+    struct Arena* ar = arena_init(1 << 18);
+    arena_ctx_push(ar);
+    int64_t sa[] = {2, 3, 4}, sb[] = {2, 1, 4}, sc[] = {2, 4, 2};
+    struct PicoTensor* a = iota_from(sa, 3, 0.0f);
+    struct PicoTensor* b = iota_from(sb, 3, 100.0f);
+    struct PicoTensor* c = iota_from(sc, 3, 200.0f);
+    struct PicoTensor* ct = pico_transpose(c, 1, 2);  // [2, 2, 4], strided
+    struct PicoTensor* ts[] = {a, b, ct};
+
+    struct PicoTensor* y = pico_cat_n(ts, 3, -2);
+    ASSERT_EQ(y->shape[0], 2);
+    ASSERT_EQ(y->shape[1], 6);
+    ASSERT_EQ(y->shape[2], 4);
+    for(int64_t o = 0; o < 2; o++) {
+        for(int64_t j = 0; j < 4; j++) {
+            for(int64_t r = 0; r < 3; r++)
+                ASSERT_EQ(y->data[(o * 6 + r) * 4 + j], a->data[(o * 3 + r) * 4 + j]);
+            ASSERT_EQ(y->data[(o * 6 + 3) * 4 + j], b->data[o * 4 + j]);
+            for(int64_t r = 0; r < 2; r++)
+                ASSERT_EQ(y->data[(o * 6 + 4 + r) * 4 + j], c->data[(o * 4 + j) * 2 + r]);
+        }
+    }
+
+    // sum(y * w) with w = the output position: each input's grad is its slot in y
+    struct PicoTensor* w = pico_create_tensor(ar, y->shape, 3);
+    for(int64_t i = 0; i < w->numel; i++) w->data[i] = (float)i;
+    pico_backward(ar, pico_sum(pico_mul(y, w), NULL, 0, false));
+    ASSERT_EQ(a->grad[1 * 12 + 2 * 4 + 3], (float)((1 * 6 + 2) * 4 + 3));
+    ASSERT_EQ(b->grad[1 * 4 + 2], (float)((1 * 6 + 3) * 4 + 2));
+    ASSERT_EQ(c->grad[(1 * 4 + 3) * 2 + 1], (float)((1 * 6 + 5) * 4 + 3));
+
+    int64_t bad[] = {2, 3, 5};
+    struct PicoTensor* d = iota_from(bad, 3, 0.0f);
+    struct PicoTensor* mismatched[] = {a, d};
+    ASSERT_TRUE(pico_cat_n(mismatched, 2, 1) == NULL);
+    ASSERT_TRUE(pico_cat_n(ts, 3, 3) == NULL);
+    ASSERT_TRUE(pico_cat(a, a, 0)->shape[0] == 4);
+    int64_t deep[PICO_VIEW_MAX_DIMS + 1];
+    for(int i = 0; i <= PICO_VIEW_MAX_DIMS; i++) deep[i] = 1;
+    struct PicoTensor* e = pico_create_tensor(ar, deep, PICO_VIEW_MAX_DIMS + 1);
+    ASSERT_TRUE(pico_cat(e, e, 0) == NULL);  // more dims than the output shape holds
+
+    pico_free(a);
+    pico_free(b);
+    pico_free(c);
+    pico_free(d);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+// the same tensor twice: both windows add into its grad (the serial path)
+UTEST(pico_cat, repeated_input_accumulates) {
+    struct Arena* ar = arena_init(1 << 16);
+    arena_ctx_push(ar);
+    int64_t s[] = {3, 2};
+    struct PicoTensor* x = iota_from(s, 2, 1.0f);
+    struct PicoTensor* ts[] = {x, x, x};
+    struct PicoTensor* y = pico_cat_n(ts, 3, 1);
+    ASSERT_EQ(y->data[1 * 6 + 4], x->data[1 * 2 + 0]);
+    pico_backward(ar, pico_sum(y, NULL, 0, false));
+    for(int i = 0; i < 6; i++) ASSERT_EQ(x->grad[i], 3.0f);
+    pico_free(x);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+UTEST(pico_stack, new_dim_anywhere) {
+    struct Arena* ar = arena_init(1 << 16);
+    arena_ctx_push(ar);
+    int64_t s[] = {2, 3};
+    struct PicoTensor* ts[4];
+    for(int k = 0; k < 4; k++) ts[k] = iota_from(s, 2, 10.0f * k);
+
+    struct PicoTensor* y0 = pico_stack(ts, 4, 0);
+    ASSERT_EQ(y0->ndim, 3);
+    ASSERT_EQ(y0->shape[0], 4);
+    ASSERT_EQ(y0->data[2 * 6 + 1 * 3 + 2], ts[2]->data[1 * 3 + 2]);
+
+    // new last dim: [2, 3, 4], y[i][j][k] = ts[k][i][j]
+    struct PicoTensor* y2 = pico_stack(ts, 4, -1);
+    ASSERT_EQ(y2->shape[2], 4);
+    ASSERT_EQ(y2->data[(1 * 3 + 2) * 4 + 3], ts[3]->data[1 * 3 + 2]);
+
+    pico_backward(ar, pico_sum(y2, NULL, 0, false));
+    for(int k = 0; k < 4; k++)
+        for(int i = 0; i < 6; i++) ASSERT_EQ(ts[k]->grad[i], 1.0f);
+
+    int64_t other[] = {3, 2};
+    struct PicoTensor* z = iota_from(other, 2, 0.0f);
+    struct PicoTensor* bad[] = {ts[0], z};
+    ASSERT_TRUE(pico_stack(bad, 2, 0) == NULL);
+    ASSERT_TRUE(pico_stack(ts, 4, 3) == NULL);
+
+    for(int k = 0; k < 4; k++) pico_free(ts[k]);
+    pico_free(z);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+// an output past PICO_CAT_STREAM_MIN_BYTES, split across threads: the streaming copy and
+// the parallel backward, in fp32 and bf16
+UTEST(pico_cat, large_streams_and_splits) {
+    pico_init();
+    struct Arena* ar = arena_init(1 << 27);
+    arena_ctx_push(ar);
+    int64_t s[] = {256, 2050};  // 8 KB runs, not a multiple of the store width
+    struct PicoTensor* ts[4];
+    for(int k = 0; k < 4; k++) ts[k] = iota_from(s, 2, (float)k);
+
+    struct PicoTensor* y = pico_cat_n(ts, 4, 1);
+    ASSERT_GE((size_t)y->numel * sizeof(float), (size_t)PICO_CAT_STREAM_MIN_BYTES);
+    for(int64_t r = 0; r < 256; r += 17)
+        for(int k = 0; k < 4; k++)
+            for(int64_t j = 0; j < 2050; j += 41)
+                ASSERT_EQ(y->data[r * 8200 + k * 2050 + j], ts[k]->data[r * 2050 + j]);
+    ASSERT_EQ(y->data[y->numel - 1], ts[3]->data[ts[3]->numel - 1]);
+
+    pico_backward(ar, pico_sum(y, NULL, 0, false));
+    for(int k = 0; k < 4; k++)
+        for(int64_t i = 0; i < ts[k]->numel; i += 97) ASSERT_EQ(ts[k]->grad[i], 1.0f);
+
+    struct PicoTensor* hs[4];
+    for(int k = 0; k < 4; k++) hs[k] = pico_to_dtype(ts[k], PICO_BF16);
+    struct PicoTensor* h = pico_cat_n(hs, 4, 0);
+    ASSERT_EQ(h->dtype, PICO_BF16);
+    ASSERT_EQ(memcmp(h->data16 + 3 * 256 * 2050, hs[3]->data16, 2 * 256 * 2050), 0);
+
+    for(int k = 0; k < 4; k++) pico_free(ts[k]);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
@@ -5,7 +5,9 @@
  * NOTE: no UTEST_MAIN here, test_basic.c owns main + UTEST_STATE.
  * TODO(pico): manual optimizer cleanup until pico_optim_sgd_free exists.
  */
+#include <math.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "act/activations.h"
 #include "arena.h"
@@ -191,3 +193,67 @@ UTEST(train, relu_mlp_lowers_loss) {
     arena_ctx_pop();
     arena_destroy(ar);
 }
+
+// gradient accumulation: 4 micro-batches of 2 rows with accum_steps = 4 (arena reset
+// between them) must land on the same weights as one SGD step on all 8 rows. each
+// micro-batch's MEAN loss averages 2 rows, the 1/4 in the step averages the rest.
+UTEST(train, grad_accum_matches_full_batch) {
+    struct Arena* ar = arena_init(1 << 16);
+    arena_ctx_push(ar);
+
+    int64_t sx[] = {8, 2}, sy[] = {8, 1}, smx[] = {2, 2}, smy[] = {2, 1}, sw[] = {2, 1};
+    struct PicoTensor* x = pico_param(sx, 2);
+    struct PicoTensor* y = pico_param(sy, 2);
+    for(int i = 0; i < 8; i++) {
+        x->data[2 * i] = (float)i * 0.5f;
+        x->data[2 * i + 1] = 1.0f - (float)i * 0.25f;
+        y->data[i] = 1.0f + 2.0f * x->data[2 * i] + 3.0f * x->data[2 * i + 1];
+    }
+    struct PicoTensor* w_full = pico_param(sw, 2);
+    struct PicoTensor* w_acc = pico_param(sw, 2);
+    struct PicoTensor* mx = pico_param(smx, 2);
+    struct PicoTensor* my = pico_param(smy, 2);
+    struct PicoMSELoss mse = {.reduction = MEAN};
+
+    struct PicoOptimSGD* full = pico_optim_sgd_init(0.05f);
+    pico_optim_sgd_add(full, w_full);
+    pico_optim_sgd_zero_grad(full);
+    pico_backward(ar, pico_mse_loss(&mse, pico_matmul(x, w_full), y));
+    pico_optim_sgd_step(full);
+    arena_reset(ar);
+
+    struct PicoOptimSGD* acc = pico_optim_sgd_init(0.05f);
+    acc->accum_steps = 4;
+    acc->fuse_zero_grad = true;
+    pico_optim_sgd_add(acc, w_acc);
+    pico_optim_sgd_zero_grad(acc);
+    int stepped[4];
+    for(int m = 0; m < 4; m++) {
+        memcpy(mx->data, x->data + 4 * m, 4 * sizeof(float));
+        memcpy(my->data, y->data + 2 * m, 2 * sizeof(float));
+        pico_backward(ar, pico_mse_loss(&mse, pico_matmul(mx, w_acc), my));
+        stepped[m] = pico_optim_sgd_accum_step(acc);
+        arena_reset(ar);
+    }
+
+    float diff = fmaxf(fabsf(w_full->data[0] - w_acc->data[0]),
+                       fabsf(w_full->data[1] - w_acc->data[1]));
+    float moved = fabsf(w_full->data[0]) + fabsf(w_full->data[1]);
+    float left = fabsf(w_acc->grad[0]) + fabsf(w_acc->grad[1]);
+
+    pico_optim_sgd_free(full);
+    pico_optim_sgd_free(acc);
+    pico_free(x);
+    pico_free(y);
+    pico_free(w_full);
+    pico_free(w_acc);
+    pico_free(mx);
+    pico_free(my);
+    arena_ctx_pop();
+    arena_destroy(ar);
+
+    ASSERT_TRUE(!stepped[0] && !stepped[1] && !stepped[2] && stepped[3]);
+    ASSERT_TRUE(moved > 0.1f);
+    ASSERT_TRUE(diff < 1e-6f);
+    ASSERT_TRUE(left == 0.0f);  // fused zero-grad: the next window starts clean
+}
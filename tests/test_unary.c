@@ -1,5 +1,5 @@
 /*
- * Tests for the unary element-wise math ops (pico_tensor_sqrt/sin/cos/tan/tanh).
+ * Tests for the unary element-wise math ops (pico_tensor_sqrt/sin/cos/tan/tanh/log/exp).
  * FORWARD ONLY for now — backwards are TODO, so there's one punch-list test
  * (unary_backward_is_todo) that stays red until the _backward fns are wired.
  * NOTE: no UTEST_MAIN here, test_basic.c owns main + UTEST_STATE.
@@ -133,6 +133,25 @@ UTEST(unary, log_forward) {
     arena_destroy(ar);
 }
 
+// e^0 == 1 exactly, e^1 == e
+UTEST(unary, exp_forward) {
+    struct Arena* ar = arena_init(4096);
+    arena_ctx_push(ar);
+
+    int64_t s[] = {2};
+    struct PicoTensor* x = pico_param(s, 1);
+    x->data[0] = 0.0f;
+    x->data[1] = 1.0f;
+
+    struct PicoTensor* out = pico_tensor_exp(x);
+    ASSERT_TRUE(out->data[0] == 1.0f);
+    ASSERT_TRUE(NEAR(out->data[1], 2.71828182845904523536f));
+
+    pico_free(x);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
 // output keeps the input shape and wires the single parent (unary op)
 UTEST(unary, preserves_shape_and_wires_parent) {
     struct Arena* ar = arena_init(4096);
@@ -288,3 +307,24 @@ UTEST(unary_backward, log) {
 
     ASSERT_TRUE(NEAR(gx, 1.0f));
 }
+
+// d/dx e^x at x=1 with upstream 2 -> 2e
+UTEST(unary_backward, exp) {
+    struct Arena* ar = arena_init(4096);
+    arena_ctx_push(ar);
+
+    int64_t s[] = {1};
+    struct PicoTensor* x = pico_param(s, 1);
+    x->data[0] = 1.0f;
+
+    struct PicoTensor* out = pico_tensor_exp(x);
+    out->grad[0] = 2.0f;
+    out->_backward(out);
+    float gx = x->grad[0];
+
+    pico_free(x);
+    arena_ctx_pop();
+    arena_destroy(ar);
+
+    ASSERT_TRUE(NEAR(gx, 2.0f * 2.71828182845904523536f));
+}
@@ -0,0 +1,251 @@
+/*
+ * Tests for views (view/view.h): reshape / slice / narrow / permute / transpose /
+ * expand share memory with their base, pico_contiguous copies only when it has to,
+ * and gradients through a view land in the base's grad.
+ * NOTE: no UTEST_MAIN here, test_basic.c owns main + UTEST_STATE.
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+#include "global.h"
+#include "kernels/cpu_kernels.h"
+#include "ops.h"
+#include "reduce/reduce.h"
+#include "tensor.h"
+#include "utest.h"
+#include "view/view.h"
+
+static struct PicoTensor* iota(int64_t* shape, int ndim) {
+    struct PicoTensor* t = pico_param(shape, (uint8_t)ndim);
+    for(int64_t i = 0; i < t->numel; i++) t->data[i] = (float)i;
+    return t;
+}
+
+// element at (i, j, k) of a 3-d tensor, through its strides
+static float at3(struct PicoTensor* t, int64_t i, int64_t j, int64_t k) {
+    return t->data[i * t->strides[0] + j * t->strides[1] + k * t->strides[2]];
+}
+
+UTEST(view, reshape_shares_memory) {
+    struct Arena* ar = arena_init(1 << 16);
+    arena_ctx_push(ar);
+    int64_t s[] = {2, 3, 4};
+    struct PicoTensor* x = iota(s, 3);
+
+    int64_t ns[] = {4, -1};
+    struct PicoTensor* r = pico_reshape(x, ns, 2);
+    ASSERT_TRUE(r != NULL);
+    ASSERT_EQ(r->shape[1], 6);
+    ASSERT_TRUE(r->data == x->data);
+    ASSERT_TRUE(pico_is_contiguous(r));
+
+    int64_t bad[] = {5, -1};
+    ASSERT_TRUE(pico_reshape(x, bad, 2) == NULL);
+
+    // swapping the outer two dims keeps the last one contiguous: splitting it is still a
+    // view, flattening everything needs a copy
+    int dims[] = {1, 0, 2};
+    struct PicoTensor* p = pico_permute(x, dims);
+    int64_t split[] = {3, 2, 2, 2};
+    struct PicoTensor* v = pico_reshape(p, split, 4);
+    ASSERT_TRUE(v->data == x->data);
+    ASSERT_EQ(v->strides[2], 2);
+    ASSERT_EQ(v->data[2 * v->strides[0] + v->strides[1] + v->strides[2]], at3(p, 2, 1, 2));
+    int64_t flat[] = {24};
+    struct PicoTensor* c = pico_reshape(p, flat, 1);
+    ASSERT_TRUE(c->data != x->data);
+    for(int64_t i = 0; i < 24; i++) ASSERT_EQ(c->data[i], at3(p, i / 8, (i / 4) % 2, i % 4));
+
+    pico_free(x);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+UTEST(view, slice_and_narrow) {
+    struct Arena* ar = arena_init(1 << 16);
+    arena_ctx_push(ar);
+    int64_t s[] = {6, 5};
+    struct PicoTensor* x = iota(s, 2);
+
+    struct PicoTensor* rows = pico_narrow(x, 0, 2, 3);
+    ASSERT_EQ(rows->shape[0], 3);
+    ASSERT_TRUE(rows->data == x->data + 10);
+    ASSERT_TRUE(pico_is_contiguous(rows));
+
+    // every other column from the second, counted from the end: columns 1 and 3
+    struct PicoTensor* cols = pico_slice(x, -1, -4, 5, 2);
+    ASSERT_EQ(cols->shape[1], 2);
+    ASSERT_FALSE(pico_is_contiguous(cols));
+    ASSERT_EQ(cols->data[4 * cols->strides[0] + 1 * cols->strides[1]], 23.0f);
+
+    ASSERT_TRUE(pico_narrow(x, 1, 3, 3) == NULL);
+    ASSERT_TRUE(pico_slice(x, 0, 4, 4, 1) == NULL);
+    ASSERT_TRUE(pico_slice(x, 2, 0, 1, 1) == NULL);
+
+    pico_free(x);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+UTEST(view, permute_transpose_expand) {
+    struct Arena* ar = arena_init(1 << 16);
+    arena_ctx_push(ar);
+    int64_t s[] = {2, 3, 4};
+    struct PicoTensor* x = iota(s, 3);
+
+    int dims[] = {2, 0, 1};
+    struct PicoTensor* p = pico_permute(x, dims);
+    ASSERT_EQ(p->shape[0], 4);
+    ASSERT_EQ(at3(p, 3, 1, 2), at3(x, 1, 2, 3));
+    int dup[] = {0, 0, 1};
+    ASSERT_TRUE(pico_permute(x, dup) == NULL);
+
+    struct PicoTensor* t = pico_transpose(x, 0, -1);
+    ASSERT_EQ(at3(t, 3, 2, 1), at3(x, 1, 2, 3));
+
+    int64_t rs[] = {3, 1};
+    struct PicoTensor* col = iota(rs, 2);
+    int64_t es[] = {2, 3, 4};
+    struct PicoTensor* e = pico_expand(col, es, 3);
+    ASSERT_EQ(e->strides[0], 0);
+    ASSERT_EQ(e->strides[2], 0);
+    ASSERT_EQ(at3(e, 1, 2, 3), 2.0f);
+    int64_t keep[] = {-1, 5};
+    ASSERT_EQ(pico_expand(col, keep, 2)->shape[0], 3);
+    int64_t bad[] = {4, 4};
+    ASSERT_TRUE(pico_expand(col, bad, 2) == NULL);
+
+    pico_free(x);
+    pico_free(col);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+// no copy when already contiguous; a strided gather otherwise, in both dtypes and
+// big enough to be split across threads
+UTEST(view, contiguous_copies_only_when_needed) {
+    struct Arena* ar = arena_init(1 << 24);
+    arena_ctx_push(ar);
+    int64_t s[] = {300, 700};
+    struct PicoTensor* x = iota(s, 2);
+    ASSERT_TRUE(pico_contiguous(x) == x);
+
+    struct PicoTensor* c = pico_contiguous(pico_transpose(x, 0, 1));
+    ASSERT_TRUE(pico_is_contiguous(c));
+    for(int64_t i = 0; i < 700; i++)
+        for(int64_t j = 0; j < 300; j++) ASSERT_EQ(c->data[i * 300 + j], x->data[j * 700 + i]);
+
+    struct PicoTensor* h = pico_to_dtype(x, PICO_BF16);
+    struct PicoTensor* hc = pico_transpose_clone(h);
+    ASSERT_EQ(hc->dtype, PICO_BF16);
+    ASSERT_EQ(pico_tensor_get(hc, 5 * 300 + 7), pico_tensor_get(h, 7 * 700 + 5));
+
+    // a clone is a new tensor even when the transpose is contiguous already
+    int64_t rs[] = {1, 8};
+    struct PicoTensor* row = iota(rs, 2);
+    ASSERT_TRUE(pico_transpose_clone(row)->data != row->data);
+
+    pico_free(x);
+    pico_free(row);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+// ops read views right, and the grads flow back into the base through the shared
+// window: the transposed use, the sliced rows and the expanded column all end up in x
+UTEST(view, grads_reach_the_base) {
+    struct Arena* ar = arena_init(1 << 18);
+    arena_ctx_push(ar);
+    int64_t s[] = {3, 4};
+    struct PicoTensor* x = iota(s, 2);
+    int64_t ws[] = {4, 3};
+    struct PicoTensor* w = iota(ws, 2);
+
+    // sum(transpose(x) * w): d/dx[i][j] = w[j][i]
+    struct PicoTensor* y = pico_mul(pico_transpose(x, 0, 1), w);
+    ASSERT_EQ(y->data[1 * 3 + 2], x->data[2 * 4 + 1] * w->data[1 * 3 + 2]);
+    pico_backward(ar, pico_sum(y, NULL, 0, false));
+    for(int i = 0; i < 3; i++)
+        for(int j = 0; j < 4; j++) ASSERT_EQ(x->grad[i * 4 + j], w->data[j * 3 + i]);
+
+    // sum(rows 1..2 of x): only those rows get 1
+    memset(x->grad, 0, sizeof(float) * 12);
+    pico_backward(ar, pico_sum(pico_narrow(x, 0, 1, 2), NULL, 0, false));
+    for(int i = 0; i < 12; i++) ASSERT_EQ(x->grad[i], i >= 4 ? 1.0f : 0.0f);
+
+    // sum(expand(column)) over [3, 5]: each column element is used 5 times
+    int64_t cs[] = {3, 1};
+    struct PicoTensor* col = iota(cs, 2);
+    int64_t es[] = {3, 5};
+    pico_backward(ar, pico_sum(pico_expand(col, es, 2), NULL, 0, false));
+    for(int i = 0; i < 3; i++) ASSERT_EQ(col->grad[i], 5.0f);
+
+    pico_free(x);
+    pico_free(w);
+    pico_free(col);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}
+
+// ---- the blocked transpose behind pico_contiguous --------------------------------------
+
+// the 8x8 register tiles (+ scalar edges) against the plain loop, copy and accumulate
+UTEST(view_transpose, avx2_matches_scalar) {
+    if(!__builtin_cpu_supports("avx2")) return;
+    int64_t sizes[][2] = {{8, 8}, {13, 29}, {64, 70}, {3, 40}};
+    for(int s = 0; s < 4; s++) {
+        int64_t r = sizes[s][0], c = sizes[s][1];
+        float* src = malloc(sizeof(float) * r * c);
+        float* a = malloc(sizeof(float) * r * c);
+        float* b = malloc(sizeof(float) * r * c);
+        for(int64_t i = 0; i < r * c; i++) {
+            src[i] = (float)(i % 101) - 50.0f;
+            a[i] = b[i] = (float)(i % 7);
+        }
+        for(int acc = 0; acc < 2; acc++) {
+            pico_transpose_f32_scalar(src, c, a, r, r, c, acc);
+            pico_transpose_f32_avx2(src, c, b, r, r, c, acc);
+            ASSERT_EQ(memcmp(a, b, sizeof(float) * r * c), 0);
+        }
+        ASSERT_EQ(a[(c - 1) * r + r - 1], 2.0f * src[(r - 1) * c + c - 1]);
+        free(src);
+        free(a);
+        free(b);
+    }
+}
+
+// a batched transpose of the last two dims, forward and backward, at every level and
+// big enough to be split into many blocks across threads
+UTEST(view_transpose, batched_forward_and_backward) {
+    SimdLevel saved = g_simd_level;
+    pico_init();
+    struct Arena* ar = arena_init(1 << 24);
+    arena_ctx_push(ar);
+    int64_t s[] = {3, 150, 203};
+    struct PicoTensor* x = iota(s, 3);
+
+    SimdLevel levels[] = {SIMD_NONE, SIMD_AVX2};
+    for(int l = 0; l < 2; l++) {
+        if(levels[l] == SIMD_AVX2 && !__builtin_cpu_supports("avx2")) continue;
+        g_simd_level = levels[l];
+        struct PicoTensor* t = pico_transpose(x, 1, 2);
+        struct PicoTensor* c = pico_contiguous(t);
+        for(int64_t b = 0; b < 3; b++)
+            for(int64_t i = 0; i < 203; i++)
+                for(int64_t j = 0; j < 150; j++)
+                    ASSERT_EQ(c->data[(b * 203 + i) * 150 + j], at3(x, b, j, i));
+
+        // sum(c * c) / 2: dx = x, landing back through the transpose
+        memset(x->grad, 0, sizeof(float) * x->numel);
+        pico_backward(ar, pico_sum(pico_mul(c, c), NULL, 0, false));
+        for(int64_t i = 0; i < x->numel; i++) ASSERT_EQ(x->grad[i], 2.0f * x->data[i]);
+        arena_reset(ar);
+    }
+    g_simd_level = saved;
+
+    pico_free(x);
+    arena_ctx_pop();
+    arena_destroy(ar);
+}